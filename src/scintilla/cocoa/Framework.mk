@@ -14,7 +14,7 @@ SCI_LEXERS=$(LEXOBJS) \
 SCI_OBJ=AutoComplete.o CallTip.o CellBuffer.o CharClassify.o \
 	ContractionState.o Decoration.o Document.o Editor.o \
 	ExternalLexer.o Indicator.o KeyMap.o LineMarker.o PerLine.o \
-	PositionCache.o PropSetSimple.o RESearch.o RunStyles.o ScintillaBase.o Style.o \
+	PositionCache.o PropSetSimple.o RESearch.o DFASearch.o BackgroundLexer.o RunStyles.o ScintillaBase.o Style.o \
 	StyleContext.o UniConversion.o ViewStyle.o XPM.o WordList.o \
 	Selection.o CharacterSet.o Catalogue.o $(SCI_LEXERS)
 
@@ -23,6 +23,7 @@
 #include <map>
 
 #include "ILexer.h"
+#include "Position.h"
 
 #ifdef SCI_LEXER
 #include "SciLexer.h"
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <math.h>
+#include <pthread.h> //!-add-[BackgroundLexing]
 
 #include <vector>
 #include <map>
@@ -1993,6 +1994,64 @@ double ElapsedTime::Duration(bool reset) {
 	return result;
 }
 
+//!-start-[BackgroundLexing]
+class ThreadLockPosix : public ThreadLock {
+	pthread_mutex_t mutex;
+public:
+	ThreadLockPosix() {
+		pthread_mutex_init(&mutex, NULL);
+	}
+	virtual ~ThreadLockPosix() {
+		pthread_mutex_destroy(&mutex);
+	}
+	virtual void Lock() {
+		pthread_mutex_lock(&mutex);
+	}
+	virtual void Unlock() {
+		pthread_mutex_unlock(&mutex);
+	}
+};
+
+ThreadLock *ThreadLock::Allocate() {
+	return new ThreadLockPosix();
+}
+
+class BackgroundThreadPosix : public BackgroundThread {
+	pthread_t thread;
+	bool joined;
+	Procedure procedure;
+	void *argument;
+	static void *ThreadProcedure(void *pThread) {
+		BackgroundThreadPosix *bt = static_cast<BackgroundThreadPosix *>(pThread);
+		bt->procedure(bt->argument);
+		return NULL;
+	}
+public:
+	BackgroundThreadPosix(Procedure procedure_, void *argument_) :
+		joined(true), procedure(procedure_), argument(argument_) {
+	}
+	bool Start() {
+		joined = pthread_create(&thread, NULL, ThreadProcedure, this) != 0;
+		return !joined;
+	}
+	virtual void Join() {
+		if (!joined) {
+			pthread_join(thread, NULL);
+			joined = true;
+		}
+	}
+};
+
+BackgroundThread *BackgroundThread::Start(Procedure procedure, void *argument) {
+	BackgroundThreadPosix *bt = new BackgroundThreadPosix(procedure, argument);
+	if (!bt->Start()) {
+		delete bt;
+		return NULL;
+	}
+	return bt;
+}
+//!-end-[BackgroundLexing]
+
 ColourDesired Platform::Chrome() {
 	return ColourDesired(0xe0, 0xe0, 0xe0);
 }
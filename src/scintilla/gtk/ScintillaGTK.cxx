@@ -26,6 +26,7 @@
 
 #include "ILexer.h"
 #include "Scintilla.h"
+#include "Position.h"
 #include "ScintillaWidget.h"
 #ifdef SCI_LEXER
 #include "SciLexer.h"
@@ -33,6 +34,7 @@
 #include "SVector.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -291,7 +293,7 @@ private:
 	static gboolean TimeOut(ScintillaGTK *sciThis);
 	static gboolean IdleCallback(ScintillaGTK *sciThis);
 	static gboolean StyleIdle(ScintillaGTK *sciThis);
-	virtual void QueueStyling(int upTo);
+	virtual void QueueStyling(Position upTo);
 	static void PopUpCB(GtkMenuItem *menuItem, ScintillaGTK *sciThis);
 
 #if GTK_CHECK_VERSION(3,0,0)
@@ -869,7 +871,7 @@ fprintf(stderr, "Can not iconv %s %s\n", charSetDest, charSetSource);
 // Returns the target converted to UTF8.
 // Return the length in bytes.
 int ScintillaGTK::TargetAsUTF8(char *text) {
-	int targetLength = targetEnd - targetStart;
+	int targetLength = static_cast<int>(targetEnd - targetStart);
 	if (IsUnicodeMode()) {
 		if (text) {
 			pdoc->GetCharRange(text, targetStart, targetLength);
@@ -2753,7 +2755,7 @@ gboolean ScintillaGTK::StyleIdle(ScintillaGTK *sciThis) {
 	return FALSE;
 }
 
-void ScintillaGTK::QueueStyling(int upTo) {
+void ScintillaGTK::QueueStyling(Position upTo) {
 	Editor::QueueStyling(upTo);
 	if (!styleNeeded.active) {
 		// Only allow one style needed to be queued
@@ -5,7 +5,7 @@ ScintillaGTK.o: ScintillaGTK.cxx \
  ../include/ILexer.h ../include/Scintilla.h ../include/ScintillaWidget.h \
  ../include/SciLexer.h ../src/SVector.h ../src/SplitVector.h \
  ../src/Partitioning.h ../src/RunStyles.h ../src/ContractionState.h \
- ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h ../src/Indicator.h \
+ ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h ../src/Indicator.h \
  ../src/XPM.h ../src/LineMarker.h ../src/Style.h ../src/AutoComplete.h \
  ../src/ViewStyle.h ../src/Decoration.h ../src/CharClassify.h \
  ../src/Document.h ../src/Selection.h ../src/PositionCache.h \
@@ -21,7 +21,7 @@ Catalogue.o: ../src/Catalogue.cxx ../include/ILexer.h \
  ../src/Catalogue.h
 CellBuffer.o: ../src/CellBuffer.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/CellBuffer.h
+ ../src/ChunkedVector.h ../src/CellBuffer.h ../lexlib/CharacterSet.h
 CharClassify.o: ../src/CharClassify.cxx ../src/CharClassify.h
 ContractionState.o: ../src/ContractionState.cxx ../include/Platform.h \
  ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
@@ -31,12 +31,12 @@ Decoration.o: ../src/Decoration.cxx ../include/Platform.h \
  ../src/RunStyles.h ../src/Decoration.h
 Document.o: ../src/Document.cxx ../include/Platform.h ../include/ILexer.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+ ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/PerLine.h \
  ../src/CharClassify.h ../lexlib/CharacterSet.h ../src/Decoration.h \
- ../src/Document.h ../src/RESearch.h ../src/UniConversion.h
+ ../src/Document.h ../src/BackgroundLexer.h ../src/RESearch.h ../src/DFASearch.h ../src/UniConversion.h
 Editor.o: ../src/Editor.cxx ../include/Platform.h ../include/ILexer.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/RunStyles.h ../src/ContractionState.h ../src/CellBuffer.h \
+ ../src/RunStyles.h ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h \
  ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
  ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
  ../src/Decoration.h ../src/Document.h ../src/Selection.h \
@@ -52,15 +52,23 @@ LineMarker.o: ../src/LineMarker.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/XPM.h ../src/LineMarker.h
 PerLine.o: ../src/PerLine.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/CellBuffer.h ../src/PerLine.h
+ ../src/ChunkedVector.h ../src/CellBuffer.h ../src/PerLine.h
 PositionCache.o: ../src/PositionCache.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/RunStyles.h ../src/ContractionState.h ../src/CellBuffer.h \
+ ../src/RunStyles.h ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h \
  ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
  ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
  ../src/Decoration.h ../include/ILexer.h ../src/Document.h \
  ../src/Selection.h ../src/PositionCache.h
 RESearch.o: ../src/RESearch.cxx ../src/CharClassify.h ../src/RESearch.h
+DFASearch.o: ../src/DFASearch.cxx ../src/CharClassify.h ../src/RESearch.h \
+ ../src/DFASearch.h
+BackgroundLexer.o: ../src/BackgroundLexer.cxx ../include/Platform.h \
+ ../include/ILexer.h ../include/Scintilla.h ../src/Position.h \
+ ../src/SplitVector.h ../src/Partitioning.h ../src/ChunkedVector.h \
+ ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+ ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
+ ../src/BackgroundLexer.h
 RunStyles.o: ../src/RunStyles.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
  ../src/RunStyles.h
@@ -68,7 +76,7 @@ ScintillaBase.o: ../src/ScintillaBase.cxx ../include/Platform.h \
  ../include/ILexer.h ../include/Scintilla.h ../lexlib/PropSetSimple.h \
  ../include/SciLexer.h ../lexlib/LexerModule.h ../src/Catalogue.h \
  ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
- ../src/ContractionState.h ../src/CellBuffer.h ../src/CallTip.h \
+ ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h \
  ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
  ../src/Style.h ../src/ViewStyle.h ../src/AutoComplete.h \
  ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
@@ -315,6 +315,10 @@ public:
 
 	virtual void SetUnicodeMode(bool unicodeMode_)=0;
 	virtual void SetDBCSMode(int codePage)=0;
+//!-start-[WrapThreads]
+	/// Can separate surfaces measure text on different threads at the same time?
+	virtual bool ThreadSafeMeasureWidths() { return false; }
+//!-end-[WrapThreads]
 };
 
 /**
@@ -427,6 +431,32 @@ public:
 	double Duration(bool reset=false);
 };
 
+//!-start-[BackgroundLexing]
+/**
+ * Lock shared between the window thread and background threads.
+ */
+class ThreadLock {
+public:
+	virtual ~ThreadLock() {}
+	virtual void Lock()=0;
+	virtual void Unlock()=0;
+	static ThreadLock *Allocate();
+};
+
+/**
+ * Thread running a procedure apart from the window thread.
+ */
+class BackgroundThread {
+public:
+	typedef void (*Procedure)(void *argument);
+	virtual ~BackgroundThread() {}
+	/// Wait for the procedure to return. Called before the thread is deleted.
+	virtual void Join()=0;
+	/// @return NULL if the thread could not be started.
+	static BackgroundThread *Start(Procedure procedure, void *argument);
+};
+//!-end-[BackgroundLexing]
+
 /**
  * Dynamic Library (DLL/SO/...) loading
  */
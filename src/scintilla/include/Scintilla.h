@@ -40,6 +40,8 @@ typedef unsigned long uptr_t;
 typedef long sptr_t;
 #endif
 
+#include "Sci_Position.h"
+
 typedef sptr_t (*SciFnDirect)(sptr_t ptr, unsigned int iMessage, uptr_t wParam, sptr_t lParam);
 
 /* ++Autogenerated -- start of section automatically generated from Scintilla.iface */
@@ -358,6 +360,7 @@ typedef sptr_t (*SciFnDirect)(sptr_t ptr, unsigned int iMessage, uptr_t wParam,
 #define SCFIND_WORDSTART 0x00100000
 #define SCFIND_REGEXP 0x00200000
 #define SCFIND_POSIX 0x00400000
+#define SCFIND_DFAREGEX 0x01000000
 #define SCI_FINDTEXT 2150
 #define SCI_FORMATRANGE 2151
 #define SCI_GETFIRSTVISIBLELINE 2152
@@ -405,6 +408,7 @@ typedef sptr_t (*SciFnDirect)(sptr_t ptr, unsigned int iMessage, uptr_t wParam,
 #define SCI_REPLACETARGET 2194
 #define SCI_REPLACETARGETRE 2195
 #define SCI_SEARCHINTARGET 2197
+#define SCI_REPLACEALLINTARGET 4026
 #define SCI_SETSEARCHFLAGS 2198
 #define SCI_GETSEARCHFLAGS 2199
 #define SCI_CALLTIPSHOW 2200
@@ -441,6 +445,14 @@ typedef sptr_t (*SciFnDirect)(sptr_t ptr, unsigned int iMessage, uptr_t wParam,
 #define SCI_SETFOLDEXPANDED 2229
 #define SCI_GETFOLDEXPANDED 2230
 #define SCI_TOGGLEFOLD 2231
+#define SC_FOLDACTION_CONTRACT 0
+#define SC_FOLDACTION_EXPAND 1
+#define SC_FOLDACTION_TOGGLE 2
+#define SCI_FOLDLINE 2237
+#define SCI_FOLDCHILDREN 2238
+#define SCI_EXPANDCHILDREN 2239
+#define SCI_FOLDALL 2662
+#define SCI_FOLDTOLEVEL 4046
 #define SCI_ENSUREVISIBLE 2232
 #define SC_FOLDFLAG_LINEBEFORE_EXPANDED 0x0002
 #define SC_FOLDFLAG_LINEBEFORE_CONTRACTED 0x0004
@@ -839,6 +851,27 @@ typedef sptr_t (*SciFnDirect)(sptr_t ptr, unsigned int iMessage, uptr_t wParam,
 #define SCI_SETTECHNOLOGY 2630
 #define SCI_GETTECHNOLOGY 2631
 #define SCI_CREATELOADER 2632
+#define SCI_SETCHUNKSIZE 4024
+#define SCI_GETCHUNKSIZE 4025
+#define SCI_SETBACKGROUNDLEXING 4027
+#define SCI_GETBACKGROUNDLEXING 4028
+#define SCI_SETWRAPTHREADS 4029
+#define SCI_GETWRAPTHREADS 4030
+#define SCI_SETUNDOMEMORYLIMIT 4031
+#define SCI_GETUNDOMEMORYLIMIT 4032
+#define SCI_GETUNDOMEMORYUSE 4033
+#define SCI_GETUNDOACTIONS 4034
+#define SCI_SAVEUNDOHISTORY 4035
+#define SCI_LOADUNDOHISTORY 4036
+#define SCI_SETPOSITIONCACHEMEMORY 4037
+#define SCI_GETPOSITIONCACHEMEMORY 4038
+#define SCI_GETPOSITIONCACHEHITS 4039
+#define SCI_GETPOSITIONCACHEMISSES 4040
+#define SCI_SETLAYOUTCACHEMEMORY 4041
+#define SCI_GETLAYOUTCACHEMEMORY 4042
+#define SCI_GETLAYOUTCACHEMEMORYUSE 4043
+#define SCI_AUTOCSETFUZZY 4044
+#define SCI_AUTOCGETFUZZY 4045
 #define SCI_STARTRECORD 3001
 #define SCI_STOPRECORD 3002
 #define SCI_SETLEXER 4001
@@ -972,6 +1005,13 @@ struct Sci_TextToFind {
 	struct Sci_CharacterRange chrgText;
 };
 
+struct Sci_TextToReplace {
+	const char *lpstrFind;
+	Sci_Position lengthFind;
+	const char *lpstrReplace;
+	Sci_Position lengthReplace;
+};
+
 #define CharacterRange Sci_CharacterRange
 #define TextRange Sci_TextRange
 #define TextToFind Sci_TextToFind
@@ -1011,7 +1051,7 @@ struct Sci_NotifyHeader {
 
 struct SCNotification {
 	struct Sci_NotifyHeader nmhdr;
-	int position;
+	Sci_Position position;
 	/* SCN_STYLENEEDED, SCN_DOUBLECLICK, SCN_MODIFIED, SCN_MARGINCLICK, */
 	/* SCN_NEEDSHOWN, SCN_DWELLSTART, SCN_DWELLEND, SCN_CALLTIPCLICK, */
 	/* SCN_HOTSPOTCLICK, SCN_HOTSPOTDOUBLECLICK, SCN_HOTSPOTRELEASECLICK, */
@@ -1027,7 +1067,7 @@ struct SCNotification {
 	const char *text;
 	/* SCN_MODIFIED, SCN_USERLISTSELECTION, SCN_AUTOCSELECTION, SCN_URIDROPPED */
 
-	int length;		/* SCN_MODIFIED */
+	Sci_Position length;		/* SCN_MODIFIED */
 	int linesAdded;	/* SCN_MODIFIED */
 	int message;	/* SCN_MACRORECORD */
 	uptr_t wParam;	/* SCN_MACRORECORD */
@@ -93,7 +93,7 @@ static bool InMultiWordsList( WordList &wl,
 	return (eq || begin);
 }
 
-static void ColouriseABAPDoc(unsigned int startPos, int length, int initStyle,
+static void ColouriseABAPDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
 		WordList *keywordlists[], Accessor &styler)
 {
 
@@ -306,7 +306,7 @@ static void ColouriseABAPDoc(unsigned int startPos, int length, int initStyle,
 	sc.Complete();
 }
 
-static void FoldABAPDoc(unsigned int startPos, int length, int initStyle,
+static void FoldABAPDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
 	WordList *keywordlists[], Accessor &styler)
 {
 	WordList &fold_begin = *keywordlists[2];
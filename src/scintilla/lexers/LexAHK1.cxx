@@ -85,8 +85,8 @@ static void HighlightKeyword(
 }
 
 static void ColouriseAHK1Doc(
-	unsigned int startPos,
-	int length,
+	Sci_PositionU startPos,
+	Sci_Position length,
 	int initStyle,
 	WordList *keywordlists[],
 	Accessor &styler) {
@@ -399,7 +399,7 @@ static void ColouriseAHK1Doc(
 	sc.Complete();
 }
 
-static void FoldAHK1Doc(unsigned int startPos, int length, int initStyle,
+static void FoldAHK1Doc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                         WordList *[], Accessor &styler) {
 	bool foldComment = styler.GetPropertyInt("fold.comment") != 0;
 	bool foldCompact = styler.GetPropertyInt("fold.compact", 1) != 0;
@@ -66,13 +66,13 @@ using namespace Scintilla;
 #endif
 
 static void ColouriseCamlDoc(
-	unsigned int startPos, int length,
+	Sci_PositionU startPos, Sci_Position length,
 	int initStyle,
 	WordList *keywordlists[],
 	Accessor &styler);
 
 static void FoldCamlDoc(
-	unsigned int startPos, int length,
+	Sci_PositionU startPos, Sci_Position length,
 	int initStyle,
 	WordList *keywordlists[],
 	Accessor &styler);
@@ -180,7 +180,7 @@ static
 #endif	/* BUILD_AS_EXTERNAL_LEXER */
 
 void ColouriseCamlDoc(
-	unsigned int startPos, int length,
+	Sci_PositionU startPos, Sci_Position length,
 	int initStyle,
 	WordList *keywordlists[],
 	Accessor &styler)
@@ -437,7 +437,7 @@ void ColouriseCamlDoc(
 static
 #endif	/* BUILD_AS_EXTERNAL_LEXER */
 void FoldCamlDoc(
-	unsigned int, int,
+	Sci_PositionU, Sci_Position,
 	int,
 	WordList *[],
 	Accessor &)
@@ -29,7 +29,7 @@
 using namespace Scintilla;
 #endif
 
-static void ColouriseNncrontabDoc(unsigned int startPos, int length, int, WordList
+static void ColouriseNncrontabDoc(Sci_PositionU startPos, Sci_Position length, int, WordList
 *keywordLists[], Accessor &styler)
 {
 	int state = SCE_NNCRONTAB_DEFAULT;
@@ -239,7 +239,7 @@ static void ColouriseNncrontabDoc(unsigned int startPos, int length, int, WordLi
 }
 
 //!-start-[ForthImprovement]
-static void FoldNncrontabDoc(unsigned int startPos, int length, int initStyle,
+static void FoldNncrontabDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
 	WordList *keywordlists[], Accessor &styler)
 {
 	WordList &fold_begin = *keywordlists[3];
@@ -49,7 +49,7 @@ static inline bool IsEuphoriaOperator(int ch) {
 		ch == '[' || ch == ']' || ch == '<' || ch == '>'  || ch == '?' || ch == '.');
 }
 
-static void ColouriseEuphoriaDoc(unsigned int startPos,  int length, int initStyle, WordList *keywordlists[], Accessor &styler) {
+static void ColouriseEuphoriaDoc(Sci_PositionU startPos,  Sci_Position length, int initStyle, WordList *keywordlists[], Accessor &styler) {
 	WordList &keywords = *keywordlists[0];
 	WordList &keywords2 = *keywordlists[1];
 	WordList &keywords3 = *keywordlists[2];
@@ -222,7 +222,7 @@ static bool WordStartsFold(const char *s) {
 	 return true;
 }
 
-static void FoldEuphoriaDocKeyWord(unsigned int startPos, int length, int iInitStyle, WordList *[], Accessor &styler) {
+static void FoldEuphoriaDocKeyWord(Sci_PositionU startPos, Sci_Position length, int iInitStyle, WordList *[], Accessor &styler) {
 	unsigned int lengthDoc = startPos + length;
 	int visibleChars = 0;
 	int lineCurrent = styler.GetLine(startPos);
@@ -331,10 +331,10 @@ static void FoldEuphoriaDocKeyWord(unsigned int startPos, int length, int iInitS
 }
 
 // Folding based on indentation
-static inline bool IsEuphoriaComment(Accessor &styler, int pos, int len) {
+static inline bool IsEuphoriaComment(Accessor &styler, Sci_Position pos, Sci_Position len) {
 	return len>1 && styler[pos]=='-' && styler[pos+1]=='-';
 }
-static void FoldEuphoriaDocIndent(unsigned int startPos, int length, int , WordList *[], Accessor &styler) {
+static void FoldEuphoriaDocIndent(Sci_PositionU startPos, Sci_Position length, int , WordList *[], Accessor &styler) {
 	int lengthDoc = startPos + length;
 	// Backtrack to previous line in case need to fix its fold status
 	int lineCurrent = styler.GetLine(startPos);
@@ -386,7 +386,7 @@ static const char * const euphoriaWordLists[] = {
 };
 
 // Fold document
-static void FoldEuphoriaDoc(unsigned int startPos, int length, int iInitStyle, WordList *keywords[], Accessor &styler) {
+static void FoldEuphoriaDoc(Sci_PositionU startPos, Sci_Position length, int iInitStyle, WordList *keywords[], Accessor &styler) {
 	if (0 != styler.GetPropertyInt("fold", 0)) {
 		int foldingStyle = 3 & styler.GetPropertyInt("fold", 0);
 		switch (foldingStyle) {
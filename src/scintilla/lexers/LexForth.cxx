@@ -155,7 +155,7 @@ bool is_number(char *s){
     return _is_number(s,10);
 }
 
-static void ColouriseForthDoc(unsigned int startPos, int length, int initStyle, WordList *keywordLists[], Accessor &styler)
+static void ColouriseForthDoc(Sci_PositionU startPos, Sci_Position length, int initStyle, WordList *keywordLists[], Accessor &styler)
 {
     bool stylingNoInterp = styler.GetPropertyInt("lexer.forth.no.interpretation") != 0;
 
@@ -496,7 +496,7 @@ static void ColouriseForthDoc(unsigned int startPos, int length, int initStyle,
     return;
 }
 
-static void FoldForthDoc(unsigned int startPos, int length, int initStyle,
+static void FoldForthDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
     WordList *keywordlists[], Accessor &styler)
 {
     WordList &startdefword = *keywordlists[6];
@@ -75,7 +75,7 @@ static inline bool IsAWordChar(const int ch) {
    return (ch < 0x80) && (isalnum(ch) || ch == '.' || ch == '_' || ch == '\'');
 }
 
-static void ColorizeHaskellDoc(unsigned int startPos, int length, int initStyle,
+static void ColorizeHaskellDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                                WordList *keywordlists[], Accessor &styler) {
 
    WordList &keywords = *keywordlists[0];
@@ -80,7 +80,7 @@ static int GetLotLineState(std::string &line) {
 	}
 }
 
-static void ColourizeLotDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
+static void ColourizeLotDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
 	styler.StartAt(startPos);
 	styler.StartSegment(startPos);
 	bool atLineStart = true;// Arms the 'at line start' flag
@@ -118,7 +118,7 @@ static void ColourizeLotDoc(unsigned int startPos, int length, int, WordList *[]
 // sections (headed by a set line)
 // passes (contiguous pass results within a section)
 // fails (contiguous fail results within a section)
-static void FoldLotDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
+static void FoldLotDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
 	bool foldCompact = styler.GetPropertyInt("fold.compact", 0) != 0;
 	unsigned int endPos = startPos + length;
 	int visibleChars = 0;
@@ -40,11 +40,11 @@ static bool IsOctaveCommentChar(int c) {
 	return (c == '%' || c == '#') ;
 }
 
-static bool IsMatlabComment(Accessor &styler, int pos, int len) {
+static bool IsMatlabComment(Accessor &styler, Sci_Position pos, Sci_Position len) {
 	return len > 0 && IsMatlabCommentChar(styler[pos]) ;
 }
 
-static bool IsOctaveComment(Accessor &styler, int pos, int len) {
+static bool IsOctaveComment(Accessor &styler, Sci_Position pos, Sci_Position len) {
 	return len > 0 && IsOctaveCommentChar(styler[pos]) ;
 }
 
@@ -57,7 +57,7 @@ static inline bool IsAWordStart(const int ch) {
 }
 
 static void ColouriseMatlabOctaveDoc(
-            unsigned int startPos, int length, int initStyle,
+            Sci_PositionU startPos, Sci_Position length, int initStyle,
             WordList *keywordlists[], Accessor &styler,
             bool (*IsCommentChar)(int)) {
 
@@ -160,19 +160,19 @@ static void ColouriseMatlabOctaveDoc(
 	sc.Complete();
 }
 
-static void ColouriseMatlabDoc(unsigned int startPos, int length, int initStyle,
+static void ColouriseMatlabDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                                WordList *keywordlists[], Accessor &styler) {
 	ColouriseMatlabOctaveDoc(startPos, length, initStyle, keywordlists, styler, IsMatlabCommentChar);
 }
 
-static void ColouriseOctaveDoc(unsigned int startPos, int length, int initStyle,
+static void ColouriseOctaveDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                                WordList *keywordlists[], Accessor &styler) {
 	ColouriseMatlabOctaveDoc(startPos, length, initStyle, keywordlists, styler, IsOctaveCommentChar);
 }
 
-static void FoldMatlabOctaveDoc(unsigned int startPos, int length, int,
+static void FoldMatlabOctaveDoc(Sci_PositionU startPos, Sci_Position length, int,
                                 WordList *[], Accessor &styler,
-                                bool (*IsComment)(Accessor&, int, int)) {
+                                bool (*IsComment)(Accessor&, Sci_Position, Sci_Position)) {
 
 	int endPos = startPos + length;
 
@@ -214,12 +214,12 @@ static void FoldMatlabOctaveDoc(unsigned int startPos, int length, int,
 	}
 }
 
-static void FoldMatlabDoc(unsigned int startPos, int length, int initStyle,
+static void FoldMatlabDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                           WordList *keywordlists[], Accessor &styler) {
 	FoldMatlabOctaveDoc(startPos, length, initStyle, keywordlists, styler, IsMatlabComment);
 }
 
-static void FoldOctaveDoc(unsigned int startPos, int length, int initStyle,
+static void FoldOctaveDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                           WordList *keywordlists[], Accessor &styler) {
 	FoldMatlabOctaveDoc(startPos, length, initStyle, keywordlists, styler, IsOctaveComment);
 }
@@ -701,8 +701,8 @@ static void ColouriseBatchLine(
 }
 
 static void ColouriseBatchDoc(
-    unsigned int startPos,
-    int length,
+    Sci_PositionU startPos,
+    Sci_Position length,
     int /*initStyle*/,
     WordList *keywordlists[],
     Accessor &styler) {
@@ -730,7 +730,7 @@ static void ColouriseBatchDoc(
 	}
 }
 //!-start-[BatchLexerImprovement]
-static void FoldBatchDoc(unsigned int startPos, int length, int,
+static void FoldBatchDoc(Sci_PositionU startPos, Sci_Position length, int,
     WordList *[], Accessor &styler)
 {
 	int line = styler.GetLine(startPos);
@@ -824,7 +824,7 @@ static void ColouriseDiffLine(char *lineBuffer, int endLine, Accessor &styler) {
 	}
 }
 
-static void ColouriseDiffDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
+static void ColouriseDiffDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
 	char lineBuffer[1024];
 	styler.StartAt(startPos);
 	styler.StartSegment(startPos);
@@ -843,7 +843,7 @@ static void ColouriseDiffDoc(unsigned int startPos, int length, int, WordList *[
 	}
 }
 
-static void FoldDiffDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
+static void FoldDiffDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
 	int curLine = styler.GetLine(startPos);
 	int curLineStart = styler.LineStart(curLine);
 	int prevLevel = curLine > 0 ? styler.LevelAt(curLine - 1) : SC_FOLDLEVELBASE;
@@ -923,7 +923,7 @@ static void ColourisePoLine(
 	}
 }
 
-static void ColourisePoDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
+static void ColourisePoDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
 	char lineBuffer[1024];
 	styler.StartAt(startPos);
 	styler.StartSegment(startPos);
@@ -1045,8 +1045,8 @@ static char ColourisePropsLine( // return last style //!-change-[PropsColouriseF
 	}
 	return SCE_PROPS_DEFAULT; //!-add-[PropsColouriseFix]
 }
-//!static void ColourisePropsDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
-static void ColourisePropsDoc(unsigned int startPos, int length, int, WordList *keywordlists[], Accessor &styler) { //!-change-[PropsKeysSets]
+//!static void ColourisePropsDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
+static void ColourisePropsDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *keywordlists[], Accessor &styler) { //!-change-[PropsKeysSets]
 
 	char lineBuffer[1024];
 	styler.StartAt(startPos);
@@ -1100,7 +1100,7 @@ static void ColourisePropsDoc(unsigned int startPos, int length, int, WordList *
 
 // adaption by ksc, using the "} else {" trick of 1.53
 // 030721
-static void FoldPropsDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
+static void FoldPropsDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
 	bool foldCompact = styler.GetPropertyInt("fold.compact", 1) != 0;
 
 	unsigned int endPos = startPos + length;
@@ -1254,7 +1254,7 @@ static void ColouriseMakeLine(
 	}
 }
 
-static void ColouriseMakeDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
+static void ColouriseMakeDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
 	char lineBuffer[1024];
 	styler.StartAt(startPos);
 	styler.StartSegment(startPos);
@@ -1546,7 +1546,7 @@ static void ColouriseErrorListLine(
 	}
 }
 
-static void ColouriseErrorListDoc(unsigned int startPos, int length, int, WordList *[], Accessor &styler) {
+static void ColouriseErrorListDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
 	char lineBuffer[10000];
 	styler.StartAt(startPos);
 	styler.StartSegment(startPos);
@@ -1652,7 +1652,7 @@ static bool latexLastWordIs(int start, Accessor &styler, const char *needle) {
 	return (strcmp(s, needle) == 0);
 }
 
-static void ColouriseLatexDoc(unsigned int startPos, int length, int initStyle,
+static void ColouriseLatexDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                               WordList *[], Accessor &styler) {
 
 	styler.StartAt(startPos);
@@ -1899,7 +1899,7 @@ static const char *const emptyWordListDesc[] = {
 	0
 };
 
-static void ColouriseNullDoc(unsigned int startPos, int length, int, WordList *[],
+static void ColouriseNullDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[],
                             Accessor &styler) {
 	// Null language means all style bytes are 0 so just mark the end - no need to fill in.
 	if (length > 0) {
@@ -32,7 +32,7 @@ enum kwType { kwOther, kwClass, kwDef, kwImport, kwCDef, kwCTypeName, kwCPDef };
 
 static const int indicatorWhitespace = 1;
 
-static bool IsPyComment(Accessor &styler, int pos, int len) {
+static bool IsPyComment(Accessor &styler, Sci_Position pos, Sci_Position len) {
 	return len > 0 && styler[pos] == '#';
 }
 
@@ -108,7 +108,7 @@ static inline bool IsAWordStart(int ch) {
 	return (ch < 0x80) && (isalnum(ch) || ch == '_');
 }
 
-static void ColourisePyDoc(unsigned int startPos, int length, int initStyle,
+static void ColourisePyDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
         WordList *keywordlists[], Accessor &styler) {
 
 	int endPos = startPos + length;
@@ -425,7 +425,7 @@ static bool IsQuoteLine(int line, Accessor &styler) {
 }
 
 
-static void FoldPyDoc(unsigned int startPos, int length, int /*initStyle - unused*/,
+static void FoldPyDoc(Sci_PositionU startPos, Sci_Position length, int /*initStyle - unused*/,
                       WordList *[], Accessor &styler) {
 	const int maxPos = startPos + length;
 	const int maxLines = (maxPos == styler.Length()) ? styler.GetLine(maxPos) : styler.GetLine(maxPos - 1);	// Requested last line
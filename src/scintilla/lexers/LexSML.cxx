@@ -34,7 +34,7 @@ using namespace Scintilla;
 #endif
 
 void ColouriseSMLDoc(
-	unsigned int startPos, int length,
+	Sci_PositionU startPos, Sci_Position length,
 	int initStyle,
 	WordList *keywordlists[],
 	Accessor &styler)
@@ -205,7 +205,7 @@ void ColouriseSMLDoc(
 }
 
 void FoldSMLDoc(
-	unsigned int, int,
+	Sci_PositionU, Sci_Position,
 	int,
 	WordList *[],
 	Accessor &)
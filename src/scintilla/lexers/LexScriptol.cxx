@@ -50,7 +50,7 @@ static void ClassifyWordSol(unsigned int start, unsigned int end, WordList &keyw
     strcpy(prevWord, s);
 }
 
-static bool IsSolComment(Accessor &styler, int pos, int len)
+static bool IsSolComment(Accessor &styler, Sci_Position pos, Sci_Position len)
 {
    if(len > 0)
    {
@@ -109,7 +109,7 @@ static int GetSolStringState(Accessor &styler, int i, int *nextIndex)
 }
 
 
-static void ColouriseSolDoc(unsigned int startPos, int length, int initStyle,
+static void ColouriseSolDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                             WordList *keywordlists[], Accessor &styler)
  {
 
@@ -347,7 +347,7 @@ static void ColouriseSolDoc(unsigned int startPos, int length, int initStyle,
 	}
 }
 
-static void FoldSolDoc(unsigned int startPos, int length, int initStyle,
+static void FoldSolDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
 						   WordList *[], Accessor &styler)
  {
 	int lengthDoc = startPos + length;
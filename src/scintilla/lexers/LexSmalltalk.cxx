@@ -265,7 +265,7 @@ static void handleLetter(StyleContext& sc, WordList* specialSelectorList)
     sc.ChangeState(state);
 }
 
-static void colorizeSmalltalkDoc(unsigned int startPos, int length, int initStyle, WordList *wordLists[], Accessor &styler)
+static void colorizeSmalltalkDoc(Sci_PositionU startPos, Sci_Position length, int initStyle, WordList *wordLists[], Accessor &styler)
 {
     StyleContext sc(startPos, length, initStyle, styler);
 
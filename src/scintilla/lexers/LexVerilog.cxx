@@ -36,7 +36,7 @@ static inline bool IsAWordStart(const int ch) {
 	return (ch < 0x80) && (isalnum(ch) || ch == '_' || ch == '$');
 }
 
-static void ColouriseVerilogDoc(unsigned int startPos, int length, int initStyle, WordList *keywordlists[],
+static void ColouriseVerilogDoc(Sci_PositionU startPos, Sci_Position length, int initStyle, WordList *keywordlists[],
                             Accessor &styler) {
 
 	WordList &keywords = *keywordlists[0];
@@ -172,7 +172,7 @@ static bool IsCommentLine(int line, Accessor &styler) {
 // Store both the current line's fold level and the next lines in the
 // level store to make it easy to pick up with each increment
 // and to make it possible to fiddle the current level for "} else {".
-static void FoldNoBoxVerilogDoc(unsigned int startPos, int length, int initStyle,
+static void FoldNoBoxVerilogDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
                             Accessor &styler) {
 	bool foldComment = styler.GetPropertyInt("fold.comment") != 0;
 	bool foldPreprocessor = styler.GetPropertyInt("fold.preprocessor") != 0;
@@ -335,7 +335,7 @@ static void FoldNoBoxVerilogDoc(unsigned int startPos, int length, int initStyle
 	}
 }
 
-static void FoldVerilogDoc(unsigned int startPos, int length, int initStyle, WordList *[],
+static void FoldVerilogDoc(Sci_PositionU startPos, Sci_Position length, int initStyle, WordList *[],
                        Accessor &styler) {
 	FoldNoBoxVerilogDoc(startPos, length, initStyle, styler);
 }
@@ -141,6 +141,19 @@ inline char MakeUpperCase(char ch) {
 int CompareCaseInsensitive(const char *a, const char *b);
 int CompareNCaseInsensitive(const char *a, const char *b, size_t len);
 
+//!-start-[HashText]
+const unsigned int hashTextStart = 2166136261U;
+
+// FNV-1a hash continuing from hash so that text hashed in pieces gives the same value.
+inline unsigned int HashText(const char *s, size_t length, unsigned int hash=hashTextStart) {
+	for (size_t i = 0; i < length; i++) {
+		hash ^= static_cast<unsigned char>(s[i]);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+//!-end-[HashText]
+
 #ifdef SCI_NAMESPACE
 }
 #endif
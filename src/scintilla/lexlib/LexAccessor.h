@@ -22,19 +22,19 @@ private:
 	 * in case there is some backtracking. */
 	enum {bufferSize=4000, slopSize=bufferSize/8};
 	char buf[bufferSize+1];
-	int startPos;
-	int endPos;
+	Sci_Position startPos;
+	Sci_Position endPos;
 	int codePage;
-	int lenDoc;
+	Sci_Position lenDoc;
 	int mask;
 	char styleBuf[bufferSize];
 	int validLen;
 	char chFlags;
 	char chWhile;
-	unsigned int startSeg;
-	int startPosStyling;
+	Sci_PositionU startSeg;
+	Sci_Position startPosStyling;
 
-	void Fill(int position) {
+	void Fill(Sci_Position position) {
 		startPos = position - slopSize;
 		if (startPos + bufferSize > lenDoc)
 			startPos = lenDoc - bufferSize;
@@ -55,14 +55,14 @@ public:
 		mask(127), validLen(0), chFlags(0), chWhile(0),
 		startSeg(0), startPosStyling(0) {
 	}
-	char operator[](int position) {
+	char operator[](Sci_Position position) {
 		if (position < startPos || position >= endPos) {
 			Fill(position);
 		}
 		return buf[position - startPos];
 	}
 	/** Safe version of operator[], returning a defined value for invalid position. */
-	char SafeGetCharAt(int position, char chDefault=' ') {
+	char SafeGetCharAt(Sci_Position position, char chDefault=' ') {
 		if (position < startPos || position >= endPos) {
 			Fill(position);
 			if (position < startPos || position >= endPos) {
@@ -76,7 +76,7 @@ public:
 		return pAccess->IsDBCSLeadByte(ch);
 	}
 
-	bool Match(int pos, const char *s) {
+	bool Match(Sci_Position pos, const char *s) {
 		for (int i=0; *s; i++) {
 			if (*s != SafeGetCharAt(pos+i))
 				return false;
@@ -84,23 +84,25 @@ public:
 		}
 		return true;
 	}
-	char StyleAt(int position) {
+	char StyleAt(Sci_Position position) {
 		return static_cast<char>(pAccess->StyleAt(position) & mask);
 	}
-	int GetLine(int position) {
+	int GetLine(Sci_Position position) {
 		return pAccess->LineFromPosition(position);
 	}
-	int LineStart(int line) {
+	Sci_Position LineStart(int line) {
 		return pAccess->LineStart(line);
 	}
 	int LevelAt(int line) {
 		return pAccess->GetLevel(line);
 	}
-	int Length() const {
+	Sci_Position Length() const {
 		return lenDoc;
 	}
 	void Flush() {
+		// An empty range so the next access fills the buffer whatever the position
 		startPos = extremePosition;
+		endPos = 0;
 		if (validLen > 0) {
 			pAccess->SetStyles(validLen, styleBuf);
 			startPosStyling += validLen;
@@ -114,7 +116,7 @@ public:
 		return pAccess->SetLineState(line, state);
 	}
 	// Style setting
-	void StartAt(unsigned int start, char chMask=31) {
+	void StartAt(Sci_PositionU start, char chMask=31) {
 		// Store the mask specified for use with StyleAt.
 		mask = chMask;
 		pAccess->StartStyling(start, chMask);
@@ -124,13 +126,13 @@ public:
 		chFlags = chFlags_;
 		chWhile = chWhile_;
 	}
-	unsigned int GetStartSegment() const {
+	Sci_PositionU GetStartSegment() const {
 		return startSeg;
 	}
-	void StartSegment(unsigned int pos) {
+	void StartSegment(Sci_PositionU pos) {
 		startSeg = pos;
 	}
-	void ColourTo(unsigned int pos, int chAttr) {
+	void ColourTo(Sci_PositionU pos, int chAttr) {
 		// Only perform styling if non empty range
 		if (pos != startSeg - 1) {
 			assert(pos >= startSeg);
@@ -147,7 +149,7 @@ public:
 				if (chAttr != chWhile)
 					chFlags = 0;
 				chAttr |= chFlags;
-				for (unsigned int i = startSeg; i <= pos; i++) {
+				for (Sci_PositionU i = startSeg; i <= pos; i++) {
 					assert((startPosStyling + validLen) < Length());
 					styleBuf[validLen++] = static_cast<char>(chAttr);
 				}
@@ -158,12 +160,12 @@ public:
 	void SetLevel(int line, int level) {
 		pAccess->SetLevel(line, level);
 	}
-	void IndicatorFill(int start, int end, int indicator, int value) {
+	void IndicatorFill(Sci_Position start, Sci_Position end, int indicator, int value) {
 		pAccess->DecorationSetCurrentIndicator(indicator);
 		pAccess->DecorationFillRange(start, value, end - start);
 	}
 
-	void ChangeLexerState(int start, int end) {
+	void ChangeLexerState(Sci_Position start, Sci_Position end) {
 		pAccess->ChangeLexerState(start, end);
 	}
 };
@@ -21,8 +21,8 @@
 using namespace Scintilla;
 #endif
 
-static void getRange(unsigned int start,
-		unsigned int end,
+static void getRange(Sci_PositionU start,
+		Sci_PositionU end,
 		LexAccessor &styler,
 		char *s,
 		unsigned int len) {
@@ -38,8 +38,8 @@ void StyleContext::GetCurrent(char *s, unsigned int len) {
 	getRange(styler.GetStartSegment(), currentPos - 1, styler, s, len);
 }
 
-static void getRangeLowered(unsigned int start,
-		unsigned int end,
+static void getRangeLowered(Sci_PositionU start,
+		Sci_PositionU end,
 		LexAccessor &styler,
 		char *s,
 		unsigned int len) {
@@ -25,9 +25,9 @@ static inline int MakeLowerCase(int ch) {
 // syntactically significant. UTF-8 avoids this as all trail bytes are >= 0x80
 class StyleContext {
 	LexAccessor &styler;
-	unsigned int endPos;
+	Sci_PositionU endPos;
 	StyleContext &operator=(const StyleContext &);
-	void GetNextChar(unsigned int pos) {
+	void GetNextChar(Sci_PositionU pos) {
 		chNext = static_cast<unsigned char>(styler.SafeGetCharAt(pos+1));
 		if (styler.IsLeadByte(static_cast<char>(chNext))) {
 			chNext = chNext << 8;
@@ -42,7 +42,7 @@ class StyleContext {
 	}
 
 public:
-	unsigned int currentPos;
+	Sci_PositionU currentPos;
 	bool atLineStart;
 	bool atLineEnd;
 	int state;
@@ -50,7 +50,7 @@ public:
 	int ch;
 	int chNext;
 
-	StyleContext(unsigned int startPos, unsigned int length,
+	StyleContext(Sci_PositionU startPos, Sci_PositionU length,
                         int initStyle, LexAccessor &styler_, char chMask=31) :
 		styler(styler_),
 		endPos(startPos + length),
@@ -62,8 +62,8 @@ public:
 		chNext(0) {
 		styler.StartAt(startPos, chMask);
 		styler.StartSegment(startPos);
-		atLineStart = static_cast<unsigned int>(styler.LineStart(styler.GetLine(startPos))) == startPos;
-		unsigned int pos = currentPos;
+		atLineStart = static_cast<Sci_PositionU>(styler.LineStart(styler.GetLine(startPos))) == startPos;
+		Sci_PositionU pos = currentPos;
 		ch = static_cast<unsigned char>(styler.SafeGetCharAt(pos));
 		if (styler.IsLeadByte(static_cast<char>(ch))) {
 			pos++;
@@ -113,7 +113,7 @@ public:
 		styler.ColourTo(currentPos - 1, state);
 		state = state_;
 	}
-	int LengthCurrent() {
+	Sci_Position LengthCurrent() {
 		return currentPos - styler.GetStartSegment();
 	}
 	int GetRelative(int n) {
@@ -10,10 +10,13 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <assert.h> //!-add-[HashText]
 
 #include <algorithm>
+#include <map> //!-add-[SharedWordLists]
 
 #include "WordList.h"
+#include "CharacterSet.h" //!-add-[HashText]
 
 #ifdef SCI_NAMESPACE
 using namespace Scintilla;
@@ -69,6 +72,8 @@ static char **ArrayFromWordList(char *wordlist, int *len, bool onlyLineEnds = fa
 }
 
 bool WordList::operator!=(const WordList &other) const {
+	if (shared && (shared == other.shared)) //!-add-[SharedWordLists]
+		return false; //!-add-[SharedWordLists]
 	if (len != other.len)
 		return true;
 	for (int i=0; i<len; i++) {
@@ -78,7 +83,67 @@ bool WordList::operator!=(const WordList &other) const {
 	return false;
 }
 
+//!-start-[SharedWordLists]
+/**
+ * The words of a list, split and sorted once for every WordList set to the same text.
+ * Lexers of the same language in several documents, and lexers created again when a
+ * document changes language, share the words instead of each parsing them again.
+ * Lists no longer used are kept for a while in case they are wanted again.
+ * Word lists are only set and cleared on the thread of the windows so the cache is
+ * not locked. A list in use is never changed so may be read by a lexer on any thread.
+ */
+#ifdef SCI_NAMESPACE
+namespace Scintilla {
+#endif
+
+struct SharedWordList {
+	char *text;	///< As passed to Set, to find the list again
+	size_t length;
+	unsigned int hash;
+	bool onlyLineEnds;
+	char *list;
+	char **words;
+	int len;
+	int starts[256];
+	int references;
+	unsigned long lastUse;
+};
+
+#ifdef SCI_NAMESPACE
+}
+#endif
+
+namespace {
+
+// Text of the lists kept when they are not used
+const size_t unusedLimit = 8 * 1024 * 1024;
+
+class WordListCache {
+	typedef std::multimap<unsigned int, SharedWordList *> ListMap;
+	ListMap lists;
+	size_t unusedSize;
+	unsigned long clock;
+	void Delete(ListMap::iterator it);
+	void Trim();
+public:
+	WordListCache() : unusedSize(0), clock(0) {
+	}
+	SharedWordList *Acquire(const char *s, bool onlyLineEnds);
+	void Release(SharedWordList *shared);
+};
+
+}
+
+static WordListCache &Cache();
+
+//!-end-[SharedWordLists]
 void WordList::Clear() {
+//!-start-[SharedWordLists]
+	if (shared) {
+		Cache().Release(shared);
+		shared = 0;
+	} else
+//!-end-[SharedWordLists]
 	if (words) {
 		delete []list;
 		delete []words;
@@ -106,23 +171,113 @@ static void SortWordList(char **words, unsigned int len) {
 
 #endif
 
-void WordList::Set(const char *s) {
-	Clear();
-	list = new char[strlen(s) + 1];
-	strcpy(list, s);
-	words = ArrayFromWordList(list, &len, onlyLineEnds);
+//!-start-[SharedWordLists]
+static WordListCache &Cache() {
+	// Never deleted as word lists of static objects may be cleared after it would be
+	static WordListCache *cache = new WordListCache();
+	return *cache;
+}
+
+SharedWordList *WordListCache::Acquire(const char *s, bool onlyLineEnds) {
+	const size_t length = strlen(s);
+	const unsigned int hash = HashText(s, length);
+	clock++;
+	std::pair<ListMap::iterator, ListMap::iterator> range = lists.equal_range(hash);
+	for (ListMap::iterator it = range.first; it != range.second; ++it) {
+		SharedWordList *shared = it->second;
+		if ((shared->length == length) && (shared->onlyLineEnds == onlyLineEnds) &&
+			(memcmp(shared->text, s, length) == 0)) {
+			if (shared->references == 0)
+				unusedSize -= shared->length;
+			shared->references++;
+			shared->lastUse = clock;
+			return shared;
+		}
+	}
+	SharedWordList *shared = new SharedWordList();
+	shared->text = new char[length + 1];
+	memcpy(shared->text, s, length + 1);
+	shared->length = length;
+	shared->hash = hash;
+	shared->onlyLineEnds = onlyLineEnds;
+	shared->list = new char[length + 1];
+	memcpy(shared->list, s, length + 1);
+	shared->words = ArrayFromWordList(shared->list, &shared->len, onlyLineEnds);
 #ifdef _MSC_VER
-	std::sort(words, words + len, cmpWords);
+	std::sort(shared->words, shared->words + shared->len, cmpWords);
 #else
-	SortWordList(words, len);
+	SortWordList(shared->words, shared->len);
 #endif
-	for (unsigned int k = 0; k < (sizeof(starts) / sizeof(starts[0])); k++)
-		starts[k] = -1;
-	for (int l = len - 1; l >= 0; l--) {
-		unsigned char indexChar = words[l][0];
-		starts[indexChar] = l;
+	for (unsigned int k = 0; k < (sizeof(shared->starts) / sizeof(shared->starts[0])); k++)
+		shared->starts[k] = -1;
+	for (int l = shared->len - 1; l >= 0; l--) {
+		unsigned char indexChar = shared->words[l][0];
+		shared->starts[indexChar] = l;
+	}
+	shared->references = 1;
+	shared->lastUse = clock;
+	lists.insert(ListMap::value_type(hash, shared));
+	return shared;
+}
+
+void WordListCache::Release(SharedWordList *shared) {
+	shared->references--;
+	if (shared->references == 0) {
+		unusedSize += shared->length;
+		Trim();
+	}
+}
+
+void WordListCache::Delete(ListMap::iterator it) {
+	SharedWordList *shared = it->second;
+	unusedSize -= shared->length;
+	delete []shared->text;
+	delete []shared->list;
+	delete []shared->words;
+	delete shared;
+	lists.erase(it);
+}
+
+void WordListCache::Trim() {
+	// Drop the lists unused for longest until the rest fit
+	while (unusedSize > unusedLimit) {
+		ListMap::iterator oldest = lists.end();
+		for (ListMap::iterator it = lists.begin(); it != lists.end(); ++it) {
+			if ((it->second->references == 0) &&
+				((oldest == lists.end()) || (it->second->lastUse < oldest->second->lastUse)))
+				oldest = it;
+		}
+		if (oldest == lists.end())
+			break;
+		Delete(oldest);
 	}
 }
+//!-end-[SharedWordLists]
+
+void WordList::Set(const char *s) {
+	Clear();
+//!-start-[SharedWordLists]
+	shared = Cache().Acquire(s, onlyLineEnds);
+	list = shared->list;
+	words = shared->words;
+	len = shared->len;
+	memcpy(starts, shared->starts, sizeof(starts));
+//!-end-[SharedWordLists]
+//!	list = new char[strlen(s) + 1];
+//!	strcpy(list, s);
+//!	words = ArrayFromWordList(list, &len, onlyLineEnds);
+//!#ifdef _MSC_VER
+//!	std::sort(words, words + len, cmpWords);
+//!#else
+//!	SortWordList(words, len);
+//!#endif
+//!	for (unsigned int k = 0; k < (sizeof(starts) / sizeof(starts[0])); k++)
+//!		starts[k] = -1;
+//!	for (int l = len - 1; l >= 0; l--) {
+//!		unsigned char indexChar = words[l][0];
+//!		starts[indexChar] = l;
+//!	}
+}
 
 /** Check whether a string is in the list.
  * List elements are either exact matches or prefixes.
@@ -12,6 +12,8 @@
 namespace Scintilla {
 #endif
 
+struct SharedWordList; //!-add-[SharedWordLists]
+
 /**
  */
 class WordList {
@@ -22,8 +24,10 @@ public:
 	int len;
 	bool onlyLineEnds;	///< Delimited by any white space or only line ends
 	int starts[256];
+	SharedWordList *shared;	///< Owner of words and list //!-add-[SharedWordLists]
 	WordList(bool onlyLineEnds_ = false) :
-		words(0), list(0), len(0), onlyLineEnds(onlyLineEnds_)
+//!		words(0), list(0), len(0), onlyLineEnds(onlyLineEnds_)
+		words(0), list(0), len(0), onlyLineEnds(onlyLineEnds_), shared(0) //!-change-[SharedWordLists]
 		{}
 	~WordList() { Clear(); }
 	operator bool() const { return len ? true : false; }
@@ -20,6 +20,7 @@
 
 #include "Platform.h"
 #include "Scintilla.h"
+#include "Position.h"
 #include "PlatMacOSX.h"
 
 
@@ -5,7 +5,7 @@ ExtInput.o: ExtInput.cxx ScintillaMacOSX.h TView.h TCarbonEvent.h TRect.h \
   ../lexlib/PropSetSimple.h ../include/ILexer.h ../lexlib/LexAccessor.h \
   ../lexlib/Accessor.h ../src/SVector.h ../src/SplitVector.h \
   ../src/Partitioning.h ../src/RunStyles.h ../src/ContractionState.h \
-  ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h ../src/Indicator.h \
+  ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h ../src/Indicator.h \
   ../src/XPM.h ../src/LineMarker.h ../src/Style.h ../src/AutoComplete.h \
   ../src/ViewStyle.h ../src/CharClassify.h ../src/Decoration.h \
   ../src/Document.h ../src/Selection.h ../src/PositionCache.h \
@@ -21,7 +21,7 @@ ScintillaCallTip.o: ScintillaCallTip.cxx ScintillaMacOSX.h TView.h \
   ../include/SciLexer.h ../lexlib/PropSetSimple.h ../include/ILexer.h \
   ../lexlib/LexAccessor.h ../lexlib/Accessor.h ../src/SVector.h \
   ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
-  ../src/ContractionState.h ../src/CellBuffer.h ../src/CallTip.h \
+  ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/AutoComplete.h ../src/ViewStyle.h \
   ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
@@ -34,7 +34,7 @@ ScintillaListBox.o: ScintillaListBox.cxx ScintillaMacOSX.h TView.h \
   ../include/SciLexer.h ../lexlib/PropSetSimple.h ../include/ILexer.h \
   ../lexlib/LexAccessor.h ../lexlib/Accessor.h ../src/SVector.h \
   ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
-  ../src/ContractionState.h ../src/CellBuffer.h ../src/CallTip.h \
+  ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/AutoComplete.h ../src/ViewStyle.h \
   ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
@@ -47,7 +47,7 @@ ScintillaMacOSX.o: ScintillaMacOSX.cxx ScintillaMacOSX.h TView.h \
   ../include/SciLexer.h ../lexlib/PropSetSimple.h ../include/ILexer.h \
   ../lexlib/LexAccessor.h ../lexlib/Accessor.h ../src/SVector.h \
   ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
-  ../src/ContractionState.h ../src/CellBuffer.h ../src/CallTip.h \
+  ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/AutoComplete.h ../src/ViewStyle.h \
   ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
@@ -64,7 +64,7 @@ Catalogue.o: ../src/Catalogue.cxx ../include/ILexer.h \
   ../src/Catalogue.h
 CellBuffer.o: ../src/CellBuffer.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/CellBuffer.h
+  ../src/ChunkedVector.h ../src/CellBuffer.h ../lexlib/CharacterSet.h
 CharClassify.o: ../src/CharClassify.cxx ../src/CharClassify.h
 ContractionState.o: ../src/ContractionState.cxx ../include/Platform.h \
   ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
@@ -74,12 +74,12 @@ Decoration.o: ../src/Decoration.cxx ../include/Platform.h \
   ../src/RunStyles.h ../src/Decoration.h
 Document.o: ../src/Document.cxx ../include/Platform.h ../include/ILexer.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+  ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/PerLine.h \
   ../src/CharClassify.h ../lexlib/CharacterSet.h ../src/Decoration.h \
-  ../src/Document.h ../src/RESearch.h ../src/UniConversion.h
+  ../src/Document.h ../src/BackgroundLexer.h ../src/RESearch.h ../src/DFASearch.h ../src/UniConversion.h
 Editor.o: ../src/Editor.cxx ../include/Platform.h ../include/ILexer.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/ContractionState.h ../src/CellBuffer.h \
+  ../src/RunStyles.h ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../src/Document.h ../src/Selection.h \
@@ -95,15 +95,23 @@ LineMarker.o: ../src/LineMarker.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/XPM.h ../src/LineMarker.h
 PerLine.o: ../src/PerLine.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/CellBuffer.h ../src/PerLine.h
+  ../src/ChunkedVector.h ../src/CellBuffer.h ../src/PerLine.h
 PositionCache.o: ../src/PositionCache.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/ContractionState.h ../src/CellBuffer.h \
+  ../src/RunStyles.h ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../include/ILexer.h ../src/Document.h \
   ../src/Selection.h ../src/PositionCache.h
 RESearch.o: ../src/RESearch.cxx ../src/CharClassify.h ../src/RESearch.h
+DFASearch.o: ../src/DFASearch.cxx ../src/CharClassify.h ../src/RESearch.h \
+ ../src/DFASearch.h
+BackgroundLexer.o: ../src/BackgroundLexer.cxx ../include/Platform.h \
+  ../include/ILexer.h ../include/Scintilla.h ../src/Position.h \
+  ../src/SplitVector.h ../src/Partitioning.h ../src/ChunkedVector.h \
+  ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+  ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
+  ../src/BackgroundLexer.h
 RunStyles.o: ../src/RunStyles.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
   ../src/RunStyles.h
@@ -111,7 +119,7 @@ ScintillaBase.o: ../src/ScintillaBase.cxx ../include/Platform.h \
   ../include/ILexer.h ../include/Scintilla.h ../lexlib/PropSetSimple.h \
   ../include/SciLexer.h ../lexlib/LexerModule.h ../src/Catalogue.h \
   ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
-  ../src/ContractionState.h ../src/CellBuffer.h ../src/CallTip.h \
+  ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h ../src/AutoComplete.h \
   ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
@@ -151,7 +159,7 @@ LexerSimple.o: ../lexlib/LexerSimple.cxx ../include/ILexer.h \
 PropSetSimple.o: ../lexlib/PropSetSimple.cxx ../lexlib/PropSetSimple.h
 StyleContext.o: ../lexlib/StyleContext.cxx ../include/ILexer.h \
   ../lexlib/LexAccessor.h ../lexlib/Accessor.h ../lexlib/StyleContext.h
-WordList.o: ../lexlib/WordList.cxx ../lexlib/WordList.h
+WordList.o: ../lexlib/WordList.cxx ../lexlib/WordList.h ../lexlib/CharacterSet.h
 AutoComplete.o: ../src/AutoComplete.cxx ../include/Platform.h \
   ../lexlib/CharacterSet.h ../src/AutoComplete.h
 CallTip.o: ../src/CallTip.cxx ../include/Platform.h \
@@ -161,7 +169,7 @@ Catalogue.o: ../src/Catalogue.cxx ../include/ILexer.h \
   ../src/Catalogue.h
 CellBuffer.o: ../src/CellBuffer.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/CellBuffer.h
+  ../src/ChunkedVector.h ../src/CellBuffer.h ../lexlib/CharacterSet.h
 CharClassify.o: ../src/CharClassify.cxx ../src/CharClassify.h
 ContractionState.o: ../src/ContractionState.cxx ../include/Platform.h \
   ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
@@ -171,12 +179,12 @@ Decoration.o: ../src/Decoration.cxx ../include/Platform.h \
   ../src/RunStyles.h ../src/Decoration.h
 Document.o: ../src/Document.cxx ../include/Platform.h ../include/ILexer.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+  ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/PerLine.h \
   ../src/CharClassify.h ../lexlib/CharacterSet.h ../src/Decoration.h \
-  ../src/Document.h ../src/RESearch.h ../src/UniConversion.h
+  ../src/Document.h ../src/BackgroundLexer.h ../src/RESearch.h ../src/DFASearch.h ../src/UniConversion.h
 Editor.o: ../src/Editor.cxx ../include/Platform.h ../include/ILexer.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/ContractionState.h ../src/CellBuffer.h \
+  ../src/RunStyles.h ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../src/Document.h ../src/Selection.h \
@@ -192,15 +200,23 @@ LineMarker.o: ../src/LineMarker.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/XPM.h ../src/LineMarker.h
 PerLine.o: ../src/PerLine.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/CellBuffer.h ../src/PerLine.h
+  ../src/ChunkedVector.h ../src/CellBuffer.h ../src/PerLine.h
 PositionCache.o: ../src/PositionCache.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/ContractionState.h ../src/CellBuffer.h \
+  ../src/RunStyles.h ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../include/ILexer.h ../src/Document.h \
   ../src/Selection.h ../src/PositionCache.h
 RESearch.o: ../src/RESearch.cxx ../src/CharClassify.h ../src/RESearch.h
+DFASearch.o: ../src/DFASearch.cxx ../src/CharClassify.h ../src/RESearch.h \
+ ../src/DFASearch.h
+BackgroundLexer.o: ../src/BackgroundLexer.cxx ../include/Platform.h \
+  ../include/ILexer.h ../include/Scintilla.h ../src/Position.h \
+  ../src/SplitVector.h ../src/Partitioning.h ../src/ChunkedVector.h \
+  ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+  ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
+  ../src/BackgroundLexer.h
 RunStyles.o: ../src/RunStyles.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
   ../src/RunStyles.h
@@ -208,7 +224,7 @@ ScintillaBase.o: ../src/ScintillaBase.cxx ../include/Platform.h \
   ../include/ILexer.h ../include/Scintilla.h ../lexlib/PropSetSimple.h \
   ../include/SciLexer.h ../lexlib/LexerModule.h ../src/Catalogue.h \
   ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
-  ../src/ContractionState.h ../src/CellBuffer.h ../src/CallTip.h \
+  ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h \
   ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h ../src/AutoComplete.h \
   ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
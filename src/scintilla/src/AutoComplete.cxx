@@ -12,6 +12,8 @@
 
 #include "Platform.h"
 
+#include "Scintilla.h"
+#include "Position.h"
 #include "CharacterSet.h"
 #include "AutoComplete.h"
 
@@ -30,7 +32,9 @@ AutoComplete::AutoComplete() :
 	startLen(0),
 	cancelAtStartPos(true),
 	autoHide(true),
-	dropRestOfWord(false)	{
+//!	dropRestOfWord(false)	{
+	dropRestOfWord(false), //!-change-[FuzzyAutoComplete]
+	fuzzy(false) { //!-add-[FuzzyAutoComplete]
 	lb = ListBox::Allocate();
 	stopChars[0] = '\0';
 	fillUpChars[0] = '\0';
@@ -49,7 +53,7 @@ bool AutoComplete::Active() const {
 }
 
 void AutoComplete::Start(Window &parent, int ctrlID,
-	int position, Point location, int startLen_,
+	Position position, Point location, int startLen_,
 	int lineHeight, bool unicodeMode, int technology) {
 	if (active) {
 		Cancel();
@@ -125,10 +129,41 @@ void AutoComplete::Move(int delta) {
 	lb->Select(current);
 }
 
+//!-start-[FuzzyAutoComplete]
+static bool ContainsInOrder(const char *item, const char *word) {
+	for (; *word; word++) {
+		const char ch = MakeUpperCase(*word);
+		while (*item && (MakeUpperCase(*item) != ch))
+			item++;
+		if (!*item)
+			return false;
+		item++;
+	}
+	return true;
+}
+//!-end-[FuzzyAutoComplete]
+
 void AutoComplete::Select(const char *word) {
 	size_t lenWord = strlen(word);
 	int location = -1;
 	const int maxItemLen=1000;
+//!-start-[FuzzyAutoComplete]
+	if (fuzzy) {
+		// Ranked lists are not sorted so choose the best item that still matches
+		const int items = lb->Length();
+		for (int i = 0; (i < items) && (location == -1); i++) {
+			char item[maxItemLen];
+			lb->GetValue(i, item, maxItemLen);
+			if (ContainsInOrder(item, word))
+				location = i;
+		}
+		if (location == -1 && autoHide)
+			Cancel();
+		else
+			lb->Select(location);
+		return;
+	}
+//!-end-[FuzzyAutoComplete]
 	int start = 0; // lower bound of the api array block to search
 	int end = lb->Length() - 1; // upper bound of the api array block to search
 	while ((start <= end) && (location == -1)) { // Binary searching loop
@@ -25,12 +25,14 @@ public:
 	bool ignoreCase;
 	bool chooseSingle;
 	ListBox *lb;
-	int posStart;
+	Position posStart;
 	int startLen;
 	/// Should autocompletion be canceled if editor's currentPos <= startPos?
 	bool cancelAtStartPos;
 	bool autoHide;
 	bool dropRestOfWord;
+	/// The list is ranked by the container and items match when they contain the characters typed in order
+	bool fuzzy; //!-add-[FuzzyAutoComplete]
 
 	AutoComplete();
 	~AutoComplete();
@@ -39,7 +41,7 @@ public:
 	bool Active() const;
 
 	/// Display the auto completion list positioned to be near a character position
-	void Start(Window &parent, int ctrlID, int position, Point location,
+	void Start(Window &parent, int ctrlID, Position position, Point location,
 		int startLen_, int lineHeight, bool unicodeMode, int technology);
 
 	/// The stop chars are characters which, when typed, cause the auto completion list to disappear
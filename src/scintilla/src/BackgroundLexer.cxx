@@ -0,0 +1,636 @@
+// Scintilla source code edit control
+/** @file BackgroundLexer.cxx
+ ** Lexing a copy of a document on another thread.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <new>
+
+#include "Platform.h"
+
+#include "ILexer.h"
+#include "Scintilla.h"
+#include "Position.h"
+
+#include "SplitVector.h"
+#include "Partitioning.h"
+#include "ChunkedVector.h"
+#include "RunStyles.h"
+#include "CellBuffer.h"
+#include "PerLine.h"
+#include "CharClassify.h"
+#include "Decoration.h"
+#include "Document.h"
+#include "BackgroundLexer.h"
+
+#ifdef SCI_NAMESPACE
+using namespace Scintilla;
+#endif
+
+// Text lexed between handing back results. Small enough that the window thread
+// does not wait long when it needs the lexer itself.
+static const Position lexChunkLength = 0x10000;
+
+// Time the window thread spends applying chunks each time it is idle.
+static const double publishSeconds = 0.02;
+
+#ifdef SCI_NAMESPACE
+namespace Scintilla {
+#endif
+
+struct LexFill {
+	int indicator;
+	Position position;
+	int value;
+	Position fillLength;
+};
+
+/// What lexing one chunk of the snapshot changed.
+struct LexChunk {
+	Position styleStart;
+	std::vector<char> styles;
+	char mask;
+	int levelLine;
+	std::vector<int> levels;
+	int stateLine;
+	std::vector<int> lineStates;
+	std::vector<LexFill> fills;
+	Position changeStart;
+	Position changeEnd;
+	int errorStatus;
+};
+
+/**
+ * Copy of the text, styles, fold levels and line states of a document that lexers
+ * can work on while the document itself is used by the window thread.
+ * Held in split vectors like the document so edits can be applied to the copy.
+ * Records the extent of what the lexer changes so it can be copied into a chunk.
+ */
+class LexSnapshot : public IDocument {
+	SplitVector<char> text;
+	SplitVector<char> styles;
+	Partitioning<Position> lineStarts;
+	SplitVector<int> levels;
+	SplitVector<int> lineStates;
+	Position length;
+	int codePage;
+	bool leadBytes[256];
+	int tabInChars;
+
+	Position stylingPos;
+	char stylingMask;
+
+	// What has changed since the last chunk was taken
+	Position styledStart;
+	Position styledEnd;
+	char maskUsed;
+	int levelStart;
+	int levelEnd;
+	int stateStart;
+	int stateEnd;
+	int indicatorCurrent;
+	std::vector<LexFill> fills;
+	Position changeStart;
+	Position changeEnd;
+	int errorStatus;
+
+	void ResetChanges();
+	void RefreshLines(Document *pdoc, int lineStart, int lineEnd);
+	void CheckLineStart(Document *pdoc, int line);
+
+public:
+	int stylingBitsMask;
+
+	explicit LexSnapshot(Document *pdoc);
+	virtual ~LexSnapshot() {
+	}
+	LexChunk *TakeChunk();
+	void Refresh(Document *pdoc, Position start, Position end);
+	/// Whether the copy has the length, lines and settings of pdoc.
+	bool Matches(Document *pdoc) const;
+	void InsertText(Document *pdoc, Position position, Position insertLength, int linesAdded);
+	void DeleteText(Document *pdoc, Position position, Position deleteLength, int linesRemoved);
+
+	virtual int SCI_METHOD Version() const {
+		return dvOriginal;
+	}
+	virtual void SCI_METHOD SetErrorStatus(int status) {
+		errorStatus = status;
+	}
+	virtual Position SCI_METHOD Length() const {
+		return length;
+	}
+	virtual void SCI_METHOD GetCharRange(char *buffer, Position position, Position lengthRetrieve) const;
+	virtual char SCI_METHOD StyleAt(Position position) const {
+		return styles.ValueAt(position);
+	}
+	virtual int SCI_METHOD LineFromPosition(Position position) const;
+	virtual Position SCI_METHOD LineStart(int line) const;
+	virtual int SCI_METHOD GetLevel(int line) const {
+		return ((line >= 0) && (line < levels.Length())) ? levels.ValueAt(line) : SC_FOLDLEVELBASE;
+	}
+	virtual int SCI_METHOD SetLevel(int line, int level);
+	virtual int SCI_METHOD GetLineState(int line) const {
+		return lineStates.ValueAt(line);
+	}
+	virtual int SCI_METHOD SetLineState(int line, int state);
+	virtual void SCI_METHOD StartStyling(Position position, char mask);
+	virtual bool SCI_METHOD SetStyleFor(Position lengthStyle, char style);
+	virtual bool SCI_METHOD SetStyles(Position lengthStyles, const char *stylesSet);
+	virtual void SCI_METHOD DecorationSetCurrentIndicator(int indicator) {
+		indicatorCurrent = indicator;
+	}
+	virtual void SCI_METHOD DecorationFillRange(Position position, int value, Position fillLength);
+	virtual void SCI_METHOD ChangeLexerState(Position start, Position end);
+	virtual int SCI_METHOD CodePage() const {
+		return codePage;
+	}
+	virtual bool SCI_METHOD IsDBCSLeadByte(char ch) const {
+		return leadBytes[static_cast<unsigned char>(ch)];
+	}
+	virtual const char * SCI_METHOD BufferPointer() {
+		return text.BufferPointer();
+	}
+	virtual int SCI_METHOD GetLineIndentation(int line);
+};
+
+#ifdef SCI_NAMESPACE
+}
+#endif
+
+LexSnapshot::LexSnapshot(Document *pdoc) : lineStarts(256) {
+	length = pdoc->Length();
+	text.InsertValue(0, length, 0);
+	pdoc->GetCharRange(text.BufferPointer(), 0, length);
+	styles.InsertValue(0, length, 0);
+	pdoc->GetStyleRange(reinterpret_cast<unsigned char *>(styles.BufferPointer()), 0, length);
+	const int lines = pdoc->LinesTotal();
+	lineStarts.InsertText(0, length);
+	levels.InsertValue(0, lines, 0);
+	lineStates.InsertValue(0, lines, 0);
+	int *levelsCopy = levels.BufferPointer();
+	int *lineStatesCopy = lineStates.BufferPointer();
+	for (int line = 0; line < lines; line++) {
+		if (line > 0)
+			lineStarts.InsertPartition(line, pdoc->LineStart(line));
+		levelsCopy[line] = pdoc->GetLevel(line);
+		lineStatesCopy[line] = pdoc->GetLineState(line);
+	}
+	codePage = pdoc->dbcsCodePage;
+	for (int ch = 0; ch < 256; ch++) {
+		leadBytes[ch] = pdoc->IsDBCSLeadByte(static_cast<char>(ch));
+	}
+	tabInChars = pdoc->tabInChars;
+	stylingBitsMask = pdoc->stylingBitsMask;
+	stylingPos = 0;
+	stylingMask = 0;
+	indicatorCurrent = 0;
+	ResetChanges();
+}
+
+void LexSnapshot::ResetChanges() {
+	styledStart = length;
+	styledEnd = 0;
+	maskUsed = 0;
+	levelStart = static_cast<int>(levels.Length());
+	levelEnd = 0;
+	stateStart = static_cast<int>(lineStates.Length());
+	stateEnd = 0;
+	fills.clear();
+	changeStart = length;
+	changeEnd = 0;
+	errorStatus = 0;
+}
+
+void LexSnapshot::RefreshLines(Document *pdoc, int lineStart, int lineEnd) {
+	lineStart = Platform::Maximum(lineStart, 0);
+	lineEnd = Platform::Minimum(lineEnd, static_cast<int>(levels.Length()));
+	for (int line = lineStart; line < lineEnd; line++) {
+		levels.SetValueAt(line, pdoc->GetLevel(line));
+		lineStates.SetValueAt(line, pdoc->GetLineState(line));
+	}
+}
+
+/// Copy again what the window thread styled between start and end as the text is the same.
+void LexSnapshot::Refresh(Document *pdoc, Position start, Position end) {
+	start = MaxPosition(MinPosition(start, end), 0);
+	end = MinPosition(MaxPosition(start, end), length);
+	if (start < end) {
+		std::vector<unsigned char> stylesDocument(end - start);
+		pdoc->GetStyleRange(&stylesDocument[0], start, end - start);
+		for (Position pos = start; pos < end; pos++)
+			styles[pos] = static_cast<char>(stylesDocument[pos - start]);
+	}
+	RefreshLines(pdoc, LineFromPosition(start), LineFromPosition(end) + 2);
+	ResetChanges();
+}
+
+bool LexSnapshot::Matches(Document *pdoc) const {
+	return (length == pdoc->Length()) && (lineStarts.Partitions() == pdoc->LinesTotal()) &&
+		(codePage == pdoc->dbcsCodePage) && (tabInChars == pdoc->tabInChars) &&
+		(stylingBitsMask == pdoc->stylingBitsMask);
+}
+
+// Joining or splitting a CR LF pair can move the start of a line next to a change
+void LexSnapshot::CheckLineStart(Document *pdoc, int line) {
+	if ((line > 0) && (line < lineStarts.Partitions()) && (line < pdoc->LinesTotal()) &&
+		(lineStarts.PositionFromPartition(line) != pdoc->LineStart(line))) {
+		lineStarts.RemovePartition(line);
+		lineStarts.InsertPartition(line, pdoc->LineStart(line));
+	}
+}
+
+/// Called after pdoc has had text inserted so new lines can be copied from it.
+void LexSnapshot::InsertText(Document *pdoc, Position position, Position insertLength, int linesAdded) {
+	const int line = LineFromPosition(position);
+	std::vector<char> inserted(insertLength);
+	pdoc->GetCharRange(&inserted[0], position, insertLength);
+	text.InsertFromArray(position, &inserted[0], 0, insertLength);
+	pdoc->GetStyleRange(reinterpret_cast<unsigned char *>(&inserted[0]), position, insertLength);
+	styles.InsertFromArray(position, &inserted[0], 0, insertLength);
+	length += insertLength;
+	lineStarts.InsertText(line, insertLength);
+	for (int lineAdded = line + 1; lineAdded <= line + linesAdded; lineAdded++)
+		lineStarts.InsertPartition(lineAdded, pdoc->LineStart(lineAdded));
+	CheckLineStart(pdoc, line);
+	CheckLineStart(pdoc, line + linesAdded + 1);
+	if (linesAdded > 0) {
+		levels.InsertValue(line + 1, linesAdded, 0);
+		lineStates.InsertValue(line + 1, linesAdded, 0);
+	}
+	RefreshLines(pdoc, line - 1, line + linesAdded + 2);
+	ResetChanges();
+}
+
+/// Called after pdoc has had text deleted.
+void LexSnapshot::DeleteText(Document *pdoc, Position position, Position deleteLength, int linesRemoved) {
+	const int line = LineFromPosition(position);
+	text.DeleteRange(position, deleteLength);
+	styles.DeleteRange(position, deleteLength);
+	length -= deleteLength;
+	linesRemoved = Platform::Minimum(linesRemoved, lineStarts.Partitions() - line - 1);
+	for (int lineRemoved = 0; lineRemoved < linesRemoved; lineRemoved++)
+		lineStarts.RemovePartition(line + 1);
+	lineStarts.InsertText(line, -deleteLength);
+	CheckLineStart(pdoc, line);
+	CheckLineStart(pdoc, line + 1);
+	if (linesRemoved > 0) {
+		levels.DeleteRange(line + 1, linesRemoved);
+		lineStates.DeleteRange(line + 1, linesRemoved);
+	}
+	RefreshLines(pdoc, line - 1, line + 2);
+	ResetChanges();
+}
+
+LexChunk *LexSnapshot::TakeChunk() {
+	LexChunk *chunk = new LexChunk();
+	chunk->styleStart = styledStart;
+	if (styledStart < styledEnd) {
+		chunk->styles.resize(styledEnd - styledStart);
+		styles.GetRange(&chunk->styles[0], styledStart, styledEnd - styledStart);
+	}
+	chunk->mask = maskUsed;
+	chunk->levelLine = levelStart;
+	if (levelStart < levelEnd) {
+		chunk->levels.resize(levelEnd - levelStart);
+		levels.GetRange(&chunk->levels[0], levelStart, levelEnd - levelStart);
+	}
+	chunk->stateLine = stateStart;
+	if (stateStart < stateEnd) {
+		chunk->lineStates.resize(stateEnd - stateStart);
+		lineStates.GetRange(&chunk->lineStates[0], stateStart, stateEnd - stateStart);
+	}
+	chunk->fills = fills;
+	chunk->changeStart = changeStart;
+	chunk->changeEnd = changeEnd;
+	chunk->errorStatus = errorStatus;
+	ResetChanges();
+	return chunk;
+}
+
+void SCI_METHOD LexSnapshot::GetCharRange(char *buffer, Position position, Position lengthRetrieve) const {
+	const Position start = MaxPosition(position, 0);
+	const Position end = MinPosition(position + lengthRetrieve, length);
+	if ((start > position) || (end < position + lengthRetrieve))
+		memset(buffer, 0, lengthRetrieve);
+	if (start < end)
+		text.GetRange(buffer + (start - position), start, end - start);
+}
+
+int SCI_METHOD LexSnapshot::LineFromPosition(Position position) const {
+	if (position <= 0)
+		return 0;
+	return lineStarts.PartitionFromPosition(position);
+}
+
+Position SCI_METHOD LexSnapshot::LineStart(int line) const {
+	if (line < 0)
+		return 0;
+	else if (line >= lineStarts.Partitions())
+		return length;
+	else
+		return lineStarts.PositionFromPartition(line);
+}
+
+int SCI_METHOD LexSnapshot::SetLevel(int line, int level) {
+	if ((line < 0) || (line >= levels.Length()))
+		return SC_FOLDLEVELBASE;
+	const int prev = levels[line];
+	if (prev != level) {
+		levels[line] = level;
+		levelStart = Platform::Minimum(levelStart, line);
+		levelEnd = Platform::Maximum(levelEnd, line + 1);
+	}
+	return prev;
+}
+
+int SCI_METHOD LexSnapshot::SetLineState(int line, int state) {
+	if ((line < 0) || (line >= lineStates.Length()))
+		return 0;
+	const int prev = lineStates[line];
+	if (prev != state) {
+		lineStates[line] = state;
+		stateStart = Platform::Minimum(stateStart, line);
+		stateEnd = Platform::Maximum(stateEnd, line + 1);
+	}
+	return prev;
+}
+
+void SCI_METHOD LexSnapshot::StartStyling(Position position, char mask) {
+	stylingPos = position;
+	stylingMask = mask;
+	maskUsed |= mask;
+}
+
+bool SCI_METHOD LexSnapshot::SetStyleFor(Position lengthStyle, char style) {
+	const Position end = MinPosition(stylingPos + lengthStyle, length);
+	if (stylingPos < end) {
+		styledStart = MinPosition(styledStart, stylingPos);
+		styledEnd = MaxPosition(styledEnd, end);
+		for (Position pos = stylingPos; pos < end; pos++)
+			styles[pos] = static_cast<char>((styles[pos] & ~stylingMask) | (style & stylingMask));
+	}
+	stylingPos += lengthStyle;
+	return true;
+}
+
+bool SCI_METHOD LexSnapshot::SetStyles(Position lengthStyles, const char *stylesSet) {
+	const Position end = MinPosition(stylingPos + lengthStyles, length);
+	if (stylingPos < end) {
+		styledStart = MinPosition(styledStart, stylingPos);
+		styledEnd = MaxPosition(styledEnd, end);
+		for (Position pos = stylingPos; pos < end; pos++)
+			styles[pos] = static_cast<char>((styles[pos] & ~stylingMask) | (stylesSet[pos - stylingPos] & stylingMask));
+	}
+	stylingPos += lengthStyles;
+	return true;
+}
+
+void SCI_METHOD LexSnapshot::DecorationFillRange(Position position, int value, Position fillLength) {
+	LexFill fill = { indicatorCurrent, position, value, fillLength };
+	fills.push_back(fill);
+}
+
+void SCI_METHOD LexSnapshot::ChangeLexerState(Position start, Position end) {
+	changeStart = MinPosition(changeStart, start);
+	changeEnd = MaxPosition(changeEnd, end);
+}
+
+int SCI_METHOD LexSnapshot::GetLineIndentation(int line) {
+	int indent = 0;
+	if ((line >= 0) && (line < lineStarts.Partitions())) {
+		for (Position i = LineStart(line); i < length; i++) {
+			const char ch = text[i];
+			if (ch == ' ')
+				indent++;
+			else if (ch == '\t')
+				indent = ((indent / tabInChars) + 1) * tabInChars;
+			else
+				return indent;
+		}
+	}
+	return indent;
+}
+
+BackgroundLexer::BackgroundLexer() : lexing(ThreadLock::Allocate()), queue(ThreadLock::Allocate()),
+	thread(0), snapshot(0), instance(0), startPos(0), cancelling(false), finished(false),
+	published(0), lexedStart(0), lexedEnd(0), staleStart(0), staleEnd(0), applying(false),
+	stopped(false) {
+}
+
+BackgroundLexer::~BackgroundLexer() {
+	Stop();
+	delete queue;
+	delete lexing;
+}
+
+void BackgroundLexer::LexThread(void *pLexer) {
+	static_cast<BackgroundLexer *>(pLexer)->Run();
+}
+
+void BackgroundLexer::Run() {
+	const Position length = snapshot->Length();
+	Position pos = startPos;
+	while ((pos < length) && !cancelling) {
+		Position end = snapshot->LineStart(snapshot->LineFromPosition(pos + lexChunkLength) + 1);
+		if (end > length)
+			end = length;
+		LexChunk *chunk = 0;
+		try {
+			LexingLock lock(this);
+			const int styleStart = (pos > 0) ? (snapshot->StyleAt(pos - 1) & snapshot->stylingBitsMask) : 0;
+			instance->Lex(pos, end - pos, styleStart, snapshot);
+			instance->Fold(pos, end - pos, styleStart, snapshot);
+			chunk = snapshot->TakeChunk();
+		} catch (...) {
+			// Out of memory: leave the rest to be styled on the window thread
+			break;
+		}
+		if (!chunk->styles.empty())
+			lexedStart = MinPosition(lexedStart, chunk->styleStart);
+		if (!chunk->levels.empty())
+			lexedStart = MinPosition(lexedStart, snapshot->LineStart(chunk->levelLine));
+		if (!chunk->lineStates.empty())
+			lexedStart = MinPosition(lexedStart, snapshot->LineStart(chunk->stateLine));
+		lexedEnd = end;
+		// The window thread may free the chunk once it is queued
+		queue->Lock();
+		chunks.push_back(chunk);
+		queue->Unlock();
+		pos = end;
+	}
+	finished = true;
+}
+
+bool BackgroundLexer::Start(Document *pdoc, ILexer *instance_, Position start) {
+	if (thread || !snapshot || (instance != instance_) || !snapshot->Matches(pdoc)) {
+		Stop();
+		try {
+			snapshot = new LexSnapshot(pdoc);
+		} catch (std::bad_alloc &) {
+			snapshot = 0;
+			return false;
+		}
+		instance = instance_;
+		staleStart = 0;
+		staleEnd = 0;
+	}
+	if (!Resume(pdoc, start)) {
+		Stop();
+		return false;
+	}
+	return true;
+}
+
+bool BackgroundLexer::Restart(Document *pdoc, Position start) {
+	if (!thread || !snapshot->Matches(pdoc))
+		return false;
+	EndThread();
+	return Resume(pdoc, start);
+}
+
+/// Start the thread again on the copy once what the window thread changed is copied.
+bool BackgroundLexer::Resume(Document *pdoc, Position start) {
+	if (staleStart < staleEnd)
+		snapshot->Refresh(pdoc, staleStart, staleEnd);
+	staleStart = 0;
+	staleEnd = 0;
+	startPos = pdoc->LineStart(pdoc->LineFromPosition(start));
+	cancelling = false;
+	finished = false;
+	published = pdoc->GetEndStyled();
+	lexedStart = startPos;
+	lexedEnd = startPos;
+	thread = BackgroundThread::Start(LexThread, this);
+	return thread != 0;
+}
+
+void BackgroundLexer::EndThread() {
+	if (thread) {
+		cancelling = true;
+		thread->Join();
+		delete thread;
+		thread = 0;
+		// The copy has styles from chunks that are not going to be applied
+		Styled(lexedStart, lexedEnd);
+	}
+	for (std::deque<LexChunk *>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+		delete *it;
+	chunks.clear();
+}
+
+void BackgroundLexer::Stop() {
+	if (thread) {
+		stopped = true;
+		etStopped.Duration(true);
+	}
+	EndThread();
+	delete snapshot;
+	snapshot = 0;
+	instance = 0;
+}
+
+void BackgroundLexer::Suspend() {
+	if (thread) {
+		stopped = true;
+		etStopped.Duration(true);
+	}
+	EndThread();
+}
+
+void BackgroundLexer::TextChanged(Document *pdoc, Position position, Position lengthChange, int linesAdded) {
+	if (!snapshot)
+		return;
+	try {
+		if (lengthChange > 0)
+			snapshot->InsertText(pdoc, position, lengthChange, linesAdded);
+		else
+			snapshot->DeleteText(pdoc, position, -lengthChange, -linesAdded);
+	} catch (std::bad_alloc &) {
+		Stop();
+		return;
+	}
+	if (!snapshot->Matches(pdoc)) {
+		Stop();
+		return;
+	}
+	// Move the stale range with the text after the change
+	if (lengthChange > 0) {
+		if (staleStart > position)
+			staleStart += lengthChange;
+		if (staleEnd > position)
+			staleEnd += lengthChange;
+	} else {
+		if (staleStart > position)
+			staleStart = MaxPosition(position, staleStart + lengthChange);
+		if (staleEnd > position)
+			staleEnd = MaxPosition(position, staleEnd + lengthChange);
+	}
+}
+
+void BackgroundLexer::Styled(Position start, Position end) {
+	if (!snapshot || applying || (start >= end))
+		return;
+	if (staleStart < staleEnd) {
+		staleStart = MinPosition(staleStart, start);
+		staleEnd = MaxPosition(staleEnd, end);
+	} else {
+		staleStart = start;
+		staleEnd = end;
+	}
+}
+
+double BackgroundLexer::SinceStopped() {
+	return stopped ? etStopped.Duration() : 1e10;
+}
+
+void BackgroundLexer::Apply(Document *pdoc, const LexChunk &chunk) {
+	if (!chunk.styles.empty()) {
+		pdoc->StartStyling(chunk.styleStart, chunk.mask);
+		pdoc->SetStyles(static_cast<Position>(chunk.styles.size()), &chunk.styles[0]);
+	}
+	for (size_t i = 0; i < chunk.levels.size(); i++)
+		pdoc->SetLevel(chunk.levelLine + static_cast<int>(i), chunk.levels[i]);
+	for (size_t i = 0; i < chunk.lineStates.size(); i++)
+		pdoc->SetLineState(chunk.stateLine + static_cast<int>(i), chunk.lineStates[i]);
+	for (std::vector<LexFill>::const_iterator it = chunk.fills.begin(); it != chunk.fills.end(); ++it) {
+		pdoc->DecorationSetCurrentIndicator(it->indicator);
+		pdoc->DecorationFillRange(it->position, it->value, it->fillLength);
+	}
+	if (chunk.changeStart < chunk.changeEnd)
+		pdoc->ChangeLexerState(chunk.changeStart, chunk.changeEnd);
+	if (chunk.errorStatus)
+		pdoc->SetErrorStatus(chunk.errorStatus);
+}
+
+bool BackgroundLexer::Publish(Document *pdoc) {
+	if (!thread)
+		return false;
+	ElapsedTime et;
+	for (;;) {
+		LexChunk *chunk = 0;
+		queue->Lock();
+		const bool done = finished;
+		if (!chunks.empty()) {
+			chunk = chunks.front();
+			chunks.pop_front();
+		}
+		queue->Unlock();
+		if (!chunk)
+			return !done;
+		applying = true;
+		Apply(pdoc, *chunk);
+		applying = false;
+		delete chunk;
+		published = pdoc->GetEndStyled();
+		if (et.Duration() > publishSeconds)
+			return true;
+	}
+}
@@ -0,0 +1,119 @@
+// Scintilla source code edit control
+/** @file BackgroundLexer.h
+ ** Lexing a copy of a document on another thread.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef BACKGROUNDLEXER_H
+#define BACKGROUNDLEXER_H
+
+#ifdef SCI_NAMESPACE
+namespace Scintilla {
+#endif
+
+class LexSnapshot;
+struct LexChunk;
+
+/**
+ * Runs a lexer over a copy of a document's text on a background thread.
+ * Styles, fold levels and line states are handed back in chunks which the window
+ * thread applies to the document when it is idle.
+ * The copy is kept while the document is edited, with the thread stopped, and
+ * updated with each change so lexing can continue without copying it again.
+ * The lexer is shared with the window thread so must only be called while locked.
+ */
+class BackgroundLexer {
+	ThreadLock *lexing;
+	ThreadLock *queue;
+	BackgroundThread *thread;
+	LexSnapshot *snapshot;
+	ILexer *instance;
+	Position startPos;
+	std::deque<LexChunk *> chunks;
+	volatile bool cancelling;
+	volatile bool finished;
+	/// End of styling in the document after the last chunk was applied
+	Position published;
+	/// Range of the copy changed by the thread, which starts before startPos when
+	/// the lexer backs up and may end beyond published
+	Position lexedStart;
+	Position lexedEnd;
+	/// Where the copy may differ from the document as it was styled on the window
+	/// thread or chunks were discarded
+	Position staleStart;
+	Position staleEnd;
+	/// Set while chunks are applied so their changes are not counted as stale
+	bool applying;
+	ElapsedTime etStopped;
+	bool stopped;
+
+	static void LexThread(void *pLexer);
+	void Run();
+	void EndThread();
+	bool Resume(Document *pdoc, Position start);
+	void Apply(Document *pdoc, const LexChunk &chunk);
+
+	// Private so BackgroundLexer objects can not be copied
+	BackgroundLexer(const BackgroundLexer &);
+	void operator=(const BackgroundLexer &);
+
+public:
+	BackgroundLexer();
+	~BackgroundLexer();
+
+	/// Start lexing pdoc with instance from the line containing start, copying its text
+	/// unless the copy kept since the thread was suspended is still current.
+	bool Start(Document *pdoc, ILexer *instance_, Position start);
+	/// Lex again from the line containing start with the text already copied when the
+	/// text is unchanged but the window thread has styled some of it.
+	/// @return false when the copy can not be used so the lexer has to be started again.
+	bool Restart(Document *pdoc, Position start);
+	/// Wait for the thread to end, discarding chunks not yet applied and the copy.
+	void Stop();
+	/// Wait for the thread to end before the text changes, keeping the copy.
+	void Suspend();
+	/// Update the copy after text was inserted (lengthChange > 0) or deleted at position.
+	void TextChanged(Document *pdoc, Position position, Position lengthChange, int linesAdded);
+	/// Note the styles, fold levels or line states between start and end changed in
+	/// the document other than by applying chunks.
+	void Styled(Position start, Position end);
+	/// Apply the chunks lexed so far to pdoc for up to a short time.
+	/// @return true while the thread has more to hand back.
+	bool Publish(Document *pdoc);
+
+	bool Running() const {
+		return thread != 0;
+	}
+	Position Published() const {
+		return published;
+	}
+	/// Seconds since Stop was last called, large if it has not been called.
+	double SinceStopped();
+
+	void Lock() {
+		lexing->Lock();
+	}
+	void Unlock() {
+		lexing->Unlock();
+	}
+};
+
+/// Holds the lexer of a BackgroundLexer, if there is one, for the life of a scope.
+class LexingLock {
+	BackgroundLexer *background;
+public:
+	explicit LexingLock(BackgroundLexer *background_) : background(background_) {
+		if (background)
+			background->Lock();
+	}
+	~LexingLock() {
+		if (background)
+			background->Unlock();
+	}
+};
+
+#ifdef SCI_NAMESPACE
+}
+#endif
+
+#endif
@@ -11,6 +11,7 @@
 #include "Platform.h"
 
 #include "Scintilla.h"
+#include "Position.h"
 #include "SplitVector.h" //!-add-[BetterCalltips]
 #include "CallTip.h"
 #include <stdio.h>
@@ -364,7 +365,7 @@ void CallTip::MouseClick(Point pt) {
 }
 
 
-PRectangle CallTip::CallTipStart(int pos, Point pt, int textHeight, const char *defn,
+PRectangle CallTip::CallTipStart(Position pos, Point pt, int textHeight, const char *defn,
                                  const char *faceName, int size,
                                  int codePage_, int characterSet,
 								 int technology, Window &wParent) {
@@ -9,28 +9,45 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <assert.h>
+#include <limits.h>
 
 #include "Platform.h"
 
+#include "ILexer.h"
 #include "Scintilla.h"
+#include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
+#include "RunStyles.h"
 #include "CellBuffer.h"
+#include "CharacterSet.h"
 
 #ifdef SCI_NAMESPACE
 using namespace Scintilla;
 #endif
 
-LineVector::LineVector() : starts(256), perLine(0) {
+LineVector::LineVector() : starts(0), startsLarge(0), perLine(0) {
 	Init();
 }
 
 LineVector::~LineVector() {
-	starts.DeleteAll();
+	delete starts;
+	starts = 0;
+	delete startsLarge;
+	startsLarge = 0;
 }
 
 void LineVector::Init() {
-	starts.DeleteAll();
+	// Start small again as the document is empty
+	delete startsLarge;
+	startsLarge = 0;
+	if (starts) {
+		starts->DeleteAll();
+	} else {
+		starts = new Partitioning<int>(256);
+	}
 	if (perLine) {
 		perLine->Init();
 	}
@@ -40,12 +57,38 @@ void LineVector::SetPerLine(PerLine *pl) {
 	perLine = pl;
 }
 
-void LineVector::InsertText(int line, int delta) {
-	starts.InsertText(line, delta);
+// Copy the line starts into a Position based partitioning so that
+// documents may grow beyond 2 GB. Only performed once per document.
+void LineVector::Widen() {
+	Partitioning<Position> *startsWide = new Partitioning<Position>(256);
+	const int lines = starts->Partitions();
+	for (int line = 1; line < lines; line++) {
+		startsWide->InsertPartition(line, starts->PositionFromPartition(line));
+	}
+	startsWide->SetPartitionStartPosition(lines, starts->PositionFromPartition(lines));
+	delete starts;
+	starts = 0;
+	startsLarge = startsWide;
 }
 
-void LineVector::InsertLine(int line, int position, bool lineStart) {
-	starts.InsertPartition(line, position);
+void LineVector::InsertText(int line, Position delta) {
+	if (!startsLarge) {
+		const Position lengthAfter = starts->PositionFromPartition(starts->Partitions()) + delta;
+		if (lengthAfter > INT_MAX) {
+			Widen();
+		} else {
+			starts->InsertText(line, static_cast<int>(delta));
+			return;
+		}
+	}
+	startsLarge->InsertText(line, delta);
+}
+
+void LineVector::InsertLine(int line, Position position, bool lineStart) {
+	if (startsLarge)
+		startsLarge->InsertPartition(line, position);
+	else
+		starts->InsertPartition(line, static_cast<int>(position));
 	if (perLine) {
 		if ((line > 0) && lineStart)
 			line--;
@@ -53,35 +96,41 @@ void LineVector::InsertLine(int line, int position, bool lineStart) {
 	}
 }
 
-void LineVector::SetLineStart(int line, int position) {
-	starts.SetPartitionStartPosition(line, position);
+void LineVector::SetLineStart(int line, Position position) {
+	if (startsLarge)
+		startsLarge->SetPartitionStartPosition(line, position);
+	else
+		starts->SetPartitionStartPosition(line, static_cast<int>(position));
 }
 
 void LineVector::RemoveLine(int line) {
-	starts.RemovePartition(line);
+	if (startsLarge)
+		startsLarge->RemovePartition(line);
+	else
+		starts->RemovePartition(line);
 	if (perLine) {
 		perLine->RemoveLine(line);
 	}
 }
 
-int LineVector::LineFromPosition(int pos) const {
-	return starts.PartitionFromPosition(pos);
+int LineVector::LineFromPosition(Position pos) const {
+	if (startsLarge)
+		return startsLarge->PartitionFromPosition(pos);
+	// Positions beyond the int range are past the end of a small document
+	if (pos > INT_MAX)
+		return starts->Partitions() - 1;
+	return starts->PartitionFromPosition(static_cast<int>(pos));
 }
 
 Action::Action() {
-	at = startAction;
 	position = 0;
 	data = 0;
 	lenData = 0;
+	at = startAction;
 	mayCoalesce = false;
 }
 
-Action::~Action() {
-	Destroy();
-}
-
-void Action::Create(actionType at_, int position_, char *data_, int lenData_, bool mayCoalesce_) {
-	delete []data;
+void Action::Create(actionType at_, Position position_, char *data_, Position lenData_, bool mayCoalesce_) {
 	position = position_;
 	at = at_;
 	data = data_;
@@ -89,26 +138,66 @@ void Action::Create(actionType at_, int position_, char *data_, int lenData_, bo
 	mayCoalesce = mayCoalesce_;
 }
 
-void Action::Destroy() {
-	delete []data;
-	data = 0;
+UndoArena::UndoArena() : allocated(0), used(0) {
 }
 
-void Action::Grab(Action *source) {
-	delete []data;
+UndoArena::~UndoArena() {
+	Clear();
+}
 
-	position = source->position;
-	at = source->at;
-	data = source->data;
-	lenData = source->lenData;
-	mayCoalesce = source->mayCoalesce;
+void UndoArena::ReleaseChunk(int chunk) {
+	Chunk *pChunk = chunks.ValueAt(chunk);
+	allocated -= pChunk->size;
+	used -= pChunk->used;
+	delete []pChunk->data;
+	delete pChunk;
+	chunks.Delete(chunk);
+}
 
-	// Ownership of source data transferred to this
-	source->position = 0;
-	source->at = startAction;
-	source->data = 0;
-	source->lenData = 0;
-	source->mayCoalesce = true;
+char *UndoArena::Allocate(Position lengthData) {
+	if (lengthData <= 0)
+		return 0;
+	Chunk *pChunk = chunks.Length() ? chunks.ValueAt(chunks.Length() - 1) : 0;
+	if (!pChunk || (pChunk->size - pChunk->used < lengthData)) {
+		// Large texts get a chunk to themselves
+		pChunk = new Chunk();
+		pChunk->size = MaxPosition(chunkSize, lengthData);
+		pChunk->data = new char[pChunk->size];
+		pChunk->used = 0;
+		chunks.Insert(chunks.Length(), pChunk);
+		allocated += pChunk->size;
+	}
+	char *text = pChunk->data + pChunk->used;
+	pChunk->used += lengthData;
+	used += lengthData;
+	return text;
+}
+
+void UndoArena::ReleaseAfter(const char *end) {
+	while (chunks.Length()) {
+		Chunk *pChunk = chunks.ValueAt(chunks.Length() - 1);
+		if (end && (end >= pChunk->data) && (end <= pChunk->data + pChunk->used)) {
+			used -= pChunk->data + pChunk->used - end;
+			pChunk->used = end - pChunk->data;
+			return;
+		}
+		ReleaseChunk(chunks.Length() - 1);
+	}
+}
+
+void UndoArena::ReleaseBefore(const char *start) {
+	while (chunks.Length()) {
+		Chunk *pChunk = chunks.ValueAt(0);
+		if (start && (start >= pChunk->data) && (start < pChunk->data + pChunk->used))
+			return;
+		ReleaseChunk(0);
+	}
+}
+
+void UndoArena::Clear() {
+	while (chunks.Length()) {
+		ReleaseChunk(chunks.Length() - 1);
+	}
 }
 
 // The undo history stores a sequence of user operations that represent the user's view of the
@@ -128,45 +217,96 @@ void Action::Grab(Action *source) {
 // operation. If there is no outstanding BeginUndoAction call then a new operation is started
 // unless it looks as if the new action is caused by the user typing or deleting a stream of text.
 // Sequences that look like typing or deletion are coalesced into a single user operation.
+// The text of the actions is appended to an arena in the same order as the actions so
+// discarding the redo actions releases the end of the arena and trimming the oldest user
+// operations releases its first chunks.
 
 UndoHistory::UndoHistory() {
 
-	lenActions = 100;
-	actions = new Action[lenActions];
+	blocks.Insert(0, new Action[actionsPerBlock]);
+	firstAction = 0;
 	maxAction = 0;
 	currentAction = 0;
 	undoSequenceDepth = 0;
 	savePoint = 0;
+	memoryLimit = 0;
+	actionsTrimmed = 0;
 
-	actions[currentAction].Create(startAction);
+	At(currentAction).Create(startAction);
 }
 
 UndoHistory::~UndoHistory() {
-	delete []actions;
-	actions = 0;
+	for (ptrdiff_t block = 0; block < blocks.Length(); block++)
+		delete []blocks[block];
 }
 
 void UndoHistory::EnsureUndoRoom() {
-	// Have to test that there is room for 2 more actions in the array
+	// Have to test that there is room for 2 more actions in the blocks
 	// as two actions may be created by the calling function
-	if (currentAction >= (lenActions - 2)) {
-		// Run out of undo nodes so extend the array
-		int lenActionsNew = lenActions * 2;
-		Action *actionsNew = new Action[lenActionsNew];
-		for (int act = 0; act <= currentAction; act++)
-			actionsNew[act].Grab(&actions[act]);
-		delete []actions;
-		lenActions = lenActionsNew;
-		actions = actionsNew;
+	while ((firstAction + currentAction + 2) >= blocks.Length() * actionsPerBlock) {
+		blocks.Insert(blocks.Length(), new Action[actionsPerBlock]);
+	}
+}
+
+void UndoHistory::DiscardActions(int act) {
+	// Release the text of the actions from act on as they are about to be overwritten
+	int actText = act;
+	while ((actText <= maxAction) && !At(actText).data)
+		actText++;
+	if (actText > maxAction)
+		return;
+	const char *end = 0;
+	for (int actKeep = act - 1; actKeep >= 0; actKeep--) {
+		const Action &action = At(actKeep);
+		if (action.data) {
+			end = action.data + action.lenData;
+			break;
+		}
+	}
+	arena.ReleaseAfter(end);
+	for (; actText <= maxAction; actText++)
+		At(actText).data = 0;
+}
+
+void UndoHistory::TrimActions(int actions) {
+	const char *start = 0;
+	for (int act = actions; act <= maxAction; act++) {
+		if (At(act).data) {
+			start = At(act).data;
+			break;
+		}
+	}
+	arena.ReleaseBefore(start);
+	firstAction += actions;
+	currentAction -= actions;
+	maxAction -= actions;
+	savePoint = (savePoint >= actions) ? savePoint - actions : -1;
+	while (firstAction >= actionsPerBlock) {
+		delete []blocks[0];
+		blocks.Delete(0);
+		firstAction -= actionsPerBlock;
+	}
+	actionsTrimmed += actions;
+}
+
+void UndoHistory::Trim() {
+	// Drop whole user operations from the start, always keeping the current one
+	while (MemoryUse() > memoryLimit) {
+		int next = 1;
+		while ((next < currentAction) && (At(next).at != startAction))
+			next++;
+		if (next >= currentAction)
+			break;
+		TrimActions(next);
 	}
 }
 
-void UndoHistory::AppendAction(actionType at, int position, char *data, int lengthData,
+char *UndoHistory::AppendAction(actionType at, Position position, Position lengthData,
 	bool &startSequence, bool mayCoalesce) {
 	EnsureUndoRoom();
 	//Platform::DebugPrintf("%% %d action %d %d %d\n", at, position, lengthData, currentAction);
-	//Platform::DebugPrintf("^ %d action %d %d\n", actions[currentAction - 1].at,
-	//	actions[currentAction - 1].position, actions[currentAction - 1].lenData);
+	//Platform::DebugPrintf("^ %d action %d %d\n", At(currentAction - 1).at,
+	//	At(currentAction - 1).position, At(currentAction - 1).lenData);
 	if (currentAction < savePoint) {
 		savePoint = -1;
 	}
@@ -175,22 +315,22 @@ void UndoHistory::AppendAction(actionType at, int position, char *data, int leng
 		if (0 == undoSequenceDepth) {
 			// Top level actions may not always be coalesced
 			int targetAct = -1;
-			const Action *actPrevious = &(actions[currentAction + targetAct]);
+			const Action *actPrevious = &(At(currentAction + targetAct));
 			// Container actions may forward the coalesce state of Scintilla Actions.
 			while ((actPrevious->at == containerAction) && actPrevious->mayCoalesce) {
 				targetAct--;
-				actPrevious = &(actions[currentAction + targetAct]);
+				actPrevious = &(At(currentAction + targetAct));
 			}
 			// See if current action can be coalesced into previous action
 			// Will work if both are inserts or deletes and position is same
 			if (currentAction == savePoint) {
 				currentAction++;
-			} else if (!actions[currentAction].mayCoalesce) {
+			} else if (!At(currentAction).mayCoalesce) {
 				// Not allowed to coalesce if this set
 				currentAction++;
 			} else if (!mayCoalesce || !actPrevious->mayCoalesce) {
 				currentAction++;
-			} else if (at == containerAction || actions[currentAction].at == containerAction) {
+			} else if (at == containerAction || At(currentAction).at == containerAction) {
 				;	// A coalescible containerAction
 			} else if ((at != actPrevious->at) && (actPrevious->at != startAction)) {
 				currentAction++;
@@ -218,28 +358,34 @@ void UndoHistory::AppendAction(actionType at, int position, char *data, int leng
 
 		} else {
 			// Actions not at top level are always coalesced unless this is after return to top level
-			if (!actions[currentAction].mayCoalesce)
+			if (!At(currentAction).mayCoalesce)
 				currentAction++;
 		}
 	} else {
 		currentAction++;
 	}
 	startSequence = oldCurrentAction != currentAction;
-	actions[currentAction].Create(at, position, data, lengthData, mayCoalesce);
+	DiscardActions(currentAction);
+	char *data = arena.Allocate(lengthData);
+	At(currentAction).Create(at, position, data, lengthData, mayCoalesce);
 	currentAction++;
-	actions[currentAction].Create(startAction);
+	At(currentAction).Create(startAction);
 	maxAction = currentAction;
+	if (memoryLimit > 0)
+		Trim();
+	return data;
 }
 
 void UndoHistory::BeginUndoAction() {
 	EnsureUndoRoom();
 	if (undoSequenceDepth == 0) {
-		if (actions[currentAction].at != startAction) {
+		if (At(currentAction).at != startAction) {
 			currentAction++;
-			actions[currentAction].Create(startAction);
+			DiscardActions(currentAction);
+			At(currentAction).Create(startAction);
 			maxAction = currentAction;
 		}
-		actions[currentAction].mayCoalesce = false;
+		At(currentAction).mayCoalesce = false;
 	}
 	undoSequenceDepth++;
 }
@@ -249,12 +395,13 @@ void UndoHistory::EndUndoAction() {
 	EnsureUndoRoom();
 	undoSequenceDepth--;
 	if (0 == undoSequenceDepth) {
-		if (actions[currentAction].at != startAction) {
+		if (At(currentAction).at != startAction) {
 			currentAction++;
-			actions[currentAction].Create(startAction);
+			DiscardActions(currentAction);
+			At(currentAction).Create(startAction);
 			maxAction = currentAction;
 		}
-		actions[currentAction].mayCoalesce = false;
+		At(currentAction).mayCoalesce = false;
 	}
 }
 
@@ -263,12 +410,17 @@ void UndoHistory::DropUndoSequence() {
 }
 
 void UndoHistory::DeleteUndoHistory() {
-	for (int i = 1; i < maxAction; i++)
-		actions[i].Destroy();
+	arena.Clear();
+	while (blocks.Length() > 1) {
+		delete []blocks[blocks.Length() - 1];
+		blocks.Delete(blocks.Length() - 1);
+	}
+	firstAction = 0;
 	maxAction = 0;
 	currentAction = 0;
-	actions[currentAction].Create(startAction);
+	At(currentAction).Create(startAction);
 	savePoint = 0;
+	actionsTrimmed = 0;
 }
 
 void UndoHistory::SetSavePoint() {
@@ -285,19 +437,19 @@ bool UndoHistory::CanUndo() const {
 
 int UndoHistory::StartUndo() {
 	// Drop any trailing startAction
-	if (actions[currentAction].at == startAction && currentAction > 0)
+	if (At(currentAction).at == startAction && currentAction > 0)
 		currentAction--;
 
 	// Count the steps in this action
 	int act = currentAction;
-	while (actions[act].at != startAction && act > 0) {
+	while (At(act).at != startAction && act > 0) {
 		act--;
 	}
 	return currentAction - act;
 }
 
 const Action &UndoHistory::GetUndoStep() const {
-	return actions[currentAction];
+	return At(currentAction);
 }
 
 void UndoHistory::CompletedUndoStep() {
@@ -310,84 +462,458 @@ bool UndoHistory::CanRedo() const {
 
 int UndoHistory::StartRedo() {
 	// Drop any leading startAction
-	if (actions[currentAction].at == startAction && currentAction < maxAction)
+	if (At(currentAction).at == startAction && currentAction < maxAction)
 		currentAction++;
 
 	// Count the steps in this action
 	int act = currentAction;
-	while (actions[act].at != startAction && act < maxAction) {
+	while (At(act).at != startAction && act < maxAction) {
 		act++;
 	}
 	return act - currentAction;
 }
 
 const Action &UndoHistory::GetRedoStep() const {
-	return actions[currentAction];
+	return At(currentAction);
 }
 
 void UndoHistory::CompletedRedoStep() {
 	currentAction++;
 }
 
+void UndoHistory::SetMemoryLimit(Position limit) {
+	memoryLimit = limit;
+	if (memoryLimit > 0)
+		Trim();
+}
+
+Position UndoHistory::MemoryUse() const {
+	return arena.Allocated() + blocks.Length() * actionsPerBlock * sizeof(Action);
+}
+
+// The saved form of an undo history is a header followed by each action as a byte of
+// type and coalescing, its position as the signed difference from the previous action's,
+// its length and its text. Numbers are written 7 bits a byte with the high bit set
+// on all but the last byte so that the small differences of typing take one byte.
+
+static const char undoHistoryMagic[] = "SUH1";
+
+/// Writes the saved form of an undo history, only counting its bytes when there is no buffer.
+class UndoWriter {
+	char *buffer;
+	Position length;
+public:
+	explicit UndoWriter(char *buffer_) : buffer(buffer_), length(0) {
+	}
+	void Byte(unsigned char value) {
+		if (buffer)
+			buffer[length] = static_cast<char>(value);
+		length++;
+	}
+	void Number(size_t value) {
+		while (value >= 0x80) {
+			Byte(static_cast<unsigned char>((value & 0x7f) | 0x80));
+			value >>= 7;
+		}
+		Byte(static_cast<unsigned char>(value));
+	}
+	void Signed(Position value) {
+		Number((value >= 0) ? (static_cast<size_t>(value) << 1) : ((static_cast<size_t>(-(value + 1)) << 1) | 1));
+	}
+	void Bytes(const char *text, Position lengthText) {
+		if (buffer && lengthText)
+			memcpy(buffer + length, text, lengthText);
+		length += lengthText;
+	}
+	Position Length() const {
+		return length;
+	}
+};
+
+/// Reads the saved form of an undo history, failing rather than reading past its end.
+class UndoReader {
+	const char *data;
+	Position length;
+	Position position;
+	bool failed;
+public:
+	UndoReader(const char *data_, Position length_) : data(data_), length(length_), position(0), failed(false) {
+	}
+	unsigned char Byte() {
+		if (position >= length) {
+			failed = true;
+			return 0;
+		}
+		return static_cast<unsigned char>(data[position++]);
+	}
+	size_t Number() {
+		size_t value = 0;
+		for (unsigned int shift = 0; shift < sizeof(size_t) * 8; shift += 7) {
+			const unsigned char b = Byte();
+			value |= static_cast<size_t>(b & 0x7f) << shift;
+			if (!(b & 0x80))
+				return value;
+		}
+		failed = true;
+		return 0;
+	}
+	Position Signed() {
+		const size_t value = Number();
+		return (value & 1) ? -static_cast<Position>(value >> 1) - 1 : static_cast<Position>(value >> 1);
+	}
+	const char *Bytes(Position lengthText) {
+		if ((lengthText < 0) || (lengthText > length - position)) {
+			failed = true;
+			return 0;
+		}
+		const char *text = data + position;
+		position += lengthText;
+		return text;
+	}
+	bool Failed() const {
+		return failed;
+	}
+	bool AtEnd() const {
+		return position == length;
+	}
+};
+
+Position UndoHistory::Save(char *buffer, Position documentLength, unsigned int checksum) const {
+	if (maxAction == 0)
+		return 0;
+	UndoWriter writer(buffer);
+	writer.Bytes(undoHistoryMagic, 4);
+	writer.Number(documentLength);
+	writer.Number(checksum);
+	writer.Number(maxAction);
+	writer.Number(currentAction);
+	Position positionPrevious = 0;
+	for (int act = 1; act <= maxAction; act++) {
+		const Action &action = At(act);
+		writer.Byte(static_cast<unsigned char>(action.at | (action.mayCoalesce ? 4 : 0)));
+		writer.Signed(action.position - positionPrevious);
+		positionPrevious = action.position;
+		writer.Number(action.lenData);
+		writer.Bytes(action.data, action.lenData);
+	}
+	return writer.Length();
+}
+
+bool UndoHistory::Load(const char *data, Position length, Position documentLength, unsigned int checksum) {
+	UndoReader reader(data, length);
+	const char *magic = reader.Bytes(4);
+	if (!magic || memcmp(magic, undoHistoryMagic, 4) != 0)
+		return false;
+	if ((reader.Number() != static_cast<size_t>(documentLength)) || (reader.Number() != checksum))
+		return false;
+	const size_t actions = reader.Number();
+	const size_t current = reader.Number();
+	if (reader.Failed() || (actions > static_cast<size_t>(length)) || (current > actions))
+		return false;
+
+	DeleteUndoHistory();
+	Position positionPrevious = 0;
+	for (int act = 1; act <= static_cast<int>(actions); act++) {
+		currentAction = act - 1;
+		EnsureUndoRoom();
+		const unsigned char type = reader.Byte();
+		const Position position = positionPrevious + reader.Signed();
+		const Position lenData = static_cast<Position>(reader.Number());
+		const char *text = reader.Bytes(lenData);
+		if (reader.Failed() || ((type & 3) == startAction && lenData)) {
+			DeleteUndoHistory();
+			return false;
+		}
+		positionPrevious = position;
+		char *dataAction = arena.Allocate(lenData);
+		if (lenData)
+			memcpy(dataAction, text, lenData);
+		At(act).Create(static_cast<actionType>(type & 3), position, dataAction, lenData, (type & 4) != 0);
+		maxAction = act;
+	}
+	currentAction = static_cast<int>(current);
+
+	// Check that every step can be undone and redone on the document
+	bool valid = reader.AtEnd() && (At(currentAction).at == startAction) && (At(maxAction).at == startAction);
+	Position lengthStep = documentLength;
+	for (int act = currentAction - 1; valid && (act > 0); act--) {
+		const Action &action = At(act);
+		if (action.at == insertAction) {
+			valid = (action.position >= 0) && (action.position + action.lenData <= lengthStep);
+			lengthStep -= action.lenData;
+		} else if (action.at == removeAction) {
+			valid = (action.position >= 0) && (action.position <= lengthStep);
+			lengthStep += action.lenData;
+		}
+	}
+	lengthStep = documentLength;
+	for (int act = currentAction; valid && (act <= maxAction); act++) {
+		const Action &action = At(act);
+		if (action.at == insertAction) {
+			valid = (action.position >= 0) && (action.position <= lengthStep);
+			lengthStep += action.lenData;
+		} else if (action.at == removeAction) {
+			valid = (action.position >= 0) && (action.position + action.lenData <= lengthStep);
+			lengthStep -= action.lenData;
+		}
+	}
+	if (!valid) {
+		DeleteUndoHistory();
+		return false;
+	}
+	savePoint = currentAction;
+	if (memoryLimit > 0)
+		Trim();
+	return true;
+}
+
+// Inserted text of a mapped buffer is stored in blocks of at least this size
+static const Position insertedBlockSize = 0x10000;
+
 CellBuffer::CellBuffer() {
+	mapped = 0;
+	pieces = 0;
+	insertedNext = 0;
+	insertedLeft = 0;
+	styleRuns = 0;
 	readOnly = false;
 	collectingUndo = true;
 }
 
 CellBuffer::~CellBuffer() {
+	ReleaseMapped();
+	delete styleRuns;
+	styleRuns = 0;
 }
 
-char CellBuffer::CharAt(int position) const {
+char CellBuffer::CharAt(Position position) const {
+	if (mapped) {
+		if (position < 0 || position >= Length())
+			return 0;
+		const int piece = pieces->PartitionFromPosition(position);
+		return pieceText.ValueAt(piece)[position - pieces->PositionFromPartition(piece)];
+	}
 	return substance.ValueAt(position);
 }
 
-void CellBuffer::GetCharRange(char *buffer, int position, int lengthRetrieve) const {
+void CellBuffer::GetCharRange(char *buffer, Position position, Position lengthRetrieve) const {
 	if (lengthRetrieve < 0)
 		return;
 	if (position < 0)
 		return;
-	if ((position + lengthRetrieve) > substance.Length()) {
-		Platform::DebugPrintf("Bad GetCharRange %d for %d of %d\n", position,
-		                      lengthRetrieve, substance.Length());
+	if ((position + lengthRetrieve) > Length()) {
+		Platform::DebugPrintf("Bad GetCharRange %d for %d of %d\n", static_cast<int>(position),
+		                      static_cast<int>(lengthRetrieve), static_cast<int>(Length()));
 		return;
 	}
-	substance.GetRange(buffer, position, lengthRetrieve);
+	if (mapped) {
+		while (lengthRetrieve > 0) {
+			Position lengthRange = 0;
+			const char *range = RangeAt(position, &lengthRange);
+			lengthRange = MinPosition(lengthRange, lengthRetrieve);
+			memcpy(buffer, range, lengthRange);
+			buffer += lengthRange;
+			position += lengthRange;
+			lengthRetrieve -= lengthRange;
+		}
+	} else {
+		substance.GetRange(buffer, position, lengthRetrieve);
+	}
 }
 
-char CellBuffer::StyleAt(int position) const {
+char CellBuffer::StyleAt(Position position) const {
+	if (styleRuns) {
+		if (position < 0 || position >= styleRuns->Length())
+			return 0;
+		return static_cast<char>(styleRuns->ValueAt(position));
+	}
 	return style.ValueAt(position);
 }
 
-void CellBuffer::GetStyleRange(unsigned char *buffer, int position, int lengthRetrieve) const {
+void CellBuffer::GetStyleRange(unsigned char *buffer, Position position, Position lengthRetrieve) const {
 	if (lengthRetrieve < 0)
 		return;
 	if (position < 0)
 		return;
-	if ((position + lengthRetrieve) > style.Length()) {
-		Platform::DebugPrintf("Bad GetStyleRange %d for %d of %d\n", position,
-		                      lengthRetrieve, style.Length());
+	if ((position + lengthRetrieve) > Length()) {
+		Platform::DebugPrintf("Bad GetStyleRange %d for %d of %d\n", static_cast<int>(position),
+		                      static_cast<int>(lengthRetrieve), static_cast<int>(Length()));
 		return;
 	}
-	style.GetRange(reinterpret_cast<char *>(buffer), position, lengthRetrieve);
+	if (styleRuns) {
+		// Expand each run covering the range
+		const Position end = position + lengthRetrieve;
+		while (position < end) {
+			const Position endRun = MinPosition(styleRuns->EndRun(position), end);
+			memset(buffer, styleRuns->ValueAt(position), endRun - position);
+			buffer += endRun - position;
+			position = endRun;
+		}
+	} else {
+		style.GetRange(reinterpret_cast<char *>(buffer), position, lengthRetrieve);
+	}
 }
 
 const char *CellBuffer::BufferPointer() {
+	// Mapped text is not terminated so has to be copied to provide a terminated string
+	Materialise();
 	return substance.BufferPointer();
 }
 
+const char *CellBuffer::RangeAt(Position position, Position *rangeLength) const {
+	if (mapped) {
+		if (position < 0 || position >= Length()) {
+			*rangeLength = 0;
+			return 0;
+		}
+		const int piece = pieces->PartitionFromPosition(position);
+		const Position pieceStart = pieces->PositionFromPartition(piece);
+		*rangeLength = pieces->PositionFromPartition(piece + 1) - position;
+		return pieceText.ValueAt(piece) + (position - pieceStart);
+	}
+	return substance.RangeAt(position, rangeLength);
+}
+
+bool CellBuffer::AdoptMapped(IMappedText *pText) {
+	if (mapped || (substance.Length() > 0))
+		return false;
+	mapped = pText;
+	const char *mappedData = pText->Data();
+	const Position mappedLength = pText->Length();
+	pieces = new Partitioning<Position>(8);
+	pieces->InsertText(0, mappedLength);
+	pieceText.Insert(0, mappedData);
+	// Frees any storage allocated for the loader as the text stays in the mapping
+	substance.DeleteAll();
+	style.DeleteAll();
+	delete styleRuns;
+	styleRuns = new RunStyles();
+	styleRuns->InsertSpace(0, mappedLength);
+
+	// Build the line index directly from the mapped text
+	lv.InsertText(0, mappedLength);
+	int lineInsert = 1;
+	for (Position i = 0; i < mappedLength; i++) {
+		const char ch = mappedData[i];
+		if (ch == '\r') {
+			if ((i + 1 < mappedLength) && (mappedData[i + 1] == '\n'))
+				i++;
+			InsertLine(lineInsert, i + 1, true);
+			lineInsert++;
+		} else if (ch == '\n') {
+			InsertLine(lineInsert, i + 1, true);
+			lineInsert++;
+		}
+	}
+	return true;
+}
+
+bool CellBuffer::IsMapped() const {
+	return mapped != 0;
+}
+
+void CellBuffer::ReleaseMapped() {
+	if (mapped) {
+		mapped->Release();
+		mapped = 0;
+		delete pieces;
+		pieces = 0;
+		pieceText.DeleteAll();
+		for (int i = 0; i < insertedBlocks.Length(); i++)
+			delete []insertedBlocks[i];
+		insertedBlocks.DeleteAll();
+		insertedNext = 0;
+		insertedLeft = 0;
+	}
+}
+
+// Copy the pieces of a mapped buffer into the gap buffer to provide a contiguous string.
+// Styles remain as runs.
+void CellBuffer::Materialise() {
+	if (mapped) {
+		const Position length = Length();
+		substance.ReAllocate(length + 1);
+		for (int piece = 0; piece < pieces->Partitions(); piece++) {
+			const Position pieceStart = pieces->PositionFromPartition(piece);
+			substance.InsertFromArray(pieceStart, pieceText.ValueAt(piece), 0,
+				pieces->PositionFromPartition(piece + 1) - pieceStart);
+		}
+		ReleaseMapped();
+	}
+}
+
+// Text inserted into a mapped buffer is appended to the last block so that it does not move
+const char *CellBuffer::StoreInserted(const char *s, Position insertLength) {
+	if (insertLength > insertedLeft) {
+		const Position blockSize = MaxPosition(insertLength, insertedBlockSize);
+		insertedNext = new char[blockSize];
+		insertedBlocks.Insert(insertedBlocks.Length(), insertedNext);
+		insertedLeft = blockSize;
+	}
+	char *stored = insertedNext;
+	memcpy(stored, s, insertLength);
+	insertedNext += insertLength;
+	insertedLeft -= insertLength;
+	return stored;
+}
+
+// Make position the start of a piece unless it is at either end of the text
+void CellBuffer::SplitPiece(Position position) {
+	if ((position <= 0) || (position >= Length()))
+		return;
+	const int piece = pieces->PartitionFromPosition(position);
+	const Position pieceStart = pieces->PositionFromPartition(piece);
+	if (pieceStart != position) {
+		pieces->InsertPartition(piece + 1, position);
+		pieceText.Insert(piece + 1, pieceText.ValueAt(piece) + (position - pieceStart));
+	}
+}
+
+void CellBuffer::MappedInsert(Position position, const char *s, Position insertLength) {
+	if (position > 0) {
+		// Typing extends the piece holding the text inserted just before
+		const int piecePrevious = pieces->PartitionFromPosition(position - 1);
+		const Position pieceStart = pieces->PositionFromPartition(piecePrevious);
+		if ((pieces->PositionFromPartition(piecePrevious + 1) == position) &&
+			(pieceText.ValueAt(piecePrevious) + (position - pieceStart) == insertedNext) &&
+			(insertLength <= insertedLeft)) {
+			StoreInserted(s, insertLength);
+			pieces->InsertText(piecePrevious, insertLength);
+			return;
+		}
+	}
+	const char *stored = StoreInserted(s, insertLength);
+	SplitPiece(position);
+	const int piece = (position >= Length()) ? pieces->Partitions() : pieces->PartitionFromPosition(position);
+	pieces->InsertPartition(piece, position);
+	pieceText.Insert(piece, stored);
+	pieces->InsertText(piece, insertLength);
+}
+
+void CellBuffer::MappedDelete(Position position, Position deleteLength) {
+	const Position end = position + deleteLength;
+	SplitPiece(position);
+	SplitPiece(end);
+	const int pieceFirst = pieces->PartitionFromPosition(position);
+	const int pieceEnd = (end >= Length()) ? pieces->Partitions() : pieces->PartitionFromPosition(end);
+	// The piece starting at end takes the place of the deleted pieces
+	for (int piece = pieceFirst; piece < pieceEnd; piece++)
+		pieces->RemovePartition(pieceFirst + 1);
+	pieceText.DeleteRange(pieceFirst, pieceEnd - pieceFirst);
+	pieces->InsertText(pieceFirst, -deleteLength);
+}
+
 // The char* returned is to an allocation owned by the undo history
-const char *CellBuffer::InsertString(int position, const char *s, int insertLength, bool &startSequence) {
+const char *CellBuffer::InsertString(Position position, const char *s, Position insertLength, bool &startSequence) {
 	char *data = 0;
 	// InsertString and DeleteChars are the bottleneck though which all changes occur
 	if (!readOnly) {
 		if (collectingUndo) {
 			// Save into the undo/redo stack, but only the characters - not the formatting
 			// This takes up about half load time
-			data = new char[insertLength];
-			for (int i = 0; i < insertLength; i++) {
-				data[i] = s[i];
-			}
-			uh.AppendAction(insertAction, position, data, insertLength, startSequence);
+			data = uh.AppendAction(insertAction, position, insertLength, startSequence);
+			if (insertLength > 0)
+				memcpy(data, s, insertLength);
 		}
 
 		BasicInsertString(position, s, insertLength);
@@ -395,10 +921,17 @@ const char *CellBuffer::InsertString(int position, const char *s, int insertLeng
 	return data;
 }
 
-bool CellBuffer::SetStyleAt(int position, char styleValue, char mask) {
+bool CellBuffer::SetStyleAt(Position position, char styleValue, char mask) {
 	styleValue &= mask;
-	char curVal = style.ValueAt(position);
+	char curVal = StyleAt(position);
 	if ((curVal & mask) != styleValue) {
+		if (styleRuns) {
+			if (position < 0 || position >= styleRuns->Length())
+				return false;
+			Position lengthFill = 1;
+			return styleRuns->FillRange(position,
+				static_cast<unsigned char>((curVal & ~mask) | styleValue), lengthFill);
+		}
 		style.SetValueAt(position, static_cast<char>((curVal & ~mask) | styleValue));
 		return true;
 	} else {
@@ -406,10 +939,26 @@ bool CellBuffer::SetStyleAt(int position, char styleValue, char mask) {
 	}
 }
 
-bool CellBuffer::SetStyleFor(int position, int lengthStyle, char styleValue, char mask) {
+bool CellBuffer::SetStyleFor(Position position, Position lengthStyle, char styleValue, char mask) {
 	bool changed = false;
 	PLATFORM_ASSERT(lengthStyle == 0 ||
-		(lengthStyle > 0 && lengthStyle + position <= style.Length()));
+		(lengthStyle > 0 && lengthStyle + position <= Length()));
+	if (styleRuns) {
+		// Work a run at a time so that unchanged runs are not split
+		const Position end = position + lengthStyle;
+		while (position < end) {
+			Position lengthFill = MinPosition(styleRuns->EndRun(position), end) - position;
+			const char curVal = static_cast<char>(styleRuns->ValueAt(position));
+			const Position next = position + lengthFill;
+			if ((curVal & mask) != styleValue) {
+				if (styleRuns->FillRange(position,
+					static_cast<unsigned char>((curVal & ~mask) | styleValue), lengthFill))
+					changed = true;
+			}
+			position = next;
+		}
+		return changed;
+	}
 	while (lengthStyle--) {
 		char curVal = style.ValueAt(position);
 		if ((curVal & mask) != styleValue) {
@@ -422,18 +971,15 @@ bool CellBuffer::SetStyleFor(int position, int lengthStyle, char styleValue, cha
 }
 
 // The char* returned is to an allocation owned by the undo history
-const char *CellBuffer::DeleteChars(int position, int deleteLength, bool &startSequence) {
+const char *CellBuffer::DeleteChars(Position position, Position deleteLength, bool &startSequence) {
 	// InsertString and DeleteChars are the bottleneck though which all changes occur
 	PLATFORM_ASSERT(deleteLength > 0);
 	char *data = 0;
 	if (!readOnly) {
 		if (collectingUndo) {
 			// Save into the undo/redo stack, but only the characters - not the formatting
-			data = new char[deleteLength];
-			for (int i = 0; i < deleteLength; i++) {
-				data[i] = substance.ValueAt(position + i);
-			}
-			uh.AppendAction(removeAction, position, data, deleteLength, startSequence);
+			data = uh.AppendAction(removeAction, position, deleteLength, startSequence);
+			GetCharRange(data, position, deleteLength);
 		}
 
 		BasicDeleteChars(position, deleteLength);
@@ -441,13 +987,27 @@ const char *CellBuffer::DeleteChars(int position, int deleteLength, bool &startS
 	return data;
 }
 
-int CellBuffer::Length() const {
+Position CellBuffer::Length() const {
+	if (mapped)
+		return pieces->PositionFromPartition(pieces->Partitions());
 	return substance.Length();
 }
 
-void CellBuffer::Allocate(int newSize) {
+void CellBuffer::Allocate(Position newSize) {
+	if (mapped)
+		return;
 	substance.ReAllocate(newSize);
-	style.ReAllocate(newSize);
+	if (!styleRuns)
+		style.ReAllocate(newSize);
+}
+
+void CellBuffer::SetChunkSize(Position chunkSize) {
+	substance.SetChunkSize(chunkSize);
+	style.SetChunkSize(chunkSize);
+}
+
+Position CellBuffer::GetChunkSize() const {
+	return substance.GetChunkSize();
 }
 
 void CellBuffer::SetPerLine(PerLine *pl) {
@@ -458,7 +1018,7 @@ int CellBuffer::Lines() const {
 	return lv.Lines();
 }
 
-int CellBuffer::LineStart(int line) const {
+Position CellBuffer::LineStart(int line) const {
 	if (line < 0)
 		return 0;
 	else if (line >= Lines())
@@ -485,7 +1045,7 @@ bool CellBuffer::IsSavePoint() {
 
 // Without undo
 
-void CellBuffer::InsertLine(int line, int position, bool lineStart) {
+void CellBuffer::InsertLine(int line, Position position, bool lineStart) {
 	lv.InsertLine(line, position, lineStart);
 }
 
@@ -493,27 +1053,37 @@ void CellBuffer::RemoveLine(int line) {
 	lv.RemoveLine(line);
 }
 
-void CellBuffer::BasicInsertString(int position, const char *s, int insertLength) {
+void CellBuffer::BasicInsertString(Position position, const char *s, Position insertLength) {
 	if (insertLength == 0)
 		return;
 	PLATFORM_ASSERT(insertLength > 0);
 
-	substance.InsertFromArray(position, s, 0, insertLength);
-	style.InsertValue(position, insertLength, 0);
+	if (mapped)
+		MappedInsert(position, s, insertLength);
+	else
+		substance.InsertFromArray(position, s, 0, insertLength);
+	if (styleRuns) {
+		// New text starts unstyled as it does in the style vector
+		styleRuns->InsertSpace(position, insertLength);
+		Position positionFill = position;
+		Position lengthFill = insertLength;
+		styleRuns->FillRange(positionFill, 0, lengthFill);
+	} else
+		style.InsertValue(position, insertLength, 0);
 
 	int lineInsert = lv.LineFromPosition(position) + 1;
 	bool atLineStart = lv.LineStart(lineInsert-1) == position;
 	// Point all the lines after the insertion point further along in the buffer
 	lv.InsertText(lineInsert-1, insertLength);
-	char chPrev = substance.ValueAt(position - 1);
-	char chAfter = substance.ValueAt(position + insertLength);
+	char chPrev = CharAt(position - 1);
+	char chAfter = CharAt(position + insertLength);
 	if (chPrev == '\r' && chAfter == '\n') {
 		// Splitting up a crlf pair at position
 		InsertLine(lineInsert, position, false);
 		lineInsert++;
 	}
 	char ch = ' ';
-	for (int i = 0; i < insertLength; i++) {
+	for (Position i = 0; i < insertLength; i++) {
 		ch = s[i];
 		if (ch == '\r') {
 			InsertLine(lineInsert, (position + i) + 1, atLineStart);
@@ -538,11 +1108,20 @@ void CellBuffer::BasicInsertString(int position, const char *s, int insertLength
 	}
 }
 
-void CellBuffer::BasicDeleteChars(int position, int deleteLength) {
+void CellBuffer::BasicDeleteChars(Position position, Position deleteLength) {
 	if (deleteLength == 0)
 		return;
 
-	if ((position == 0) && (deleteLength == substance.Length())) {
+	if (mapped && (position == 0) && (deleteLength == Length())) {
+		// Nothing to copy when all the mapped text goes
+		ReleaseMapped();
+		substance.DeleteAll();
+		styleRuns->DeleteAll();
+		lv.Init();
+		return;
+	}
+
+	if ((position == 0) && (deleteLength == Length())) {
 		// If whole buffer is being deleted, faster to reinitialise lines data
 		// than to delete each line.
 		lv.Init();
@@ -552,9 +1131,9 @@ void CellBuffer::BasicDeleteChars(int position, int deleteLength) {
 
 		int lineRemove = lv.LineFromPosition(position) + 1;
 		lv.InsertText(lineRemove-1, - (deleteLength));
-		char chPrev = substance.ValueAt(position - 1);
+		char chPrev = CharAt(position - 1);
 		char chBefore = chPrev;
-		char chNext = substance.ValueAt(position);
+		char chNext = CharAt(position);
 		bool ignoreNL = false;
 		if (chPrev == '\r' && chNext == '\n') {
 			// Move back one
@@ -564,8 +1143,8 @@ void CellBuffer::BasicDeleteChars(int position, int deleteLength) {
 		}
 
 		char ch = chNext;
-		for (int i = 0; i < deleteLength; i++) {
-			chNext = substance.ValueAt(position + i + 1);
+		for (Position i = 0; i < deleteLength; i++) {
+			chNext = CharAt(position + i + 1);
 			if (ch == '\r') {
 				if (chNext != '\n') {
 					RemoveLine(lineRemove);
@@ -582,15 +1161,21 @@ void CellBuffer::BasicDeleteChars(int position, int deleteLength) {
 		}
 		// May have to fix up end if last deletion causes cr to be next to lf
 		// or removes one of a crlf pair
-		char chAfter = substance.ValueAt(position + deleteLength);
+		char chAfter = CharAt(position + deleteLength);
 		if (chBefore == '\r' && chAfter == '\n') {
 			// Using lineRemove-1 as cr ended line before start of deletion
 			RemoveLine(lineRemove - 1);
 			lv.SetLineStart(lineRemove - 1, position + 1);
 		}
 	}
-	substance.DeleteRange(position, deleteLength);
-	style.DeleteRange(position, deleteLength);
+	if (mapped)
+		MappedDelete(position, deleteLength);
+	else
+		substance.DeleteRange(position, deleteLength);
+	if (styleRuns)
+		styleRuns->DeleteRange(position, deleteLength);
+	else
+		style.DeleteRange(position, deleteLength);
 }
 
 bool CellBuffer::SetUndoCollection(bool collectUndo) {
@@ -613,13 +1198,53 @@ void CellBuffer::EndUndoAction() {
 
 void CellBuffer::AddUndoAction(int token, bool mayCoalesce) {
 	bool startSequence;
-	uh.AppendAction(containerAction, token, 0, 0, startSequence, mayCoalesce);
+	uh.AppendAction(containerAction, token, 0, startSequence, mayCoalesce);
 }
 
 void CellBuffer::DeleteUndoHistory() {
 	uh.DeleteUndoHistory();
 }
 
+void CellBuffer::SetUndoMemoryLimit(Position limit) {
+	uh.SetMemoryLimit(limit);
+}
+
+Position CellBuffer::GetUndoMemoryLimit() const {
+	return uh.GetMemoryLimit();
+}
+
+Position CellBuffer::UndoMemoryUse() const {
+	return uh.MemoryUse();
+}
+
+int CellBuffer::UndoActions() const {
+	return uh.Actions();
+}
+
+unsigned int CellBuffer::Checksum() const {
+	unsigned int hash = hashTextStart;
+	Position position = 0;
+	while (position < Length()) {
+		Position lengthRange = 0;
+		const char *range = RangeAt(position, &lengthRange);
+		if (!range || (lengthRange <= 0))
+			break;
+		hash = HashText(range, lengthRange, hash);
+		position += lengthRange;
+	}
+	return hash;
+}
+
+Position CellBuffer::SaveUndoHistory(char *buffer) const {
+	return uh.Save(buffer, Length(), Checksum());
+}
+
+bool CellBuffer::LoadUndoHistory(const char *data, Position length) {
+	if (!collectingUndo || !uh.IsSavePoint())
+		return false;
+	return uh.Load(data, length, Length(), Checksum());
+}
+
 bool CellBuffer::CanUndo() {
 	return uh.CanUndo();
 }
@@ -12,6 +12,9 @@
 namespace Scintilla {
 #endif
 
+class IMappedText;
+class RunStyles;
+
 // Interface to per-line data that wants to see each line insertion and deletion
 class PerLine {
 public:
@@ -23,12 +26,17 @@ public:
 
 /**
  * The line vector contains information about each of the lines in a cell buffer.
+ * Line starts are held as int while the document is smaller than 2 GB and are
+ * widened to Position the first time an insertion takes the document past that.
  */
 class LineVector {
 
-	Partitioning starts;
+	Partitioning<int> *starts;
+	Partitioning<Position> *startsLarge;
 	PerLine *perLine;
 
+	void Widen();
+
 public:
 
 	LineVector();
@@ -36,16 +44,19 @@ public:
 	void Init();
 	void SetPerLine(PerLine *pl);
 
-	void InsertText(int line, int delta);
-	void InsertLine(int line, int position, bool lineStart);
-	void SetLineStart(int line, int position);
+	void InsertText(int line, Position delta);
+	void InsertLine(int line, Position position, bool lineStart);
+	void SetLineStart(int line, Position position);
 	void RemoveLine(int line);
 	int Lines() const {
-		return starts.Partitions();
+		return startsLarge ? startsLarge->Partitions() : starts->Partitions();
+	}
+	int LineFromPosition(Position pos) const;
+	Position LineStart(int line) const {
+		return startsLarge ? startsLarge->PositionFromPartition(line) : starts->PositionFromPartition(line);
 	}
-	int LineFromPosition(int pos) const;
-	int LineStart(int line) const {
-		return starts.PositionFromPartition(line);
+	bool IsLarge() const {
+		return startsLarge != 0;
 	}
 
 	int MarkValue(int line);
@@ -69,40 +80,97 @@ enum actionType { insertAction, removeAction, startAction, containerAction };
 
 /**
  * Actions are used to store all the information required to perform one undo/redo step.
+ * The text of an action is held by the UndoArena of its history.
  */
 class Action {
 public:
-	actionType at;
-	int position;
+	Position position;
 	char *data;
-	int lenData;
+	Position lenData;
+	actionType at;
 	bool mayCoalesce;
 
 	Action();
-	~Action();
-	void Create(actionType at_, int position_=0, char *data_=0, int lenData_=0, bool mayCoalesce_=true);
-	void Destroy();
-	void Grab(Action *source);
+	void Create(actionType at_, Position position_=0, char *data_=0, Position lenData_=0, bool mayCoalesce_=true);
+};
+
+/**
+ * Append only store for the text of undo actions. Text is placed in large chunks one
+ * after another so that actions do not need an allocation each. As actions are only
+ * discarded from the end, for a new redo branch, or from the start, when trimming,
+ * their text is released the same way.
+ */
+class UndoArena {
+	struct Chunk {
+		char *data;
+		Position size;
+		Position used;
+	};
+	SplitVector<Chunk *> chunks;
+	Position allocated;
+	Position used;
+
+	void ReleaseChunk(int chunk);
+
+	// Private so UndoArena objects can not be copied
+	UndoArena(const UndoArena &);
+	void operator=(const UndoArena &);
+
+public:
+	enum { chunkSize = 0x10000 };
+	UndoArena();
+	~UndoArena();
+	/// Room for lengthData bytes after all the text already held.
+	char *Allocate(Position lengthData);
+	/// Release the text after end, or all of it when end is NULL.
+	void ReleaseAfter(const char *end);
+	/// Release the chunks before the one holding start, or all of them when start is NULL.
+	void ReleaseBefore(const char *start);
+	void Clear();
+	Position Allocated() const {
+		return allocated;
+	}
+	Position Used() const {
+		return used;
+	}
 };
 
 /**
- *
+ * Actions are held in blocks that are never moved so growing the history does not
+ * copy it, and the oldest blocks can be freed when the history is trimmed.
  */
 class UndoHistory {
-	Action *actions;
-	int lenActions;
+	SplitVector<Action *> blocks;
+	/// Position of action 0 in the first block
+	int firstAction;
 	int maxAction;
 	int currentAction;
 	int undoSequenceDepth;
 	int savePoint;
-
+	UndoArena arena;
+	Position memoryLimit;
+	int actionsTrimmed;
+
+	enum { actionsPerBlock = 0x400 };
+	Action &At(int act) const {
+		const int index = act + firstAction;
+		return blocks[index / actionsPerBlock][index % actionsPerBlock];
+	}
 	void EnsureUndoRoom();
+	void DiscardActions(int act);
+	void TrimActions(int actions);
+	void Trim();
+
+	// Private so UndoHistory objects can not be copied
+	UndoHistory(const UndoHistory &);
+	void operator=(const UndoHistory &);
 
 public:
 	UndoHistory();
 	~UndoHistory();
 
-	void AppendAction(actionType at, int position, char *data, int length, bool &startSequence, bool mayCoalesce=true);
+	/// @return room for the lengthData bytes of text of the action which the caller fills in.
+	char *AppendAction(actionType at, Position position, Position lengthData, bool &startSequence, bool mayCoalesce=true);
 
 	void BeginUndoAction();
 	void EndUndoAction();
@@ -124,6 +192,28 @@ public:
 	int StartRedo();
 	const Action &GetRedoStep() const;
 	void CompletedRedoStep();
+
+	/// Drop the oldest user operations while the history takes more than limit bytes.
+	/// 0 keeps all the history.
+	void SetMemoryLimit(Position limit);
+	Position GetMemoryLimit() const {
+		return memoryLimit;
+	}
+	/// Bytes allocated for actions and their text.
+	Position MemoryUse() const;
+	int Actions() const {
+		return maxAction;
+	}
+	int ActionsTrimmed() const {
+		return actionsTrimmed;
+	}
+
+	/// Write the saved form of the history into buffer, when not NULL.
+	/// @return the length of the saved form, 0 when there are no actions.
+	Position Save(char *buffer, Position documentLength, unsigned int checksum) const;
+	/// Replace the history with one saved from a document of the same length and checksum.
+	/// The history is left empty when the saved form is damaged.
+	bool Load(const char *data, Position length, Position documentLength, unsigned int checksum);
 };
 
 /**
@@ -133,8 +223,19 @@ public:
  */
 class CellBuffer {
 private:
-	SplitVector<char> substance;
-	SplitVector<char> style;
+	ChunkedVector<char> substance;
+	ChunkedVector<char> style;
+	/// Read-only text owned by the container, used in place of substance while it is mapped.
+	/// The text is then a list of pieces, each pointing into the mapping or into blocks of
+	/// inserted text, so that changes do not copy the mapped text.
+	IMappedText *mapped;
+	Partitioning<Position> *pieces;
+	SplitVector<const char *> pieceText;
+	SplitVector<char *> insertedBlocks;
+	char *insertedNext;
+	Position insertedLeft;
+	/// Styles of a mapped buffer are held as runs rather than one byte per character
+	RunStyles *styleRuns;
 	bool readOnly;
 
 	bool collectingUndo;
@@ -143,8 +244,15 @@ private:
 	LineVector lv;
 
 	/// Actions without undo
-	void BasicInsertString(int position, const char *s, int insertLength);
-	void BasicDeleteChars(int position, int deleteLength);
+	void BasicInsertString(Position position, const char *s, Position insertLength);
+	void BasicDeleteChars(Position position, Position deleteLength);
+	void ReleaseMapped();
+	void Materialise();
+	const char *StoreInserted(const char *s, Position insertLength);
+	void SplitPiece(Position position);
+	void MappedInsert(Position position, const char *s, Position insertLength);
+	void MappedDelete(Position position, Position deleteLength);
+	unsigned int Checksum() const;
 
 public:
 
@@ -152,28 +260,37 @@ public:
 	~CellBuffer();
 
 	/// Retrieving positions outside the range of the buffer works and returns 0
-	char CharAt(int position) const;
-	void GetCharRange(char *buffer, int position, int lengthRetrieve) const;
-	char StyleAt(int position) const;
-	void GetStyleRange(unsigned char *buffer, int position, int lengthRetrieve) const;
+	char CharAt(Position position) const;
+	void GetCharRange(char *buffer, Position position, Position lengthRetrieve) const;
+	char StyleAt(Position position) const;
+	void GetStyleRange(unsigned char *buffer, Position position, Position lengthRetrieve) const;
 	const char *BufferPointer();
-
-	int Length() const;
-	void Allocate(int newSize);
+	/// Text from position that is contiguous in memory without moving or copying anything
+	const char *RangeAt(Position position, Position *rangeLength) const;
+
+	/// Use text owned by pText without copying it. Only possible while the buffer is empty.
+	bool AdoptMapped(IMappedText *pText);
+	bool IsMapped() const;
+
+	Position Length() const;
+	void Allocate(Position newSize);
+	/// Hold text and styles in blocks of at most chunkSize bytes. 0 uses a single block.
+	void SetChunkSize(Position chunkSize);
+	Position GetChunkSize() const;
 	void SetPerLine(PerLine *pl);
 	int Lines() const;
-	int LineStart(int line) const;
-	int LineFromPosition(int pos) const { return lv.LineFromPosition(pos); }
-	void InsertLine(int line, int position, bool lineStart);
+	Position LineStart(int line) const;
+	int LineFromPosition(Position pos) const { return lv.LineFromPosition(pos); }
+	void InsertLine(int line, Position position, bool lineStart);
 	void RemoveLine(int line);
-	const char *InsertString(int position, const char *s, int insertLength, bool &startSequence);
+	const char *InsertString(Position position, const char *s, Position insertLength, bool &startSequence);
 
 	/// Setting styles for positions outside the range of the buffer is safe and has no effect.
 	/// @return true if the style of a character is changed.
-	bool SetStyleAt(int position, char styleValue, char mask='\377');
-	bool SetStyleFor(int position, int length, char styleValue, char mask);
+	bool SetStyleAt(Position position, char styleValue, char mask='\377');
+	bool SetStyleFor(Position position, Position length, char styleValue, char mask);
 
-	const char *DeleteChars(int position, int deleteLength, bool &startSequence);
+	const char *DeleteChars(Position position, Position deleteLength, bool &startSequence);
 
 	bool IsReadOnly() const;
 	void SetReadOnly(bool set);
@@ -189,6 +306,14 @@ public:
 	void EndUndoAction();
 	void AddUndoAction(int token, bool mayCoalesce);
 	void DeleteUndoHistory();
+	void SetUndoMemoryLimit(Position limit);
+	Position GetUndoMemoryLimit() const;
+	Position UndoMemoryUse() const;
+	int UndoActions() const;
+	/// The undo history can be saved and loaded again into a document holding the same text,
+	/// which becomes its save point.
+	Position SaveUndoHistory(char *buffer) const;
+	bool LoadUndoHistory(const char *data, Position length);
 
 	/// To perform an undo, StartUndo is called to retrieve the number of steps, then UndoStep is
 	/// called that many times. Similarly for redo.
@@ -0,0 +1,323 @@
+// Scintilla source code edit control
+/** @file ChunkedVector.h
+ ** Data structure for holding large arrays as a sequence of bounded
+ ** split vectors so that scattered insertions and deletions are fast.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef CHUNKEDVECTOR_H
+#define CHUNKEDVECTOR_H
+
+/// A sequence of elements held as a list of chunks where each chunk is a SplitVector.
+/// A modification only moves the gap inside the chunk it touches so edits far apart
+/// do not copy the data between them as a single SplitVector does.
+/// The start of each chunk is held in a Partitioning so finding the chunk for a
+/// position is a binary search.
+/// With a chunk size of 0 there is only ever one chunk and the behaviour is that
+/// of a SplitVector.
+/// A contiguous copy is only made when BufferPointer is called which joins all
+/// the chunks into one. The next modification splits it again.
+
+template <typename T>
+class ChunkedVector {
+private:
+	SplitVector<SplitVector<T> *> chunks;
+	Partitioning<ptrdiff_t> starts;
+	ptrdiff_t lengthBody;
+	ptrdiff_t chunkSize;
+	/// Most recently modified chunk as accesses are usually close to the last change.
+	/// Only written by modifications so that several threads may read the text at once.
+	int chunkLast;
+
+	// Private so ChunkedVector objects can not be copied
+	ChunkedVector(const ChunkedVector &);
+	void operator=(const ChunkedVector &);
+
+	SplitVector<T> *Chunk(int chunk) const {
+		return chunks.ValueAt(chunk);
+	}
+
+	ptrdiff_t ChunkStart(int chunk) const {
+		return starts.PositionFromPartition(chunk);
+	}
+
+	int ChunkFromPosition(ptrdiff_t position) const {
+		if (position >= lengthBody) {
+			// Appending goes into the last chunk
+			return static_cast<int>(chunks.Length()) - 1;
+		}
+		const int chunk = chunkLast;
+		if ((chunk < chunks.Length()) && (position >= ChunkStart(chunk))) {
+			if (position < ChunkStart(chunk + 1))
+				return chunk;
+			// Reading forward from the last change moves into the next chunk
+			if ((chunk + 1 < chunks.Length()) && (position < ChunkStart(chunk + 2)))
+				return chunk + 1;
+		}
+		return starts.PartitionFromPosition(position);
+	}
+
+	/// Find the chunk for a modification and remember it for the following lookups.
+	int ChunkForChange(ptrdiff_t position) {
+		chunkLast = ChunkFromPosition(position);
+		return chunkLast;
+	}
+
+	void InsertChunk(int chunk, SplitVector<T> *pChunk) {
+		// The new chunk takes its text from the end of the previous chunk
+		starts.InsertPartition(chunk, ChunkStart(chunk) - pChunk->Length());
+		chunks.Insert(chunk, pChunk);
+	}
+
+	void RemoveChunk(int chunk) {
+		// Only called for empty chunks when there are others
+		delete Chunk(chunk);
+		chunks.Delete(chunk);
+		starts.RemovePartition((chunk > 0) ? chunk : 1);
+		chunkLast = 0;
+	}
+
+	/// Break an oversized chunk into pieces that are no larger than chunkSize.
+	void SplitChunk(int chunk) {
+		SplitVector<T> *pChunk = Chunk(chunk);
+		const ptrdiff_t lengthChunk = pChunk->Length();
+		if ((chunkSize <= 0) || (lengthChunk <= chunkSize))
+			return;
+		const ptrdiff_t pieces = (lengthChunk + chunkSize - 1) / chunkSize;
+		const ptrdiff_t lengthPiece = (lengthChunk + pieces - 1) / pieces;
+		const T *data = pChunk->BufferPointer();
+		// Move pieces from the end so that the first piece stays in place
+		ptrdiff_t endPiece = lengthChunk;
+		while (endPiece > lengthPiece) {
+			ptrdiff_t startPiece = ((endPiece - 1) / lengthPiece) * lengthPiece;
+			SplitVector<T> *pPiece = new SplitVector<T>();
+			pPiece->ReAllocate(endPiece - startPiece + 1);
+			pPiece->InsertFromArray(0, data, startPiece, endPiece - startPiece);
+			InsertChunk(chunk + 1, pPiece);
+			endPiece = startPiece;
+		}
+		pChunk->DeleteRange(endPiece, lengthChunk - endPiece);
+		chunkLast = chunk;
+	}
+
+	/// Join a chunk with the following chunk when both have become small.
+	/// Only merging to half chunkSize stops repeated splitting and merging.
+	void MergeChunk(int chunk) {
+		if ((chunk + 1 >= chunks.Length()) || (chunkSize <= 0))
+			return;
+		SplitVector<T> *pChunk = Chunk(chunk);
+		SplitVector<T> *pNext = Chunk(chunk + 1);
+		if (pChunk->Length() + pNext->Length() <= chunkSize / 2) {
+			const ptrdiff_t lengthNext = pNext->Length();
+			pChunk->InsertFromArray(pChunk->Length(), pNext->BufferPointer(), 0, lengthNext);
+			delete pNext;
+			chunks.Delete(chunk + 1);
+			// Removing the boundary between them extends this chunk over the next
+			starts.RemovePartition(chunk + 1);
+			chunkLast = chunk;
+		}
+	}
+
+	void Join() {
+		if (chunks.Length() > 1) {
+			SplitVector<T> *pWhole = new SplitVector<T>();
+			pWhole->ReAllocate(lengthBody + 1);
+			for (int chunk = 0; chunk < chunks.Length(); chunk++) {
+				SplitVector<T> *pChunk = Chunk(chunk);
+				pWhole->InsertFromArray(pWhole->Length(), pChunk->BufferPointer(), 0, pChunk->Length());
+				delete pChunk;
+			}
+			chunks.DeleteAll();
+			starts.DeleteAll();
+			chunks.Insert(0, pWhole);
+			starts.InsertText(0, lengthBody);
+			chunkLast = 0;
+		}
+	}
+
+public:
+	/// Construct an empty vector with a single chunk.
+	ChunkedVector() : starts(8), lengthBody(0), chunkSize(0), chunkLast(0) {
+		chunks.Insert(0, new SplitVector<T>());
+	}
+
+	~ChunkedVector() {
+		for (int chunk = 0; chunk < chunks.Length(); chunk++) {
+			delete Chunk(chunk);
+		}
+	}
+
+	ptrdiff_t GetChunkSize() const {
+		return chunkSize;
+	}
+
+	/// Change the maximum size of chunks, reorganising the current contents.
+	/// 0 means a single unbounded chunk.
+	void SetChunkSize(ptrdiff_t chunkSize_) {
+		if (chunkSize_ < 0)
+			chunkSize_ = 0;
+		if (chunkSize != chunkSize_) {
+			chunkSize = chunkSize_;
+			Join();
+			SplitChunk(0);
+		}
+	}
+
+	/// Number of chunks currently in use.
+	int Chunks() const {
+		return static_cast<int>(chunks.Length());
+	}
+
+	/// Reserve space when there is a single unbounded chunk.
+	/// Bounded chunks allocate as they grow.
+	void ReAllocate(ptrdiff_t newSize) {
+		if (chunkSize == 0)
+			Chunk(0)->ReAllocate(newSize);
+	}
+
+	/// Retrieve the element at a particular position.
+	/// Retrieving positions outside the range of the vector returns 0.
+	T ValueAt(ptrdiff_t position) const {
+		if (chunks.Length() == 1)
+			return Chunk(0)->ValueAt(position);
+		if ((position < 0) || (position >= lengthBody))
+			return 0;
+		const int chunk = ChunkFromPosition(position);
+		return Chunk(chunk)->ValueAt(position - ChunkStart(chunk));
+	}
+
+	void SetValueAt(ptrdiff_t position, T v) {
+		if ((position < 0) || (position >= lengthBody))
+			return;
+		const int chunk = ChunkForChange(position);
+		Chunk(chunk)->SetValueAt(position - ChunkStart(chunk), v);
+	}
+
+	ptrdiff_t Length() const {
+		return lengthBody;
+	}
+
+	/// Insert insertLength elements taken from s starting at positionFrom.
+	void InsertFromArray(ptrdiff_t position, const T s[], ptrdiff_t positionFrom, ptrdiff_t insertLength) {
+		PLATFORM_ASSERT((position >= 0) && (position <= lengthBody));
+		if (insertLength > 0) {
+			if ((position < 0) || (position > lengthBody)) {
+				return;
+			}
+			while (insertLength > 0) {
+				// Large insertions are made a chunk at a time to avoid one huge temporary chunk
+				ptrdiff_t lengthPart = insertLength;
+				if ((chunkSize > 0) && (lengthPart > chunkSize))
+					lengthPart = chunkSize;
+				const int chunk = ChunkForChange(position);
+				Chunk(chunk)->InsertFromArray(position - ChunkStart(chunk), s, positionFrom, lengthPart);
+				starts.InsertText(chunk, lengthPart);
+				lengthBody += lengthPart;
+				SplitChunk(chunk);
+				position += lengthPart;
+				positionFrom += lengthPart;
+				insertLength -= lengthPart;
+			}
+		}
+	}
+
+	/// Insert a number of elements into the vector setting their value.
+	void InsertValue(ptrdiff_t position, ptrdiff_t insertLength, T v) {
+		PLATFORM_ASSERT((position >= 0) && (position <= lengthBody));
+		if (insertLength > 0) {
+			if ((position < 0) || (position > lengthBody)) {
+				return;
+			}
+			while (insertLength > 0) {
+				ptrdiff_t lengthPart = insertLength;
+				if ((chunkSize > 0) && (lengthPart > chunkSize))
+					lengthPart = chunkSize;
+				const int chunk = ChunkForChange(position);
+				Chunk(chunk)->InsertValue(position - ChunkStart(chunk), lengthPart, v);
+				starts.InsertText(chunk, lengthPart);
+				lengthBody += lengthPart;
+				SplitChunk(chunk);
+				position += lengthPart;
+				insertLength -= lengthPart;
+			}
+		}
+	}
+
+	/// Delete a range from the vector which may cover several chunks.
+	void DeleteRange(ptrdiff_t position, ptrdiff_t deleteLength) {
+		PLATFORM_ASSERT((position >= 0) && (position + deleteLength <= lengthBody));
+		if ((position < 0) || ((position + deleteLength) > lengthBody)) {
+			return;
+		}
+		if ((position == 0) && (deleteLength == lengthBody)) {
+			DeleteAll();
+			return;
+		}
+		while (deleteLength > 0) {
+			const int chunk = ChunkForChange(position);
+			SplitVector<T> *pChunk = Chunk(chunk);
+			const ptrdiff_t offset = position - ChunkStart(chunk);
+			ptrdiff_t lengthDelete = pChunk->Length() - offset;
+			if (lengthDelete > deleteLength)
+				lengthDelete = deleteLength;
+			pChunk->DeleteRange(offset, lengthDelete);
+			starts.InsertText(chunk, -lengthDelete);
+			lengthBody -= lengthDelete;
+			deleteLength -= lengthDelete;
+			if (pChunk->Length() == 0) {
+				RemoveChunk(chunk);
+			} else if (deleteLength == 0) {
+				MergeChunk(chunk);
+				if (chunk > 0)
+					MergeChunk(chunk - 1);
+			}
+		}
+	}
+
+	void DeleteAll() {
+		for (int chunk = 0; chunk < chunks.Length(); chunk++) {
+			delete Chunk(chunk);
+		}
+		chunks.DeleteAll();
+		starts.DeleteAll();
+		chunks.Insert(0, new SplitVector<T>());
+		lengthBody = 0;
+		chunkLast = 0;
+	}
+
+	/// Retrieve a range of elements into an array
+	void GetRange(T *buffer, ptrdiff_t position, ptrdiff_t retrieveLength) const {
+		while (retrieveLength > 0) {
+			const int chunk = ChunkFromPosition(position);
+			const SplitVector<T> *pChunk = Chunk(chunk);
+			const ptrdiff_t offset = position - ChunkStart(chunk);
+			ptrdiff_t lengthRetrieve = pChunk->Length() - offset;
+			if (lengthRetrieve > retrieveLength)
+				lengthRetrieve = retrieveLength;
+			pChunk->GetRange(buffer, offset, lengthRetrieve);
+			buffer += lengthRetrieve;
+			position += lengthRetrieve;
+			retrieveLength -= lengthRetrieve;
+		}
+	}
+
+	/// Return a pointer to the elements from position that are contiguous in memory
+	/// and set *rangeLength to their number. Nothing is moved or joined.
+	const T *RangeAt(ptrdiff_t position, ptrdiff_t *rangeLength) const {
+		if ((position < 0) || (position >= lengthBody)) {
+			*rangeLength = 0;
+			return 0;
+		}
+		const int chunk = ChunkFromPosition(position);
+		return Chunk(chunk)->RangeAt(position - ChunkStart(chunk), rangeLength);
+	}
+
+	/// Return a pointer to a contiguous, terminated copy of the elements.
+	/// All chunks are joined into one which remains valid until the next modification.
+	T *BufferPointer() {
+		Join();
+		return Chunk(0)->BufferPointer();
+	}
+};
+
+#endif
@@ -9,6 +9,8 @@
 
 #include "Platform.h"
 
+#include "Sci_Position.h"
+#include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
 #include "RunStyles.h"
@@ -31,7 +33,7 @@ void ContractionState::EnsureData() {
 		visible = new RunStyles();
 		expanded = new RunStyles();
 		heights = new RunStyles();
-		displayLines = new Partitioning(4);
+		displayLines = new Partitioning<int>(4);
 		InsertLines(0, linesInDocument);
 	}
 }
@@ -209,7 +211,7 @@ int ContractionState::ContractedNext(int lineDocStart) const {
 		if (!expanded->ValueAt(lineDocStart)) {
 			return lineDocStart;
 		} else {
-			int lineDocNextChange = expanded->EndRun(lineDocStart);
+			int lineDocNextChange = static_cast<int>(expanded->EndRun(lineDocStart));
 			if (lineDocNextChange < LinesInDoc())
 				return lineDocNextChange;
 			else
@@ -218,6 +220,63 @@ int ContractionState::ContractedNext(int lineDocStart) const {
 	}
 }
 
+//!-start-[FoldBulk]
+// Set the visibility and expansion of lineCount lines from lineDocStart, one char for each line
+// in visibleNew and expandedNew, in one pass rather than line by line.
+// Return true if this is a change.
+bool ContractionState::SetFoldState(int lineDocStart, int lineCount, const char *visibleNew, const char *expandedNew) {
+	if ((lineDocStart < 0) || (lineCount <= 0) || (lineDocStart + lineCount > LinesInDoc()))
+		return false;
+	if (OneToOne()) {
+		bool allShown = true;
+		for (int i = 0; (i < lineCount) && allShown; i++)
+			allShown = visibleNew[i] && expandedNew[i];
+		if (allShown)
+			return false;
+	}
+	EnsureData();
+	Check();
+	bool changed = false;
+	// Display lines are changed in order of line so each change continues the step of the last
+	int line = lineDocStart;
+	const int lineEnd = lineDocStart + lineCount;
+	while (line < lineEnd) {
+		const bool visibleRun = visible->ValueAt(line) == 1;
+		int lineEndRun = static_cast<int>(visible->EndRun(line));
+		if (lineEndRun > lineEnd)
+			lineEndRun = lineEnd;
+		for (; line < lineEndRun; line++) {
+			if ((visibleNew[line - lineDocStart] != 0) != visibleRun) {
+				const int height = heights->ValueAt(line);
+				displayLines->InsertText(line, visibleRun ? -height : height);
+				changed = true;
+			}
+		}
+	}
+	for (int i = 0; i < lineCount;) {
+		int iEnd = i + 1;
+		while ((iEnd < lineCount) && ((visibleNew[iEnd] != 0) == (visibleNew[i] != 0)))
+			iEnd++;
+		Position position = lineDocStart + i;
+		Position fillLength = iEnd - i;
+		visible->FillRange(position, visibleNew[i] ? 1 : 0, fillLength);
+		i = iEnd;
+	}
+	for (int j = 0; j < lineCount;) {
+		int jEnd = j + 1;
+		while ((jEnd < lineCount) && ((expandedNew[jEnd] != 0) == (expandedNew[j] != 0)))
+			jEnd++;
+		Position position = lineDocStart + j;
+		Position fillLength = jEnd - j;
+		if (expanded->FillRange(position, expandedNew[j] ? 1 : 0, fillLength))
+			changed = true;
+		j = jEnd;
+	}
+	Check();
+	return changed;
+}
+//!-end-[FoldBulk]
+
 int ContractionState::GetHeight(int lineDoc) const {
 	if (OneToOne()) {
 		return 1;
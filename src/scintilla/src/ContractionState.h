@@ -19,7 +19,7 @@ class ContractionState {
 	RunStyles *visible;
 	RunStyles *expanded;
 	RunStyles *heights;
-	Partitioning *displayLines;
+	Partitioning<int> *displayLines;
 	int linesInDocument;
 
 	void EnsureData();
@@ -53,6 +53,7 @@ public:
 	bool GetExpanded(int lineDoc) const;
 	bool SetExpanded(int lineDoc, bool expanded);
 	int ContractedNext(int lineDocStart) const;
+	bool SetFoldState(int lineDocStart, int lineCount, const char *visibleNew, const char *expandedNew);	//!-add-[FoldBulk]
 
 	int GetHeight(int lineDoc) const;
 	bool SetHeight(int lineDoc, int height);
@@ -0,0 +1,982 @@
+// Scintilla source code edit control
+/** @file DFASearch.cxx
+ ** Linear time regular expression search.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+/*
+ * The syntax follows RESearch with some additions:
+ *
+ *      char    matches itself unless it is one of . \ [ ] * + ? ^ $
+ *              and, with the posix option, ( ) | { }
+ *      .       any character except the line end characters \r and \n
+ *      [set]   as RESearch; a complemented set [^...] does not match \r or \n
+ *      \a \b \f \n \r \t \v \xHH  the character with that value;
+ *              \n and \r may be used to match over line ends
+ *      \d \D \s \S \w \W  character classes; none of these match \r or \n
+ *      \< \>   start and end of word
+ *      ^ $     start and end of line at the start or end of an alternative
+ *      * + ?   repeat the previous form, lazily when followed by ?
+ *      \{n\} \{n,\} \{n,m\}  bounded repetition, { } with the posix option
+ *      \( \)   tagged sub-expression, ( ) with the posix option
+ *      x\|y    either x or y, x|y with the posix option
+ *
+ * Back references (\1 in the pattern) can not be matched in linear time so are an error.
+ * When there is a choice, the leftmost match is found and, from there, the one that
+ * a backtracking matcher would find first.
+ *
+ * Implementation:
+ *
+ * The pattern is parsed into a tree which is compiled twice into instruction lists for
+ * a non-deterministic automaton: once forward, preceded by a lazy loop over any byte so
+ * a match may start anywhere, and once with concatenations reversed.
+ * A deterministic state is an ordered list of the automaton's instructions that are
+ * waiting for the next byte together with what kind of character was just passed so
+ * that ^ $ \< and \> can be decided. States and their transitions are only built when
+ * the text reaches them and are kept in a DFACache until it is full when it is emptied.
+ * The forward automaton keeps its threads in priority order and drops those of lower
+ * priority than a thread that matches so it stops at the end of the leftmost match.
+ * The reversed automaton is then run backwards from that end to find the start.
+ * Tags are found when needed by simulating the forward automaton over just the match.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "Sci_Position.h"
+#include "CharClassify.h"
+#include "RESearch.h"
+#include "DFASearch.h"
+
+#ifdef SCI_NAMESPACE
+using namespace Scintilla;
+#endif
+
+// Stands for the missing character before the start or after the end of the text
+static const int noChar = 256;
+
+// Kinds of character on either side of a position
+enum { ctxNone, ctxLF, ctxCR, ctxWord, ctxOther };
+
+enum { asBOL, asEOL, asBOW, asEOW };
+
+static bool AssertionHolds(int assertion, int before, int after) {
+	switch (assertion) {
+	case asBOL:
+		return (before == ctxNone) || (before == ctxLF) || ((before == ctxCR) && (after != ctxLF));
+	case asEOL:
+		return (after == ctxNone) || (after == ctxCR) || ((after == ctxLF) && (before != ctxCR));
+	case asBOW:
+		return (after == ctxWord) && (before != ctxWord);
+	case asEOW:
+		return (before == ctxWord) && (after != ctxWord);
+	}
+	return false;
+}
+
+// Limits that stop a short pattern from expanding into a huge automaton
+static const size_t maxInstructions = 20000;
+static const int maxRepetition = 1000;
+// Each cached state holds a transition for every byte
+static const size_t maxStates = 2000;
+
+class ByteSet {
+	unsigned char bits[32];
+public:
+	ByteSet() {
+		memset(bits, 0, sizeof(bits));
+	}
+	void Add(int ch) {
+		bits[ch >> 3] |= static_cast<unsigned char>(1 << (ch & 7));
+	}
+	void AddRange(int first, int last) {
+		for (int ch = first; ch <= last; ch++)
+			Add(ch);
+	}
+	void Remove(int ch) {
+		bits[ch >> 3] &= static_cast<unsigned char>(~(1 << (ch & 7)));
+	}
+	void Invert() {
+		for (size_t i = 0; i < sizeof(bits); i++)
+			bits[i] = static_cast<unsigned char>(~bits[i]);
+	}
+	bool Contains(int ch) const {
+		return (ch < noChar) && ((bits[ch >> 3] & (1 << (ch & 7))) != 0);
+	}
+};
+
+enum { opByte, opSplit, opSave, opAssert, opMatch };
+
+struct Instruction {
+	int op;
+	int next;	///< Following instruction, the preferred one for opSplit
+	int alt;	///< Other choice for opSplit
+	int arg;	///< Set for opByte, slot for opSave, assertion for opAssert
+};
+
+/// Compiled form of a pattern in one direction.
+class DFAProgram {
+public:
+	std::vector<Instruction> code;
+	std::vector<ByteSet> sets;
+	int start;	///< Entry where the scan starts
+	int startAnchored;	///< Entry that only matches from the position where it starts
+	unsigned char context[noChar + 1];
+
+	DFAProgram() : start(0), startAnchored(0) {
+	}
+	int Add(int op, int next, int alt, int arg) {
+		Instruction ins = {op, next, alt, arg};
+		code.push_back(ins);
+		return static_cast<int>(code.size()) - 1;
+	}
+};
+
+enum { ndSet, ndConcat, ndAlternate, ndRepeat, ndGroup, ndAssert };
+
+struct Node {
+	int type;
+	int arg;	///< Set for ndSet, tag for ndGroup, assertion for ndAssert
+	int minimum;
+	int maximum;	///< -1 when unbounded
+	bool greedy;
+	std::vector<int> children;
+};
+
+/// Turns a pattern into a tree of Nodes and then into DFAPrograms.
+class RegexParser {
+	const char *pattern;
+	Sci_Position length;
+	Sci_Position i;
+	bool caseSensitive;
+	bool posix;
+	CharClassify *charClass;
+	int tagNext;
+public:
+	const char *error;
+	std::vector<Node> nodes;
+	std::vector<ByteSet> sets;
+
+	RegexParser(const char *pattern_, Sci_Position length_, bool caseSensitive_, bool posix_,
+		CharClassify *charClass_) :
+		pattern(pattern_), length(length_), i(0), caseSensitive(caseSensitive_), posix(posix_),
+		charClass(charClass_), tagNext(1), error(0) {
+	}
+
+	int Parse() {
+		const int root = ParseAlternation();
+		if (!error && (i < length))
+			error = "Unmatched )";
+		return root;
+	}
+
+	int AddSet(const ByteSet &set) {
+		sets.push_back(set);
+		return NewNode(ndSet, static_cast<int>(sets.size()) - 1);
+	}
+
+	/// Compile the tree into program with next followed after it.
+	int Emit(DFAProgram &program, int node, int next, bool reversed) {
+		if (program.code.size() > maxInstructions)
+			return next;
+		switch (nodes[node].type) {
+		case ndSet:
+			return program.Add(opByte, next, 0, nodes[node].arg);
+		case ndAssert:
+			return program.Add(opAssert, next, 0, nodes[node].arg);
+		case ndConcat: {
+				const std::vector<int> children = nodes[node].children;
+				if (reversed) {
+					for (size_t child = 0; child < children.size(); child++)
+						next = Emit(program, children[child], next, reversed);
+				} else {
+					for (size_t child = children.size(); child > 0; child--)
+						next = Emit(program, children[child - 1], next, reversed);
+				}
+				return next;
+			}
+		case ndAlternate: {
+				const std::vector<int> children = nodes[node].children;
+				int entry = Emit(program, children.back(), next, reversed);
+				for (size_t child = children.size() - 1; child > 0; child--) {
+					const int first = Emit(program, children[child - 1], next, reversed);
+					entry = program.Add(opSplit, first, entry, 0);
+				}
+				return entry;
+			}
+		case ndGroup: {
+				const int tag = nodes[node].arg;
+				const int child = nodes[node].children[0];
+				if (reversed)
+					return Emit(program, child, next, reversed);
+				const int close = program.Add(opSave, next, 0, tag * 2 + 1);
+				const int body = Emit(program, child, close, reversed);
+				return program.Add(opSave, body, 0, tag * 2);
+			}
+		case ndRepeat: {
+				const Node repeat = nodes[node];
+				const int child = repeat.children[0];
+				int entry = next;
+				if (repeat.maximum < 0) {
+					const int loop = program.Add(opSplit, next, next, 0);
+					const int body = Emit(program, child, loop, reversed);
+					program.code[loop].next = repeat.greedy ? body : next;
+					program.code[loop].alt = repeat.greedy ? next : body;
+					entry = loop;
+				} else {
+					for (int optional = repeat.minimum; optional < repeat.maximum; optional++) {
+						const int choice = program.Add(opSplit, next, next, 0);
+						const int body = Emit(program, child, entry, reversed);
+						program.code[choice].next = repeat.greedy ? body : next;
+						program.code[choice].alt = repeat.greedy ? next : body;
+						entry = choice;
+					}
+				}
+				for (int required = 0; required < repeat.minimum; required++)
+					entry = Emit(program, child, entry, reversed);
+				return entry;
+			}
+		}
+		return next;
+	}
+
+private:
+	int NewNode(int type, int arg) {
+		Node node;
+		node.type = type;
+		node.arg = arg;
+		node.minimum = 0;
+		node.maximum = 0;
+		node.greedy = true;
+		nodes.push_back(node);
+		return static_cast<int>(nodes.size()) - 1;
+	}
+
+	/// Length of the grouping operator op at position: bare with posix, otherwise escaped.
+	int MetaLength(Sci_Position position, char op) const {
+		if (posix)
+			return ((position < length) && (pattern[position] == op)) ? 1 : 0;
+		return ((position + 1 < length) && (pattern[position] == '\\') && (pattern[position + 1] == op)) ? 2 : 0;
+	}
+
+	bool EndsAlternative(Sci_Position position) const {
+		return (position >= length) || MetaLength(position, '|') || MetaLength(position, ')');
+	}
+
+	int ParseAlternation() {
+		const int first = ParseSequence();
+		if (error || !MetaLength(i, '|'))
+			return first;
+		const int alternation = NewNode(ndAlternate, 0);
+		nodes[alternation].children.push_back(first);
+		int lengthOp = 0;
+		while (!error && ((lengthOp = MetaLength(i, '|')) > 0)) {
+			i += lengthOp;
+			const int alternative = ParseSequence();
+			nodes[alternation].children.push_back(alternative);
+		}
+		return alternation;
+	}
+
+	int ParseSequence() {
+		const int sequence = NewNode(ndConcat, 0);
+		const Sci_Position startSequence = i;
+		while (!error && !EndsAlternative(i)) {
+			int atom;
+			if ((pattern[i] == '^') && (i == startSequence)) {
+				i++;
+				atom = NewNode(ndAssert, asBOL);
+			} else if ((pattern[i] == '$') && EndsAlternative(i + 1)) {
+				i++;
+				atom = NewNode(ndAssert, asEOL);
+			} else {
+				atom = ParseAtom();
+			}
+			if (!error)
+				atom = ParseQuantifiers(atom);
+			nodes[sequence].children.push_back(atom);
+		}
+		return sequence;
+	}
+
+	int ParseAtom() {
+		int lengthOp = MetaLength(i, '(');
+		if (lengthOp) {
+			i += lengthOp;
+			// Only the first 9 sub-expressions are tagged
+			const int tag = (tagNext < DFASearch::MAXTAG) ? tagNext++ : 0;
+			const int inner = ParseAlternation();
+			if (error)
+				return inner;
+			lengthOp = MetaLength(i, ')');
+			if (!lengthOp) {
+				error = "Missing )";
+				return inner;
+			}
+			i += lengthOp;
+			if (!tag)
+				return inner;
+			const int group = NewNode(ndGroup, tag);
+			nodes[group].children.push_back(inner);
+			return group;
+		}
+		const unsigned char ch = static_cast<unsigned char>(pattern[i]);
+		ByteSet set;
+		if (ch == '.') {
+			i++;
+			set.Invert();
+			set.Remove('\r');
+			set.Remove('\n');
+			return AddSet(set);
+		} else if (ch == '[') {
+			return ParseSet();
+		} else if ((ch == '\\') && (i + 1 < length)) {
+			const char escaped = pattern[i + 1];
+			if (escaped == '<') {
+				i += 2;
+				return NewNode(ndAssert, asBOW);
+			} else if (escaped == '>') {
+				i += 2;
+				return NewNode(ndAssert, asEOW);
+			} else if ((escaped >= '1') && (escaped <= '9')) {
+				error = "Back references are not supported";
+				return NewNode(ndConcat, 0);
+			}
+		}
+		const int byte = ReadByte(set);
+		if (byte >= 0)
+			AddWithCase(set, byte);
+		return AddSet(set);
+	}
+
+	/// Read one item of the pattern: a character or an escape. Classes like \d are
+	/// added to set and -1 returned, otherwise the byte is returned.
+	int ReadByte(ByteSet &set) {
+		const unsigned char ch = static_cast<unsigned char>(pattern[i++]);
+		if ((ch != '\\') || (i >= length))
+			return ch;
+		const unsigned char escaped = static_cast<unsigned char>(pattern[i++]);
+		switch (escaped) {
+		case 'a':
+			return '\a';
+		case 'b':
+			return '\b';
+		case 'f':
+			return '\f';
+		case 'n':
+			return '\n';
+		case 'r':
+			return '\r';
+		case 't':
+			return '\t';
+		case 'v':
+			return '\v';
+		case 'x':
+			if ((i + 1 < length) && (HexDigit(pattern[i]) >= 0) && (HexDigit(pattern[i + 1]) >= 0)) {
+				const int value = HexDigit(pattern[i]) * 16 + HexDigit(pattern[i + 1]);
+				i += 2;
+				return value;
+			}
+			return 'x';
+		case 'd':
+		case 'D':
+		case 's':
+		case 'S':
+		case 'w':
+		case 'W':
+			AddClass(set, escaped);
+			return -1;
+		}
+		return escaped;
+	}
+
+	static int HexDigit(char ch) {
+		if ((ch >= '0') && (ch <= '9'))
+			return ch - '0';
+		if ((ch >= 'A') && (ch <= 'F'))
+			return ch - 'A' + 10;
+		if ((ch >= 'a') && (ch <= 'f'))
+			return ch - 'a' + 10;
+		return -1;
+	}
+
+	void AddClass(ByteSet &set, unsigned char cls) {
+		ByteSet members;
+		switch (cls) {
+		case 'd':
+		case 'D':
+			members.AddRange('0', '9');
+			break;
+		case 's':
+		case 'S':
+			members.Add(' ');
+			members.Add('\t');
+			members.Add('\v');
+			members.Add('\f');
+			break;
+		default:
+			for (int ch = 0; ch < noChar; ch++) {
+				if (charClass->IsWord(static_cast<unsigned char>(ch)))
+					members.Add(ch);
+			}
+		}
+		if ((cls == 'D') || (cls == 'S') || (cls == 'W'))
+			members.Invert();
+		members.Remove('\r');
+		members.Remove('\n');
+		for (int ch = 0; ch < noChar; ch++) {
+			if (members.Contains(ch))
+				set.Add(ch);
+		}
+	}
+
+	void AddWithCase(ByteSet &set, int ch) {
+		set.Add(ch);
+		if (!caseSensitive) {
+			if ((ch >= 'a') && (ch <= 'z'))
+				set.Add(ch - 'a' + 'A');
+			else if ((ch >= 'A') && (ch <= 'Z'))
+				set.Add(ch - 'A' + 'a');
+		}
+	}
+
+	int ParseSet() {
+		i++;	// [
+		ByteSet set;
+		bool complement = false;
+		if ((i < length) && (pattern[i] == '^')) {
+			complement = true;
+			i++;
+		}
+		bool firstItem = true;
+		for (;;) {
+			if (i >= length) {
+				error = "Missing ]";
+				return AddSet(set);
+			}
+			if ((pattern[i] == ']') && !firstItem) {
+				i++;
+				break;
+			}
+			firstItem = false;
+			const int low = ReadByte(set);
+			if (low < 0)
+				continue;
+			if ((i + 1 < length) && (pattern[i] == '-') && (pattern[i + 1] != ']')) {
+				i++;
+				const int high = ReadByte(set);
+				if (high < 0) {
+					// A class can not end a range so the - is literal
+					AddWithCase(set, low);
+					set.Add('-');
+				} else if (high < low) {
+					error = "Invalid range in set";
+					return AddSet(set);
+				} else {
+					for (int ch = low; ch <= high; ch++)
+						AddWithCase(set, ch);
+				}
+			} else {
+				AddWithCase(set, low);
+			}
+		}
+		if (complement) {
+			set.Invert();
+			set.Remove('\r');
+			set.Remove('\n');
+		}
+		return AddSet(set);
+	}
+
+	int ParseQuantifiers(int atom) {
+		while (!error && (i < length)) {
+			int minimum = 0;
+			int maximum = -1;
+			int lengthOp = 0;
+			if (pattern[i] == '*') {
+				i++;
+			} else if (pattern[i] == '+') {
+				minimum = 1;
+				i++;
+			} else if (pattern[i] == '?') {
+				maximum = 1;
+				i++;
+			} else if ((lengthOp = MetaLength(i, '{')) > 0) {
+				i += lengthOp;
+				minimum = ReadCount();
+				maximum = minimum;
+				if ((i < length) && (pattern[i] == ',')) {
+					i++;
+					maximum = ((i < length) && (pattern[i] >= '0') && (pattern[i] <= '9')) ? ReadCount() : -1;
+				}
+				lengthOp = MetaLength(i, '}');
+				if (!lengthOp || (minimum < 0)) {
+					error = "Invalid repetition count";
+					return atom;
+				}
+				i += lengthOp;
+				if ((minimum > maxRepetition) || (maximum > maxRepetition) ||
+					((maximum >= 0) && (maximum < minimum))) {
+					error = "Invalid repetition count";
+					return atom;
+				}
+			} else {
+				break;
+			}
+			const int repeat = NewNode(ndRepeat, 0);
+			nodes[repeat].minimum = minimum;
+			nodes[repeat].maximum = maximum;
+			if ((i < length) && (pattern[i] == '?')) {
+				nodes[repeat].greedy = false;
+				i++;
+			}
+			nodes[repeat].children.push_back(atom);
+			atom = repeat;
+		}
+		return atom;
+	}
+
+	int ReadCount() {
+		if ((i >= length) || (pattern[i] < '0') || (pattern[i] > '9'))
+			return -1;
+		int count = 0;
+		while ((i < length) && (pattern[i] >= '0') && (pattern[i] <= '9')) {
+			if (count <= maxRepetition)
+				count = count * 10 + pattern[i] - '0';
+			i++;
+		}
+		return count;
+	}
+};
+
+/**
+ * Deterministic states built on demand from a DFAProgram.
+ * In leftmost-first mode threads of lower priority than a matching thread are dropped
+ * so the scan ends with the match a backtracking matcher prefers. Otherwise all are
+ * kept and every position where a match ends is reported.
+ */
+class DFACache {
+	const DFAProgram &program;
+	bool leftmostFirst;
+	struct State {
+		std::vector<int> threads;
+		int context;
+	};
+	std::vector<State> states;
+	/// Transitions of each state for every byte and noChar in one table, -1 until built
+	std::vector<int> transitions;
+	std::map<std::vector<int>, int> lookup;
+	std::vector<int> mark;
+	int generation;
+	std::vector<int> stack;
+	std::vector<int> closure;
+
+	void NextGeneration() {
+		generation++;
+		if (generation == 0x7fffffff) {
+			std::fill(mark.begin(), mark.end(), 0);
+			generation = 1;
+		}
+	}
+
+	int Intern(const std::vector<int> &threads, int context) {
+		std::vector<int> key(1, context);
+		key.insert(key.end(), threads.begin(), threads.end());
+		std::map<std::vector<int>, int>::const_iterator it = lookup.find(key);
+		if (it != lookup.end())
+			return it->second;
+		State state;
+		state.threads = threads;
+		state.context = context;
+		states.push_back(state);
+		transitions.resize(states.size() * (noChar + 1), -1);
+		const int index = static_cast<int>(states.size()) - 1;
+		lookup[key] = index;
+		built++;
+		return index;
+	}
+
+	int Build(int state, int ch, bool backward) {
+		if (states.size() >= maxStates) {
+			// Start again, keeping only the current state
+			const State current = states[state];
+			states.clear();
+			transitions.clear();
+			lookup.clear();
+			resets++;
+			state = Intern(current.threads, current.context);
+		}
+		const std::vector<int> threads = states[state].threads;
+		const int context = states[state].context;
+		const int before = backward ? program.context[ch] : context;
+		const int after = backward ? context : program.context[ch];
+
+		// Follow the threads through instructions that do not consume a byte, in priority order
+		NextGeneration();
+		closure.clear();
+		for (size_t thread = 0; thread < threads.size(); thread++) {
+			stack.push_back(threads[thread]);
+			while (!stack.empty()) {
+				const int pc = stack.back();
+				stack.pop_back();
+				if (mark[pc] == generation)
+					continue;
+				mark[pc] = generation;
+				const Instruction &ins = program.code[pc];
+				switch (ins.op) {
+				case opSave:
+					stack.push_back(ins.next);
+					break;
+				case opSplit:
+					stack.push_back(ins.alt);
+					stack.push_back(ins.next);
+					break;
+				case opAssert:
+					if (AssertionHolds(ins.arg, before, after))
+						stack.push_back(ins.next);
+					break;
+				default:
+					closure.push_back(pc);
+				}
+			}
+		}
+
+		bool matched = false;
+		NextGeneration();
+		std::vector<int> threadsNext;
+		for (size_t pos = 0; pos < closure.size(); pos++) {
+			const Instruction &ins = program.code[closure[pos]];
+			if (ins.op == opMatch) {
+				matched = true;
+				if (leftmostFirst)
+					break;
+			} else if (program.sets[ins.arg].Contains(ch) && (mark[ins.next] != generation)) {
+				mark[ins.next] = generation;
+				threadsNext.push_back(ins.next);
+			}
+		}
+		const int next = Intern(threadsNext, program.context[ch]);
+		const int transition = (next << stateShift) |
+			(threadsNext.empty() ? deadBit : 0) | (matched ? matchedBit : 0);
+		transitions[state * (noChar + 1) + ch] = transition;
+		return transition;
+	}
+
+public:
+	/// A transition is the next state shifted left with these bits set for a match
+	/// ending before the byte and for the next state having no threads left.
+	enum { matchedBit = 1, deadBit = 2, stateShift = 2 };
+
+	int built;
+	int resets;
+
+	DFACache(const DFAProgram &program_, bool leftmostFirst_) :
+		program(program_), leftmostFirst(leftmostFirst_), mark(program_.code.size(), 0), generation(0),
+		built(0), resets(0) {
+	}
+
+	int Start(int context) {
+		return Intern(std::vector<int>(1, program.start), context);
+	}
+
+	bool Dead(int state) const {
+		return states[state].threads.empty();
+	}
+
+	/// Move over ch, returning the transition. backward when moving towards the start of the text.
+	int Step(int state, int ch, bool backward) {
+		const int transition = transitions[state * (noChar + 1) + ch];
+		if (transition >= 0)
+			return transition;
+		return Build(state, ch, backward);
+	}
+};
+
+/// Simulates the forward automaton keeping the position of tags in each thread.
+class TagMatcher {
+	const DFAProgram &program;
+	BlockIndexer &bi;
+	std::vector<int> mark;
+	int generation;
+
+	struct Threads {
+		std::vector<int> pcs;
+		std::vector<Sci_Position> tags;
+		void Clear() {
+			pcs.clear();
+			tags.clear();
+		}
+	};
+
+	enum { slots = DFASearch::MAXTAG * 2 };
+
+	void Add(Threads &threads, int pc, Sci_Position *tags, Sci_Position position, int before, int after) {
+		if (mark[pc] == generation)
+			return;
+		mark[pc] = generation;
+		const Instruction &ins = program.code[pc];
+		switch (ins.op) {
+		case opSplit:
+			Add(threads, ins.next, tags, position, before, after);
+			Add(threads, ins.alt, tags, position, before, after);
+			break;
+		case opSave: {
+				const Sci_Position previous = tags[ins.arg];
+				tags[ins.arg] = position;
+				Add(threads, ins.next, tags, position, before, after);
+				tags[ins.arg] = previous;
+			}
+			break;
+		case opAssert:
+			if (AssertionHolds(ins.arg, before, after))
+				Add(threads, ins.next, tags, position, before, after);
+			break;
+		default:
+			threads.pcs.push_back(pc);
+			threads.tags.insert(threads.tags.end(), tags, tags + slots);
+		}
+	}
+
+	int ContextAt(Sci_Position position, Sci_Position lengthText) {
+		if ((position < 0) || (position >= lengthText))
+			return ctxNone;
+		return program.context[static_cast<unsigned char>(bi.CharAt(position))];
+	}
+
+public:
+	TagMatcher(const DFAProgram &program_, BlockIndexer &bi_) :
+		program(program_), bi(bi_), mark(program_.code.size(), 0), generation(0) {
+	}
+
+	/// Match from start, not going past end, setting tags on success.
+	bool Match(Sci_Position start, Sci_Position end, Sci_Position *tagsFound) {
+		const Sci_Position lengthText = bi.Length();
+		Sci_Position tags[slots];
+		for (int slot = 0; slot < slots; slot++)
+			tags[slot] = DFASearch::NOTFOUND;
+		Threads current;
+		Threads following;
+		generation++;
+		Add(current, program.startAnchored, tags, start,
+			ContextAt(start - 1, lengthText), ContextAt(start, lengthText));
+		bool found = false;
+		for (Sci_Position position = start; !current.pcs.empty(); position++) {
+			const int ch = (position < end) ? static_cast<unsigned char>(bi.CharAt(position)) : noChar;
+			const int before = program.context[ch];
+			const int after = ContextAt(position + 1, lengthText);
+			generation++;
+			following.Clear();
+			for (size_t thread = 0; thread < current.pcs.size(); thread++) {
+				const Instruction &ins = program.code[current.pcs[thread]];
+				if (ins.op == opMatch) {
+					// Threads after this have lower priority
+					memcpy(tagsFound, &current.tags[thread * slots], sizeof(tags));
+					found = true;
+					break;
+				} else if (program.sets[ins.arg].Contains(ch)) {
+					Add(following, ins.next, &current.tags[thread * slots], position + 1, before, after);
+				}
+			}
+			std::swap(current, following);
+		}
+		return found;
+	}
+};
+
+DFASearch::DFASearch(CharClassify *charClassTable) :
+	charClass(charClassTable), forward(0), reverse(0), cacheForward(0), cacheReverse(0),
+	patternLast(0), lengthLast(0), caseSensitiveLast(false), posixLast(false) {
+	for (int tag = 0; tag < MAXTAG; tag++)
+		pat[tag] = 0;
+	ClearTags();
+	memset(wordLast, 0, sizeof(wordLast));
+}
+
+DFASearch::~DFASearch() {
+	Clear();
+	ClearTags();
+}
+
+void DFASearch::Clear() {
+	delete cacheForward;
+	cacheForward = 0;
+	delete cacheReverse;
+	cacheReverse = 0;
+	delete forward;
+	forward = 0;
+	delete reverse;
+	reverse = 0;
+	delete []patternLast;
+	patternLast = 0;
+	lengthLast = 0;
+}
+
+void DFASearch::ClearTags() {
+	for (int tag = 0; tag < MAXTAG; tag++) {
+		delete []pat[tag];
+		pat[tag] = 0;
+		bopat[tag] = NOTFOUND;
+		eopat[tag] = NOTFOUND;
+	}
+}
+
+const char *DFASearch::Compile(const char *pattern, Sci_Position length, bool caseSensitive, bool posix) {
+	unsigned char word[256];
+	for (int ch = 0; ch < 256; ch++)
+		word[ch] = charClass->IsWord(static_cast<unsigned char>(ch)) ? 1 : 0;
+	if (forward && (length == lengthLast) && (memcmp(pattern, patternLast, length) == 0) &&
+		(caseSensitive == caseSensitiveLast) && (posix == posixLast) &&
+		(memcmp(word, wordLast, sizeof(word)) == 0))
+		return 0;
+	Clear();
+
+	RegexParser parser(pattern, length, caseSensitive, posix, charClass);
+	const int root = parser.Parse();
+	if (parser.error)
+		return parser.error;
+	ByteSet anyByte;
+	anyByte.Invert();
+	parser.sets.push_back(anyByte);
+	const int setAny = static_cast<int>(parser.sets.size()) - 1;
+
+	forward = new DFAProgram();
+	reverse = new DFAProgram();
+	DFAProgram *programs[] = {forward, reverse};
+	for (int direction = 0; direction < 2; direction++) {
+		DFAProgram &program = *programs[direction];
+		program.sets = parser.sets;
+		for (int ch = 0; ch < 256; ch++) {
+			if (ch == '\n')
+				program.context[ch] = ctxLF;
+			else if (ch == '\r')
+				program.context[ch] = ctxCR;
+			else
+				program.context[ch] = word[ch] ? ctxWord : ctxOther;
+		}
+		program.context[noChar] = ctxNone;
+		const int match = program.Add(opMatch, 0, 0, 0);
+		if (direction == 0) {
+			// Whole match is tag 0
+			const int close = program.Add(opSave, match, 0, 1);
+			const int body = parser.Emit(program, root, close, false);
+			program.startAnchored = program.Add(opSave, body, 0, 0);
+			// Preceded by a lazy loop over any byte so the match may start anywhere
+			const int loop = program.Add(opSplit, program.startAnchored, 0, 0);
+			const int skip = program.Add(opByte, loop, 0, setAny);
+			program.code[loop].alt = skip;
+			program.start = loop;
+		} else {
+			program.startAnchored = parser.Emit(program, root, match, true);
+			program.start = program.startAnchored;
+		}
+		if (program.code.size() > maxInstructions) {
+			Clear();
+			return "Regular expression too large";
+		}
+	}
+	cacheForward = new DFACache(*forward, true);
+	cacheReverse = new DFACache(*reverse, false);
+
+	patternLast = new char[length + 1];
+	memcpy(patternLast, pattern, length);
+	lengthLast = length;
+	caseSensitiveLast = caseSensitive;
+	posixLast = posix;
+	memcpy(wordLast, word, sizeof(word));
+	return 0;
+}
+
+int DFASearch::Execute(BlockIndexer &bi, Sci_Position lp, Sci_Position endp) {
+	ClearTags();
+	if (!forward || (lp > endp))
+		return 0;
+	const Sci_Position lengthText = bi.Length();
+
+	// Forward to the end of the leftmost match
+	Sci_Position endMatch = NOTFOUND;
+	int state = cacheForward->Start(forward->context[(lp > 0) ? static_cast<unsigned char>(bi.CharAt(lp - 1)) : noChar]);
+	Sci_Position position = lp;
+	while ((position < endp) && !cacheForward->Dead(state)) {
+		Sci_Position lengthRange = 0;
+		const unsigned char *range = reinterpret_cast<const unsigned char *>(bi.RangeAt(position, &lengthRange));
+		if (lengthRange <= 0)
+			break;
+		if (lengthRange > endp - position)
+			lengthRange = endp - position;
+		for (Sci_Position offset = 0; offset < lengthRange; offset++) {
+			const int transition = cacheForward->Step(state, range[offset], false);
+			if (transition & DFACache::matchedBit)
+				endMatch = position + offset;
+			state = transition >> DFACache::stateShift;
+			if (transition & DFACache::deadBit) {
+				lengthRange = offset + 1;
+				break;
+			}
+		}
+		position += lengthRange;
+	}
+	if ((position == endp) && !cacheForward->Dead(state)) {
+		// A match may end at endp, which depends on the character after it
+		const int ch = (endp < lengthText) ? static_cast<unsigned char>(bi.CharAt(endp)) : noChar;
+		if (cacheForward->Step(state, ch, false) & DFACache::matchedBit)
+			endMatch = endp;
+	}
+	if (endMatch == NOTFOUND)
+		return 0;
+
+	// Backward from there to the furthest start
+	Sci_Position startMatch = NOTFOUND;
+	state = cacheReverse->Start(reverse->context[(endMatch < lengthText) ? static_cast<unsigned char>(bi.CharAt(endMatch)) : noChar]);
+	for (position = endMatch; !cacheReverse->Dead(state); position--) {
+		const int ch = (position > 0) ? static_cast<unsigned char>(bi.CharAt(position - 1)) : noChar;
+		const int transition = cacheReverse->Step(state, ch, true);
+		if (transition & DFACache::matchedBit)
+			startMatch = position;
+		if (position == lp)
+			break;
+		state = transition >> DFACache::stateShift;
+	}
+	if (startMatch == NOTFOUND)
+		return 0;
+	bopat[0] = startMatch;
+	eopat[0] = endMatch;
+	return 1;
+}
+
+bool DFASearch::GrabMatches(BlockIndexer &bi) {
+	if (!forward || (bopat[0] == NOTFOUND))
+		return false;
+	TagMatcher matcher(*forward, bi);
+	Sci_Position tags[MAXTAG * 2];
+	if (!matcher.Match(bopat[0], eopat[0], tags))
+		return false;
+	for (int tag = 0; tag < MAXTAG; tag++) {
+		delete []pat[tag];
+		pat[tag] = 0;
+		bopat[tag] = tags[tag * 2];
+		eopat[tag] = tags[tag * 2 + 1];
+		if ((bopat[tag] != NOTFOUND) && (eopat[tag] != NOTFOUND)) {
+			const Sci_Position len = eopat[tag] - bopat[tag];
+			pat[tag] = new char[len + 1];
+			for (Sci_Position j = 0; j < len; j++)
+				pat[tag][j] = bi.CharAt(bopat[tag] + j);
+			pat[tag][len] = '\0';
+		} else {
+			bopat[tag] = NOTFOUND;
+			eopat[tag] = NOTFOUND;
+		}
+	}
+	return true;
+}
+
+int DFASearch::StatesBuilt() const {
+	return (cacheForward ? cacheForward->built : 0) + (cacheReverse ? cacheReverse->built : 0);
+}
+
+int DFASearch::CacheResets() const {
+	return (cacheForward ? cacheForward->resets : 0) + (cacheReverse ? cacheReverse->resets : 0);
+}
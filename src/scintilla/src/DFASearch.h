@@ -0,0 +1,81 @@
+// Scintilla source code edit control
+/** @file DFASearch.h
+ ** Interface to the linear time regular expression search.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef DFASEARCH_H
+#define DFASEARCH_H
+
+#ifdef SCI_NAMESPACE
+namespace Scintilla {
+#endif
+
+/// Access to the text being searched that can hand out contiguous blocks
+/// so the automaton does not make a virtual call for every byte.
+class BlockIndexer : public CharacterIndexer {
+public:
+	/// Text from position that is contiguous in memory, setting *rangeLength to its length.
+	virtual const char *RangeAt(Sci_Position position, Sci_Position *rangeLength)=0;
+	virtual Sci_Position Length()=0;
+};
+
+class DFAProgram;
+class DFACache;
+
+/**
+ * Regular expression search that takes time proportional to the length of the text.
+ * The pattern is compiled to a non-deterministic automaton from which deterministic
+ * states are built lazily as the text needs them and cached for later searches.
+ * Finding a match is a forward scan for its end then a backward scan for its start.
+ * Tagged sub-expressions are only located when GrabMatches is called.
+ */
+class DFASearch {
+
+public:
+	DFASearch(CharClassify *charClassTable);
+	~DFASearch();
+	const char *Compile(const char *pattern, Sci_Position length, bool caseSensitive, bool posix);
+	/// Find the leftmost match starting at or after lp that ends at or before endp.
+	int Execute(BlockIndexer &bi, Sci_Position lp, Sci_Position endp);
+	/// Locate the tagged sub-expressions of the last match and copy their text.
+	bool GrabMatches(BlockIndexer &bi);
+
+	/// Number of deterministic states built and times the cache was discarded when full.
+	int StatesBuilt() const;
+	int CacheResets() const;
+
+	enum { MAXTAG=10 };
+	enum { NOTFOUND=-1 };
+
+	Sci_Position bopat[MAXTAG];
+	Sci_Position eopat[MAXTAG];
+	char *pat[MAXTAG];
+
+private:
+	void Clear();
+	void ClearTags();
+
+	CharClassify *charClass;
+	DFAProgram *forward;
+	DFAProgram *reverse;
+	DFACache *cacheForward;
+	DFACache *cacheReverse;
+
+	// The compiled pattern is reused while these stay the same
+	char *patternLast;
+	Sci_Position lengthLast;
+	bool caseSensitiveLast;
+	bool posixLast;
+	unsigned char wordLast[256];
+
+	// Private so DFASearch objects can not be copied
+	DFASearch(const DFASearch &);
+	void operator=(const DFASearch &);
+};
+
+#ifdef SCI_NAMESPACE
+}
+#endif
+
+#endif
@@ -27,9 +27,9 @@ class DecorationList {
 	int currentIndicator;
 	int currentValue;
 	Decoration *current;
-	int lengthDocument;
+	Position lengthDocument;
 	Decoration *DecorationFromIndicator(int indicator);
-	Decoration *Create(int indicator, int length);
+	Decoration *Create(int indicator, Position length);
 	void Delete(int indicator);
 	void DeleteAnyEmpty();
 public:
@@ -46,15 +46,15 @@ public:
 	int GetCurrentValue() const { return currentValue; }
 
 	// Returns true if some values may have changed
-	bool FillRange(int &position, int value, int &fillLength);
+	bool FillRange(Position &position, int value, Position &fillLength);
 
-	void InsertSpace(int position, int insertLength);
-	void DeleteRange(int position, int deleteLength);
+	void InsertSpace(Position position, Position insertLength);
+	void DeleteRange(Position position, Position deleteLength);
 
-	int AllOnFor(int position);
-	int ValueAt(int indicator, int position);
-	int Start(int indicator, int position);
-	int End(int indicator, int position);
+	int AllOnFor(Position position);
+	int ValueAt(int indicator, Position position);
+	Position Start(int indicator, Position position);
+	Position End(int indicator, Position position);
 };
 
 #ifdef SCI_NAMESPACE
@@ -13,14 +13,22 @@
 
 #include <string>
 #include <vector>
+#include <deque> //!-add-[BackgroundLexing]
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define FIND_SSE2
+#include <emmintrin.h>
+#endif
 
 #include "Platform.h"
 
 #include "ILexer.h"
 #include "Scintilla.h"
+#include "Position.h"
 
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "CellBuffer.h"
 #include "PerLine.h"
@@ -28,7 +36,9 @@
 #include "CharacterSet.h"
 #include "Decoration.h"
 #include "Document.h"
+#include "BackgroundLexer.h" //!-add-[BackgroundLexing]
 #include "RESearch.h"
+#include "DFASearch.h"
 #include "UniConversion.h"
 
 #ifdef SCI_NAMESPACE
@@ -56,7 +66,7 @@ static inline bool IsUpperCase(char ch) {
 	return isascii(ch) && isupper(ch);
 }
 
-void LexInterface::Colourise(int start, int end) {
+void LexInterface::Colourise(Position start, Position end) {
 	ElapsedTime et;
 	if (pdoc && instance && !performingStyle) {
 		// Protect against reentrance, which may occur, for example, when
@@ -64,10 +74,10 @@ void LexInterface::Colourise(int start, int end) {
 		// code looks for child lines which may trigger styling.
 		performingStyle = true;
 
-		int lengthDoc = pdoc->Length();
+		Position lengthDoc = pdoc->Length();
 		if (end == -1)
 			end = lengthDoc;
-		int len = end - start;
+		Position len = end - start;
 
 		PLATFORM_ASSERT(len >= 0);
 		PLATFORM_ASSERT(start + len <= lengthDoc);
@@ -77,6 +87,7 @@ void LexInterface::Colourise(int start, int end) {
 			styleStart = pdoc->StyleAt(start - 1) & pdoc->stylingBitsMask;
 
 		if (len > 0) {
+			LexingLock lock(background); //!-add-[BackgroundLexing]
 			instance->Lex(start, len, styleStart, pdoc);
 			instance->Fold(start, len, styleStart, pdoc);
 		}
@@ -85,6 +96,82 @@ void LexInterface::Colourise(int start, int end) {
 	}
 }
 
+//!-start-[BackgroundLexing]
+// After the text changes wait this long before lexing in the background again so
+// that typing does not start the thread again for every character.
+static const double restartSeconds = 0.1;
+
+LexInterface::~LexInterface() {
+	delete background;
+}
+
+bool LexInterface::ColouriseBackground() {
+	if (!pdoc || !instance || performingStyle)
+		return false;
+	if (!background)
+		background = new BackgroundLexer();
+	if (background->Running()) {
+		if (background->Published() != pdoc->GetEndStyled()) {
+			// Styled on the window thread. Changes to the text stop the background lexer
+			// so its copy is still current and lexing goes on from the new end of styling.
+			if ((pdoc->GetEndStyled() < pdoc->Length()) && background->Restart(pdoc, pdoc->GetEndStyled()))
+				return true;
+			background->Stop();
+		} else {
+			performingStyle = true;
+			const bool more = background->Publish(pdoc);
+			performingStyle = false;
+			if (more)
+				return true;
+			background->Stop();
+			// Some lexers leave the end unstyled so do not start again until something changes
+			lexedToEnd = true;
+		}
+	}
+	if (lexedToEnd || (pdoc->GetEndStyled() >= pdoc->Length()))
+		return false;
+	if (background->SinceStopped() < restartSeconds)
+		return true;
+	return background->Start(pdoc, instance, pdoc->GetEndStyled());
+}
+
+void LexInterface::ColouriseAhead(Position start, Position end) {
+	if ((start >= aheadStart) && (end <= aheadEnd))
+		return;
+	const Position endStyled = pdoc->GetEndStyled();
+	Colourise(start, end);
+	pdoc->ModifiedAt(endStyled);
+	aheadStart = start;
+	aheadEnd = end;
+}
+
+void LexInterface::StopBackground() {
+	if (background)
+		background->Stop();
+	aheadStart = 0;
+	aheadEnd = 0;
+	lexedToEnd = false;
+}
+
+void LexInterface::TextChanging() {
+	if (background)
+		background->Suspend();
+	aheadStart = 0;
+	aheadEnd = 0;
+	lexedToEnd = false;
+}
+
+void LexInterface::TextChanged(Position position, Position lengthChange, int linesAdded) {
+	if (background)
+		background->TextChanged(pdoc, position, lengthChange, linesAdded);
+}
+
+void LexInterface::Restyled(Position start, Position end) {
+	if (background)
+		background->Styled(start, end);
+}
+//!-end-[BackgroundLexing]
+
 Document::Document() {
 	refCount = 0;
 #ifdef _WIN32
@@ -112,6 +199,7 @@ Document::Document() {
 
 	matchesValid = false;
 	regex = 0;
+	regexDFA = false;
 
 	perLineData[ldMarkers] = new LineMarkers();
 	perLineData[ldLevels] = new LineLevels();
@@ -244,15 +332,15 @@ int Document::LineFromHandle(int markerHandle) {
 	return static_cast<LineMarkers *>(perLineData[ldMarkers])->LineFromHandle(markerHandle);
 }
 
-int SCI_METHOD Document::LineStart(int line) const {
+Position SCI_METHOD Document::LineStart(int line) const {
 	return cb.LineStart(line);
 }
 
-int Document::LineEnd(int line) const {
+Position Document::LineEnd(int line) const {
 	if (line == LinesTotal() - 1) {
 		return LineStart(line + 1);
 	} else {
-		int position = LineStart(line + 1) - 1;
+		Position position = LineStart(line + 1) - 1;
 		// When line terminator is CR+LF, may need to go back one more
 		if ((position > LineStart(line)) && (cb.CharAt(position - 1) == '\r')) {
 			position--;
@@ -268,23 +356,23 @@ void SCI_METHOD Document::SetErrorStatus(int status) {
 	}
 }
 
-int SCI_METHOD Document::LineFromPosition(int pos) const {
+int SCI_METHOD Document::LineFromPosition(Position pos) const {
 	return cb.LineFromPosition(pos);
 }
 
-int Document::LineEndPosition(int position) const {
+Position Document::LineEndPosition(Position position) const {
 	return LineEnd(LineFromPosition(position));
 }
 
-bool Document::IsLineEndPosition(int position) const {
+bool Document::IsLineEndPosition(Position position) const {
 	return LineEnd(LineFromPosition(position)) == position;
 }
 
-int Document::VCHomePosition(int position) const {
+Position Document::VCHomePosition(Position position) const {
 	int line = LineFromPosition(position);
-	int startPosition = LineStart(line);
-	int endLine = LineEnd(line);
-	int startText = startPosition;
+	Position startPosition = LineStart(line);
+	Position endLine = LineEnd(line);
+	Position startText = startPosition;
 	while (startText < endLine && (cb.CharAt(startText) == ' ' || cb.CharAt(startText) == '\t'))
 		startText++;
 	if (position == startText)
@@ -313,12 +401,14 @@ void Document::ClearLevels() {
 	static_cast<LineLevels *>(perLineData[ldLevels])->ClearLevels();
 }
 
-static bool IsSubordinate(int levelStart, int levelTry) {
-	if (levelTry & SC_FOLDLEVELWHITEFLAG)
-		return true;
-	else
-		return (levelStart & SC_FOLDLEVELNUMBERMASK) < (levelTry & SC_FOLDLEVELNUMBERMASK);
-}
+//!-start-[FoldIndex]
+//!static bool IsSubordinate(int levelStart, int levelTry) {
+//!	if (levelTry & SC_FOLDLEVELWHITEFLAG)
+//!		return true;
+//!	else
+//!		return (levelStart & SC_FOLDLEVELNUMBERMASK) < (levelTry & SC_FOLDLEVELNUMBERMASK);
+//!}
+//!-end-[FoldIndex]
 
 int Document::GetLastChild(int lineParent, int level, int lastLine) {
 	if (level == -1)
@@ -326,14 +416,37 @@ int Document::GetLastChild(int lineParent, int level, int lastLine) {
 	int maxLine = LinesTotal();
 	int lookLastLine = (lastLine != -1) ? Platform::Minimum(LinesTotal() - 1, lastLine) : -1;
 	int lineMaxSubord = lineParent;
+//!-start-[FoldIndex]
+//!	while (lineMaxSubord < maxLine - 1) {
+//!		EnsureStyledTo(LineStart(lineMaxSubord + 2));
+//!		if (!IsSubordinate(level, GetLevel(lineMaxSubord + 1)))
+//!			break;
+//!		if ((lookLastLine != -1) && (lineMaxSubord >= lookLastLine) && !(GetLevel(lineMaxSubord) & SC_FOLDLEVELWHITEFLAG))
+//!			break;
+//!		lineMaxSubord++;
+//!	}
+	// Search the fold index for the first line which is not subordinate, over the lines
+	// already styled and then over twice as many lines each time more are styled.
+	// After lookLastLine, the search goes line by line to stop at a line which is not white.
+	LineLevels *lineLevels = static_cast<LineLevels *>(perLineData[ldLevels]);
+	int linesStyle = 1;
 	while (lineMaxSubord < maxLine - 1) {
-		EnsureStyledTo(LineStart(lineMaxSubord + 2));
-		if (!IsSubordinate(level, GetLevel(lineMaxSubord + 1)))
+		int lineEnd = Platform::Maximum(lineMaxSubord + 1 + linesStyle, LineFromPosition(GetEndStyled()));
+		lineEnd = Platform::Minimum(lineEnd, maxLine);
+		if (lookLastLine != -1)
+			lineEnd = Platform::Minimum(lineEnd, Platform::Maximum(lookLastLine, lineMaxSubord + 1) + 1);
+		EnsureStyledTo(LineStart(lineEnd));
+		int lineNotSubordinate = lineLevels->FirstNotAbove(lineMaxSubord + 1, lineEnd, level & SC_FOLDLEVELNUMBERMASK);
+		if (lineNotSubordinate != -1) {
+			lineMaxSubord = lineNotSubordinate - 1;
 			break;
+		}
 		if ((lookLastLine != -1) && (lineMaxSubord >= lookLastLine) && !(GetLevel(lineMaxSubord) & SC_FOLDLEVELWHITEFLAG))
 			break;
-		lineMaxSubord++;
+		lineMaxSubord = lineEnd - 1;
+		linesStyle *= 2;
 	}
+//!-end-[FoldIndex]
 	if (lineMaxSubord > lineParent) {
 		if (level > (GetLevel(lineMaxSubord + 1) & SC_FOLDLEVELNUMBERMASK)) {
 			// Have chewed up some whitespace that belongs to a parent so seek back
@@ -347,19 +460,22 @@ int Document::GetLastChild(int lineParent, int level, int lastLine) {
 
 int Document::GetFoldParent(int line) {
 	int level = GetLevel(line) & SC_FOLDLEVELNUMBERMASK;
-	int lineLook = line - 1;
-	while ((lineLook > 0) && (
-	            (!(GetLevel(lineLook) & SC_FOLDLEVELHEADERFLAG)) ||
-	            ((GetLevel(lineLook) & SC_FOLDLEVELNUMBERMASK) >= level))
-	      ) {
-		lineLook--;
-	}
-	if ((GetLevel(lineLook) & SC_FOLDLEVELHEADERFLAG) &&
-	        ((GetLevel(lineLook) & SC_FOLDLEVELNUMBERMASK) < level)) {
-		return lineLook;
-	} else {
-		return -1;
-	}
+//!-start-[FoldIndex]
+//!	int lineLook = line - 1;
+//!	while ((lineLook > 0) && (
+//!	            (!(GetLevel(lineLook) & SC_FOLDLEVELHEADERFLAG)) ||
+//!	            ((GetLevel(lineLook) & SC_FOLDLEVELNUMBERMASK) >= level))
+//!	      ) {
+//!		lineLook--;
+//!	}
+//!	if ((GetLevel(lineLook) & SC_FOLDLEVELHEADERFLAG) &&
+//!	        ((GetLevel(lineLook) & SC_FOLDLEVELNUMBERMASK) < level)) {
+//!		return lineLook;
+//!	} else {
+//!		return -1;
+//!	}
+	return static_cast<LineLevels *>(perLineData[ldLevels])->LastHeaderBelow(line, level);
+//!-end-[FoldIndex]
 }
 
 void Document::GetHighlightDelimiters(HighlightDelimiter &highlightDelimiter, int line, int lastLine) {
@@ -432,11 +548,11 @@ void Document::GetHighlightDelimiters(HighlightDelimiter &highlightDelimiter, in
 	highlightDelimiter.firstChangeableLineAfter = firstChangeableLineAfter;
 }
 
-int Document::ClampPositionIntoDocument(int pos) {
-	return Platform::Clamp(pos, 0, Length());
+Position Document::ClampPositionIntoDocument(Position pos) {
+	return ClampPosition(pos, 0, Length());
 }
 
-bool Document::IsCrLf(int pos) {
+bool Document::IsCrLf(Position pos) {
 	if (pos < 0)
 		return false;
 	if (pos >= (Length() - 1))
@@ -444,7 +560,7 @@ bool Document::IsCrLf(int pos) {
 	return (cb.CharAt(pos) == '\r') && (cb.CharAt(pos + 1) == '\n');
 }
 
-int Document::LenChar(int pos) {
+int Document::LenChar(Position pos) {
 	if (pos < 0) {
 		return 1;
 	} else if (IsCrLf(pos)) {
@@ -458,9 +574,9 @@ int Document::LenChar(int pos) {
 			len = 4;
 		else if (ch >= (0x80 + 0x40 + 0x20))
 			len = 3;
-		int lengthDoc = Length();
+		Position lengthDoc = Length();
 		if ((pos + len) > lengthDoc)
-			return lengthDoc -pos;
+			return static_cast<int>(lengthDoc -pos);
 		else
 			return len;
 	} else if (dbcsCodePage) {
@@ -488,8 +604,8 @@ static int BytesFromLead(int leadByte) {
 	return 0;
 }
 
-bool Document::InGoodUTF8(int pos, int &start, int &end) const {
-	int lead = pos;
+bool Document::InGoodUTF8(Position pos, Position &start, Position &end) const {
+	Position lead = pos;
 	while ((lead>0) && (pos-lead < 4) && IsTrailByte(static_cast<unsigned char>(cb.CharAt(lead-1))))
 		lead--;
 	start = 0;
@@ -502,12 +618,12 @@ bool Document::InGoodUTF8(int pos, int &start, int &end) const {
 		return false;
 	} else {
 		int trailBytes = bytes - 1;
-		int len = pos - lead + 1;
+		Position len = pos - lead + 1;
 		if (len > trailBytes)
 			// pos too far from lead
 			return false;
 		// Check that there are enough trails for this lead
-		int trail = pos + 1;
+		Position trail = pos + 1;
 		while ((trail-lead<trailBytes) && (trail < Length())) {
 			if (!IsTrailByte(static_cast<unsigned char>(cb.CharAt(trail)))) {
 				return false;
@@ -524,7 +640,7 @@ bool Document::InGoodUTF8(int pos, int &start, int &end) const {
 // When lines are terminated with \r\n pairs which should be treated as one character.
 // When displaying DBCS text such as Japanese.
 // If moving, move the position in the indicated direction.
-int Document::MovePositionOutsideChar(int pos, int moveDir, bool checkLineEnd) {
+Position Document::MovePositionOutsideChar(Position pos, Position moveDir, bool checkLineEnd) {
 	//Platform::DebugPrintf("NoCRLF %d %d\n", pos, moveDir);
 	// If out of range, just return minimum/maximum value.
 	if (pos <= 0)
@@ -543,8 +659,8 @@ int Document::MovePositionOutsideChar(int pos, int moveDir, bool checkLineEnd) {
 	if (dbcsCodePage) {
 		if (SC_CP_UTF8 == dbcsCodePage) {
 			unsigned char ch = static_cast<unsigned char>(cb.CharAt(pos));
-			int startUTF = pos;
-			int endUTF = pos;
+			Position startUTF = pos;
+			Position endUTF = pos;
 			if (IsTrailByte(ch) && InGoodUTF8(pos, startUTF, endUTF)) {
 				// ch is a trail byte within a UTF-8 character
 				if (moveDir > 0)
@@ -555,12 +671,12 @@ int Document::MovePositionOutsideChar(int pos, int moveDir, bool checkLineEnd) {
 		} else {
 			// Anchor DBCS calculations at start of line because start of line can
 			// not be a DBCS trail byte.
-			int posStartLine = LineStart(LineFromPosition(pos));
+			Position posStartLine = LineStart(LineFromPosition(pos));
 			if (pos == posStartLine)
 				return pos;
 
 			// Step back until a non-lead-byte is found.
-			int posCheck = pos;
+			Position posCheck = pos;
 			while ((posCheck > posStartLine) && IsDBCSLeadByte(cb.CharAt(posCheck-1)))
 				posCheck--;
 
@@ -587,7 +703,7 @@ int Document::MovePositionOutsideChar(int pos, int moveDir, bool checkLineEnd) {
 // NextPosition moves between valid positions - it can not handle a position in the middle of a
 // multi-byte character. It is used to iterate through text more efficiently than MovePositionOutsideChar.
 // A \r\n pair is treated as two characters.
-int Document::NextPosition(int pos, int moveDir) const {
+Position Document::NextPosition(Position pos, int moveDir) const {
 	// If out of range, just return minimum/maximum value.
 	int increment = (moveDir > 0) ? 1 : -1;
 	if (pos + increment <= 0)
@@ -599,8 +715,8 @@ int Document::NextPosition(int pos, int moveDir) const {
 		if (SC_CP_UTF8 == dbcsCodePage) {
 			pos += increment;
 			unsigned char ch = static_cast<unsigned char>(cb.CharAt(pos));
-			int startUTF = pos;
-			int endUTF = pos;
+			Position startUTF = pos;
+			Position endUTF = pos;
 			if (IsTrailByte(ch) && InGoodUTF8(pos, startUTF, endUTF)) {
 				// ch is a trail byte within a UTF-8 character
 				if (moveDir > 0)
@@ -617,7 +733,7 @@ int Document::NextPosition(int pos, int moveDir) const {
 			} else {
 				// Anchor DBCS calculations at start of line because start of line can
 				// not be a DBCS trail byte.
-				int posStartLine = LineStart(LineFromPosition(pos));
+				Position posStartLine = LineStart(LineFromPosition(pos));
 				// See http://msdn.microsoft.com/en-us/library/cc194792%28v=MSDN.10%29.aspx
 				// http://msdn.microsoft.com/en-us/library/cc194790.aspx
 				if ((pos - 1) <= posStartLine) {
@@ -627,7 +743,7 @@ int Document::NextPosition(int pos, int moveDir) const {
 					return pos - 2;
 				} else {
 					// Otherwise, step back until a non-lead-byte is found.
-					int posTemp = pos - 1;
+					Position posTemp = pos - 1;
 					while (posStartLine <= --posTemp && IsDBCSLeadByte(cb.CharAt(posTemp)))
 						;
 					// Now posTemp+1 must point to the beginning of a character,
@@ -644,9 +760,9 @@ int Document::NextPosition(int pos, int moveDir) const {
 	return pos;
 }
 
-bool Document::NextCharacter(int &pos, int moveDir) {
+bool Document::NextCharacter(Position &pos, int moveDir) {
 	// Returns true if pos changed
-	int posNext = NextPosition(pos, moveDir);
+	Position posNext = NextPosition(pos, moveDir);
 	if (posNext == pos) {
 		return false;
 	} else {
@@ -736,7 +852,7 @@ int Document::SafeSegment(const char *text, int length, int lengthSegment) {
 	return lastEncodingAllowedBreak;
 }
 
-void Document::ModifiedAt(int pos) {
+void Document::ModifiedAt(Position pos) {
 	if (endStyled > pos)
 		endStyled = pos;
 }
@@ -752,7 +868,7 @@ void Document::CheckReadOnly() {
 // Document only modified by gateways DeleteChars, InsertString, Undo, Redo, and SetStyleAt.
 // SetStyleAt does not change the persistent state of a document
 
-bool Document::DeleteChars(int pos, int len) {
+bool Document::DeleteChars(Position pos, Position len) {
 	if (len == 0)
 		return false;
 	if ((pos + len) > Length())
@@ -792,7 +908,7 @@ bool Document::DeleteChars(int pos, int len) {
 /**
  * Insert a string with a length.
  */
-bool Document::InsertString(int position, const char *s, int insertLength) {
+bool Document::InsertString(Position position, const char *s, Position insertLength) {
 	if (insertLength <= 0) {
 		return false;
 	}
@@ -825,9 +941,9 @@ bool Document::InsertString(int position, const char *s, int insertLength) {
 	return !cb.IsReadOnly();
 }
 
-int SCI_METHOD Document::AddData(char *data, int length) {
+int SCI_METHOD Document::AddData(char *data, Position length) {
 	try {
-		int position = Length();
+		Position position = Length();
 		InsertString(position,data, length);
 	} catch (std::bad_alloc &) {
 		return SC_STATUS_BADALLOC;
@@ -841,8 +957,21 @@ void * SCI_METHOD Document::ConvertToDocument() {
 	return this;
 }
 
-int Document::Undo() {
-	int newPos = -1;
+int SCI_METHOD Document::AddMapped(IMappedText *pText) {
+	try {
+		if (!cb.AdoptMapped(pText))
+			return SC_STATUS_FAILURE;
+		decorations.InsertSpace(0, cb.Length());
+	} catch (std::bad_alloc &) {
+		return SC_STATUS_BADALLOC;
+	} catch (...) {
+		return SC_STATUS_FAILURE;
+	}
+	return 0;
+}
+
+Position Document::Undo() {
+	Position newPos = -1;
 	CheckReadOnly();
 	if (enteredModification == 0) {
 		enteredModification++;
@@ -859,14 +988,14 @@ int Document::Undo() {
 									SC_MOD_BEFOREINSERT | SC_PERFORMED_UNDO, action));
 				} else if (action.at == containerAction) {
 					DocModification dm(SC_MOD_CONTAINER | SC_PERFORMED_UNDO);
-					dm.token = action.position;
+					dm.token = static_cast<int>(action.position);
 					NotifyModified(dm);
 				} else {
 					NotifyModified(DocModification(
 									SC_MOD_BEFOREDELETE | SC_PERFORMED_UNDO, action));
 				}
 				cb.PerformUndoStep();
-				int cellPosition = action.position;
+				Position cellPosition = action.position;
 				if (action.at != containerAction) {
 					ModifiedAt(cellPosition);
 					newPos = cellPosition;
@@ -903,8 +1032,8 @@ int Document::Undo() {
 	return newPos;
 }
 
-int Document::Redo() {
-	int newPos = -1;
+Position Document::Redo() {
+	Position newPos = -1;
 	CheckReadOnly();
 	if (enteredModification == 0) {
 		enteredModification++;
@@ -920,7 +1049,7 @@ int Document::Redo() {
 									SC_MOD_BEFOREINSERT | SC_PERFORMED_REDO, action));
 				} else if (action.at == containerAction) {
 					DocModification dm(SC_MOD_CONTAINER | SC_PERFORMED_REDO);
-					dm.token = action.position;
+					dm.token = static_cast<int>(action.position);
 					NotifyModified(dm);
 				} else {
 					NotifyModified(DocModification(
@@ -966,7 +1095,7 @@ int Document::Redo() {
 /**
  * Insert a single character.
  */
-bool Document::InsertChar(int pos, char ch) {
+bool Document::InsertChar(Position pos, char ch) {
 	char chs[1];
 	chs[0] = ch;
 	return InsertString(pos, chs, 1);
@@ -975,26 +1104,26 @@ bool Document::InsertChar(int pos, char ch) {
 /**
  * Insert a null terminated string.
  */
-bool Document::InsertCString(int position, const char *s) {
+bool Document::InsertCString(Position position, const char *s) {
 	return InsertString(position, s, static_cast<int>(strlen(s)));
 }
 
-void Document::ChangeChar(int pos, char ch) {
+void Document::ChangeChar(Position pos, char ch) {
 	DeleteChars(pos, 1);
 	InsertChar(pos, ch);
 }
 
-void Document::DelChar(int pos) {
+void Document::DelChar(Position pos) {
 	DeleteChars(pos, LenChar(pos));
 }
 
-void Document::DelCharBack(int pos) {
+void Document::DelCharBack(Position pos) {
 	if (pos <= 0) {
 		return;
 	} else if (IsCrLf(pos - 2)) {
 		DeleteChars(pos - 2, 2);
 	} else if (dbcsCodePage) {
-		int startChar = NextPosition(pos, -1);
+		Position startChar = NextPosition(pos, -1);
 		DeleteChars(startChar, pos - startChar);
 	} else {
 		DeleteChars(pos - 1, 1);
@@ -1029,9 +1158,9 @@ static void CreateIndentation(char *linebuf, int length, int indent, int tabSize
 int SCI_METHOD Document::GetLineIndentation(int line) {
 	int indent = 0;
 	if ((line >= 0) && (line < LinesTotal())) {
-		int lineStart = LineStart(line);
-		int length = Length();
-		for (int i = lineStart; i < length; i++) {
+		Position lineStart = LineStart(line);
+		Position length = Length();
+		for (Position i = lineStart; i < length; i++) {
 			char ch = cb.CharAt(i);
 			if (ch == ' ')
 				indent++;
@@ -1051,30 +1180,30 @@ void Document::SetLineIndentation(int line, int indent) {
 	if (indent != indentOfLine) {
 		char linebuf[1000];
 		CreateIndentation(linebuf, sizeof(linebuf), indent, tabInChars, !useTabs);
-		int thisLineStart = LineStart(line);
-		int indentPos = GetLineIndentPosition(line);
+		Position thisLineStart = LineStart(line);
+		Position indentPos = GetLineIndentPosition(line);
 		UndoGroup ug(this);
 		DeleteChars(thisLineStart, indentPos - thisLineStart);
 		InsertCString(thisLineStart, linebuf);
 	}
 }
 
-int Document::GetLineIndentPosition(int line) const {
+Position Document::GetLineIndentPosition(int line) const {
 	if (line < 0)
 		return 0;
-	int pos = LineStart(line);
-	int length = Length();
+	Position pos = LineStart(line);
+	Position length = Length();
 	while ((pos < length) && isindentchar(cb.CharAt(pos))) {
 		pos++;
 	}
 	return pos;
 }
 
-int Document::GetColumn(int pos) {
+int Document::GetColumn(Position pos) {
 	int column = 0;
 	int line = LineFromPosition(pos);
 	if ((line >= 0) && (line < LinesTotal())) {
-		for (int i = LineStart(line); i < pos;) {
+		for (Position i = LineStart(line); i < pos;) {
 			char ch = cb.CharAt(i);
 			if (ch == '\t') {
 				column = NextTab(column, tabInChars);
@@ -1094,11 +1223,11 @@ int Document::GetColumn(int pos) {
 	return column;
 }
 
-int Document::CountCharacters(int startPos, int endPos) {
+Position Document::CountCharacters(Position startPos, Position endPos) {
 	startPos = MovePositionOutsideChar(startPos, 1, false);
 	endPos = MovePositionOutsideChar(endPos, -1, false);
-	int count = 0;
-	int i = startPos;
+	Position count = 0;
+	Position i = startPos;
 	while (i < endPos) {
 		count++;
 		if (IsCrLf(i))
@@ -1108,8 +1237,8 @@ int Document::CountCharacters(int startPos, int endPos) {
 	return count;
 }
 
-int Document::FindColumn(int line, int column) {
-	int position = LineStart(line);
+Position Document::FindColumn(int line, int column) {
+	Position position = LineStart(line);
 	if ((line >= 0) && (line < LinesTotal())) {
 		int columnCurrent = 0;
 		while ((columnCurrent < column) && (position < Length())) {
@@ -1171,14 +1300,14 @@ char *Document::TransformLineEnds(int *pLenOut, const char *s, size_t len, int e
 		}
 	}
 	*dptr++ = '\0';
-	*pLenOut = (dptr - dest) - 1;
+	*pLenOut = static_cast<int>(dptr - dest) - 1;
 	return dest;
 }
 
 void Document::ConvertLineEnds(int eolModeSet) {
 	UndoGroup ug(this);
 
-	for (int pos = 0; pos < Length(); pos++) {
+	for (Position pos = 0; pos < Length(); pos++) {
 		if (cb.CharAt(pos) == '\r') {
 			if (cb.CharAt(pos + 1) == '\n') {
 				// CRLF
@@ -1214,8 +1343,8 @@ void Document::ConvertLineEnds(int eolModeSet) {
 }
 
 bool Document::IsWhiteLine(int line) const {
-	int currentChar = LineStart(line);
-	int endLine = LineEnd(line);
+	Position currentChar = LineStart(line);
+	Position endLine = LineEnd(line);
 	while (currentChar < endLine) {
 		if (cb.CharAt(currentChar) != ' ' && cb.CharAt(currentChar) != '\t') {
 			return false;
@@ -1225,7 +1354,7 @@ bool Document::IsWhiteLine(int line) const {
 	return true;
 }
 
-int Document::ParaUp(int pos) {
+Position Document::ParaUp(Position pos) {
 	int line = LineFromPosition(pos);
 	line--;
 	while (line >= 0 && IsWhiteLine(line)) { // skip empty lines
@@ -1238,7 +1367,7 @@ int Document::ParaUp(int pos) {
 	return LineStart(line);
 }
 
-int Document::ParaDown(int pos) {
+Position Document::ParaDown(Position pos) {
 	int line = LineFromPosition(pos);
 	while (line < LinesTotal() && !IsWhiteLine(line)) { // skip non-empty lines
 		line++;
@@ -1262,7 +1391,7 @@ CharClassify::cc Document::WordCharClass(unsigned char ch) {
  * Used by commmands that want to select whole words.
  * Finds the start of word at pos when delta < 0 or the end of the word when delta >= 0.
  */
-int Document::ExtendWordSelect(int pos, int delta, bool onlyWordCharacters) {
+Position Document::ExtendWordSelect(Position pos, int delta, bool onlyWordCharacters) {
 	CharClassify::cc ccStart = CharClassify::ccWord;
 	if (delta < 0) {
 		if (!onlyWordCharacters)
@@ -1285,7 +1414,7 @@ int Document::ExtendWordSelect(int pos, int delta, bool onlyWordCharacters) {
  * additional movement to transit white space.
  * Used by cursor movement by word commands.
  */
-int Document::NextWordStart(int pos, int delta) {
+Position Document::NextWordStart(Position pos, int delta) {
 	if (delta < 0) {
 		while (pos > 0 && (WordCharClass(cb.CharAt(pos - 1)) == CharClassify::ccSpace))
 			pos--;
@@ -1312,7 +1441,7 @@ int Document::NextWordStart(int pos, int delta) {
  * additional movement to transit white space.
  * Used by cursor movement by word commands.
  */
-int Document::NextWordEnd(int pos, int delta) {
+Position Document::NextWordEnd(Position pos, int delta) {
 	if (delta < 0) {
 		if (pos > 0) {
 			CharClassify::cc ccStart = WordCharClass(cb.CharAt(pos-1));
@@ -1343,7 +1472,7 @@ int Document::NextWordEnd(int pos, int delta) {
  * Check that the character at the given position is a word or punctuation character and that
  * the previous character is of a different character class.
  */
-bool Document::IsWordStartAt(int pos) {
+bool Document::IsWordStartAt(Position pos) {
 	if (pos > 0) {
 		CharClassify::cc ccPos = WordCharClass(CharAt(pos));
 		return (ccPos == CharClassify::ccWord || ccPos == CharClassify::ccPunctuation) &&
@@ -1356,7 +1485,7 @@ bool Document::IsWordStartAt(int pos) {
  * Check that the character at the given position is a word or punctuation character and that
  * the next character is of a different character class.
  */
-bool Document::IsWordEndAt(int pos) {
+bool Document::IsWordEndAt(Position pos) {
 	if (pos < Length()) {
 		CharClassify::cc ccPrev = WordCharClass(CharAt(pos-1));
 		return (ccPrev == CharClassify::ccWord || ccPrev == CharClassify::ccPunctuation) &&
@@ -1369,7 +1498,7 @@ bool Document::IsWordEndAt(int pos) {
  * Check that the given range is has transitions between character classes at both
  * ends and where the characters on the inside are word or punctuation characters.
  */
-bool Document::IsWordAt(int start, int end) {
+bool Document::IsWordAt(Position start, Position end) {
 	return IsWordStartAt(start) && IsWordEndAt(end);
 }
 
@@ -1384,7 +1513,7 @@ static bool GoodTrailByte(int v) {
 	return (v >= 0x80) && (v < 0xc0);
 }
 
-size_t Document::ExtractChar(int pos, char *bytes) {
+size_t Document::ExtractChar(Position pos, char *bytes) {
 	unsigned char ch = static_cast<unsigned char>(cb.CharAt(pos));
 	size_t widthChar = UTF8CharLength(ch);
 	bytes[0] = ch;
@@ -1431,26 +1560,143 @@ void CaseFolderTable::StandardASCII() {
 	}
 }
 
-bool Document::MatchesWordOptions(bool word, bool wordStart, int pos, int length) {
+bool Document::MatchesWordOptions(bool word, bool wordStart, Position pos, Position length) {
 	return (!word && !wordStart) ||
 			(word && IsWordAt(pos, pos + length)) ||
 			(wordStart && IsWordStartAt(pos));
 }
 
+/**
+ * Bytes that may start a match: at position p, the byte at p must be one of first[]
+ * and the byte at p + offsetLast one of last[]. With high set, any byte >= 0x80 at p
+ * is also accepted as it may be part of a character that folds to first[].
+ */
+struct SearchFilter {
+	unsigned char first[2];
+	unsigned char last[2];
+	Position offsetLast;
+	bool high;
+	SearchFilter(unsigned char first0, unsigned char first1, unsigned char last0, unsigned char last1,
+		Position offsetLast_, bool high_) : offsetLast(offsetLast_), high(high_) {
+		first[0] = first0;
+		first[1] = first1;
+		last[0] = last0;
+		last[1] = last1;
+	}
+	bool Matches(unsigned char chFirst, unsigned char chLast) const {
+		return ((chFirst == first[0]) || (chFirst == first[1]) || (high && (chFirst >= 0x80))) &&
+			((chLast == last[0]) || (chLast == last[1]) || (high && (chLast >= 0x80)));
+	}
+};
+
+/**
+ * Find the first of the starts [0, lengthStarts) of contiguous text that passes filter.
+ * The text must extend filter.offsetLast bytes past the last start.
+ * @return the index found or lengthStarts.
+ */
+static Position ScanFilter(const char *text, Position lengthStarts, const SearchFilter &filter) {
+	const unsigned char *data = reinterpret_cast<const unsigned char *>(text);
+	Position i = 0;
+#ifdef FIND_SSE2
+	// Test 16 starts at once by comparing the first and last bytes of each
+	const __m128i first0 = _mm_set1_epi8(static_cast<char>(filter.first[0]));
+	const __m128i first1 = _mm_set1_epi8(static_cast<char>(filter.first[1]));
+	const __m128i last0 = _mm_set1_epi8(static_cast<char>(filter.last[0]));
+	const __m128i last1 = _mm_set1_epi8(static_cast<char>(filter.last[1]));
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= lengthStarts; i += 16) {
+		const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+		const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + filter.offsetLast));
+		__m128i matchFirst = _mm_or_si128(_mm_cmpeq_epi8(blockFirst, first0), _mm_cmpeq_epi8(blockFirst, first1));
+		__m128i matchLast = _mm_or_si128(_mm_cmpeq_epi8(blockLast, last0), _mm_cmpeq_epi8(blockLast, last1));
+		if (filter.high) {
+			// Bytes >= 0x80 are negative as signed bytes
+			matchFirst = _mm_or_si128(matchFirst, _mm_cmplt_epi8(blockFirst, zero));
+			matchLast = _mm_or_si128(matchLast, _mm_cmplt_epi8(blockLast, zero));
+		}
+		int mask = _mm_movemask_epi8(_mm_and_si128(matchFirst, matchLast));
+		if (mask) {
+			Position bit = 0;
+			while (!(mask & 1)) {
+				mask >>= 1;
+				bit++;
+			}
+			return i + bit;
+		}
+	}
+#else
+	if ((filter.first[0] == filter.first[1]) && !filter.high) {
+		// memchr is usually vectorised by the C library
+		while (i < lengthStarts) {
+			const void *found = memchr(data + i, filter.first[0], lengthStarts - i);
+			if (!found)
+				return lengthStarts;
+			i = static_cast<const unsigned char *>(found) - data;
+			if ((data[i + filter.offsetLast] == filter.last[0]) || (data[i + filter.offsetLast] == filter.last[1]))
+				return i;
+			i++;
+		}
+		return lengthStarts;
+	}
+#endif
+	for (; i < lengthStarts; i++) {
+		if (filter.Matches(data[i], data[i + filter.offsetLast]))
+			return i;
+	}
+	return lengthStarts;
+}
+
+/**
+ * Move forward from pos to the first position before endSearch that passes filter,
+ * scanning the contiguous ranges of the buffer directly.
+ * @return the position found or endSearch.
+ */
+static Position NextCandidate(const CellBuffer &cb, Position pos, Position endSearch, const SearchFilter &filter) {
+	while (pos < endSearch) {
+		Position lengthRange = 0;
+		const char *range = cb.RangeAt(pos, &lengthRange);
+		if (lengthRange <= 0)
+			break;
+		const Position posRangeEnd = MinPosition(pos + lengthRange, endSearch);
+		// Starts where both tested bytes lie inside this range
+		const Position lengthStarts = MinPosition(lengthRange - filter.offsetLast, endSearch - pos);
+		if (lengthStarts > 0) {
+			const Position offset = ScanFilter(range, lengthStarts, filter);
+			if (offset < lengthStarts)
+				return pos + offset;
+			pos += lengthStarts;
+		}
+		// Starts where the last byte is in the next range
+		for (; pos < posRangeEnd; pos++) {
+			if (filter.Matches(cb.CharAt(pos), cb.CharAt(pos + filter.offsetLast)))
+				return pos;
+		}
+	}
+	return endSearch;
+}
+
 /**
  * Find text in document, supporting both forward and backward
  * searches (just pass minPos > maxPos to do a backward search)
  * Has not been tested with backwards DBCS searches yet.
+ * Forward searches skip over text that can not start a match with NextCandidate.
  */
-long Document::FindText(int minPos, int maxPos, const char *search,
+Position Document::FindText(Position minPos, Position maxPos, const char *search,
                         bool caseSensitive, bool word, bool wordStart, bool regExp, int flags,
-                        int *length, CaseFolder *pcf) {
+                        Position *length, CaseFolder *pcf) {
 	if ((minPos == maxPos) && (minPos == Length())) return -1; //!-add-[FixFind]
 	if (*length <= 0)
 		return minPos;
 	if (regExp) {
-		if (!regex)
-			regex = CreateRegexSearch(&charClass);
+		const bool dfa = (flags & SCFIND_DFAREGEX) != 0;
+		if (regex && (regexDFA != dfa)) {
+			delete regex;
+			regex = 0;
+		}
+		if (!regex) {
+			regex = dfa ? CreateDFARegexSearch(&charClass) : CreateRegexSearch(&charClass);
+			regexDFA = dfa;
+		}
 		return regex->FindText(this, minPos, maxPos, search, caseSensitive, word, wordStart, flags, length);
 	} else {
 
@@ -1458,24 +1704,36 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 		const int increment = forward ? 1 : -1;
 
 		// Range endpoints should not be inside DBCS characters, but just in case, move them.
-		const int startPos = MovePositionOutsideChar(minPos, increment, false);
-		const int endPos = MovePositionOutsideChar(maxPos, increment, false);
+		const Position startPos = MovePositionOutsideChar(minPos, increment, false);
+		const Position endPos = MovePositionOutsideChar(maxPos, increment, false);
 
 		// Compute actual search ranges needed
-		const int lengthFind = *length;
+		const Position lengthFind = *length;
 
 		//Platform::DebugPrintf("Find %d %d %s %d\n", startPos, endPos, ft->lpstrText, lengthFind);
-		const int limitPos = Platform::Maximum(startPos, endPos);
-		int pos = startPos;
+		const Position limitPos = MaxPosition(startPos, endPos);
+		Position pos = startPos;
 		if (!forward) {
 			// Back all of a character
 			pos = NextPosition(pos, increment);
 		}
 		if (caseSensitive) {
-			const int endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
+			const Position endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
+			const unsigned char chFirst = static_cast<unsigned char>(search[0]);
+			const unsigned char chLast = static_cast<unsigned char>(search[lengthFind - 1]);
+			const SearchFilter filter(chFirst, chFirst, chLast, chLast, lengthFind - 1, false);
+			// Only positions on character boundaries may match: in UTF-8 those are all bytes other
+			// than trail bytes but DBCS trail bytes can not be told apart from single bytes.
+			const bool useFilter = forward &&
+				((dbcsCodePage == 0) || ((SC_CP_UTF8 == dbcsCodePage) && !GoodTrailByte(chFirst)));
 			while (forward ? (pos < endSearch) : (pos >= endSearch)) {
+				if (useFilter) {
+					pos = NextCandidate(cb, pos, endSearch, filter);
+					if (pos >= endSearch)
+						break;
+				}
 				bool found = (pos + lengthFind) <= limitPos;
-				for (int indexSearch = 0; (indexSearch < lengthFind) && found; indexSearch++) {
+				for (Position indexSearch = 0; (indexSearch < lengthFind) && found; indexSearch++) {
 					found = CharAt(pos + indexSearch) == search[indexSearch];
 				}
 				if (found && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
@@ -1490,9 +1748,36 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 			std::vector<char> searchThing(lengthFind * maxBytesCharacter * maxFoldingExpansion + 1);
 			const int lenSearch = static_cast<int>(
 				pcf->Fold(&searchThing[0], searchThing.size(), search, lengthFind));
+			// When the folded search starts with an ASCII character, a match starts with one of
+			// the ASCII bytes that fold to it or with a non-ASCII character.
+			unsigned char asciiFirst[2] = {0, 0};
+			int countFirst = 0;
+			if (static_cast<unsigned char>(searchThing[0]) < 0x80) {
+				for (int ch = 1; ch < 0x80; ch++) {
+					char mixed = static_cast<char>(ch);
+					char folded[maxFoldingExpansion + 1];
+					if ((pcf->Fold(folded, sizeof(folded), &mixed, 1) == 1) && (folded[0] == searchThing[0])) {
+						if (countFirst < 2)
+							asciiFirst[countFirst] = static_cast<unsigned char>(ch);
+						countFirst++;
+					}
+				}
+			}
+			const bool useFilter = forward && (countFirst > 0) && (countFirst <= 2);
+			const SearchFilter filter(asciiFirst[0], asciiFirst[(countFirst > 1) ? 1 : 0],
+				asciiFirst[0], asciiFirst[(countFirst > 1) ? 1 : 0], 0, true);
 			while (forward ? (pos < endPos) : (pos >= endPos)) {
+				if (useFilter) {
+					pos = NextCandidate(cb, pos, endPos, filter);
+					if (pos >= endPos)
+						break;
+					if (GoodTrailByte(static_cast<unsigned char>(cb.CharAt(pos)))) {
+						pos++;
+						continue;
+					}
+				}
 				int widthFirstCharacter = 0;
-				int indexDocument = 0;
+				Position indexDocument = 0;
 				int indexSearch = 0;
 				bool characterMatches = true;
 				while (characterMatches &&
@@ -1533,7 +1818,7 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 			const int lenSearch = static_cast<int>(
 				pcf->Fold(&searchThing[0], searchThing.size(), search, lengthFind));
 			while (forward ? (pos < endPos) : (pos >= endPos)) {
-				int indexDocument = 0;
+				Position indexDocument = 0;
 				int indexSearch = 0;
 				bool characterMatches = true;
 				while (characterMatches &&
@@ -1564,16 +1849,47 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 					break;
 			}
 		} else {
-			const int endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
+			const Position endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
 			std::vector<char> searchThing(lengthFind + 1);
 			pcf->Fold(&searchThing[0], searchThing.size(), search, lengthFind);
+			// Single byte folding is a table so fold every byte once rather than each time it is compared
+			char foldTable[256];
+			for (int ch = 0; ch < 256; ch++) {
+				char mixed = static_cast<char>(ch);
+				char folded[2];
+				pcf->Fold(folded, sizeof(folded), &mixed, 1);
+				foldTable[ch] = folded[0];
+			}
+			// Filter on the first and last bytes when each is folded from no more than 2 bytes
+			unsigned char bytesFirst[2] = {0, 0};
+			unsigned char bytesLast[2] = {0, 0};
+			int countFirst = 0;
+			int countLast = 0;
+			for (int ch = 0; ch < 256; ch++) {
+				if (foldTable[ch] == searchThing[0]) {
+					if (countFirst < 2)
+						bytesFirst[countFirst] = static_cast<unsigned char>(ch);
+					countFirst++;
+				}
+				if (foldTable[ch] == searchThing[lengthFind - 1]) {
+					if (countLast < 2)
+						bytesLast[countLast] = static_cast<unsigned char>(ch);
+					countLast++;
+				}
+			}
+			const bool useFilter = forward && (countFirst > 0) && (countFirst <= 2) &&
+				(countLast > 0) && (countLast <= 2);
+			const SearchFilter filter(bytesFirst[0], bytesFirst[(countFirst > 1) ? 1 : 0],
+				bytesLast[0], bytesLast[(countLast > 1) ? 1 : 0], lengthFind - 1, false);
 			while (forward ? (pos < endSearch) : (pos >= endSearch)) {
+				if (useFilter) {
+					pos = NextCandidate(cb, pos, endSearch, filter);
+					if (pos >= endSearch)
+						break;
+				}
 				bool found = (pos + lengthFind) <= limitPos;
-				for (int indexSearch = 0; (indexSearch < lengthFind) && found; indexSearch++) {
-					char ch = CharAt(pos + indexSearch);
-					char folded[2];
-					pcf->Fold(folded, sizeof(folded), &ch, 1);
-					found = folded[0] == searchThing[indexSearch];
+				for (Position indexSearch = 0; (indexSearch < lengthFind) && found; indexSearch++) {
+					found = foldTable[static_cast<unsigned char>(cb.CharAt(pos + indexSearch))] == searchThing[indexSearch];
 				}
 				if (found && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
 					return pos;
@@ -1587,19 +1903,129 @@ long Document::FindText(int minPos, int maxPos, const char *search,
 	return -1;
 }
 
-const char *Document::SubstituteByPosition(const char *text, int *length) {
+const char *Document::SubstituteByPosition(const char *text, Position *length) {
 	if (regex)
 		return regex->SubstituteByPosition(this, text, length);
 	else
 		return 0;
 }
 
+// Rebuilding the text between the matches is only worthwhile when it is mostly matches
+static const int rebuildSpanRatio = 2;
+
+/**
+ * Replace every match of search in the range [minPos, maxPos) inside one undo action.
+ * Matches are found in the unmodified text then each is replaced on its own, or when they
+ * make up most of the span from the first match to the end of the last match, that span
+ * is rebuilt once and swapped in.
+ * Empty matches advance by a character, moving past a line end as well.
+ * @return the number of replacements with *replaced set to the span after replacement.
+ */
+int Document::ReplaceAll(Position minPos, Position maxPos, const char *search, Position lengthSearch,
+	const char *replace, Position lengthReplace, bool caseSensitive, bool word, bool wordStart,
+	bool regExp, int flags, CaseFolder *pcf, Range *replaced) {
+	if ((lengthSearch <= 0) || (minPos >= maxPos) || cb.IsReadOnly())
+		return 0;
+	// Pairs of match start and length
+	std::vector<Position> matches;
+	// Regular expression replacements depend on each match so are kept as found
+	std::string substitutions;
+	std::vector<Position> lengthSubstitutions;
+	Position pos = minPos;
+	while (pos < maxPos) {
+		Position lengthFound = lengthSearch;
+		const Position posFound = FindText(pos, maxPos, search, caseSensitive, word, wordStart,
+			regExp, flags, &lengthFound, pcf);
+		if (posFound < 0)
+			break;
+		matches.push_back(posFound);
+		matches.push_back(lengthFound);
+		if (regExp) {
+			Position lengthSubstituted = lengthReplace;
+			const char *substituted = SubstituteByPosition(replace, &lengthSubstituted);
+			if (!substituted)
+				return 0;
+			substitutions.append(substituted, lengthSubstituted);
+			lengthSubstitutions.push_back(lengthSubstituted);
+		}
+		pos = posFound + lengthFound;
+		if (lengthFound == 0) {
+			const char chNext = CharAt(pos);
+			if ((chNext == '\r') || (chNext == '\n'))
+				pos++;
+			pos = MovePositionOutsideChar(pos + 1, 1, true);
+		}
+	}
+	const int replacements = static_cast<int>(matches.size() / 2);
+	if (replacements == 0)
+		return 0;
+
+	const Position spanStart = matches[0];
+	const Position spanEnd = matches[matches.size() - 2] + matches[matches.size() - 1];
+	Position lengthMatched = 0;
+	Position lengthResult = spanEnd - spanStart;
+	for (int i = 0; i < replacements; i++) {
+		lengthMatched += matches[i * 2 + 1];
+		lengthResult -= matches[i * 2 + 1];
+		lengthResult += regExp ? lengthSubstitutions[i] : lengthReplace;
+	}
+	*replaced = Range(spanStart, spanStart + lengthResult);
+
+	if ((spanEnd - spanStart) > rebuildSpanRatio * lengthMatched) {
+		UndoGroup ug(this);
+		// From the last match back so the earlier matches stay where they were found
+		Position posSubstitution = static_cast<Position>(substitutions.length());
+		for (int i = replacements - 1; i >= 0; i--) {
+			const Position posMatch = matches[i * 2];
+			const Position lengthMatch = matches[i * 2 + 1];
+			const char *text = replace;
+			Position lengthText = lengthReplace;
+			if (regExp) {
+				lengthText = lengthSubstitutions[i];
+				posSubstitution -= lengthText;
+				text = substitutions.c_str() + posSubstitution;
+			}
+			if (lengthMatch > 0)
+				DeleteChars(posMatch, lengthMatch);
+			if (lengthText > 0)
+				InsertString(posMatch, text, lengthText);
+		}
+		return replacements;
+	}
+
+	// Build the new text for the span in one allocation
+	std::vector<char> result(lengthResult + 1);
+	Position posResult = 0;
+	Position posSubstitution = 0;
+	Position posCopied = spanStart;
+	for (int i = 0; i < replacements; i++) {
+		const Position posMatch = matches[i * 2];
+		GetCharRange(&result[posResult], posCopied, posMatch - posCopied);
+		posResult += posMatch - posCopied;
+		if (regExp) {
+			memcpy(&result[posResult], substitutions.c_str() + posSubstitution, lengthSubstitutions[i]);
+			posResult += lengthSubstitutions[i];
+			posSubstitution += lengthSubstitutions[i];
+		} else {
+			memcpy(&result[posResult], replace, lengthReplace);
+			posResult += lengthReplace;
+		}
+		posCopied = posMatch + matches[i * 2 + 1];
+	}
+	PLATFORM_ASSERT(posResult == lengthResult);
+
+	UndoGroup ug(this);
+	DeleteChars(spanStart, spanEnd - spanStart);
+	InsertString(spanStart, &result[0], lengthResult);
+	return replacements;
+}
+
 int Document::LinesTotal() const {
 	return cb.Lines();
 }
 
 void Document::ChangeCase(Range r, bool makeUpperCase) {
-	for (int pos = r.start; pos < r.end;) {
+	for (Position pos = r.start; pos < r.end;) {
 		int len = LenChar(pos);
 		if (len == 1) {
 			char ch = CharAt(pos);
@@ -1630,18 +2056,18 @@ void Document::SetStylingBits(int bits) {
 	stylingBitsMask = (1 << stylingBits) - 1;
 }
 
-void SCI_METHOD Document::StartStyling(int position, char mask) {
+void SCI_METHOD Document::StartStyling(Position position, char mask) {
 	stylingMask = mask;
 	endStyled = position;
 }
 
-bool SCI_METHOD Document::SetStyleFor(int length, char style) {
+bool SCI_METHOD Document::SetStyleFor(Position length, char style) {
 	if (enteredStyling != 0) {
 		return false;
 	} else {
 		enteredStyling++;
 		style &= stylingMask;
-		int prevEndStyled = endStyled;
+		Position prevEndStyled = endStyled;
 		if (cb.SetStyleFor(endStyled, length, style, stylingMask)) {
 			DocModification mh(SC_MOD_CHANGESTYLE | SC_PERFORMED_USER,
 			                   prevEndStyled, length);
@@ -1653,15 +2079,15 @@ bool SCI_METHOD Document::SetStyleFor(int length, char style) {
 	}
 }
 
-bool SCI_METHOD Document::SetStyles(int length, const char *styles) {
+bool SCI_METHOD Document::SetStyles(Position length, const char *styles) {
 	if (enteredStyling != 0) {
 		return false;
 	} else {
 		enteredStyling++;
 		bool didChange = false;
-		int startMod = 0;
-		int endMod = 0;
-		for (int iPos = 0; iPos < length; iPos++, endStyled++) {
+		Position startMod = 0;
+		Position endMod = 0;
+		for (Position iPos = 0; iPos < length; iPos++, endStyled++) {
 			PLATFORM_ASSERT(endStyled < Length());
 			if (cb.SetStyleAt(endStyled, styles[iPos], stylingMask)) {
 				if (!didChange) {
@@ -1681,12 +2107,12 @@ bool SCI_METHOD Document::SetStyles(int length, const char *styles) {
 	}
 }
 
-void Document::EnsureStyledTo(int pos) {
+void Document::EnsureStyledTo(Position pos) {
 	if ((enteredStyling == 0) && (pos > GetEndStyled())) {
 		IncrementStyleClock();
 		if (pli && !pli->UseContainerLexing()) {
 			int lineEndStyled = LineFromPosition(GetEndStyled());
-			int endStyledTo = LineStart(lineEndStyled);
+			Position endStyledTo = LineStart(lineEndStyled);
 			pli->Colourise(endStyledTo, pos);
 		} else {
 			// Ask the watchers to style, and stop as soon as one responds.
@@ -1721,7 +2147,7 @@ int Document::GetMaxLineState() {
 	return static_cast<LineState *>(perLineData[ldState])->GetMaxLineState();
 }
 
-void SCI_METHOD Document::ChangeLexerState(int start, int end) {
+void SCI_METHOD Document::ChangeLexerState(Position start, Position end) {
 	DocModification mh(SC_MOD_LEXERSTATE, start, end-start, 0, 0, 0);
 	NotifyModified(mh);
 }
@@ -1807,7 +2233,7 @@ void Document::IncrementStyleClock() {
 	styleClock = (styleClock + 1) % 0x100000;
 }
 
-void SCI_METHOD Document::DecorationFillRange(int position, int value, int fillLength) {
+void SCI_METHOD Document::DecorationFillRange(Position position, int value, Position fillLength) {
 	if (decorations.FillRange(position, value, fillLength)) {
 		DocModification mh(SC_MOD_CHANGEINDICATOR | SC_PERFORMED_USER,
 							position, fillLength);
@@ -1868,6 +2294,19 @@ void Document::NotifySavePoint(bool atSavePoint) {
 }
 
 void Document::NotifyModified(DocModification mh) {
+//!-start-[BackgroundLexing]
+	if (pli && (mh.modificationType & (SC_MOD_BEFOREINSERT | SC_MOD_BEFOREDELETE))) {
+		// The background lexer's copy has to be updated with the change
+		pli->TextChanging();
+	} else if (pli && (mh.modificationType & SC_MOD_INSERTTEXT)) {
+		pli->TextChanged(mh.position, mh.length, mh.linesAdded);
+	} else if (pli && (mh.modificationType & SC_MOD_DELETETEXT)) {
+		pli->TextChanged(mh.position, -mh.length, mh.linesAdded);
+	} else if (pli && (mh.modificationType & (SC_MOD_CHANGESTYLE | SC_MOD_CHANGEFOLD | SC_MOD_CHANGELINESTATE))) {
+		// Lexing on the window thread may back up before where it was asked to start
+		pli->Restyled(mh.position, mh.position + ((mh.length > 0) ? mh.length : 1));
+	}
+//!-end-[BackgroundLexing]
 	if (mh.modificationType & SC_MOD_INSERTTEXT) {
 		decorations.InsertSpace(mh.position, mh.length);
 	} else if (mh.modificationType & SC_MOD_DELETETEXT) {
@@ -1882,7 +2321,7 @@ bool Document::IsWordPartSeparator(char ch) {
 	return (WordCharClass(ch) == CharClassify::ccWord) && IsPunctuation(ch);
 }
 
-int Document::WordPartLeft(int pos) {
+Position Document::WordPartLeft(Position pos) {
 	if (pos > 0) {
 		--pos;
 		char startChar = cb.CharAt(pos);
@@ -1932,9 +2371,9 @@ int Document::WordPartLeft(int pos) {
 	return pos;
 }
 
-int Document::WordPartRight(int pos) {
+Position Document::WordPartRight(Position pos) {
 	char startChar = cb.CharAt(pos);
-	int length = Length();
+	Position length = Length();
 	if (IsWordPartSeparator(startChar)) {
 		while (pos < length && IsWordPartSeparator(cb.CharAt(pos)))
 			++pos;
@@ -1976,7 +2415,7 @@ bool IsLineEndChar(char c) {
 	return (c == '\n' || c == '\r');
 }
 
-int Document::ExtendStyleRange(int pos, int delta, bool singleLine) {
+Position Document::ExtendStyleRange(Position pos, int delta, bool singleLine) {
 	int sStart = cb.StyleAt(pos);
 	if (delta < 0) {
 		while (pos > 0 && (cb.StyleAt(pos) == sStart) && (!singleLine || !IsLineEndChar(cb.CharAt(pos))))
@@ -2013,7 +2452,7 @@ static char BraceOpposite(char ch) {
 }
 
 // TODO: should be able to extend styled region to find matching brace
-int Document::BraceMatch(int position, int /*maxReStyle*/) {
+Position Document::BraceMatch(Position position, Position /*maxReStyle*/) {
 	char chBrace = CharAt(position);
 	char chSeek = BraceOpposite(chBrace);
 	if (chSeek == '\0')
@@ -2035,7 +2474,7 @@ int Document::BraceMatch(int position, int /*maxReStyle*/) {
 			if (depth == 0)
 				return position;
 		}
-		int positionBeforeMove = position;
+		Position positionBeforeMove = position;
 		position = NextPosition(position, direction);
 		if (position == positionBeforeMove)
 			break;
@@ -2043,6 +2482,90 @@ int Document::BraceMatch(int position, int /*maxReStyle*/) {
 	return - 1;
 }
 
+/**
+ * Expand the escapes and tag references (\1 to \9) in text using the tags of the last match.
+ * @return a new string which the caller deletes, with *length set to its length.
+ */
+static char *SubstituteTags(const char *text, Position *length,
+	const Position *bopat, const Position *eopat, char *const *pat) {
+	Position lenResult = 0;
+	for (Position i = 0; i < *length; i++) {
+		if (text[i] == '\\') {
+			if (text[i + 1] >= '1' && text[i + 1] <= '9') {
+				unsigned int patNum = text[i + 1] - '0';
+				lenResult += eopat[patNum] - bopat[patNum];
+				i++;
+			} else {
+				switch (text[i + 1]) {
+				case 'a':
+				case 'b':
+				case 'f':
+				case 'n':
+				case 'r':
+				case 't':
+				case 'v':
+				case '\\':
+					i++;
+				}
+				lenResult++;
+			}
+		} else {
+			lenResult++;
+		}
+	}
+	char *substituted = new char[lenResult + 1];
+	char *o = substituted;
+	for (Position j = 0; j < *length; j++) {
+		if (text[j] == '\\') {
+			if (text[j + 1] >= '1' && text[j + 1] <= '9') {
+				unsigned int patNum = text[j + 1] - '0';
+				Position len = eopat[patNum] - bopat[patNum];
+				if (pat[patNum])	// Will be null if try for a match that did not occur
+					memcpy(o, pat[patNum], len);
+				o += len;
+				j++;
+			} else {
+				j++;
+				switch (text[j]) {
+				case 'a':
+					*o++ = '\a';
+					break;
+				case 'b':
+					*o++ = '\b';
+					break;
+				case 'f':
+					*o++ = '\f';
+					break;
+				case 'n':
+					*o++ = '\n';
+					break;
+				case 'r':
+					*o++ = '\r';
+					break;
+				case 't':
+					*o++ = '\t';
+					break;
+				case 'v':
+					*o++ = '\v';
+					break;
+				case '\\':
+					*o++ = '\\';
+					break;
+				default:
+					*o++ = '\\';
+					j--;
+				}
+			}
+		} else {
+			*o++ = text[j];
+		}
+	}
+	*o = '\0';
+	*length = lenResult;
+	return substituted;
+}
+
+
 /**
  * Implementation of RegexSearchBase for the default built-in regular expression engine
  */
@@ -2054,11 +2577,11 @@ public:
 		delete substituted;
 	}
 
-	virtual long FindText(Document *doc, int minPos, int maxPos, const char *s,
+	virtual Position FindText(Document *doc, Position minPos, Position maxPos, const char *s,
                         bool caseSensitive, bool word, bool wordStart, int flags,
-                        int *length);
+                        Position *length);
 
-	virtual const char *SubstituteByPosition(Document *doc, const char *text, int *length);
+	virtual const char *SubstituteByPosition(Document *doc, const char *text, Position *length);
 
 private:
 	RESearch search;
@@ -2068,16 +2591,16 @@ private:
 // Define a way for the Regular Expression code to access the document
 class DocumentIndexer : public CharacterIndexer {
 	Document *pdoc;
-	int end;
+	Position end;
 public:
-	DocumentIndexer(Document *pdoc_, int end_) :
+	DocumentIndexer(Document *pdoc_, Position end_) :
 		pdoc(pdoc_), end(end_) {
 	}
 
 	virtual ~DocumentIndexer() {
 	}
 
-	virtual char CharAt(int index) {
+	virtual char CharAt(Position index) {
 		if (index < 0 || index >= end)
 			return 0;
 		else
@@ -2085,20 +2608,20 @@ public:
 	}
 };
 
-long BuiltinRegex::FindText(Document *doc, int minPos, int maxPos, const char *s,
+Position BuiltinRegex::FindText(Document *doc, Position minPos, Position maxPos, const char *s,
                         bool caseSensitive, bool, bool, int flags,
-                        int *length) {
+                        Position *length) {
 	bool posix = (flags & SCFIND_POSIX) != 0;
 	int increment = (minPos <= maxPos) ? 1 : -1;
 
-	int startPos = minPos;
-	int endPos = maxPos;
+	Position startPos = minPos;
+	Position endPos = maxPos;
 
 	// Range endpoints should not be inside DBCS characters, but just in case, move them.
 	startPos = doc->MovePositionOutsideChar(startPos, 1, false);
 	endPos = doc->MovePositionOutsideChar(endPos, 1, false);
 
-	const char *errmsg = search.Compile(s, *length, caseSensitive, posix);
+	const char *errmsg = search.Compile(s, static_cast<int>(*length), caseSensitive, posix);
 	if (errmsg) {
 		return -1;
 	}
@@ -2121,14 +2644,14 @@ long BuiltinRegex::FindText(Document *doc, int minPos, int maxPos, const char *s
 		lineRangeStart--;
 		startPos = doc->LineEnd(lineRangeStart);
 	}
-	int pos = -1;
-	int lenRet = 0;
+	Position pos = -1;
+	Position lenRet = 0;
 	char searchEnd = s[*length - 1];
 	char searchEndPrev = (*length > 1) ? s[*length - 2] : '\0';
 	int lineRangeBreak = lineRangeEnd + increment;
 	for (int line = lineRangeStart; line != lineRangeBreak; line += increment) {
-		int startOfLine = doc->LineStart(line);
-		int endOfLine = doc->LineEnd(line);
+		Position startOfLine = doc->LineStart(line);
+		Position endOfLine = doc->LineEnd(line);
 		if (increment == 1) {
 			if (line == lineRangeStart) {
 				if ((startPos != startOfLine) && (s[0] == '^'))
@@ -2181,89 +2704,139 @@ long BuiltinRegex::FindText(Document *doc, int minPos, int maxPos, const char *s
 	return pos;
 }
 
-const char *BuiltinRegex::SubstituteByPosition(Document *doc, const char *text, int *length) {
+const char *BuiltinRegex::SubstituteByPosition(Document *doc, const char *text, Position *length) {
 	delete []substituted;
 	substituted = 0;
 	DocumentIndexer di(doc, doc->Length());
 	if (!search.GrabMatches(di))
 		return 0;
-	unsigned int lenResult = 0;
-	for (int i = 0; i < *length; i++) {
-		if (text[i] == '\\') {
-			if (text[i + 1] >= '1' && text[i + 1] <= '9') {
-				unsigned int patNum = text[i + 1] - '0';
-				lenResult += search.eopat[patNum] - search.bopat[patNum];
-				i++;
-			} else {
-				switch (text[i + 1]) {
-				case 'a':
-				case 'b':
-				case 'f':
-				case 'n':
-				case 'r':
-				case 't':
-				case 'v':
-				case '\\':
-					i++;
-				}
-				lenResult++;
-			}
-		} else {
-			lenResult++;
-		}
+	substituted = SubstituteTags(text, length, search.bopat, search.eopat, search.pat);
+	return substituted;
+}
+
+/**
+ * Implementation of RegexSearchBase for the linear time DFASearch engine
+ */
+class DFARegex : public RegexSearchBase {
+public:
+	DFARegex(CharClassify *charClassTable) : search(charClassTable), substituted(NULL) {}
+
+	virtual ~DFARegex() {
+		delete []substituted;
 	}
-	substituted = new char[lenResult + 1];
-	char *o = substituted;
-	for (int j = 0; j < *length; j++) {
-		if (text[j] == '\\') {
-			if (text[j + 1] >= '1' && text[j + 1] <= '9') {
-				unsigned int patNum = text[j + 1] - '0';
-				unsigned int len = search.eopat[patNum] - search.bopat[patNum];
-				if (search.pat[patNum])	// Will be null if try for a match that did not occur
-					memcpy(o, search.pat[patNum], len);
-				o += len;
-				j++;
-			} else {
-				j++;
-				switch (text[j]) {
-				case 'a':
-					*o++ = '\a';
-					break;
-				case 'b':
-					*o++ = '\b';
-					break;
-				case 'f':
-					*o++ = '\f';
-					break;
-				case 'n':
-					*o++ = '\n';
-					break;
-				case 'r':
-					*o++ = '\r';
-					break;
-				case 't':
-					*o++ = '\t';
-					break;
-				case 'v':
-					*o++ = '\v';
-					break;
-				case '\\':
-					*o++ = '\\';
-					break;
-				default:
-					*o++ = '\\';
-					j--;
-				}
-			}
-		} else {
-			*o++ = text[j];
+
+	virtual Position FindText(Document *doc, Position minPos, Position maxPos, const char *s,
+                        bool caseSensitive, bool word, bool wordStart, int flags,
+                        Position *length);
+
+	virtual const char *SubstituteByPosition(Document *doc, const char *text, Position *length);
+
+private:
+	DFASearch search;
+	char *substituted;
+};
+
+// Lets DFASearch read the document a block at a time
+class DocumentBlocks : public BlockIndexer {
+	Document *pdoc;
+public:
+	DocumentBlocks(Document *pdoc_) : pdoc(pdoc_) {
+	}
+
+	virtual ~DocumentBlocks() {
+	}
+
+	virtual char CharAt(Position index) {
+		return pdoc->CharAt(index);
+	}
+
+	virtual const char *RangeAt(Position position, Position *rangeLength) {
+		return pdoc->RangeAt(position, rangeLength);
+	}
+
+	virtual Position Length() {
+		return pdoc->Length();
+	}
+};
+
+Position DFARegex::FindText(Document *doc, Position minPos, Position maxPos, const char *s,
+                        bool caseSensitive, bool, bool, int flags,
+                        Position *length) {
+	const bool posix = (flags & SCFIND_POSIX) != 0;
+	const char *errmsg = search.Compile(s, *length, caseSensitive, posix);
+	if (errmsg) {
+		return -1;
+	}
+
+	// Range endpoints should not be inside DBCS characters, but just in case, move them.
+	const Position startPos = doc->MovePositionOutsideChar(minPos, 1, false);
+	const Position endPos = doc->MovePositionOutsideChar(maxPos, 1, false);
+
+	DocumentBlocks blocks(doc);
+	if (startPos <= endPos) {
+		if (!search.Execute(blocks, startPos, endPos)) {
+			*length = 0;
+			return -1;
+		}
+		*length = search.eopat[0] - search.bopat[0];
+		return search.bopat[0];
+	}
+
+	// Backwards: the last match ending by startPos. Look through a window of lines
+	// before startPos, doubling the number of lines until a match is found.
+	int lineWindow = doc->LineFromPosition(startPos);
+	int lines = 1;
+	for (;;) {
+		const Position windowStart = MaxPosition(doc->LineStart(lineWindow), endPos);
+		Position pos = -1;
+		Position lenMatch = 0;
+		Position from = windowStart;
+		while ((from <= startPos) && search.Execute(blocks, from, startPos)) {
+			pos = search.bopat[0];
+			lenMatch = search.eopat[0] - search.bopat[0];
+			from = doc->NextPosition(pos, 1);
+			if (from == pos)
+				break;
+		}
+		if (pos >= 0) {
+			// Leave the search at the match returned so SubstituteByPosition uses it
+			search.Execute(blocks, pos, startPos);
+			*length = lenMatch;
+			return pos;
 		}
+		if (windowStart <= endPos) {
+			*length = 0;
+			return -1;
+		}
+		lineWindow = (lineWindow > lines) ? lineWindow - lines : 0;
+		lines *= 2;
 	}
-	*o = '\0';
-	*length = lenResult;
+}
+
+const char *DFARegex::SubstituteByPosition(Document *doc, const char *text, Position *length) {
+	delete []substituted;
+	substituted = 0;
+	DocumentBlocks blocks(doc);
+	if (!search.GrabMatches(blocks))
+		return 0;
+	substituted = SubstituteTags(text, length, search.bopat, search.eopat, search.pat);
 	return substituted;
 }
 
+#ifdef SCI_NAMESPACE
+
+RegexSearchBase *Scintilla::CreateDFARegexSearch(CharClassify *charClassTable) {
+	return new DFARegex(charClassTable);
+}
+
+#else
+
+RegexSearchBase *CreateDFARegexSearch(CharClassify *charClassTable) {
+	return new DFARegex(charClassTable);
+}
+
+#endif
+
 #ifndef SCI_OWNREGEX
 
 #ifdef SCI_NAMESPACE
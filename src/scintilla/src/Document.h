@@ -12,13 +12,6 @@
 namespace Scintilla {
 #endif
 
-/**
- * A Position is a position within a document between two characters or at the beginning or end.
- * Sometimes used as a character index where it identifies the character after the position.
- */
-typedef int Position;
-const Position invalidPosition = -1;
-
 /**
  * The range class represents a range of text in a document.
  * The two values are not sorted as one end may be more significant than the other
@@ -83,16 +76,19 @@ class RegexSearchBase {
 public:
 	virtual ~RegexSearchBase() {}
 
-	virtual long FindText(Document *doc, int minPos, int maxPos, const char *s,
-                        bool caseSensitive, bool word, bool wordStart, int flags, int *length) = 0;
+	virtual Position FindText(Document *doc, Position minPos, Position maxPos, const char *s,
+                        bool caseSensitive, bool word, bool wordStart, int flags, Position *length) = 0;
 
 	///@return String with the substitutions, must remain valid until the next call or destruction
-	virtual const char *SubstituteByPosition(Document *doc, const char *text, int *length) = 0;
+	virtual const char *SubstituteByPosition(Document *doc, const char *text, Position *length) = 0;
 };
 
 /// Factory function for RegexSearchBase
 extern RegexSearchBase *CreateRegexSearch(CharClassify *charClassTable);
 
+/// Factory function for the linear time RegexSearchBase chosen with SCFIND_DFAREGEX
+extern RegexSearchBase *CreateDFARegexSearch(CharClassify *charClassTable);
+
 struct StyledText {
 	size_t length;
 	const char *text;
@@ -174,21 +170,46 @@ public:
 };
 
 class Document;
+class BackgroundLexer; //!-add-[BackgroundLexing]
 
 class LexInterface {
 protected:
 	Document *pdoc;
 	ILexer *instance;
 	bool performingStyle;	///< Prevent reentrance
+//!-start-[BackgroundLexing]
+	BackgroundLexer *background;
+	/// Text styled by ColouriseAhead that the background lexer has not reached
+	Position aheadStart;
+	Position aheadEnd;
+	/// The background lexer reached the end and nothing has changed since
+	bool lexedToEnd;
+//!-end-[BackgroundLexing]
 public:
-	LexInterface(Document *pdoc_) : pdoc(pdoc_), instance(0), performingStyle(false) {
-	}
-	virtual ~LexInterface() {
+	LexInterface(Document *pdoc_) : pdoc(pdoc_), instance(0), performingStyle(false),
+		background(0), aheadStart(0), aheadEnd(0), lexedToEnd(false) { //!-change-[BackgroundLexing]
 	}
-	void Colourise(int start, int end);
+	virtual ~LexInterface();
+	void Colourise(Position start, Position end);
 	bool UseContainerLexing() const {
 		return instance == 0;
 	}
+//!-start-[BackgroundLexing]
+	/// Start, continue or finish lexing on a background thread from the end of styling.
+	/// @return true while there is more to do.
+	bool ColouriseBackground();
+	/// Style the text from start to end, which is after the end of styling, without moving
+	/// the end of styling so the background lexer still styles it properly later.
+	void ColouriseAhead(Position start, Position end);
+	/// Discard the work of the background lexer as the text or the lexer are changing.
+	void StopBackground();
+	/// Pause the background lexer before the text changes, keeping its copy of the text.
+	void TextChanging();
+	/// Apply an insertion (lengthChange > 0) or deletion to the background lexer's copy.
+	void TextChanged(Position position, Position lengthChange, int linesAdded);
+	/// Tell the background lexer its copy differs from the document between start and end.
+	void Restyled(Position start, Position end);
+//!-end-[BackgroundLexing]
 };
 
 /**
@@ -213,7 +234,7 @@ private:
 	CellBuffer cb;
 	CharClassify charClass;
 	char stylingMask;
-	int endStyled;
+	Position endStyled;
 	int styleClock;
 	int enteredModification;
 	int enteredStyling;
@@ -228,6 +249,7 @@ private:
 
 	bool matchesValid;
 	RegexSearchBase *regex;
+	bool regexDFA;
 
 public:
 
@@ -264,27 +286,28 @@ public:
 
 	void SCI_METHOD SetErrorStatus(int status);
 
-	int SCI_METHOD LineFromPosition(int pos) const;
-	int ClampPositionIntoDocument(int pos);
-	bool IsCrLf(int pos);
-	int LenChar(int pos);
-	bool InGoodUTF8(int pos, int &start, int &end) const;
-	int MovePositionOutsideChar(int pos, int moveDir, bool checkLineEnd=true);
-	int NextPosition(int pos, int moveDir) const;
-	bool NextCharacter(int &pos, int moveDir);	// Returns true if pos changed
+	int SCI_METHOD LineFromPosition(Position pos) const;
+	Position ClampPositionIntoDocument(Position pos);
+	bool IsCrLf(Position pos);
+	int LenChar(Position pos);
+	bool InGoodUTF8(Position pos, Position &start, Position &end) const;
+	Position MovePositionOutsideChar(Position pos, Position moveDir, bool checkLineEnd=true);
+	Position NextPosition(Position pos, int moveDir) const;
+	bool NextCharacter(Position &pos, int moveDir);	// Returns true if pos changed
 	int SCI_METHOD CodePage() const;
 	bool SCI_METHOD IsDBCSLeadByte(char ch) const;
 	int SafeSegment(const char *text, int length, int lengthSegment);
 
 	// Gateways to modifying document
-	void ModifiedAt(int pos);
+	void ModifiedAt(Position pos);
 	void CheckReadOnly();
-	bool DeleteChars(int pos, int len);
-	bool InsertString(int position, const char *s, int insertLength);
-	int SCI_METHOD AddData(char *data, int length);
+	bool DeleteChars(Position pos, Position len);
+	bool InsertString(Position position, const char *s, Position insertLength);
+	int SCI_METHOD AddData(char *data, Position length);
 	void * SCI_METHOD ConvertToDocument();
-	int Undo();
-	int Redo();
+	int SCI_METHOD AddMapped(IMappedText *pText);
+	Position Undo();
+	Position Redo();
 	bool CanUndo() { return cb.CanUndo(); }
 	bool CanRedo() { return cb.CanRedo(); }
 	void DeleteUndoHistory() { cb.DeleteUndoHistory(); }
@@ -295,34 +318,40 @@ public:
 	void BeginUndoAction() { cb.BeginUndoAction(); }
 	void EndUndoAction() { cb.EndUndoAction(); }
 	void AddUndoAction(int token, bool mayCoalesce) { cb.AddUndoAction(token, mayCoalesce); }
+	void SetUndoMemoryLimit(Position limit) { cb.SetUndoMemoryLimit(limit); } //!-add-[UndoArena]
+	Position GetUndoMemoryLimit() const { return cb.GetUndoMemoryLimit(); } //!-add-[UndoArena]
+	Position UndoMemoryUse() const { return cb.UndoMemoryUse(); } //!-add-[UndoArena]
+	int UndoActions() const { return cb.UndoActions(); } //!-add-[UndoArena]
+	Position SaveUndoHistory(char *buffer) const { return cb.SaveUndoHistory(buffer); } //!-add-[PersistentUndo]
+	bool LoadUndoHistory(const char *data, Position length) { return cb.LoadUndoHistory(data, length); } //!-add-[PersistentUndo]
 	void SetSavePoint();
 	bool IsSavePoint() { return cb.IsSavePoint(); }
 	const char * SCI_METHOD BufferPointer() { return cb.BufferPointer(); }
 
 	int SCI_METHOD GetLineIndentation(int line);
 	void SetLineIndentation(int line, int indent);
-	int GetLineIndentPosition(int line) const;
-	int GetColumn(int position);
-	int CountCharacters(int startPos, int endPos);
-	int FindColumn(int line, int column);
+	Position GetLineIndentPosition(int line) const;
+	int GetColumn(Position position);
+	Position CountCharacters(Position startPos, Position endPos);
+	Position FindColumn(int line, int column);
 	void Indent(bool forwards, int lineBottom, int lineTop);
 	static char *TransformLineEnds(int *pLenOut, const char *s, size_t len, int eolModeWanted);
 	void ConvertLineEnds(int eolModeSet);
 	void SetReadOnly(bool set) { cb.SetReadOnly(set); }
 	bool IsReadOnly() { return cb.IsReadOnly(); }
 
-	bool InsertChar(int pos, char ch);
-	bool InsertCString(int position, const char *s);
-	void ChangeChar(int pos, char ch);
-	void DelChar(int pos);
-	void DelCharBack(int pos);
+	bool InsertChar(Position pos, char ch);
+	bool InsertCString(Position position, const char *s);
+	void ChangeChar(Position pos, char ch);
+	void DelChar(Position pos);
+	void DelCharBack(Position pos);
 
-	char CharAt(int position) { return cb.CharAt(position); }
-	void SCI_METHOD GetCharRange(char *buffer, int position, int lengthRetrieve) const {
+	char CharAt(Position position) { return cb.CharAt(position); }
+	void SCI_METHOD GetCharRange(char *buffer, Position position, Position lengthRetrieve) const {
 		cb.GetCharRange(buffer, position, lengthRetrieve);
 	}
-	char SCI_METHOD StyleAt(int position) const { return cb.StyleAt(position); }
-	void GetStyleRange(unsigned char *buffer, int position, int lengthRetrieve) const {
+	char SCI_METHOD StyleAt(Position position) const { return cb.StyleAt(position); }
+	void GetStyleRange(unsigned char *buffer, Position position, Position lengthRetrieve) const {
 		cb.GetStyleRange(buffer, position, lengthRetrieve);
 	}
 	int GetMark(int line);
@@ -333,11 +362,11 @@ public:
 	void DeleteMarkFromHandle(int markerHandle);
 	void DeleteAllMarks(int markerNum);
 	int LineFromHandle(int markerHandle);
-	int SCI_METHOD LineStart(int line) const;
-	int LineEnd(int line) const;
-	int LineEndPosition(int position) const;
-	bool IsLineEndPosition(int position) const;
-	int VCHomePosition(int position) const;
+	Position SCI_METHOD LineStart(int line) const;
+	Position LineEnd(int line) const;
+	Position LineEndPosition(Position position) const;
+	bool IsLineEndPosition(Position position) const;
+	Position VCHomePosition(Position position) const;
 
 	int SCI_METHOD SetLevel(int line, int level);
 	int SCI_METHOD GetLevel(int line) const;
@@ -347,16 +376,22 @@ public:
 	void GetHighlightDelimiters(HighlightDelimiter &hDelimiter, int line, int lastLine);
 
 	void Indent(bool forwards);
-	int ExtendWordSelect(int pos, int delta, bool onlyWordCharacters=false);
-	int NextWordStart(int pos, int delta);
-	int NextWordEnd(int pos, int delta);
-	int SCI_METHOD Length() const { return cb.Length(); }
-	void Allocate(int newSize) { cb.Allocate(newSize); }
-	size_t ExtractChar(int pos, char *bytes);
-	bool MatchesWordOptions(bool word, bool wordStart, int pos, int length);
-	long FindText(int minPos, int maxPos, const char *search, bool caseSensitive, bool word,
-		bool wordStart, bool regExp, int flags, int *length, CaseFolder *pcf);
-	const char *SubstituteByPosition(const char *text, int *length);
+	Position ExtendWordSelect(Position pos, int delta, bool onlyWordCharacters=false);
+	Position NextWordStart(Position pos, int delta);
+	Position NextWordEnd(Position pos, int delta);
+	Position SCI_METHOD Length() const { return cb.Length(); }
+	void Allocate(Position newSize) { cb.Allocate(newSize); }
+	void SetChunkSize(Position chunkSize) { cb.SetChunkSize(chunkSize); }
+	Position GetChunkSize() const { return cb.GetChunkSize(); }
+	const char *RangeAt(Position position, Position *rangeLength) const { return cb.RangeAt(position, rangeLength); }
+	size_t ExtractChar(Position pos, char *bytes);
+	bool MatchesWordOptions(bool word, bool wordStart, Position pos, Position length);
+	Position FindText(Position minPos, Position maxPos, const char *search, bool caseSensitive, bool word,
+		bool wordStart, bool regExp, int flags, Position *length, CaseFolder *pcf);
+	const char *SubstituteByPosition(const char *text, Position *length);
+	int ReplaceAll(Position minPos, Position maxPos, const char *search, Position lengthSearch,
+		const char *replace, Position lengthReplace, bool caseSensitive, bool word, bool wordStart,
+		bool regExp, int flags, CaseFolder *pcf, Range *replaced);
 	int LinesTotal() const;
 
 	void ChangeCase(Range r, bool makeUpperCase);
@@ -364,23 +399,23 @@ public:
 	void SetDefaultCharClasses(bool includeWordClass);
 	void SetCharClasses(const unsigned char *chars, CharClassify::cc newCharClass);
 	void SetStylingBits(int bits);
-	void SCI_METHOD StartStyling(int position, char mask);
-	bool SCI_METHOD SetStyleFor(int length, char style);
-	bool SCI_METHOD SetStyles(int length, const char *styles);
-	int GetEndStyled() { return endStyled; }
-	void EnsureStyledTo(int pos);
+	void SCI_METHOD StartStyling(Position position, char mask);
+	bool SCI_METHOD SetStyleFor(Position length, char style);
+	bool SCI_METHOD SetStyles(Position length, const char *styles);
+	Position GetEndStyled() { return endStyled; }
+	void EnsureStyledTo(Position pos);
 	void LexerChanged();
 	int GetStyleClock() { return styleClock; }
 	void IncrementStyleClock();
 	void SCI_METHOD DecorationSetCurrentIndicator(int indicator) {
 		decorations.SetCurrentIndicator(indicator);
 	}
-	void SCI_METHOD DecorationFillRange(int position, int value, int fillLength);
+	void SCI_METHOD DecorationFillRange(Position position, int value, Position fillLength);
 
 	int SCI_METHOD SetLineState(int line, int state);
 	int SCI_METHOD GetLineState(int line) const;
 	int GetMaxLineState();
-	void SCI_METHOD ChangeLexerState(int start, int end);
+	void SCI_METHOD ChangeLexerState(Position start, Position end);
 
 	StyledText MarginStyledText(int line);
 	void MarginSetStyle(int line, int style);
@@ -405,19 +440,19 @@ public:
 
 	CharClassify::cc WordCharClass(unsigned char ch);
 	bool IsWordPartSeparator(char ch);
-	int WordPartLeft(int pos);
-	int WordPartRight(int pos);
-	int ExtendStyleRange(int pos, int delta, bool singleLine = false);
+	Position WordPartLeft(Position pos);
+	Position WordPartRight(Position pos);
+	Position ExtendStyleRange(Position pos, int delta, bool singleLine = false);
 	bool IsWhiteLine(int line) const;
-	int ParaUp(int pos);
-	int ParaDown(int pos);
+	Position ParaUp(Position pos);
+	Position ParaDown(Position pos);
 	int IndentSize() { return actualIndentInChars; }
-	int BraceMatch(int position, int maxReStyle);
+	Position BraceMatch(Position position, Position maxReStyle);
 
 private:
-	bool IsWordStartAt(int pos);
-	bool IsWordEndAt(int pos);
-	bool IsWordAt(int start, int end);
+	bool IsWordStartAt(Position pos);
+	bool IsWordEndAt(Position pos);
+	bool IsWordAt(Position start, Position end);
 
 	void NotifyModifyAttempt();
 	void NotifySavePoint(bool atSavePoint);
@@ -453,8 +488,8 @@ public:
 class DocModification {
 public:
   	int modificationType;
-	int position;
- 	int length;
+	Position position;
+ 	Position length;
  	int linesAdded;	/**< Negative if lines deleted. */
  	const char *text;	/**< Only valid for changes to text, not for changes to style. */
  	int line;
@@ -463,7 +498,7 @@ public:
 	int annotationLinesAdded;
 	int token;
 
-	DocModification(int modificationType_, int position_=0, int length_=0,
+	DocModification(int modificationType_, Position position_=0, Position length_=0,
 		int linesAdded_=0, const char *text_=0, int line_=0) :
 		modificationType(modificationType_),
 		position(position_),
@@ -501,7 +536,7 @@ public:
 	virtual void NotifySavePoint(Document *doc, void *userData, bool atSavePoint) = 0;
 	virtual void NotifyModified(Document *doc, DocModification mh, void *userData) = 0;
 	virtual void NotifyDeleted(Document *doc, void *userData) = 0;
-	virtual void NotifyStyleNeeded(Document *doc, void *userData, int endPos) = 0;
+	virtual void NotifyStyleNeeded(Document *doc, void *userData, Position endPos) = 0;
 	virtual void NotifyLexerChanged(Document *doc, void *userData) = 0;
 	virtual void NotifyErrorOccurred(Document *doc, void *userData, int status) = 0;
 };
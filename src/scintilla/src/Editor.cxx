@@ -21,9 +21,11 @@
 
 #include "ILexer.h"
 #include "Scintilla.h"
+#include "Position.h"
 
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -196,6 +198,7 @@ Editor::Editor() {
 
 	paintState = notPainting;
 	willRedrawAll = false;
+	backgroundLexing = false; //!-add-[BackgroundLexing]
 
 	modEventMask = SC_MODEVENTMASKALL;
 
@@ -214,6 +217,7 @@ Editor::Editor() {
 	wrapVisualFlagsLocation = 0;
 	wrapVisualStartIndent = 0;
 	wrapIndentMode = SC_WRAPINDENT_FIXED;
+	wrapThreads = 1; //!-add-[WrapThreads]
 	wrapAddIndent = 0;
 
 	convertPastes = true;
@@ -420,9 +424,9 @@ Point Editor::LocationFromPosition(SelectionPosition pos) {
 		// -1 because of adding in for visible lines in following loop.
 		pt.y = (lineVisible - topLine - 1) * vs.lineHeight;
 		pt.x = 0;
-		unsigned int posLineStart = pdoc->LineStart(line);
+		Position posLineStart = pdoc->LineStart(line);
 		LayoutLine(line, surface, vs, ll, wrapWidth);
-		int posInLine = pos.Position() - posLineStart;
+		Position posInLine = pos.Position() - posLineStart;
 		// In case of very long line put x at arbitrary large position
 		if (posInLine > ll->maxLineLength) {
 			pt.x = ll->positions[ll->maxLineLength] - ll->positions[ll->LineStart(ll->lines)];
@@ -447,11 +451,11 @@ Point Editor::LocationFromPosition(SelectionPosition pos) {
 	return pt;
 }
 
-Point Editor::LocationFromPosition(int pos) {
+Point Editor::LocationFromPosition(Position pos) {
 	return LocationFromPosition(SelectionPosition(pos));
 }
 
-int Editor::XFromPosition(int pos) {
+int Editor::XFromPosition(Position pos) {
 	Point pt = LocationFromPosition(pos);
 	return pt.x - vs.fixedColumnWidth + xOffset;
 }
@@ -496,7 +500,7 @@ SelectionPosition Editor::SPositionFromLocation(Point pt, bool canReturnInvalid,
 		return SelectionPosition(INVALID_POSITION);
 	if (lineDoc >= pdoc->LinesTotal())
 		return SelectionPosition(canReturnInvalid ? INVALID_POSITION : pdoc->Length());
-	unsigned int posLineStart = pdoc->LineStart(lineDoc);
+	Position posLineStart = pdoc->LineStart(lineDoc);
 	SelectionPosition retVal(canReturnInvalid ? INVALID_POSITION : static_cast<int>(posLineStart));
 	AutoSurface surface(this);
 	AutoLineLayout ll(llc, RetrieveLineLayout(lineDoc));
@@ -545,7 +549,7 @@ SelectionPosition Editor::SPositionFromLocation(Point pt, bool canReturnInvalid,
 	return retVal;
 }
 
-int Editor::PositionFromLocation(Point pt, bool canReturnInvalid, bool charPosition) {
+Position Editor::PositionFromLocation(Point pt, bool canReturnInvalid, bool charPosition) {
 	return SPositionFromLocation(pt, canReturnInvalid, charPosition, false).Position();
 }
 
@@ -553,16 +557,16 @@ int Editor::PositionFromLocation(Point pt, bool canReturnInvalid, bool charPosit
  * Find the document position corresponding to an x coordinate on a particular document line.
  * Ensure is between whole characters when document is in multi-byte or UTF-8 mode.
  */
-int Editor::PositionFromLineX(int lineDoc, int x) {
+Position Editor::PositionFromLineX(int lineDoc, int x) {
 	RefreshStyleData();
 	if (lineDoc >= pdoc->LinesTotal())
 		return pdoc->Length();
 	//Platform::DebugPrintf("Position of (%d,%d) line = %d top=%d\n", pt.x, pt.y, line, topLine);
 	AutoSurface surface(this);
 	AutoLineLayout ll(llc, RetrieveLineLayout(lineDoc));
-	int retVal = 0;
+	Position retVal = 0;
 	if (surface && ll) {
-		unsigned int posLineStart = pdoc->LineStart(lineDoc);
+		Position posLineStart = pdoc->LineStart(lineDoc);
 		LayoutLine(lineDoc, surface, vs, ll, wrapWidth);
 		retVal = ll->numCharsBeforeEOL + posLineStart;
 		int subLine = 0;
@@ -597,9 +601,9 @@ SelectionPosition Editor::SPositionFromLineX(int lineDoc, int x) {
 	//Platform::DebugPrintf("Position of (%d,%d) line = %d top=%d\n", pt.x, pt.y, line, topLine);
 	AutoSurface surface(this);
 	AutoLineLayout ll(llc, RetrieveLineLayout(lineDoc));
-	int retVal = 0;
+	Position retVal = 0;
 	if (surface && ll) {
-		unsigned int posLineStart = pdoc->LineStart(lineDoc);
+		Position posLineStart = pdoc->LineStart(lineDoc);
 		LayoutLine(lineDoc, surface, vs, ll, wrapWidth);
 		int subLine = 0;
 		int lineStart = ll->LineStart(subLine);
@@ -670,7 +674,7 @@ void Editor::RedrawSelMargin(int line, bool allAfter) {
 			PRectangle rcSelMargin = GetClientRectangle();
 			rcSelMargin.right = vs.fixedColumnWidth;
 			if (line != -1) {
-				int position = pdoc->LineStart(line);
+				Position position = pdoc->LineStart(line);
 				PRectangle rcLine = RectangleFromRange(position, position);
 				rcSelMargin.top = rcLine.top;
 				if (!allAfter)
@@ -681,11 +685,11 @@ void Editor::RedrawSelMargin(int line, bool allAfter) {
 	}
 }
 
-PRectangle Editor::RectangleFromRange(int start, int end) {
-	int minPos = start;
+PRectangle Editor::RectangleFromRange(Position start, Position end) {
+	Position minPos = start;
 	if (minPos > end)
 		minPos = end;
-	int maxPos = start;
+	Position maxPos = start;
 	if (maxPos < end)
 		maxPos = end;
 	int minLine = cs.DisplayFromDoc(pdoc->LineFromPosition(minPos));
@@ -706,11 +710,11 @@ PRectangle Editor::RectangleFromRange(int start, int end) {
 	return rc;
 }
 
-void Editor::InvalidateRange(int start, int end) {
+void Editor::InvalidateRange(Position start, Position end) {
 	RedrawRect(RectangleFromRange(start, end));
 }
 
-int Editor::CurrentPosition() {
+Position Editor::CurrentPosition() {
 	return sel.MainCaret();
 }
 
@@ -764,16 +768,16 @@ void Editor::InvalidateSelection(SelectionRange newMain, bool invalidateWholeSel
 	if (sel.Count() > 1 || !(sel.RangeMain().anchor == newMain.anchor) || sel.IsRectangular()) {
 		invalidateWholeSelection = true;
 	}
-	int firstAffected = Platform::Minimum(sel.RangeMain().Start().Position(), newMain.Start().Position());
+	Position firstAffected = MinPosition(sel.RangeMain().Start().Position(), newMain.Start().Position());
 	// +1 for lastAffected ensures caret repainted
-	int lastAffected = Platform::Maximum(newMain.caret.Position()+1, newMain.anchor.Position());
-	lastAffected = Platform::Maximum(lastAffected, sel.RangeMain().End().Position());
+	Position lastAffected = MaxPosition(newMain.caret.Position()+1, newMain.anchor.Position());
+	lastAffected = MaxPosition(lastAffected, sel.RangeMain().End().Position());
 	if (invalidateWholeSelection) {
 		for (size_t r=0; r<sel.Count(); r++) {
-			firstAffected = Platform::Minimum(firstAffected, sel.Range(r).caret.Position());
-			firstAffected = Platform::Minimum(firstAffected, sel.Range(r).anchor.Position());
-			lastAffected = Platform::Maximum(lastAffected, sel.Range(r).caret.Position()+1);
-			lastAffected = Platform::Maximum(lastAffected, sel.Range(r).anchor.Position());
+			firstAffected = MinPosition(firstAffected, sel.Range(r).caret.Position());
+			firstAffected = MinPosition(firstAffected, sel.Range(r).anchor.Position());
+			lastAffected = MaxPosition(lastAffected, sel.Range(r).caret.Position()+1);
+			lastAffected = MaxPosition(lastAffected, sel.Range(r).anchor.Position());
 		}
 	}
 	ContainerNeedsUpdate(SC_UPDATE_SELECTION);
@@ -808,7 +812,7 @@ void Editor::SetSelection(SelectionPosition currentPos_, SelectionPosition ancho
 	}
 }
 
-void Editor::SetSelection(int currentPos_, int anchor_) {
+void Editor::SetSelection(Position currentPos_, Position anchor_) {
 	SetSelection(SelectionPosition(currentPos_), SelectionPosition(anchor_));
 }
 
@@ -834,7 +838,7 @@ void Editor::SetSelection(SelectionPosition currentPos_) {
 	}
 }
 
-void Editor::SetSelection(int currentPos_) {
+void Editor::SetSelection(Position currentPos_) {
 	SetSelection(SelectionPosition(currentPos_));
 }
 
@@ -854,19 +858,19 @@ void Editor::SetEmptySelection(SelectionPosition currentPos_) {
 	}
 }
 
-void Editor::SetEmptySelection(int currentPos_) {
+void Editor::SetEmptySelection(Position currentPos_) {
 	SetEmptySelection(SelectionPosition(currentPos_));
 }
 
-bool Editor::RangeContainsProtected(int start, int end) const {
+bool Editor::RangeContainsProtected(Position start, Position end) const {
 	if (vs.ProtectionActive()) {
 		if (start > end) {
-			int t = start;
+			Position t = start;
 			start = end;
 			end = t;
 		}
 		int mask = pdoc->stylingBitsMask;
-		for (int pos = start; pos < end; pos++) {
+		for (Position pos = start; pos < end; pos++) {
 			if (vs.styles[pdoc->StyleAt(pos) & mask].IsProtected())
 				return true;
 		}
@@ -887,12 +891,12 @@ bool Editor::SelectionContainsProtected() {
 /**
  * Asks document to find a good position and then moves out of any invisible positions.
  */
-int Editor::MovePositionOutsideChar(int pos, int moveDir, bool checkLineEnd) const {
+Position Editor::MovePositionOutsideChar(Position pos, Position moveDir, bool checkLineEnd) const {
 	return MovePositionOutsideChar(SelectionPosition(pos), moveDir, checkLineEnd).Position();
 }
 
-SelectionPosition Editor::MovePositionOutsideChar(SelectionPosition pos, int moveDir, bool checkLineEnd) const {
-	int posMoved = pdoc->MovePositionOutsideChar(pos.Position(), moveDir, checkLineEnd);
+SelectionPosition Editor::MovePositionOutsideChar(SelectionPosition pos, Position moveDir, bool checkLineEnd) const {
+	Position posMoved = pdoc->MovePositionOutsideChar(pos.Position(), moveDir, checkLineEnd);
 	if (posMoved != pos.Position())
 		pos.SetPosition(posMoved);
 	if (vs.ProtectionActive()) {
@@ -914,11 +918,11 @@ SelectionPosition Editor::MovePositionOutsideChar(SelectionPosition pos, int mov
 	return pos;
 }
 
-int Editor::MovePositionTo(SelectionPosition newPos, Selection::selTypes selt, bool ensureVisible) {
+Position Editor::MovePositionTo(SelectionPosition newPos, Selection::selTypes selt, bool ensureVisible) {
 	bool simpleCaret = (sel.Count() == 1) && sel.Empty();
 	SelectionPosition spCaret = sel.Last();
 
-	int delta = newPos.Position() - sel.MainCaret();
+	Position delta = newPos.Position() - sel.MainCaret();
 	newPos = ClampPositionIntoDocument(newPos);
 	newPos = MovePositionOutsideChar(newPos, delta);
 	if (!multipleSelection && sel.IsRectangular() && (selt == Selection::selStream)) {
@@ -961,7 +965,7 @@ int Editor::MovePositionTo(SelectionPosition newPos, Selection::selTypes selt, b
 	return 0;
 }
 
-int Editor::MovePositionTo(int newPos, Selection::selTypes selt, bool ensureVisible) {
+Position Editor::MovePositionTo(Position newPos, Selection::selTypes selt, bool ensureVisible) {
 	return MovePositionTo(SelectionPosition(newPos), selt, ensureVisible);
 }
 
@@ -984,7 +988,7 @@ SelectionPosition Editor::MovePositionSoVisible(SelectionPosition pos, int moveD
 	}
 }
 
-SelectionPosition Editor::MovePositionSoVisible(int pos, int moveDir) {
+SelectionPosition Editor::MovePositionSoVisible(Position pos, int moveDir) {
 	return MovePositionSoVisible(SelectionPosition(pos), moveDir);
 }
 
@@ -1061,16 +1065,16 @@ void Editor::VerticalCentreCaret() {
 void Editor::MoveSelectedLines(int lineDelta) {
 
 	// if selection doesn't start at the beginning of the line, set the new start
-	int selectionStart = SelectionStart().Position();
+	Position selectionStart = SelectionStart().Position();
 	int startLine = pdoc->LineFromPosition(selectionStart);
-	int beginningOfStartLine = pdoc->LineStart(startLine);
+	Position beginningOfStartLine = pdoc->LineStart(startLine);
 	selectionStart = beginningOfStartLine;
 
 	// if selection doesn't end at the beginning of a line greater than that of the start,
 	// then set it at the beginning of the next one
-	int selectionEnd = SelectionEnd().Position();
+	Position selectionEnd = SelectionEnd().Position();
 	int endLine = pdoc->LineFromPosition(selectionEnd);
-	int beginningOfEndLine = pdoc->LineStart(endLine);
+	Position beginningOfEndLine = pdoc->LineStart(endLine);
 	if (selectionEnd > beginningOfEndLine
 		|| selectionStart == selectionEnd) {
 		selectionEnd = pdoc->LineStart(endLine + 1);
@@ -1092,7 +1096,7 @@ void Editor::MoveSelectedLines(int lineDelta) {
 	SelectionText selectedText;
 	CopySelectionRange(&selectedText);
 
-	int selectionLength = SelectionRange(selectionStart, selectionEnd).Length();
+	Position selectionLength = SelectionRange(selectionStart, selectionEnd).Length();
 	ClearSelection();
 
 	Point currentLocation = LocationFromPosition(CurrentPosition());
@@ -1126,15 +1130,15 @@ void Editor::MoveCaretInsideView(bool ensureVisible) {
 	}
 }
 
-int Editor::DisplayFromPosition(int pos) {
+int Editor::DisplayFromPosition(Position pos) {
 	int lineDoc = pdoc->LineFromPosition(pos);
 	int lineDisplay = cs.DisplayFromDoc(lineDoc);
 	AutoSurface surface(this);
 	AutoLineLayout ll(llc, RetrieveLineLayout(lineDoc));
 	if (surface && ll) {
 		LayoutLine(lineDoc, surface, vs, ll, wrapWidth);
-		unsigned int posLineStart = pdoc->LineStart(lineDoc);
-		int posInLine = pos - posLineStart;
+		Position posLineStart = pdoc->LineStart(lineDoc);
+		Position posInLine = pos - posLineStart;
 		lineDisplay--; // To make up for first increment ahead.
 		for (int subLine = 0; subLine < ll->lines; subLine++) {
 			if (posInLine >= ll->LineStart(subLine)) {
@@ -1549,17 +1553,32 @@ bool Editor::WrapLines(bool fullWrap, int priorityWrapLineStart) {
 						priorityWrap = true;
 					} else {
 						// This is idle wrap.
-						lastLineToWrap = wrapStart + linesInOneCall;
+						lastLineToWrap = wrapStart + linesInOneCall * wrapThreads; //!-change-[WrapThreads]
 					}
 					if (lastLineToWrap >= wrapEnd)
 						lastLineToWrap = wrapEnd;
 				} // else do a fullWrap.
 
 				// Ensure all lines being wrapped are styled.
+//!-start-[BackgroundLexing]
+				// When lexing in the background the lines are wrapped again as styles arrive.
+				if (!LexingInBackground())
+//!-end-[BackgroundLexing]
 				pdoc->EnsureStyledTo(pdoc->LineEnd(lastLineToWrap));
 
 				// Platform::DebugPrintf("Wraplines: full = %d, priorityStart = %d (wrapping: %d to %d)\n", fullWrap, priorityWrapLineStart, lineToWrap, lastLineToWrap);
 				// Platform::DebugPrintf("Pending wraps: %d to %d\n", wrapStart, wrapEnd);
+//!-start-[WrapThreads]
+				if ((wrapThreads > 1) && !priorityWrap) {
+					// Measuring on this thread is limited as before so idle calls take as long
+					// as they did with one thread while wrapping wrapThreads times the lines.
+					if (WrapLinesOnThreads(surface, lineToWrap, lastLineToWrap,
+						fullWrap ? wrapLineLarge : linesInOneCall)) {
+						wrapOccurred = true;
+					}
+					lastLineToWrap = lineToWrap;
+				}
+//!-end-[WrapThreads]
 				while (lineToWrap < lastLineToWrap) {
 					if (WrapOneLine(surface, lineToWrap)) {
 						wrapOccurred = true;
@@ -1591,11 +1610,144 @@ bool Editor::WrapLines(bool fullWrap, int priorityWrapLineStart) {
 	return wrapOccurred;
 }
 
+//!-start-[WrapThreads]
+/**
+ * Lines wrapped together by several threads. Each thread claims blocks of lines until
+ * there are none left and records how many lines each wraps onto, or 0 when the line
+ * holds text that has to be measured with a surface on the window thread.
+ */
+class WrapBatch {
+	ThreadLock *lock;
+	int lineNext;
+
+	// Private so WrapBatch objects can not be copied
+	WrapBatch(const WrapBatch &);
+	void operator=(const WrapBatch &);
+
+public:
+	enum { linesPerBlock = 64, linesPerBatch = 0x2000 };
+	Editor *editor;
+	int lineStart;
+	int lineEnd;
+	int width;
+	std::vector<int> wraps;
+
+	WrapBatch(Editor *editor_, int lineStart_, int lineEnd_, int width_) :
+		lock(ThreadLock::Allocate()), lineNext(lineStart_),
+		editor(editor_), lineStart(lineStart_), lineEnd(lineEnd_), width(width_),
+		wraps(lineEnd_ - lineStart_, 0) {
+	}
+	~WrapBatch() {
+		delete lock;
+	}
+	bool NextBlock(int &lineBlock, int &lineBlockEnd) {
+		lock->Lock();
+		lineBlock = lineNext;
+		lineNext += linesPerBlock;
+		lock->Unlock();
+		lineBlockEnd = std::min(lineBlock + static_cast<int>(linesPerBlock), lineEnd);
+		return lineBlock < lineEnd;
+	}
+};
+
+/// A thread wrapping lines of a batch and the surface it measures with, if any.
+struct WrapWorker {
+	WrapBatch *batch;
+	Surface *surface;
+};
+
+void Editor::WrapThread(void *pWorker) {
+	WrapWorker *worker = static_cast<WrapWorker *>(pWorker);
+	worker->batch->editor->WrapBatchLines(*worker->batch, worker->surface);
+}
+
+/**
+ * Lay out the lines of a batch with a surface used by no other thread, or with none
+ * when the platform can only measure on the window thread. Only reads the document
+ * and the view style so may run on several threads while the window thread waits.
+ */
+void Editor::WrapBatchLines(WrapBatch &batch, Surface *surface) {
+	LineLayout ll(200);
+	int lineBlock = 0;
+	int lineBlockEnd = 0;
+	while (batch.NextBlock(lineBlock, lineBlockEnd)) {
+		for (int line = lineBlock; line < lineBlockEnd; line++) {
+			ll.Resize(static_cast<int>(pdoc->LineStart(line + 1) - pdoc->LineStart(line)));
+			ll.Invalidate(LineLayout::llInvalid);
+			LayoutLine(line, surface, vs, &ll, batch.width);
+			batch.wraps[line - batch.lineStart] = (ll.validity == LineLayout::llLines) ? ll.lines : 0;
+		}
+	}
+}
+
+/**
+ * Wrap lines from @a lineToWrap up to @a lastLineToWrap on wrapThreads threads, a batch
+ * at a time, then set their heights on this thread.
+ * Where the platform can not measure on other threads, they only wrap lines with all
+ * their text in posCache. The other lines are measured here, which also adds their text
+ * to posCache for following lines, stopping early after @a linesToMeasure lines.
+ * Return true if wrapping occurred.
+ */
+bool Editor::WrapLinesOnThreads(Surface *surface, int &lineToWrap, int lastLineToWrap, int linesToMeasure) {
+	const bool measureOnThreads = surface->ThreadSafeMeasureWidths();
+	std::vector<AutoSurface *> surfaces;
+	std::vector<WrapWorker> workers(wrapThreads - 1);
+	for (size_t worker = 0; worker < workers.size(); worker++) {
+		if (measureOnThreads) {
+			surfaces.push_back(new AutoSurface(this));
+			workers[worker].surface = *surfaces.back();
+		} else {
+			workers[worker].surface = 0;
+		}
+	}
+	bool wrapOccurred = false;
+	while (lineToWrap < lastLineToWrap) {
+		WrapBatch batch(this, lineToWrap,
+			std::min(lineToWrap + static_cast<int>(WrapBatch::linesPerBatch), lastLineToWrap), wrapWidth);
+		std::vector<BackgroundThread *> threads;
+		for (size_t worker = 0; worker < workers.size(); worker++) {
+			workers[worker].batch = &batch;
+			BackgroundThread *pThread = BackgroundThread::Start(WrapThread, &workers[worker]);
+			if (!pThread)
+				break;
+			threads.push_back(pThread);
+		}
+		WrapBatchLines(batch, measureOnThreads ? surface : 0);
+		for (size_t thread = 0; thread < threads.size(); thread++) {
+			threads[thread]->Join();
+			delete threads[thread];
+		}
+		for (; lineToWrap < batch.lineEnd; lineToWrap++) {
+			const int wraps = batch.wraps[lineToWrap - batch.lineStart];
+			if (wraps > 0) {
+				if (cs.SetHeight(lineToWrap, wraps +
+					(vs.annotationVisible ? pdoc->AnnotationLines(lineToWrap) : 0))) {
+					wrapOccurred = true;
+				}
+			} else {
+				if (linesToMeasure <= 0)
+					break;
+				linesToMeasure--;
+				if (WrapOneLine(surface, lineToWrap)) {
+					wrapOccurred = true;
+				}
+			}
+		}
+		if (lineToWrap < batch.lineEnd)
+			break;
+	}
+	for (size_t i = 0; i < surfaces.size(); i++) {
+		delete surfaces[i];
+	}
+	return wrapOccurred;
+}
+//!-end-[WrapThreads]
+
 void Editor::LinesJoin() {
 	if (!RangeContainsProtected(targetStart, targetEnd)) {
 		UndoGroup ug(pdoc);
 		bool prevNonWS = true;
-		for (int pos = targetStart; pos < targetEnd; pos++) {
+		for (Position pos = targetStart; pos < targetEnd; pos++) {
 			if (IsEOLChar(pdoc->CharAt(pos))) {
 				targetEnd -= pdoc->LenChar(pos);
 				pdoc->DelChar(pos);
@@ -1635,7 +1787,7 @@ void Editor::LinesSplit(int pixelWidth) {
 			AutoSurface surface(this);
 			AutoLineLayout ll(llc, RetrieveLineLayout(line));
 			if (surface && ll) {
-				unsigned int posLineStart = pdoc->LineStart(line);
+				Position posLineStart = pdoc->LineStart(line);
 				LayoutLine(line, surface, vs, ll, pixelWidth);
 				for (int subLine = 1; subLine < ll->lines; subLine++) {
 					pdoc->InsertCString(
@@ -2040,12 +2192,12 @@ void DrawTabArrow(Surface *surface, PRectangle rcTab, int ymid) {
 }
 
 LineLayout *Editor::RetrieveLineLayout(int lineNumber) {
-	int posLineStart = pdoc->LineStart(lineNumber);
-	int posLineEnd = pdoc->LineStart(lineNumber + 1);
+	Position posLineStart = pdoc->LineStart(lineNumber);
+	Position posLineEnd = pdoc->LineStart(lineNumber + 1);
 	PLATFORM_ASSERT(posLineEnd >= posLineStart);
 	int lineCaret = pdoc->LineFromPosition(sel.MainCaret());
 	return llc.Retrieve(lineNumber, lineCaret,
-	        posLineEnd - posLineStart, pdoc->GetStyleClock(),
+	        static_cast<int>(posLineEnd - posLineStart), pdoc->GetStyleClock(),
 	        LinesOnScreen() + 1, pdoc->LinesTotal());
 }
 
@@ -2142,6 +2294,8 @@ bool BadUTF(const char *s, int len, int &trailBytes) {
  * Fill in the LineLayout data for the given line.
  * Copy the given @a line and its styles from the document into local arrays.
  * Also determine the x position at which each character starts.
+ * Without a @a surface only text already in posCache can be measured and
+ * @a ll is left invalid when the line holds any other text.
  */
 void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayout *ll, int width) {
 	if (!ll)
@@ -2149,16 +2303,16 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 
 	PLATFORM_ASSERT(line < pdoc->LinesTotal());
 	PLATFORM_ASSERT(ll->chars != NULL);
-	int posLineStart = pdoc->LineStart(line);
-	int posLineEnd = pdoc->LineStart(line + 1);
+	Position posLineStart = pdoc->LineStart(line);
+	Position posLineEnd = pdoc->LineStart(line + 1);
 	// If the line is very long, limit the treatment to a length that should fit in the viewport
 	if (posLineEnd > (posLineStart + ll->maxLineLength)) {
 		posLineEnd = posLineStart + ll->maxLineLength;
 	}
 	if (ll->validity == LineLayout::llCheckTextAndStyle) {
-		int lineLength = posLineEnd - posLineStart;
+		int lineLength = static_cast<int>(posLineEnd - posLineStart);
 		if (!vstyle.viewEOL) {
-			int cid = posLineEnd - 1;
+			Position cid = posLineEnd - 1;
 			while ((cid > posLineStart) && IsEOLChar(pdoc->CharAt(cid))) {
 				cid--;
 				lineLength--;
@@ -2172,7 +2326,7 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 			char styleByte = 0;
 			int numCharsInLine = 0;
 			while (numCharsInLine < lineLength) {
-				int charInDoc = numCharsInLine + posLineStart;
+				Position charInDoc = numCharsInLine + posLineStart;
 				char chDoc = pdoc->CharAt(charInDoc);
 				styleByte = pdoc->StyleAt(charInDoc);
 				allSame = allSame &&
@@ -2190,7 +2344,12 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 					        (ll->chars[numCharsInLine] == static_cast<char>(toupper(chDoc)));
 				numCharsInLine++;
 			}
-			allSame = allSame && (ll->styles[numCharsInLine] == styleByte);	// For eolFilled
+//!			allSame = allSame && (ll->styles[numCharsInLine] == styleByte);	// For eolFilled
+//!-start-[LayoutCacheMemory]
+			// Same value as set when laid out: the style of the last character including line ends
+			styleByte = static_cast<char>(((posLineEnd > posLineStart) ? pdoc->StyleAt(posLineEnd - 1) : 0) & styleMask);
+			allSame = allSame && (ll->styles[numCharsInLine] == static_cast<unsigned char>(styleByte));	// For eolFilled
+//!-end-[LayoutCacheMemory]
 			if (allSame) {
 				ll->validity = LineLayout::llPositions;
 			} else {
@@ -2204,10 +2363,11 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 		ll->widthLine = LineLayout::wrapWidthInfinite;
 		ll->lines = 1;
 		if (vstyle.edgeState == EDGE_BACKGROUND) {
-			ll->edgeColumn = pdoc->FindColumn(line, theEdge);
-			if (ll->edgeColumn >= posLineStart) {
-				ll->edgeColumn -= posLineStart;
+			Position posEdge = pdoc->FindColumn(line, theEdge);
+			if (posEdge >= posLineStart) {
+				posEdge -= posLineStart;
 			}
+			ll->edgeColumn = static_cast<int>(posEdge);
 		} else {
 			ll->edgeColumn = -1;
 		}
@@ -2216,7 +2376,7 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 		const int styleMask = pdoc->stylingBitsMask;
 		ll->styleBitsSet = 0;
 		// Fill base line layout
-		const int lineLength = posLineEnd - posLineStart;
+		const int lineLength = static_cast<int>(posLineEnd - posLineStart);
 		pdoc->GetCharRange(ll->chars, posLineStart, lineLength);
 		pdoc->GetStyleRange(ll->styles, posLineStart, lineLength);
 		int numCharsBeforeEOL = lineLength;
@@ -2272,6 +2432,10 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 						if (ll->chars[charInLine] == '\t') {
 							ll->positions[charInLine + 1] = ((((static_cast<int>(startsegx) + 2) /
 							        tabWidth) + 1) * tabWidth) - startsegx;
+//!-start-[WrapThreads]
+						} else if (!surface) {
+							return;
+//!-end-[WrapThreads]
 						} else if (controlCharSymbol < 32) {
 							if (ctrlCharWidth[ll->chars[charInLine]] == 0) {
 								const char *ctrlChar = ControlCharacterString(ll->chars[charInLine]);
@@ -2287,6 +2451,8 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 						}
 						lastSegItalics = false;
 					} else if (isBadUTF) {
+						if (!surface) //!-add-[WrapThreads]
+							return; //!-add-[WrapThreads]
 						char hexits[4];
 						sprintf(hexits, "x%2X", ll->chars[charInLine] & 0xff);
 						ll->positions[charInLine + 1] =
@@ -2299,6 +2465,13 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 							ll->positions[charInLine + 1] = vstyle.styles[ll->styles[charInLine]].spaceWidth;
 						} else {
 							lastSegItalics = vstyle.styles[ll->styles[charInLine]].italic;
+//!-start-[WrapThreads]
+							if (!surface) {
+								if (!posCache.Retrieve(vstyle, ll->styles[charInLine], ll->chars + startseg,
+								        lenSeg, ll->positions + startseg + 1, pdoc)) //!-change-[SharedPositionCache]
+									return;
+							} else
+//!-end-[WrapThreads]
 							posCache.MeasureWidths(surface, vstyle, ll->styles[charInLine], ll->chars + startseg,
 							        lenSeg, ll->positions + startseg + 1, pdoc);
 						}
@@ -2363,13 +2536,13 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 					if (lastGoodBreak == lastLineStart) {
 						// Try moving to start of last character
 						if (p > 0) {
-							lastGoodBreak = pdoc->MovePositionOutsideChar(p + posLineStart, -1)
-							        - posLineStart;
+							lastGoodBreak = static_cast<int>(pdoc->MovePositionOutsideChar(p + posLineStart, -1)
+							        - posLineStart);
 						}
 						if (lastGoodBreak == lastLineStart) {
 							// Ensure at least one character on line.
-							lastGoodBreak = pdoc->MovePositionOutsideChar(lastGoodBreak + posLineStart + 1, 1)
-							        - posLineStart;
+							lastGoodBreak = static_cast<int>(pdoc->MovePositionOutsideChar(lastGoodBreak + posLineStart + 1, 1)
+							        - posLineStart);
 						}
 					}
 					lastLineStart = lastGoodBreak;
@@ -2383,9 +2556,9 @@ void Editor::LayoutLine(int line, Surface *surface, ViewStyle &vstyle, LineLayou
 				}
 				if (p > 0) {
 					if (wrapState == eWrapChar) {
-						lastGoodBreak = pdoc->MovePositionOutsideChar(p + posLineStart, -1)
-						        - posLineStart;
-						p = pdoc->MovePositionOutsideChar(p + 1 + posLineStart, 1) - posLineStart;
+						lastGoodBreak = static_cast<int>(pdoc->MovePositionOutsideChar(p + posLineStart, -1)
+						        - posLineStart);
+						p = static_cast<int>(pdoc->MovePositionOutsideChar(p + 1 + posLineStart, 1) - posLineStart);
 						continue;
 					} else if (ll->styles[p] != ll->styles[p - 1]) {
 						lastGoodBreak = p;
@@ -2520,7 +2693,7 @@ void Editor::DrawEOL(Surface *surface, ViewStyle &vsDraw, PRectangle rcLine, Lin
         bool overrideBackground, ColourDesired background,
         bool drawWrapMarkEnd, ColourDesired wrapColour) {
 
-	const int posLineStart = pdoc->LineStart(line);
+	const Position posLineStart = pdoc->LineStart(line);
 	const int styleMask = pdoc->stylingBitsMask;
 	PRectangle rcSegment = rcLine;
 
@@ -2559,7 +2732,7 @@ void Editor::DrawEOL(Surface *surface, ViewStyle &vsDraw, PRectangle rcLine, Lin
 		}
 	}
 
-	int posAfterLineEnd = pdoc->LineStart(line + 1);
+	Position posAfterLineEnd = pdoc->LineStart(line + 1);
 	int eolInSelection = (subLine == (ll->lines - 1)) ? sel.InSelectionForEOL(posAfterLineEnd) : 0;
 	int alpha = (eolInSelection == 1) ? vsDraw.selAlpha : vsDraw.selAdditionalAlpha;
 
@@ -2647,7 +2820,7 @@ void Editor::DrawEOL(Surface *surface, ViewStyle &vsDraw, PRectangle rcLine, Lin
 	}
 }
 
-void Editor::DrawIndicator(int indicNum, int startPos, int endPos, Surface *surface, ViewStyle &vsDraw,
+void Editor::DrawIndicator(int indicNum, Position startPos, Position endPos, Surface *surface, ViewStyle &vsDraw,
 		int xStart, PRectangle rcLine, LineLayout *ll, int subLine) {
 	const int subLineStart = ll->positions[ll->LineStart(subLine)];
 	PRectangle rcIndic(
@@ -2661,9 +2834,9 @@ void Editor::DrawIndicator(int indicNum, int startPos, int endPos, Surface *surf
 void Editor::DrawIndicators(Surface *surface, ViewStyle &vsDraw, int line, int xStart,
         PRectangle rcLine, LineLayout *ll, int subLine, int lineEnd, bool under) {
 	// Draw decorators
-	const int posLineStart = pdoc->LineStart(line);
+	const Position posLineStart = pdoc->LineStart(line);
 	const int lineStart = ll->LineStart(subLine);
-	const int posLineEnd = posLineStart + lineEnd;
+	const Position posLineEnd = posLineStart + lineEnd;
 
 	if (!under) {
 		// Draw indicators
@@ -2699,12 +2872,12 @@ void Editor::DrawIndicators(Surface *surface, ViewStyle &vsDraw, int line, int x
 
 	for (Decoration *deco = pdoc->decorations.root; deco; deco = deco->next) {
 		if (under == vsDraw.indicators[deco->indicator].under) {
-			int startPos = posLineStart + lineStart;
+			Position startPos = posLineStart + lineStart;
 			if (!deco->rs.ValueAt(startPos)) {
 				startPos = deco->rs.EndRun(startPos);
 			}
 			while ((startPos < posLineEnd) && (deco->rs.ValueAt(startPos))) {
-				int endPos = deco->rs.EndRun(startPos);
+				Position endPos = deco->rs.EndRun(startPos);
 				if (endPos > posLineEnd)
 					endPos = posLineEnd;
 				DrawIndicator(deco->indicator, startPos - posLineStart, endPos - posLineStart,
@@ -2721,13 +2894,13 @@ void Editor::DrawIndicators(Surface *surface, ViewStyle &vsDraw, int line, int x
 		if (under == vsDraw.indicators[braceIndicator].under) {
 			Range rangeLine(posLineStart + lineStart, posLineEnd);
 			if (rangeLine.ContainsCharacter(braces[0])) {
-				int braceOffset = braces[0] - posLineStart;
+				Position braceOffset = braces[0] - posLineStart;
 				if (braceOffset < ll->numCharsInLine) {
 					DrawIndicator(braceIndicator, braceOffset, braceOffset + 1, surface, vsDraw, xStart, rcLine, ll, subLine);
 				}
 			}
 			if (rangeLine.ContainsCharacter(braces[1])) {
-				int braceOffset = braces[1] - posLineStart;
+				Position braceOffset = braces[1] - posLineStart;
 				if (braceOffset < ll->numCharsInLine) {
 					DrawIndicator(braceIndicator, braceOffset, braceOffset + 1, surface, vsDraw, xStart, rcLine, ll, subLine);
 				}
@@ -2843,7 +3016,7 @@ void Editor::DrawLine(Surface *surface, ViewStyle &vsDraw, int line, int lineVis
 	bool inIndentation = subLine == 0;	// Do not handle indentation except on first subline.
 	int indentWidth = pdoc->IndentSize() * vsDraw.spaceWidth;
 
-	int posLineStart = pdoc->LineStart(line);
+	Position posLineStart = pdoc->LineStart(line);
 
 	int startseg = ll->LineStart(subLine);
 	int subLineStart = ll->positions[startseg];
@@ -2927,7 +3100,7 @@ void Editor::DrawLine(Surface *surface, ViewStyle &vsDraw, int line, int lineVis
 		startseg = next;
 		next = bfBack.Next();
 		int i = next - 1;
-		int iDoc = i + posLineStart;
+		Position iDoc = i + posLineStart;
 
 		rcSegment.left = ll->positions[startseg] + xStart - subLineStart;
 		rcSegment.right = ll->positions[i + 1] + xStart - subLineStart;
@@ -3022,7 +3195,7 @@ void Editor::DrawLine(Surface *surface, ViewStyle &vsDraw, int line, int lineVis
 		next = bfFore.Next();
 		int i = next - 1;
 
-		int iDoc = i + posLineStart;
+		Position iDoc = i + posLineStart;
 
 		rcSegment.left = ll->positions[startseg] + xStart - subLineStart;
 		rcSegment.right = ll->positions[i + 1] + xStart - subLineStart;
@@ -3272,18 +3445,18 @@ void Editor::DrawLine(Surface *surface, ViewStyle &vsDraw, int line, int lineVis
 }
 
 void Editor::DrawBlockCaret(Surface *surface, ViewStyle &vsDraw, LineLayout *ll, int subLine,
-							int xStart, int offset, int posCaret, PRectangle rcCaret, ColourDesired caretColour) {
+							int xStart, int offset, Position posCaret, PRectangle rcCaret, ColourDesired caretColour) {
 
 	int lineStart = ll->LineStart(subLine);
-	int posBefore = posCaret;
-	int posAfter = MovePositionOutsideChar(posCaret + 1, 1);
-	int numCharsToDraw = posAfter - posCaret;
+	Position posBefore = posCaret;
+	Position posAfter = MovePositionOutsideChar(posCaret + 1, 1);
+	int numCharsToDraw = static_cast<int>(posAfter - posCaret);
 
 	// Work out where the starting and ending offsets are. We need to
 	// see if the previous character shares horizontal space, such as a
 	// glyph / combining character. If so we'll need to draw that too.
 	int offsetFirstChar = offset;
-	int offsetLastChar = offset + (posAfter - posCaret);
+	int offsetLastChar = offset + static_cast<int>(posAfter - posCaret);
 	while ((offsetLastChar - numCharsToDraw) >= lineStart) {
 		if ((ll->positions[offsetLastChar] - ll->positions[offsetLastChar - numCharsToDraw]) > 0) {
 			// The char does not share horizontal space
@@ -3292,8 +3465,8 @@ void Editor::DrawBlockCaret(Surface *surface, ViewStyle &vsDraw, LineLayout *ll,
 		// Char shares horizontal space, update the numChars to draw
 		// Update posBefore to point to the prev char
 		posBefore = MovePositionOutsideChar(posBefore - 1, -1);
-		numCharsToDraw = posAfter - posBefore;
-		offsetFirstChar = offset - (posCaret - posBefore);
+		numCharsToDraw = static_cast<int>(posAfter - posBefore);
+		offsetFirstChar = offset - static_cast<int>(posCaret - posBefore);
 	}
 
 	// See if the next character shares horizontal space, if so we'll
@@ -3305,8 +3478,8 @@ void Editor::DrawBlockCaret(Surface *surface, ViewStyle &vsDraw, LineLayout *ll,
 		// to compare these two
 		posBefore = posAfter;
 		posAfter = MovePositionOutsideChar(posAfter + 1, 1);
-		offsetLastChar = offset + (posAfter - posCaret);
-		if ((ll->positions[offsetLastChar] - ll->positions[offsetLastChar - (posAfter - posBefore)]) > 0) {
+		offsetLastChar = offset + static_cast<int>(posAfter - posCaret);
+		if ((ll->positions[offsetLastChar] - ll->positions[offsetLastChar - static_cast<int>(posAfter - posBefore)]) > 0) {
 			// The char does not share horizontal space
 			break;
 		}
@@ -3405,15 +3578,15 @@ void Editor::DrawCarets(Surface *surface, ViewStyle &vsDraw, int lineDoc, int xS
 	bool drawDrag = posDrag.IsValid();
 	if (hideSelection && !drawDrag)
 		return;
-	const int posLineStart = pdoc->LineStart(lineDoc);
+	const Position posLineStart = pdoc->LineStart(lineDoc);
 	// For each selection draw
 	for (size_t r=0; (r<sel.Count()) || drawDrag; r++) {
 		const bool mainCaret = r == sel.Main();
 		const SelectionPosition posCaret = (drawDrag ? posDrag : sel.Range(r).caret);
-		const int offset = posCaret.Position() - posLineStart;
+		const Position offset = posCaret.Position() - posLineStart;
 		const int spaceWidth = static_cast<int>(vsDraw.styles[ll->EndLineStyle()].spaceWidth);
 		const int virtualOffset = posCaret.VirtualSpace() * spaceWidth;
-		if (ll->InLine(offset, subLine) && offset <= ll->numCharsBeforeEOL) {
+		if ((offset >= 0) && (offset <= ll->numCharsBeforeEOL) && ll->InLine(static_cast<int>(offset), subLine)) {
 			XYPOSITION xposCaret = ll->positions[offset] + virtualOffset - ll->positions[ll->LineStart(subLine)];
 			if (ll->wrapIndent != 0) {
 				int lineStart = ll->LineStart(subLine);
@@ -3471,7 +3644,7 @@ void Editor::DrawCarets(Surface *surface, ViewStyle &vsDraw, int lineDoc, int xS
 				}
 				ColourDesired caretColour = mainCaret ? vsDraw.caretcolour : vsDraw.additionalCaretColour;
 				if (drawBlockCaret) {
-					DrawBlockCaret(surface, vsDraw, ll, subLine, xStart, offset, posCaret.Position(), rcCaret, caretColour);
+					DrawBlockCaret(surface, vsDraw, ll, subLine, xStart, static_cast<int>(offset), posCaret.Position(), rcCaret, caretColour);
 				} else {
 					surface->FillRectangle(rcCaret, caretColour);
 				}
@@ -3808,7 +3981,7 @@ long Editor::FormatRange(bool draw, Sci_RangeToFormat *pfr) {
 	//Platform::DebugPrintf("Formatting lines=[%0d,%0d,%0d] top=%0d bottom=%0d line=%0d %0d\n",
 	//      linePrintStart, linePrintLast, linePrintMax, pfr->rc.top, pfr->rc.bottom, vsPrint.lineHeight,
 	//      surfaceMeasure->Height(vsPrint.styles[STYLE_LINENUMBER].font));
-	int endPosPrint = pdoc->Length();
+	Position endPosPrint = pdoc->Length();
 	if (linePrintLast < pdoc->LinesTotal())
 		endPosPrint = pdoc->LineStart(linePrintLast + 1);
 
@@ -3820,7 +3993,7 @@ long Editor::FormatRange(bool draw, Sci_RangeToFormat *pfr) {
 
 	int lineDoc = linePrintStart;
 
-	int nPrintPos = pfr->chrg.cpMin;
+	Position nPrintPos = pfr->chrg.cpMin;
 	int visibleLine = 0;
 	int widthPrint = pfr->rc.right - pfr->rc.left - vsPrint.fixedColumnWidth;
 	if (printWrapState == eWrapNone)
@@ -3851,7 +4024,7 @@ long Editor::FormatRange(bool draw, Sci_RangeToFormat *pfr) {
 		// to start printing from to ensure a particular position is on the first
 		// line of the page.
 		if (visibleLine == 0) {
-			int startWithinLine = nPrintPos - pdoc->LineStart(lineDoc);
+			Position startWithinLine = nPrintPos - pdoc->LineStart(lineDoc);
 			for (int iwl = 0; iwl < ll.lines - 1; iwl++) {
 				if (ll.LineStart(iwl) <= startWithinLine && ll.LineStart(iwl + 1) >= startWithinLine) {
 					visibleLine = -iwl;
@@ -3961,7 +4134,7 @@ void Editor::ChangeSize() {
 	}
 }
 
-int Editor::InsertSpace(int position, unsigned int spaces) {
+Position Editor::InsertSpace(Position position, unsigned int spaces) {
 	if (spaces > 0) {
 		std::string spaceText(spaces, ' ');
 		pdoc->InsertString(position, spaceText.c_str(), spaces);
@@ -4006,7 +4179,7 @@ void Editor::AddCharUTF(char *s, unsigned int len, bool treatAsDBCS) {
 			SelectionRange *currentSel = *rit;
 			if (!RangeContainsProtected(currentSel->Start().Position(),
 				currentSel->End().Position())) {
-				int positionInsert = currentSel->Start().Position();
+				Position positionInsert = currentSel->Start().Position();
 				if (!currentSel->Empty()) {
 					if (currentSel->Length()) {
 						pdoc->DeleteChars(positionInsert, currentSel->Length());
@@ -4109,7 +4282,7 @@ void Editor::InsertPaste(SelectionPosition selStart, const char *text, int len)
 		for (size_t r=0; r<sel.Count(); r++) {
 			if (!RangeContainsProtected(sel.Range(r).Start().Position(),
 				sel.Range(r).End().Position())) {
-				int positionInsert = sel.Range(r).Start().Position();
+				Position positionInsert = sel.Range(r).Start().Position();
 				if (!sel.Range(r).Empty()) {
 					if (sel.Range(r).Length()) {
 						pdoc->DeleteChars(positionInsert, sel.Range(r).Length());
@@ -4178,6 +4351,10 @@ void Editor::ClearDocumentStyle() {
 		}
 		deco = decoNext;
 	}
+//!-start-[BackgroundLexing]
+	if (pdoc->pli)
+		pdoc->pli->StopBackground();
+//!-end-[BackgroundLexing]
 	pdoc->StartStyling(0, '\377');
 	pdoc->SetStyleFor(pdoc->Length(), 0);
 	cs.ShowAll();
@@ -4285,7 +4462,7 @@ void Editor::SelectAll() {
 void Editor::Undo() {
 	if (pdoc->CanUndo()) {
 		InvalidateCaret();
-		int newPos = pdoc->Undo();
+		Position newPos = pdoc->Undo();
 		if (newPos >= 0)
 			SetEmptySelection(newPos);
 		EnsureCaretVisible();
@@ -4294,7 +4471,7 @@ void Editor::Undo() {
 
 void Editor::Redo() {
 	if (pdoc->CanRedo()) {
-		int newPos = pdoc->Redo();
+		Position newPos = pdoc->Redo();
 		if (newPos >= 0)
 			SetEmptySelection(newPos);
 		EnsureCaretVisible();
@@ -4360,14 +4537,14 @@ void Editor::SetCtrlID(int identifier) {
 	ctrlID = identifier; 
 }
 
-void Editor::NotifyStyleToNeeded(int endStyleNeeded) {
+void Editor::NotifyStyleToNeeded(Position endStyleNeeded) {
 	SCNotification scn = {0};
 	scn.nmhdr.code = SCN_STYLENEEDED;
 	scn.position = endStyleNeeded;
 	NotifyParent(scn);
 }
 
-void Editor::NotifyStyleNeeded(Document *, void *, int endStyleNeeded) {
+void Editor::NotifyStyleNeeded(Document *, void *, Position endStyleNeeded) {
 	NotifyStyleToNeeded(endStyleNeeded);
 }
 
@@ -4432,7 +4609,7 @@ void Editor::NotifyMouseButtonUp(Point pt, bool ctrl) {
 }
 //!-end-[OnMouseButtonUp]
 
-void Editor::NotifyHotSpotDoubleClicked(int position, bool shift, bool ctrl, bool alt) {
+void Editor::NotifyHotSpotDoubleClicked(Position position, bool shift, bool ctrl, bool alt) {
 	SCNotification scn = {0};
 	scn.nmhdr.code = SCN_HOTSPOTDOUBLECLICK;
 	scn.position = position;
@@ -4441,7 +4618,7 @@ void Editor::NotifyHotSpotDoubleClicked(int position, bool shift, bool ctrl, boo
 	NotifyParent(scn);
 }
 
-void Editor::NotifyHotSpotClicked(int position, bool shift, bool ctrl, bool alt) {
+void Editor::NotifyHotSpotClicked(Position position, bool shift, bool ctrl, bool alt) {
 	SCNotification scn = {0};
 	scn.nmhdr.code = SCN_HOTSPOTCLICK;
 	scn.position = position;
@@ -4450,7 +4627,7 @@ void Editor::NotifyHotSpotClicked(int position, bool shift, bool ctrl, bool alt)
 	NotifyParent(scn);
 }
 
-void Editor::NotifyHotSpotReleaseClick(int position, bool shift, bool ctrl, bool alt) {
+void Editor::NotifyHotSpotReleaseClick(Position position, bool shift, bool ctrl, bool alt) {
 	SCNotification scn = {0};
 	scn.nmhdr.code = SCN_HOTSPOTRELEASECLICK;
 	scn.position = position;
@@ -4472,7 +4649,7 @@ void Editor::NotifyPainted() {
 	NotifyParent(scn);
 }
 
-void Editor::NotifyIndicatorClick(bool click, int position, bool shift, bool ctrl, bool alt) {
+void Editor::NotifyIndicatorClick(bool click, Position position, bool shift, bool ctrl, bool alt) {
 	int mask = pdoc->decorations.AllOnFor(position);
 	if ((click && mask) || pdoc->decorations.clickNotified) {
 		SCNotification scn = {0};
@@ -4506,7 +4683,7 @@ bool Editor::NotifyMarginClick(Point pt, bool shift, bool ctrl, bool alt) {
 	}
 }
 
-void Editor::NotifyNeedShown(int pos, int len) {
+void Editor::NotifyNeedShown(Position pos, Position len) {
 	SCNotification scn = {0};
 	scn.nmhdr.code = SCN_NEEDSHOWN;
 	scn.position = pos;
@@ -4544,6 +4721,7 @@ void Editor::CheckModificationForWrap(DocModification mh) {
 	if (mh.modificationType & (SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT)) {
 		llc.Invalidate(LineLayout::llCheckTextAndStyle);
 		int lineDoc = pdoc->LineFromPosition(mh.position);
+		llc.MoveLines(lineDoc, mh.linesAdded); //!-add-[LayoutCacheMemory]
 		int lines = Platform::Maximum(0, mh.linesAdded);
 		if (wrapState != eWrapNone) {
 			NeedWrapping(lineDoc, lineDoc + lines + 1);
@@ -4554,7 +4732,7 @@ void Editor::CheckModificationForWrap(DocModification mh) {
 }
 
 // Move a position so it is still after the same character as before the insertion.
-static inline int MovePositionForInsertion(int position, int startInsertion, int length) {
+static inline Position MovePositionForInsertion(Position position, Position startInsertion, Position length) {
 	if (position > startInsertion) {
 		return position + length;
 	}
@@ -4563,9 +4741,9 @@ static inline int MovePositionForInsertion(int position, int startInsertion, int
 
 // Move a position so it is still after the same character as before the deletion if that
 // character is still present else after the previous surviving character.
-static inline int MovePositionForDeletion(int position, int startDeletion, int length) {
+static inline Position MovePositionForDeletion(Position position, Position startDeletion, Position length) {
 	if (position > startDeletion) {
-		int endDeletion = startDeletion + length;
+		Position endDeletion = startDeletion + length;
 		if (position > endDeletion) {
 			return position - length;
 		} else {
@@ -4612,6 +4790,13 @@ void Editor::NotifyModified(Document *, DocModification mh, void *) {
 		}
 		if (mh.modificationType & SC_MOD_CHANGESTYLE) {
 			llc.Invalidate(LineLayout::llCheckTextAndStyle);
+//!-start-[BackgroundLexing]
+			if ((wrapState != eWrapNone) && LexingInBackground()) {
+				// Lines were wrapped before being styled
+				NeedWrapping(pdoc->LineFromPosition(mh.position),
+					pdoc->LineFromPosition(mh.position + mh.length) + 1);
+			}
+//!-end-[BackgroundLexing]
 		}
 	} else {
 		// Move selection and brace highlights
@@ -4955,14 +5140,14 @@ void Editor::LineTranspose() {
 	int line = pdoc->LineFromPosition(sel.MainCaret());
 	if (line > 0) {
 		UndoGroup ug(pdoc);
-		int startPrev = pdoc->LineStart(line - 1);
-		int endPrev = pdoc->LineEnd(line - 1);
-		int start = pdoc->LineStart(line);
-		int end = pdoc->LineEnd(line);
+		Position startPrev = pdoc->LineStart(line - 1);
+		Position endPrev = pdoc->LineEnd(line - 1);
+		Position start = pdoc->LineStart(line);
+		Position end = pdoc->LineEnd(line);
 		char *line1 = CopyRange(startPrev, endPrev);
-		int len1 = endPrev - startPrev;
+		Position len1 = endPrev - startPrev;
 		char *line2 = CopyRange(start, end);
-		int len2 = end - start;
+		Position len2 = end - start;
 		pdoc->DeleteChars(start, len2);
 		pdoc->DeleteChars(startPrev, len1);
 		pdoc->InsertString(startPrev, line2, len2);
@@ -5080,7 +5265,8 @@ void Editor::CursorUpOrDown(int direction, Selection::selTypes selt) {
 }
 
 void Editor::ParaUpOrDown(int direction, Selection::selTypes selt) {
-	int lineDoc, savedPos = sel.MainCaret();
+	int lineDoc;
+	Position savedPos = sel.MainCaret();
 	do {
 		MovePositionTo(SelectionPosition(direction > 0 ? pdoc->ParaDown(sel.MainCaret()) : pdoc->ParaUp(sel.MainCaret())), selt);
 		lineDoc = pdoc->LineFromPosition(sel.MainCaret());
@@ -5095,16 +5281,16 @@ void Editor::ParaUpOrDown(int direction, Selection::selTypes selt) {
 	} while (!cs.GetVisible(lineDoc));
 }
 
-int Editor::StartEndDisplayLine(int pos, bool start) {
+Position Editor::StartEndDisplayLine(Position pos, bool start) {
 	RefreshStyleData();
 	int line = pdoc->LineFromPosition(pos);
 	AutoSurface surface(this);
 	AutoLineLayout ll(llc, RetrieveLineLayout(line));
-	int posRet = INVALID_POSITION;
+	Position posRet = INVALID_POSITION;
 	if (surface && ll) {
-		unsigned int posLineStart = pdoc->LineStart(line);
+		Position posLineStart = pdoc->LineStart(line);
 		LayoutLine(line, surface, vs, ll, wrapWidth);
-		int posInLine = pos - posLineStart;
+		Position posInLine = pos - posLineStart;
 		if (posInLine <= ll->maxLineLength) {
 			for (int subLine = 0; subLine < ll->lines; subLine++) {
 				if ((posInLine >= ll->LineStart(subLine)) && (posInLine <= ll->LineStart(subLine + 1))) {
@@ -5472,7 +5658,7 @@ int Editor::KeyCommand(unsigned int iMessage) {
 		}
 		break;
 	case SCI_DELWORDLEFT: {
-			int startWord = pdoc->NextWordStart(sel.MainCaret(), -1);
+			Position startWord = pdoc->NextWordStart(sel.MainCaret(), -1);
 			pdoc->DeleteChars(startWord, sel.MainCaret() - startWord);
 			sel.RangeMain().ClearVirtualSpace();
 			SetLastXChosen();
@@ -5483,7 +5669,7 @@ int Editor::KeyCommand(unsigned int iMessage) {
 			sel.RangeMain().caret = SelectionPosition(
 				InsertSpace(sel.RangeMain().caret.Position(), sel.RangeMain().caret.VirtualSpace()));
 			sel.RangeMain().anchor = sel.RangeMain().caret;
-			int endWord = pdoc->NextWordStart(sel.MainCaret(), 1);
+			Position endWord = pdoc->NextWordStart(sel.MainCaret(), 1);
 			pdoc->DeleteChars(sel.MainCaret(), endWord - sel.MainCaret());
 		}
 		break;
@@ -5491,13 +5677,13 @@ int Editor::KeyCommand(unsigned int iMessage) {
 			UndoGroup ug(pdoc);
 			sel.RangeMain().caret = SelectionPosition(
 				InsertSpace(sel.RangeMain().caret.Position(), sel.RangeMain().caret.VirtualSpace()));
-			int endWord = pdoc->NextWordEnd(sel.MainCaret(), 1);
+			Position endWord = pdoc->NextWordEnd(sel.MainCaret(), 1);
 			pdoc->DeleteChars(sel.MainCaret(), endWord - sel.MainCaret());
 		}
 		break;
 	case SCI_DELLINELEFT: {
 			int line = pdoc->LineFromPosition(sel.MainCaret());
-			int start = pdoc->LineStart(line);
+			Position start = pdoc->LineStart(line);
 			pdoc->DeleteChars(start, sel.MainCaret() - start);
 			sel.RangeMain().ClearVirtualSpace();
 			SetLastXChosen();
@@ -5505,7 +5691,7 @@ int Editor::KeyCommand(unsigned int iMessage) {
 		break;
 	case SCI_DELLINERIGHT: {
 			int line = pdoc->LineFromPosition(sel.MainCaret());
-			int end = pdoc->LineEnd(line);
+			Position end = pdoc->LineEnd(line);
 			pdoc->DeleteChars(sel.MainCaret(), end - sel.MainCaret());
 		}
 		break;
@@ -5519,8 +5705,8 @@ int Editor::KeyCommand(unsigned int iMessage) {
 	case SCI_LINECUT: {
 			int lineStart = pdoc->LineFromPosition(SelectionStart().Position());
 			int lineEnd = pdoc->LineFromPosition(SelectionEnd().Position());
-			int start = pdoc->LineStart(lineStart);
-			int end = pdoc->LineStart(lineEnd + 1);
+			Position start = pdoc->LineStart(lineStart);
+			Position end = pdoc->LineStart(lineEnd + 1);
 			SetSelection(start, end);
 			Cut();
 			SetLastXChosen();
@@ -5528,8 +5714,8 @@ int Editor::KeyCommand(unsigned int iMessage) {
 		break;
 	case SCI_LINEDELETE: {
 			int line = pdoc->LineFromPosition(sel.MainCaret());
-			int start = pdoc->LineStart(line);
-			int end = pdoc->LineStart(line + 1);
+			Position start = pdoc->LineStart(line);
+			Position end = pdoc->LineStart(line + 1);
 			pdoc->DeleteChars(start, end - start);
 		}
 		break;
@@ -5629,7 +5815,7 @@ int Editor::GetWhitespaceVisible() {
 void Editor::Indent(bool forwards) {
 	for (size_t r=0; r<sel.Count(); r++) {
 		int lineOfAnchor = pdoc->LineFromPosition(sel.Range(r).anchor.Position());
-		int caretPosition = sel.Range(r).caret.Position();
+		Position caretPosition = sel.Range(r).caret.Position();
 		int lineCurrentPos = pdoc->LineFromPosition(caretPosition);
 		if (lineOfAnchor == lineCurrentPos) {
 			if (forwards) {
@@ -5670,15 +5856,15 @@ void Editor::Indent(bool forwards) {
 							pdoc->tabInChars;
 					if (newColumn < 0)
 						newColumn = 0;
-					int newPos = caretPosition;
+					Position newPos = caretPosition;
 					while (pdoc->GetColumn(newPos) > newColumn)
 						newPos--;
 					sel.Range(r) = SelectionRange(newPos);
 				}
 			}
 		} else {	// Multiline
-			int anchorPosOnLine = sel.Range(r).anchor.Position() - pdoc->LineStart(lineOfAnchor);
-			int currentPosPosOnLine = caretPosition - pdoc->LineStart(lineCurrentPos);
+			Position anchorPosOnLine = sel.Range(r).anchor.Position() - pdoc->LineStart(lineOfAnchor);
+			Position currentPosPosOnLine = caretPosition - pdoc->LineStart(lineCurrentPos);
 			// Multiple lines selected so indent / dedent
 			int lineTopSel = Platform::Minimum(lineOfAnchor, lineCurrentPos);
 			int lineBottomSel = Platform::Maximum(lineOfAnchor, lineCurrentPos);
@@ -5732,15 +5918,15 @@ CaseFolder *Editor::CaseFolderForEncoding() {
  * Search of a text in the document, in the given range.
  * @return The position of the found text, -1 if not found.
  */
-long Editor::FindText(
+Position Editor::FindText(
     uptr_t wParam,		///< Search modes : @c SCFIND_MATCHCASE, @c SCFIND_WHOLEWORD,
     ///< @c SCFIND_WORDSTART, @c SCFIND_REGEXP or @c SCFIND_POSIX.
     sptr_t lParam) {	///< @c TextToFind structure: The text to search for in the given range.
 
 	Sci_TextToFind *ft = reinterpret_cast<Sci_TextToFind *>(lParam);
-	int lengthFound = istrlen(ft->lpstrText);
+	Position lengthFound = istrlen(ft->lpstrText);
 	std::auto_ptr<CaseFolder> pcf(CaseFolderForEncoding());
-	int pos = pdoc->FindText(ft->chrg.cpMin, ft->chrg.cpMax, ft->lpstrText,
+	Position pos = pdoc->FindText(ft->chrg.cpMin, ft->chrg.cpMax, ft->lpstrText,
 	        (wParam & SCFIND_MATCHCASE) != 0,
 	        (wParam & SCFIND_WHOLEWORD) != 0,
 	        (wParam & SCFIND_WORDSTART) != 0,
@@ -5775,7 +5961,7 @@ void Editor::SearchAnchor() {
  * Used for next text and previous text requests.
  * @return The position of the found text, -1 if not found.
  */
-long Editor::SearchText(
+Position Editor::SearchText(
     unsigned int iMessage,		///< Accepts both @c SCI_SEARCHNEXT and @c SCI_SEARCHPREV.
     uptr_t wParam,				///< Search modes : @c SCFIND_MATCHCASE, @c SCFIND_WHOLEWORD,
     ///< @c SCFIND_WORDSTART, @c SCFIND_REGEXP or @c SCFIND_POSIX.
@@ -5783,7 +5969,7 @@ long Editor::SearchText(
 
 	const char *txt = reinterpret_cast<char *>(lParam);
 	int pos;
-	int lengthFound = istrlen(txt);
+	Position lengthFound = istrlen(txt);
 	std::auto_ptr<CaseFolder> pcf(CaseFolderForEncoding());
 	if (iMessage == SCI_SEARCHNEXT) {
 		pos = pdoc->FindText(searchAnchor, pdoc->Length(), txt,
@@ -5832,11 +6018,11 @@ std::string Editor::CaseMapString(const std::string &s, int caseMapping) {
  * Search for text in the target range of the document.
  * @return The position of the found text, -1 if not found.
  */
-long Editor::SearchInTarget(const char *text, int length) {
-	int lengthFound = length;
+Position Editor::SearchInTarget(const char *text, Position length) {
+	Position lengthFound = length;
 
 	std::auto_ptr<CaseFolder> pcf(CaseFolderForEncoding());
-	int pos = pdoc->FindText(targetStart, targetEnd, text,
+	Position pos = pdoc->FindText(targetStart, targetEnd, text,
 	        (searchFlags & SCFIND_MATCHCASE) != 0,
 	        (searchFlags & SCFIND_WHOLEWORD) != 0,
 	        (searchFlags & SCFIND_WORDSTART) != 0,
@@ -5851,6 +6037,35 @@ long Editor::SearchInTarget(const char *text, int length) {
 	return pos;
 }
 
+//!-start-[ReplaceAll]
+/**
+ * Replace all matches inside the target as one undo action.
+ * The target is set to the text from the first replacement to the end of the last.
+ */
+int Editor::ReplaceAllInTarget(const char *search, Position lengthSearch, const char *replace, Position lengthReplace) {
+	if (lengthSearch == -1)
+		lengthSearch = istrlen(search);
+	if (lengthReplace == -1)
+		lengthReplace = istrlen(replace);
+	std::auto_ptr<CaseFolder> pcf(CaseFolderForEncoding());
+	Range replaced;
+	const int replacements = pdoc->ReplaceAll(targetStart, targetEnd, search, lengthSearch,
+		replace, lengthReplace,
+	        (searchFlags & SCFIND_MATCHCASE) != 0,
+	        (searchFlags & SCFIND_WHOLEWORD) != 0,
+	        (searchFlags & SCFIND_WORDSTART) != 0,
+	        (searchFlags & SCFIND_REGEXP) != 0,
+	        searchFlags,
+			pcf.get(),
+			&replaced);
+	if (replacements > 0) {
+		targetStart = replaced.start;
+		targetEnd = replaced.end;
+	}
+	return replacements;
+}
+//!-end-[ReplaceAll]
+
 void Editor::GoToLine(int lineNo) {
 	if (lineNo > pdoc->LinesTotal())
 		lineNo = pdoc->LinesTotal();
@@ -5869,10 +6084,10 @@ static bool Close(Point pt1, Point pt2) {
 	return true;
 }
 
-char *Editor::CopyRange(int start, int end) {
+char *Editor::CopyRange(Position start, Position end) {
 	char *text = 0;
 	if (start < end) {
-		int len = end - start;
+		Position len = end - start;
 		text = new char[len + 1];
 		for (int i = 0; i < len; i++) {
 			text[i] = pdoc->CharAt(start + i);
@@ -5886,8 +6101,8 @@ void Editor::CopySelectionRange(SelectionText *ss, bool allowLineCopy) {
 	if (sel.Empty()) {
 		if (allowLineCopy) {
 			int currentLine = pdoc->LineFromPosition(sel.MainCaret());
-			int start = pdoc->LineStart(currentLine);
-			int end = pdoc->LineEnd(currentLine);
+			Position start = pdoc->LineStart(currentLine);
+			Position end = pdoc->LineEnd(currentLine);
 
 			char *text = CopyRange(start, end);
 			size_t textLen = text ? strlen(text) : 0;
@@ -5922,7 +6137,7 @@ void Editor::CopySelectionRange(SelectionText *ss, bool allowLineCopy) {
 			std::sort(rangesInOrder.begin(), rangesInOrder.end());
 		for (size_t r=0; r<rangesInOrder.size(); r++) {
 			SelectionRange current = rangesInOrder[r];
-			for (int i = current.Start().Position();
+			for (Position i = current.Start().Position();
 			        i < current.End().Position();
 			        i++) {
 				text[j++] = pdoc->CharAt(i);
@@ -5942,11 +6157,11 @@ void Editor::CopySelectionRange(SelectionText *ss, bool allowLineCopy) {
 	}
 }
 
-void Editor::CopyRangeToClipboard(int start, int end) {
+void Editor::CopyRangeToClipboard(Position start, Position end) {
 	start = pdoc->ClampPositionIntoDocument(start);
 	end = pdoc->ClampPositionIntoDocument(end);
 	SelectionText selectedText;
-	selectedText.Set(CopyRange(start, end), end - start + 1,
+	selectedText.Set(CopyRange(start, end), static_cast<int>(end - start + 1),
 		pdoc->dbcsCodePage, vs.styles[STYLE_DEFAULT].characterSet, false, false);
 	CopyToClipboard(selectedText);
 }
@@ -6053,7 +6268,7 @@ void Editor::DropAt(SelectionPosition position, const char *value, bool moving,
 /**
  * @return true if given position is inside the selection,
  */
-bool Editor::PositionInSelection(int pos) {
+bool Editor::PositionInSelection(Position pos) {
 	pos = MovePositionOutsideChar(pos, sel.MainCaret() - pos);
 	for (size_t r=0; r<sel.Count(); r++) {
 		if (sel.Range(r).Contains(pos))
@@ -6109,8 +6324,8 @@ Window::Cursor Editor::GetMarginCursor(Point pt) {
 	return Window::cursorReverseArrow;
 }
 
-void Editor::LineSelection(int lineCurrentPos_, int lineAnchorPos_, bool wholeLine) {
-	int selCurrentPos, selAnchorPos;
+void Editor::LineSelection(Position lineCurrentPos_, Position lineAnchorPos_, bool wholeLine) {
+	Position selCurrentPos, selAnchorPos;
 	if (wholeLine) {
 		int lineCurrent_ = pdoc->LineFromPosition(lineCurrentPos_);
 		int lineAnchor_ = pdoc->LineFromPosition(lineAnchorPos_);
@@ -6142,7 +6357,7 @@ void Editor::LineSelection(int lineCurrentPos_, int lineAnchorPos_, bool wholeLi
 	SetSelection(selCurrentPos, selAnchorPos);
 }
 
-void Editor::WordSelection(int pos) {
+void Editor::WordSelection(Position pos) {
 	if (pos < wordSelectAnchorStartPos) {
 		// Extend backward to the word containing pos.
 		// Skip ExtendWordSelect if the line is empty or if pos is after the last character.
@@ -6238,13 +6453,13 @@ void Editor::ButtonDown(Point pt, unsigned int curTime, bool shift, bool ctrl, b
 		}
 
 		if (selectionType == selWord) {
-			int charPos = originalAnchorPos;
+			Position charPos = originalAnchorPos;
 			if (sel.MainCaret() == originalAnchorPos) {
 				charPos = PositionFromLocation(pt, false, true);
 				charPos = MovePositionOutsideChar(charPos, -1);
 			}
 
-			int startWord, endWord;
+			Position startWord, endWord;
 			if ((sel.MainCaret() >= originalAnchorPos) && !pdoc->IsLineEndPosition(charPos)) {
 				startWord = pdoc->ExtendWordSelect(pdoc->MovePositionOutsideChar(charPos + 1, 1), -1);
 				endWord = pdoc->ExtendWordSelect(charPos, 1);
@@ -6356,12 +6571,12 @@ void Editor::ButtonDown(Point pt, unsigned int curTime, bool shift, bool ctrl, b
 	if (notifyClick) NotifyClick(pt, shift, ctrl, alt); //!-add-[OnClick]
 }
 
-bool Editor::PositionIsHotspot(int position) {
+bool Editor::PositionIsHotspot(Position position) {
 	return vs.styles[pdoc->StyleAt(position) & pdoc->stylingBitsMask].hotspot;
 }
 
 bool Editor::PointIsHotspot(Point pt) {
-	int pos = PositionFromLocation(pt, true);
+	Position pos = PositionFromLocation(pt, true);
 	if (pos == INVALID_POSITION)
 		return false;
 	return PositionIsHotspot(pos);
@@ -6369,13 +6584,13 @@ bool Editor::PointIsHotspot(Point pt) {
 
 void Editor::SetHotSpotRange(Point *pt) {
 	if (pt) {
-		int pos = PositionFromLocation(*pt);
+		Position pos = PositionFromLocation(*pt);
 
 		// If we don't limit this to word characters then the
 		// range can encompass more than the run range and then
 		// the underline will not be drawn properly.
-		int hsStart_ = pdoc->ExtendStyleRange(pos, -1, vs.hotspotSingleLine);
-		int hsEnd_ = pdoc->ExtendStyleRange(pos, 1, vs.hotspotSingleLine);
+		Position hsStart_ = pdoc->ExtendStyleRange(pos, -1, vs.hotspotSingleLine);
+		Position hsEnd_ = pdoc->ExtendStyleRange(pos, 1, vs.hotspotSingleLine);
 
 		// Only invalidate the range if the hotspot range has changed...
 		if (hsStart_ != hsStart || hsEnd_ != hsEnd) {
@@ -6388,8 +6603,8 @@ void Editor::SetHotSpotRange(Point *pt) {
 		}
 	} else {
 		if (hsStart != -1) {
-			int hsStart_ = hsStart;
-			int hsEnd_ = hsEnd;
+			Position hsStart_ = hsStart;
+			Position hsEnd_ = hsEnd;
 			hsStart = -1;
 			hsEnd = -1;
 			InvalidateRange(hsStart_, hsEnd_);
@@ -6400,7 +6615,7 @@ void Editor::SetHotSpotRange(Point *pt) {
 	}
 }
 
-void Editor::GetHotSpotRange(int &hsStart_, int &hsEnd_) {
+void Editor::GetHotSpotRange(Position &hsStart_, Position &hsEnd_) {
 	hsStart_ = hsStart;
 	hsEnd_ = hsEnd;
 }
@@ -6638,12 +6853,16 @@ bool Editor::Idle() {
 			wrappingDone = true;
 	}
 
+//!-start-[BackgroundLexing]
+	bool lexingDone = !LexingInBackground() || !pdoc->pli->ColouriseBackground();
+//!-end-[BackgroundLexing]
+
 	// Add more idle things to do here, but make sure idleDone is
 	// set correctly before the function returns. returning
 	// false will stop calling this idle funtion until SetIdle() is
 	// called again.
 
-	idleDone = wrappingDone; // && thatDone && theOtherThingDone...
+	idleDone = wrappingDone && lexingDone; // && thatDone && theOtherThingDone... //!-change-[BackgroundLexing]
 
 	return !idleDone;
 }
@@ -6659,7 +6878,7 @@ void Editor::SetFocusState(bool focusState) {
 	}
 }
 
-int Editor::PositionAfterArea(PRectangle rcArea) {
+Position Editor::PositionAfterArea(PRectangle rcArea) {
 	// The start of the document line after the display line after the area
 	// This often means that the line after a modification is restyled which helps
 	// detect multiline comment additions and heals single line comments
@@ -6670,12 +6889,30 @@ int Editor::PositionAfterArea(PRectangle rcArea) {
 		return pdoc->Length();
 }
 
+//!-start-[BackgroundLexing]
+// Text further than this before the view is left to the background lexer.
+static const Position lexAheadDistance = 0x10000;
+//!-end-[BackgroundLexing]
+
 // Style to a position within the view. If this causes a change at end of last line then
 // affects later lines so style all the viewed text.
 void Editor::StyleToPositionInView(Position pos) {
-	int endWindow = PositionAfterArea(GetClientRectangle());
+	Position endWindow = PositionAfterArea(GetClientRectangle());
 	if (pos > endWindow)
 		pos = endWindow;
+//!-start-[BackgroundLexing]
+	if (LexingInBackground()) {
+		if (pdoc->GetEndStyled() < pdoc->Length())
+			SetIdle(true);
+		const Position startWindow = pdoc->LineStart(cs.DocFromDisplay(topLine));
+		if (pdoc->GetEndStyled() + lexAheadDistance < startWindow) {
+			// Styling is far behind the view so style just the view rather than
+			// everything up to it and leave the rest to the background lexer.
+			pdoc->pli->ColouriseAhead(startWindow, endWindow);
+			return;
+		}
+	}
+//!-end-[BackgroundLexing]
 	int styleAtEnd = pdoc->StyleAt(pos-1);
 	pdoc->EnsureStyledTo(pos);
 	if ((endWindow > pos) && (styleAtEnd != pdoc->StyleAt(pos-1))) {
@@ -6697,7 +6934,13 @@ void Editor::IdleStyling() {
 	styleNeeded.Reset();
 }
 
-void Editor::QueueStyling(int upTo) {
+//!-start-[BackgroundLexing]
+bool Editor::LexingInBackground() const {
+	return backgroundLexing && pdoc->pli && !pdoc->pli->UseContainerLexing();
+}
+//!-end-[BackgroundLexing]
+
+void Editor::QueueStyling(Position upTo) {
 	styleNeeded.NeedUpTo(upTo);
 }
 
@@ -6848,6 +7091,56 @@ void Editor::Expand(int &line, bool doExpand) {
 }
 
 void Editor::ToggleContraction(int line) {
+//!-start-[FoldBulk]
+	FoldLine(line, SC_FOLDACTION_TOGGLE);
+}
+
+// Level number beyond any level so all headers are expanded or contracted
+static const int levelAll = SC_FOLDLEVELNUMBERMASK + 1;
+
+/**
+ * Expand or contract the fold headers from lineStart to lineEnd with one change to the
+ * contraction state. Headers with a level number below levelExpand are expanded, those
+ * below levelContract are contracted and the others keep their state.
+ * The lines after lineStart are shown unless in a contracted fold.
+ */
+void Editor::FoldRange(int lineStart, int lineEnd, int levelExpand, int levelContract) {
+	if (lineEnd >= pdoc->LinesTotal())
+		lineEnd = pdoc->LinesTotal() - 1;
+	if ((lineStart < 0) || (lineEnd < lineStart))
+		return;
+	const int lines = lineEnd - lineStart + 1;
+	std::vector<char> visibleNew(lines);
+	std::vector<char> expandedNew(lines);
+	// The lines up to lineHiddenEnd are in a contracted fold
+	int lineHiddenEnd = lineStart - 1;
+	for (int line = lineStart; line <= lineEnd; line++) {
+		if ((line == lineStart) && (line > 0))
+			visibleNew[0] = cs.GetVisible(line);
+		else
+			visibleNew[line - lineStart] = line > lineHiddenEnd;
+		const int level = pdoc->GetLevel(line);
+		bool expanded = cs.GetExpanded(line);
+		if (level & SC_FOLDLEVELHEADERFLAG) {
+			const int levelNumber = level & SC_FOLDLEVELNUMBERMASK;
+			if (levelNumber < levelExpand)
+				expanded = true;
+			else if (levelNumber < levelContract)
+				expanded = false;
+			// A fold inside a contracted fold ends within it
+			if (!expanded && (line > lineHiddenEnd))
+				lineHiddenEnd = pdoc->GetLastChild(line, levelNumber);
+		}
+		expandedNew[line - lineStart] = expanded;
+	}
+	if (cs.SetFoldState(lineStart, lines, &visibleNew[0], &expandedNew[0])) {
+		SetScrollBars();
+		Redraw();
+	}
+}
+
+void Editor::FoldLine(int line, int action) {
+//!-end-[FoldBulk]
 	if (line >= 0) {
 		if ((pdoc->GetLevel(line) & SC_FOLDLEVELHEADERFLAG) == 0) {
 			line = pdoc->GetFoldParent(line);
@@ -6855,7 +7148,12 @@ void Editor::ToggleContraction(int line) {
 				return;
 		}
 
-		if (cs.GetExpanded(line)) {
+//!		if (cs.GetExpanded(line)) {
+//!-start-[FoldBulk]
+		if (action == SC_FOLDACTION_TOGGLE)
+			action = cs.GetExpanded(line) ? SC_FOLDACTION_CONTRACT : SC_FOLDACTION_EXPAND;
+		if (action == SC_FOLDACTION_CONTRACT) {
+//!-end-[FoldBulk]
 			int lineMaxSubord = pdoc->GetLastChild(line);
 			if (lineMaxSubord > line) {
 				cs.SetExpanded(line, 0);
@@ -6876,14 +7174,63 @@ void Editor::ToggleContraction(int line) {
 				EnsureLineVisible(line, false);
 				GoToLine(line);
 			}
-			cs.SetExpanded(line, 1);
-			Expand(line, true);
+//!-start-[FoldBulk]
+//!			cs.SetExpanded(line, 1);
+//!			Expand(line, true);
+			// Show the children except those in folds which stay contracted
+			const int levelChildren = (pdoc->GetLevel(line) & SC_FOLDLEVELNUMBERMASK) + 1;
+			FoldRange(line, pdoc->GetLastChild(line), levelChildren, levelChildren);
+//!-end-[FoldBulk]
 			SetScrollBars();
 			Redraw();
 		}
 	}
 }
 
+//!-start-[FoldBulk]
+/**
+ * Expand or contract a header and all the headers in its fold, using level instead of
+ * the level of the header to find the end of the fold.
+ */
+void Editor::FoldExpand(int line, int action, int level) {
+	if ((line < 0) || (line >= pdoc->LinesTotal()))
+		return;
+	if (action == SC_FOLDACTION_TOGGLE)
+		action = cs.GetExpanded(line) ? SC_FOLDACTION_CONTRACT : SC_FOLDACTION_EXPAND;
+	const bool expanding = action == SC_FOLDACTION_EXPAND;
+	if (cs.SetExpanded(line, expanding))
+		RedrawSelMargin();
+	const int lineMaxSubord = pdoc->GetLastChild(line, level & SC_FOLDLEVELNUMBERMASK);
+	FoldRange(line, lineMaxSubord, expanding ? levelAll : 0, levelAll);
+}
+
+void Editor::FoldAll(int action) {
+	pdoc->EnsureStyledTo(pdoc->Length());
+	const int maxLine = pdoc->LinesTotal();
+	bool expanding = action == SC_FOLDACTION_EXPAND;
+	if (action == SC_FOLDACTION_TOGGLE) {
+		// Discover current state from the first header
+		for (int lineSeek = 0; lineSeek < maxLine; lineSeek++) {
+			if (pdoc->GetLevel(lineSeek) & SC_FOLDLEVELHEADERFLAG) {
+				expanding = !cs.GetExpanded(lineSeek);
+				break;
+			}
+		}
+	}
+	if (expanding) {
+		FoldRange(0, maxLine - 1, levelAll, levelAll);
+	} else {
+		// Only the top level headers are contracted so the others keep their state
+		FoldRange(0, maxLine - 1, 0, SC_FOLDLEVELBASE + 1);
+	}
+}
+
+void Editor::FoldToLevel(int levels) {
+	pdoc->EnsureStyledTo(pdoc->Length());
+	FoldRange(0, pdoc->LinesTotal() - 1, SC_FOLDLEVELBASE + Platform::Maximum(levels, 0), levelAll);
+}
+//!-end-[FoldBulk]
+
 int Editor::ContractedFoldNext(int lineStart) {
 	for (int line = lineStart; line<pdoc->LinesTotal();) {
 		if (!cs.GetExpanded(line) && (pdoc->GetLevel(line) & SC_FOLDLEVELHEADERFLAG))
@@ -6949,7 +7296,7 @@ void Editor::EnsureLineVisible(int lineDoc, bool enforcePolicy) {
 int Editor::GetTag(char *tagValue, int tagNumber) {
 	char name[3] = "\\?";
 	const char *text = 0;
-	int length = 0;
+	Position length = 0;
 	if ((tagNumber >= 1) && (tagNumber <= 9)) {
 		name[1] = static_cast<char>(tagNumber + '0');
 		length = 2;
@@ -6961,10 +7308,10 @@ int Editor::GetTag(char *tagValue, int tagNumber) {
 		else
 			*tagValue = '\0';
 	}
-	return length;
+	return static_cast<int>(length);
 }
 
-int Editor::ReplaceTarget(bool replacePatterns, const char *text, int length) {
+Position Editor::ReplaceTarget(bool replacePatterns, const char *text, Position length) {
 	UndoGroup ug(pdoc);
 	if (length == -1)
 		length = istrlen(text);
@@ -7005,9 +7352,9 @@ int Editor::WrapCount(int line) {
 	}
 }
 
-void Editor::AddStyledText(char *buffer, int appendLength) {
+void Editor::AddStyledText(char *buffer, Position appendLength) {
 	// The buffer consists of alternating character bytes and style bytes
-	int textLength = appendLength / 2;
+	Position textLength = appendLength / 2;
 	char *text = new char[textLength];
 	int i;
 	for (i = 0; i < textLength; i++) {
@@ -7237,14 +7584,14 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		break;
 
 	case SCI_GETLINE: {	// Risk of overwriting the end of the buffer
-			int lineStart = pdoc->LineStart(wParam);
-			int lineEnd = pdoc->LineStart(wParam + 1);
+			Position lineStart = pdoc->LineStart(wParam);
+			Position lineEnd = pdoc->LineStart(wParam + 1);
 			if (lParam == 0) {
 				return lineEnd - lineStart;
 			}
 			char *ptr = CharPtrFromSPtr(lParam);
-			int iPlace = 0;
-			for (int iChar = lineStart; iChar < lineEnd; iChar++) {
+			Position iPlace = 0;
+			for (Position iChar = lineStart; iChar < lineEnd; iChar++) {
 				ptr[iPlace++] = pdoc->CharAt(iChar);
 			}
 			return iPlace;
@@ -7260,8 +7607,8 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		return !pdoc->IsSavePoint();
 
 	case SCI_SETSEL: {
-			int nStart = static_cast<int>(wParam);
-			int nEnd = static_cast<int>(lParam);
+			Position nStart = static_cast<Position>(wParam);
+			Position nEnd = static_cast<Position>(lParam);
 			if (nEnd < 0)
 				nEnd = pdoc->Length();
 			if (nStart < 0)
@@ -7363,6 +7710,14 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		PLATFORM_ASSERT(lParam);
 		return SearchInTarget(CharPtrFromSPtr(lParam), wParam);
 
+//!-start-[ReplaceAll]
+	case SCI_REPLACEALLINTARGET: {
+			PLATFORM_ASSERT(lParam);
+			const Sci_TextToReplace *ttr = reinterpret_cast<const Sci_TextToReplace *>(lParam);
+			return ReplaceAllInTarget(ttr->lpstrFind, ttr->lengthFind, ttr->lpstrReplace, ttr->lengthReplace);
+		}
+//!-end-[ReplaceAll]
+
 	case SCI_SETSEARCHFLAGS:
 		searchFlags = wParam;
 		break;
@@ -7435,11 +7790,11 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 			if (lParam == 0)
 				return 0;
 			Sci_TextRange *tr = reinterpret_cast<Sci_TextRange *>(lParam);
-			int cpMax = tr->chrg.cpMax;
+			Position cpMax = tr->chrg.cpMax;
 			if (cpMax == -1)
 				cpMax = pdoc->Length();
 			PLATFORM_ASSERT(cpMax <= pdoc->Length());
-			int len = cpMax - tr->chrg.cpMin; 	// No -1 as cpMin and cpMax are referring to inter character positions
+			Position len = cpMax - tr->chrg.cpMin; 	// No -1 as cpMin and cpMax are referring to inter character positions
 			pdoc->GetCharRange(tr->lpstrText, tr->chrg.cpMin, len);
 			// Spec says copied text is terminated with a NUL
 			tr->lpstrText[len] = '\0';
@@ -7488,10 +7843,10 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 	case SCI_INSERTTEXT: {
 			if (lParam == 0)
 				return 0;
-			int insertPos = wParam;
-			if (static_cast<int>(wParam) == -1)
+			Position insertPos = static_cast<Position>(wParam);
+			if (static_cast<Position>(wParam) == -1)
 				insertPos = CurrentPosition();
-			int newCurrent = CurrentPosition();
+			Position newCurrent = CurrentPosition();
 			char *sz = CharPtrFromSPtr(lParam);
 			pdoc->InsertCString(insertPos, sz);
 			if (newCurrent > insertPos)
@@ -7560,6 +7915,61 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		pdoc->Allocate(wParam);
 		break;
 
+//!-start-[BackgroundLexing]
+	case SCI_SETBACKGROUNDLEXING:
+		backgroundLexing = wParam != 0;
+		if (!backgroundLexing && pdoc->pli)
+			pdoc->pli->StopBackground();
+		Redraw();
+		break;
+
+	case SCI_GETBACKGROUNDLEXING:
+		return backgroundLexing;
+//!-end-[BackgroundLexing]
+
+//!-start-[WrapThreads]
+	case SCI_SETWRAPTHREADS:
+		wrapThreads = Platform::Clamp(static_cast<int>(wParam), 1, 64);
+		break;
+
+	case SCI_GETWRAPTHREADS:
+		return wrapThreads;
+//!-end-[WrapThreads]
+
+//!-start-[UndoArena]
+	case SCI_SETUNDOMEMORYLIMIT:
+		pdoc->SetUndoMemoryLimit(wParam);
+		break;
+
+	case SCI_GETUNDOMEMORYLIMIT:
+		return pdoc->GetUndoMemoryLimit();
+
+	case SCI_GETUNDOMEMORYUSE:
+		return pdoc->UndoMemoryUse();
+
+	case SCI_GETUNDOACTIONS:
+		return pdoc->UndoActions();
+//!-end-[UndoArena]
+
+//!-start-[PersistentUndo]
+	case SCI_SAVEUNDOHISTORY: {
+			Document *pdocSave = wParam ? reinterpret_cast<Document *>(wParam) : pdoc;
+			return pdocSave->SaveUndoHistory(CharPtrFromSPtr(lParam));
+		}
+
+	case SCI_LOADUNDOHISTORY:
+		return pdoc->LoadUndoHistory(CharPtrFromSPtr(lParam), wParam);
+//!-end-[PersistentUndo]
+
+//!-start-[ChunkedStorage]
+	case SCI_SETCHUNKSIZE:
+		pdoc->SetChunkSize(wParam);
+		break;
+
+	case SCI_GETCHUNKSIZE:
+		return pdoc->GetChunkSize();
+//!-end-[ChunkedStorage]
+
 	case SCI_GETCHARAT:
 		return pdoc->CharAt(wParam);
 
@@ -7590,14 +8000,14 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		return sel.IsRectangular() ? sel.Rectangular().anchor.Position() : sel.MainAnchor();
 
 	case SCI_SETSELECTIONSTART:
-		SetSelection(Platform::Maximum(sel.MainCaret(), wParam), wParam);
+		SetSelection(MaxPosition(sel.MainCaret(), wParam), wParam);
 		break;
 
 	case SCI_GETSELECTIONSTART:
 		return sel.LimitsForRectangularElseMain().start.Position();
 
 	case SCI_SETSELECTIONEND:
-		SetSelection(wParam, Platform::Minimum(sel.MainAnchor(), wParam));
+		SetSelection(wParam, MinPosition(sel.MainAnchor(), wParam));
 		break;
 
 	case SCI_GETSELECTIONEND:
@@ -7629,7 +8039,7 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		return printWrapState;
 
 	case SCI_GETSTYLEAT:
-		if (static_cast<int>(wParam) >= pdoc->Length())
+		if (static_cast<Position>(wParam) >= pdoc->Length())
 			return 0;
 		else
 			return pdoc->StyleAt(wParam);
@@ -7651,7 +8061,7 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 				return 0;
 			Sci_TextRange *tr = reinterpret_cast<Sci_TextRange *>(lParam);
 			int iPlace = 0;
-			for (int iChar = tr->chrg.cpMin; iChar < tr->chrg.cpMax; iChar++) {
+			for (Position iChar = tr->chrg.cpMin; iChar < tr->chrg.cpMax; iChar++) {
 				tr->lpstrText[iPlace++] = pdoc->CharAt(iChar);
 				tr->lpstrText[iPlace++] = pdoc->StyleAt(iChar);
 			}
@@ -7709,15 +8119,15 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 
 	case SCI_GETCURLINE: {
 			int lineCurrentPos = pdoc->LineFromPosition(sel.MainCaret());
-			int lineStart = pdoc->LineStart(lineCurrentPos);
-			unsigned int lineEnd = pdoc->LineStart(lineCurrentPos + 1);
+			Position lineStart = pdoc->LineStart(lineCurrentPos);
+			Position lineEnd = pdoc->LineStart(lineCurrentPos + 1);
 			if (lParam == 0) {
 				return 1 + lineEnd - lineStart;
 			}
 			PLATFORM_ASSERT(wParam > 0);
 			char *ptr = CharPtrFromSPtr(lParam);
-			unsigned int iPlace = 0;
-			for (unsigned int iChar = lineStart; iChar < lineEnd && iPlace < wParam - 1; iChar++) {
+			uptr_t iPlace = 0;
+			for (Position iChar = lineStart; iChar < lineEnd && iPlace < wParam - 1; iChar++) {
 				ptr[iPlace++] = pdoc->CharAt(iChar);
 			}
 			ptr[iPlace] = '\0';
@@ -7911,6 +8321,18 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 	case SCI_GETLAYOUTCACHE:
 		return llc.GetLevel();
 
+//!-start-[LayoutCacheMemory]
+	case SCI_SETLAYOUTCACHEMEMORY:
+		llc.SetMemory(wParam);
+		break;
+
+	case SCI_GETLAYOUTCACHEMEMORY:
+		return llc.GetMemory();
+
+	case SCI_GETLAYOUTCACHEMEMORYUSE:
+		return llc.MemoryUse();
+//!-end-[LayoutCacheMemory]
+
 	case SCI_SETPOSITIONCACHE:
 		posCache.SetSize(wParam);
 		break;
@@ -7918,6 +8340,21 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 	case SCI_GETPOSITIONCACHE:
 		return posCache.GetSize();
 
+//!-start-[SharedPositionCache]
+	case SCI_SETPOSITIONCACHEMEMORY:
+		PositionCache::SetMemory(wParam);
+		break;
+
+	case SCI_GETPOSITIONCACHEMEMORY:
+		return PositionCache::GetMemory();
+
+	case SCI_GETPOSITIONCACHEHITS:
+		return PositionCache::Hits();
+
+	case SCI_GETPOSITIONCACHEMISSES:
+		return PositionCache::Misses();
+//!-end-[SharedPositionCache]
+
 	case SCI_SETSCROLLWIDTH:
 		PLATFORM_ASSERT(wParam > 0);
 		if ((wParam > 0) && (wParam != static_cast<unsigned int >(scrollWidth))) {
@@ -8351,6 +8788,28 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		ToggleContraction(wParam);
 		break;
 
+//!-start-[FoldBulk]
+	case SCI_FOLDLINE:
+		FoldLine(wParam, lParam);
+		break;
+
+	case SCI_FOLDCHILDREN:
+		FoldExpand(wParam, lParam, pdoc->GetLevel(wParam));
+		break;
+
+	case SCI_EXPANDCHILDREN:
+		FoldExpand(wParam, SC_FOLDACTION_EXPAND, lParam);
+		break;
+
+	case SCI_FOLDALL:
+		FoldAll(wParam);
+		break;
+
+	case SCI_FOLDTOLEVEL:
+		FoldToLevel(wParam);
+		break;
+//!-end-[FoldBulk]
+
 	case SCI_CONTRACTEDFOLDNEXT:
 		return ContractedFoldNext(wParam);
 
@@ -8652,7 +9111,7 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		return KeyCommand(iMessage);
 
 	case SCI_BRACEHIGHLIGHT:
-		SetBraceHighlight(static_cast<int>(wParam), lParam, STYLE_BRACELIGHT);
+		SetBraceHighlight(static_cast<Position>(wParam), lParam, STYLE_BRACELIGHT);
 		break;
 
 	case SCI_BRACEHIGHLIGHTINDICATOR:
@@ -8663,7 +9122,7 @@ sptr_t Editor::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
 		break;
 
 	case SCI_BRACEBADLIGHT:
-		SetBraceHighlight(static_cast<int>(wParam), -1, STYLE_BRACEBAD);
+		SetBraceHighlight(static_cast<Position>(wParam), -1, STYLE_BRACEBAD);
 		break;
 
 	case SCI_BRACEBADLIGHTINDICATOR:
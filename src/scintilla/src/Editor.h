@@ -12,6 +12,8 @@
 namespace Scintilla {
 #endif
 
+class WrapBatch; //!-add-[WrapThreads]
+
 /**
  */
 class Caret {
@@ -203,18 +205,18 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	bool dropWentOutside;
 	SelectionPosition posDrag;
 	SelectionPosition posDrop;
-	int hotSpotClickPos;
+	Position hotSpotClickPos;
 	int lastXChosen;
-	int lineAnchorPos;
-	int originalAnchorPos;
-	int wordSelectAnchorStartPos;
-	int wordSelectAnchorEndPos;
-	int wordSelectInitialCaretPos;
-	int targetStart;
-	int targetEnd;
+	Position lineAnchorPos;
+	Position originalAnchorPos;
+	Position wordSelectAnchorStartPos;
+	Position wordSelectAnchorEndPos;
+	Position wordSelectInitialCaretPos;
+	Position targetStart;
+	Position targetEnd;
 	int searchFlags;
 	int topLine;
-	int posTopLine;
+	Position posTopLine;
 	int lengthForEncode;
 
 	int needUpdateUI;
@@ -229,6 +231,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	bool paintingAllText;
 	bool willRedrawAll;
 	StyleNeeded styleNeeded;
+	bool backgroundLexing; //!-add-[BackgroundLexing]
 
 	int modEventMask;
 
@@ -245,7 +248,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	int visiblePolicy;
 	int visibleSlop;
 
-	int searchAnchor;
+	Position searchAnchor;
 
 	bool recordingMacro;
 
@@ -253,8 +256,8 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	ContractionState cs;
 
 	// Hotspot support
-	int hsStart;
-	int hsEnd;
+	Position hsStart;
+	Position hsEnd;
 
 	// Wrapping support
 	enum { eWrapNone, eWrapWord, eWrapChar } wrapState;
@@ -267,6 +270,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	int wrapVisualStartIndent;
 	int wrapAddIndent; // This will be added to initial indent of line
 	int wrapIndentMode; // SC_WRAPINDENT_FIXED, _SAME, _INDENT
+	int wrapThreads; //!-add-[WrapThreads]
 
 	bool convertPastes;
 
@@ -291,13 +295,13 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	int MaxScrollPos();
 	SelectionPosition ClampPositionIntoDocument(SelectionPosition sp) const;
 	Point LocationFromPosition(SelectionPosition pos);
-	Point LocationFromPosition(int pos);
-	int XFromPosition(int pos);
+	Point LocationFromPosition(Position pos);
+	int XFromPosition(Position pos);
 	int XFromPosition(SelectionPosition sp);
 	SelectionPosition SPositionFromLocation(Point pt, bool canReturnInvalid=false, bool charPosition=false, bool virtualSpace=true);
-	int PositionFromLocation(Point pt, bool canReturnInvalid=false, bool charPosition=false);
+	Position PositionFromLocation(Point pt, bool canReturnInvalid=false, bool charPosition=false);
 	SelectionPosition SPositionFromLineX(int lineDoc, int x);
-	int PositionFromLineX(int line, int x);
+	Position PositionFromLineX(int line, int x);
 	int LineFromLocation(Point pt);
 	void SetTopLine(int topLineNew);
 
@@ -305,13 +309,13 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void RedrawRect(PRectangle rc);
 	void Redraw();
 	void RedrawSelMargin(int line=-1, bool allAfter=false);
-	PRectangle RectangleFromRange(int start, int end);
-	void InvalidateRange(int start, int end);
+	PRectangle RectangleFromRange(Position start, Position end);
+	void InvalidateRange(Position start, Position end);
 
 	bool UserVirtualSpace() const {
 		return ((virtualSpaceOptions & SCVS_USERACCESSIBLE) != 0);
 	}
-	int CurrentPosition();
+	Position CurrentPosition();
 	bool SelectionEmpty();
 	SelectionPosition SelectionStart();
 	SelectionPosition SelectionEnd();
@@ -319,19 +323,19 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void ThinRectangularRange();
 	void InvalidateSelection(SelectionRange newMain, bool invalidateWholeSelection=false);
 	void SetSelection(SelectionPosition currentPos_, SelectionPosition anchor_);
-	void SetSelection(int currentPos_, int anchor_);
+	void SetSelection(Position currentPos_, Position anchor_);
 	void SetSelection(SelectionPosition currentPos_);
-	void SetSelection(int currentPos_);
+	void SetSelection(Position currentPos_);
 	void SetEmptySelection(SelectionPosition currentPos_);
-	void SetEmptySelection(int currentPos_);
-	bool RangeContainsProtected(int start, int end) const;
+	void SetEmptySelection(Position currentPos_);
+	bool RangeContainsProtected(Position start, Position end) const;
 	bool SelectionContainsProtected();
-	int MovePositionOutsideChar(int pos, int moveDir, bool checkLineEnd=true) const;
-	SelectionPosition MovePositionOutsideChar(SelectionPosition pos, int moveDir, bool checkLineEnd=true) const;
-	int MovePositionTo(SelectionPosition newPos, Selection::selTypes sel=Selection::noSel, bool ensureVisible=true);
-	int MovePositionTo(int newPos, Selection::selTypes sel=Selection::noSel, bool ensureVisible=true);
+	Position MovePositionOutsideChar(Position pos, Position moveDir, bool checkLineEnd=true) const;
+	SelectionPosition MovePositionOutsideChar(SelectionPosition pos, Position moveDir, bool checkLineEnd=true) const;
+	Position MovePositionTo(SelectionPosition newPos, Selection::selTypes sel=Selection::noSel, bool ensureVisible=true);
+	Position MovePositionTo(Position newPos, Selection::selTypes sel=Selection::noSel, bool ensureVisible=true);
 	SelectionPosition MovePositionSoVisible(SelectionPosition pos, int moveDir);
-	SelectionPosition MovePositionSoVisible(int pos, int moveDir);
+	SelectionPosition MovePositionSoVisible(Position pos, int moveDir);
 	Point PointMainCaret();
 	void SetLastXChosen();
 
@@ -343,7 +347,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void MoveSelectedLinesUp();
 	void MoveSelectedLinesDown();
 	void MoveCaretInsideView(bool ensureVisible=true);
-	int DisplayFromPosition(int pos);
+	int DisplayFromPosition(Position pos);
 
 	struct XYScrollPosition {
 		int xOffset;
@@ -361,6 +365,11 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void NeedWrapping(int docLineStart = 0, int docLineEnd = wrapLineLarge);
 	bool WrapOneLine(Surface *surface, int lineToWrap);
 	bool WrapLines(bool fullWrap, int priorityWrapLineStart);
+//!-start-[WrapThreads]
+	static void WrapThread(void *pBatch);
+	void WrapBatchLines(WrapBatch &batch, Surface *surface);
+	bool WrapLinesOnThreads(Surface *surface, int &lineToWrap, int lastLineToWrap, int linesToMeasure);
+//!-end-[WrapThreads]
 	void LinesJoin();
 	void LinesSplit(int pixelWidth);
 
@@ -377,7 +386,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 		int line, int lineEnd, int xStart, int subLine, int subLineStart,
 		bool overrideBackground, ColourDesired background,
 		bool drawWrapMark, ColourDesired wrapColour);
-	void DrawIndicator(int indicNum, int startPos, int endPos, Surface *surface, ViewStyle &vsDraw,
+	void DrawIndicator(int indicNum, Position startPos, Position endPos, Surface *surface, ViewStyle &vsDraw,
 		int xStart, PRectangle rcLine, LineLayout *ll, int subLine);
 	void DrawIndicators(Surface *surface, ViewStyle &vsDraw, int line, int xStart,
 		PRectangle rcLine, LineLayout *ll, int subLine, int lineEnd, bool under);
@@ -386,7 +395,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void DrawLine(Surface *surface, ViewStyle &vsDraw, int line, int lineVisible, int xStart,
 		PRectangle rcLine, LineLayout *ll, int subLine);
 	void DrawBlockCaret(Surface *surface, ViewStyle &vsDraw, LineLayout *ll, int subLine,
-		int xStart, int offset, int posCaret, PRectangle rcCaret, ColourDesired caretColour);
+		int xStart, int offset, Position posCaret, PRectangle rcCaret, ColourDesired caretColour);
 	void DrawCarets(Surface *surface, ViewStyle &vsDraw, int line, int xStart,
 		PRectangle rcLine, LineLayout *ll, int subLine);
 	void RefreshPixMaps(Surface *surfaceWindow);
@@ -402,7 +411,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void ChangeSize();
 
 	void FilterSelections();
-	int InsertSpace(int position, unsigned int spaces);
+	Position InsertSpace(Position position, unsigned int spaces);
 	void AddChar(char ch);
 	virtual void AddCharUTF(char *s, unsigned int len, bool treatAsDBCS=false);
 	void InsertPaste(SelectionPosition selStart, const char *text, int len);
@@ -428,21 +437,21 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	virtual void SetCtrlID(int identifier);
 	virtual int GetCtrlID() { return ctrlID; }
 	virtual void NotifyParent(SCNotification scn) = 0;
-	virtual void NotifyStyleToNeeded(int endStyleNeeded);
+	virtual void NotifyStyleToNeeded(Position endStyleNeeded);
 	void NotifyChar(int ch);
 	void NotifySavePoint(bool isSavePoint);
 	void NotifyModifyAttempt();
 	virtual void NotifyDoubleClick(Point pt, bool shift, bool ctrl, bool alt);
 	void NotifyClick(Point pt, bool shift, bool ctrl, bool alt); //!-add-[OnClick]
 	void NotifyMouseButtonUp(Point pt, bool ctrl); //!-add-[OnMouseButtonUp]
-	void NotifyHotSpotClicked(int position, bool shift, bool ctrl, bool alt);
-	void NotifyHotSpotDoubleClicked(int position, bool shift, bool ctrl, bool alt);
-	void NotifyHotSpotReleaseClick(int position, bool shift, bool ctrl, bool alt);
+	void NotifyHotSpotClicked(Position position, bool shift, bool ctrl, bool alt);
+	void NotifyHotSpotDoubleClicked(Position position, bool shift, bool ctrl, bool alt);
+	void NotifyHotSpotReleaseClick(Position position, bool shift, bool ctrl, bool alt);
 	void NotifyUpdateUI();
 	void NotifyPainted();
-	void NotifyIndicatorClick(bool click, int position, bool shift, bool ctrl, bool alt);
+	void NotifyIndicatorClick(bool click, Position position, bool shift, bool ctrl, bool alt);
 	bool NotifyMarginClick(Point pt, bool shift, bool ctrl, bool alt);
-	void NotifyNeedShown(int pos, int len);
+	void NotifyNeedShown(Position pos, Position len);
 	void NotifyDwelling(Point pt, bool state);
 	void NotifyZoom();
 
@@ -451,7 +460,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void CheckModificationForWrap(DocModification mh);
 	void NotifyModified(Document *document, DocModification mh, void *userData);
 	void NotifyDeleted(Document *document, void *userData);
-	void NotifyStyleNeeded(Document *doc, void *userData, int endPos);
+	void NotifyStyleNeeded(Document *doc, void *userData, Position endPos);
 	void NotifyLexerChanged(Document *doc, void *userData);
 	void NotifyErrorOccurred(Document *doc, void *userData, int status);
 	void NotifyMacroRecord(unsigned int iMessage, uptr_t wParam, sptr_t lParam);
@@ -467,7 +476,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void NewLine();
 	void CursorUpOrDown(int direction, Selection::selTypes sel=Selection::noSel);
 	void ParaUpOrDown(int direction, Selection::selTypes sel=Selection::noSel);
-	int StartEndDisplayLine(int pos, bool start);
+	Position StartEndDisplayLine(Position pos, bool start);
 	virtual int KeyCommand(unsigned int iMessage);
 	virtual int KeyDefault(int /* key */, int /*modifiers*/);
 	int KeyDownWithModifiers(int key, int modifiers, bool *consumed);
@@ -479,16 +488,17 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void Indent(bool forwards);
 
 	virtual CaseFolder *CaseFolderForEncoding();
-	long FindText(uptr_t wParam, sptr_t lParam);
+	Position FindText(uptr_t wParam, sptr_t lParam);
 	void SearchAnchor();
-	long SearchText(unsigned int iMessage, uptr_t wParam, sptr_t lParam);
-	long SearchInTarget(const char *text, int length);
+	Position SearchText(unsigned int iMessage, uptr_t wParam, sptr_t lParam);
+	Position SearchInTarget(const char *text, Position length);
+	int ReplaceAllInTarget(const char *search, Position lengthSearch, const char *replace, Position lengthReplace); //!-add-[ReplaceAll]
 	void GoToLine(int lineNo);
 
 	virtual void CopyToClipboard(const SelectionText &selectedText) = 0;
-	char *CopyRange(int start, int end);
+	char *CopyRange(Position start, Position end);
 	void CopySelectionRange(SelectionText *ss, bool allowLineCopy=false);
-	void CopyRangeToClipboard(int start, int end);
+	void CopyRangeToClipboard(Position start, Position end);
 	void CopyText(int length, const char *text);
 	void SetDragPosition(SelectionPosition newPos);
 	virtual void DisplayCursor(Window::Cursor c);
@@ -496,12 +506,12 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	virtual void StartDrag();
 	void DropAt(SelectionPosition position, const char *value, bool moving, bool rectangular);
 	/** PositionInSelection returns true if position in selection. */
-	bool PositionInSelection(int pos);
+	bool PositionInSelection(Position pos);
 	bool PointInSelection(Point pt);
 	bool PointInSelMargin(Point pt);
 	Window::Cursor GetMarginCursor(Point pt);
-	void LineSelection(int lineCurrentPos_, int lineAnchorPos_, bool wholeLine);
-	void WordSelection(int pos);
+	void LineSelection(Position lineCurrentPos_, Position lineAnchorPos_, bool wholeLine);
+	void WordSelection(Position pos);
 	void DwellEnd(bool mouseMoved);
 	void MouseLeave();
 	virtual void ButtonDown(Point pt, unsigned int curTime, bool shift, bool ctrl, bool alt);
@@ -516,10 +526,11 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	virtual bool HaveMouseCapture() = 0;
 	void SetFocusState(bool focusState);
 
-	int PositionAfterArea(PRectangle rcArea);
+	Position PositionAfterArea(PRectangle rcArea);
 	void StyleToPositionInView(Position pos);
 	void IdleStyling();
-	virtual void QueueStyling(int upTo);
+	bool LexingInBackground() const; //!-add-[BackgroundLexing]
+	virtual void QueueStyling(Position upTo);
 
 	virtual bool PaintContains(PRectangle rc);
 	bool PaintContainsMargin();
@@ -533,20 +544,27 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 
 	void Expand(int &line, bool doExpand);
 	void ToggleContraction(int line);
+//!-start-[FoldBulk]
+	void FoldRange(int lineStart, int lineEnd, int levelExpand, int levelContract);
+	void FoldLine(int line, int action);
+	void FoldExpand(int line, int action, int level);
+	void FoldAll(int action);
+	void FoldToLevel(int levels);
+//!-end-[FoldBulk]
 	int ContractedFoldNext(int lineStart);
 	void EnsureLineVisible(int lineDoc, bool enforcePolicy);
 	int GetTag(char *tagValue, int tagNumber);
-	int ReplaceTarget(bool replacePatterns, const char *text, int length=-1);
+	Position ReplaceTarget(bool replacePatterns, const char *text, Position length=-1);
 
-	bool PositionIsHotspot(int position);
+	bool PositionIsHotspot(Position position);
 	bool PointIsHotspot(Point pt);
 	void SetHotSpotRange(Point *pt);
-	void GetHotSpotRange(int &hsStart, int &hsEnd);
+	void GetHotSpotRange(Position &hsStart, Position &hsEnd);
 
 	int CodePage() const;
 	virtual bool ValidCodePage(int /* codePage */) const { return true; }
 	int WrapCount(int line);
-	void AddStyledText(char *buffer, int appendLength);
+	void AddStyledText(char *buffer, Position appendLength);
 
 	virtual sptr_t DefWndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam) = 0;
 	void StyleSetMessage(unsigned int iMessage, uptr_t wParam, sptr_t lParam);
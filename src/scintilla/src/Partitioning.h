@@ -11,30 +11,33 @@
 /// A split vector of integers with a method for adding a value to all elements
 /// in a range.
 /// Used by the Partitioning class.
+/// T is the type of the values held: int for small ranges or Position when
+/// values may exceed 2**31.
 
-class SplitVectorWithRangeAdd : public SplitVector<int> {
+template <typename T>
+class SplitVectorWithRangeAdd : public SplitVector<T> {
 public:
 	SplitVectorWithRangeAdd(int growSize_) {
-		SetGrowSize(growSize_);
-		ReAllocate(growSize_);
+		this->SetGrowSize(growSize_);
+		this->ReAllocate(growSize_);
 	}
 	~SplitVectorWithRangeAdd() {
 	}
-	void RangeAddDelta(int start, int end, int delta) {
+	void RangeAddDelta(int start, int end, T delta) {
 		// end is 1 past end, so end-start is number of elements to change
 		int i = 0;
 		int rangeLength = end - start;
 		int range1Length = rangeLength;
-		int part1Left = part1Length - start;
+		int part1Left = static_cast<int>(this->part1Length) - start;
 		if (range1Length > part1Left)
 			range1Length = part1Left;
 		while (i < range1Length) {
-			body[start++] += delta;
+			this->body[start++] += delta;
 			i++;
 		}
-		start += gapLength;
+		start += static_cast<int>(this->gapLength);
 		while (i < rangeLength) {
-			body[start++] += delta;
+			this->body[start++] += delta;
 			i++;
 		}
 	}
@@ -46,14 +49,16 @@ public:
 /// If interval not 0 length then each partition non-zero length
 /// When needed, positions after the interval are considered part of the last partition
 /// but the end of the last partition can be found with PositionFromPartition(last+1).
+/// Partitions are always counted with int while T is the type of the positions.
 
+template <typename T>
 class Partitioning {
 private:
 	// To avoid calculating all the partition positions whenever any text is inserted
 	// there may be a step somewhere in the list.
 	int stepPartition;
-	int stepLength;
-	SplitVectorWithRangeAdd *body;
+	T stepLength;
+	SplitVectorWithRangeAdd<T> *body;
 
 	// Move step forward
 	void ApplyStep(int partitionUpTo) {
@@ -61,8 +66,8 @@ private:
 			body->RangeAddDelta(stepPartition+1, partitionUpTo + 1, stepLength);
 		}
 		stepPartition = partitionUpTo;
-		if (stepPartition >= body->Length()-1) {
-			stepPartition = body->Length()-1;
+		if (stepPartition >= Partitions()) {
+			stepPartition = Partitions();
 			stepLength = 0;
 		}
 	}
@@ -76,7 +81,7 @@ private:
 	}
 
 	void Allocate(int growSize) {
-		body = new SplitVectorWithRangeAdd(growSize);
+		body = new SplitVectorWithRangeAdd<T>(growSize);
 		stepPartition = 0;
 		stepLength = 0;
 		body->Insert(0, 0);	// This value stays 0 for ever
@@ -94,10 +99,10 @@ public:
 	}
 
 	int Partitions() const {
-		return body->Length()-1;
+		return static_cast<int>(body->Length())-1;
 	}
 
-	void InsertPartition(int partition, int pos) {
+	void InsertPartition(int partition, T pos) {
 		if (stepPartition < partition) {
 			ApplyStep(partition);
 		}
@@ -105,7 +110,7 @@ public:
 		stepPartition++;
 	}
 
-	void SetPartitionStartPosition(int partition, int pos) {
+	void SetPartitionStartPosition(int partition, T pos) {
 		ApplyStep(partition+1);
 		if ((partition < 0) || (partition > body->Length())) {
 			return;
@@ -113,19 +118,19 @@ public:
 		body->SetValueAt(partition, pos);
 	}
 
-	void InsertText(int partitionInsert, int delta) {
+	void InsertText(int partitionInsert, T delta) {
 		// Point all the partitions after the insertion point further along in the buffer
 		if (stepLength != 0) {
 			if (partitionInsert >= stepPartition) {
 				// Fill in up to the new insertion point
 				ApplyStep(partitionInsert);
 				stepLength += delta;
-			} else if (partitionInsert >= (stepPartition - body->Length() / 10)) {
+			} else if (partitionInsert >= (stepPartition - static_cast<int>(body->Length()) / 10)) {
 				// Close to step but before so move step back
 				BackStep(partitionInsert);
 				stepLength += delta;
 			} else {
-				ApplyStep(body->Length()-1);
+				ApplyStep(Partitions());
 				stepPartition = partitionInsert;
 				stepLength = delta;
 			}
@@ -145,29 +150,30 @@ public:
 		body->Delete(partition);
 	}
 
-	int PositionFromPartition(int partition) const {
+	T PositionFromPartition(int partition) const {
 		PLATFORM_ASSERT(partition >= 0);
 		PLATFORM_ASSERT(partition < body->Length());
 		if ((partition < 0) || (partition >= body->Length())) {
 			return 0;
 		}
-		int pos = body->ValueAt(partition);
+		T pos = body->ValueAt(partition);
 		if (partition > stepPartition)
 			pos += stepLength;
 		return pos;
 	}
 
 	/// Return value in range [0 .. Partitions() - 1] even for arguments outside interval
-	int PartitionFromPosition(int pos) const {
+	int PartitionFromPosition(T pos) const {
 		if (body->Length() <= 1)
 			return 0;
-		if (pos >= (PositionFromPartition(body->Length()-1)))
-			return body->Length() - 1 - 1;
+		const int lastPartition = Partitions();
+		if (pos >= (PositionFromPartition(lastPartition)))
+			return lastPartition - 1;
 		int lower = 0;
-		int upper = body->Length()-1;
+		int upper = lastPartition;
 		do {
 			int middle = (upper + lower + 1) / 2; 	// Round high
-			int posMiddle = body->ValueAt(middle);
+			T posMiddle = body->ValueAt(middle);
 			if (middle > stepPartition)
 				posMiddle += stepLength;
 			if (pos < posMiddle) {
@@ -180,7 +186,7 @@ public:
 	}
 
 	void DeleteAll() {
-		int growSize = body->GetGrowSize();
+		int growSize = static_cast<int>(body->GetGrowSize());
 		delete body;
 		Allocate(growSize);
 	}
@@ -10,8 +10,10 @@
 #include "Platform.h"
 
 #include "Scintilla.h"
+#include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "CellBuffer.h"
 #include "PerLine.h"
 
@@ -185,7 +187,7 @@ int LineMarkers::MarkValue(int line) {
 int LineMarkers::MarkerNext(int lineStart, int mask) const {
 	if (lineStart < 0)
 		lineStart = 0;
-	int length = markers.Length();
+	int length = static_cast<int>(markers.Length());
 	for (int iLine = lineStart; iLine < length; iLine++) {
 		MarkerHandleSet *onLine = markers[iLine];
 		if (onLine && ((onLine->MarkValue() & mask) != 0))
@@ -249,17 +251,213 @@ void LineMarkers::DeleteMarkFromHandle(int markerHandle) {
 	}
 }
 
+//!-start-[FoldIndex]
+// Greater than any level number so white lines and lines which are not headers never match
+static const unsigned short levelNone = 0xFFFF;
+
+LevelIndex::LevelIndex() : nodes(0), size(0), lengthBody(0), part1Length(0), gapLength(0) {
+}
+
+LevelIndex::~LevelIndex() {
+	Clear();
+}
+
+LevelIndex::Node LevelIndex::NodeFromLevel(int level) {
+	Node node;
+	node.level = (level & SC_FOLDLEVELWHITEFLAG) ?
+		levelNone : static_cast<unsigned short>(level & SC_FOLDLEVELNUMBERMASK);
+	node.header = (level & SC_FOLDLEVELHEADERFLAG) ?
+		static_cast<unsigned short>(level & SC_FOLDLEVELNUMBERMASK) : levelNone;
+	return node;
+}
+
+int LevelIndex::LineFromLeaf(int leaf) const {
+	int position = leaf - size;
+	return (position < part1Length) ? position : position - gapLength;
+}
+
+/// Recalculate the nodes above the leaves from leafStart up to leafEnd.
+void LevelIndex::Update(int leafStart, int leafEnd) {
+	if (leafStart >= leafEnd)
+		return;
+	int start = leafStart / 2;
+	int end = (leafEnd - 1) / 2;
+	while (start >= 1) {
+		for (int n = start; n <= end; n++) {
+			const Node &left = nodes[2 * n];
+			const Node &right = nodes[2 * n + 1];
+			nodes[n].level = (left.level < right.level) ? left.level : right.level;
+			nodes[n].header = (left.header < right.header) ? left.header : right.header;
+		}
+		start /= 2;
+		end /= 2;
+	}
+}
+
+/// Move the gap so it starts at position, only recalculating the nodes above the moved leaves.
+void LevelIndex::MoveGap(int position) {
+	Node none = { levelNone, levelNone };
+	if (position < part1Length) {
+		int moved = part1Length - position;
+		memmove(nodes + size + position + gapLength, nodes + size + position, sizeof(Node) * moved);
+		int endCleared = (moved < gapLength) ? part1Length : position + gapLength;
+		for (int leaf = size + position; leaf < size + endCleared; leaf++)
+			nodes[leaf] = none;
+		Update(size + position, size + endCleared);
+		Update(size + position + gapLength, size + part1Length + gapLength);
+	} else if (position > part1Length) {
+		int moved = position - part1Length;
+		memmove(nodes + size + part1Length, nodes + size + part1Length + gapLength, sizeof(Node) * moved);
+		int startCleared = (moved < gapLength) ? part1Length + gapLength : position;
+		for (int leaf = size + startCleared; leaf < size + position + gapLength; leaf++)
+			nodes[leaf] = none;
+		Update(size + part1Length, size + position);
+		Update(size + startCleared, size + position + gapLength);
+	}
+	part1Length = position;
+}
+
+/// Double the number of leaves, leaving the gap at the end.
+void LevelIndex::Grow() {
+	int sizeNew = size * 2;
+	Node *nodesNew = new Node[sizeNew * 2];
+	for (int line = 0; line < lengthBody; line++)
+		nodesNew[sizeNew + line] = nodes[Leaf(line)];
+	Node none = { levelNone, levelNone };
+	for (int leaf = sizeNew + lengthBody; leaf < sizeNew * 2; leaf++)
+		nodesNew[leaf] = none;
+	delete []nodes;
+	nodes = nodesNew;
+	size = sizeNew;
+	part1Length = lengthBody;
+	gapLength = size - lengthBody;
+	Update(size, size * 2);
+}
+
+void LevelIndex::Build(SplitVector<int> &levels) {
+	Clear();
+	lengthBody = levels.Length();
+	size = 2;
+	while (size <= lengthBody)
+		size *= 2;
+	nodes = new Node[size * 2];
+	for (int line = 0; line < lengthBody; line++)
+		nodes[size + line] = NodeFromLevel(levels.ValueAt(line));
+	Node none = { levelNone, levelNone };
+	for (int leaf = size + lengthBody; leaf < size * 2; leaf++)
+		nodes[leaf] = none;
+	part1Length = lengthBody;
+	gapLength = size - lengthBody;
+	Update(size, size * 2);
+}
+
+void LevelIndex::Clear() {
+	delete []nodes;
+	nodes = 0;
+	size = 0;
+	lengthBody = 0;
+	part1Length = 0;
+	gapLength = 0;
+}
+
+void LevelIndex::SetLevel(int line, int level) {
+	if ((line >= 0) && (line < lengthBody)) {
+		int leaf = Leaf(line);
+		Node node = NodeFromLevel(level);
+		if ((nodes[leaf].level != node.level) || (nodes[leaf].header != node.header)) {
+			nodes[leaf] = node;
+			Update(leaf, leaf + 1);
+		}
+	}
+}
+
+void LevelIndex::InsertLine(int line, int level) {
+	if ((line >= 0) && (line <= lengthBody)) {
+		if (gapLength == 0)
+			Grow();
+		MoveGap(line);
+		nodes[size + line] = NodeFromLevel(level);
+		part1Length++;
+		gapLength--;
+		lengthBody++;
+		Update(size + line, size + line + 1);
+	}
+}
+
+void LevelIndex::RemoveLine(int line) {
+	if ((line >= 0) && (line < lengthBody)) {
+		MoveGap(line);
+		int leaf = size + line + gapLength;
+		nodes[leaf].level = levelNone;
+		nodes[leaf].header = levelNone;
+		Update(leaf, leaf + 1);
+		gapLength++;
+		lengthBody--;
+	}
+}
+
+int LevelIndex::FirstNotAbove(int lineStart, int lineEnd, int level) const {
+	if (lineStart < 0)
+		lineStart = 0;
+	if ((lineStart >= lineEnd) || (lineStart >= lengthBody))
+		return -1;
+	// Climb while the nodes to the right of the start have no match then descend to it
+	int node = Leaf(lineStart);
+	while (nodes[node].level > level) {
+		while (node & 1) {
+			if (node == 1)
+				return -1;
+			node /= 2;
+		}
+		node++;
+	}
+	while (node < size) {
+		node *= 2;
+		if (nodes[node].level > level)
+			node++;
+	}
+	int line = LineFromLeaf(node);
+	return (line < lineEnd) ? line : -1;
+}
+
+int LevelIndex::LastHeaderBelow(int line, int level) const {
+	if (line > lengthBody)
+		line = lengthBody;
+	if (line <= 0)
+		return -1;
+	int node = Leaf(line - 1);
+	while (nodes[node].header >= level) {
+		while (!(node & 1))
+			node /= 2;
+		if (node == 1)
+			return -1;
+		node--;
+	}
+	while (node < size) {
+		node = node * 2 + 1;
+		if (nodes[node].header >= level)
+			node--;
+	}
+	return LineFromLeaf(node);
+}
+//!-end-[FoldIndex]
+
 LineLevels::~LineLevels() {
 }
 
 void LineLevels::Init() {
 	levels.DeleteAll();
+	index.Clear();	//!-add-[FoldIndex]
 }
 
 void LineLevels::InsertLine(int line) {
 	if (levels.Length()) {
 		int level = (line < levels.Length()) ? levels[line] : SC_FOLDLEVELBASE;
 		levels.InsertValue(line, 1, level);
+//!-start-[FoldIndex]
+		if (index.Built())
+			index.InsertLine(line, level);
+//!-end-[FoldIndex]
 	}
 }
 
@@ -273,15 +471,24 @@ void LineLevels::RemoveLine(int line) {
 			levels[line-1] &= ~SC_FOLDLEVELHEADERFLAG;
 		else if (line > 0)
 			levels[line-1] |= firstHeader;
+//!-start-[FoldIndex]
+		if (index.Built()) {
+			index.RemoveLine(line);
+			if (line > 0)
+				index.SetLevel(line-1, levels[line-1]);
+		}
+//!-end-[FoldIndex]
 	}
 }
 
 void LineLevels::ExpandLevels(int sizeNew) {
 	levels.InsertValue(levels.Length(), sizeNew - levels.Length(), SC_FOLDLEVELBASE);
+	index.Clear();	//!-add-[FoldIndex]
 }
 
 void LineLevels::ClearLevels() {
 	levels.DeleteAll();
+	index.Clear();	//!-add-[FoldIndex]
 }
 
 int LineLevels::SetLevel(int line, int level, int lines) {
@@ -293,6 +500,10 @@ int LineLevels::SetLevel(int line, int level, int lines) {
 		prev = levels[line];
 		if (prev != level) {
 			levels[line] = level;
+//!-start-[FoldIndex]
+			if (index.Built())
+				index.SetLevel(line, level);
+//!-end-[FoldIndex]
 		}
 	}
 	return prev;
@@ -306,6 +517,33 @@ int LineLevels::GetLevel(int line) {
 	}
 }
 
+//!-start-[FoldIndex]
+int LineLevels::FirstNotAbove(int lineStart, int lineEnd, int level) {
+	int line = -1;
+	if (levels.Length()) {
+		// The index is only built once it is wanted and then kept up to date
+		if (!index.Built())
+			index.Build(levels);
+		line = index.FirstNotAbove(lineStart, lineEnd, level);
+	}
+	if ((line == -1) && (SC_FOLDLEVELBASE <= level)) {
+		// Lines without levels have the base level
+		int lineBase = (lineStart > levels.Length()) ? lineStart : levels.Length();
+		if (lineBase < lineEnd)
+			line = lineBase;
+	}
+	return line;
+}
+
+int LineLevels::LastHeaderBelow(int line, int level) {
+	if (!levels.Length())
+		return -1;
+	if (!index.Built())
+		index.Build(levels);
+	return index.LastHeaderBelow(line, level);
+}
+//!-end-[FoldIndex]
+
 LineState::~LineState() {
 }
 
@@ -342,7 +580,7 @@ int LineState::GetLineState(int line) {
 }
 
 int LineState::GetMaxLineState() {
-	return lineStates.Length();
+	return static_cast<int>(lineStates.Length());
 }
 
 static int NumberLines(const char *text) {
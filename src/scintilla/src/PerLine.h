@@ -62,8 +62,60 @@ public:
 	int LineFromHandle(int markerHandle);
 };
 
+//!-start-[FoldIndex]
+/**
+ * The least fold levels of ranges of lines as a binary tree over the lines so the end
+ * of a fold and the header containing a line are found without walking line by line.
+ * Like SplitVector, the leaves have a gap where lines were last inserted or removed so
+ * changes near each other are cheap.
+ */
+class LevelIndex {
+	/// The least level number of the non-white lines and of the header lines below a node.
+	struct Node {
+		unsigned short level;
+		unsigned short header;
+	};
+	Node *nodes;	///< Root at 1, children of n at 2n and 2n+1, leaves from size
+	int size;	///< Number of leaves, a power of 2
+	int lengthBody;
+	int part1Length;
+	int gapLength;
+
+	static Node NodeFromLevel(int level);
+	int Leaf(int line) const {
+		return size + ((line < part1Length) ? line : line + gapLength);
+	}
+	int LineFromLeaf(int leaf) const;
+	void Update(int leafStart, int leafEnd);
+	void MoveGap(int position);
+	void Grow();
+
+	// Private so LevelIndex objects can not be copied
+	LevelIndex(const LevelIndex &);
+	void operator=(const LevelIndex &);
+
+public:
+	LevelIndex();
+	~LevelIndex();
+	bool Built() const {
+		return nodes != 0;
+	}
+	void Build(SplitVector<int> &levels);
+	void Clear();
+	void SetLevel(int line, int level);
+	void InsertLine(int line, int level);
+	void RemoveLine(int line);
+	/// First line from lineStart before lineEnd which is not white and has a level number
+	/// no greater than level, or -1.
+	int FirstNotAbove(int lineStart, int lineEnd, int level) const;
+	/// Last header line before line with a level number less than level, or -1.
+	int LastHeaderBelow(int line, int level) const;
+};
+//!-end-[FoldIndex]
+
 class LineLevels : public PerLine {
 	SplitVector<int> levels;
+	LevelIndex index;	//!-add-[FoldIndex]
 public:
 	virtual ~LineLevels();
 	virtual void Init();
@@ -74,6 +126,10 @@ public:
 	void ClearLevels();
 	int SetLevel(int line, int level, int lines);
 	int GetLevel(int line);
+//!-start-[FoldIndex]
+	int FirstNotAbove(int lineStart, int lineEnd, int level);
+	int LastHeaderBelow(int line, int level);
+//!-end-[FoldIndex]
 };
 
 class LineState : public PerLine {
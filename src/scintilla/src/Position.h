@@ -0,0 +1,45 @@
+// Scintilla source code edit control
+/** @file Position.h
+ ** Defines the Position type used inside Scintilla.
+ **/
+// Copyright 1998-2012 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#ifdef SCI_NAMESPACE
+namespace Scintilla {
+#endif
+
+/**
+ * A Position is a position within a document between two characters or at the beginning or end.
+ * Sometimes used as a character index where it identifies the character after the position.
+ * It is as wide as a pointer so that documents larger than 2 GB can be handled on 64-bit platforms.
+ */
+typedef Sci_Position Position;
+const Position invalidPosition = -1;
+
+/// Versions of Platform::Minimum, Platform::Maximum and Platform::Clamp for
+/// positions as those only handle int.
+inline Position MinPosition(Position a, Position b) {
+	return (a < b) ? a : b;
+}
+
+inline Position MaxPosition(Position a, Position b) {
+	return (a > b) ? a : b;
+}
+
+inline Position ClampPosition(Position pos, Position minPos, Position maxPos) {
+	if (pos > maxPos)
+		pos = maxPos;
+	if (pos < minPos)
+		pos = minPos;
+	return pos;
+}
+
+#ifdef SCI_NAMESPACE
+}
+#endif
+
+#endif
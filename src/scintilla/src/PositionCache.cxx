@@ -17,9 +17,11 @@
 #include "Platform.h"
 
 #include "Scintilla.h"
+#include "Position.h"
 
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -102,6 +104,7 @@ void LineLayout::Free() {
 	positions = 0;
 	delete []lineStarts;
 	lineStarts = 0;
+	lenLineStarts = 0; //!-add-[WrapThreads]
 }
 
 void LineLayout::Invalidate(validLevel validity_) {
@@ -154,14 +157,14 @@ void LineLayout::SetLineStart(int line, int start) {
 void LineLayout::SetBracesHighlight(Range rangeLine, Position braces[],
                                     char bracesMatchStyle, int xHighlight, bool ignoreStyle) {
 	if (!ignoreStyle && rangeLine.ContainsCharacter(braces[0])) {
-		int braceOffset = braces[0] - rangeLine.start;
+		Position braceOffset = braces[0] - rangeLine.start;
 		if (braceOffset < numCharsInLine) {
 			bracePreviousStyles[0] = styles[braceOffset];
 			styles[braceOffset] = bracesMatchStyle;
 		}
 	}
 	if (!ignoreStyle && rangeLine.ContainsCharacter(braces[1])) {
-		int braceOffset = braces[1] - rangeLine.start;
+		Position braceOffset = braces[1] - rangeLine.start;
 		if (braceOffset < numCharsInLine) {
 			bracePreviousStyles[1] = styles[braceOffset];
 			styles[braceOffset] = bracesMatchStyle;
@@ -175,13 +178,13 @@ void LineLayout::SetBracesHighlight(Range rangeLine, Position braces[],
 
 void LineLayout::RestoreBracesHighlight(Range rangeLine, Position braces[], bool ignoreStyle) {
 	if (!ignoreStyle && rangeLine.ContainsCharacter(braces[0])) {
-		int braceOffset = braces[0] - rangeLine.start;
+		Position braceOffset = braces[0] - rangeLine.start;
 		if (braceOffset < numCharsInLine) {
 			styles[braceOffset] = bracePreviousStyles[0];
 		}
 	}
 	if (!ignoreStyle && rangeLine.ContainsCharacter(braces[1])) {
-		int braceOffset = braces[1] - rangeLine.start;
+		Position braceOffset = braces[1] - rangeLine.start;
 		if (braceOffset < numCharsInLine) {
 			styles[braceOffset] = bracePreviousStyles[1];
 		}
@@ -206,14 +209,270 @@ int LineLayout::EndLineStyle() const {
 	return styles[numCharsBeforeEOL > 0 ? numCharsBeforeEOL-1 : 0];
 }
 
+//!-start-[LayoutCacheMemory]
+struct CompactStyleRun {
+	int length;
+	unsigned char style;
+	char indicators;
+};
+
+/// A run of positions each delta after the one before or, when count is 0, a position of delta.
+struct CompactPositionRun {
+	XYPOSITION delta;
+	int count;
+};
+
+/**
+ * The layout of a line not on screen. Styles and positions are run length encoded and are
+ * followed by the text so the layout can be checked against the document when it is needed
+ * again. The arrays are allocated after the struct.
+ */
+struct CompactLineLayout {
+	CompactLineLayout *newer;
+	CompactLineLayout *older;
+	int lineNumber;
+	int numCharsInLine;
+	int numCharsBeforeEOL;
+	int styleBitsSet;
+	int edgeColumn;
+	int styleRuns;
+	int positionRuns;
+
+	static size_t Bytes(int styleRuns_, int positionRuns_, int numCharsInLine_) {
+		return sizeof(CompactLineLayout) + styleRuns_ * sizeof(CompactStyleRun) +
+			positionRuns_ * sizeof(CompactPositionRun) + numCharsInLine_ + 1;
+	}
+	size_t Bytes() const {
+		return Bytes(styleRuns, positionRuns, numCharsInLine);
+	}
+	CompactStyleRun *StyleRuns() {
+		return reinterpret_cast<CompactStyleRun *>(this + 1);
+	}
+	CompactPositionRun *PositionRuns() {
+		return reinterpret_cast<CompactPositionRun *>(StyleRuns() + styleRuns);
+	}
+	char *Chars() {
+		return reinterpret_cast<char *>(PositionRuns() + positionRuns);
+	}
+};
+
+/**
+ * Compact layouts of lines, found by line number. The least recently stored are
+ * dropped when they take more than the memory budget.
+ */
+class LineLayoutStore {
+	typedef std::map<int, CompactLineLayout *> LineMap;
+	LineMap lines;
+	CompactLineLayout *newest;
+	CompactLineLayout *oldest;
+	size_t bytes;
+	size_t budget;
+	std::vector<CompactStyleRun> styleRuns;
+	std::vector<CompactPositionRun> positionRuns;
+
+	// Allowance for the node of each line in the map
+	enum { bytesPerLine = sizeof(LineMap::value_type) + 4 * sizeof(void *) };
+
+	void Free(CompactLineLayout *cll);
+	void Remove(CompactLineLayout *cll);
+	void Trim();
+public:
+	LineLayoutStore();
+	~LineLayoutStore();
+	void Clear();
+	void MoveLines(int line, int linesAdded);
+	void Add(int lineNumber, const LineLayout *ll);
+	bool Restore(int lineNumber, LineLayout *ll);
+	void SetBudget(size_t budget_);
+	size_t Budget() const {
+		return budget;
+	}
+	size_t Bytes() const {
+		return bytes;
+	}
+};
+
+LineLayoutStore::LineLayoutStore() : newest(0), oldest(0), bytes(0), budget(0x1000000) {
+}
+
+LineLayoutStore::~LineLayoutStore() {
+	Clear();
+}
+
+void LineLayoutStore::Clear() {
+	while (oldest)
+		Remove(oldest);
+}
+
+void LineLayoutStore::Free(CompactLineLayout *cll) {
+	if (cll->newer)
+		cll->newer->older = cll->older;
+	else
+		newest = cll->older;
+	if (cll->older)
+		cll->older->newer = cll->newer;
+	else
+		oldest = cll->newer;
+	bytes -= cll->Bytes() + bytesPerLine;
+	delete [](reinterpret_cast<char *>(cll));
+}
+
+void LineLayoutStore::Remove(CompactLineLayout *cll) {
+	lines.erase(cll->lineNumber);
+	Free(cll);
+}
+
+/// Renumber the lines after line when linesAdded lines were inserted after it or,
+/// when negative, deleted after it.
+void LineLayoutStore::MoveLines(int line, int linesAdded) {
+	if (linesAdded == 0)
+		return;
+	const LineMap::iterator itMove = lines.upper_bound(line);
+	std::vector<CompactLineLayout *> moving;
+	for (LineMap::iterator it = itMove; it != lines.end(); ++it)
+		moving.push_back(it->second);
+	lines.erase(itMove, lines.end());
+	for (size_t i = 0; i < moving.size(); i++) {
+		CompactLineLayout *cll = moving[i];
+		cll->lineNumber += linesAdded;
+		if (cll->lineNumber > line)
+			lines.insert(lines.end(), LineMap::value_type(cll->lineNumber, cll));
+		else
+			Free(cll);
+	}
+}
+
+void LineLayoutStore::Trim() {
+	while (oldest && (bytes > budget))
+		Remove(oldest);
+}
+
+void LineLayoutStore::Add(int lineNumber, const LineLayout *ll) {
+	if (budget == 0)
+		return;
+	LineMap::iterator it = lines.find(lineNumber);
+	if (it != lines.end())
+		Remove(it->second);
+	const int numCharsInLine = ll->numCharsInLine;
+
+	// The element after the text holds the style used to fill past the end of the line
+	styleRuns.clear();
+	for (int i = 0; i <= numCharsInLine; i++) {
+		if (styleRuns.empty() || (styleRuns.back().style != ll->styles[i]) ||
+			(styleRuns.back().indicators != ll->indicators[i])) {
+			CompactStyleRun run = { 0, ll->styles[i], ll->indicators[i] };
+			styleRuns.push_back(run);
+		}
+		styleRuns.back().length++;
+	}
+
+	// Positions are only encoded as a difference when adding it gives back exactly the same value
+	positionRuns.clear();
+	XYPOSITION previous = 0;
+	for (int i = 0; i <= numCharsInLine; i++) {
+		const XYPOSITION position = ll->positions[i];
+		const XYPOSITION delta = position - previous;
+		const XYPOSITION next = previous + delta;
+		if (next != position) {
+			CompactPositionRun run = { position, 0 };
+			positionRuns.push_back(run);
+		} else if (!positionRuns.empty() && (positionRuns.back().count > 0) &&
+			(positionRuns.back().delta == delta)) {
+			positionRuns.back().count++;
+		} else {
+			CompactPositionRun run = { delta, 1 };
+			positionRuns.push_back(run);
+		}
+		previous = position;
+	}
+
+	const int countStyleRuns = static_cast<int>(styleRuns.size());
+	const int countPositionRuns = static_cast<int>(positionRuns.size());
+	const size_t size = CompactLineLayout::Bytes(countStyleRuns, countPositionRuns, numCharsInLine);
+	CompactLineLayout *cll = reinterpret_cast<CompactLineLayout *>(new char[size]);
+	cll->lineNumber = lineNumber;
+	cll->numCharsInLine = numCharsInLine;
+	cll->numCharsBeforeEOL = ll->numCharsBeforeEOL;
+	cll->styleBitsSet = ll->styleBitsSet;
+	cll->edgeColumn = ll->edgeColumn;
+	cll->styleRuns = countStyleRuns;
+	cll->positionRuns = countPositionRuns;
+	memcpy(cll->StyleRuns(), &styleRuns[0], countStyleRuns * sizeof(CompactStyleRun));
+	memcpy(cll->PositionRuns(), &positionRuns[0], countPositionRuns * sizeof(CompactPositionRun));
+	memcpy(cll->Chars(), ll->chars, numCharsInLine + 1);
+
+	cll->newer = 0;
+	cll->older = newest;
+	if (newest)
+		newest->newer = cll;
+	else
+		oldest = cll;
+	newest = cll;
+	lines[lineNumber] = cll;
+	bytes += size + bytesPerLine;
+	Trim();
+}
+
+/// Fill ll with the layout kept for lineNumber, which is then dropped from the store.
+/// The text and styles still have to be checked against the document.
+bool LineLayoutStore::Restore(int lineNumber, LineLayout *ll) {
+	LineMap::iterator it = lines.find(lineNumber);
+	if (it == lines.end())
+		return false;
+	CompactLineLayout *cll = it->second;
+	const bool fits = cll->numCharsInLine <= ll->maxLineLength;
+	if (fits) {
+		ll->numCharsInLine = cll->numCharsInLine;
+		ll->numCharsBeforeEOL = cll->numCharsBeforeEOL;
+		ll->styleBitsSet = cll->styleBitsSet;
+		ll->edgeColumn = cll->edgeColumn;
+		memcpy(ll->chars, cll->Chars(), cll->numCharsInLine + 1);
+		const CompactStyleRun *styleRun = cll->StyleRuns();
+		int i = 0;
+		for (int run = 0; run < cll->styleRuns; run++, styleRun++) {
+			for (int j = 0; j < styleRun->length; j++, i++) {
+				ll->styles[i] = styleRun->style;
+				ll->indicators[i] = styleRun->indicators;
+			}
+		}
+		const CompactPositionRun *positionRun = cll->PositionRuns();
+		XYPOSITION position = 0;
+		i = 0;
+		for (int run = 0; run < cll->positionRuns; run++, positionRun++) {
+			if (positionRun->count == 0) {
+				position = positionRun->delta;
+				ll->positions[i++] = position;
+			} else {
+				for (int j = 0; j < positionRun->count; j++) {
+					position = position + positionRun->delta;
+					ll->positions[i++] = position;
+				}
+			}
+		}
+		ll->widthLine = LineLayout::wrapWidthInfinite;
+		ll->lines = 1;
+		ll->validity = LineLayout::llCheckTextAndStyle;
+	}
+	Remove(cll);
+	return fits;
+}
+
+void LineLayoutStore::SetBudget(size_t budget_) {
+	budget = budget_;
+	Trim();
+}
+//!-end-[LayoutCacheMemory]
+
 LineLayoutCache::LineLayoutCache() :
 	level(0), length(0), size(0), cache(0),
 	allInvalidated(false), styleClock(-1), useCount(0) {
+	store = new LineLayoutStore(); //!-add-[LayoutCacheMemory]
 	Allocate(0);
 }
 
 LineLayoutCache::~LineLayoutCache() {
 	Deallocate();
+	delete store; //!-add-[LayoutCacheMemory]
 }
 
 void LineLayoutCache::Allocate(int length_) {
@@ -231,7 +490,8 @@ void LineLayoutCache::Allocate(int length_) {
 		cache[i] = 0;
 }
 
-void LineLayoutCache::AllocateForLevel(int linesOnScreen, int linesInDoc) {
+//!void LineLayoutCache::AllocateForLevel(int linesOnScreen, int linesInDoc) {
+void LineLayoutCache::AllocateForLevel(int linesOnScreen, int /*linesInDoc*/) { //!-change-[LayoutCacheMemory]
 	PLATFORM_ASSERT(useCount == 0);
 	int lengthForLevel = 0;
 	if (level == llcCaret) {
@@ -239,7 +499,11 @@ void LineLayoutCache::AllocateForLevel(int linesOnScreen, int linesInDoc) {
 	} else if (level == llcPage) {
 		lengthForLevel = linesOnScreen + 1;
 	} else if (level == llcDocument) {
-		lengthForLevel = linesInDoc;
+//!-start-[LayoutCacheMemory]
+		// Lines scrolled off screen are kept in store
+		lengthForLevel = linesOnScreen + 1;
+//!-end-[LayoutCacheMemory]
+//!		lengthForLevel = linesInDoc;
 	}
 	if (lengthForLevel > size) {
 		Deallocate();
@@ -265,9 +529,12 @@ void LineLayoutCache::Deallocate() {
 	cache = 0;
 	length = 0;
 	size = 0;
+	store->Clear(); //!-add-[LayoutCacheMemory]
 }
 
 void LineLayoutCache::Invalidate(LineLayout::validLevel validity_) {
+	if (validity_ == LineLayout::llInvalid) //!-add-[LayoutCacheMemory]
+		store->Clear(); //!-add-[LayoutCacheMemory]
 	if (cache && !allInvalidated) {
 		for (int i = 0; i < length; i++) {
 			if (cache[i]) {
@@ -300,14 +567,15 @@ LineLayout *LineLayoutCache::Retrieve(int lineNumber, int lineCaret, int maxChar
 	LineLayout *ret = 0;
 	if (level == llcCaret) {
 		pos = 0;
-	} else if (level == llcPage) {
+//!	} else if (level == llcPage) {
+	} else if ((level == llcPage) || (level == llcDocument)) { //!-change-[LayoutCacheMemory]
 		if (lineNumber == lineCaret) {
 			pos = 0;
 		} else if (length > 1) {
 			pos = 1 + (lineNumber % (length - 1));
 		}
-	} else if (level == llcDocument) {
-		pos = lineNumber;
+//!	} else if (level == llcDocument) {
+//!		pos = lineNumber;
 	}
 	if (pos >= 0) {
 		PLATFORM_ASSERT(useCount == 0);
@@ -315,12 +583,19 @@ LineLayout *LineLayoutCache::Retrieve(int lineNumber, int lineCaret, int maxChar
 			if (cache[pos]) {
 				if ((cache[pos]->lineNumber != lineNumber) ||
 				        (cache[pos]->maxLineLength < maxChars)) {
+//!-start-[LayoutCacheMemory]
+					if ((level == llcDocument) && (cache[pos]->lineNumber != lineNumber) &&
+					        (cache[pos]->validity != LineLayout::llInvalid))
+						store->Add(cache[pos]->lineNumber, cache[pos]);
+//!-end-[LayoutCacheMemory]
 					delete cache[pos];
 					cache[pos] = 0;
 				}
 			}
 			if (!cache[pos]) {
 				cache[pos] = new LineLayout(maxChars);
+				if (level == llcDocument) //!-add-[LayoutCacheMemory]
+					store->Restore(lineNumber, cache[pos]); //!-add-[LayoutCacheMemory]
 			}
 			if (cache[pos]) {
 				cache[pos]->lineNumber = lineNumber;
@@ -350,6 +625,24 @@ void LineLayoutCache::Dispose(LineLayout *ll) {
 	}
 }
 
+//!-start-[LayoutCacheMemory]
+void LineLayoutCache::MoveLines(int line, int linesAdded) {
+	store->MoveLines(line, linesAdded);
+}
+
+void LineLayoutCache::SetMemory(size_t bytes) {
+	store->SetBudget(bytes);
+}
+
+size_t LineLayoutCache::GetMemory() const {
+	return store->Budget();
+}
+
+size_t LineLayoutCache::MemoryUse() const {
+	return store->Bytes();
+}
+//!-end-[LayoutCacheMemory]
+
 void BreakFinder::Insert(int val) {
 	// Expand if needed
 	if (saeLen >= saeSize) {
@@ -392,7 +685,7 @@ static int NextBadU(const char *s, int p, int len, int &trailBytes) {
 	return -1;
 }
 
-BreakFinder::BreakFinder(LineLayout *ll_, int lineStart_, int lineEnd_, int posLineStart_,
+BreakFinder::BreakFinder(LineLayout *ll_, int lineStart_, int lineEnd_, Position posLineStart_,
 	int xStart, bool breakForSelection, Document *pdoc_) :
 	ll(ll_),
 	lineStart(lineStart_),
@@ -427,9 +720,9 @@ BreakFinder::BreakFinder(LineLayout *ll_, int lineStart_, int lineEnd_, int posL
 			SelectionSegment portion = ll->psel->Range(r).Intersect(segmentLine);
 			if (!(portion.start == portion.end)) {
 				if (portion.start.IsValid())
-					Insert(portion.start.Position() - posLineStart - 1);
+					Insert(static_cast<int>(portion.start.Position() - posLineStart) - 1);
 				if (portion.end.IsValid())
-					Insert(portion.end.Position() - posLineStart - 1);
+					Insert(static_cast<int>(portion.end.Position() - posLineStart) - 1);
 			}
 		}
 	}
@@ -498,125 +791,292 @@ int BreakFinder::Next() {
 	}
 }
 
-PositionCacheEntry::PositionCacheEntry() :
-	styleNumber(0), len(0), clock(0), positions(0) {
+//!-start-[SharedPositionCache]
+/// A measured run. The positions and then the text are allocated after the entry.
+struct PositionCacheEntry {
+	PositionCacheEntry *nextInBucket;
+	PositionCacheEntry *newer;
+	PositionCacheEntry *older;
+	unsigned long long hash;
+	unsigned long long fontKey;
+	unsigned int len;
+
+	XYPOSITION *Positions() {
+		return reinterpret_cast<XYPOSITION *>(this + 1);
+	}
+	char *Text() {
+		return reinterpret_cast<char *>(Positions() + len);
+	}
+	static size_t Bytes(unsigned int len_) {
+		return sizeof(PositionCacheEntry) + len_ * (sizeof(XYPOSITION) + 1);
+	}
+};
+
+static const unsigned long long hashMultiplier = 0x9E3779B97F4A7C15ULL;
+
+static inline unsigned long long HashMix(unsigned long long hash, unsigned long long value) {
+	hash = (hash ^ value) * hashMultiplier;
+	return hash ^ (hash >> 29);
 }
 
-void PositionCacheEntry::Set(unsigned int styleNumber_, const char *s_,
-	unsigned int len_, XYPOSITION *positions_, unsigned int clock_) {
-	Clear();
-	styleNumber = styleNumber_;
-	len = len_;
-	clock = clock_;
-	if (s_ && positions_) {
-		positions = new XYPOSITION[len + (len + 1) / 2];
-		for (unsigned int i=0; i<len; i++) {
-			positions[i] = static_cast<XYPOSITION>(positions_[i]);
-		}
-		memcpy(reinterpret_cast<char *>(positions + len), s_, len);
+// Hashes 8 bytes at a time which is much faster for long runs than a byte at a time.
+static unsigned long long HashBytes(unsigned long long hash, const char *s, size_t len) {
+	hash = HashMix(hash, len);
+	while (len >= 8) {
+		unsigned long long value;
+		memcpy(&value, s, 8);
+		hash = HashMix(hash, value);
+		s += 8;
+		len -= 8;
+	}
+	if (len) {
+		unsigned long long value = 0;
+		memcpy(&value, s, len);
+		hash = HashMix(hash, value);
 	}
+	return HashMix(hash, hash >> 32);
 }
 
-PositionCacheEntry::~PositionCacheEntry() {
-	Clear();
+// Everything that changes the widths of a style's text. The font identity separates the
+// screen and printer fonts, the specification guards against a font being reused.
+static unsigned long long FontKey(ViewStyle &vstyle, unsigned int styleNumber, Document *pdoc) {
+	Style &style = vstyle.styles[styleNumber];
+	unsigned long long key = HashMix(0, reinterpret_cast<size_t>(style.font.GetID()));
+	if (style.fontName)
+		key = HashBytes(key, style.fontName, strlen(style.fontName));
+	key = HashMix(key, style.sizeZoomed);
+	key = HashMix(key, (style.weight << 1) | (style.italic ? 1 : 0));
+	key = HashMix(key, (style.characterSet << 8) | style.extraFontFlag);
+	return HashMix(key, (vstyle.technology << 16) | pdoc->dbcsCodePage);
 }
 
-void PositionCacheEntry::Clear() {
-	delete []positions;
-	positions = 0;
-	styleNumber = 0;
-	len = 0;
-	clock = 0;
+/**
+ * The process wide store of measured runs. Entries are chained in a hash table and also
+ * kept in a list from the most to the least recently used.
+ */
+class PositionCacheStore {
+	ThreadLock *lock;
+	PositionCacheEntry **buckets;
+	size_t bucketCount;
+	PositionCacheEntry *newest;
+	PositionCacheEntry *oldest;
+	size_t entries;
+	size_t bytes;
+	size_t budget;
+	size_t hits;
+	size_t misses;
+
+	void Unlink(PositionCacheEntry *pce);
+	void MakeNewest(PositionCacheEntry *pce);
+	void Remove(PositionCacheEntry *pce);
+	void Grow();
+	void Trim();
+public:
+	PositionCacheStore();
+	~PositionCacheStore();
+	bool Find(unsigned long long hash, unsigned long long fontKey, const char *s, unsigned int len,
+		XYPOSITION *positions);
+	void Add(unsigned long long hash, unsigned long long fontKey, const char *s, unsigned int len,
+		const XYPOSITION *positions);
+	void SetBudget(size_t budget_);
+	size_t Budget() const {
+		return budget;
+	}
+	size_t Hits() const {
+		return hits;
+	}
+	size_t Misses() const {
+		return misses;
+	}
+};
+
+PositionCacheStore::PositionCacheStore() : bucketCount(0x400), newest(0), oldest(0),
+	entries(0), bytes(0), budget(0x800000), hits(0), misses(0) {
+	lock = ThreadLock::Allocate();
+	buckets = new PositionCacheEntry *[bucketCount];
+	memset(buckets, 0, bucketCount * sizeof(PositionCacheEntry *));
+}
+
+PositionCacheStore::~PositionCacheStore() {
+	while (oldest)
+		Remove(oldest);
+	delete []buckets;
+	delete lock;
+}
+
+void PositionCacheStore::Unlink(PositionCacheEntry *pce) {
+	if (pce->newer)
+		pce->newer->older = pce->older;
+	else
+		newest = pce->older;
+	if (pce->older)
+		pce->older->newer = pce->newer;
+	else
+		oldest = pce->newer;
+}
+
+void PositionCacheStore::MakeNewest(PositionCacheEntry *pce) {
+	pce->newer = 0;
+	pce->older = newest;
+	if (newest)
+		newest->newer = pce;
+	newest = pce;
+	if (!oldest)
+		oldest = pce;
+}
+
+void PositionCacheStore::Remove(PositionCacheEntry *pce) {
+	Unlink(pce);
+	PositionCacheEntry **link = &buckets[pce->hash & (bucketCount - 1)];
+	while (*link != pce)
+		link = &(*link)->nextInBucket;
+	*link = pce->nextInBucket;
+	entries--;
+	bytes -= PositionCacheEntry::Bytes(pce->len);
+	delete []reinterpret_cast<char *>(pce);
+}
+
+void PositionCacheStore::Grow() {
+	const size_t bucketCountNew = bucketCount * 2;
+	PositionCacheEntry **bucketsNew = new PositionCacheEntry *[bucketCountNew];
+	memset(bucketsNew, 0, bucketCountNew * sizeof(PositionCacheEntry *));
+	for (size_t bucket = 0; bucket < bucketCount; bucket++) {
+		PositionCacheEntry *pce = buckets[bucket];
+		while (pce) {
+			PositionCacheEntry *pceNext = pce->nextInBucket;
+			const size_t bucketNew = pce->hash & (bucketCountNew - 1);
+			pce->nextInBucket = bucketsNew[bucketNew];
+			bucketsNew[bucketNew] = pce;
+			pce = pceNext;
+		}
+	}
+	delete []buckets;
+	buckets = bucketsNew;
+	bucketCount = bucketCountNew;
+}
+
+void PositionCacheStore::Trim() {
+	while (oldest && (bytes + bucketCount * sizeof(PositionCacheEntry *) > budget))
+		Remove(oldest);
 }
 
-bool PositionCacheEntry::Retrieve(unsigned int styleNumber_, const char *s_,
-	unsigned int len_, XYPOSITION *positions_) const {
-	if ((styleNumber == styleNumber_) && (len == len_) &&
-		(memcmp(reinterpret_cast<char *>(positions + len), s_, len)== 0)) {
-		for (unsigned int i=0; i<len; i++) {
-			positions_[i] = positions[i];
+bool PositionCacheStore::Find(unsigned long long hash, unsigned long long fontKey, const char *s,
+	unsigned int len, XYPOSITION *positions) {
+	lock->Lock();
+	PositionCacheEntry *pce = buckets[hash & (bucketCount - 1)];
+	while (pce && !((pce->hash == hash) && (pce->fontKey == fontKey) && (pce->len == len) &&
+		(memcmp(pce->Text(), s, len) == 0)))
+		pce = pce->nextInBucket;
+	if (pce) {
+		memcpy(positions, pce->Positions(), len * sizeof(XYPOSITION));
+		if (pce != newest) {
+			Unlink(pce);
+			MakeNewest(pce);
 		}
-		return true;
+		hits++;
 	} else {
-		return false;
+		misses++;
 	}
+	lock->Unlock();
+	return pce != 0;
 }
 
-int PositionCacheEntry::Hash(unsigned int styleNumber_, const char *s, unsigned int len_) {
-	unsigned int ret = s[0] << 7;
-	for (unsigned int i=0; i<len_; i++) {
-		ret *= 1000003;
-		ret ^= s[i];
+void PositionCacheStore::Add(unsigned long long hash, unsigned long long fontKey, const char *s,
+	unsigned int len, const XYPOSITION *positions) {
+	char *block = new char[PositionCacheEntry::Bytes(len)];
+	PositionCacheEntry *pce = reinterpret_cast<PositionCacheEntry *>(block);
+	pce->hash = hash;
+	pce->fontKey = fontKey;
+	pce->len = len;
+	memcpy(pce->Positions(), positions, len * sizeof(XYPOSITION));
+	memcpy(pce->Text(), s, len);
+	lock->Lock();
+	// Another thread may have measured the same run since it was looked for
+	PositionCacheEntry *pceSame = buckets[hash & (bucketCount - 1)];
+	while (pceSame && !((pceSame->hash == hash) && (pceSame->fontKey == fontKey) &&
+		(pceSame->len == len) && (memcmp(pceSame->Text(), s, len) == 0)))
+		pceSame = pceSame->nextInBucket;
+	if (pceSame) {
+		lock->Unlock();
+		delete []block;
+		return;
 	}
-	ret *= 1000003;
-	ret ^= len_;
-	ret *= 1000003;
-	ret ^= styleNumber_;
-	return ret;
+	if (entries >= bucketCount)
+		Grow();
+	const size_t bucket = hash & (bucketCount - 1);
+	pce->nextInBucket = buckets[bucket];
+	buckets[bucket] = pce;
+	MakeNewest(pce);
+	entries++;
+	bytes += PositionCacheEntry::Bytes(len);
+	Trim();
+	lock->Unlock();
 }
 
-bool PositionCacheEntry::NewerThan(const PositionCacheEntry &other) const {
-	return clock > other.clock;
+void PositionCacheStore::SetBudget(size_t budget_) {
+	lock->Lock();
+	budget = budget_;
+	Trim();
+	lock->Unlock();
 }
 
-void PositionCacheEntry::ResetClock() {
-	if (clock > 0) {
-		clock = 1;
+static PositionCacheStore positionCacheStore;
+
+//!-start-[MonospaceLayout]
+// Runs of printable ASCII in a font where they all have the same width are laid out
+// arithmetically. Other text, which may be wide or combine, is left to the platform.
+static bool LayoutMonospaced(const Style &style, const char *s, unsigned int len, XYPOSITION *positions) {
+	const XYPOSITION width = style.monospaceASCIIWidth;
+	if (width <= 0)
+		return false;
+	for (unsigned int i = 0; i < len; i++) {
+		const unsigned char ch = static_cast<unsigned char>(s[i]);
+		if ((ch < ' ') || (ch > '~'))
+			return false;
 	}
+	for (unsigned int i = 0; i < len; i++)
+		positions[i] = width * (i + 1);
+	return true;
 }
+//!-end-[MonospaceLayout]
 
-PositionCache::PositionCache() {
-	size = 0x400;
-	clock = 1;
-	pces = new PositionCacheEntry[size];
-	allClear = true;
+PositionCache::PositionCache() : size(0x400) {
 }
 
 PositionCache::~PositionCache() {
-	Clear();
-	delete []pces;
 }
 
 void PositionCache::Clear() {
-	if (!allClear) {
-		for (size_t i=0; i<size; i++) {
-			pces[i].Clear();
-		}
-	}
-	clock = 1;
-	allClear = true;
 }
 
 void PositionCache::SetSize(size_t size_) {
-	Clear();
-	delete []pces;
 	size = size_;
-	pces = new PositionCacheEntry[size];
+}
+
+bool PositionCache::Retrieve(ViewStyle &vstyle, unsigned int styleNumber, const char *s, unsigned int len,
+	XYPOSITION *positions, Document *pdoc) {
+	if (LayoutMonospaced(vstyle.styles[styleNumber], s, len, positions)) //!-add-[MonospaceLayout]
+		return true; //!-add-[MonospaceLayout]
+	if ((size == 0) || (len > BreakFinder::lengthStartSubdivision))
+		return false;
+	const unsigned long long fontKey = FontKey(vstyle, styleNumber, pdoc);
+	return positionCacheStore.Find(HashBytes(fontKey, s, len), fontKey, s, len, positions);
 }
 
 void PositionCache::MeasureWidths(Surface *surface, ViewStyle &vstyle, unsigned int styleNumber,
 	const char *s, unsigned int len, XYPOSITION *positions, Document *pdoc) {
+	if (LayoutMonospaced(vstyle.styles[styleNumber], s, len, positions)) //!-add-[MonospaceLayout]
+		return; //!-add-[MonospaceLayout]
 
-	allClear = false;
-	int probe = -1;
-	if ((size > 0) && (len < 30)) {
-		// Only store short strings in the cache so it doesn't churn with
-		// long comments with only a single comment.
-
-		// Two way associative: try two probe positions.
-		int hashValue = PositionCacheEntry::Hash(styleNumber, s, len);
-		probe = static_cast<int>(hashValue % size);
-		if (pces[probe].Retrieve(styleNumber, s, len, positions)) {
-			return;
-		}
-		int probe2 = static_cast<int>((hashValue * 37) % size);
-		if (pces[probe2].Retrieve(styleNumber, s, len, positions)) {
+	// Longer runs are split by BreakFinder so are unlikely to be seen again
+	const bool cacheable = (size > 0) && (len <= BreakFinder::lengthStartSubdivision);
+	unsigned long long fontKey = 0;
+	unsigned long long hash = 0;
+	if (cacheable) {
+		fontKey = FontKey(vstyle, styleNumber, pdoc);
+		hash = HashBytes(fontKey, s, len);
+		if (positionCacheStore.Find(hash, fontKey, s, len, positions))
 			return;
-		}
-		// Not found. Choose the oldest of the two slots to replace
-		if (pces[probe].NewerThan(pces[probe2])) {
-			probe = probe2;
-		}
 	}
 	if (len > BreakFinder::lengthStartSubdivision) {
 		// Break up into segments
@@ -634,16 +1094,24 @@ void PositionCache::MeasureWidths(Surface *surface, ViewStyle &vstyle, unsigned
 	} else {
 		surface->MeasureWidths(vstyle.styles[styleNumber].font, s, len, positions);
 	}
-	if (probe >= 0) {
-		clock++;
-		if (clock > 60000) {
-			// Since there are only 16 bits for the clock, wrap it round and
-			// reset all cache entries so none get stuck with a high clock.
-			for (size_t i=0; i<size; i++) {
-				pces[i].ResetClock();
-			}
-			clock = 2;
-		}
-		pces[probe].Set(styleNumber, s, len, positions, clock);
+	if (cacheable) {
+		positionCacheStore.Add(hash, fontKey, s, len, positions);
 	}
 }
+
+void PositionCache::SetMemory(size_t bytes) {
+	positionCacheStore.SetBudget(bytes);
+}
+
+size_t PositionCache::GetMemory() {
+	return positionCacheStore.Budget();
+}
+
+size_t PositionCache::Hits() {
+	return positionCacheStore.Hits();
+}
+
+size_t PositionCache::Misses() {
+	return positionCacheStore.Misses();
+}
+//!-end-[SharedPositionCache]
@@ -45,8 +45,8 @@ public:
 	char bracePreviousStyles[2];
 
 	// Hotspot support
-	int hsStart;
-	int hsEnd;
+	Position hsStart;
+	Position hsEnd;
 
 	// Wrapped line support
 	int widthLine;
@@ -69,6 +69,8 @@ public:
 	int EndLineStyle() const;
 };
 
+class LineLayoutStore; //!-add-[LayoutCacheMemory]
+
 /**
  */
 class LineLayoutCache {
@@ -79,6 +81,10 @@ class LineLayoutCache {
 	bool allInvalidated;
 	int styleClock;
 	int useCount;
+//!-start-[LayoutCacheMemory]
+	/// At the document level, lines no longer on screen are kept here in compact form
+	LineLayoutStore *store;
+//!-end-[LayoutCacheMemory]
 	void Allocate(int length_);
 	void AllocateForLevel(int linesOnScreen, int linesInDoc);
 public:
@@ -97,22 +103,12 @@ public:
 	LineLayout *Retrieve(int lineNumber, int lineCaret, int maxChars, int styleClock_,
 		int linesOnScreen, int linesInDoc);
 	void Dispose(LineLayout *ll);
-};
-
-class PositionCacheEntry {
-	unsigned int styleNumber:8;
-	unsigned int len:8;
-	unsigned int clock:16;
-	XYPOSITION *positions;
-public:
-	PositionCacheEntry();
-	~PositionCacheEntry();
-	void Set(unsigned int styleNumber_, const char *s_, unsigned int len_, XYPOSITION *positions_, unsigned int clock);
-	void Clear();
-	bool Retrieve(unsigned int styleNumber_, const char *s_, unsigned int len_, XYPOSITION *positions_) const;
-	static int Hash(unsigned int styleNumber_, const char *s, unsigned int len);
-	bool NewerThan(const PositionCacheEntry &other) const;
-	void ResetClock();
+//!-start-[LayoutCacheMemory]
+	void MoveLines(int line, int linesAdded);
+	void SetMemory(size_t bytes);
+	size_t GetMemory() const;
+	size_t MemoryUse() const;
+//!-end-[LayoutCacheMemory]
 };
 
 // Class to break a line of text into shorter runs at sensible places.
@@ -120,7 +116,7 @@ class BreakFinder {
 	LineLayout *ll;
 	int lineStart;
 	int lineEnd;
-	int posLineStart;
+	Position posLineStart;
 	int nextBreak;
 	int *selAndEdge;
 	unsigned int saeSize;
@@ -136,27 +132,42 @@ public:
 	enum { lengthStartSubdivision = 300 };
 	// Try to make each subdivided run lengthEachSubdivision or shorter.
 	enum { lengthEachSubdivision = 100 };
-	BreakFinder(LineLayout *ll_, int lineStart_, int lineEnd_, int posLineStart_,
+	BreakFinder(LineLayout *ll_, int lineStart_, int lineEnd_, Position posLineStart_,
 		int xStart, bool breakForSelection, Document *pdoc_);
 	~BreakFinder();
 	int First() const;
 	int Next();
 };
 
+//!-start-[SharedPositionCache]
+/**
+ * Widths of runs of text recently measured, shared by all the Scintilla windows in the process.
+ * Runs are found by a 64-bit hash of their font and text and the least recently used are
+ * dropped when the cache takes more than its memory budget.
+ * Measuring and retrieving lock the cache so several threads may measure at once.
+ */
 class PositionCache {
-	PositionCacheEntry *pces;
+	/// 0 stops this window using the cache
 	size_t size;
-	unsigned int clock;
-	bool allClear;
 public:
 	PositionCache();
 	~PositionCache();
+	/// Entries are keyed by font so nothing needs to be cleared when styles change.
 	void Clear();
 	void SetSize(size_t size_);
 	size_t GetSize() const { return size; }
+	/// Find widths already measured, without needing a surface.
+	bool Retrieve(ViewStyle &vstyle, unsigned int styleNumber, const char *s, unsigned int len,
+		XYPOSITION *positions, Document *pdoc);
 	void MeasureWidths(Surface *surface, ViewStyle &vstyle, unsigned int styleNumber,
 		const char *s, unsigned int len, XYPOSITION *positions, Document *pdoc);
+
+	static void SetMemory(size_t bytes);
+	static size_t GetMemory();
+	static size_t Hits();
+	static size_t Misses();
 };
+//!-end-[SharedPositionCache]
 
 inline bool IsSpaceOrTab(int ch) {
 	return ch == ' ' || ch == '\t';
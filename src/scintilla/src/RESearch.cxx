@@ -206,6 +206,7 @@
 
 #include <stdlib.h>
 
+#include "Sci_Position.h"
 #include "CharClassify.h"
 #include "RESearch.h"
 
@@ -287,10 +288,10 @@ bool RESearch::GrabMatches(CharacterIndexer &ci) {
 	bool success = true;
 	for (unsigned int i = 0; i < MAXTAG; i++) {
 		if ((bopat[i] != NOTFOUND) && (eopat[i] != NOTFOUND)) {
-			unsigned int len = eopat[i] - bopat[i];
+			Sci_Position len = eopat[i] - bopat[i];
 			pat[i] = new char[len + 1];
 			if (pat[i]) {
-				for (unsigned int j = 0; j < len; j++)
+				for (Sci_Position j = 0; j < len; j++)
 					pat[i][j] = ci.CharAt(bopat[i] + j);
 				pat[i][len] = '\0';
 			} else {
@@ -763,9 +764,9 @@ const char *RESearch::Compile(const char *pattern, int length, bool caseSensitiv
  *  respectively.
  *
  */
-int RESearch::Execute(CharacterIndexer &ci, int lp, int endp) {
+int RESearch::Execute(CharacterIndexer &ci, Sci_Position lp, Sci_Position endp) {
 	unsigned char c;
-	int ep = NOTFOUND;
+	Sci_Position ep = NOTFOUND;
 	char *ap = nfa;
 
 	bol = lp;
@@ -852,13 +853,13 @@ extern void re_fail(char *,char);
 #define CHRSKIP 3	/* [CLO] CHR chr END      */
 #define CCLSKIP 34	/* [CLO] CCL 32 bytes END */
 
-int RESearch::PMatch(CharacterIndexer &ci, int lp, int endp, char *ap) {
+Sci_Position RESearch::PMatch(CharacterIndexer &ci, Sci_Position lp, Sci_Position endp, char *ap) {
 	int op, c, n;
-	int e;		/* extra pointer for CLO  */
-	int bp;		/* beginning of subpat... */
-	int ep;		/* ending of subpat...    */
-	int are;	/* to save the line ptr.  */
-	int llp;	/* lazy lp for LCLO       */
+	Sci_Position e;		/* extra pointer for CLO  */
+	Sci_Position bp;		/* beginning of subpat... */
+	Sci_Position ep;		/* ending of subpat...    */
+	Sci_Position are;	/* to save the line ptr.  */
+	Sci_Position llp;	/* lazy lp for LCLO       */
 
 	while ((op = *ap++) != END)
 		switch (op) {
@@ -948,7 +949,7 @@ int RESearch::PMatch(CharacterIndexer &ci, int lp, int endp, char *ap) {
 			llp = lp;
 			e = NOTFOUND;
 			while (llp >= are) {
-				int q;
+				Sci_Position q;
 				if ((q = PMatch(ci, llp, endp, ap)) != NOTFOUND) {
 					e = q;
 					lp = llp;
@@ -980,8 +981,8 @@ int RESearch::PMatch(CharacterIndexer &ci, int lp, int endp, char *ap) {
 int RESearch::Substitute(CharacterIndexer &ci, char *src, char *dst) {
 	unsigned char c;
 	int  pin;
-	int bp;
-	int ep;
+	Sci_Position bp;
+	Sci_Position ep;
 
 	if (!*src || !bopat[0])
 		return 0;
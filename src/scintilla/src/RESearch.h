@@ -23,7 +23,7 @@ namespace Scintilla {
 
 class CharacterIndexer {
 public:
-	virtual char CharAt(int index)=0;
+	virtual char CharAt(Sci_Position index)=0;
 	virtual ~CharacterIndexer() {
 	}
 };
@@ -35,15 +35,15 @@ public:
 	~RESearch();
 	bool GrabMatches(CharacterIndexer &ci);
 	const char *Compile(const char *pattern, int length, bool caseSensitive, bool posix);
-	int Execute(CharacterIndexer &ci, int lp, int endp);
+	int Execute(CharacterIndexer &ci, Sci_Position lp, Sci_Position endp);
 	int Substitute(CharacterIndexer &ci, char *src, char *dst);
 
 	enum { MAXTAG=10 };
 	enum { MAXNFA=2048 };
 	enum { NOTFOUND=-1 };
 
-	int bopat[MAXTAG];
-	int eopat[MAXTAG];
+	Sci_Position bopat[MAXTAG];
+	Sci_Position eopat[MAXTAG];
 	char *pat[MAXTAG];
 
 private:
@@ -53,9 +53,9 @@ private:
 	void ChSetWithCase(unsigned char c, bool caseSensitive);
 	int GetBackslashExpression(const char *pattern, int &incr);
 
-	int PMatch(CharacterIndexer &ci, int lp, int endp, char *ap);
+	Sci_Position PMatch(CharacterIndexer &ci, Sci_Position lp, Sci_Position endp, char *ap);
 
-	int bol;
+	Sci_Position bol;
 	int tagstk[MAXTAG];  /* subpat tag stack */
 	char nfa[MAXNFA];    /* automaton */
 	int sta;
@@ -12,6 +12,7 @@
 #include "Platform.h"
 
 #include "Scintilla.h"
+#include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
 #include "RunStyles.h"
@@ -21,7 +22,7 @@ using namespace Scintilla;
 #endif
 
 // Find the first run at a position
-int RunStyles::RunFromPosition(int position) const {
+int RunStyles::RunFromPosition(Position position) const {
 	int run = starts->PartitionFromPosition(position);
 	// Go to first element with this position
 	while ((run > 0) && (position == starts->PositionFromPartition(run-1))) {
@@ -31,9 +32,9 @@ int RunStyles::RunFromPosition(int position) const {
 }
 
 // If there is no run boundary at position, insert one continuing style.
-int RunStyles::SplitRun(int position) {
+int RunStyles::SplitRun(Position position) {
 	int run = RunFromPosition(position);
-	int posRun = starts->PositionFromPartition(run);
+	Position posRun = starts->PositionFromPartition(run);
 	if (posRun < position) {
 		int runStyle = ValueAt(position);
 		run++;
@@ -65,7 +66,7 @@ void RunStyles::RemoveRunIfSameAsPrevious(int run) {
 }
 
 RunStyles::RunStyles() {
-	starts = new Partitioning(8);
+	starts = new Partitioning<Position>(8);
 	styles = new SplitVector<int>();
 	styles->InsertValue(0, 2, 0);
 }
@@ -77,21 +78,21 @@ RunStyles::~RunStyles() {
 	styles = NULL;
 }
 
-int RunStyles::Length() const {
+Position RunStyles::Length() const {
 	return starts->PositionFromPartition(starts->Partitions());
 }
 
-int RunStyles::ValueAt(int position) const {
+int RunStyles::ValueAt(Position position) const {
 	return styles->ValueAt(starts->PartitionFromPosition(position));
 }
 
-int RunStyles::FindNextChange(int position, int end) {
+Position RunStyles::FindNextChange(Position position, Position end) {
 	int run = starts->PartitionFromPosition(position);
 	if (run < starts->Partitions()) {
-		int runChange = starts->PositionFromPartition(run);
+		Position runChange = starts->PositionFromPartition(run);
 		if (runChange > position)
 			return runChange;
-		int nextChange = starts->PositionFromPartition(run + 1);
+		Position nextChange = starts->PositionFromPartition(run + 1);
 		if (nextChange > position) {
 			return nextChange;
 		} else if (position < end) {
@@ -104,16 +105,16 @@ int RunStyles::FindNextChange(int position, int end) {
 	}
 }
 
-int RunStyles::StartRun(int position) {
+Position RunStyles::StartRun(Position position) {
 	return starts->PositionFromPartition(starts->PartitionFromPosition(position));
 }
 
-int RunStyles::EndRun(int position) {
+Position RunStyles::EndRun(Position position) {
 	return starts->PositionFromPartition(starts->PartitionFromPosition(position) + 1);
 }
 
-bool RunStyles::FillRange(int &position, int value, int &fillLength) {
-	int end = position + fillLength;
+bool RunStyles::FillRange(Position &position, int value, Position &fillLength) {
+	Position end = position + fillLength;
 	int runEnd = RunFromPosition(end);
 	if (styles->ValueAt(runEnd) == value) {
 		// End already has value so trim range.
@@ -155,12 +156,12 @@ bool RunStyles::FillRange(int &position, int value, int &fillLength) {
 	}
 }
 
-void RunStyles::SetValueAt(int position, int value) {
-	int len = 1;
+void RunStyles::SetValueAt(Position position, int value) {
+	Position len = 1;
 	FillRange(position, value, len);
 }
 
-void RunStyles::InsertSpace(int position, int insertLength) {
+void RunStyles::InsertSpace(Position position, Position insertLength) {
 	int runStart = RunFromPosition(position);
 	if (starts->PositionFromPartition(runStart) == position) {
 		int runStyle = ValueAt(position);
@@ -193,13 +194,13 @@ void RunStyles::DeleteAll() {
 	starts = NULL;
 	delete styles;
 	styles = NULL;
-	starts = new Partitioning(8);
+	starts = new Partitioning<Position>(8);
 	styles = new SplitVector<int>();
 	styles->InsertValue(0, 2, 0);
 }
 
-void RunStyles::DeleteRange(int position, int deleteLength) {
-	int end = position + deleteLength;
+void RunStyles::DeleteRange(Position position, Position deleteLength) {
+	Position end = position + deleteLength;
 	int runStart = RunFromPosition(position);
 	int runEnd = RunFromPosition(end);
 	if (runStart == runEnd) {
@@ -234,7 +235,7 @@ bool RunStyles::AllSameAs(int value) const {
 	return AllSame() && (styles->ValueAt(0) == value);
 }
 
-int RunStyles::Find(int value, int start) const {
+Position RunStyles::Find(int value, Position start) const {
 	if (start < Length()) {
 		int run = start ? RunFromPosition(start) : 0;
 		if (styles->ValueAt(run) == value)
@@ -16,31 +16,31 @@ namespace Scintilla {
 
 class RunStyles {
 private:
-	Partitioning *starts;
+	Partitioning<Position> *starts;
 	SplitVector<int> *styles;
-	int RunFromPosition(int position) const;
-	int SplitRun(int position);
+	int RunFromPosition(Position position) const;
+	int SplitRun(Position position);
 	void RemoveRun(int run);
 	void RemoveRunIfEmpty(int run);
 	void RemoveRunIfSameAsPrevious(int run);
 public:
 	RunStyles();
 	~RunStyles();
-	int Length() const;
-	int ValueAt(int position) const;
-	int FindNextChange(int position, int end);
-	int StartRun(int position);
-	int EndRun(int position);
+	Position Length() const;
+	int ValueAt(Position position) const;
+	Position FindNextChange(Position position, Position end);
+	Position StartRun(Position position);
+	Position EndRun(Position position);
 	// Returns true if some values may have changed
-	bool FillRange(int &position, int value, int &fillLength);
-	void SetValueAt(int position, int value);
-	void InsertSpace(int position, int insertLength);
+	bool FillRange(Position &position, int value, Position &fillLength);
+	void SetValueAt(Position position, int value);
+	void InsertSpace(Position position, Position insertLength);
 	void DeleteAll();
-	void DeleteRange(int position, int deleteLength);
+	void DeleteRange(Position position, Position deleteLength);
 	int Runs() const;
 	bool AllSame() const;
 	bool AllSameAs(int value) const;
-	int Find(int value, int start) const;
+	Position Find(int value, Position start) const;
 };
 
 #ifdef SCI_NAMESPACE
@@ -19,6 +19,7 @@
 
 #include "ILexer.h"
 #include "Scintilla.h"
+#include "Position.h"
 
 #include "PropSetSimple.h"
 #ifdef SCI_LEXER
@@ -28,6 +29,7 @@
 #endif
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -295,7 +297,7 @@ void ScintillaBase::AutoCompleteMove(int delta) {
 void ScintillaBase::AutoCompleteMoveToCurrentWord() {
 	char wordCurrent[1000];
 	int i;
-	int startWord = ac.posStart - ac.startLen;
+	Position startWord = ac.posStart - ac.startLen;
 	for (i = startWord; i < sel.MainCaret() && i - startWord < 1000; i++)
 		wordCurrent[i - startWord] = pdoc->CharAt(i);
 	wordCurrent[Platform::Minimum(i - startWord, 999)] = '\0';
@@ -528,6 +530,7 @@ LexState::LexState(Document *pdoc_) : LexInterface(pdoc_) {
 }
 
 LexState::~LexState() {
+	StopBackground(); //!-add-[BackgroundLexing]
 	if (instance) {
 		instance->Release();
 		instance = 0;
@@ -543,6 +546,7 @@ LexState *ScintillaBase::DocumentLexState() {
 
 void LexState::SetLexerModule(const LexerModule *lex) {
 	if (lex != lexCurrent) {
+		StopBackground(); //!-add-[BackgroundLexing]
 		if (instance) {
 			instance->Release();
 			instance = 0;
@@ -585,6 +589,7 @@ const char *LexState::DescribeWordListSets() {
 
 void LexState::SetWordList(int n, const char *wl) {
 	if (instance) {
+		StopBackground(); //!-add-[BackgroundLexing]
 		int firstModification = instance->WordListSet(n, wl);
 		if (firstModification >= 0) {
 			pdoc->ModifiedAt(firstModification);
@@ -602,6 +607,7 @@ const char *LexState::GetName() const {
 
 void *LexState::PrivateCall(int operation, void *pointer) {
 	if (pdoc && instance) {
+		StopBackground(); //!-add-[BackgroundLexing]
 		return instance->PrivateCall(operation, pointer);
 	} else {
 		return 0;
@@ -635,6 +641,7 @@ const char *LexState::DescribeProperty(const char *name) {
 void LexState::PropSet(const char *key, const char *val) {
 	props.Set(key, val);
 	if (instance) {
+		StopBackground(); //!-add-[BackgroundLexing]
 		int firstModification = instance->PropertySet(key, val);
 		if (firstModification >= 0) {
 			pdoc->ModifiedAt(firstModification);
@@ -656,11 +663,11 @@ int LexState::PropGetExpanded(const char *key, char *result) const {
 
 #endif
 
-void ScintillaBase::NotifyStyleToNeeded(int endStyleNeeded) {
+void ScintillaBase::NotifyStyleToNeeded(Position endStyleNeeded) {
 #ifdef SCI_LEXER
 	if (DocumentLexState()->lexLanguage != SCLEX_CONTAINER) {
 		int lineEndStyled = pdoc->LineFromPosition(pdoc->GetEndStyled());
-		int endStyled = pdoc->LineStart(lineEndStyled);
+		Position endStyled = pdoc->LineStart(lineEndStyled);
 		DocumentLexState()->Colourise(endStyled, endStyleNeeded);
 		return;
 	}
@@ -754,6 +761,15 @@ sptr_t ScintillaBase::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lPara
 	case SCI_AUTOCGETAUTOHIDE:
 		return ac.autoHide;
 
+//!-start-[FuzzyAutoComplete]
+	case SCI_AUTOCSETFUZZY:
+		ac.fuzzy = wParam != 0;
+		break;
+
+	case SCI_AUTOCGETFUZZY:
+		return ac.fuzzy;
+//!-end-[FuzzyAutoComplete]
+
 	case SCI_AUTOCSETDROPRESTOFWORD:
 		ac.dropRestOfWord = wParam != 0;
 		break;
@@ -874,6 +890,7 @@ sptr_t ScintillaBase::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lPara
 			pdoc->ModifiedAt(wParam);
 			NotifyStyleToNeeded((lParam == -1) ? pdoc->Length() : lParam);
 		} else {
+			DocumentLexState()->StopBackground(); //!-add-[BackgroundLexing]
 			DocumentLexState()->Colourise(wParam, lParam);
 		}
 		Redraw();
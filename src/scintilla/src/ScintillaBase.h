@@ -84,7 +84,7 @@ protected:
 
 	virtual void ButtonDown(Point pt, unsigned int curTime, bool shift, bool ctrl, bool alt);
 
-	void NotifyStyleToNeeded(int endStyleNeeded);
+	void NotifyStyleToNeeded(Position endStyleNeeded);
 	void NotifyLexerChanged(Document *doc, void *userData);
 
 public:
@@ -19,7 +19,7 @@
 using namespace Scintilla;
 #endif
 
-void SelectionPosition::MoveForInsertDelete(bool insertion, int startChange, int length) {
+void SelectionPosition::MoveForInsertDelete(bool insertion, Sci_Position startChange, Sci_Position length) {
 	if (position == startChange) {
 		virtualSpace = 0;
 	}
@@ -29,7 +29,7 @@ void SelectionPosition::MoveForInsertDelete(bool insertion, int startChange, int
 		}
 	} else {
 		if (position > startChange) {
-			int endDeletion = startChange + length;
+			Sci_Position endDeletion = startChange + length;
 			if (position > endDeletion) {
 				position -= length;
 			} else {
@@ -68,7 +68,7 @@ bool SelectionPosition::operator >=(const SelectionPosition &other) const {
 		return *this > other;
 }
 
-int SelectionRange::Length() const {
+Sci_Position SelectionRange::Length() const {
 	if (anchor > caret) {
 		return anchor.Position() - caret.Position();
 	} else {
@@ -76,7 +76,7 @@ int SelectionRange::Length() const {
 	}
 }
 
-bool SelectionRange::Contains(int pos) const {
+bool SelectionRange::Contains(Sci_Position pos) const {
 	if (anchor > caret)
 		return (pos >= caret.Position()) && (pos <= anchor.Position());
 	else
@@ -90,7 +90,7 @@ bool SelectionRange::Contains(SelectionPosition sp) const {
 		return (sp >= anchor) && (sp <= caret);
 }
 
-bool SelectionRange::ContainsCharacter(int posCharacter) const {
+bool SelectionRange::ContainsCharacter(Sci_Position posCharacter) const {
 	if (anchor > caret)
 		return (posCharacter >= caret.Position()) && (posCharacter < anchor.Position());
 	else
@@ -171,11 +171,11 @@ bool Selection::IsRectangular() const {
 	return (selType == selRectangle) || (selType == selThin);
 }
 
-int Selection::MainCaret() const {
+Sci_Position Selection::MainCaret() const {
 	return ranges[mainRange].caret.Position();
 }
 
-int Selection::MainAnchor() const {
+Sci_Position Selection::MainAnchor() const {
 	return ranges[mainRange].anchor.Position();
 }
 
@@ -252,15 +252,15 @@ SelectionPosition Selection::Last() const {
 	return lastPosition;
 }
 
-int Selection::Length() const {
-	int len = 0;
+Sci_Position Selection::Length() const {
+	Sci_Position len = 0;
 	for (size_t i=0; i<ranges.size(); i++) {
 		len += ranges[i].Length();
 	}
 	return len;
 }
 
-void Selection::MovePositions(bool insertion, int startChange, int length) {
+void Selection::MovePositions(bool insertion, Sci_Position startChange, Sci_Position length) {
 	for (size_t i=0; i<ranges.size(); i++) {
 		ranges[i].caret.MoveForInsertDelete(insertion, startChange, length);
 		ranges[i].anchor.MoveForInsertDelete(insertion, startChange, length);
@@ -315,7 +315,7 @@ void Selection::CommitTentative() {
 	tentativeMain = false;
 }
 
-int Selection::CharacterInSelection(int posCharacter) const {
+int Selection::CharacterInSelection(Sci_Position posCharacter) const {
 	for (size_t i=0; i<ranges.size(); i++) {
 		if (ranges[i].ContainsCharacter(posCharacter))
 			return i == mainRange ? 1 : 2;
@@ -323,7 +323,7 @@ int Selection::CharacterInSelection(int posCharacter) const {
 	return 0;
 }
 
-int Selection::InSelectionForEOL(int pos) const {
+int Selection::InSelectionForEOL(Sci_Position pos) const {
 	for (size_t i=0; i<ranges.size(); i++) {
 		if (!ranges[i].Empty() && (pos > ranges[i].Start().Position()) && (pos <= ranges[i].End().Position()))
 			return i == mainRange ? 1 : 2;
@@ -331,7 +331,7 @@ int Selection::InSelectionForEOL(int pos) const {
 	return 0;
 }
 
-int Selection::VirtualSpaceFor(int pos) const {
+int Selection::VirtualSpaceFor(Sci_Position pos) const {
 	int virtualSpace = 0;
 	for (size_t i=0; i<ranges.size(); i++) {
 		if ((ranges[i].caret.Position() == pos) && (virtualSpace < ranges[i].caret.VirtualSpace()))
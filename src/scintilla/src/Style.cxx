@@ -52,6 +52,7 @@ void FontMeasurements::Clear() {
 	aveCharWidth = 1;
 	spaceWidth = 1;
 	sizeZoomed = 2;
+	monospaceASCIIWidth = 0; //!-add-[MonospaceLayout]
 }
 
 Style::Style() : FontSpecification() {
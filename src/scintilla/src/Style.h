@@ -50,6 +50,7 @@ struct FontMeasurements {
 	unsigned int aveCharWidth;
 	unsigned int spaceWidth;
 	int sizeZoomed;
+	XYPOSITION monospaceASCIIWidth;	///< Width of every printable ASCII character or 0 when they differ //!-add-[MonospaceLayout]
 	FontMeasurements();
 	void Clear();
 };
@@ -13,6 +13,7 @@
 #include "Platform.h"
 
 #include "Scintilla.h"
+#include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
 #include "RunStyles.h"
@@ -102,6 +103,25 @@ void FontRealised::Realise(Surface &surface, int zoomLevel, int technology) {
 	lineHeight = surface.Height(font);
 	aveCharWidth = surface.AverageCharWidth(font);
 	spaceWidth = surface.WidthChar(font, ' ');
+//!-start-[MonospaceLayout]
+	// When all printable ASCII characters advance by the same amount, runs of them can
+	// be laid out by multiplying instead of asking the platform to measure them.
+	monospaceASCIIWidth = 0;
+	const int printables = 0x7f - ' ';
+	char ascii[printables];
+	XYPOSITION positions[printables];
+	for (int ch = 0; ch < printables; ch++)
+		ascii[ch] = static_cast<char>(ch + ' ');
+	surface.MeasureWidths(font, ascii, printables, positions);
+	const XYPOSITION width = positions[0];
+	bool monospaced = width > 0;
+	for (int i = 1; monospaced && (i < printables); i++) {
+		const XYPOSITION difference = positions[i] - width * (i + 1);
+		monospaced = (difference < 0.01f) && (difference > -0.01f);
+	}
+	if (monospaced)
+		monospaceASCIIWidth = width;
+//!-end-[MonospaceLayout]
 	if (frNext) {
 		frNext->Realise(surface, zoomLevel, technology);
 	}
@@ -79,5 +79,34 @@ class TestPerformance(unittest.TestCase):
 		self.xite.DoEvents()
 		self.assert_(self.ed.Length > 0)
 
+	def scatteredEdits(self, chunkSize, name):
+		oneLine = (string.ascii_letters + string.digits + "\n").encode('utf-8')
+		data = oneLine * 100000
+		insert = (string.digits + "\n").encode('utf-8')
+		self.ed.ChunkSize = chunkSize
+		self.ed.AddText(len(data), data)
+		start = time.time()
+		for i in range(1000):
+			# Alternate between the start and end of the document as a
+			# multiple selection edit or replace all would
+			pos = (i * 1009 * len(oneLine)) % (len(data) - len(oneLine))
+			if i % 2:
+				pos = self.ed.Length - pos - len(oneLine)
+			self.ed.TargetStart = pos
+			self.ed.TargetEnd = pos + len(insert)
+			self.ed.ReplaceTarget(len(insert), insert)
+		end = time.time()
+		duration = end - start
+		print("%6.3f %s" % (duration, name))
+		self.xite.DoEvents()
+		self.assertEquals(self.ed.Length, len(data))
+		self.ed.ChunkSize = 0
+
+	def testScatteredEditsGap(self):
+		self.scatteredEdits(0, "testScatteredEditsGap")
+
+	def testScatteredEditsChunked(self):
+		self.scatteredEdits(65536, "testScatteredEditsChunked")
+
 if __name__ == '__main__':
 	XiteWin.main("performanceTests")
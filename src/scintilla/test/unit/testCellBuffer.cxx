@@ -0,0 +1,293 @@
+// Unit Tests for Scintilla internal data structures
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Platform.h"
+
+#include "ILexer.h"
+#include "Position.h"
+#include "SplitVector.h"
+#include "Partitioning.h"
+#include "ChunkedVector.h"
+#include "RunStyles.h"
+#include "CellBuffer.h"
+
+#include <gtest/gtest.h>
+
+// Test CellBuffer.
+
+class MappedString : public IMappedText {
+public:
+	const char *s;
+	int releases;
+	MappedString(const char *s_) : s(s_), releases(0) {
+	}
+	virtual ~MappedString() {
+	}
+	const char * SCI_METHOD Data() {
+		return s;
+	}
+	Sci_Position SCI_METHOD Length() {
+		return strlen(s);
+	}
+	void SCI_METHOD Release() {
+		releases++;
+	}
+};
+
+class CellBufferTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		pcb = new CellBuffer();
+	}
+
+	virtual void TearDown() {
+		delete pcb;
+		pcb = 0;
+	}
+
+	CellBuffer *pcb;
+};
+
+TEST_F(CellBufferTest, InsertOne) {
+	bool startSequence = false;
+	pcb->InsertString(0, "abc\ndef", 7, startSequence);
+	EXPECT_EQ(7, pcb->Length());
+	EXPECT_EQ(2, pcb->Lines());
+	EXPECT_EQ(4, pcb->LineStart(1));
+	EXPECT_EQ('d', pcb->CharAt(4));
+}
+
+TEST_F(CellBufferTest, AdoptMapped) {
+	MappedString text("ab\r\ncd\ref\ngh");
+	EXPECT_TRUE(pcb->AdoptMapped(&text));
+	EXPECT_TRUE(pcb->IsMapped());
+	EXPECT_EQ(12, pcb->Length());
+	EXPECT_EQ(4, pcb->Lines());
+	EXPECT_EQ(4, pcb->LineStart(1));
+	EXPECT_EQ(7, pcb->LineStart(2));
+	EXPECT_EQ(10, pcb->LineStart(3));
+	EXPECT_EQ('c', pcb->CharAt(4));
+	char buffer[3] = "";
+	pcb->GetCharRange(buffer, 7, 2);
+	EXPECT_EQ(0, memcmp(buffer, "ef", 2));
+	EXPECT_EQ(0, text.releases);
+}
+
+TEST_F(CellBufferTest, AdoptMappedOnlyWhenEmpty) {
+	bool startSequence = false;
+	pcb->InsertString(0, "x", 1, startSequence);
+	MappedString text("abc");
+	EXPECT_FALSE(pcb->AdoptMapped(&text));
+	EXPECT_FALSE(pcb->IsMapped());
+}
+
+TEST_F(CellBufferTest, MappedStyles) {
+	MappedString text("abcdefgh");
+	pcb->AdoptMapped(&text);
+	EXPECT_EQ(0, pcb->StyleAt(3));
+	EXPECT_TRUE(pcb->SetStyleFor(2, 3, 5, '\xff'));
+	EXPECT_FALSE(pcb->SetStyleFor(2, 3, 5, '\xff'));
+	EXPECT_TRUE(pcb->SetStyleAt(7, 9));
+	unsigned char styles[8];
+	pcb->GetStyleRange(styles, 0, 8);
+	const unsigned char expected[8] = {0, 0, 5, 5, 5, 0, 0, 9};
+	EXPECT_EQ(0, memcmp(styles, expected, 8));
+	EXPECT_TRUE(pcb->IsMapped());
+}
+
+TEST_F(CellBufferTest, EditMapped) {
+	MappedString text("ab\ncd");
+	pcb->AdoptMapped(&text);
+	pcb->SetStyleFor(0, 2, 3, '\xff');
+	bool startSequence = false;
+	pcb->InsertString(1, "X\n", 2, startSequence);
+	// Only the inserted text is stored, the rest is still read from the mapping
+	EXPECT_TRUE(pcb->IsMapped());
+	EXPECT_EQ(0, text.releases);
+	EXPECT_EQ(7, pcb->Length());
+	char buffer[8] = "";
+	pcb->GetCharRange(buffer, 0, 7);
+	EXPECT_EQ(0, strcmp("aX\nb\ncd", buffer));
+	EXPECT_EQ('b', pcb->CharAt(3));
+	EXPECT_EQ(3, pcb->Lines());
+	EXPECT_EQ(0, strcmp("aX\nb\ncd", pcb->BufferPointer()));
+	EXPECT_EQ(3, pcb->StyleAt(0));
+	EXPECT_EQ(0, pcb->StyleAt(1));
+	EXPECT_EQ(3, pcb->StyleAt(3));
+	// Undo restores the original text
+	EXPECT_EQ(1, pcb->StartUndo());
+	pcb->PerformUndoStep();
+	EXPECT_EQ(5, pcb->Length());
+	EXPECT_EQ(0, strcmp("ab\ncd", pcb->BufferPointer()));
+	EXPECT_FALSE(pcb->IsMapped());
+	EXPECT_EQ(1, text.releases);
+}
+
+TEST_F(CellBufferTest, EditMappedMatchesUnmapped) {
+	const char *original = "one\r\ntwo\rthree\nfour\r\n\r\nfive";
+	MappedString text(original);
+	pcb->AdoptMapped(&text);
+	CellBuffer plain;
+	bool startSequence = false;
+	plain.InsertString(0, original, strlen(original), startSequence);
+	const char *inserts[] = {"x", "\r", "\n", "ab\r\ncd", "\r\n"};
+	unsigned int seed = 7;
+	for (int step = 0; step < 300; step++) {
+		seed = seed * 1103515245 + 12345;
+		const Position length = plain.Length();
+		const Position position = (seed >> 8) % (length + 1);
+		if (((seed >> 4) % 3 == 0) && (position < length)) {
+			const Position deleteLength = MinPosition(1 + (seed >> 20) % 4, length - position);
+			if (deleteLength == length)
+				continue;
+			pcb->DeleteChars(position, deleteLength, startSequence);
+			plain.DeleteChars(position, deleteLength, startSequence);
+		} else {
+			const char *s = inserts[(seed >> 16) % 5];
+			pcb->InsertString(position, s, strlen(s), startSequence);
+			plain.InsertString(position, s, strlen(s), startSequence);
+		}
+		ASSERT_EQ(plain.Length(), pcb->Length());
+		ASSERT_EQ(plain.Lines(), pcb->Lines());
+		for (int line = 0; line < plain.Lines(); line++)
+			ASSERT_EQ(plain.LineStart(line), pcb->LineStart(line));
+		for (Position i = 0; i < plain.Length(); i++)
+			ASSERT_EQ(plain.CharAt(i), pcb->CharAt(i));
+	}
+	EXPECT_TRUE(pcb->IsMapped());
+	EXPECT_EQ(0, strcmp(plain.BufferPointer(), pcb->BufferPointer()));
+}
+
+TEST_F(CellBufferTest, DeleteAllMapped) {
+	MappedString text("abc\ndef");
+	pcb->AdoptMapped(&text);
+	bool startSequence = false;
+	pcb->DeleteChars(0, 7, startSequence);
+	EXPECT_FALSE(pcb->IsMapped());
+	EXPECT_EQ(1, text.releases);
+	EXPECT_EQ(0, pcb->Length());
+	EXPECT_EQ(1, pcb->Lines());
+}
+
+TEST_F(CellBufferTest, BufferPointerMaterialises) {
+	MappedString text("abc");
+	pcb->AdoptMapped(&text);
+	EXPECT_EQ(0, strcmp("abc", pcb->BufferPointer()));
+	EXPECT_FALSE(pcb->IsMapped());
+	EXPECT_EQ(1, text.releases);
+}
+
+TEST_F(CellBufferTest, RedoDiscardedByNewAction) {
+	bool startSequence = false;
+	pcb->InsertString(0, "abc", 3, startSequence);
+	pcb->BeginUndoAction();
+	pcb->DeleteChars(1, 1, startSequence);
+	pcb->EndUndoAction();
+	EXPECT_EQ(1, pcb->StartUndo());
+	pcb->PerformUndoStep();
+	EXPECT_TRUE(pcb->CanRedo());
+	// Replaces the redo action and its text
+	pcb->BeginUndoAction();
+	pcb->InsertString(3, "de", 2, startSequence);
+	pcb->EndUndoAction();
+	EXPECT_FALSE(pcb->CanRedo());
+	EXPECT_EQ(0, strcmp("abcde", pcb->BufferPointer()));
+	EXPECT_EQ(1, pcb->StartUndo());
+	const Action &action = pcb->GetUndoStep();
+	EXPECT_EQ(insertAction, action.at);
+	EXPECT_EQ(0, memcmp("de", action.data, 2));
+	pcb->PerformUndoStep();
+	EXPECT_EQ(1, pcb->StartUndo());
+	pcb->PerformUndoStep();
+	EXPECT_EQ(0, pcb->Length());
+}
+
+TEST_F(CellBufferTest, UndoMemoryLimit) {
+	std::string text(UndoArena::chunkSize / 4, 'x');
+	bool startSequence = false;
+	for (int i = 0; i < 40; i++) {
+		pcb->BeginUndoAction();
+		pcb->InsertString(pcb->Length(), text.c_str(), static_cast<int>(text.length()), startSequence);
+		pcb->EndUndoAction();
+	}
+	const Position use = pcb->UndoMemoryUse();
+	EXPECT_GE(use, 40 * static_cast<Position>(text.length()));
+	// Each user operation is an action followed by a start action
+	EXPECT_EQ(80, pcb->UndoActions());
+	pcb->SetUndoMemoryLimit(use / 2);
+	EXPECT_LE(pcb->UndoMemoryUse(), use / 2);
+	EXPECT_LT(pcb->UndoActions(), 80);
+	const int operations = pcb->UndoActions() / 2;
+	// The remaining history can all be undone
+	int undone = 0;
+	while (pcb->CanUndo()) {
+		const int steps = pcb->StartUndo();
+		for (int step = 0; step < steps; step++)
+			pcb->PerformUndoStep();
+		undone++;
+	}
+	EXPECT_EQ(operations, undone);
+	EXPECT_EQ((40 - undone) * static_cast<Position>(text.length()), pcb->Length());
+	EXPECT_FALSE(pcb->IsSavePoint());
+}
+
+TEST_F(CellBufferTest, SaveAndLoadUndoHistory) {
+	bool startSequence = false;
+	pcb->InsertString(0, "abc", 3, startSequence);
+	pcb->BeginUndoAction();
+	pcb->InsertString(3, "def", 3, startSequence);
+	pcb->DeleteChars(0, 1, startSequence);
+	pcb->EndUndoAction();
+	// One step is left to redo
+	pcb->InsertString(5, "g", 1, startSequence);
+	EXPECT_EQ(1, pcb->StartUndo());
+	pcb->PerformUndoStep();
+	EXPECT_EQ(0, CellBuffer().SaveUndoHistory(NULL));
+	std::string history(pcb->SaveUndoHistory(NULL), '\0');
+	pcb->SaveUndoHistory(&history[0]);
+
+	CellBuffer cbOther;
+	cbOther.SetUndoCollection(false);
+	cbOther.InsertString(0, "bcdef", 5, startSequence);
+	cbOther.SetUndoCollection(true);
+	cbOther.SetSavePoint();
+	EXPECT_TRUE(cbOther.LoadUndoHistory(history.c_str(), static_cast<Position>(history.length())));
+	EXPECT_TRUE(cbOther.IsSavePoint());
+	EXPECT_TRUE(cbOther.CanRedo());
+	EXPECT_EQ(1, cbOther.StartRedo());
+	cbOther.PerformRedoStep();
+	EXPECT_EQ(0, strcmp("bcdefg", cbOther.BufferPointer()));
+	EXPECT_EQ(1, cbOther.StartUndo());
+	cbOther.PerformUndoStep();
+	EXPECT_EQ(2, cbOther.StartUndo());
+	cbOther.PerformUndoStep();
+	cbOther.PerformUndoStep();
+	EXPECT_EQ(1, cbOther.StartUndo());
+	cbOther.PerformUndoStep();
+	EXPECT_EQ(0, cbOther.Length());
+	EXPECT_FALSE(cbOther.CanUndo());
+}
+
+TEST_F(CellBufferTest, LoadUndoHistoryOfOtherText) {
+	bool startSequence = false;
+	pcb->InsertString(0, "abc", 3, startSequence);
+	std::string history(pcb->SaveUndoHistory(NULL), '\0');
+	pcb->SaveUndoHistory(&history[0]);
+
+	CellBuffer cbOther;
+	cbOther.SetUndoCollection(false);
+	cbOther.InsertString(0, "abd", 3, startSequence);
+	cbOther.SetUndoCollection(true);
+	cbOther.SetSavePoint();
+	EXPECT_FALSE(cbOther.LoadUndoHistory(history.c_str(), static_cast<Position>(history.length())));
+	EXPECT_FALSE(cbOther.CanUndo());
+	// Damaged history is not loaded
+	cbOther.DeleteChars(2, 1, startSequence);
+	cbOther.InsertString(2, "c", 1, startSequence);
+	cbOther.SetSavePoint();
+	EXPECT_FALSE(cbOther.LoadUndoHistory(history.c_str(), static_cast<Position>(history.length()) - 1));
+	EXPECT_TRUE(cbOther.LoadUndoHistory(history.c_str(), static_cast<Position>(history.length())));
+	EXPECT_TRUE(cbOther.CanUndo());
+}
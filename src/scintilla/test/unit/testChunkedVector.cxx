@@ -0,0 +1,163 @@
+// Unit Tests for Scintilla internal data structures
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Platform.h"
+
+#include "SplitVector.h"
+#include "Partitioning.h"
+#include "ChunkedVector.h"
+
+#include <gtest/gtest.h>
+
+// Test ChunkedVector.
+
+const int chunkSizeTest = 16;
+
+class ChunkedVectorTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		pcv = new ChunkedVector<char>;
+		pcv->SetChunkSize(chunkSizeTest);
+	}
+
+	virtual void TearDown() {
+		delete pcv;
+		pcv = 0;
+	}
+
+	ChunkedVector<char> *pcv;
+};
+
+static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+const int lengthAlphabet = 52;
+
+TEST_F(ChunkedVectorTest, IsEmptyInitially) {
+	EXPECT_EQ(0, pcv->Length());
+	EXPECT_EQ(1, pcv->Chunks());
+	EXPECT_EQ(0, pcv->ValueAt(0));
+}
+
+TEST_F(ChunkedVectorTest, InsertSplits) {
+	pcv->InsertFromArray(0, alphabet, 0, lengthAlphabet);
+	EXPECT_EQ(lengthAlphabet, pcv->Length());
+	EXPECT_EQ(4, pcv->Chunks());
+	for (int i=0; i<lengthAlphabet; i++) {
+		EXPECT_EQ(alphabet[i], pcv->ValueAt(i));
+	}
+	EXPECT_EQ(0, pcv->ValueAt(-1));
+	EXPECT_EQ(0, pcv->ValueAt(lengthAlphabet));
+}
+
+TEST_F(ChunkedVectorTest, GetRangeOverChunks) {
+	pcv->InsertFromArray(0, alphabet, 0, lengthAlphabet);
+	char buffer[lengthAlphabet];
+	pcv->GetRange(buffer, 10, 30);
+	EXPECT_EQ(0, memcmp(buffer, alphabet + 10, 30));
+}
+
+TEST_F(ChunkedVectorTest, SetValue) {
+	pcv->InsertValue(0, 40, 'x');
+	pcv->SetValueAt(20, 'y');
+	pcv->SetValueAt(40, 'z');
+	EXPECT_EQ(40, pcv->Length());
+	EXPECT_EQ('x', pcv->ValueAt(19));
+	EXPECT_EQ('y', pcv->ValueAt(20));
+	EXPECT_EQ(0, pcv->ValueAt(40));
+}
+
+TEST_F(ChunkedVectorTest, DeleteOverChunks) {
+	pcv->InsertFromArray(0, alphabet, 0, lengthAlphabet);
+	pcv->DeleteRange(5, 40);
+	EXPECT_EQ(12, pcv->Length());
+	char buffer[12];
+	pcv->GetRange(buffer, 0, 12);
+	EXPECT_EQ(0, memcmp(buffer, "abcdeTUVWXYZ", 12));
+	EXPECT_EQ(2, pcv->Chunks());
+	pcv->DeleteRange(3, 4);
+	EXPECT_EQ(1, pcv->Chunks());
+	EXPECT_EQ('a', pcv->ValueAt(0));
+	EXPECT_EQ('V', pcv->ValueAt(3));
+}
+
+TEST_F(ChunkedVectorTest, DeleteAll) {
+	pcv->InsertFromArray(0, alphabet, 0, lengthAlphabet);
+	pcv->DeleteRange(0, lengthAlphabet);
+	EXPECT_EQ(0, pcv->Length());
+	EXPECT_EQ(1, pcv->Chunks());
+	pcv->InsertFromArray(0, alphabet, 0, 3);
+	EXPECT_EQ('c', pcv->ValueAt(2));
+}
+
+TEST_F(ChunkedVectorTest, BufferPointerJoins) {
+	pcv->InsertFromArray(0, alphabet, 0, lengthAlphabet);
+	const char *text = pcv->BufferPointer();
+	EXPECT_EQ(1, pcv->Chunks());
+	EXPECT_EQ(0, memcmp(text, alphabet, lengthAlphabet));
+	EXPECT_EQ(0, text[lengthAlphabet]);
+	// Next modification splits again
+	pcv->InsertFromArray(26, "-", 0, 1);
+	EXPECT_LT(1, pcv->Chunks());
+	EXPECT_EQ('-', pcv->ValueAt(26));
+	EXPECT_EQ('A', pcv->ValueAt(27));
+}
+
+TEST_F(ChunkedVectorTest, UnboundedIsSingleChunk) {
+	pcv->InsertFromArray(0, alphabet, 0, lengthAlphabet);
+	pcv->SetChunkSize(0);
+	EXPECT_EQ(1, pcv->Chunks());
+	pcv->InsertFromArray(0, alphabet, 0, lengthAlphabet);
+	EXPECT_EQ(1, pcv->Chunks());
+	EXPECT_EQ(2 * lengthAlphabet, pcv->Length());
+	pcv->SetChunkSize(chunkSizeTest);
+	EXPECT_LT(1, pcv->Chunks());
+	EXPECT_EQ('a', pcv->ValueAt(lengthAlphabet));
+}
+
+TEST_F(ChunkedVectorTest, ScatteredEditsMatchSplitVector) {
+	SplitVector<char> sv;
+	srand(1);
+	for (int i=0; i<2000; i++) {
+		const ptrdiff_t length = sv.Length();
+		const ptrdiff_t position = length ? rand() % (length + 1) : 0;
+		if ((rand() % 3) || (length < 10)) {
+			const int from = rand() % 40;
+			const int insertLength = rand() % 12 + 1;
+			sv.InsertFromArray(position, alphabet, from, insertLength);
+			pcv->InsertFromArray(position, alphabet, from, insertLength);
+		} else {
+			ptrdiff_t deleteLength = rand() % 30 + 1;
+			if (position + deleteLength > length)
+				deleteLength = length - position;
+			sv.DeleteRange(position, deleteLength);
+			pcv->DeleteRange(position, deleteLength);
+		}
+		ASSERT_EQ(sv.Length(), pcv->Length());
+	}
+	for (ptrdiff_t j=0; j<sv.Length(); j++) {
+		ASSERT_EQ(sv.ValueAt(j), pcv->ValueAt(j));
+	}
+	EXPECT_EQ(0, strcmp(sv.BufferPointer(), pcv->BufferPointer()));
+}
+
+TEST_F(ChunkedVectorTest, RangeAtStopsAtChunkEnd) {
+	pcv->InsertFromArray(0, alphabet, 0, lengthAlphabet);
+	ptrdiff_t lengthRange = 0;
+	const char *range = pcv->RangeAt(0, &lengthRange);
+	EXPECT_LT(0, lengthRange);
+	EXPECT_GE(chunkSizeTest, lengthRange);
+	EXPECT_EQ(0, memcmp(range, alphabet, lengthRange));
+	// Walking the ranges covers every element once
+	ptrdiff_t position = 0;
+	while (position < lengthAlphabet) {
+		range = pcv->RangeAt(position, &lengthRange);
+		ASSERT_LT(0, lengthRange);
+		EXPECT_EQ(0, memcmp(range, alphabet + position, lengthRange));
+		position += lengthRange;
+	}
+	EXPECT_EQ(lengthAlphabet, position);
+	EXPECT_EQ(0, pcv->RangeAt(lengthAlphabet, &lengthRange));
+	EXPECT_EQ(0, lengthRange);
+}
@@ -4,6 +4,8 @@
 
 #include "Platform.h"
 
+#include "Sci_Position.h"
+#include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
 #include "RunStyles.h"
@@ -144,3 +146,26 @@ TEST_F(ContractionStateTest, ChangeHeight) {
 	EXPECT_EQ(2, pcs->GetHeight(1));
 	EXPECT_EQ(1, pcs->GetHeight(2));
 }
+
+TEST_F(ContractionStateTest, SetFoldState) {
+	pcs->InsertLines(0,7);
+	pcs->SetHeight(4, 2);
+	const char visibleNew[] = { 1, 0, 0, 1, 0, 1 };
+	const char expandedNew[] = { 0, 1, 1, 0, 1, 1 };
+	EXPECT_EQ(true, pcs->SetFoldState(1, 6, visibleNew, expandedNew));
+	EXPECT_EQ(false, pcs->SetFoldState(1, 6, visibleNew, expandedNew));
+	for (int l=0;l<6;l++) {
+		EXPECT_EQ(visibleNew[l] != 0, pcs->GetVisible(l+1));
+		EXPECT_EQ(expandedNew[l] != 0, pcs->GetExpanded(l+1));
+	}
+	EXPECT_EQ(6, pcs->LinesDisplayed());
+	EXPECT_EQ(2, pcs->DisplayFromDoc(3));
+	EXPECT_EQ(4, pcs->DisplayFromDoc(6));
+	EXPECT_EQ(6, pcs->DocFromDisplay(4));
+
+	const char allVisible[] = { 1, 1, 1, 1, 1, 1 };
+	EXPECT_EQ(true, pcs->SetFoldState(1, 6, allVisible, allVisible));
+	EXPECT_EQ(9, pcs->LinesDisplayed());
+	EXPECT_EQ(false, pcs->HiddenLines());
+	EXPECT_EQ(-1, pcs->ContractedNext(0));
+}
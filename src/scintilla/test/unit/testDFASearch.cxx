@@ -0,0 +1,162 @@
+// Unit Tests for Scintilla internal data structures
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Platform.h"
+
+#include "Sci_Position.h"
+#include "CharClassify.h"
+#include "RESearch.h"
+#include "DFASearch.h"
+
+#include <gtest/gtest.h>
+
+// Test DFASearch.
+
+// Hands out the text in small blocks so matches cross block boundaries.
+class BlockString : public BlockIndexer {
+public:
+	const char *s;
+	Sci_Position length;
+	Sci_Position blockSize;
+	BlockString(const char *s_, Sci_Position blockSize_) :
+		s(s_), length(static_cast<Sci_Position>(strlen(s_))), blockSize(blockSize_) {
+	}
+	virtual ~BlockString() {
+	}
+	virtual char CharAt(Sci_Position index) {
+		return ((index >= 0) && (index < length)) ? s[index] : '\0';
+	}
+	virtual const char *RangeAt(Sci_Position position, Sci_Position *rangeLength) {
+		if ((position < 0) || (position >= length)) {
+			*rangeLength = 0;
+			return 0;
+		}
+		const Sci_Position blockEnd = (position / blockSize + 1) * blockSize;
+		*rangeLength = ((blockEnd < length) ? blockEnd : length) - position;
+		return s + position;
+	}
+	virtual Sci_Position Length() {
+		return length;
+	}
+};
+
+class DFASearchTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		pcc = new CharClassify();
+		pds = new DFASearch(pcc);
+	}
+
+	virtual void TearDown() {
+		delete pds;
+		pds = 0;
+		delete pcc;
+		pcc = 0;
+	}
+
+	bool Find(const char *pattern, const char *text, bool posix=false, bool caseSensitive=true) {
+		EXPECT_EQ(NULL, pds->Compile(pattern, static_cast<Sci_Position>(strlen(pattern)), caseSensitive, posix));
+		BlockString bs(text, 3);
+		return pds->Execute(bs, 0, bs.Length()) != 0;
+	}
+
+	CharClassify *pcc;
+	DFASearch *pds;
+};
+
+TEST_F(DFASearchTest, Literal) {
+	EXPECT_TRUE(Find("needle", "haystack with a needle in it"));
+	EXPECT_EQ(16, pds->bopat[0]);
+	EXPECT_EQ(22, pds->eopat[0]);
+	EXPECT_FALSE(Find("needle", "haystack"));
+}
+
+TEST_F(DFASearchTest, CaseInsensitive) {
+	EXPECT_TRUE(Find("NeEdLe", "a needle", false, false));
+	EXPECT_EQ(2, pds->bopat[0]);
+	EXPECT_FALSE(Find("NeEdLe", "a needle", false, true));
+}
+
+TEST_F(DFASearchTest, LeftmostThenFirstAlternative) {
+	EXPECT_TRUE(Find("ab\\|abcd", "xxabcd"));
+	EXPECT_EQ(2, pds->bopat[0]);
+	EXPECT_EQ(4, pds->eopat[0]);
+	EXPECT_TRUE(Find("cd|abcd", "xxabcd", true));
+	EXPECT_EQ(2, pds->bopat[0]);
+	EXPECT_EQ(6, pds->eopat[0]);
+}
+
+TEST_F(DFASearchTest, GreedyAndLazy) {
+	EXPECT_TRUE(Find("<.*>", "a<b>c<d>e"));
+	EXPECT_EQ(1, pds->bopat[0]);
+	EXPECT_EQ(8, pds->eopat[0]);
+	EXPECT_TRUE(Find("<.*?>", "a<b>c<d>e"));
+	EXPECT_EQ(1, pds->bopat[0]);
+	EXPECT_EQ(4, pds->eopat[0]);
+}
+
+TEST_F(DFASearchTest, DotStopsAtLineEnd) {
+	EXPECT_TRUE(Find("a.*", "xab\r\ncd"));
+	EXPECT_EQ(1, pds->bopat[0]);
+	EXPECT_EQ(3, pds->eopat[0]);
+}
+
+TEST_F(DFASearchTest, BoundedRepetition) {
+	EXPECT_TRUE(Find("[0-9]\\{3,4\\}", "12 12345"));
+	EXPECT_EQ(3, pds->bopat[0]);
+	EXPECT_EQ(7, pds->eopat[0]);
+	EXPECT_TRUE(Find("x{2}", "x xx", true));
+	EXPECT_EQ(2, pds->bopat[0]);
+}
+
+TEST_F(DFASearchTest, LineAnchors) {
+	EXPECT_TRUE(Find("^b.*$", "ab\nbc\r\nd"));
+	EXPECT_EQ(3, pds->bopat[0]);
+	EXPECT_EQ(5, pds->eopat[0]);
+	EXPECT_TRUE(Find("c$", "abc"));
+	EXPECT_EQ(2, pds->bopat[0]);
+	EXPECT_FALSE(Find("^c", "abc"));
+}
+
+TEST_F(DFASearchTest, WordBoundaries) {
+	EXPECT_TRUE(Find("\\<is\\>", "this is"));
+	EXPECT_EQ(5, pds->bopat[0]);
+}
+
+TEST_F(DFASearchTest, Tags) {
+	EXPECT_TRUE(Find("\\([a-z]+\\)=\\([0-9]+\\)", "  key=123;"));
+	BlockString bs("  key=123;", 3);
+	EXPECT_TRUE(pds->GrabMatches(bs));
+	EXPECT_EQ(2, pds->bopat[1]);
+	EXPECT_EQ(5, pds->eopat[1]);
+	EXPECT_STREQ("key", pds->pat[1]);
+	EXPECT_EQ(6, pds->bopat[2]);
+	EXPECT_EQ(9, pds->eopat[2]);
+	EXPECT_STREQ("123", pds->pat[2]);
+}
+
+TEST_F(DFASearchTest, SearchRange) {
+	EXPECT_EQ(NULL, pds->Compile("ab", 2, true, false));
+	BlockString bs("ab ab ab", 3);
+	EXPECT_TRUE(pds->Execute(bs, 1, 8) != 0);
+	EXPECT_EQ(3, pds->bopat[0]);
+	// A match must end before the end of the range
+	EXPECT_FALSE(pds->Execute(bs, 7, 8) != 0);
+}
+
+TEST_F(DFASearchTest, CompileErrors) {
+	EXPECT_TRUE(NULL != pds->Compile("\\(a\\)\\1", 7, true, false));
+	EXPECT_TRUE(NULL != pds->Compile("(a", 2, true, true));
+	EXPECT_TRUE(NULL != pds->Compile("[a", 2, true, false));
+}
+
+TEST_F(DFASearchTest, StatesAreCached) {
+	EXPECT_TRUE(Find("[a-c]+d", "xxabcabcd"));
+	const int states = pds->StatesBuilt();
+	EXPECT_LT(0, states);
+	EXPECT_TRUE(Find("[a-c]+d", "xxabcabcd"));
+	EXPECT_EQ(states, pds->StatesBuilt());
+	EXPECT_EQ(0, pds->CacheResets());
+}
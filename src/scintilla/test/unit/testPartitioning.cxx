@@ -1,5 +1,6 @@
 // Unit Tests for Scintilla internal data structures
 
+#include <stddef.h>
 #include <string.h>
 
 #include "Platform.h"
@@ -19,7 +20,7 @@ static const int testArray[lengthTestArray] = {3, 4, 5, 6, 7, 8, 9, 10};
 class SplitVectorWithRangeAddTest : public ::testing::Test {
 protected:
 	virtual void SetUp() {
-		psvwra = new SplitVectorWithRangeAdd(growSize);
+		psvwra = new SplitVectorWithRangeAdd<int>(growSize);
 	}
 
 	virtual void TearDown() {
@@ -27,7 +28,7 @@ protected:
 		psvwra = 0;
 	}
 
-	SplitVectorWithRangeAdd *psvwra;
+	SplitVectorWithRangeAdd<int> *psvwra;
 };
 
 TEST_F(SplitVectorWithRangeAddTest, IsEmptyInitially) {
@@ -50,7 +51,7 @@ TEST_F(SplitVectorWithRangeAddTest, IncrementExceptEnds) {
 class PartitioningTest : public ::testing::Test {
 protected:
 	virtual void SetUp() {
-		pp = new Partitioning(growSize);
+		pp = new Partitioning<int>(growSize);
 	}
 
 	virtual void TearDown() {
@@ -58,7 +59,7 @@ protected:
 		pp = 0;
 	}
 
-	Partitioning *pp;
+	Partitioning<int> *pp;
 };
 
 TEST_F(PartitioningTest, IsEmptyInitially) {
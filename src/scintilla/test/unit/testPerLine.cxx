@@ -0,0 +1,136 @@
+// Unit Tests for Scintilla internal data structures
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Platform.h"
+
+#include "Scintilla.h"
+#include "Position.h"
+#include "SplitVector.h"
+#include "Partitioning.h"
+#include "ChunkedVector.h"
+#include "CellBuffer.h"
+#include "PerLine.h"
+
+#include <gtest/gtest.h>
+
+// Test LineLevels.
+
+const int header = SC_FOLDLEVELHEADERFLAG;
+const int white = SC_FOLDLEVELWHITEFLAG;
+const int base = SC_FOLDLEVELBASE;
+
+class LineLevelsTest : public ::testing::Test {
+protected:
+	virtual void SetUp() {
+		pll = new LineLevels();
+		lines = 0;
+	}
+
+	virtual void TearDown() {
+		delete pll;
+		pll = 0;
+	}
+
+	void SetLevels(const int *levels, int length) {
+		lines = length;
+		for (int line = 0; line < length; line++)
+			pll->SetLevel(line, levels[line], lines);
+	}
+
+	// The linear searches the index replaces
+	int FirstNotAboveSlow(int lineStart, int lineEnd, int level) {
+		for (int line = lineStart; line < lineEnd; line++) {
+			int levelLine = pll->GetLevel(line);
+			if (!(levelLine & white) && ((levelLine & SC_FOLDLEVELNUMBERMASK) <= level))
+				return line;
+		}
+		return -1;
+	}
+
+	int LastHeaderBelowSlow(int line, int level) {
+		for (int lineLook = line - 1; lineLook >= 0; lineLook--) {
+			int levelLine = pll->GetLevel(lineLook);
+			if ((levelLine & header) && ((levelLine & SC_FOLDLEVELNUMBERMASK) < level))
+				return lineLook;
+		}
+		return -1;
+	}
+
+	LineLevels *pll;
+	int lines;
+};
+
+TEST_F(LineLevelsTest, IsEmptyInitially) {
+	EXPECT_EQ(base, pll->GetLevel(0));
+	EXPECT_EQ(0, pll->FirstNotAbove(0, 5, base));
+	EXPECT_EQ(-1, pll->FirstNotAbove(0, 5, base - 1));
+	EXPECT_EQ(-1, pll->LastHeaderBelow(5, base + 1));
+}
+
+TEST_F(LineLevelsTest, Folds) {
+	const int levels[] = {
+		base | header, base + 1, (base + 1) | header, base + 2, (base + 2) | white,
+		base + 1, base, base | header, (base + 1) | white, base + 1
+	};
+	SetLevels(levels, 10);
+	EXPECT_EQ(6, pll->FirstNotAbove(1, 10, base));
+	EXPECT_EQ(5, pll->FirstNotAbove(3, 10, base + 1));
+	EXPECT_EQ(-1, pll->FirstNotAbove(3, 5, base + 1));
+	EXPECT_EQ(-1, pll->FirstNotAbove(8, 10, base));
+	EXPECT_EQ(2, pll->LastHeaderBelow(4, base + 2));
+	EXPECT_EQ(0, pll->LastHeaderBelow(2, base + 1));
+	EXPECT_EQ(7, pll->LastHeaderBelow(9, base + 1));
+	EXPECT_EQ(-1, pll->LastHeaderBelow(9, base));
+}
+
+TEST_F(LineLevelsTest, InsertAndRemove) {
+	const int levels[] = { base | header, base + 1, base + 1, base };
+	SetLevels(levels, 4);
+	EXPECT_EQ(3, pll->FirstNotAbove(1, 4, base));
+	pll->InsertLine(0);
+	EXPECT_EQ(base | header, pll->GetLevel(1));
+	EXPECT_EQ(1, pll->LastHeaderBelow(2, base + 1));
+	pll->SetLevel(1, base + 1, 5);
+	EXPECT_EQ(4, pll->FirstNotAbove(1, 5, base));
+	EXPECT_EQ(0, pll->LastHeaderBelow(4, base + 1));
+	pll->RemoveLine(3);
+	EXPECT_EQ(3, pll->FirstNotAbove(1, 4, base));
+	pll->RemoveLine(0);
+	EXPECT_EQ(-1, pll->LastHeaderBelow(2, base + 1));
+}
+
+TEST_F(LineLevelsTest, MatchesLinearSearch) {
+	srand(1);
+	const int levels[] = { base };
+	SetLevels(levels, 1);
+	lines = 1;
+	for (int step = 0; step < 20000; step++) {
+		int action = rand() % 10;
+		if ((action < 3) || (lines < 2)) {
+			// Insert near the last change most of the time
+			int line = rand() % lines;
+			pll->InsertLine(line);
+			lines++;
+		} else if (action < 5) {
+			int line = 1 + rand() % (lines - 1);
+			pll->RemoveLine(line);
+			lines--;
+		} else {
+			int level = base + rand() % 6;
+			if (rand() % 3 == 0)
+				level |= header;
+			if (rand() % 5 == 0)
+				level |= white;
+			pll->SetLevel(rand() % lines, level, lines);
+		}
+		int lineStart = rand() % lines;
+		int lineEnd = lineStart + rand() % (lines - lineStart + 1);
+		int level = base + rand() % 6;
+		ASSERT_EQ(FirstNotAboveSlow(lineStart, lineEnd, level), pll->FirstNotAbove(lineStart, lineEnd, level));
+		int line = rand() % (lines + 1);
+		ASSERT_EQ(LastHeaderBelowSlow(line, level), pll->LastHeaderBelow(line, level));
+	}
+}
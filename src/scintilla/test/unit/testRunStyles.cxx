@@ -4,6 +4,8 @@
 
 #include "Platform.h"
 
+#include "Sci_Position.h"
+#include "Position.h"
 #include "SplitVector.h"
 #include "Partitioning.h"
 #include "RunStyles.h"
@@ -92,8 +94,8 @@ TEST_F(RunStylesTest, LongerRuns) {
 
 TEST_F(RunStylesTest, FillRange) {
 	prs->InsertSpace(0, 5);
-	int startFill = 1;
-	int lengthFill = 3;
+	Position startFill = 1;
+	Position lengthFill = 3;
 	EXPECT_EQ(true, prs->FillRange(startFill, 99, lengthFill));
 	EXPECT_EQ(1, startFill);
 	EXPECT_EQ(3, lengthFill);
@@ -113,14 +115,14 @@ TEST_F(RunStylesTest, FillRange) {
 
 TEST_F(RunStylesTest, FillRangeAlreadyFilled) {
 	prs->InsertSpace(0, 5);
-	int startFill = 1;
-	int lengthFill = 3;
+	Position startFill = 1;
+	Position lengthFill = 3;
 	EXPECT_EQ(true, prs->FillRange(startFill, 99, lengthFill));
 	EXPECT_EQ(1, startFill);
 	EXPECT_EQ(3, lengthFill);
 
-	int startFill2 = 2;
-	int lengthFill2 = 1;
+	Position startFill2 = 2;
+	Position lengthFill2 = 1;
 	// Compiler warnings if 'false' used instead of '0' as expected value:
 	EXPECT_EQ(0, prs->FillRange(startFill2, 99, lengthFill2));
 	EXPECT_EQ(2, startFill2);
@@ -135,14 +137,14 @@ TEST_F(RunStylesTest, FillRangeAlreadyFilled) {
 
 TEST_F(RunStylesTest, FillRangeAlreadyPartFilled) {
 	prs->InsertSpace(0, 5);
-	int startFill = 1;
-	int lengthFill = 2;
+	Position startFill = 1;
+	Position lengthFill = 2;
 	EXPECT_EQ(true, prs->FillRange(startFill, 99, lengthFill));
 	EXPECT_EQ(1, startFill);
 	EXPECT_EQ(2, lengthFill);
 
-	int startFill2 = 2;
-	int lengthFill2 = 2;
+	Position startFill2 = 2;
+	Position lengthFill2 = 2;
 	EXPECT_EQ(true, prs->FillRange(startFill2, 99, lengthFill2));
 	EXPECT_EQ(3, startFill2);
 	EXPECT_EQ(1, lengthFill2);
@@ -173,8 +175,8 @@ TEST_F(RunStylesTest, DeleteRange) {
 
 TEST_F(RunStylesTest, Find) {
 	prs->InsertSpace(0, 5);
-	int startFill = 1;
-	int lengthFill = 3;
+	Position startFill = 1;
+	Position lengthFill = 3;
 	EXPECT_EQ(true, prs->FillRange(startFill, 99, lengthFill));
 	EXPECT_EQ(1, startFill);
 	EXPECT_EQ(3, lengthFill);
@@ -210,8 +212,8 @@ TEST_F(RunStylesTest, AllSame) {
 	EXPECT_EQ(true, prs->AllSame());
 	EXPECT_EQ(0, prs->AllSameAs(88));
 	EXPECT_EQ(true, prs->AllSameAs(0));
-	int startFill = 1;
-	int lengthFill = 3;
+	Position startFill = 1;
+	Position lengthFill = 3;
 	EXPECT_EQ(true, prs->FillRange(startFill, 99, lengthFill));
 	EXPECT_EQ(0, prs->AllSame());
 	EXPECT_EQ(0, prs->AllSameAs(88));
@@ -226,8 +228,8 @@ TEST_F(RunStylesTest, FindWithReversion) {
 	prs->InsertSpace(0, 5);
 	EXPECT_EQ(1, prs->Runs());
 
-	int startFill = 1;
-	int lengthFill = 1;
+	Position startFill = 1;
+	Position lengthFill = 1;
 	EXPECT_EQ(true, prs->FillRange(startFill, 99, lengthFill));
 	EXPECT_EQ(1, startFill);
 	EXPECT_EQ(1, lengthFill);
@@ -1,5 +1,6 @@
 // Unit Tests for Scintilla internal data structures
 
+#include <stddef.h>
 #include <string.h>
 
 #include "Platform.h"
@@ -3,15 +3,16 @@
 /*
     Currently tested:
         SplitVector
+        ChunkedVector
         Partitioning
         RunStyles
         ContractionState
+        CellBuffer
 
     To do:
         Decoration
         DecorationList
         PerLine *
-        CellBuffer *
         Range
         StyledText
         CaseFolder ...
@@ -44,6 +45,9 @@ void Platform::Assert(const char *c, const char *file, int line) {
 	abort();
 }
 
+void Platform::DebugPrintf(const char *, ...) {
+}
+
 int main(int argc, char **argv) {
 	testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
@@ -13,6 +13,7 @@
 #include <time.h>
 #include <limits.h>
 #include <math.h>
+#include <process.h> //!-add-[BackgroundLexing]
 
 #include <vector>
 #include <map>
@@ -539,6 +540,8 @@ public:
 
 	void SetUnicodeMode(bool unicodeMode_);
 	void SetDBCSMode(int codePage_);
+	// Each surface measures with its own device context
+	bool ThreadSafeMeasureWidths() { return true; } //!-add-[WrapThreads]
 };
 
 #ifdef SCI_NAMESPACE
@@ -1187,6 +1190,8 @@ public:
 
 	void SetUnicodeMode(bool unicodeMode_);
 	void SetDBCSMode(int codePage_);
+	// DirectWrite text layouts may be created on any thread
+	bool ThreadSafeMeasureWidths() { return true; } //!-add-[WrapThreads]
 };
 
 #ifdef SCI_NAMESPACE
@@ -2486,10 +2491,14 @@ void ListBoxX::SetList(const char *list, char separator, char typesep) {
 
 	// Finally populate the listbox itself with the correct number of items
 	int count = lti.Count();
-	::SendMessage(lb, LB_INITSTORAGE, count, 0);
-	for (int j=0; j<count; j++) {
-		::SendMessage(lb, LB_ADDSTRING, 0, j+1);
-	}
+//!-start-[FuzzyAutoComplete]
+	// The list box has no data so only the rows shown are drawn from lti
+	::SendMessage(lb, LB_SETCOUNT, count, 0);
+//!-end-[FuzzyAutoComplete]
+//!	::SendMessage(lb, LB_INITSTORAGE, count, 0);
+//!	for (int j=0; j<count; j++) {
+//!		::SendMessage(lb, LB_ADDSTRING, 0, j+1);
+//!	}
 	SetRedraw(true);
 }
 
@@ -3013,6 +3022,66 @@ double ElapsedTime::Duration(bool reset) {
 	return result;
 }
 
+//!-start-[BackgroundLexing]
+class ThreadLockWin : public ThreadLock {
+	CRITICAL_SECTION cs;
+public:
+	ThreadLockWin() {
+		::InitializeCriticalSection(&cs);
+	}
+	virtual ~ThreadLockWin() {
+		::DeleteCriticalSection(&cs);
+	}
+	virtual void Lock() {
+		::EnterCriticalSection(&cs);
+	}
+	virtual void Unlock() {
+		::LeaveCriticalSection(&cs);
+	}
+};
+
+ThreadLock *ThreadLock::Allocate() {
+	return new ThreadLockWin();
+}
+
+class BackgroundThreadWin : public BackgroundThread {
+	HANDLE hThread;
+	Procedure procedure;
+	void *argument;
+	static unsigned __stdcall ThreadProcedure(void *pThread) {
+		BackgroundThreadWin *thread = static_cast<BackgroundThreadWin *>(pThread);
+		thread->procedure(thread->argument);
+		return 0;
+	}
+public:
+	BackgroundThreadWin(Procedure procedure_, void *argument_) :
+		hThread(NULL), procedure(procedure_), argument(argument_) {
+	}
+	virtual ~BackgroundThreadWin() {
+		if (hThread)
+			::CloseHandle(hThread);
+	}
+	bool Start() {
+		// _beginthreadex rather than CreateThread so the C runtime is set up for the thread
+		hThread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, ThreadProcedure, this, 0, NULL));
+		return hThread != NULL;
+	}
+	virtual void Join() {
+		if (hThread)
+			::WaitForSingleObject(hThread, INFINITE);
+	}
+};
+
+BackgroundThread *BackgroundThread::Start(Procedure procedure, void *argument) {
+	BackgroundThreadWin *thread = new BackgroundThreadWin(procedure, argument);
+	if (!thread->Start()) {
+		delete thread;
+		return NULL;
+	}
+	return thread;
+}
+//!-end-[BackgroundLexing]
+
 class DynamicLibraryImpl : public DynamicLibrary {
 protected:
 	HMODULE h;
@@ -37,6 +37,7 @@
 
 #include "ILexer.h"
 #include "Scintilla.h"
+#include "Position.h"
 
 #ifdef SCI_LEXER
 #include "SciLexer.h"
@@ -44,6 +45,7 @@
 #endif
 #include "SplitVector.h"
 #include "Partitioning.h"
+#include "ChunkedVector.h"
 #include "RunStyles.h"
 #include "ContractionState.h"
 #include "CellBuffer.h"
@@ -1746,7 +1748,7 @@ void ScintillaWin::InsertPasteText(const char *text, int len, SelectionPosition
 			text = convertedText;
 		}
 		if (isLine) {
-			int insertPos = pdoc->LineStart(pdoc->LineFromPosition(sel.MainCaret()));
+			Position insertPos = pdoc->LineStart(pdoc->LineFromPosition(sel.MainCaret()));
 			pdoc->InsertString(insertPos, text, len);
 			// add the newline if necessary
 			if ((len > 0) && (text[len-1] != '\n' && text[len-1] != '\r')) {
@@ -3,7 +3,7 @@ PlatWin.o: PlatWin.cxx ../include/Platform.h \
 ScintillaWin.o: ScintillaWin.cxx ../include/Platform.h \
  ../include/ILexer.h ../include/Scintilla.h ../src/SplitVector.h \
  ../src/Partitioning.h ../src/RunStyles.h ../src/ContractionState.h \
- ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h ../src/Indicator.h \
+ ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h ../src/Indicator.h \
  ../src/XPM.h ../src/LineMarker.h ../src/Style.h ../src/AutoComplete.h \
  ../src/ViewStyle.h ../src/CharClassify.h ../src/Decoration.h \
  ../src/Document.h ../src/Selection.h ../src/PositionCache.h \
@@ -19,7 +19,7 @@ Catalogue.o: ../src/Catalogue.cxx ../include/ILexer.h \
  ../lexlib/LexerModule.h ../src/Catalogue.h
 CellBuffer.o: ../src/CellBuffer.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/CellBuffer.h
+ ../src/ChunkedVector.h ../src/CellBuffer.h ../lexlib/CharacterSet.h
 CharClassify.o: ../src/CharClassify.cxx ../src/CharClassify.h
 ContractionState.o: ../src/ContractionState.cxx ../include/Platform.h \
  ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
@@ -29,12 +29,12 @@ Decoration.o: ../src/Decoration.cxx ../include/Platform.h \
  ../src/RunStyles.h ../src/Decoration.h
 Document.o: ../src/Document.cxx ../include/Platform.h ../include/ILexer.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+ ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/PerLine.h \
  ../src/CharClassify.h ../lexlib/CharacterSet.h ../src/Decoration.h \
- ../src/Document.h ../src/RESearch.h ../src/UniConversion.h
+ ../src/Document.h ../src/BackgroundLexer.h ../src/RESearch.h ../src/DFASearch.h ../src/UniConversion.h
 Editor.o: ../src/Editor.cxx ../include/Platform.h ../include/ILexer.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/RunStyles.h ../src/ContractionState.h ../src/CellBuffer.h \
+ ../src/RunStyles.h ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h \
  ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
  ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
  ../src/Decoration.h ../lexlib/LexAccessor.h ../lexlib/Accessor.h \
@@ -52,22 +52,30 @@ LineMarker.o: ../src/LineMarker.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/XPM.h ../src/LineMarker.h
 PerLine.o: ../src/PerLine.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/CellBuffer.h ../src/PerLine.h
+ ../src/ChunkedVector.h ../src/CellBuffer.h ../src/PerLine.h
 PositionCache.o: ../src/PositionCache.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
- ../src/RunStyles.h ../src/ContractionState.h ../src/CellBuffer.h \
+ ../src/RunStyles.h ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h \
  ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
  ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
  ../src/Decoration.h ../include/ILexer.h ../src/Document.h \
  ../src/Selection.h ../src/PositionCache.h
 RESearch.o: ../src/RESearch.cxx ../src/CharClassify.h ../src/RESearch.h
+DFASearch.o: ../src/DFASearch.cxx ../src/CharClassify.h ../src/RESearch.h \
+ ../src/DFASearch.h
+BackgroundLexer.o: ../src/BackgroundLexer.cxx ../include/Platform.h \
+ ../include/ILexer.h ../include/Scintilla.h ../src/Position.h \
+ ../src/SplitVector.h ../src/Partitioning.h ../src/ChunkedVector.h \
+ ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+ ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
+ ../src/BackgroundLexer.h
 RunStyles.o: ../src/RunStyles.cxx ../include/Platform.h \
  ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
  ../src/RunStyles.h
 ScintillaBase.o: ../src/ScintillaBase.cxx ../include/Platform.h \
  ../include/ILexer.h ../include/Scintilla.h ../lexlib/PropSetSimple.h \
  ../src/SplitVector.h ../src/Partitioning.h ../src/RunStyles.h \
- ../src/ContractionState.h ../src/CellBuffer.h ../src/CallTip.h \
+ ../src/ContractionState.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h \
  ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
  ../src/Style.h ../src/ViewStyle.h ../src/AutoComplete.h \
  ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
@@ -102,7 +110,7 @@ LexerSimple.o: ../lexlib/LexerSimple.cxx ../include/ILexer.h \
 PropSetSimple.o: ../lexlib/PropSetSimple.cxx ../lexlib/PropSetSimple.h
 StyleContext.o: ../lexlib/StyleContext.cxx ../include/ILexer.h \
  ../lexlib/LexAccessor.h ../lexlib/Accessor.h ../lexlib/StyleContext.h
-WordList.o: ../lexlib/WordList.cxx ../lexlib/WordList.h
+WordList.o: ../lexlib/WordList.cxx ../lexlib/WordList.h ../lexlib/CharacterSet.h
 LexAbaqus.o: ../lexers/LexAbaqus.cxx ../include/ILexer.h \
  ../include/Scintilla.h ../include/SciLexer.h ../lexlib/PropSetSimple.h \
  ../lexlib/WordList.h ../lexlib/LexAccessor.h ../lexlib/Accessor.h \
@@ -73,6 +73,8 @@ SOBJS=\
 	$(DIR_O)\PositionCache.obj \
 	$(DIR_O)\PropSetSimple.obj \
 	$(DIR_O)\RESearch.obj \
+	$(DIR_O)\DFASearch.obj \
+	$(DIR_O)\BackgroundLexer.obj \
 	$(DIR_O)\RunStyles.obj \
 	$(DIR_O)\ScintillaBase.obj \
 	$(DIR_O)\ScintillaWin.obj \
@@ -196,6 +198,8 @@ LOBJS=\
 	$(DIR_O)\PositionCache.obj \
 	$(DIR_O)\PropSetSimple.obj \
 	$(DIR_O)\RESearch.obj \
+	$(DIR_O)\DFASearch.obj \
+	$(DIR_O)\BackgroundLexer.obj \
 	$(DIR_O)\RunStyles.obj \
 	$(DIR_O)\ScintillaBaseL.obj \
 	$(DIR_O)\ScintillaWinL.obj \
@@ -244,7 +248,7 @@ $(DIR_O)\ScintillaWinS.obj: ScintillaWin.cxx
 # Dependencies
 
 # All lexers depend on this set of headers
-LEX_HEADERS= ..\include\ILexer.h ..\include\Scintilla.h ..\include\SciLexer.h \
+LEX_HEADERS= ..\include\ILexer.h ..\include\Sci_Position.h ..\include\Scintilla.h ..\include\SciLexer.h \
  ..\lexlib\Accessor.h ..\lexlib\CharacterSet.h ..\lexlib\LexAccessor.h \
  ..\lexlib\LexerModule.h ..\lexlib\StyleContext.h
 
@@ -255,7 +259,7 @@ $(DIR_O)\CallTip.obj: ../src/CallTip.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/CallTip.h
 $(DIR_O)\CellBuffer.obj: ../src/CellBuffer.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SVector.h ../src/SplitVector.h \
-  ../src/Partitioning.h ../src/CellBuffer.h
+  ../src/Partitioning.h ../src/ChunkedVector.h ../src/CellBuffer.h ../lexlib/CharacterSet.h
 $(DIR_O)\CharacterSet.obj: ../lexlib/CharacterSet.cxx ../lexlib/CharacterSet.h
 $(DIR_O)\CharClassify.obj: ../src/CharClassify.cxx ../src/CharClassify.h
 $(DIR_O)\ContractionState.obj: ../src/ContractionState.cxx ../include/Platform.h \
@@ -265,12 +269,12 @@ $(DIR_O)\Decoration.obj: ../src/Decoration.cxx ../include/Platform.h \
   ../src/RunStyles.h ../src/Decoration.h
 $(DIR_O)\Document.obj: ../src/Document.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SVector.h ../src/SplitVector.h \
-  ../src/Partitioning.h ../src/RunStyles.h ../src/CellBuffer.h \
+  ../src/Partitioning.h ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h \
   ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
-  ../src/RESearch.h ../src/PerLine.h
+  ../src/RESearch.h ../src/DFASearch.h ../src/PerLine.h ../src/BackgroundLexer.h
 $(DIR_O)\Editor.obj: ../src/Editor.cxx ../include/Platform.h ../include/Scintilla.h \
   ../src/ContractionState.h ../src/SVector.h ../src/SplitVector.h \
-  ../src/Partitioning.h ../src/CellBuffer.h ../src/KeyMap.h \
+  ../src/Partitioning.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/KeyMap.h \
   ../src/RunStyles.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../src/Document.h ../src/Editor.h ../src/Selection.h ../src/PositionCache.h
@@ -468,19 +472,27 @@ $(DIR_O)\PlatWin.obj: PlatWin.cxx ../include/Platform.h \
   ../src/UniConversion.h ../src/XPM.h
 $(DIR_O)\PositionCache.obj: ../src/Editor.cxx ../include/Platform.h ../include/Scintilla.h \
   ../src/ContractionState.h ../src/SVector.h ../src/SplitVector.h \
-  ../src/Partitioning.h ../src/CellBuffer.h ../src/KeyMap.h \
+  ../src/Partitioning.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/KeyMap.h \
   ../src/RunStyles.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../src/Document.h ../src/Editor.h ../src/Selection.h ../src/PositionCache.h
 $(DIR_O)\PropSetSimple.obj: ../lexlib/PropSetSimple.cxx ../include/Platform.h
 $(DIR_O)\RESearch.obj: ../src/RESearch.cxx ../src/CharClassify.h ../src/RESearch.h
+$(DIR_O)\DFASearch.obj: ../src/DFASearch.cxx ../src/CharClassify.h ../src/RESearch.h \
+  ../src/DFASearch.h
+$(DIR_O)\BackgroundLexer.obj: ../src/BackgroundLexer.cxx ../include/Platform.h \
+  ../include/ILexer.h ../include/Scintilla.h ../src/Position.h \
+  ../src/SplitVector.h ../src/Partitioning.h ../src/ChunkedVector.h \
+  ../src/RunStyles.h ../src/CellBuffer.h ../src/PerLine.h \
+  ../src/CharClassify.h ../src/Decoration.h ../src/Document.h \
+  ../src/BackgroundLexer.h
 $(DIR_O)\RunStyles.obj: ../src/RunStyles.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
   ../src/RunStyles.h
 $(DIR_O)\ScintillaBase.obj: ../src/ScintillaBase.cxx ../include/Platform.h \
   ../include/Scintilla.h \
   ../src/ContractionState.h ../src/SVector.h ../src/SplitVector.h \
-  ../src/Partitioning.h ../src/RunStyles.h ../src/CellBuffer.h \
+  ../src/Partitioning.h ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h \
   ../src/CallTip.h ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h \
   ../src/LineMarker.h ../src/Style.h ../src/ViewStyle.h \
   ../src/AutoComplete.h ../src/CharClassify.h ../src/Decoration.h \
@@ -488,7 +500,7 @@ $(DIR_O)\ScintillaBase.obj: ../src/ScintillaBase.cxx ../include/Platform.h \
 $(DIR_O)\ScintillaBaseL.obj: ../src/ScintillaBase.cxx ../include/Platform.h \
   ../include/Scintilla.h \
   ../src/ContractionState.h ../src/SVector.h ../src/SplitVector.h \
-  ../src/Partitioning.h ../src/RunStyles.h ../src/CellBuffer.h \
+  ../src/Partitioning.h ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h \
   ../src/CallTip.h ../src/KeyMap.h ../src/Indicator.h ../src/XPM.h \
   ../src/LineMarker.h ../src/Style.h ../src/ViewStyle.h \
   ../src/AutoComplete.h ../src/CharClassify.h ../src/Decoration.h \
@@ -496,7 +508,7 @@ $(DIR_O)\ScintillaBaseL.obj: ../src/ScintillaBase.cxx ../include/Platform.h \
 $(DIR_O)\ScintillaWin.obj: ScintillaWin.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/ContractionState.h \
   ../src/SVector.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h \
+  ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h \
   ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h ../src/Style.h \
   ../src/AutoComplete.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../src/Document.h ../src/Editor.h \
@@ -504,7 +516,7 @@ $(DIR_O)\ScintillaWin.obj: ScintillaWin.cxx ../include/Platform.h \
 $(DIR_O)\ScintillaWinS.obj: ScintillaWin.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/ContractionState.h \
   ../src/SVector.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h \
+  ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h \
   ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h ../src/Style.h \
   ../src/AutoComplete.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../src/Document.h ../src/Editor.h \
@@ -512,7 +524,7 @@ $(DIR_O)\ScintillaWinS.obj: ScintillaWin.cxx ../include/Platform.h \
 $(DIR_O)\ScintillaWinL.obj: ScintillaWin.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/ContractionState.h \
   ../src/SVector.h ../src/SplitVector.h ../src/Partitioning.h \
-  ../src/RunStyles.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h \
+  ../src/RunStyles.h ../src/ChunkedVector.h ../src/CellBuffer.h ../src/CallTip.h ../src/KeyMap.h \
   ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h ../src/Style.h \
   ../src/AutoComplete.h ../src/ViewStyle.h ../src/CharClassify.h \
   ../src/Decoration.h ../src/Document.h ../src/Editor.h \
@@ -528,5 +540,5 @@ $(DIR_O)\ViewStyle.obj: ../src/ViewStyle.cxx ../include/Platform.h \
   ../include/Scintilla.h ../src/SplitVector.h ../src/Partitioning.h \
   ../src/RunStyles.h ../src/Indicator.h ../src/XPM.h ../src/LineMarker.h \
   ../src/Style.h ../src/ViewStyle.h
-$(DIR_O)\WordList.obj: ../lexlib/WordList.cxx ../lexlib/WordList.h
+$(DIR_O)\WordList.obj: ../lexlib/WordList.cxx ../lexlib/WordList.h ../lexlib/CharacterSet.h
 $(DIR_O)\XPM.obj: ../src/XPM.cxx ../include/Platform.h ../src/XPM.h
@@ -8,14 +8,34 @@
 
 // http://www.microsoft.com/msj/0797/win320797.aspx
 
+//!-start-[ParallelGrep]
+#include <pthread.h>
+//!-end-[ParallelGrep]
+
 #include "Mutex.h"
 
 class GTKMutex : public Mutex {
 private:
+/*!
 	virtual void Lock() {}
 	virtual void Unlock() {}
 	GTKMutex() {}
 	virtual ~GTKMutex() {}
+*/
+//!-start-[ParallelGrep]
+	// Recursive like a critical section on Windows as the job queue may lock twice
+	pthread_mutex_t mutex;
+	virtual void Lock() { pthread_mutex_lock(&mutex); }
+	virtual void Unlock() { pthread_mutex_unlock(&mutex); }
+	GTKMutex() {
+		pthread_mutexattr_t attr;
+		pthread_mutexattr_init(&attr);
+		pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&mutex, &attr);
+		pthread_mutexattr_destroy(&attr);
+	}
+	virtual ~GTKMutex() { pthread_mutex_destroy(&mutex); }
+//!-end-[ParallelGrep]
 	friend class Mutex;
 };
 
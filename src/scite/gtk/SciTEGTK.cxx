@@ -28,6 +28,12 @@
 #include <sys/wait.h>
 #include <sys/types.h>
 #include <errno.h>
+#include <pthread.h> //!-add-[ParallelGrep]
+//!-start-[FileWatcher]
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+//!-end-[FileWatcher]
 
 #include "Scintilla.h"
 #include "ScintillaWidget.h"
@@ -63,6 +69,8 @@
 #include "Widget.h"
 #include "Cookie.h"
 #include "Worker.h"
+#include "FileWorker.h" //!-add-[ParallelGrep]
+#include "FileWatcher.h" //!-add-[FileWatcher]
 #include "SciTEBase.h"
 #include "SciTEKeys.h"
 
@@ -433,6 +441,28 @@ public:
 	}
 };
 
+//!-start-[ParallelGrep]
+enum {
+	WORK_GREP = WORK_PLATFORM + 1
+};
+
+class SciTEGTK;
+
+// Runs an internal Find in Files job on its own thread so the main loop goes on
+// while the files are searched
+class GrepJobWorker : public PostingWorker {
+public:
+	SciTEGTK *pSciTE;
+	Job job;
+	GrepSettings settings;	///< Read on the main thread before starting
+
+	GrepJobWorker(SciTEGTK *pSciTE_, const Job &job_, const GrepSettings &settings_) :
+		pSciTE(pSciTE_), job(job_), settings(settings_) {
+	}
+	virtual void Execute();
+};
+//!-end-[ParallelGrep]
+
 class SciTEGTK : public SciTEBase {
 
 protected:
@@ -463,6 +493,19 @@ protected:
 	SString lastOutput;
 	int lastFlags;
 
+//!-start-[FileWatcher]
+	// Changes to files from inotify
+	int fdWatch;
+	guint watchHandle;
+	std::map<int, FilePath> watchDirectories;	///< Directory of each inotify watch
+//!-end-[FileWatcher]
+//!-start-[ParallelGrep]
+	friend class GrepJobWorker;
+	GrepJobWorker *pGrepWorker;	///< Internal Find in Files job while it runs
+	pthread_t mainThread;
+	bool OnMainThread() const;
+//!-end-[ParallelGrep]
+
 	// For single instance
 	char uniqueInstance[MAX_PATH];
 	guint32 startupTimestamp;
@@ -707,6 +750,13 @@ public:
 	virtual bool PerformOnNewThread(Worker *pWorker);
 	virtual void PostOnMainThread(int cmd, Worker *pWorker);
 	static gboolean PostCallback(void *ptr);
+//!-start-[ParallelGrep]
+	virtual void WorkerCommand(int cmd, Worker *pWorker);
+	virtual void OutputAppendStringSynchronised(const char *s, int len = -1);
+	virtual void MakeOutputVisible();
+//!-end-[ParallelGrep]
+	virtual void WatchDirectories(const std::vector<FilePath> &directories); //!-add-[FileWatcher]
+	static gboolean WatchSignal(GIOChannel *source, GIOCondition condition, SciTEGTK *scitew); //!-add-[FileWatcher]
 	// Single instance
 	void SetStartupTime(const char *timestamp);
 };
@@ -727,6 +777,10 @@ SciTEGTK::SciTEGTK(Extension *ext) : SciTEBase(ext) {
 	inputHandle = 0;
 	inputChannel = 0;
 	lastFlags = 0;
+	fdWatch = -1; //!-add-[FileWatcher]
+	watchHandle = 0; //!-add-[FileWatcher]
+	pGrepWorker = 0; //!-add-[ParallelGrep]
+	mainThread = pthread_self(); //!-add-[ParallelGrep]
 
 	uniqueInstance[0] = '\0';
 	startupTimestamp = 0;
@@ -2046,6 +2100,7 @@ void SciTEGTK::FindInFilesCmd() {
 	//	props.Get("find.files"));
 	SelectionIntoProperties();
 	SString findCommand = props.GetNewExpand("find.command");
+/*!
 	if (findCommand == "") {
 		findCommand = sciteExecutable.AsInternal();
 		findCommand += " -grep ";
@@ -2063,6 +2118,25 @@ void SciTEGTK::FindInFilesCmd() {
 		//~ fprintf(stderr, "%s\n", findCommand.c_str());
 	}
 	AddCommand(findCommand, props.Get("find.directory"), jobCLI);
+*/
+//!-start-[ParallelGrep]
+	if (findCommand == "") {
+		// Search in this process on another thread as on Windows
+		// searchParams is "(w|~)(c|~)(d|~)(b|~)\0files\0text"
+		SString searchParams;
+		searchParams.append(wholeWord ? "w" : "~");
+		searchParams.append(matchCase ? "c" : "~");
+		searchParams.append(props.GetInt("find.in.dot") ? "d" : "~");
+		searchParams.append(props.GetInt("find.in.binary") ? "b" : "~");
+		searchParams.append("\0", 1);
+		searchParams.append(props.Get("find.files").c_str());
+		searchParams.append("\0", 1);
+		searchParams.append(props.Get("find.what").c_str());
+		AddCommand(searchParams, props.Get("find.directory"), jobGrep);
+	} else {
+		AddCommand(findCommand, props.Get("find.directory"), jobCLI);
+	}
+//!-end-[ParallelGrep]
 	if (jobQueue.commandCurrent > 0)
 		Execute();
 }
@@ -2441,12 +2515,24 @@ void SciTEGTK::ExecuteNext() {
 
 void SciTEGTK::ContinueExecute(int fromPoll) {
 	char buf[8192];
-	int count = read(fdFIFO, buf, sizeof(buf) - 1);
+//!-start-[OutputBatch]
+	int count = read(fdFIFO, buf, sizeof(buf));
 	if (count > 0) {
-		buf[count] = '\0';
-		OutputAppendString(buf);
-		lastOutput += buf;
+		// Read what is ready, up to a limit so the user interface stays responsive
+		// while a tool writes a lot, and show it in batches
+		int total = 0;
+		while (count > 0) {
+			OutputAppendBatched(buf, count, false);
+			if (lastFlags & jobRepSelMask)
+				lastOutput.append(buf, count);
+			total += count;
+			if (total >= 0x40000)
+				break;
+			count = read(fdFIFO, buf, sizeof(buf));
+		}
 	} else if (count == 0) {
+		OutputFlush(false);
+//!-end-[OutputBatch]
 		SString sExitMessage(WEXITSTATUS(exitStatus));
 		sExitMessage.insert(0, ">Exit code: ");
 		if (WIFSIGNALED(exitStatus)) {
@@ -2469,7 +2555,8 @@ void SciTEGTK::ContinueExecute(int fromPoll) {
 		// Move selection back to beginning of this run so that F4 will go
 		// to first error of this run.
 		if ((scrollOutput == 1) && returnOutputToCommand)
-			wOutput.Send(SCI_GOTOPOS, originalEnd);
+//!			wOutput.Send(SCI_GOTOPOS, originalEnd);
+			wOutput.Send(SCI_GOTOPOS, (originalEnd > outputRemoved) ? originalEnd - outputRemoved : 0);	//!-change-[OutputBatch]
 		returnOutputToCommand = true;
 		g_source_remove(inputHandle);
 		inputHandle = 0;
@@ -2487,6 +2574,7 @@ void SciTEGTK::ContinueExecute(int fromPoll) {
 			ExecuteNext();
 	} else { // count < 0
 		// The FIFO is not ready - expected when called from polling callback.
+		OutputFlush(false);	//!-add-[OutputBatch]
 		if (!fromPoll) {
 			OutputAppendString(">End Bad\n");
 		}
@@ -2503,6 +2591,74 @@ void SciTEGTK::ShowBackgroundProgress(const GUI::gui_string &explanation, int si
 	}
 }
 
+//!-start-[FileWatcher]
+// Watching directories rather than files sees files replaced by renaming as
+// many programs save them. When inotify is not available the watcher polls.
+void SciTEGTK::WatchDirectories(const std::vector<FilePath> &directories) {
+#ifdef __linux__
+	if ((fdWatch < 0) && !directories.empty()) {
+		fdWatch = inotify_init();
+		if (fdWatch < 0)
+			return;
+		fcntl(fdWatch, F_SETFL, fcntl(fdWatch, F_GETFL) | O_NONBLOCK);
+		fcntl(fdWatch, F_SETFD, FD_CLOEXEC);
+		GIOChannel *watchChannel = g_io_channel_unix_new(fdWatch);
+		watchHandle = g_io_add_watch(watchChannel, G_IO_IN, (GIOFunc)WatchSignal, this);
+		g_io_channel_unref(watchChannel);
+	}
+	if (fdWatch < 0)
+		return;
+	std::map<int, FilePath>::iterator it = watchDirectories.begin();
+	while (it != watchDirectories.end()) {
+		if (std::find(directories.begin(), directories.end(), it->second) == directories.end()) {
+			inotify_rm_watch(fdWatch, it->first);
+			watchDirectories.erase(it++);
+		} else {
+			++it;
+		}
+	}
+	for (size_t i = 0; i < directories.size(); i++) {
+		bool watched = false;
+		for (it = watchDirectories.begin(); (it != watchDirectories.end()) && !watched; ++it)
+			watched = it->second == directories[i];
+		if (!watched) {
+			int wd = inotify_add_watch(fdWatch, directories[i].AsInternal(),
+				IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO |
+				IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF);
+			if (wd >= 0)
+				watchDirectories[wd] = directories[i];
+		}
+	}
+#endif
+}
+
+// Only tells the watcher which files to look at so the user interface does not wait for them
+gboolean SciTEGTK::WatchSignal(GIOChannel *, GIOCondition, SciTEGTK *scitew) {
+#ifdef __linux__
+	char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	ssize_t len;
+	while ((len = read(scitew->fdWatch, buf, sizeof(buf))) > 0) {
+		const char *ptr = buf;
+		while (ptr < buf + len) {
+			const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+			ptr += sizeof(struct inotify_event) + event->len;
+			std::map<int, FilePath>::iterator it = scitew->watchDirectories.find(event->wd);
+			if (scitew->pFileWatcher) {
+				if ((event->mask & IN_Q_OVERFLOW) || ((it != scitew->watchDirectories.end()) && (event->len == 0)))
+					// Events lost or the directory itself moved or deleted
+					scitew->pFileWatcher->ChangedAll();
+				else if (it != scitew->watchDirectories.end())
+					scitew->pFileWatcher->Changed(FilePath(it->second, FilePath(event->name)));
+			}
+			if ((event->mask & IN_IGNORED) && (it != scitew->watchDirectories.end()))
+				scitew->watchDirectories.erase(it);
+		}
+	}
+#endif
+	return TRUE;
+}
+//!-end-[FileWatcher]
+
 gboolean SciTEGTK::IOSignal(GIOChannel *, GIOCondition, SciTEGTK *scitew) {
 	ThreadLockMinder minder;
 	scitew->ContinueExecute(FALSE);
@@ -2539,11 +2695,13 @@ void SciTEGTK::Execute() {
 	if (scrollOutput)
 		wOutput.Send(SCI_GOTOPOS, wOutput.Send(SCI_GETTEXTLENGTH));
 	originalEnd = wOutput.Send(SCI_GETCURRENTPOS);
+	outputRemoved = 0;	//!-add-[OutputBatch]
 
 	lastOutput = "";
 	lastFlags = jobQueue.jobQueue[icmd].flags;
 
-	if (jobQueue.jobQueue[icmd].jobType != jobExtension) {
+//!	if (jobQueue.jobQueue[icmd].jobType != jobExtension) {
+	if ((jobQueue.jobQueue[icmd].jobType != jobExtension) && (jobQueue.jobQueue[icmd].jobType != jobGrep)) { //!-change-[ParallelGrep]
 		OutputAppendString(">");
 		OutputAppendString(jobQueue.jobQueue[icmd].command.c_str());
 		OutputAppendString("\n");
@@ -2563,6 +2721,16 @@ void SciTEGTK::Execute() {
 		if (extender)
 			extender->OnExecute(jobQueue.jobQueue[icmd].command.c_str());
 		ExecuteNext();
+//!-start-[ParallelGrep]
+	} else if (jobQueue.jobQueue[icmd].jobType == jobGrep) {
+		pGrepWorker = new GrepJobWorker(this, jobQueue.jobQueue[icmd], GrepSettingsFromProps());
+		if (!PerformOnNewThread(pGrepWorker)) {
+			delete pGrepWorker;
+			pGrepWorker = 0;
+			OutputAppendString(">Failed to start search\n");
+			ExecuteNext();
+		}
+//!-end-[ParallelGrep]
 	} else {
 		int pipefds[2];
 		if (pipe(pipefds)) {
@@ -2587,6 +2755,8 @@ void SciTEGTK::StopExecute() {
 		kill(-pidShell, SIGKILL);
 		triedKill = true;
 	}
+	if (pGrepWorker) //!-add-[ParallelGrep]
+		jobQueue.SetCancelFlag(1); //!-add-[ParallelGrep]
 }
 
 void SciTEGTK::GotoCmd() {
@@ -3848,6 +4018,7 @@ void SciTEGTK::CreateMenu() {
 	            {"/Options/_Wrap", "", menuSig, IDM_WRAP, "<CheckItem>"},
 	            {"/Options/Wrap Out_put", "", menuSig, IDM_WRAPOUTPUT, "<CheckItem>"},
 	            {"/Options/_Read-Only", "", menuSig, IDM_READONLY, "<CheckItem>"},
+	            {"/Options/_Follow File End", "", menuSig, IDM_FOLLOW, "<CheckItem>"}, //!-add-[TailFollow]
 	            {"/Options/sep1", NULL, NULL, 0, "<Separator>"},
 	            {"/Options/_Line End Characters", "", 0, 0, "<Branch>"},
 	            {"/Options/Line End Characters/CR _+ LF", "", menuSig, IDM_EOL_CRLF, "<RadioItem>"},
@@ -4647,8 +4818,15 @@ static void *WorkerThread(void *ptr) {
 
 bool SciTEGTK::PerformOnNewThread(Worker *pWorker) {
 	pthread_t tid;
-	pthread_create(&tid, NULL, WorkerThread, pWorker);
-	return tid != 0;
+//!	pthread_create(&tid, NULL, WorkerThread, pWorker);
+//!	return tid != 0;
+//!-start-[ParallelGrep]
+	if (pthread_create(&tid, NULL, WorkerThread, pWorker) != 0)
+		return false;
+	// Workers report by posting to the main thread so are never joined
+	pthread_detach(tid);
+	return true;
+//!-end-[ParallelGrep]
 }
 
 struct CallbackData {
@@ -4675,6 +4853,57 @@ gboolean SciTEGTK::PostCallback(void *ptr) {
 	return FALSE;
 }
 
+//!-start-[ParallelGrep]
+void GrepJobWorker::Execute() {
+	// Not scrolled here as that is done on the main thread after the search
+	pSciTE->InternalGrepJob(job, settings, false);
+	PostFinished(pSciTE, WORK_GREP);
+}
+
+void SciTEGTK::WorkerCommand(int cmd, Worker *pWorker) {
+	if (cmd < WORK_PLATFORM) {
+		SciTEBase::WorkerCommand(cmd, pWorker);
+	} else if (cmd == WORK_GREP) {
+		pGrepWorker->AwaitFinished();
+		delete pGrepWorker;
+		pGrepWorker = 0;
+		// Move to the first result below the line naming the search so that F4
+		// goes to the first match of this run
+		if ((scrollOutput == 1) && returnOutputToCommand) {
+			const int start = (originalEnd > outputRemoved) ? originalEnd - outputRemoved : 0;
+			const int lineResults = wOutput.Call(SCI_LINEFROMPOSITION, start) + 1;
+			wOutput.Call(SCI_GOTOPOS, wOutput.Call(SCI_POSITIONFROMLINE, lineResults));
+		}
+		returnOutputToCommand = true;
+		ExecuteNext();
+	}
+}
+
+bool SciTEGTK::OnMainThread() const {
+	return pthread_equal(pthread_self(), mainThread) != 0;
+}
+
+// The search thread writes its results while holding the GDK lock which the
+// main thread already holds when it calls these
+void SciTEGTK::OutputAppendStringSynchronised(const char *s, int len) {
+	if (OnMainThread()) {
+		SciTEBase::OutputAppendStringSynchronised(s, len);
+	} else {
+		ThreadLockMinder minder;
+		SciTEBase::OutputAppendStringSynchronised(s, len);
+	}
+}
+
+void SciTEGTK::MakeOutputVisible() {
+	if (OnMainThread()) {
+		SciTEBase::MakeOutputVisible();
+	} else {
+		ThreadLockMinder minder;
+		SciTEBase::MakeOutputVisible();
+	}
+}
+//!-end-[ParallelGrep]
+
 void SciTEGTK::SetStartupTime(const char *timestamp) {
 	if (timestamp != NULL) {
 		char *end;
@@ -4854,6 +5083,15 @@ void SciTEGTK::Run(int argc, char *argv[]) {
 	gdk_threads_enter();
 	gtk_main();
 	gdk_threads_leave();
+//!-start-[ParallelGrep]
+	// A search still going takes the lock released above to write so can finish
+	if (pGrepWorker) {
+		jobQueue.SetCancelFlag(1);
+		pGrepWorker->Cancel();
+		delete pGrepWorker;
+		pGrepWorker = 0;
+	}
+//!-end-[ParallelGrep]
 }
 
 // Avoid zombie detached processes by reaping their exit statuses when
@@ -40,31 +40,40 @@ MultiplexExtension.o: ../src/MultiplexExtension.cxx \
  ../../scintilla/include/Scintilla.h ../src/GUI.h \
  ../src/MultiplexExtension.h ../src/Extender.h
 PropSetFile.o: ../src/PropSetFile.cxx ../../scintilla/include/Scintilla.h \
- ../src/GUI.h ../src/SString.h ../src/FilePath.h ../src/PropSetFile.h
+ ../src/GUI.h ../src/SString.h ../src/FilePath.h ../src/PropSetFile.h \
+ ../src/StringHelpers.h
 SciTEBase.o: ../src/SciTEBase.cxx \
  ../../scintilla/include/Scintilla.h ../../scintilla/include/SciLexer.h \
  ../src/GUI.h ../src/SString.h ../src/StringList.h ../src/StringHelpers.h \
  ../src/FilePath.h ../src/PropSetFile.h ../src/StyleWriter.h \
  ../src/Extender.h ../src/SciTE.h ../src/Mutex.h ../src/JobQueue.h \
- ../src/SciTEBase.h
+ ../src/WordIndex.h ../src/SciTEBase.h
 SciTEBuffers.o: ../src/SciTEBuffers.cxx \
  ../../scintilla/include/Scintilla.h ../../scintilla/include/SciLexer.h \
  ../src/GUI.h ../src/SString.h ../src/StringList.h ../src/StringHelpers.h \
  ../src/FilePath.h ../src/PropSetFile.h ../src/StyleWriter.h \
  ../src/Extender.h ../src/SciTE.h ../src/Mutex.h ../src/JobQueue.h \
- ../src/SciTEBase.h
+ ../src/WordIndex.h ../src/SciTEBase.h
 SciTEIO.o: ../src/SciTEIO.cxx \
  ../../scintilla/include/Scintilla.h ../src/GUI.h ../src/SString.h \
  ../src/StringList.h ../src/StringHelpers.h ../src/FilePath.h \
  ../src/PropSetFile.h ../src/StyleWriter.h ../src/Extender.h \
  ../src/SciTE.h ../src/Mutex.h ../src/JobQueue.h ../src/SciTEBase.h \
- ../src/Utf8_16.h
+ ../src/TrigramIndex.h ../src/Utf8_16.h
+TrigramIndex.o: ../src/TrigramIndex.cxx ../../scintilla/include/Scintilla.h \
+ ../src/GUI.h ../src/StringHelpers.h ../src/FilePath.h ../src/TrigramIndex.h
+WordIndex.o: ../src/WordIndex.cxx ../../scintilla/include/Scintilla.h \
+ ../src/GUI.h ../src/StringHelpers.h ../src/WordIndex.h
+FileWatcher.o: ../src/FileWatcher.cxx ../../scintilla/include/Scintilla.h \
+ ../../scintilla/include/ILexer.h ../src/GUI.h ../src/SString.h \
+ ../src/FilePath.h ../src/Cookie.h ../src/Mutex.h ../src/Worker.h \
+ ../src/FileWorker.h ../src/FileWatcher.h
 SciTEProps.o: ../src/SciTEProps.cxx ../../scintilla/include/Scintilla.h \
  ../../scintilla/include/SciLexer.h ../src/GUI.h \
  ../src/StringList.h ../src/StringHelpers.h ../src/FilePath.h \
  ../src/PropSetFile.h ../src/StyleWriter.h ../src/Extender.h \
  ../src/SciTE.h ../src/IFaceTable.h ../src/Mutex.h ../src/JobQueue.h \
- ../src/SciTEBase.h
+ ../src/FileWorker.h ../src/SciTEBase.h
 StringHelpers.o: ../src/StringHelpers.cxx \
  ../../scintilla/include/Scintilla.h ../src/GUI.h ../src/StringHelpers.h
 StringList.o: ../src/StringList.cxx ../src/SString.h ../src/StringList.h
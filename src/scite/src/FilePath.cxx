@@ -282,6 +282,13 @@ static int unlink(const wchar_t *filename) {
 	return _wunlink(filename);
 }
 
+//!-start-[TrigramIndex]
+// Replace an existing file like POSIX rename does
+static int rename(const wchar_t *oldName, const wchar_t *newName) {
+	return ::MoveFileExW(oldName, newName, MOVEFILE_REPLACE_EXISTING) ? 0 : -1;
+}
+//!-end-[TrigramIndex]
+
 static int access(const wchar_t *path, int mode) {
 	return _waccess(path, mode);
 }
@@ -449,6 +456,12 @@ void FilePath::Remove() const {
 	unlink(AsInternal());
 }
 
+//!-start-[TrigramIndex]
+bool FilePath::Rename(const FilePath &newName) const {
+	return rename(AsInternal(), newName.AsInternal()) == 0;
+}
+//!-end-[TrigramIndex]
+
 #ifndef R_OK
 // Microsoft does not define the constants used to call access
 #define R_OK 4
@@ -474,13 +487,19 @@ time_t FilePath::ModifiedTime() const {
 		return 0;
 }
 
-long FilePath::GetFileLength() const {
-	long size = -1;
+Sci_Position FilePath::GetFileLength() const {
+	Sci_Position size = -1;
 	if (IsSet()) {
 		FILE *fp = Open(fileRead);
 		if (fp) {
+#if defined(_MSC_VER) && defined(_WIN64)
+			// ftell is limited to 2GB as long is 32 bits on Windows
+			_fseeki64(fp, 0, SEEK_END);
+			size = static_cast<Sci_Position>(_ftelli64(fp));
+#else
 			fseek(fp, 0, SEEK_END);
 			size = ftell(fp);
+#endif
 			fseek(fp, 0, SEEK_SET);
 			fclose(fp);
 		}
@@ -488,6 +507,26 @@ long FilePath::GetFileLength() const {
 	return size;
 }
 
+//!-start-[TrigramIndex]
+// Modification time and length from a single call, faster than ModifiedTime and GetFileLength
+bool FilePath::Status(time_t &modifiedTime, Sci_Position &length) const {
+	if (!IsSet())
+		return false;
+#ifdef _WIN32
+	struct _stati64 statusFile;
+	if (_wstati64(AsInternal(), &statusFile) == -1)
+		return false;
+#else
+	struct stat statusFile;
+	if (stat(AsInternal(), &statusFile) == -1)
+		return false;
+#endif
+	modifiedTime = statusFile.st_mtime;
+	length = static_cast<Sci_Position>(statusFile.st_size);
+	return true;
+}
+//!-end-[TrigramIndex]
+
 bool FilePath::Exists() const {
 	bool ret = false;
 	if (IsSet()) {
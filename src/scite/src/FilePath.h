@@ -72,8 +72,10 @@ public:
 	void List(FilePathSet &directories, FilePathSet &files);
 	FILE *Open(const GUI::gui_char *mode) const;
 	void Remove() const;
+	bool Rename(const FilePath &newName) const; //!-add-[TrigramIndex]
 	time_t ModifiedTime() const;
-	long GetFileLength() const;
+	Sci_Position GetFileLength() const;
+	bool Status(time_t &modifiedTime, Sci_Position &length) const; //!-add-[TrigramIndex]
 	bool Exists() const;
 	bool IsDirectory() const;
 	bool Matches(const GUI::gui_char *pattern) const;
@@ -0,0 +1,334 @@
+// SciTE - Scintilla based Text Editor
+/** @file FileWatcher.cxx
+ ** Notice changes made to open files outside SciTE.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#if defined(__unix__)
+
+#include <unistd.h>
+
+#else
+
+#undef _WIN32_WINNT
+#define _WIN32_WINNT  0x0500
+#ifdef _MSC_VER
+// windows.h, et al, use a lot of nameless struct/unions - can't fix it, so allow it
+#pragma warning(disable: 4201)
+#endif
+#include <windows.h>
+#ifdef _MSC_VER
+// okay, that's done, don't allow it in our code
+#pragma warning(default: 4201)
+#endif
+
+#endif
+
+#include "Scintilla.h"
+#include "ILexer.h"
+
+#include "GUI.h"
+#include "SString.h"
+
+#include "FilePath.h"
+#include "Cookie.h"
+#include "Mutex.h"
+#include "Worker.h"
+#include "FileWorker.h"
+#include "FileWatcher.h"
+
+// How long a changed file has to stay the same before the change is reported.
+const double settleTime = 0.3;
+// How long the thread sleeps between looking at the files that are due.
+const int napMilliseconds = 50;
+// Shorter while a tail waits to be taken so the next is read soon after.
+const int napTailMilliseconds = 5;
+// Most read from the followed file at once so that adding it to the buffer is quick.
+const Sci_Position tailChunk = 1024 * 1024;
+// How much of the start of the followed file is checked to see whether it was replaced.
+const size_t headLength = 64;
+
+FileWatcher::FileWatcher(WorkerListener *pListener_) :
+	pListener(pListener_), mutex(Mutex::Create()), posted(false), woken(false), tailWaiting(false), pollInterval(5.0) {
+}
+
+FileWatcher::~FileWatcher() {
+	delete mutex;
+}
+
+void FileWatcher::Execute() {
+	GUI::ElapsedTime sincePoll;
+	while (!cancelling) {
+		const bool all = sincePoll.Duration() >= pollInterval;
+		if (all)
+			sincePoll.Duration(true);
+		woken = false;
+		Pass(all);
+		PassFollowed();
+		// Sleep until told to look, a file settling is due again or a second has passed
+		int napped = 0;
+		while (!woken && !cancelling && (napped < 1000) && ((napped == 0) || !Settling())) {
+			const int nap = tailWaiting ? napTailMilliseconds : napMilliseconds;
+#ifdef __unix__
+			usleep(nap * 1000);
+#else
+			::Sleep(nap);
+#endif
+			napped += nap;
+		}
+	}
+	completed = true;
+}
+
+FileWatcher::WatchedFile *FileWatcher::Find(const FilePath &path) {
+	for (size_t i = 0; i < files.size(); i++) {
+		if (files[i].path.SameNameAs(path))
+			return &files[i];
+	}
+	return 0;
+}
+
+bool FileWatcher::Settling() {
+	Lock lock(mutex);
+	for (size_t i = 0; i < files.size(); i++) {
+		if (files[i].settling)
+			return true;
+	}
+	return false;
+}
+
+void FileWatcher::Pass(bool all) {
+	std::vector<FilePath> paths;
+	{
+		Lock lock(mutex);
+		for (size_t i = 0; i < files.size(); i++) {
+			if (all || files[i].due || files[i].settling)
+				paths.push_back(files[i].path);
+		}
+	}
+	if (paths.empty())
+		return;
+	// Looking at files may be slow so is done without holding the lock
+	std::vector<time_t> modifieds(paths.size(), 0);
+	std::vector<Sci_Position> sizes(paths.size(), 0);
+	for (size_t p = 0; (p < paths.size()) && !cancelling; p++) {
+		if (!paths[p].Status(modifieds[p], sizes[p])) {
+			modifieds[p] = 0;
+			sizes[p] = 0;
+		}
+	}
+	const double now = sinceStart.Duration();
+	bool post = false;
+	{
+		Lock lock(mutex);
+		for (size_t p = 0; p < paths.size(); p++) {
+			// The file may have stopped being watched while it was looked at
+			WatchedFile *pwf = Find(paths[p]);
+			if (!pwf)
+				continue;
+			pwf->due = false;
+			if ((pwf->size < 0) && (modifieds[p] == pwf->modified)) {
+				pwf->size = sizes[p];
+			} else if ((modifieds[p] != pwf->modified) || (sizes[p] != pwf->size)) {
+				pwf->modified = modifieds[p];
+				pwf->size = sizes[p];
+				pwf->settling = true;
+				pwf->changedAt = now;
+			} else if (pwf->settling && (now - pwf->changedAt >= settleTime)) {
+				pwf->settling = false;
+				pwf->modifiedSettled = pwf->modified;
+				changes.push_back(FileChange(pwf->path, pwf->modified, pwf->size));
+			}
+		}
+		if (!changes.empty() && !posted) {
+			posted = true;
+			post = true;
+		}
+	}
+	if (post)
+		pListener->PostOnMainThread(WORK_FILECHANGED, this);
+}
+
+// The followed file is looked at on every pass since its buffer wants additions soon.
+// Nothing more is read until the last tail is taken so a fast growing file can not
+// fill memory faster than the buffer takes it.
+void FileWatcher::PassFollowed() {
+	Followed look;
+	{
+		Lock lock(mutex);
+		if (!followed.path.IsSet() || followed.stopped || (followed.pendingOffset >= 0))
+			return;
+		look = followed;
+	}
+	FileChange change(look.path, 0, 0);
+	if (!ReadTail(look, change))
+		return;
+	bool post = false;
+	{
+		Lock lock(mutex);
+		// Following may have restarted while the file was read
+		if (followed.serial != look.serial)
+			return;
+		followed = look;
+		if (change.offset >= 0) {
+			followed.pendingOffset = change.offset;
+			tailWaiting = true;
+		}
+		changes.push_back(change);
+		if (!posted) {
+			posted = true;
+			post = true;
+		}
+	}
+	if (post)
+		pListener->PostOnMainThread(WORK_FILECHANGED, this);
+}
+
+bool FileWatcher::ReadTail(Followed &look, FileChange &change) {
+	time_t modified = 0;
+	Sci_Position size = 0;
+	if (!look.path.Status(modified, size))
+		return false;
+	change.modified = modified;
+	change.size = size;
+	if (!look.starting && (size == look.offset))
+		return false;
+	FILE *fp = look.path.Open(fileRead);
+	if (!fp)
+		return false;
+	char start[headLength + 3];
+	const size_t lengthStart = fread(start, 1, sizeof(start), fp);
+	if (look.starting) {
+		look.lengthBom = (look.bom && (lengthStart >= 3) && (memcmp(start, "\xEF\xBB\xBF", 3) == 0)) ? 3 : 0;
+		look.offset += look.lengthBom;
+		look.starting = false;
+	}
+	const size_t lengthHead = look.head.length();
+	if ((size < look.offset) || (lengthStart < look.lengthBom + lengthHead) ||
+		(look.head.compare(0, lengthHead, start + look.lengthBom, lengthHead) != 0)) {
+		fclose(fp);
+		change.restarted = true;
+		look.stopped = true;
+		return true;
+	}
+	if (size > look.offset) {
+		const Sci_Position lengthTail = (size - look.offset < tailChunk) ? size - look.offset : tailChunk;
+#if defined(_MSC_VER) && defined(_WIN64)
+		_fseeki64(fp, look.offset, SEEK_SET);
+#else
+		fseek(fp, look.offset, SEEK_SET);
+#endif
+		change.tail.resize(static_cast<size_t>(lengthTail));
+		change.tail.resize(fread(&change.tail[0], 1, change.tail.length(), fp));
+		change.offset = look.offset;
+		look.offset += change.tail.length();
+	}
+	fclose(fp);
+	// A document shorter than the head has more of the head checked as it grows
+	const size_t lengthKnown = static_cast<size_t>(look.offset - look.lengthBom);
+	if ((lengthHead < headLength) && (lengthKnown > lengthHead) && (lengthStart > static_cast<size_t>(look.lengthBom)))
+		look.head.assign(start + look.lengthBom, std::min(lengthKnown, lengthStart - look.lengthBom));
+	return !change.tail.empty();
+}
+
+void FileWatcher::SetFiles(const std::vector<FilePath> &paths, const std::vector<time_t> &modifiedBuffers) {
+	Lock lock(mutex);
+	std::vector<WatchedFile> filesNew;
+	for (size_t p = 0; p < paths.size(); p++) {
+		WatchedFile *pwf = Find(paths[p]);
+		if (pwf && (pwf->modifiedBuffer == modifiedBuffers[p])) {
+			filesNew.push_back(*pwf);
+		} else {
+			// New or read or written again so start from the time of the buffer
+			WatchedFile wf;
+			wf.path = paths[p];
+			wf.modifiedBuffer = modifiedBuffers[p];
+			wf.modified = modifiedBuffers[p];
+			wf.modifiedSettled = modifiedBuffers[p];
+			wf.size = -1;
+			wf.due = true;
+			wf.settling = false;
+			wf.changedAt = 0.0;
+			filesNew.push_back(wf);
+			woken = true;
+		}
+	}
+	files.swap(filesNew);
+}
+
+bool FileWatcher::ModifiedTime(const FilePath &path, time_t &modified) {
+	Lock lock(mutex);
+	WatchedFile *pwf = Find(path);
+	if (!pwf)
+		return false;
+	modified = pwf->modifiedSettled;
+	return true;
+}
+
+void FileWatcher::Changed(const FilePath &path) {
+	Lock lock(mutex);
+	WatchedFile *pwf = Find(path);
+	if (pwf) {
+		pwf->due = true;
+		woken = true;
+	}
+}
+
+void FileWatcher::ChangedAll() {
+	Lock lock(mutex);
+	for (size_t i = 0; i < files.size(); i++)
+		files[i].due = true;
+	woken = true;
+}
+
+void FileWatcher::Follow(const FilePath &path, Sci_Position offset, bool starting, const std::string &head, bool bom) {
+	Lock lock(mutex);
+	if (path.SameNameAs(followed.path) && !followed.stopped) {
+		// Already following from where the buffer is, perhaps with a tail it has not taken
+		if (starting ? (followed.givenStarting && (offset == followed.given)) :
+			(offset == ((followed.pendingOffset >= 0) ? followed.pendingOffset : followed.offset)))
+			return;
+	}
+	// Tails read for the buffer as it was are no longer wanted
+	for (size_t i = changes.size(); i > 0; i--) {
+		const FileChange &change = changes[i - 1];
+		if (((change.offset >= 0) || change.restarted) && change.path.SameNameAs(followed.path))
+			changes.erase(changes.begin() + i - 1);
+	}
+	const int serial = followed.serial + 1;
+	followed = Followed();
+	followed.serial = serial;
+	tailWaiting = false;
+	if (!path.IsSet())
+		return;
+	followed.path = path;
+	followed.given = offset;
+	followed.givenStarting = starting;
+	followed.offset = offset;
+	followed.starting = starting;
+	followed.bom = bom;
+	followed.head = head.substr(0, headLength);
+	woken = true;
+}
+
+void FileWatcher::TakeChanges(std::vector<FileChange> &changes_) {
+	Lock lock(mutex);
+	changes_.insert(changes_.end(), changes.begin(), changes.end());
+	changes.clear();
+	posted = false;
+	if (followed.pendingOffset >= 0) {
+		// Read more of the followed file straight away
+		followed.pendingOffset = -1;
+		tailWaiting = false;
+		woken = true;
+	}
+}
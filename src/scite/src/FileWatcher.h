@@ -0,0 +1,103 @@
+// SciTE - Scintilla based Text Editor
+/** @file FileWatcher.h
+ ** Notice changes made to open files outside SciTE.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+/// A file found changed and no longer changing or, for the followed file,
+/// the bytes added to it.
+struct FileChange {
+	FilePath path;
+	time_t modified;	///< 0 if the file is missing
+	Sci_Position size;
+	Sci_Position offset;	///< Where tail starts in the followed file, -1 for other changes
+	std::string tail;
+	bool restarted;	///< The followed file was replaced or shortened
+	FileChange(const FilePath &path_, time_t modified_, Sci_Position size_) :
+		path(path_), modified(modified_), size(size_), offset(-1), restarted(false) {
+	}
+};
+
+/// Looks at the files of the open buffers on its own thread so that a slow file
+/// system never blocks the user interface.
+/// A file is looked at when the platform tells that something changed in its
+/// directory and every poll interval in case the platform can not tell, as for
+/// files changed by other machines on network file systems. A change is reported
+/// once the file has stayed the same for a while so a file still being written
+/// is not read part way through.
+class FileWatcher : public Worker {
+	struct WatchedFile {
+		FilePath path;
+		time_t modifiedBuffer;	///< Time of the file when the buffer was read or written
+		time_t modified;
+		time_t modifiedSettled;	///< Time of the file when it was last not changing
+		Sci_Position size;	///< -1 until first seen
+		bool due;	///< Look at the file on the next pass
+		bool settling;	///< Changed and waiting to stay the same
+		double changedAt;
+	};
+
+	/// The file whose additions are read for its buffer.
+	struct Followed {
+		FilePath path;
+		int serial;	///< Changes each time following restarts
+		Sci_Position given;	///< Offset passed to Follow
+		bool givenStarting;
+		Sci_Position offset;	///< How much of the file has been read
+		bool starting;	///< offset is the length of the document which leaves out any BOM
+		bool bom;	///< The document may have been read from a file starting with a UTF-8 BOM
+		Sci_Position lengthBom;
+		std::string head;	///< Start of the document, to notice the file being replaced
+		Sci_Position pendingOffset;	///< Start of the tail not yet taken, -1 if none
+		bool stopped;	///< Replaced or shortened so wait for the buffer to be read again
+		Followed() : serial(0), given(-1), givenStarting(false), offset(-1), starting(false),
+			bom(false), lengthBom(0), pendingOffset(-1), stopped(false) {
+		}
+	};
+
+	WorkerListener *pListener;
+	Mutex *mutex;
+	std::vector<WatchedFile> files;
+	std::vector<FileChange> changes;
+	Followed followed;
+	bool posted;
+	volatile bool woken;
+	volatile bool tailWaiting;
+	volatile double pollInterval;
+	GUI::ElapsedTime sinceStart;
+
+	WatchedFile *Find(const FilePath &path);
+	bool Settling();
+	void Pass(bool all);
+	void PassFollowed();
+	static bool ReadTail(Followed &look, FileChange &change);
+
+public:
+	explicit FileWatcher(WorkerListener *pListener_);
+	virtual ~FileWatcher();
+	virtual void Execute();
+	void SetPollInterval(double pollInterval_) {
+		pollInterval = pollInterval_;
+	}
+
+	/// Watch just these files. modifiedBuffers are the times the files had when their
+	/// buffers were read or written, which restart the watch of a file when they change.
+	void SetFiles(const std::vector<FilePath> &paths, const std::vector<time_t> &modifiedBuffers);
+	/// The time the file had when last seen not changing.
+	bool ModifiedTime(const FilePath &path, time_t &modified);
+	/// Something may have changed the file so look at it soon.
+	void Changed(const FilePath &path);
+	/// Look at all the files soon.
+	void ChangedAll();
+	/// Read what is added to this file, which has been read up to offset or, when
+	/// starting, which has a document of length offset starting with head.
+	/// An unset path stops following.
+	void Follow(const FilePath &path, Sci_Position offset, bool starting, const std::string &head, bool bom);
+	/// Move the changes found since the last call into changes_.
+	void TakeChanges(std::vector<FileChange> &changes_);
+};
+
+#endif
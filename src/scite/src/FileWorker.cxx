@@ -7,6 +7,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <time.h> //!-add-[mapped.open]
 
 #include <string>
 #include <vector>
@@ -14,6 +15,13 @@
 #if defined(__unix__)
 
 #include <unistd.h>
+//!-start-[mapped.open]
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+//!-end-[mapped.open]
 
 #else
 
@@ -39,13 +47,16 @@
 
 #include "FilePath.h"
 #include "Cookie.h"
+#include "Mutex.h" //!-add-[WorkerFinish]
 #include "Worker.h"
 #include "FileWorker.h"
 #include "Utf8_16.h"
 
 const double timeBetweenProgress = 0.4;
+// Seconds a file has to be unchanged before it is mapped rather than copied //!-add-[mapped.open]
+const double mapQuietTime = 60.0; //!-add-[mapped.open]
 
-FileWorker::FileWorker(WorkerListener *pListener_, FilePath path_, long size_, FILE *fp_) :
+FileWorker::FileWorker(WorkerListener *pListener_, FilePath path_, Sci_Position size_, FILE *fp_) :
 	pListener(pListener_), path(path_), size(size_), err(0), fp(fp_), sleepTime(0), nextProgress(timeBetweenProgress) {
 }
 
@@ -56,8 +67,156 @@ double FileWorker::Duration() {
 	return et.Duration();
 }
 
-FileLoader::FileLoader(WorkerListener *pListener_, ILoader *pLoader_, FilePath path_, long size_, FILE *fp_) : 
-	FileWorker(pListener_, path_, size_, fp_), pLoader(pLoader_), readSoFar(0), unicodeMode(uni8Bit) {
+//!-start-[mapped.open]
+#if defined(__unix__)
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+// Reading pages of a mapping that are past the end of a file which has been
+// truncated, as when a log is rotated, raises SIGBUS. Those pages are replaced
+// by pages of zeros so the document shows NULs until the change is noticed and
+// the file read again, instead of the process being killed.
+// The handler may run while another thread changes the table so an entry is only
+// counted or marked live after its fields are written and is never moved.
+namespace {
+
+struct MappedRange {
+	const char * volatile start;
+	volatile size_t length;
+	volatile sig_atomic_t live;
+};
+
+const int maxMappedRanges = 64;
+MappedRange mappedRanges[maxMappedRanges];
+// Entries beyond the count have never been used
+volatile sig_atomic_t mappedRangeCount = 0;
+pthread_mutex_t mappedRangesMutex = PTHREAD_MUTEX_INITIALIZER;
+struct sigaction busActionPrevious;
+bool busGuarded = false;
+size_t pageSize = 4096;
+
+void BusHandler(int, siginfo_t *info, void *) {
+	const char *address = static_cast<const char *>(info->si_addr);
+	const int count = mappedRangeCount;
+	for (int i = 0; i < count; i++) {
+		if (!mappedRanges[i].live)
+			continue;
+		const char *start = mappedRanges[i].start;
+		if ((address >= start) && (address < start + mappedRanges[i].length)) {
+			char *page = const_cast<char *>(start) + ((address - start) & ~(pageSize - 1));
+			if (mmap(page, pageSize, PROT_READ, MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS, -1, 0) != MAP_FAILED)
+				return;
+		}
+	}
+	// Not a mapped file so fail as before when the access is repeated
+	sigaction(SIGBUS, &busActionPrevious, 0);
+}
+
+bool GuardRange(const char *start, size_t length) {
+	bool guarded = false;
+	pthread_mutex_lock(&mappedRangesMutex);
+	if (!busGuarded) {
+		pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_sigaction = BusHandler;
+		action.sa_flags = SA_SIGINFO;
+		sigemptyset(&action.sa_mask);
+		busGuarded = sigaction(SIGBUS, &action, &busActionPrevious) == 0;
+	}
+	for (int i = 0; busGuarded && !guarded && (i < maxMappedRanges); i++) {
+		if ((i >= mappedRangeCount) || !mappedRanges[i].live) {
+			mappedRanges[i].start = start;
+			mappedRanges[i].length = length;
+			__sync_synchronize();
+			mappedRanges[i].live = 1;
+			if (i >= mappedRangeCount) {
+				__sync_synchronize();
+				mappedRangeCount = i + 1;
+			}
+			guarded = true;
+		}
+	}
+	pthread_mutex_unlock(&mappedRangesMutex);
+	return guarded;
+}
+
+void UnguardRange(const char *start) {
+	pthread_mutex_lock(&mappedRangesMutex);
+	for (int i = 0; i < mappedRangeCount; i++) {
+		if (mappedRanges[i].live && (mappedRanges[i].start == start))
+			mappedRanges[i].live = 0;
+	}
+	pthread_mutex_unlock(&mappedRangesMutex);
+}
+
+}
+
+MappedFile *MappedFile::Open(const FilePath &path) {
+	int fd = open(path.AsInternal(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+	MappedFile *mf = 0;
+	struct stat st;
+	if ((fstat(fd, &st) == 0) && (st.st_size > 0) &&
+		(static_cast<unsigned long long>(st.st_size) < static_cast<size_t>(-1) / 2)) {
+		const size_t length = static_cast<size_t>(st.st_size);
+		void *view = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view != MAP_FAILED) {
+			// Without the guard a truncation could kill the process so the file is not mapped
+			if (GuardRange(static_cast<const char *>(view), length))
+				mf = new MappedFile(static_cast<const char *>(view), static_cast<Sci_Position>(st.st_size));
+			else
+				munmap(view, length);
+		}
+	}
+	close(fd);
+	return mf;
+}
+
+void SCI_METHOD MappedFile::Release() {
+	UnguardRange(data);
+	munmap(const_cast<char *>(data), static_cast<size_t>(length));
+	delete this;
+}
+
+#else
+
+// Windows refuses to truncate a file while a view of it is mapped so no guard is needed
+MappedFile *MappedFile::Open(const FilePath &path) {
+	HANDLE hFile = ::CreateFileW(path.AsInternal(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return 0;
+	MappedFile *mf = 0;
+	LARGE_INTEGER fileSize;
+	if (::GetFileSizeEx(hFile, &fileSize) && (fileSize.QuadPart > 0) &&
+		(static_cast<unsigned long long>(fileSize.QuadPart) < static_cast<size_t>(-1) / 2)) {
+		HANDLE hMap = ::CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (hMap) {
+			// The view keeps the mapping alive after its handle is closed
+			void *view = ::MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+			if (view)
+				mf = new MappedFile(static_cast<const char *>(view), static_cast<Sci_Position>(fileSize.QuadPart));
+			::CloseHandle(hMap);
+		}
+	}
+	::CloseHandle(hFile);
+	return mf;
+}
+
+void SCI_METHOD MappedFile::Release() {
+	::UnmapViewOfFile(data);
+	delete this;
+}
+
+#endif
+//!-end-[mapped.open]
+
+FileLoader::FileLoader(WorkerListener *pListener_, ILoader *pLoader_, FilePath path_, Sci_Position size_, FILE *fp_) : 
+	FileWorker(pListener_, path_, size_, fp_), pLoader(pLoader_), readSoFar(0), unicodeMode(uni8Bit), mapRead(false) {
 	jobSize = static_cast<int>(size);
 	jobProgress = 0;
 }
@@ -79,6 +238,33 @@ void FileLoader::Execute() {
 		}
 		Utf8_16_Read convert(umCodingCookie==uni8Bit && check_utf8==1);
 //!-end-[utf8.auto.check]
+//!-start-[mapped.open]
+		if (mapRead && (lenFile > 0)) {
+			// Text that needs no conversion is used in place rather than copied
+			size_t lenConverted = convert.convert(data, lenFile);
+			// A file written recently may still be being written so is copied instead
+			time_t modified = 0;
+			Sci_Position lengthNow = 0;
+			const bool quiet = path.Status(modified, lengthNow) && (difftime(time(0), modified) >= mapQuietTime);
+			if (quiet && (convert.getNewBuf() == data) && (lenConverted == lenFile)) {
+				MappedFile *mf = MappedFile::Open(path);
+				if (mf) {
+					if (pLoader->AddMapped(mf) == 0) {
+						jobProgress = jobSize;
+						lenFile = 0;
+					} else {
+						mf->Release();
+					}
+				}
+			}
+			if (lenFile > 0) {
+				// Continue by copying, starting with the block already converted
+				err = pLoader->AddData(convert.getNewBuf(), static_cast<Sci_Position>(lenConverted));
+				jobProgress += static_cast<int>(lenFile);
+				lenFile = fread(data, 1, sizeof(data), fp);
+			}
+		}
+//!-end-[mapped.open]
 		while ((lenFile > 0) && (err == 0) && (!cancelling)) {
 #ifdef __unix__
 			usleep(sleepTime * 1000);
@@ -87,7 +273,7 @@ void FileLoader::Execute() {
 #endif
 			lenFile = convert.convert(data, lenFile);
 			char *dataBlock = convert.getNewBuf();
-			err = pLoader->AddData(dataBlock, static_cast<int>(lenFile));
+			err = pLoader->AddData(dataBlock, static_cast<Sci_Position>(lenFile));
 			jobProgress += static_cast<int>(lenFile);
 			if (et.Duration() > nextProgress) {
 				nextProgress = et.Duration() + timeBetweenProgress;
@@ -114,7 +300,7 @@ void FileLoader::Cancel() {
 	pLoader = 0;
 }
 
-FileStorer::FileStorer(WorkerListener *pListener_, const char *documentBytes_, FilePath path_, long size_, FILE *fp_, UniMode unicodeMode_) : 
+FileStorer::FileStorer(WorkerListener *pListener_, const char *documentBytes_, FilePath path_, Sci_Position size_, FILE *fp_, UniMode unicodeMode_) : 
 	FileWorker(pListener_, path_, size_, fp_), documentBytes(documentBytes_), writtenSoFar(0), unicodeMode(unicodeMode_) {
 	jobSize = static_cast<int>(size);
 	jobProgress = 0;
@@ -137,17 +323,17 @@ void FileStorer::Execute() {
 		}
 		convert.setfile(fp);
 		char data[blockSize + 1];
-		int lengthDoc = static_cast<int>(size);
+		Sci_Position lengthDoc = size;
 		int grabSize;
-		for (int i = 0; i < lengthDoc; i += grabSize) {
+		for (Sci_Position i = 0; i < lengthDoc; i += grabSize) {
 #ifdef __unix__
 			usleep(sleepTime * 1000);
 #else
 			::Sleep(sleepTime);
 #endif
-			grabSize = lengthDoc - i;
-			if (grabSize > blockSize)
-				grabSize = blockSize;
+			grabSize = blockSize;
+			if (lengthDoc - i < blockSize)
+				grabSize = static_cast<int>(lengthDoc - i);
 			if ((unicodeMode != uni8Bit) && (i + grabSize < lengthDoc)) {
 				// Round down so only whole characters retrieved.
 				int startLast = grabSize;
@@ -11,7 +11,7 @@ const int blockSize = 131072;
 struct FileWorker : public Worker {
 	WorkerListener *pListener;
 	FilePath path;
-	long size;
+	Sci_Position size;
 	int err;
 	FILE *fp;
 	GUI::ElapsedTime et;
@@ -19,7 +19,7 @@ struct FileWorker : public Worker {
     int check_utf8; //!-add-[utf8.auto.check]
 	double nextProgress;
 
-	FileWorker(WorkerListener *pListener_, FilePath path_, long size_, FILE *fp_);
+	FileWorker(WorkerListener *pListener_, FilePath path_, Sci_Position size_, FILE *fp_);
 	virtual ~FileWorker();
 	virtual double Duration();
 	virtual void Cancel() {
@@ -30,15 +30,39 @@ struct FileWorker : public Worker {
 
 #ifdef SCI_NAMESPACE
 using Scintilla::ILoader;
+using Scintilla::IMappedText; //!-add-[mapped.open]
 #endif
 
+//!-start-[mapped.open]
+// Read-only view of a whole file handed to the document so that huge files
+// do not have to be copied into memory.
+class MappedFile : public IMappedText {
+	const char *data;
+	Sci_Position length;
+	MappedFile(const char *data_, Sci_Position length_) : data(data_), length(length_) {
+	}
+public:
+	static MappedFile *Open(const FilePath &path);
+	virtual ~MappedFile() {
+	}
+	const char * SCI_METHOD Data() {
+		return data;
+	}
+	Sci_Position SCI_METHOD Length() {
+		return length;
+	}
+	void SCI_METHOD Release();
+};
+//!-end-[mapped.open]
+
 class FileLoader : public FileWorker {
 public:
 	ILoader *pLoader;
-	long readSoFar;
+	Sci_Position readSoFar;
 	UniMode unicodeMode;
+	bool mapRead; //!-add-[mapped.open]
 
-	FileLoader(WorkerListener *pListener_, ILoader *pLoader_, FilePath path_, long size_, FILE *fp_);
+	FileLoader(WorkerListener *pListener_, ILoader *pLoader_, FilePath path_, Sci_Position size_, FILE *fp_);
 	virtual ~FileLoader();
 	virtual void Execute();
 	virtual void Cancel();
@@ -50,10 +74,10 @@ public:
 class FileStorer : public FileWorker {
 public:
 	const char *documentBytes;
-	long writtenSoFar;
+	Sci_Position writtenSoFar;
 	UniMode unicodeMode;
 
-	FileStorer(WorkerListener *pListener_, const char *documentBytes_, FilePath path_, long size_, FILE *fp_, UniMode unicodeMode_);
+	FileStorer(WorkerListener *pListener_, const char *documentBytes_, FilePath path_, Sci_Position size_, FILE *fp_, UniMode unicodeMode_);
 	virtual ~FileStorer();
 	virtual void Execute();
 	virtual bool IsLoading() const {
@@ -65,5 +89,9 @@ enum {
 	WORK_FILEREAD = 1,
 	WORK_FILEWRITTEN = 2,
 	WORK_FILEPROGRESS = 3,
+	WORK_GREPINDEXED = 4, //!-add-[TrigramIndex]
+	WORK_WORDINDEXED = 5, //!-add-[AutoCompleteWordIndex]
+	WORK_FILECHANGED = 6, //!-add-[FileWatcher]
+	WORK_GREPINDEXSTART = 7, //!-add-[TrigramIndex]
 	WORK_PLATFORM = 100
 };
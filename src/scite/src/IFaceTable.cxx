@@ -192,6 +192,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"IDM_FINDNEXTSEL",213},
 	{"IDM_FINISHEDEXECUTE",305},
 	{"IDM_FOLDMARGIN",406},
+	{"IDM_FOLLOW",417}, //!-add-[TailFollow]
 	{"IDM_FULLSCREEN",961},
 	{"IDM_GO",303},
 	{"IDM_GOTO",220},
@@ -1779,6 +1780,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCE_YAML_OPERATOR",9},
 	{"SCE_YAML_REFERENCE",5},
 	{"SCE_YAML_TEXT",7},
+	{"SCFIND_DFAREGEX",0x01000000},
 	{"SCFIND_MATCHCASE",4},
 	{"SCFIND_POSIX",0x00400000},
 	{"SCFIND_REGEXP",0x00200000},
@@ -1795,6 +1797,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_AUTOCGETCANCELATSTART",2111},
 	{"SCI_AUTOCGETCHOOSESINGLE",2114},
 	{"SCI_AUTOCGETDROPRESTOFWORD",2271},
+	{"SCI_AUTOCGETFUZZY",4045},
 	{"SCI_AUTOCGETIGNORECASE",2116},
 	{"SCI_AUTOCGETMAXHEIGHT",2211},
 	{"SCI_AUTOCGETMAXWIDTH",2209},
@@ -1805,6 +1808,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_AUTOCSETCHOOSESINGLE",2113},
 	{"SCI_AUTOCSETDROPRESTOFWORD",2270},
 	{"SCI_AUTOCSETFILLUPS",2112},
+	{"SCI_AUTOCSETFUZZY",4044},
 	{"SCI_AUTOCSETIGNORECASE",2115},
 	{"SCI_AUTOCSETMAXHEIGHT",2210},
 	{"SCI_AUTOCSETMAXWIDTH",2208},
@@ -1815,6 +1819,11 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_CALLTIPSETFOREHLT",2207},
 	{"SCI_CALLTIPSETPOSITION",2213},
 	{"SCI_CALLTIPUSESTYLE",2212},
+	{"SCI_EXPANDCHILDREN",2239},
+	{"SCI_FOLDALL",2662},
+	{"SCI_FOLDCHILDREN",2238},
+	{"SCI_FOLDLINE",2237},
+	{"SCI_FOLDTOLEVEL",4046},
 	{"SCI_GETADDITIONALCARETFORE",2605},
 	{"SCI_GETADDITIONALCARETSBLINK",2568},
 	{"SCI_GETADDITIONALCARETSVISIBLE",2609},
@@ -1822,6 +1831,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETADDITIONALSELECTIONTYPING",2566},
 	{"SCI_GETALLLINESVISIBLE",2236},
 	{"SCI_GETANCHOR",2009},
+	{"SCI_GETBACKGROUNDLEXING",4028},
 	{"SCI_GETBACKSPACEUNINDENTS",2263},
 	{"SCI_GETBUFFEREDDRAW",2034},
 	{"SCI_GETCARETFORE",2138},
@@ -1834,6 +1844,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETCARETWIDTH",2189},
 	{"SCI_GETCHARACTERPOINTER",2520},
 	{"SCI_GETCHARAT",2007},
+	{"SCI_GETCHUNKSIZE",4025},
 	{"SCI_GETCODEPAGE",2137},
 	{"SCI_GETCOLUMN",2129},
 	{"SCI_GETCONTROLCHARSYMBOL",2389},
@@ -1867,6 +1878,8 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETINDICATORVALUE",2503},
 	{"SCI_GETKEYSUNICODE",2522},
 	{"SCI_GETLAYOUTCACHE",2273},
+	{"SCI_GETLAYOUTCACHEMEMORY",4042},
+	{"SCI_GETLAYOUTCACHEMEMORYUSE",4043},
 	{"SCI_GETLENGTH",2006},
 	{"SCI_GETLEXER",4002},
 	{"SCI_GETLINECOUNT",2154},
@@ -1894,6 +1907,9 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETOVERTYPE",2187},
 	{"SCI_GETPASTECONVERTENDINGS",2468},
 	{"SCI_GETPOSITIONCACHE",2515},
+	{"SCI_GETPOSITIONCACHEHITS",4039},
+	{"SCI_GETPOSITIONCACHEMEMORY",4038},
+	{"SCI_GETPOSITIONCACHEMISSES",4040},
 	{"SCI_GETPRINTCOLOURMODE",2149},
 	{"SCI_GETPRINTMAGNIFICATION",2147},
 	{"SCI_GETPRINTWRAPMODE",2407},
@@ -1930,7 +1946,10 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETTECHNOLOGY",2631},
 	{"SCI_GETTEXTLENGTH",2183},
 	{"SCI_GETTWOPHASEDRAW",2283},
+	{"SCI_GETUNDOACTIONS",4034},
 	{"SCI_GETUNDOCOLLECTION",2019},
+	{"SCI_GETUNDOMEMORYLIMIT",4032},
+	{"SCI_GETUNDOMEMORYUSE",4033},
 	{"SCI_GETUSETABS",2125},
 	{"SCI_GETVIEWEOL",2355},
 	{"SCI_GETVIEWWS",2020},
@@ -1940,6 +1959,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETWRAPINDENTMODE",2473},
 	{"SCI_GETWRAPMODE",2269},
 	{"SCI_GETWRAPSTARTINDENT",2465},
+	{"SCI_GETWRAPTHREADS",4030},
 	{"SCI_GETWRAPVISUALFLAGS",2461},
 	{"SCI_GETWRAPVISUALFLAGSLOCATION",2463},
 	{"SCI_GETXOFFSET",2398},
@@ -1956,6 +1976,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_INDICSETUNDER",2510},
 	{"SCI_LEXER_START",4000},
 	{"SCI_LINESONSCREEN",2370},
+	{"SCI_LOADUNDOHISTORY",4036},
 	{"SCI_MARGINGETSTYLE",2533},
 	{"SCI_MARGINGETSTYLEOFFSET",2538},
 	{"SCI_MARGINSETSTYLE",2532},
@@ -1963,6 +1984,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_OPTIONAL_START",3000},
 	{"SCI_RGBAIMAGESETHEIGHT",2625},
 	{"SCI_RGBAIMAGESETWIDTH",2624},
+	{"SCI_SAVEUNDOHISTORY",4035},
 	{"SCI_SELECTIONISRECTANGLE",2372},
 	{"SCI_SETADDITIONALCARETFORE",2604},
 	{"SCI_SETADDITIONALCARETSBLINK",2567},
@@ -1972,6 +1994,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETADDITIONALSELECTIONTYPING",2565},
 	{"SCI_SETADDITIONALSELFORE",2600},
 	{"SCI_SETANCHOR",2026},
+	{"SCI_SETBACKGROUNDLEXING",4027},
 	{"SCI_SETBACKSPACEUNINDENTS",2262},
 	{"SCI_SETBUFFEREDDRAW",2035},
 	{"SCI_SETCARETFORE",2069},
@@ -1982,6 +2005,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETCARETSTICKY",2458},
 	{"SCI_SETCARETSTYLE",2512},
 	{"SCI_SETCARETWIDTH",2188},
+	{"SCI_SETCHUNKSIZE",4024},
 	{"SCI_SETCODEPAGE",2037},
 	{"SCI_SETCONTROLCHARSYMBOL",2388},
 	{"SCI_SETCURRENTPOS",2141},
@@ -2011,6 +2035,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETKEYSUNICODE",2521},
 	{"SCI_SETKEYWORDS",4005},
 	{"SCI_SETLAYOUTCACHE",2272},
+	{"SCI_SETLAYOUTCACHEMEMORY",4041},
 	{"SCI_SETLEXER",4001},
 	{"SCI_SETLINEINDENTATION",2126},
 	{"SCI_SETLINESTATE",2092},
@@ -2032,6 +2057,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETOVERTYPE",2186},
 	{"SCI_SETPASTECONVERTENDINGS",2467},
 	{"SCI_SETPOSITIONCACHE",2514},
+	{"SCI_SETPOSITIONCACHEMEMORY",4037},
 	{"SCI_SETPRINTCOLOURMODE",2148},
 	{"SCI_SETPRINTMAGNIFICATION",2146},
 	{"SCI_SETPRINTWRAPMODE",2406},
@@ -2065,6 +2091,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETTECHNOLOGY",2630},
 	{"SCI_SETTWOPHASEDRAW",2284},
 	{"SCI_SETUNDOCOLLECTION",2012},
+	{"SCI_SETUNDOMEMORYLIMIT",4031},
 	{"SCI_SETUSETABS",2124},
 	{"SCI_SETVIEWEOL",2356},
 	{"SCI_SETVIEWWS",2021},
@@ -2076,6 +2103,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETWRAPINDENTMODE",2472},
 	{"SCI_SETWRAPMODE",2268},
 	{"SCI_SETWRAPSTARTINDENT",2464},
+	{"SCI_SETWRAPTHREADS",4029},
 	{"SCI_SETWRAPVISUALFLAGS",2460},
 	{"SCI_SETWRAPVISUALFLAGSLOCATION",2462},
 	{"SCI_SETXOFFSET",2397},
@@ -2294,6 +2322,9 @@ static IFaceConstant ifaceConstants[] = {
 	{"SC_EOL_CR",1},
 	{"SC_EOL_CRLF",0},
 	{"SC_EOL_LF",2},
+	{"SC_FOLDACTION_CONTRACT",0},
+	{"SC_FOLDACTION_EXPAND",1},
+	{"SC_FOLDACTION_TOGGLE",2},
 	{"SC_FOLDFLAG_LEVELNUMBERS",0x0040},
 	{"SC_FOLDFLAG_LINEAFTER_CONTRACTED",0x0010},
 	{"SC_FOLDFLAG_LINEAFTER_EXPANDED",0x0008},
@@ -2521,8 +2552,13 @@ static IFaceFunction ifaceFunctions[] = {
 	{"EndUndoAction", 2079, iface_void, {iface_void, iface_void}},
 	{"EnsureVisible", 2232, iface_void, {iface_int, iface_void}},
 	{"EnsureVisibleEnforcePolicy", 2234, iface_void, {iface_int, iface_void}},
+	{"ExpandChildren", 2239, iface_void, {iface_int, iface_int}},
 	{"FindColumn", 2456, iface_int, {iface_int, iface_int}},
 	{"FindText", 2150, iface_position, {iface_int, iface_findtext}},
+	{"FoldAll", 2662, iface_void, {iface_int, iface_void}},
+	{"FoldChildren", 2238, iface_void, {iface_int, iface_int}},
+	{"FoldLine", 2237, iface_void, {iface_int, iface_int}},
+	{"FoldToLevel", 4046, iface_void, {iface_int, iface_void}},
 	{"FormFeed", 2330, iface_void, {iface_void, iface_void}},
 	{"FormatRange", 2151, iface_position, {iface_bool, iface_formatrange}},
 	{"GetCurLine", 2027, iface_int, {iface_length, iface_stringresult}},
@@ -2585,6 +2621,7 @@ static IFaceFunction ifaceFunctions[] = {
 	{"LinesJoin", 2288, iface_void, {iface_void, iface_void}},
 	{"LinesSplit", 2289, iface_void, {iface_int, iface_void}},
 	{"LoadLexerLibrary", 4007, iface_void, {iface_void, iface_string}},
+	{"LoadUndoHistory", 4036, iface_bool, {iface_length, iface_string}},
 	{"LowerCase", 2340, iface_void, {iface_void, iface_void}},
 	{"MarginGetStyles", 2535, iface_int, {iface_int, iface_stringresult}},
 	{"MarginGetText", 2531, iface_int, {iface_int, iface_stringresult}},
@@ -2643,6 +2680,7 @@ static IFaceFunction ifaceFunctions[] = {
 	{"ReplaceTarget", 2194, iface_int, {iface_length, iface_string}},
 	{"ReplaceTargetRE", 2195, iface_int, {iface_length, iface_string}},
 	{"RotateSelection", 2606, iface_void, {iface_void, iface_void}},
+	{"SaveUndoHistory", 4035, iface_int, {iface_int, iface_stringresult}},
 	{"ScrollCaret", 2169, iface_void, {iface_void, iface_void}},
 	{"ScrollToEnd", 2629, iface_void, {iface_void, iface_void}},
 	{"ScrollToStart", 2628, iface_void, {iface_void, iface_void}},
@@ -2743,12 +2781,14 @@ static IFaceProperty ifaceProperties[] = {
 	{"AutoCChooseSingle", 2114, 2113, iface_bool, iface_void},
 	{"AutoCDropRestOfWord", 2271, 2270, iface_bool, iface_void},
 	{"AutoCFillUps", 0, 2112, iface_string, iface_void},
+	{"AutoCFuzzy", 4045, 4044, iface_bool, iface_void},
 	{"AutoCIgnoreCase", 2116, 2115, iface_bool, iface_void},
 	{"AutoCMaxHeight", 2211, 2210, iface_int, iface_void},
 	{"AutoCMaxWidth", 2209, 2208, iface_int, iface_void},
 	{"AutoCSeparator", 2107, 2106, iface_int, iface_void},
 	{"AutoCTypeSeparator", 2285, 2286, iface_int, iface_void},
 	{"BackSpaceUnIndents", 2263, 2262, iface_bool, iface_void},
+	{"BackgroundLexing", 4028, 4027, iface_bool, iface_void},
 	{"BufferedDraw", 2034, 2035, iface_bool, iface_void},
 	{"CallTipBack", 0, 2205, iface_colour, iface_void},
 	{"CallTipFore", 0, 2206, iface_colour, iface_void},
@@ -2765,6 +2805,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"CaretWidth", 2189, 2188, iface_int, iface_void},
 	{"CharAt", 2007, 0, iface_int, iface_position},
 	{"CharacterPointer", 2520, 0, iface_int, iface_void},
+	{"ChunkSize", 4025, 4024, iface_int, iface_void},
 	{"CodePage", 2137, 2037, iface_int, iface_void},
 	{"Column", 2129, 0, iface_int, iface_position},
 	{"ControlCharSymbol", 2389, 2388, iface_int, iface_void},
@@ -2804,6 +2845,8 @@ static IFaceProperty ifaceProperties[] = {
 	{"KeyWords", 0, 4005, iface_string, iface_int},
 	{"KeysUnicode", 2522, 2521, iface_bool, iface_void},
 	{"LayoutCache", 2273, 2272, iface_int, iface_void},
+	{"LayoutCacheMemory", 4042, 4041, iface_int, iface_void},
+	{"LayoutCacheMemoryUse", 4043, 0, iface_int, iface_void},
 	{"Length", 2006, 0, iface_int, iface_void},
 	{"Lexer", 4002, 4001, iface_int, iface_void},
 	{"LineCount", 2154, 0, iface_int, iface_void},
@@ -2835,6 +2878,9 @@ static IFaceProperty ifaceProperties[] = {
 	{"Overtype", 2187, 2186, iface_bool, iface_void},
 	{"PasteConvertEndings", 2468, 2467, iface_bool, iface_void},
 	{"PositionCache", 2515, 2514, iface_int, iface_void},
+	{"PositionCacheHits", 4039, 0, iface_int, iface_void},
+	{"PositionCacheMemory", 4038, 4037, iface_int, iface_void},
+	{"PositionCacheMisses", 4040, 0, iface_int, iface_void},
 	{"PrintColourMode", 2149, 2148, iface_int, iface_void},
 	{"PrintMagnification", 2147, 2146, iface_int, iface_void},
 	{"PrintWrapMode", 2407, 2406, iface_int, iface_void},
@@ -2890,7 +2936,10 @@ static IFaceProperty ifaceProperties[] = {
 	{"Technology", 2631, 2630, iface_int, iface_void},
 	{"TextLength", 2183, 0, iface_int, iface_void},
 	{"TwoPhaseDraw", 2283, 2284, iface_bool, iface_void},
+	{"UndoActions", 4034, 0, iface_int, iface_void},
 	{"UndoCollection", 2019, 2012, iface_bool, iface_void},
+	{"UndoMemoryLimit", 4032, 4031, iface_int, iface_void},
+	{"UndoMemoryUse", 4033, 0, iface_int, iface_void},
 	{"UseTabs", 2125, 2124, iface_bool, iface_void},
 	{"VScrollBar", 2281, 2280, iface_bool, iface_void},
 	{"ViewEOL", 2355, 2356, iface_bool, iface_void},
@@ -2902,6 +2951,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"WrapIndentMode", 2473, 2472, iface_int, iface_void},
 	{"WrapMode", 2269, 2268, iface_int, iface_void},
 	{"WrapStartIndent", 2465, 2464, iface_int, iface_void},
+	{"WrapThreads", 4030, 4029, iface_int, iface_void},
 	{"WrapVisualFlags", 2461, 2460, iface_int, iface_void},
 	{"WrapVisualFlagsLocation", 2463, 2462, iface_int, iface_void},
 	{"XOffset", 2398, 2397, iface_int, iface_void},
@@ -2909,9 +2959,9 @@ static IFaceProperty ifaceProperties[] = {
 };
 
 enum {
-	ifaceFunctionCount = 291,
-	ifaceConstantCount = 2298,
-	ifacePropertyCount = 181
+	ifaceFunctionCount = 298,
+	ifaceConstantCount = 2329,
+	ifacePropertyCount = 193
 };
 
 //--Autogenerated
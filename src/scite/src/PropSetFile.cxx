@@ -34,6 +34,7 @@
 #include "SString.h"
 #include "FilePath.h"
 #include "PropSetFile.h"
+#include "StringHelpers.h" //!-add-[PropsSnapshot]
 
 // The comparison and case changing functions here assume ASCII
 // or extended ASCII such as the normal Windows code page.
@@ -75,11 +76,15 @@ bool ImportFilter::IsValid(std::string name) const {
 }
 
 bool PropSetFile::caseSensitiveFilenames = false;
+PropsSources *PropSetFile::sourcesRead = 0; //!-add-[PropsSnapshot]
 
-PropSetFile::PropSetFile(bool lowerKeys_) : lowerKeys(lowerKeys_), superPS(0) {
+//!PropSetFile::PropSetFile(bool lowerKeys_) : lowerKeys(lowerKeys_), superPS(0) {
+PropSetFile::PropSetFile(bool lowerKeys_) : lowerKeys(lowerKeys_), generation(0), superPS(0) { //!-change-[PropsWildCache]
 }
 
-PropSetFile::PropSetFile(const PropSetFile &copy) : lowerKeys(copy.lowerKeys), props(copy.props), superPS(copy.superPS) {
+//!PropSetFile::PropSetFile(const PropSetFile &copy) : lowerKeys(copy.lowerKeys), props(copy.props), superPS(copy.superPS) {
+PropSetFile::PropSetFile(const PropSetFile &copy) : lowerKeys(copy.lowerKeys), props(copy.props), //!-change-[PropsWildCache]
+	generation(0), superPS(copy.superPS) {
 }
 
 PropSetFile::~PropSetFile() {
@@ -91,7 +96,11 @@ PropSetFile &PropSetFile::operator=(const PropSetFile &assign) {
 	if (this != &assign) {
 		lowerKeys = assign.lowerKeys;
 		superPS = assign.superPS;
+//!		props = assign.props;
+//!-start-[PropsWildCache]
 		props = assign.props;
+		generation++;
+//!-end-[PropsWildCache]
 		enumnext = "";
 	}
 	return *this;
@@ -104,7 +113,18 @@ void PropSetFile::Set(const char *key, const char *val, ptrdiff_t lenKey, ptrdif
 		lenKey = static_cast<int>(strlen(key));
 	if (lenVal == -1)
 		lenVal = static_cast<int>(strlen(val));
-	props[std::string(key, lenKey)] = std::string(val, lenVal);
+//!	props[std::string(key, lenKey)] = std::string(val, lenVal);
+//!-start-[PropsWildCache]
+	const std::string sKey(key, lenKey);
+	mapss::iterator keyPos = props.find(sKey);
+	if (keyPos == props.end()) {
+		props.insert(mapss::value_type(sKey, std::string(val, lenVal)));
+		generation++;
+	} else if (keyPos->second.compare(0, std::string::npos, val, lenVal) != 0) {
+		keyPos->second.assign(val, lenVal);
+		generation++;
+	}
+//!-end-[PropsWildCache]
 }
 
 void PropSetFile::Set(const char *keyVal) {
@@ -127,8 +147,14 @@ void PropSetFile::Unset(const char *key, int lenKey) {
 	if (lenKey == -1)
 		lenKey = static_cast<int>(strlen(key));
 	mapss::iterator keyPos = props.find(std::string(key, lenKey));
-	if (keyPos != props.end())
+//!	if (keyPos != props.end())
+//!		props.erase(keyPos);
+//!-start-[PropsWildCache]
+	if (keyPos != props.end()) {
 		props.erase(keyPos);
+		generation++;
+	}
+//!-end-[PropsWildCache]
 }
 
 void PropSetFile::SetMultiple(const char *s) {
@@ -204,9 +230,12 @@ static SString ShellEscape(const char *toEscape) {
 	return str.c_str();
 }
 
-SString PropSetFile::Evaluate(const char *key) const {
+//!SString PropSetFile::Evaluate(const char *key) const {
+SString PropSetFile::Evaluate(const char *key, std::set<std::string> *variablesRead) const { //!-change-[PropsWildCache]
 	if (strchr(key, ' ')) {
 		if (isprefix(key, "escape ")) {
+			if (variablesRead) //!-add-[PropsWildCache]
+				variablesRead->insert(key+7); //!-add-[PropsWildCache]
 			SString val = Get(key+7);
 			return ShellEscape(val.c_str());
 		} else if (isprefix(key, "star ")) {
@@ -217,6 +246,10 @@ SString PropSetFile::Evaluate(const char *key) const {
 			for (const PropSetFile *psf = this; psf; psf = psf->superPS) {
 				mapss::const_iterator it = psf->props.lower_bound(sKeybase);
 				while ((it != psf->props.end()) && (it->first.find(sKeybase) == 0)) {
+//!-start-[PropsWildCache]
+					if (variablesRead)
+						variablesRead->insert(it->first);
+//!-end-[PropsWildCache]
 					mapss::iterator itDestination = values.find(it->first);
 					if (itDestination == values.end()) {
 						// Not present so add
@@ -233,6 +266,8 @@ SString PropSetFile::Evaluate(const char *key) const {
 			return SString(combination.c_str());
 		}
 	} else {
+		if (variablesRead) //!-add-[PropsWildCache]
+			variablesRead->insert(key); //!-add-[PropsWildCache]
 		return Get(key);
 	}
 	return "";
@@ -255,7 +290,9 @@ struct VarChain {
 	const VarChain *link;
 };
 
-static int ExpandAllInPlace(const PropSetFile &props, SString &withVars, int maxExpands, const VarChain &blankVars = VarChain()) {
+//!static int ExpandAllInPlace(const PropSetFile &props, SString &withVars, int maxExpands, const VarChain &blankVars = VarChain()) {
+static int ExpandAllInPlace(const PropSetFile &props, SString &withVars, int maxExpands, const VarChain &blankVars = VarChain(), //!-change-[PropsWildCache]
+	std::set<std::string> *variablesRead = 0) {
 	int varStart = withVars.search("$(");
 	while ((varStart >= 0) && (maxExpands > 0)) {
 		int varEnd = withVars.search(")", varStart+2);
@@ -272,14 +309,16 @@ static int ExpandAllInPlace(const PropSetFile &props, SString &withVars, int max
 		}
 
 		SString var(withVars.c_str(), varStart + 2, varEnd);
-		SString val = props.Evaluate(var.c_str());
+//!		SString val = props.Evaluate(var.c_str());
+		SString val = props.Evaluate(var.c_str(), variablesRead); //!-change-[PropsWildCache]
 
 		if (blankVars.contains(var.c_str())) {
 			val.clear(); // treat blankVar as an empty string (e.g. to block self-reference)
 		}
 
 		if (--maxExpands >= 0) {
-			maxExpands = ExpandAllInPlace(props, val, maxExpands, VarChain(var.c_str(), &blankVars));
+//!			maxExpands = ExpandAllInPlace(props, val, maxExpands, VarChain(var.c_str(), &blankVars));
+			maxExpands = ExpandAllInPlace(props, val, maxExpands, VarChain(var.c_str(), &blankVars), variablesRead); //!-change-[PropsWildCache]
 		}
 
 		withVars.remove(varStart, varEnd-varStart+1);
@@ -291,9 +330,13 @@ static int ExpandAllInPlace(const PropSetFile &props, SString &withVars, int max
 	return maxExpands;
 }
 
-SString PropSetFile::GetExpanded(const char *key) const {
+//!SString PropSetFile::GetExpanded(const char *key) const {
+SString PropSetFile::GetExpanded(const char *key, std::set<std::string> *variablesRead) const { //!-change-[PropsWildCache]
+	if (variablesRead) //!-add-[PropsWildCache]
+		variablesRead->insert(key); //!-add-[PropsWildCache]
 	SString val = Get(key);
-	ExpandAllInPlace(*this, val, 100, VarChain(key));
+//!	ExpandAllInPlace(*this, val, 100, VarChain(key));
+	ExpandAllInPlace(*this, val, 100, VarChain(key), variablesRead); //!-change-[PropsWildCache]
 	return val;
 }
 
@@ -324,7 +367,12 @@ static bool isPrefix(const char *target, const char *prefix) {
 }
 
 void PropSetFile::Clear() {
+//!	props.clear();
+//!-start-[PropsWildCache]
+	if (!props.empty())
+		generation++;
 	props.clear();
+//!-end-[PropsWildCache]
 }
 
 char *PropSetFile::ToString() const {
@@ -414,13 +462,25 @@ bool PropSetFile::ReadLine(const char *lineBuffer, bool ifIsTrue, FilePath direc
 		ifIsTrue = true;
 	if (isPrefix(lineBuffer, "if ")) {
 		const char *expr = lineBuffer + strlen("if") + 1;
-		ifIsTrue = GetInt(expr) != 0;
+//!		ifIsTrue = GetInt(expr) != 0;
+//!-start-[PropsSnapshot]
+		std::set<std::string> variables;
+		ifIsTrue = GetExpanded(expr, sourcesRead ? &variables : 0).value() != 0;
+		for (std::set<std::string>::const_iterator it = variables.begin(); it != variables.end(); ++it) {
+			if (superPS)
+				sourcesRead->variables[*it] = superPS->Get(it->c_str()).c_str();
+			else
+				sourcesRead->variables[*it] = "";
+		}
+//!-end-[PropsSnapshot]
 	} else if (isPrefix(lineBuffer, "import ") && directoryForImports.IsSet()) {
 		SString importName(lineBuffer + strlen("import") + 1);
 		if (importName == "*") {
 			// Import all .properties files in this directory except for system properties
 			FilePathSet directories;
 			FilePathSet files;
+			if (sourcesRead) //!-add-[PropsSnapshot]
+				sourcesRead->Add(directoryForImports); //!-add-[PropsSnapshot]
 			directoryForImports.List(directories, files);
 			for (size_t i = 0; i < files.size(); i ++) {
 				FilePath fpFile = files[i];
@@ -434,6 +494,8 @@ bool PropSetFile::ReadLine(const char *lineBuffer, bool ifIsTrue, FilePath direc
 		} else if (filter.IsValid(importName.c_str())) {
 //!			importName += ".properties"; //!-remove-[import]
 			FilePath importPath(directoryForImports, FilePath(GUI::StringFromUTF8(importName.c_str())));
+			if (sourcesRead) //!-add-[PropsSnapshot]
+				sourcesRead->Add(importPath); //!-add-[PropsSnapshot]
 //!-start-[import]
             if(!importPath.Exists()) {
                 importName += ".properties";
@@ -468,6 +530,8 @@ void PropSetFile::ReadFromMemory(const char *data, size_t len, FilePath director
 
 bool PropSetFile::Read(FilePath filename, FilePath directoryForImports,
                        const ImportFilter &filter, std::vector<FilePath> *imports) {
+	if (sourcesRead) //!-add-[PropsSnapshot]
+		sourcesRead->Add(filename); //!-add-[PropsSnapshot]
 	FILE *rcfile = filename.Open(fileRead);
 	if (rcfile) {
 		char propsData[60000];
@@ -529,7 +593,99 @@ static bool startswith(const std::string &s, const char *keybase) {
 	return isPrefix(s.c_str(), keybase);
 }
 
+//!-start-[PropsWildCache]
+static bool SameKeys(const mapss &props, const std::vector<std::string> &keys) {
+	if (props.size() != keys.size())
+		return false;
+	std::vector<std::string>::const_iterator itKey = keys.begin();
+	for (mapss::const_iterator it = props.begin(); it != props.end(); ++it, ++itKey) {
+		if (it->first != *itKey)
+			return false;
+	}
+	return true;
+}
+
+// The cached results stay right while the same property sets are chained with the same
+// keys and the variables used in keys have the same values. Keys and values are only
+// compared for property sets changed since the last check, so clearing and reading the
+// same file again keeps the results.
+bool PropSetFile::WildCacheValid() {
+	bool valid = true;
+	std::vector<const PropSetFile *> changed;
+	size_t depth = 0;
+	for (const PropSetFile *psf = this; psf && valid; psf = psf->superPS, depth++) {
+		valid = (depth < wildCacheChain.size()) && (wildCacheChain[depth].ps == psf);
+		if (valid && (wildCacheChain[depth].generation != psf->generation)) {
+			changed.push_back(psf);
+			valid = SameKeys(psf->props, wildCacheChain[depth].keys);
+		}
+	}
+	valid = valid && (depth == wildCacheChain.size());
+	if (valid && changed.empty())
+		return true;
+	// With the same keys, a variable can only have a new value if it is set in a changed set
+	for (size_t i = 0; valid && (i < changed.size()); i++) {
+		const mapss &propsChanged = changed[i]->props;
+		for (mapss::const_iterator it = propsChanged.begin(); valid && (it != propsChanged.end()); ++it) {
+			mapss::const_iterator itVariable = wildCacheVariables.find(it->first);
+			if (itVariable != wildCacheVariables.end())
+				valid = itVariable->second == Get(it->first.c_str()).c_str();
+		}
+	}
+	if (!valid) {
+		wildCache.clear();
+		wildCacheVariables.clear();
+	}
+	// Keys are only copied again for the property sets that changed
+	std::vector<WildCacheSet> chain;
+	depth = 0;
+	for (const PropSetFile *psf = this; psf; psf = psf->superPS, depth++) {
+		chain.push_back(WildCacheSet());
+		WildCacheSet &wcs = chain.back();
+		wcs.ps = psf;
+		wcs.generation = psf->generation;
+		if ((depth < wildCacheChain.size()) && (wildCacheChain[depth].ps == psf) &&
+			(valid || (wildCacheChain[depth].generation == psf->generation))) {
+			wcs.keys.swap(wildCacheChain[depth].keys);
+		} else {
+			for (mapss::const_iterator it = psf->props.begin(); it != psf->props.end(); ++it)
+				wcs.keys.push_back(it->first);
+		}
+	}
+	wildCacheChain.swap(chain);
+	return valid;
+}
+
+void PropSetFile::AddWildCache(const std::string &cacheKey, const std::set<std::string> &variables,
+	const PropSetFile *psFound, const std::string &key) {
+	if (wildCache.size() >= 20000)
+		wildCache.clear();
+	for (std::set<std::string>::const_iterator it = variables.begin(); it != variables.end(); ++it)
+		wildCacheVariables[*it] = Get(it->c_str()).c_str();
+	wildCache[cacheKey] = WildFound(psFound, key);
+}
+//!-end-[PropsWildCache]
+
 SString PropSetFile::GetWildUsingStart(const PropSetFile &psStart, const char *keybase, const char *filename) {
+//!-start-[PropsWildCache]
+	std::string cacheKey(keybase);
+	cacheKey += '\0';
+	cacheKey += filename;
+	cacheKey += caseSensitiveFilenames ? '1' : '0';
+	if (&psStart == this) {
+		WildCacheValid();
+		std::map<std::string, WildFound>::const_iterator itFound = wildCache.find(cacheKey);
+		if (itFound != wildCache.end()) {
+			const PropSetFile *psFound = itFound->second.first;
+			if (!psFound)
+				return "";
+			mapss::const_iterator keyPos = psFound->props.find(itFound->second.second);
+			if (keyPos != psFound->props.end())
+				return SString(keyPos->second.c_str());
+		}
+	}
+	std::set<std::string> variables;
+//!-end-[PropsWildCache]
 	const std::string sKeybase(keybase);
 	const size_t lenKeybase = strlen(keybase);
 	const PropSetFile *psf = this;
@@ -543,7 +699,10 @@ SString PropSetFile::GetWildUsingStart(const PropSetFile &psStart, const char *k
 				const char *cpendvar = strchr(orgkeyfile, ')');
 				if (cpendvar) {
 					SString var(orgkeyfile, 2, cpendvar-orgkeyfile);
-					SString s = psStart.GetExpanded(var.c_str());
+//!					SString s = psStart.GetExpanded(var.c_str());
+//!-start-[PropsWildCache]
+					SString s = psStart.GetExpanded(var.c_str(), &variables);
+//!-end-[PropsWildCache]
 					keyptr = StringDup(s.c_str());
 				}
 			}
@@ -558,6 +717,8 @@ SString PropSetFile::GetWildUsingStart(const PropSetFile &psStart, const char *k
 					del = keyfile + strlen(keyfile);
 				if (MatchWild(keyfile, del - keyfile, filename, caseSensitiveFilenames)) {
 					delete []keyptr;
+					if (&psStart == this) //!-add-[PropsWildCache]
+						AddWildCache(cacheKey, variables, psf, it->first); //!-add-[PropsWildCache]
 					return SString(it->second.c_str());
 				}
 				if (*del == '\0')
@@ -567,6 +728,8 @@ SString PropSetFile::GetWildUsingStart(const PropSetFile &psStart, const char *k
 			delete []keyptr;
 
 			if (0 == strcmp(it->first.c_str(), keybase)) {
+				if (&psStart == this) //!-add-[PropsWildCache]
+					AddWildCache(cacheKey, variables, psf, it->first); //!-add-[PropsWildCache]
 				return SString(it->second.c_str());
 			}
 			++it;
@@ -574,6 +737,8 @@ SString PropSetFile::GetWildUsingStart(const PropSetFile &psStart, const char *k
 		// Failed here, so try in base property set
 		psf = psf->superPS;
 	}
+	if (&psStart == this) //!-add-[PropsWildCache]
+		AddWildCache(cacheKey, variables, 0, std::string()); //!-add-[PropsWildCache]
 	return "";
 }
 
@@ -651,6 +816,108 @@ bool PropSetFile::GetNext(const char *&key, const char *&val) {
 		return false;
 	}
 }
+//!-start-[PropsSnapshot]
+void PropsSources::Add(const FilePath &path) {
+	Stamp stamp;
+	stamp.path = path.AsUTF8();
+	time_t modified = 0;
+	Sci_Position size = 0;
+	if (path.Status(modified, size)) {
+		stamp.modified = modified;
+		stamp.size = size;
+	} else {
+		stamp.modified = 0;
+		stamp.size = -1;
+	}
+	stamps.push_back(stamp);
+}
+
+bool PropsSources::Current(const PropSetFile *base, time_t written) const {
+	for (std::vector<Stamp>::const_iterator it = stamps.begin(); it != stamps.end(); ++it) {
+		FilePath path(GUI::StringFromUTF8(it->path.c_str()));
+		time_t modified = 0;
+		Sci_Position size = 0;
+		if (path.Status(modified, size)) {
+			// Times are in seconds so a file changed in the second it was read may not look changed
+			if ((it->size != size) || (it->modified != modified) || (modified >= written))
+				return false;
+		} else if (it->size != -1) {
+			return false;
+		}
+	}
+	for (mapss::const_iterator itVar = variables.begin(); itVar != variables.end(); ++itVar) {
+		const SString value = base ? base->Get(itVar->first.c_str()) : SString();
+		if (itVar->second != value.c_str())
+			return false;
+	}
+	return true;
+}
+
+void PropsSources::AppendTo(std::string &data) const {
+	AppendNumber(data, static_cast<long long>(stamps.size()));
+	for (std::vector<Stamp>::const_iterator it = stamps.begin(); it != stamps.end(); ++it) {
+		AppendString(data, it->path);
+		AppendNumber(data, it->modified);
+		AppendNumber(data, it->size);
+	}
+	AppendNumber(data, static_cast<long long>(variables.size()));
+	for (mapss::const_iterator itVar = variables.begin(); itVar != variables.end(); ++itVar) {
+		AppendString(data, itVar->first);
+		AppendString(data, itVar->second);
+	}
+}
+
+bool PropsSources::ReadFrom(const char *&data, const char *end) {
+	stamps.clear();
+	variables.clear();
+	long long count = 0;
+	if (!ReadNumber(data, end, count))
+		return false;
+	for (long long i = 0; i < count; i++) {
+		Stamp stamp;
+		if (!ReadString(data, end, stamp.path) || !ReadNumber(data, end, stamp.modified) ||
+			!ReadNumber(data, end, stamp.size))
+			return false;
+		stamps.push_back(stamp);
+	}
+	if (!ReadNumber(data, end, count))
+		return false;
+	for (long long j = 0; j < count; j++) {
+		std::string name;
+		std::string value;
+		if (!ReadString(data, end, name) || !ReadString(data, end, value))
+			return false;
+		variables[name] = value;
+	}
+	return true;
+}
+
+void PropSetFile::AppendTo(std::string &data) const {
+	AppendNumber(data, static_cast<long long>(props.size()));
+	for (mapss::const_iterator it = props.begin(); it != props.end(); ++it) {
+		AppendString(data, it->first);
+		AppendString(data, it->second);
+	}
+}
+
+bool PropSetFile::ReadFrom(const char *&data, const char *end) {
+	Clear();
+	long long count = 0;
+	if (!ReadNumber(data, end, count))
+		return false;
+	for (long long i = 0; i < count; i++) {
+		std::string key;
+		std::string val;
+		if (!ReadString(data, end, key) || !ReadString(data, end, val) || key.empty())
+			return false;
+		// Written in order so each key goes at the end
+		props.insert(props.end(), mapss::value_type(key, val));
+	}
+	generation++;
+	return true;
+}
+//!-end-[PropsSnapshot]
+
 //!-start-[FindResultListStyle]
 const char * PropSetFile::GetString( const char *key ) const
 {
@@ -18,14 +18,60 @@ public:
 	bool IsValid(std::string name) const;
 };
 
+//!-start-[PropsSnapshot]
+class PropSetFile;
+
+/// The files and directories read for property files together with the values of base
+/// properties used by "if" lines, so it can be told whether reading the files again
+/// would give the same properties.
+class PropsSources {
+public:
+	struct Stamp {
+		std::string path;
+		long long modified;
+		long long size;	///< -1 when the file did not exist
+	};
+	std::vector<Stamp> stamps;
+	mapss variables;
+	void Add(const FilePath &path);
+	/// Whether all the files are unchanged and older than written and base has the same
+	/// values of the variables.
+	bool Current(const PropSetFile *base, time_t written) const;
+	void AppendTo(std::string &data) const;
+	bool ReadFrom(const char *&data, const char *end);
+};
+//!-end-[PropsSnapshot]
+
 class PropSetFile {
 	bool lowerKeys;
 	SString GetWildUsingStart(const PropSetFile &psStart, const char *keybase, const char *filename);
 	static bool caseSensitiveFilenames;
 	mapss props;
 	std::string enumnext;
+//!-start-[PropsWildCache]
+	/// Incremented whenever a key is added or removed or a value changes.
+	int generation;
+	/// Property set and key that GetWild found for each key base and file name,
+	/// or a null set for no match.
+	typedef std::pair<const PropSetFile *, std::string> WildFound;
+	std::map<std::string, WildFound> wildCache;
+	/// A property set the cached results depend on with its keys when they were found.
+	struct WildCacheSet {
+		const PropSetFile *ps;
+		int generation;
+		std::vector<std::string> keys;
+	};
+	std::vector<WildCacheSet> wildCacheChain;
+	/// Values of the properties read while expanding variables in keys such as
+	/// "lexer.$(file.patterns.cpp)".
+	mapss wildCacheVariables;
+	bool WildCacheValid();
+	void AddWildCache(const std::string &cacheKey, const std::set<std::string> &variables,
+		const PropSetFile *psFound, const std::string &key);
+//!-end-[PropsWildCache]
 public:
 	PropSetFile *superPS;
+	static PropsSources *sourcesRead;	///< Where Read records what it depends on //!-add-[PropsSnapshot]
 	PropSetFile(bool lowerKeys_=false);
 	PropSetFile(const PropSetFile &copy);
 	virtual ~PropSetFile();
@@ -37,8 +83,13 @@ public:
 	bool Exists(const char *key) const;
 	SString Get(const char *key) const;
 	const char *GetString(const char *key) const; //!-add-[FindResultListStyle]
-	SString Evaluate(const char *key) const;
-	SString GetExpanded(const char *key) const;
+//!	SString Evaluate(const char *key) const;
+//!	SString GetExpanded(const char *key) const;
+//!-start-[PropsWildCache]
+	/// When variablesRead is set, the names of all the properties read are added to it.
+	SString Evaluate(const char *key, std::set<std::string> *variablesRead=0) const;
+	SString GetExpanded(const char *key, std::set<std::string> *variablesRead=0) const;
+//!-end-[PropsWildCache]
 	SString Expand(const char *withVars, int maxExpands=100) const;
 	int GetInt(const char *key, int defaultValue=0) const;
 	void Clear();
@@ -53,6 +104,11 @@ public:
 	SString GetNewExpand(const char *keybase, const char *filename="");
 	bool GetFirst(const char *&key, const char *&val);
 	bool GetNext(const char *&key, const char *&val);
+//!-start-[PropsSnapshot]
+	/// Append all the keys and values to data in a form that ReadFrom reads back.
+	void AppendTo(std::string &data) const;
+	bool ReadFrom(const char *&data, const char *end);
+//!-end-[PropsSnapshot]
 	static void SetCaseSensitiveFilenames(bool caseSensitiveFilenames_) {
 		caseSensitiveFilenames = caseSensitiveFilenames_;
 	}
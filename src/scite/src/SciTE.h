@@ -159,6 +159,7 @@
 #define IDM_WRAP			414
 #define IDM_WRAPOUTPUT		415
 #define IDM_READONLY			416
+#define IDM_FOLLOW			417 //!-add-[TailFollow]
 
 #define IDM_CLEAROUTPUT		420
 #define IDM_SWITCHPANE			421
@@ -71,6 +71,8 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "FileWorker.h"
+#include "WordIndex.h" //!-add-[AutoCompleteWordIndex]
+#include "FileWatcher.h" //!-add-[FileWatcher]
 #include "SciTEBase.h"
 #define _MAX_EXTENSION_RECURSIVE_CALL 100 //!-add-[OnMenuCommand]
 
@@ -158,6 +160,8 @@ SciTEBase::SciTEBase(Extension *ext) : apis(true), extender(ext) {
 	allowMenuActions = true;
 	scrollOutput = 1;
 	returnOutputToCommand = true;
+	outputMaxSize = 0;	//!-add-[OutputBatch]
+	outputRemoved = 0;	//!-add-[OutputBatch]
 
 	ptStartDrag.x = 0;
 	ptStartDrag.y = 0;
@@ -176,6 +180,16 @@ SciTEBase::SciTEBase(Extension *ext) : apis(true), extender(ext) {
 	indentExamine = SC_IV_LOOKBOTH;
 
 	autoCompleteIgnoreCase = false;
+//!-start-[FuzzyAutoComplete]
+	autoCompleteFuzzy = false;
+	autoCompleteMaxItems = 100;
+	autoCFromApis = false;
+	autoCTruncated = false;
+//!-end-[FuzzyAutoComplete]
+//!-start-[AutoCompleteWordIndex]
+	autoCompleteWordIndex = false;
+	autoCompleteWordAllBuffers = false;
+//!-end-[AutoCompleteWordIndex]
 	callTipIgnoreCase = false;
 	calltipShowPerPage = 1; //!-add-[BetterCalltips]
 	autoCCausedByOnlyOne = false;
@@ -218,13 +232,36 @@ SciTEBase::SciTEBase(Extension *ext) : apis(true), extender(ext) {
 	wEditor.pBase = this; //!-add-[OnSendEditor]
 	OnMenuCommandCallsCount = 0;	//!-add-[OnMenuCommand]
 	quitting = false;
+	pIndexWorker = 0; //!-add-[TrigramIndex]
+	pWordIndexWorker = 0; //!-add-[AutoCompleteWordIndex]
+	pFileWatcher = 0; //!-add-[FileWatcher]
+	apisSize = 0; //!-add-[ApiCache]
 }
 
 SciTEBase::~SciTEBase() {
 	if (extender)
 		extender->Finalise();
+//!-start-[FileWatcher]
+	if (pFileWatcher) {
+		pFileWatcher->Cancel();
+		delete pFileWatcher;
+	}
+//!-end-[FileWatcher]
+//!-start-[TrigramIndex]
+	if (pIndexWorker) {
+		pIndexWorker->Cancel();
+		delete pIndexWorker;
+	}
+//!-end-[TrigramIndex]
+//!-start-[AutoCompleteWordIndex]
+	if (pWordIndexWorker) {
+		pWordIndexWorker->Cancel();
+		delete pWordIndexWorker;
+	}
+//!-end-[AutoCompleteWordIndex]
 	delete []languageMenu;
 	delete []shortCutItemList;
+	ClearApiCache(); //!-add-[ApiCache]
 }
 //!	popup.Destroy(); //!-remove-[ExtendedContextMenu]
 //!-start-[OnSendEditor]
@@ -401,6 +438,33 @@ int SciTEBase::ScintillaWindowEditor::Call( unsigned int msg, uptr_t wParam, spt
 }
 //!-end-[OnSendEditor]
 
+//!-start-[AutoCompleteWordIndex]
+// Documents shorter than this are counted at once rather than on another thread
+static const int wordIndexThreadMinimum = 0x10000;
+
+/// Counts the words of a copy of a document on its own thread.
+struct WordIndexWorker : public PostingWorker {
+	WorkerListener *pListener;
+	WordIndex *pIndex;
+	int generation;
+	std::vector<char> text;
+	std::string wordCharacters;
+	WordIndex::WordCounts counts;
+
+	WordIndexWorker(WorkerListener *pListener_, WordIndex *pIndex_, int generation_, const char *wordCharacters_) :
+		pListener(pListener_), pIndex(pIndex_), generation(generation_), wordCharacters(wordCharacters_) {
+	}
+	void Count() {
+		if (!text.empty())
+			WordIndex::CountAll(counts, &text[0], text.size(), wordCharacters.c_str(), &cancelling);
+	}
+	virtual void Execute() {
+		Count();
+		PostFinished(pListener, WORK_WORDINDEXED);
+	}
+};
+//!-end-[AutoCompleteWordIndex]
+
 void SciTEBase::WorkerCommand(int cmd, Worker *pWorker) {
 	switch (cmd) {
 	case WORK_FILEREAD:
@@ -414,6 +478,33 @@ void SciTEBase::WorkerCommand(int cmd, Worker *pWorker) {
 	case WORK_FILEPROGRESS:
  		UpdateProgress(pWorker);
 		break;
+//!-start-[TrigramIndex]
+	case WORK_GREPINDEXSTART:
+		GrepIndexStart(pWorker);
+		break;
+	case WORK_GREPINDEXED:
+		pIndexWorker->AwaitFinished();
+		delete pIndexWorker;
+		pIndexWorker = 0;
+		break;
+//!-end-[TrigramIndex]
+//!-start-[AutoCompleteWordIndex]
+	case WORK_WORDINDEXED: {
+			WordIndexWorker *pWordWorker = static_cast<WordIndexWorker *>(pWorker);
+			pWordWorker->AwaitFinished();
+			pWordIndexWorker = 0;
+			// The index stays allocated while SciTE runs so is still there even if its buffer closed
+			pWordWorker->pIndex->FinishBuild(pWordWorker->generation, pWordWorker->counts);
+			delete pWordWorker;
+		}
+		break;
+//!-end-[AutoCompleteWordIndex]
+//!-start-[FileWatcher]
+	case WORK_FILECHANGED:
+		// The watcher may have been stopped since it posted so its pointer is not used
+		FilesChanged();
+		break;
+//!-end-[FileWatcher]
 	}
 }
 
@@ -534,7 +625,7 @@ SString SciTEBase::GetLine(int line) {
 	return SString(text);
 }
 
-void SciTEBase::GetRange(GUI::ScintillaWindow &win, int start, int end, char *text) {
+void SciTEBase::GetRange(GUI::ScintillaWindow &win, Sci_Position start, Sci_Position end, char *text) {
 	Sci_TextRange tr;
 	tr.chrg.cpMin = start;
 	tr.chrg.cpMax = end;
@@ -1268,7 +1359,8 @@ int SciTEBase::FindNext(bool reverseDirection, bool showWarnings) {
 	int flags = (wholeWord ? SCFIND_WHOLEWORD : 0) |
 	        (matchCase ? SCFIND_MATCHCASE : 0) |
 	        (regExp ? SCFIND_REGEXP : 0) |
-	        (props.GetInt("find.replace.regexp.posix") ? SCFIND_POSIX : 0);
+	        (props.GetInt("find.replace.regexp.posix") ? SCFIND_POSIX : 0) |
+	        (props.GetInt("find.replace.regexp.dfa") ? SCFIND_DFAREGEX : 0); //!-change-[DFARegex]
 
 	wEditor.Call(SCI_SETSEARCHFLAGS, flags);
 	int posFind = FindInTarget(findTarget.c_str(), lenFind, startPosition, endPosition);
@@ -1378,8 +1470,31 @@ int SciTEBase::DoReplaceAll(bool inSelection) {
 	int flags = (wholeWord ? SCFIND_WHOLEWORD : 0) |
 	        (matchCase ? SCFIND_MATCHCASE : 0) |
 	        (regExp ? SCFIND_REGEXP : 0) |
-	        (props.GetInt("find.replace.regexp.posix") ? SCFIND_POSIX : 0);
+	        (props.GetInt("find.replace.regexp.posix") ? SCFIND_POSIX : 0) |
+	        (props.GetInt("find.replace.regexp.dfa") ? SCFIND_DFAREGEX : 0); //!-change-[DFARegex]
 	wEditor.Call(SCI_SETSEARCHFLAGS, flags);
+//!-start-[ReplaceAll]
+	if (!findInStyle && !(inSelection && countSelections > 1) &&
+		!((findLen == 1) && regExp && (findTarget[0] == '^'))) {
+		// Replace every match with a single modification of the document
+		Sci_Position lengthBefore = wEditor.Send(SCI_GETLENGTH);
+		wEditor.Call(SCI_SETTARGETSTART, startPosition);
+		wEditor.Call(SCI_SETTARGETEND, endPosition);
+		Sci_TextToReplace ttr = {findTarget.c_str(), findLen, replaceTarget.c_str(), replaceLen};
+		int replacements = static_cast<int>(wEditor.Send(SCI_REPLACEALLINTARGET, 0, reinterpret_cast<sptr_t>(&ttr)));
+		if (replacements > 0) {
+			endPosition += static_cast<int>(wEditor.Send(SCI_GETLENGTH) - lengthBefore);
+			int lastMatch = wEditor.Call(SCI_GETTARGETEND);
+			if (inSelection) {
+				SetSelection(startPosition, endPosition);
+			} else {
+				if(!props.GetInt("find.replace.return.to.start"))
+				SetSelection(lastMatch, lastMatch);
+			}
+		}
+		return replacements;
+	}
+//!-end-[ReplaceAll]
 	int posFind = FindInTarget(findTarget.c_str(), findLen, startPosition, endPosition);
 	if ((findLen == 1) && regExp && (findTarget[0] == '^')) {
 		// Special case for replace all start of line so it hits the first line
@@ -1508,6 +1623,7 @@ void SciTEBase::OutputAppendString(const char *s, int len) {
 	if (len == -1)
 		len = static_cast<int>(strlen(s));
 	wOutput.Call(SCI_APPENDTEXT, len, reinterpret_cast<sptr_t>(s));
+	OutputLimitSize(false);	//!-add-[OutputBatch]
 	if (scrollOutput) {
 		int line = wOutput.Call(SCI_GETLINECOUNT, 0, 0);
 		int lineStart = wOutput.Call(SCI_POSITIONFROMLINE, line);
@@ -1519,6 +1635,7 @@ void SciTEBase::OutputAppendStringSynchronised(const char *s, int len) {
 	if (len == -1)
 		len = static_cast<int>(strlen(s));
 	wOutput.Send(SCI_APPENDTEXT, len, reinterpret_cast<sptr_t>(s));
+	OutputLimitSize(true);	//!-add-[OutputBatch]
 	if (scrollOutput) {
 		sptr_t line = wOutput.Send(SCI_GETLINECOUNT);
 		sptr_t lineStart = wOutput.Send(SCI_POSITIONFROMLINE, line);
@@ -1526,6 +1643,68 @@ void SciTEBase::OutputAppendStringSynchronised(const char *s, int len) {
 	}
 }
 
+//!-start-[OutputBatch]
+static sptr_t OutputMessage(GUI::ScintillaWindow &w, bool synchronised,
+	unsigned int msg, uptr_t wParam = 0, sptr_t lParam = 0) {
+	return synchronised ? w.Send(msg, wParam, lParam) : w.Call(msg, wParam, lParam);
+}
+
+void SciTEBase::OutputLimitSize(bool synchronised) {
+	if (outputMaxSize <= 0)
+		return;
+	const int length = static_cast<int>(OutputMessage(wOutput, synchronised, SCI_GETLENGTH));
+	if (length <= outputMaxSize)
+		return;
+	// Remove whole lines from the start leaving the output a quarter below the
+	// limit so it is not trimmed again for every append
+	const int keep = outputMaxSize - outputMaxSize / 4;
+	const int lineCut = static_cast<int>(OutputMessage(wOutput, synchronised,
+		SCI_LINEFROMPOSITION, length - keep));
+	int removed = static_cast<int>(OutputMessage(wOutput, synchronised,
+		SCI_POSITIONFROMLINE, lineCut + 1));
+	if (removed >= length) {
+		// The last line alone is over the limit so cut it between characters
+		removed = static_cast<int>(OutputMessage(wOutput, synchronised,
+			SCI_POSITIONAFTER, length - keep - 1));
+	}
+	// Each line of the error list is styled on its own so the lines kept keep
+	// their styles and only the text not yet styled is lexed
+	const int endStyled = static_cast<int>(OutputMessage(wOutput, synchronised, SCI_GETENDSTYLED));
+	OutputMessage(wOutput, synchronised, SCI_SETTARGETSTART, 0);
+	OutputMessage(wOutput, synchronised, SCI_SETTARGETEND, removed);
+	OutputMessage(wOutput, synchronised, SCI_REPLACETARGET, 0, reinterpret_cast<sptr_t>(""));
+	if (endStyled > removed)
+		OutputMessage(wOutput, synchronised, SCI_STARTSTYLING, endStyled - removed, 0);
+	// Undo would bring back what was removed
+	OutputMessage(wOutput, synchronised, SCI_EMPTYUNDOBUFFER);
+	outputRemoved += removed;
+}
+
+// Tool output is shown at most this often, in seconds, or when this much is
+// waiting, rather than appending, lexing and scrolling for every read.
+static const double outputInterval = 0.1;
+static const size_t outputPendingMax = 0x100000;
+
+bool SciTEBase::OutputAppendBatched(const char *s, int len, bool synchronised) {
+	outputPending.append(s, len);
+	if ((outputPending.length() < outputPendingMax) && (outputShown.Duration() < outputInterval))
+		return false;
+	return OutputFlush(synchronised);
+}
+
+bool SciTEBase::OutputFlush(bool synchronised) {
+	outputShown.Duration(true);
+	if (!outputPending.length())
+		return false;
+	if (synchronised)
+		OutputAppendStringSynchronised(outputPending.c_str(), static_cast<int>(outputPending.length()));
+	else
+		OutputAppendString(outputPending.c_str(), static_cast<int>(outputPending.length()));
+	outputPending.clear();
+	return true;
+}
+//!-end-[OutputBatch]
+
 void SciTEBase::MakeOutputVisible() {
 	if (heightOutput <= 0) {
 		ToggleOutputVisible();
@@ -1564,7 +1743,12 @@ void SciTEBase::Execute() {
 		ParamGrab();
 	}
 	for (ic = 0; ic < jobQueue.commandMax; ic++) {
-		jobQueue.jobQueue[ic].command = props.Expand(jobQueue.jobQueue[ic].command.c_str());
+//!		jobQueue.jobQueue[ic].command = props.Expand(jobQueue.jobQueue[ic].command.c_str());
+//!-start-[ParallelGrep]
+		// Search parameters are separated by NULs so would be cut short by expanding
+		if (jobQueue.jobQueue[ic].jobType != jobGrep)
+			jobQueue.jobQueue[ic].command = props.Expand(jobQueue.jobQueue[ic].command.c_str());
+//!-end-[ParallelGrep]
 	}
 
 	if (jobQueue.ClearBeforeExecute()) {
@@ -1953,13 +2137,24 @@ bool SciTEBase::StartAutoComplete() {
 
 	SString root = line.substr(startword, current - startword);
 	if (apis) {
-		char *words = GetNearestWords(root.c_str(), root.length(),
-			calltipParametersStart.c_str(), autoCompleteIgnoreCase);
+//!-start-[FuzzyAutoComplete]
+		// Names are looked up in an index of the api files built on first use, so without
+		// duplicates and quickly even for large files. Lists are kept short so they open
+		// quickly on all platforms and are looked up again as typing narrows them.
+		char *words = apis.GetCompletions(root.c_str(), root.length(), autoCompleteIgnoreCase,
+			calltipParametersStart.c_str(), autoCompleteFuzzy, autoCompleteMaxItems, autoCTruncated);
+//!-end-[FuzzyAutoComplete]
+//!		char *words = GetNearestWords(root.c_str(), root.length(),
+//!			calltipParametersStart.c_str(), autoCompleteIgnoreCase);
 		if (words) {
-			EliminateDuplicateWords(words);
+//!			EliminateDuplicateWords(words);
 			wEditor.Call(SCI_AUTOCSETSEPARATOR, ' ');
+			wEditor.Call(SCI_AUTOCSETFUZZY, autoCompleteFuzzy); //!-add-[FuzzyAutoComplete]
 			wEditor.CallString(SCI_AUTOCSHOW, root.length(), words);
+			autoCFromApis = wEditor.Call(SCI_AUTOCACTIVE) != 0; //!-add-[FuzzyAutoComplete]
 			delete []words;
+		} else if (autoCompleteFuzzy) { //!-add-[FuzzyAutoComplete]
+			wEditor.Call(SCI_AUTOCCANCEL); //!-add-[FuzzyAutoComplete]
 		}
 	}
 	return true;
@@ -1982,6 +2177,23 @@ bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 	if (startword == current || allNumber)
 		return true;
 	SString root = line.substr(startword, current - startword);
+//!-start-[AutoCompleteWordIndex]
+	if (autoCompleteWordIndex) {
+		WordIndex *pIndex = CurrentBuffer()->wordIndex;
+		if (!pIndex || pIndex->Empty() ||
+			(pIndex->Ready() && !pIndex->Valid(LengthDocument(), wordCharacters.c_str()))) {
+			WordIndexStart();
+			pIndex = CurrentBuffer()->wordIndex;
+		}
+		if (pIndex && pIndex->Valid(LengthDocument(), wordCharacters.c_str())) {
+			size_t wordEnd = current;
+			while ((wordEnd < line.length()) && wordCharacters.contains(line[wordEnd]))
+				wordEnd++;
+			return ShowWordsFromIndex(root, line.substr(startword, wordEnd - startword), onlyOneWord);
+		}
+		// Still being built or not indexed so search the document
+	}
+//!-end-[AutoCompleteWordIndex]
 	int doclen = LengthDocument();
 	Sci_TextToFind ft = {{0, 0}, 0, {0, 0}};
 	ft.lpstrText = const_cast<char *>(root.c_str());
@@ -2040,6 +2252,8 @@ bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 		// Return spaces from \001
 		acText.substitute('\001', ' ');
 		wEditor.Call(SCI_AUTOCSETSEPARATOR, '\n');
+		wEditor.Call(SCI_AUTOCSETFUZZY, 0); //!-add-[FuzzyAutoComplete]
+		autoCFromApis = false; //!-add-[FuzzyAutoComplete]
 		wEditor.CallString(SCI_AUTOCSHOW, root.length(), acText.c_str());
 		delete []words;
 	} else {
@@ -2048,6 +2262,119 @@ bool SciTEBase::StartAutoCompleteWord(bool onlyOneWord) {
 	return true;
 }
 
+//!-start-[AutoCompleteWordIndex]
+// Built when first needed for autocompletion so opening files does not wait to copy
+// them. Documents which are large or mapped from their files, which copying would
+// undo, are searched instead.
+void SciTEBase::WordIndexStart() {
+	// Only one index is built at a time
+	if (pWordIndexWorker)
+		return;
+	const Sci_Position length = wEditor.Call(SCI_GETLENGTH);
+	const int mappedSize = props.GetInt("mapped.open.size", -1);
+	long long sizeLimit = props.GetInt("autocompleteword.index.size", 64);
+	sizeLimit *= 1024 * 1024;
+	if ((length > sizeLimit) || ((mappedSize >= 0) && (length >= mappedSize)))
+		return;
+	Buffer *buffer = CurrentBuffer();
+	if (!buffer->wordIndex)
+		buffer->wordIndex = new WordIndex();
+	const int generation = buffer->wordIndex->StartBuild(length, wordCharacters.c_str());
+	WordIndexWorker *pWorker = new WordIndexWorker(this, buffer->wordIndex, generation, wordCharacters.c_str());
+	pWorker->text.resize(length + 1);
+	GetRange(wEditor, 0, length, &pWorker->text[0]);
+	pWorker->text.resize(length);
+	if (length >= wordIndexThreadMinimum) {
+		pWordIndexWorker = pWorker;
+		if (PerformOnNewThread(pWorker))
+			return;
+		pWordIndexWorker = 0;
+	}
+	pWorker->Count();
+	buffer->wordIndex->FinishBuild(generation, pWorker->counts);
+	delete pWorker;
+}
+
+void SciTEBase::WordIndexModified(const SCNotification *notification) {
+	WordIndex *pIndex = CurrentBuffer()->wordIndex;
+	if (!pIndex || pIndex->Empty())
+		return;
+	const int modificationType = notification->modificationType;
+	const bool before = (modificationType & (SC_MOD_BEFOREINSERT | SC_MOD_BEFOREDELETE)) != 0;
+	if (!before && !(modificationType & (SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT)))
+		return;
+	const int lengthDoc = LengthDocument();
+	if ((modificationType & SC_MOD_BEFOREDELETE) &&
+		(notification->position == 0) && (notification->length == lengthDoc)) {
+		pIndex->BeforeClear();
+		return;
+	}
+	// Only the words touching the changed text can change
+	int start = notification->position;
+	int end = start;
+	if (modificationType & (SC_MOD_BEFOREDELETE | SC_MOD_INSERTTEXT))
+		end += notification->length;
+	TextReader acc(wEditor);
+	while ((start > 0) && wordCharacters.contains(acc.SafeGetCharAt(start - 1)))
+		start--;
+	while ((end < lengthDoc) && wordCharacters.contains(acc.SafeGetCharAt(end)))
+		end++;
+	SString text = GetRange(wEditor, start, end);
+	if (before) {
+		pIndex->BeforeChange(text.c_str(), text.length());
+	} else {
+		const int lengthChange = (modificationType & SC_MOD_INSERTTEXT) ?
+			notification->length : -notification->length;
+		pIndex->AfterChange(text.c_str(), text.length(), lengthChange);
+	}
+}
+
+void SciTEBase::WordIndexInvalidateAll() {
+	for (int i = 0; i < buffers.size; i++) {
+		if (buffers.buffers[i].wordIndex)
+			buffers.buffers[i].wordIndex->Invalidate();
+	}
+}
+
+bool SciTEBase::ShowWordsFromIndex(const SString &root, const SString &wordCurrent, bool onlyOneWord) {
+	std::vector<std::string> words;
+	CurrentBuffer()->wordIndex->Find(root.c_str(), autoCompleteIgnoreCase, wordCurrent.c_str(), words);
+	if (autoCompleteWordAllBuffers) {
+		// Hidden documents are not changed so their counts are still right
+		for (int i = 0; i < buffers.length; i++) {
+			WordIndex *pIndex = buffers.buffers[i].wordIndex;
+			if ((i != buffers.Current()) && pIndex && pIndex->Ready())
+				pIndex->Find(root.c_str(), autoCompleteIgnoreCase, std::string(), words);
+		}
+		if (autoCompleteIgnoreCase)
+			std::sort(words.begin(), words.end(), WordLessNoCase());
+		else
+			std::sort(words.begin(), words.end());
+		words.erase(std::unique(words.begin(), words.end()), words.end());
+	} else if (!autoCompleteIgnoreCase) {
+		// The index is in the order for ignoring case
+		std::sort(words.begin(), words.end());
+	}
+	if (onlyOneWord && (words.size() > 1))
+		return true;
+	if (words.empty()) {
+		wEditor.Call(SCI_AUTOCCANCEL);
+		return true;
+	}
+	std::string acText;
+	for (size_t i = 0; i < words.size(); i++) {
+		if (i)
+			acText += '\n';
+		acText += words[i];
+	}
+	wEditor.Call(SCI_AUTOCSETSEPARATOR, '\n');
+	wEditor.Call(SCI_AUTOCSETFUZZY, 0);
+	autoCFromApis = false;
+	wEditor.CallString(SCI_AUTOCSHOW, root.length(), acText.c_str());
+	return true;
+}
+//!-end-[AutoCompleteWordIndex]
+
 bool SciTEBase::StartInsertAbbreviation() {
 	if (!AbbrevDialog()) {
 		return true;
@@ -3034,6 +3361,11 @@ void SciTEBase::CharAdded(char ch) {
 				if (autoCompleteStartCharacters.contains(ch)) {
 					StartAutoComplete();
 				}
+//!-start-[FuzzyAutoComplete]
+			} else if ((autoCompleteFuzzy || autoCTruncated) && autoCFromApis) {
+				// Rank the names again or find those cut off for the longer text
+				StartAutoComplete();
+//!-end-[FuzzyAutoComplete]
 			} else if (autoCCausedByOnlyOne) {
 //!				StartAutoCompleteWord(true);
 				StartAutoCompleteWord(!props.GetInt("autocompleteword.incremental")); //!-change-[autocompleteword.incremental]
@@ -3739,6 +4071,18 @@ void SciTEBase::MenuCommand(int cmdID, int source) {
 		BuffersMenu(); //!-add-[ReadOnlyTabMarker]
 		break;
 
+//!-start-[TailFollow]
+	case IDM_FOLLOW:
+		// A document with changes does not match the file so where to follow from is unknown
+		if (CurrentBuffer()->follow || (CanFollow() && !CurrentBuffer()->isDirty)) {
+			CurrentBuffer()->follow = !CurrentBuffer()->follow;
+			CurrentBuffer()->followOffset = -1;
+			FollowFile();
+			CheckMenus();
+		}
+		break;
+//!-end-[TailFollow]
+
 	case IDM_VIEWTABBAR:
 		tabVisible = !tabVisible;
 		ShowTabBar();
@@ -3986,7 +4330,7 @@ void SciTEBase::FoldChanged(int line, int levelNow, int levelPrev) {
 			// Adding a fold point.
 			wEditor.Call(SCI_SETFOLDEXPANDED, line, 1);
 			if (!wEditor.Call(SCI_GETALLLINESVISIBLE))
-				Expand(line, true, false, 0, levelPrev);
+				wEditor.Call(SCI_EXPANDCHILDREN, line, levelPrev);	//!-change-[FoldBulk]
 		}
 	} else if (levelPrev & SC_FOLDLEVELHEADERFLAG) {
 		if (!wEditor.Call(SCI_GETFOLDEXPANDED, line)) {
@@ -3994,7 +4338,7 @@ void SciTEBase::FoldChanged(int line, int levelNow, int levelPrev) {
 			// otherwise lines are left invisible with no way to make them visible
 			wEditor.Call(SCI_SETFOLDEXPANDED, line, 1);
 			if (!wEditor.Call(SCI_GETALLLINESVISIBLE))
-				Expand(line, true, false, 0, levelPrev);
+				wEditor.Call(SCI_EXPANDCHILDREN, line, levelPrev);	//!-change-[FoldBulk]
 		}
 	}
 	if (!(levelNow & SC_FOLDLEVELWHITEFLAG) &&
@@ -4011,70 +4355,10 @@ void SciTEBase::FoldChanged(int line, int levelNow, int levelPrev) {
 	}
 }
 
-void SciTEBase::Expand(int &line, bool doExpand, bool force, int visLevels, int level) {
-	int lineMaxSubord = wEditor.Call(SCI_GETLASTCHILD, line, level & SC_FOLDLEVELNUMBERMASK);
-	line++;
-	while (line <= lineMaxSubord) {
-		if (force) {
-			if (visLevels > 0)
-				wEditor.Call(SCI_SHOWLINES, line, line);
-			else
-				wEditor.Call(SCI_HIDELINES, line, line);
-		} else {
-			if (doExpand)
-				wEditor.Call(SCI_SHOWLINES, line, line);
-		}
-		int levelLine = level;
-		if (levelLine == -1)
-			levelLine = wEditor.Call(SCI_GETFOLDLEVEL, line);
-		if (levelLine & SC_FOLDLEVELHEADERFLAG) {
-			if (force) {
-				if (visLevels > 1)
-					wEditor.Call(SCI_SETFOLDEXPANDED, line, 1);
-				else
-					wEditor.Call(SCI_SETFOLDEXPANDED, line, 0);
-				Expand(line, doExpand, force, visLevels - 1);
-			} else {
-				if (doExpand) {
-					if (!wEditor.Call(SCI_GETFOLDEXPANDED, line))
-						wEditor.Call(SCI_SETFOLDEXPANDED, line, 1);
-					Expand(line, true, force, visLevels - 1);
-				} else {
-					Expand(line, false, force, visLevels - 1);
-				}
-			}
-		} else {
-			line++;
-		}
-	}
-}
-
 void SciTEBase::FoldAll() {
-	wEditor.Call(SCI_COLOURISE, 0, -1);
-	int maxLine = wEditor.Call(SCI_GETLINECOUNT);
-	bool expanding = true;
-	for (int lineSeek = 0; lineSeek < maxLine; lineSeek++) {
-		if (wEditor.Call(SCI_GETFOLDLEVEL, lineSeek) & SC_FOLDLEVELHEADERFLAG) {
-			expanding = !wEditor.Call(SCI_GETFOLDEXPANDED, lineSeek);
-			break;
-		}
-	}
-	for (int line = 0; line < maxLine; line++) {
-		int level = wEditor.Call(SCI_GETFOLDLEVEL, line);
-		if ((level & SC_FOLDLEVELHEADERFLAG) &&
-		        (SC_FOLDLEVELBASE == (level & SC_FOLDLEVELNUMBERMASK))) {
-			if (expanding) {
-				wEditor.Call(SCI_SETFOLDEXPANDED, line, 1);
-				Expand(line, true, false, 0, level);
-				line--;
-			} else {
-				int lineMaxSubord = wEditor.Call(SCI_GETLASTCHILD, line, -1);
-				wEditor.Call(SCI_SETFOLDEXPANDED, line, 0);
-				if (lineMaxSubord > line)
-					wEditor.Call(SCI_HIDELINES, line + 1, lineMaxSubord);
-			}
-		}
-	}
+//!-start-[FoldBulk]
+	wEditor.Call(SCI_FOLDALL, SC_FOLDACTION_TOGGLE);
+//!-end-[FoldBulk]
 }
 
 void SciTEBase::GotoLineEnsureVisible(int line) {
@@ -4110,22 +4394,16 @@ bool SciTEBase::MarginClick(int position, int modifiers) {
 	return true;
 }
 
-void SciTEBase::ToggleFoldRecursive(int line, int level) {
-	if (wEditor.Call(SCI_GETFOLDEXPANDED, line)) {
-		// Contract this line and all children
-		wEditor.Call(SCI_SETFOLDEXPANDED, line, 0);
-		Expand(line, false, true, 0, level);
-	} else {
-		// Expand this line and all children
-		wEditor.Call(SCI_SETFOLDEXPANDED, line, 1);
-		Expand(line, true, true, 100, level);
-	}
+void SciTEBase::ToggleFoldRecursive(int line, int) {
+//!-start-[FoldBulk]
+	// Contract or expand this line and all children
+	wEditor.Call(SCI_FOLDCHILDREN, line, SC_FOLDACTION_TOGGLE);
+//!-end-[FoldBulk]
 }
 
-void SciTEBase::EnsureAllChildrenVisible(int line, int level) {
+void SciTEBase::EnsureAllChildrenVisible(int line, int) {
 	// Ensure all children visible
-	wEditor.Call(SCI_SETFOLDEXPANDED, line, 1);
-	Expand(line, true, true, 100, level);
+	wEditor.Call(SCI_FOLDCHILDREN, line, SC_FOLDACTION_EXPAND);	//!-change-[FoldBulk]
 }
 
 void SciTEBase::NewLineInOutput() {
@@ -4195,6 +4473,11 @@ void SciTEBase::Notify(SCNotification *notification) {
 		break;
 //!-start-[autocompleteword.incremental]
 	case SCN_AUTOCUPDATED:
+//!-start-[FuzzyAutoComplete]
+		if ((autoCompleteFuzzy || autoCTruncated) && autoCFromApis && (notification->nmhdr.idFrom == IDM_SRCWIN))
+			StartAutoComplete();
+		else
+//!-end-[FuzzyAutoComplete]
 		if (props.GetInt("autocompleteword.incremental"))
 		{
 			StartAutoCompleteWord(false);
@@ -4328,6 +4611,10 @@ void SciTEBase::Notify(SCNotification *notification) {
 		break;
 
 	case SCN_MODIFIED:
+//!-start-[AutoCompleteWordIndex]
+		if (autoCompleteWordIndex && (notification->nmhdr.idFrom == IDM_SRCWIN))
+			WordIndexModified(notification);
+//!-end-[AutoCompleteWordIndex]
 		if (notification->modificationType & SC_LASTSTEPINUNDOREDO) {
 			//when the user hits undo or redo, several normal insert/delete
 			//notifications may fire, but we will end up here in the end
@@ -4415,12 +4702,13 @@ void SciTEBase::Notify(SCNotification *notification) {
 
 	case SCN_DWELLSTART:
 		if (extender && (INVALID_POSITION != notification->position)) {
-			int endWord = notification->position;
+			int startWord = static_cast<int>(notification->position);
+			int endWord = startWord;
 			SString message =
 				RangeExtendAndGrab(wEditor,
-					notification->position, endWord, &SciTEBase::iswordcharforsel);
+					startWord, endWord, &SciTEBase::iswordcharforsel);
 			if (message.length()) {
-				extender->OnDwellStart(notification->position,message.c_str());
+				extender->OnDwellStart(startWord,message.c_str());
 			}
 		}
 		break;
@@ -4480,6 +4768,8 @@ void SciTEBase::CheckMenus() {
 	CheckAMenuItem(IDM_WRAP, wrap);
 	CheckAMenuItem(IDM_WRAPOUTPUT, wrapOutput);
 	CheckAMenuItem(IDM_READONLY, isReadOnly);
+	EnableAMenuItem(IDM_FOLLOW, CurrentBuffer()->follow || (CanFollow() && !CurrentBuffer()->isDirty)); //!-add-[TailFollow]
+	CheckAMenuItem(IDM_FOLLOW, CurrentBuffer()->follow); //!-add-[TailFollow]
 	CheckAMenuItem(IDM_FULLSCREEN, fullScreen);
 	CheckAMenuItem(IDM_VIEWTOOLBAR, tbVisible);
 	CheckAMenuItem(IDM_VIEWTABBAR, tabVisible);
@@ -5200,7 +5490,8 @@ bool SciTEBase::ProcessCommandLine(GUI::gui_string &args, int phase) {
 				char unquoted[1000];
 				strcpy(unquoted, GUI::UTF8FromString(wlArgs[i+3].c_str()).c_str());
 				UnSlash(unquoted);
-				InternalGrep(gf, FilePath::GetWorkingDirectory().AsInternal(), wlArgs[i+2].c_str(), unquoted);
+//!				InternalGrep(gf, FilePath::GetWorkingDirectory().AsInternal(), wlArgs[i+2].c_str(), unquoted);
+				InternalGrep(gf, FilePath::GetWorkingDirectory().AsInternal(), wlArgs[i+2].c_str(), unquoted, GrepSettingsFromProps()); //!-change-[ParallelGrep]
 				exit(0);
 			} else {
 				if (AfterName(arg) == ':') {
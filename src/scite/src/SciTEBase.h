@@ -103,6 +103,9 @@ public:
 };
 
 struct FileWorker;
+class WordIndex; //!-add-[AutoCompleteWordIndex]
+class FileWatcher; //!-add-[FileWatcher]
+struct FileChange; //!-add-[TailFollow]
 
 class Buffer : public RecentFile {
 public:
@@ -121,10 +124,19 @@ public:
 	FileWorker *pFileWorker;
 	PropSetFile props;
 	enum FutureDo { fdNone=0, fdFinishSave=1 } futureDo;
+	bool undoPending;	///< Saved undo history not yet restored //!-add-[PersistentUndo]
+	WordIndex *wordIndex;	///< Words of the document, stays with the document when buffers move //!-add-[AutoCompleteWordIndex]
+//!-start-[TailFollow]
+	bool follow;	///< Add what is appended to the file to the end of the document
+	Sci_Position followOffset;	///< How much of the file is in the document, -1 when it is all of the document
+//!-end-[TailFollow]
 	Buffer() :
 //!			RecentFile(), doc(0), isDirty(false), useMonoFont(false), lifeState(empty),
 			RecentFile(), doc(0), isDirty(false), ROMarker(0), useMonoFont(false), lifeState(empty),  //!-change-[ReadOnlyTabMarker]
-			unicodeMode(uni8Bit), fileModTime(0), fileModLastAsk(0), findMarks(fmNone), pFileWorker(0), futureDo(fdNone) {}
+//!			unicodeMode(uni8Bit), fileModTime(0), fileModLastAsk(0), findMarks(fmNone), pFileWorker(0), futureDo(fdNone) {}
+//!			unicodeMode(uni8Bit), fileModTime(0), fileModLastAsk(0), findMarks(fmNone), pFileWorker(0), futureDo(fdNone), undoPending(false) {} //!-change-[PersistentUndo]
+//!			unicodeMode(uni8Bit), fileModTime(0), fileModLastAsk(0), findMarks(fmNone), pFileWorker(0), futureDo(fdNone), undoPending(false), wordIndex(0) {} //!-change-[AutoCompleteWordIndex]
+			unicodeMode(uni8Bit), fileModTime(0), fileModLastAsk(0), findMarks(fmNone), pFileWorker(0), futureDo(fdNone), undoPending(false), wordIndex(0), follow(false), followOffset(-1) {} //!-change-[TailFollow]
 
 	void Init() {
 		RecentFile::Init();
@@ -141,11 +153,16 @@ public:
 		bookmarks.clear();
 		pFileWorker = 0;
 		futureDo = fdNone;
+		undoPending = false; //!-add-[PersistentUndo]
+		ResetWordIndex(); //!-add-[AutoCompleteWordIndex]
+		follow = false; //!-add-[TailFollow]
+		followOffset = -1; //!-add-[TailFollow]
 	}
 
 	void SetTimeFromFile() {
 		fileModTime = ModifiedTime();
 		fileModLastAsk = fileModTime;
+		followOffset = -1; //!-add-[TailFollow]
 	}
 //!-start-[OpenNonExistent]
 	bool DocumentNotSaved() const {
@@ -161,6 +178,7 @@ public:
 	}
 
 	void CancelLoad();
+	void ResetWordIndex(); //!-add-[AutoCompleteWordIndex]
 };
 
 struct BackgroundActivities {
@@ -217,6 +235,16 @@ public:
 	SString menuCommand; // the menu command to be passed to "SciTEBase::MenuCommand"
 };
 
+//!-start-[ApiCache]
+/// Api files read before, kept for when a buffer using them is shown again.
+struct ApiCacheEntry {
+	SString fileNames;
+	SString stamps;	///< Modification times and sizes of the files when read
+	size_t size;
+	StringList *list;
+};
+//!-end-[ApiCache]
+
 class LanguageMenuItem {
 public:
 	SString menuItem;
@@ -377,6 +405,16 @@ public:
 	}
 };
 
+//!-start-[ParallelGrep]
+/// Properties used by Find in Files, read on the main thread as the search may run on another.
+struct GrepSettings {
+	int threads;
+	int findListStyle;
+	bool indexing;
+	FilePath indexDirectory;
+};
+//!-end-[ParallelGrep]
+
 class SciTEBase : public ExtensionAPI, public Searcher, public WorkerListener {
 protected:
 	virtual void SetToolBar() = 0;	//!-add-[user.toolbar]
@@ -418,6 +456,11 @@ protected:
 	int lexLPeg;
 	StringList apis;
 	SString apisFileNames;
+//!-start-[ApiCache]
+	SString apisStamps;
+	size_t apisSize;
+	std::vector<ApiCacheEntry> apiCache;	///< Least recently used first
+//!-end-[ApiCache]
 	SString functionDefinition;
 
 	enum { diagnosticStyleStart=256, diagnosticStyleEnd=diagnosticStyleStart+4-1};
@@ -448,6 +491,9 @@ protected:
 	};
 	ScintillaWindowEditor wEditor;
 	friend class ScintillaWindowEditor;
+	friend class GrepPool; //!-add-[ParallelGrep]
+	friend struct GrepIndexWorker; //!-add-[TrigramIndex]
+	friend struct WordIndexWorker; //!-add-[AutoCompleteWordIndex]
 //!-end-[OnSendEditor]
 	GUI::ScintillaWindow wOutput;
 	GUI::Window wIncrement;
@@ -502,6 +548,16 @@ protected:
 	int indentExamine;
 
 	bool autoCompleteIgnoreCase;
+//!-start-[FuzzyAutoComplete]
+	bool autoCompleteFuzzy;
+	int autoCompleteMaxItems;
+	bool autoCFromApis;	///< The list shown came from the api files
+	bool autoCTruncated;	///< The list shown had more names than autoCompleteMaxItems
+//!-end-[FuzzyAutoComplete]
+//!-start-[AutoCompleteWordIndex]
+	bool autoCompleteWordIndex;
+	bool autoCompleteWordAllBuffers;
+//!-end-[AutoCompleteWordIndex]
 	bool callTipAutomatic; //!-add-[BetterCalltips]
 	bool callTipIgnoreCase;
 	int calltipShowPerPage; //!-add-[BetterCalltips]
@@ -537,7 +593,16 @@ protected:
 	bool allowMenuActions;
 	int scrollOutput;
 	bool returnOutputToCommand;
+//!-start-[OutputBatch]
+	int outputMaxSize;
+	int outputRemoved;	///< Bytes removed from the start of the output pane to keep it below outputMaxSize
+	SString outputPending;	///< Tool output gathered but not yet shown
+	GUI::ElapsedTime outputShown;
+//!-end-[OutputBatch]
 	JobQueue jobQueue;
+	PostingWorker *pIndexWorker; //!-add-[TrigramIndex]
+	PostingWorker *pWordIndexWorker; //!-add-[AutoCompleteWordIndex]
+	FileWatcher *pFileWatcher; //!-add-[FileWatcher]
 
 	bool macrosEnabled;
 	SString currentMacro;
@@ -590,7 +655,13 @@ protected:
 	void MoveTabRight();
 	void MoveTabLeft();
 
-	void ReadGlobalPropFile();
+//!	void ReadGlobalPropFile();
+//!-start-[PropsSnapshot]
+	void ReadGlobalPropFile(bool useSnapshot=true);
+	bool ReadPropsSnapshot();
+	void WritePropsSnapshot(const SString &excludes, const SString &includes,
+		const PropsSources &sourcesBase, const PropsSources &sourcesUser);
+//!-end-[PropsSnapshot]
 	void ReadAbbrevPropFile();
 	void ReadLocalPropFile();
 	void ReadDirectoryPropFile();
@@ -603,7 +674,7 @@ protected:
 	int GetCaretInLine();
 	void GetLine(char *text, int sizeText, int line = -1);
 	SString GetLine(int line = -1);
-	void GetRange(GUI::ScintillaWindow &win, int start, int end, char *text);
+	void GetRange(GUI::ScintillaWindow &win, Sci_Position start, Sci_Position end, char *text);
 	int IsLinePreprocessorCondition(char *line);
 	bool FindMatchingPreprocessorCondition(int &curLine, int direction, int condEnd1, int condEnd2);
 	bool FindMatchingPreprocCondPosition(bool isForward, int &mppcAtCaret, int &mppcMatch);
@@ -626,6 +697,11 @@ protected:
 	void RestoreFromSession(const Session &session);
 	void RestoreSession();
 	void SaveSessionFile(const GUI::gui_char *sessionName);
+//!-start-[PersistentUndo]
+	FilePath UndoFileFor(const FilePath &path);
+	void SaveUndoHistory(int index);
+	void RestoreUndoHistory();
+//!-end-[PersistentUndo]
 	virtual void GetWindowPosition(int *left, int *top, int *width, int *height, int *maximize) = 0;
 	void SetIndentSettings();
 	void SetEol();
@@ -637,7 +713,7 @@ protected:
 	void DiscoverEOLSetting();
 	void DiscoverIndentSetting();
 	SString DiscoverLanguage();
-	void OpenFile(long fileSize, bool suppressMessage, bool asynchronous);
+	void OpenFile(Sci_Position fileSize, bool suppressMessage, bool asynchronous);
 	virtual void OpenUriList(const char *) {}
 	virtual bool OpenDialog(FilePath directory, const GUI::gui_char *filter) = 0;
 	virtual bool SaveAsDialog() = 0;
@@ -650,7 +726,8 @@ protected:
 	    ofForceLoad = 2,	// Reload file even if already in a buffer
 	    ofPreserveUndo = 4,	// Do not delete undo history
 	    ofQuiet = 8,		// Avoid "Could not open file" message
-	    ofSynchronous = 16	// Force synchronous read
+	    ofSynchronous = 16,	// Force synchronous read
+	    ofDeferUndo = 32	// Restore saved undo history when the buffer is next shown //!-add-[PersistentUndo]
 	};
 	void TextRead(FileWorker *pFileLoader);
 	void TextWritten(FileWorker *pFileStorer);
@@ -747,8 +824,15 @@ protected:
 	void GoMatchingPreprocCond(int direction, bool select);
 	virtual void FindReplace(bool replace) = 0;
 	void OutputAppendString(const char *s, int len = -1);
-	void OutputAppendStringSynchronised(const char *s, int len = -1);
-	void MakeOutputVisible();
+//!	void OutputAppendStringSynchronised(const char *s, int len = -1);
+	virtual void OutputAppendStringSynchronised(const char *s, int len = -1); //!-change-[ParallelGrep]
+//!-start-[OutputBatch]
+	void OutputLimitSize(bool synchronised);
+	bool OutputAppendBatched(const char *s, int len, bool synchronised);
+	bool OutputFlush(bool synchronised);
+//!-end-[OutputBatch]
+//!	void MakeOutputVisible();
+	virtual void MakeOutputVisible(); //!-change-[ParallelGrep]
 	void ClearJobQueue();
 	virtual void Execute();
 	virtual void StopExecute() = 0;
@@ -763,6 +847,12 @@ protected:
 	virtual void EliminateDuplicateWords(char *words);
 	virtual bool StartAutoComplete();
 	virtual bool StartAutoCompleteWord(bool onlyOneWord);
+//!-start-[AutoCompleteWordIndex]
+	void WordIndexStart();
+	void WordIndexModified(const SCNotification *notification);
+	void WordIndexInvalidateAll();
+	bool ShowWordsFromIndex(const SString &root, const SString &wordCurrent, bool onlyOneWord);
+//!-end-[AutoCompleteWordIndex]
 	virtual bool StartExpandAbbreviation();
 	virtual bool StartInsertAbbreviation();
 	virtual bool InsertAbbreviation(const char* data); //!-add-[InsertAbbreviation]
@@ -802,8 +892,6 @@ protected:
 	void MenuCommand(int cmdID, int source = 0);
 	void FoldChanged(int line, int levelNow, int levelPrev);
 	void FoldChanged(int position);
-	void Expand(int &line, bool doExpand, bool force = false,
-	        int visLevels = 0, int level = -1);
 	void FoldAll();
 	void ToggleFoldRecursive(int line, int level);
 	void EnsureAllChildrenVisible(int line, int level);
@@ -888,6 +976,10 @@ protected:
 	void ForwardPropertyToEditor(const char *key);
 	void DefineMarker(int marker, int markerType, Colour fore, Colour back, Colour backSelected);
 	void ReadAPI(const SString &fileNameForExtension);
+//!-start-[ApiCache]
+	void SwitchAPI(const SString &fileNameForExtension, const SString &fileNames);
+	void ClearApiCache();
+//!-end-[ApiCache]
 	SString FindLanguageProperty(const char *pattern, const char *defaultValue = "");
 	int FindIntLanguageProperty(const char *pattern, int defaultValue = 0); //!-add-[BetterCalltips]
 	virtual void ReadProperties();
@@ -897,6 +989,18 @@ protected:
 	void ReloadProperties();
 
 	void CheckReload();
+//!-start-[FileWatcher]
+	void WatchFiles();
+	/// Watch these directories for changes to the files in them if the platform can.
+	virtual void WatchDirectories(const std::vector<FilePath> &) {}
+	void FilesChanged();
+	void ReloadInBackground(int index, time_t modified, Sci_Position size);
+//!-end-[FileWatcher]
+//!-start-[TailFollow]
+	bool CanFollow();
+	void FollowFile();
+	void FollowChanged(const FileChange &change);
+//!-end-[TailFollow]
 	void Activate(bool activeApp);
 	GUI::Rectangle GetClientRectangle();
 	void Redraw();
@@ -921,10 +1025,15 @@ protected:
 	    grepNone = 0, grepWholeWord = 1, grepMatchCase = 2, grepStdOut = 4,
 	    grepDot = 8, grepBinary = 16, grepScroll = 32
 	};
+	GrepSettings GrepSettingsFromProps(); //!-add-[ParallelGrep]
 	virtual bool GrepIntoDirectory(const FilePath &directory);
 //!	void GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes);
-	void GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes, unsigned int basePath); //!-change-[FindResultListStyle]
-	void InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const GUI::gui_char *files, const char *search);
+	void GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes, unsigned int basePath, const GrepSettings &settings); //!-change-[FindResultListStyle]
+	void GrepOutput(GrepFlags gf, SString &os); //!-add-[ParallelGrep]
+	void GrepIndexStart(Worker *pWorker); //!-add-[TrigramIndex]
+//!	void InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const GUI::gui_char *files, const char *search);
+	void InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const GUI::gui_char *files, const char *search, const GrepSettings &settings); //!-change-[ParallelGrep]
+	void InternalGrepJob(const Job &job, const GrepSettings &settings, bool scroll); //!-add-[ParallelGrep]
 	void EnumProperties(const char *action);
 	void SendOneProperty(const char *kind, const char *key, const char *val);
 	void PropertyFromDirector(const char *arg);
@@ -69,6 +69,7 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "FileWorker.h"
+#include "WordIndex.h" //!-add-[AutoCompleteWordIndex]
 #include "SciTEBase.h"
 
 const GUI::gui_char defaultSessionFileName[] = GUI_TEXT("SciTE.session");
@@ -98,9 +99,20 @@ void Buffer::CancelLoad() {
 	}
 }
 
+//!-start-[AutoCompleteWordIndex]
+void Buffer::ResetWordIndex() {
+	if (wordIndex)
+		wordIndex->Invalidate();
+}
+//!-end-[AutoCompleteWordIndex]
+
 BufferList::BufferList() : current(0), stackcurrent(0), stack(0), buffers(0), size(0), length(0), lengthVisible(0), initialised(false) {}
 
 BufferList::~BufferList() {
+//!-start-[AutoCompleteWordIndex]
+	for (int i = 0; i < size; i++)
+		delete buffers[i].wordIndex;
+//!-end-[AutoCompleteWordIndex]
 	delete []buffers;
 	delete []stack;
 }
@@ -176,11 +188,13 @@ void BufferList::RemoveInvisible(int index) {
 void BufferList::RemoveCurrent() {
 	// Delete and move up to fill gap but ensure doc pointer is saved.
 	sptr_t currentDoc = buffers[current].doc;
+	WordIndex *currentWordIndex = buffers[current].wordIndex; //!-add-[AutoCompleteWordIndex]
 	buffers[current].CompleteLoading();
 	for (int i = current;i < length - 1;i++) {
 		buffers[i] = buffers[i + 1];
 	}
 	buffers[length - 1].doc = currentDoc;
+	buffers[length - 1].wordIndex = currentWordIndex; //!-add-[AutoCompleteWordIndex]
 
 	if (length > 1) {
 		CommitStackSelection();
@@ -425,12 +439,18 @@ void SciTEBase::SetDocumentAt(int index, bool updateStack) {
 	wEditor.Call(SCI_SETDOCPOINTER, 0, GetDocumentAt(buffers.Current()));
 	bool restoreBookmarks = bufferNext.lifeState == Buffer::readAll;
 	PerformDeferredTasks();
+//!-start-[FileWatcher]
+	// Reloading in the background so keep the old text unchanged until replaced
+	if (bufferNext.lifeState == Buffer::reading)
+		wEditor.Call(SCI_SETREADONLY, 1);
+//!-end-[FileWatcher]
 	if (bufferNext.lifeState == Buffer::readAll) {
 		CompleteOpen(ocCompleteSwitch);
 		if (extender)
 			extender->OnOpen(filePath.AsUTF8().c_str());
 	}
 	RestoreState(bufferNext, restoreBookmarks);
+	RestoreUndoHistory(); //!-add-[PersistentUndo]
 
 	TabSelect(index);
 
@@ -451,6 +471,8 @@ void SciTEBase::SetDocumentAt(int index, bool updateStack) {
 	if (extender) {
 		extender->OnSwitchFile(filePath.AsUTF8().c_str());
 	}
+	if (pFileWatcher) //!-add-[FileWatcher]
+		CheckReload(); //!-add-[FileWatcher]
 }
 
 void SciTEBase::UpdateBuffersCurrent() {
@@ -616,6 +638,7 @@ void SciTEBase::RestoreFromSession(const Session &session) {
 	int iBuffer = buffers.GetDocumentByName(session.pathActive);
 	if (iBuffer >= 0)
 		SetDocumentAt(iBuffer);
+	RestoreUndoHistory(); //!-add-[PersistentUndo]
 }
 
 void SciTEBase::RestoreSession() {
@@ -712,6 +735,7 @@ void SciTEBase::SaveSessionFile(const GUI::gui_char *sessionName) {
 		for (int i = 0; i < buffers.lengthVisible; i++) {
 			if (buffers.buffers[i].IsSet() && !buffers.buffers[i].IsUntitled()) {
 				Buffer &buff = buffers.buffers[i];
+				SaveUndoHistory(i); //!-add-[PersistentUndo]
 				SString propKey = IndexPropKey("buffer", i, "path");
 				fprintf(sessionFile, "\n%s=%s\n", propKey.c_str(), buff.AsUTF8().c_str());
 
@@ -766,6 +790,100 @@ void SciTEBase::SaveSessionFile(const GUI::gui_char *sessionName) {
 	props.Set("SessionPath", sessionFilePath.AsUTF8().c_str());
 }
 
+//!-start-[PersistentUndo]
+// A saved undo history starts with a line identifying the format and the file it belongs to,
+// then the size and modification time the file had when the history was saved
+// and the history as written by Scintilla.
+static const char undoFileMagic[] = "SciTE undo 1\n";
+
+FilePath SciTEBase::UndoFileFor(const FilePath &path) {
+	// Hash of the path so that each file has its own history
+	const std::string name = path.AsUTF8();
+	const unsigned int hash = HashText(name.c_str(), name.length());
+	char hashText[20];
+	sprintf(hashText, "%08x", hash);
+	GUI::gui_string fileName = GUI_TEXT("SciTE-");
+	fileName += GUI::StringFromUTF8(hashText);
+	fileName += GUI_TEXT(".undo");
+	SString undoDirectory = props.GetExpanded("undo.persistent.directory");
+	return FilePath(undoDirectory.length() ?
+		FilePath(GUI::StringFromUTF8(undoDirectory.c_str())) : GetSciteUserHome(), FilePath(fileName));
+}
+
+void SciTEBase::SaveUndoHistory(int index) {
+	if ((index < 0) || (index >= buffers.length) || !props.GetInt("undo.persistent"))
+		return;
+	Buffer &buffer = buffers.buffers[index];
+	// A history not yet restored is still in its file and one of a changed buffer
+	// would not match the file when it is next opened
+	if (buffer.IsUntitled() || (buffer.lifeState != Buffer::open) || buffer.pFileWorker ||
+		buffer.undoPending || buffer.DocumentNotSaved())
+		return;
+	time_t modified = 0;
+	Sci_Position size = 0;
+	if (!buffer.Status(modified, size) || (modified != buffer.fileModTime))
+		return;
+	FilePath undoFile = UndoFileFor(buffer);
+	const sptr_t doc = GetDocumentAt(index);
+	const sptr_t lengthHistory = wEditor.Call(SCI_SAVEUNDOHISTORY, doc);
+	if (lengthHistory <= 0) {
+		undoFile.Remove();
+		return;
+	}
+	std::vector<char> history(lengthHistory);
+	wEditor.Call(SCI_SAVEUNDOHISTORY, doc, reinterpret_cast<sptr_t>(&history[0]));
+	FILE *fp = undoFile.Open(fileWrite);
+	if (!fp)
+		return;
+	const std::string path = buffer.AsUTF8();
+	const long long fileSize = size;
+	const long long fileModified = modified;
+	fwrite(undoFileMagic, 1, strlen(undoFileMagic), fp);
+	fwrite(path.c_str(), 1, path.length() + 1, fp);
+	fwrite(&fileSize, sizeof(fileSize), 1, fp);
+	fwrite(&fileModified, sizeof(fileModified), 1, fp);
+	fwrite(&history[0], 1, history.size(), fp);
+	const bool written = !ferror(fp);
+	if ((fclose(fp) != 0) || !written)
+		undoFile.Remove();
+}
+
+void SciTEBase::RestoreUndoHistory() {
+	Buffer *buffer = CurrentBuffer();
+	if (!buffer->undoPending || (buffer->lifeState != Buffer::open) || buffer->pFileWorker)
+		return;
+	buffer->undoPending = false;
+	time_t modified = 0;
+	Sci_Position size = 0;
+	if (buffer->isDirty || !buffer->Status(modified, size) || (modified != buffer->fileModTime))
+		return;
+	FILE *fp = UndoFileFor(*buffer).Open(fileRead);
+	if (!fp)
+		return;
+	std::vector<char> contents;
+	char data[blockSize];
+	size_t lenData;
+	while ((lenData = fread(data, 1, sizeof(data), fp)) > 0)
+		contents.insert(contents.end(), data, data + lenData);
+	fclose(fp);
+
+	const std::string path = buffer->AsUTF8();
+	const size_t lenMagic = strlen(undoFileMagic);
+	const size_t lenHeader = lenMagic + path.length() + 1 + 2 * sizeof(long long);
+	if ((contents.size() <= lenHeader) ||
+		(memcmp(&contents[0], undoFileMagic, lenMagic) != 0) ||
+		(memcmp(&contents[lenMagic], path.c_str(), path.length() + 1) != 0))
+		return;
+	long long fileSize = 0;
+	long long fileModified = 0;
+	memcpy(&fileSize, &contents[lenMagic + path.length() + 1], sizeof(fileSize));
+	memcpy(&fileModified, &contents[lenMagic + path.length() + 1 + sizeof(fileSize)], sizeof(fileModified));
+	if ((fileSize != size) || (fileModified != modified))
+		return;
+	wEditor.Call(SCI_LOADUNDOHISTORY, contents.size() - lenHeader, reinterpret_cast<sptr_t>(&contents[lenHeader]));
+}
+//!-end-[PersistentUndo]
+
 void SciTEBase::SetIndentSettings() {
 	// Get default values
 	int useTabs = props.GetInt("use.tabs", 1);
@@ -880,6 +998,7 @@ void SciTEBase::Close(bool updateUI, bool loadingSession, bool makingRoomForNew)
 	int index = buffers.Current();
 	if (index >= 0) {
 		buffers.buffers[index].CancelLoad();
+		SaveUndoHistory(index); //!-add-[PersistentUndo]
 	}
 
 	if (extender) {
@@ -1177,6 +1296,7 @@ void SciTEBase::SetBuffersMenu() {
 #if defined(GTK)
 	ShowTabBar();
 #endif
+	WatchFiles(); //!-add-[FileWatcher]
 }
 
 void SciTEBase::BuffersMenu() {
@@ -1239,7 +1359,8 @@ bool SciTEBase::AddFileToBuffer(const BufferState &bufferState) {
 	// Return whether file loads successfully
 	bool opened = false;
 	if (bufferState.Exists()) {
-		opened = Open(bufferState, static_cast<OpenFlags>(ofForceLoad));
+//!		opened = Open(bufferState, static_cast<OpenFlags>(ofForceLoad));
+		opened = Open(bufferState, static_cast<OpenFlags>(ofForceLoad | ofDeferUndo)); //!-change-[PersistentUndo]
 		// If forced synchronous should set up position, foldState and bookmarks
 		if (opened) {
 			int iBuffer = buffers.GetDocumentByName(bufferState, false);
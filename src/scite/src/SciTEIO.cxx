@@ -16,6 +16,8 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <deque> //!-add-[ParallelGrep]
+#include <algorithm> //!-add-[FileWatcher]
 
 #if defined(__unix__)
 
@@ -65,6 +67,8 @@
 #include "Cookie.h"
 #include "Worker.h"
 #include "FileWorker.h"
+#include "TrigramIndex.h" //!-add-[TrigramIndex]
+#include "FileWatcher.h" //!-add-[FileWatcher]
 #include "SciTEBase.h"
 #include "Utf8_16.h"
 
@@ -266,7 +270,7 @@ void SciTEBase::DiscoverIndentSetting() {
 	}
 }
 
-void SciTEBase::OpenFile(long fileSize, bool suppressMessage, bool asynchronous) {
+void SciTEBase::OpenFile(Sci_Position fileSize, bool suppressMessage, bool asynchronous) {
 //!-start-[warning.couldnotopenfile.disable]
     if (!suppressMessage && props.GetInt("warning.couldnotopenfile.disable") == 1)
         suppressMessage = true;
@@ -305,8 +309,17 @@ void SciTEBase::OpenFile(long fileSize, bool suppressMessage, bool asynchronous)
 		wEditor.Call(SCI_STYLESETBACK, STYLE_DEFAULT, 0xEEEEEE);
 		wEditor.Call(SCI_SETREADONLY, 1);
 		assert(CurrentBuffer()->pFileWorker == NULL);
-		ILoader *pdocLoad = reinterpret_cast<ILoader *>(wEditor.CallReturnPointer(SCI_CREATELOADER, fileSize + 1000));
-		CurrentBuffer()->pFileWorker = new FileLoader(this, pdocLoad, filePath, fileSize, fp);
+//!		ILoader *pdocLoad = reinterpret_cast<ILoader *>(wEditor.CallReturnPointer(SCI_CREATELOADER, fileSize + 1000));
+//!		CurrentBuffer()->pFileWorker = new FileLoader(this, pdocLoad, filePath, fileSize, fp);
+//!-start-[mapped.open]
+		int mappedSize = props.GetInt("mapped.open.size", -1);
+		const bool mapRead = (mappedSize >= 0) && (fileSize >= mappedSize);
+		// A mapped file needs no storage and if it is copied after all the storage grows
+		ILoader *pdocLoad = reinterpret_cast<ILoader *>(wEditor.CallReturnPointer(SCI_CREATELOADER, mapRead ? 1000 : fileSize + 1000));
+		FileLoader *pFileLoader = new FileLoader(this, pdocLoad, filePath, fileSize, fp);
+		pFileLoader->mapRead = mapRead;
+		CurrentBuffer()->pFileWorker = pFileLoader;
+//!-end-[mapped.open]
 		CurrentBuffer()->pFileWorker->sleepTime = props.GetInt("asynchronous.sleep");
         CurrentBuffer()->pFileWorker->check_utf8 = check_utf8; //!-add-[utf8.auto.check]
 		PerformOnNewThread(CurrentBuffer()->pFileWorker);
@@ -366,6 +379,7 @@ void SciTEBase::TextRead(FileWorker *pFileWorker) {
 			if (extender)
 				extender->OnOpen(buffers.buffers[iBuffer].AsUTF8().c_str());
 			RestoreState(buffers.buffers[iBuffer], true);
+			RestoreUndoHistory(); //!-add-[PersistentUndo]
 			DisplayAround(buffers.buffers[iBuffer]);
 			wEditor.Call(SCI_SCROLLCARET);
 		}
@@ -382,6 +396,8 @@ void SciTEBase::PerformDeferredTasks() {
 
 void SciTEBase::CompleteOpen(OpenCompletion oc) {
 	wEditor.Call(SCI_SETREADONLY, isReadOnly);
+	// Documents loaded in the background are created without the setting
+	wEditor.Call(SCI_SETCHUNKSIZE, props.GetInt("storage.chunk.size")); //!-add-[ChunkedStorage]
 	if (language == "") {
 		SString languageOverride = DiscoverLanguage();
 		if (languageOverride.length()) {
@@ -424,6 +440,7 @@ void SciTEBase::CompleteOpen(OpenCompletion oc) {
 	wEditor.Call(SCI_GOTOPOS, 0);
 
 	CurrentBuffer()->CompleteLoading();
+	FollowFile(); //!-add-[TailFollow]
 
 	Redraw();
 }
@@ -531,7 +548,7 @@ bool SciTEBase::Open(FilePath file, OpenFlags of) {
 		return false;
 	}
 
-	long size = absPath.GetFileLength();
+	Sci_Position size = absPath.GetFileLength();
 	if (size > 0) {
 		// Real file, not empty buffer
 		int maxSize = props.GetInt("max.file.size");
@@ -593,12 +610,19 @@ bool SciTEBase::Open(FilePath file, OpenFlags of) {
 
 		asynchronous = (size > props.GetInt("background.open.size", -1)) && 
 			!(of & (ofPreserveUndo|ofSynchronous));
+//!-start-[mapped.open]
+		// Mapping is only performed by the background loader
+		int mappedSize = props.GetInt("mapped.open.size", -1);
+		if ((mappedSize >= 0) && (size >= mappedSize) && !(of & (ofPreserveUndo|ofSynchronous)))
+			asynchronous = true;
+//!-end-[mapped.open]
 		OpenFile(size, of & ofQuiet, asynchronous);
 
 		if (of & ofPreserveUndo) {
 			wEditor.Call(SCI_ENDUNDOACTION);
 		} else {
 			wEditor.Call(SCI_EMPTYUNDOBUFFER);
+			CurrentBuffer()->undoPending = props.GetInt("undo.persistent") != 0; //!-add-[PersistentUndo]
 		}
 		isReadOnly = props.GetInt("read.only");
 		wEditor.Call(SCI_SETREADONLY, isReadOnly);
@@ -612,6 +636,8 @@ bool SciTEBase::Open(FilePath file, OpenFlags of) {
 	UpdateStatusBar(true);
 	if (extender && !asynchronous)
 		extender->OnOpen(filePath.AsUTF8().c_str());
+	if (!(of & ofDeferUndo)) //!-add-[PersistentUndo]
+		RestoreUndoHistory(); //!-add-[PersistentUndo]
 	return true;
 }
 
@@ -740,9 +766,24 @@ void SciTEBase::Revert() {
 }
 
 void SciTEBase::CheckReload() {
+//!-start-[TailFollow]
+	// A followed buffer is added to as its file grows rather than read again
+	if (CurrentBuffer()->follow) {
+		WatchFiles();
+		if (pFileWatcher)
+			return;
+	}
+//!-end-[TailFollow]
 	if (props.GetInt("load.on.activate")) {
 		// Make a copy of fullPath as otherwise it gets aliased in Open
-		time_t newModTime = filePath.ModifiedTime();
+//!		time_t newModTime = filePath.ModifiedTime();
+//!-start-[FileWatcher]
+		// The watcher has already looked at the file so a slow file system is not waited for
+		time_t newModTime = 0;
+		WatchFiles();
+		if (!pFileWatcher || !pFileWatcher->ModifiedTime(filePath, newModTime))
+			newModTime = filePath.ModifiedTime();
+//!-end-[FileWatcher]
 /*!
 		if ((newModTime != 0) && (newModTime != CurrentBuffer()->fileModTime)) {
 			RecentFile rf = GetFilePosition();
@@ -820,6 +861,172 @@ void SciTEBase::CheckReload() {
 	}
 }
 
+//!-start-[FileWatcher]
+void SciTEBase::WatchFiles() {
+	if (!props.GetInt("files.watch")) {
+		if (pFileWatcher) {
+			pFileWatcher->Cancel();
+			delete pFileWatcher;
+			pFileWatcher = 0;
+			WatchDirectories(std::vector<FilePath>());
+		}
+		return;
+	}
+	if (!pFileWatcher) {
+		pFileWatcher = new FileWatcher(this);
+		if (!PerformOnNewThread(pFileWatcher)) {
+			delete pFileWatcher;
+			pFileWatcher = 0;
+			return;
+		}
+	}
+	pFileWatcher->SetPollInterval(props.GetInt("files.watch.poll", 5));
+	std::vector<FilePath> paths;
+	std::vector<time_t> modifiedBuffers;
+	std::vector<FilePath> directories;
+	for (int i = 0; i < buffers.length; i++) {
+		const Buffer &buffer = buffers.buffers[i];
+		if (buffer.IsUntitled())
+			continue;
+		paths.push_back(buffer);
+		modifiedBuffers.push_back(buffer.fileModTime);
+		FilePath directory = buffer.Directory();
+		if (std::find(directories.begin(), directories.end(), directory) == directories.end())
+			directories.push_back(directory);
+	}
+	pFileWatcher->SetFiles(paths, modifiedBuffers);
+	WatchDirectories(directories);
+	FollowFile(); //!-add-[TailFollow]
+}
+
+void SciTEBase::FilesChanged() {
+	if (!pFileWatcher)
+		return;
+	std::vector<FileChange> changes;
+	pFileWatcher->TakeChanges(changes);
+//!	if (!props.GetInt("load.on.activate"))
+//!		return;
+	const bool reload = props.GetInt("load.on.activate") != 0; //!-change-[TailFollow]
+	// Changes that need a question or lose changes are left until the buffer is
+	// shown or SciTE activated and files kept in undo are reloaded when shown
+	const bool ask = props.GetInt("are.you.sure.on.reload") != 0;
+	const bool preserveUndo = props.GetInt("reload.preserves.undo") != 0;
+	for (size_t i = 0; i < changes.size(); i++) {
+		const int index = buffers.GetDocumentByName(changes[i].path);
+		if (index < 0)
+			continue;
+		Buffer &buffer = buffers.buffers[index];
+//!-start-[TailFollow]
+		if (buffer.follow) {
+			if (index == buffers.Current())
+				FollowChanged(changes[i]);
+			continue;
+		}
+//!-end-[TailFollow]
+//!		if (buffer.pFileWorker || (buffer.lifeState != Buffer::open) || buffer.isDirty || ask ||
+		if (!reload || buffer.pFileWorker || (buffer.lifeState != Buffer::open) || buffer.isDirty || ask || //!-change-[TailFollow]
+			(changes[i].modified == 0) || (changes[i].modified == buffer.fileModTime))
+			continue;
+		if (index == buffers.Current())
+			CheckReload();
+		else if (!preserveUndo)
+			ReloadInBackground(index, changes[i].modified, changes[i].size);
+	}
+}
+
+void SciTEBase::ReloadInBackground(int index, time_t modified, Sci_Position size) {
+	Buffer &buffer = buffers.buffers[index];
+	FILE *fp = buffer.Open(fileRead);
+	if (!fp)
+		return;
+	// The watcher has seen the time so the file is not looked at again
+	buffer.fileModTime = modified;
+	buffer.fileModLastAsk = modified;
+	buffer.lifeState = Buffer::reading;
+	int mappedSize = props.GetInt("mapped.open.size", -1);
+	const bool mapRead = (mappedSize >= 0) && (size >= mappedSize);
+	ILoader *pdocLoad = reinterpret_cast<ILoader *>(wEditor.CallReturnPointer(SCI_CREATELOADER, mapRead ? 1000 : size + 1000));
+	FileLoader *pFileLoader = new FileLoader(this, pdocLoad, buffer, size, fp);
+	pFileLoader->mapRead = mapRead;
+	pFileLoader->sleepTime = props.GetInt("asynchronous.sleep");
+	pFileLoader->check_utf8 = props.GetInt("utf8.auto.check");
+	buffer.pFileWorker = pFileLoader;
+	PerformOnNewThread(pFileLoader);
+}
+//!-end-[FileWatcher]
+
+//!-start-[TailFollow]
+bool SciTEBase::CanFollow() {
+	const Buffer *buffer = CurrentBuffer();
+	return pFileWatcher && !buffer->IsUntitled() && (buffer->lifeState == Buffer::open) &&
+		!buffer->pFileWorker && (buffer->unicodeMode != uni16BE) && (buffer->unicodeMode != uni16LE);
+}
+
+// Have the watcher read what is appended to the file of the current buffer.
+void SciTEBase::FollowFile() {
+	if (!pFileWatcher)
+		return;
+	Buffer *buffer = CurrentBuffer();
+	if (!buffer->follow || !CanFollow()) {
+		pFileWatcher->Follow(FilePath(), 0, false, std::string(), false);
+		return;
+	}
+	const Sci_Position lengthDocument = wEditor.Call(SCI_GETLENGTH);
+	// The start of the document shows whether the file was replaced by another
+	char head[65];
+	const Sci_Position lengthHead = (lengthDocument < 64) ? lengthDocument : 64;
+	GetRange(wEditor, 0, lengthHead, head);
+	const bool starting = buffer->followOffset < 0;
+	pFileWatcher->Follow(*buffer, starting ? lengthDocument : buffer->followOffset, starting,
+		std::string(head, lengthHead), buffer->unicodeMode == uniUTF8);
+}
+
+void SciTEBase::FollowChanged(const FileChange &change) {
+	if (!CanFollow())
+		return;
+	Buffer *buffer = CurrentBuffer();
+	if (change.restarted) {
+		if (buffer->isDirty) {
+			// Reading the file again would lose the changes so stop following
+			buffer->follow = false;
+			FollowFile();
+			CheckMenus();
+			return;
+		}
+		// Replaced or shortened so read it all and follow from its new end
+		OpenFlags of = props.GetInt("reload.preserves.undo") ? ofPreserveUndo : ofNone;
+		Open(filePath, static_cast<OpenFlags>(of | ofForceLoad));
+		if (props.GetInt("follow.pin.end", 1))
+			wEditor.Call(SCI_DOCUMENTEND);
+		return;
+	}
+	if ((buffer->followOffset >= 0) && (change.offset != buffer->followOffset)) {
+		// Read for the document before it was read or saved again
+		FollowFile();
+		return;
+	}
+	const Sci_Position lengthDocument = wEditor.Call(SCI_GETLENGTH);
+	const bool atEnd = wEditor.Call(SCI_GETCURRENTPOS) == lengthDocument;
+	const bool clean = !buffer->isDirty;
+	// Added without undo as the file can not have the addition undone
+	const int readOnly = wEditor.Call(SCI_GETREADONLY);
+	const int undoCollection = wEditor.Call(SCI_GETUNDOCOLLECTION);
+	wEditor.Call(SCI_SETREADONLY, 0);
+	wEditor.Call(SCI_SETUNDOCOLLECTION, 0);
+	wEditor.CallString(SCI_APPENDTEXT, change.tail.length(), change.tail.c_str());
+	wEditor.Call(SCI_SETUNDOCOLLECTION, undoCollection);
+	wEditor.Call(SCI_SETREADONLY, readOnly);
+	if (clean)
+		wEditor.Call(SCI_SETSAVEPOINT);
+	buffer->followOffset = change.offset + static_cast<Sci_Position>(change.tail.length());
+	buffer->fileModTime = change.modified;
+	buffer->fileModLastAsk = change.modified;
+	// Only the new lines are styled, when shown, as styling before the end is kept
+	if (atEnd && props.GetInt("follow.pin.end", 1))
+		wEditor.Call(SCI_GOTOPOS, wEditor.Call(SCI_GETLENGTH));
+}
+//!-end-[TailFollow]
+
 void SciTEBase::Activate(bool activeApp) {
 	if (activeApp) {
 		CheckReload();
@@ -994,9 +1201,11 @@ bool SciTEBase::SaveBuffer(FilePath saveName, bool asynchronous) {
 
 	if (!retVal) {
 
+		// Copy a memory mapped document into memory before its file is overwritten
+		wEditor.CallReturnPointer(SCI_GETCHARACTERPOINTER); //!-add-[mapped.open]
 		FILE *fp = saveName.Open(fileWrite);
 		if (fp) {
-			int lengthDoc = LengthDocument();
+			Sci_Position lengthDoc = wEditor.Send(SCI_GETLENGTH);
 			if (asynchronous) {
 				wEditor.Call(SCI_SETREADONLY, 1);
 				const char *documentBytes = reinterpret_cast<const char *>(wEditor.CallReturnPointer(SCI_GETCHARACTERPOINTER));
@@ -1014,12 +1223,12 @@ bool SciTEBase::SaveBuffer(FilePath saveName, bool asynchronous) {
 				char data[blockSize + 1];
 				retVal = true;
 				int grabSize;
-				for (int i = 0; i < lengthDoc; i += grabSize) {
-					grabSize = lengthDoc - i;
-					if (grabSize > blockSize)
-						grabSize = blockSize;
+				for (Sci_Position i = 0; i < lengthDoc; i += grabSize) {
+					grabSize = blockSize;
+					if (lengthDoc - i < blockSize)
+						grabSize = static_cast<int>(lengthDoc - i);
 					// Round down so only whole characters retrieved.
-					grabSize = wEditor.Call(SCI_POSITIONBEFORE, i + grabSize + 1) - i;
+					grabSize = static_cast<int>(wEditor.Send(SCI_POSITIONBEFORE, i + grabSize + 1) - i);
 					GetRange(wEditor, i, i + grabSize, data);
 					size_t written = convert.fwrite(data, grabSize);
 					if (written == 0) {
@@ -1040,7 +1249,8 @@ bool SciTEBase::SaveBuffer(FilePath saveName, bool asynchronous) {
 }
 
 void SciTEBase::ReloadProperties() {
-	ReadGlobalPropFile();
+//!	ReadGlobalPropFile();
+	ReadGlobalPropFile(false); //!-change-[PropsSnapshot]
 	SetImportMenu();
 	ReadLocalPropFile();
 	ReadAbbrevPropFile();
@@ -1394,86 +1604,442 @@ bool SciTEBase::GrepIntoDirectory(const FilePath &directory) {
     return sDirectory[0] != '.';
 }
 
-//!void SciTEBase::GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes) {
-void SciTEBase::GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes, unsigned int basePath) { //!-change-[FindResultListStyle]
+//!-start-[ParallelGrep]
+static int ProcessorCount() {
+#if defined(__unix__)
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (count > 0) ? static_cast<int>(count) : 1;
+#else
+	SYSTEM_INFO si;
+	::GetSystemInfo(&si);
+	return static_cast<int>(si.dwNumberOfProcessors);
+#endif
+}
+
+// Wait a moment for another thread to produce work
+static void GrepIdle() {
+#if defined(__unix__)
+	usleep(1000);
+#else
+	::Sleep(1);
+#endif
+}
+
+/// A file or directory to be searched by Find in Files.
+/// The children of a directory are its matching files followed by the directories
+/// to search, in the order they were listed, which is the order of the output.
+struct GrepItem {
+	FilePath path;
+	bool directory;
+	bool done;	///< Guarded by the pool as it is set and read on different threads
+	SString result;
+	std::vector<GrepItem *> children;
+
+	GrepItem(const FilePath &path_, bool directory_) : path(path_), directory(directory_), done(false) {
+	}
+	~GrepItem() {
+		DeleteChildren();
+	}
+	void DeleteChildren() {
+		for (size_t i = 0; i < children.size(); i++) {
+			delete children[i];
+		}
+		children.clear();
+	}
+};
+
+/// Work shared by the threads of a Find in Files search.
+/// Each thread has its own deque of items: it takes the item it added most recently
+/// and, when that is empty, steals the oldest item of another thread. So idle threads
+/// pick up whole subtrees while busy threads stay close to where output is being written.
+/// Listing a directory, reading its files and matching all run on whichever thread is free.
+class GrepPool {
+	SciTEBase *pSciTE;
+	SciTEBase::GrepFlags gf;
+	const char *searchString;
+	size_t searchLength;
+	const GUI::gui_char *fileTypes;
+	unsigned int basePath;
+	int listStyle;
+	const TrigramIndex *index;	///< Files that can be skipped, may be NULL
+	std::vector<std::deque<GrepItem *> > queues;
+	std::vector<Mutex *> mutexQueues;
+	Mutex *mutexDone;
+	volatile bool finished;
+	volatile bool cancelled;
+	volatile bool stale;
+
+	// Private so GrepPool objects can not be copied
+	GrepPool(const GrepPool &);
+	void operator=(const GrepPool &);
+
+	void ListDirectory(int thread, GrepItem *item);
+	void SearchFile(GrepItem *item);
+public:
+	GrepPool(SciTEBase *pSciTE_, int threads, SciTEBase::GrepFlags gf_, const char *searchString_,
+		const GUI::gui_char *fileTypes_, unsigned int basePath_, int listStyle_, const TrigramIndex *index_);
+	~GrepPool();
+	void Push(int thread, GrepItem *item);
+	bool Take(int thread, GrepItem *&item);
+	void Process(int thread, GrepItem *item);
+	bool Done(GrepItem *item);
+	/// Process one item if there is one available.
+	void Help(int thread);
+	/// Loop of the worker threads until Finish is called.
+	void Run(int thread);
+	void Finish() {
+		finished = true;
+	}
+	void Cancel() {
+		cancelled = true;
+	}
+	/// Whether a file was searched that is missing from the index or has changed.
+	bool Stale() const {
+		return stale;
+	}
+};
+
+GrepPool::GrepPool(SciTEBase *pSciTE_, int threads, SciTEBase::GrepFlags gf_, const char *searchString_,
+	const GUI::gui_char *fileTypes_, unsigned int basePath_, int listStyle_, const TrigramIndex *index_) :
+	pSciTE(pSciTE_), gf(gf_), searchString(searchString_), searchLength(strlen(searchString_)),
+	fileTypes(fileTypes_), basePath(basePath_), listStyle(listStyle_), index(index_),
+	queues(threads), mutexQueues(threads), finished(false), cancelled(false), stale(false) {
+	for (int thread = 0; thread < threads; thread++) {
+		mutexQueues[thread] = Mutex::Create();
+	}
+	mutexDone = Mutex::Create();
+}
+
+GrepPool::~GrepPool() {
+	for (size_t thread = 0; thread < mutexQueues.size(); thread++) {
+		delete mutexQueues[thread];
+	}
+	delete mutexDone;
+}
+
+void GrepPool::Push(int thread, GrepItem *item) {
+	Lock lock(mutexQueues[thread]);
+	queues[thread].push_back(item);
+}
+
+bool GrepPool::Take(int thread, GrepItem *&item) {
+	{
+		Lock lock(mutexQueues[thread]);
+		if (!queues[thread].empty()) {
+			item = queues[thread].back();
+			queues[thread].pop_back();
+			return true;
+		}
+	}
+	const size_t threads = queues.size();
+	for (size_t i = 1; i < threads; i++) {
+		const size_t victim = (thread + i) % threads;
+		Lock lock(mutexQueues[victim]);
+		if (!queues[victim].empty()) {
+			item = queues[victim].front();
+			queues[victim].pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void GrepPool::ListDirectory(int thread, GrepItem *item) {
 	FilePathSet directories;
 	FilePathSet files;
-	baseDir.List(directories, files);
-	size_t searchLength = strlen(searchString);
-	SString os;
-	for (size_t i = 0; i < files.size(); i ++) {
-		if (jobQueue.Cancelled())
+	item->path.List(directories, files);
+	for (size_t i = 0; i < files.size(); i++) {
+		if (files[i].Matches(fileTypes))
+			item->children.push_back(new GrepItem(files[i], false));
+	}
+	for (size_t j = 0; j < directories.size(); j++) {
+		if ((gf & SciTEBase::grepDot) || pSciTE->GrepIntoDirectory(directories[j].Name()))
+			item->children.push_back(new GrepItem(directories[j], true));
+	}
+	// Last child first so this thread goes on with the first one
+	for (size_t k = item->children.size(); k > 0; k--) {
+		Push(thread, item->children[k - 1]);
+	}
+}
+
+void GrepPool::SearchFile(GrepItem *item) {
+//!-start-[TrigramIndex]
+	if (index) {
+		const TrigramIndex::FileState state = index->Check(item->path, (gf & SciTEBase::grepBinary) != 0);
+		if (state == TrigramIndex::fileSkip)
 			return;
-		FilePath fPath = files[i];
-		if (fPath.Matches(fileTypes)) {
-			//OutputAppendStringSynchronised(i->AsInternal());
-			//OutputAppendStringSynchronised("\n");
-			FileReader fr(fPath, gf & grepMatchCase);
-			if ((gf & grepBinary) || !fr.BufferContainsNull()) {
-				while (char *line = fr.Next()) {
-					char *match = strstr(line, searchString);
-					if (match) {
-						if (gf & grepWholeWord) {
-							char *lineEnd = line + strlen(line);
-							while (match) {
-								if (((match == line) || !IsWordCharacter(match[-1])) &&
-								        ((match + searchLength == (lineEnd)) || !IsWordCharacter(match[searchLength]))) {
-									break;
-								}
-								match = strstr(match + 1, searchString);
-							}
+		if (state == TrigramIndex::fileUnknown)
+			stale = true;
+	}
+//!-end-[TrigramIndex]
+	SString &os = item->result;
+	FileReader fr(item->path, (gf & SciTEBase::grepMatchCase) != 0);
+	if ((gf & SciTEBase::grepBinary) || !fr.BufferContainsNull()) {
+		while (char *line = fr.Next()) {
+			if (cancelled)
+				return;
+			char *match = strstr(line, searchString);
+			if (match) {
+				if (gf & SciTEBase::grepWholeWord) {
+					char *lineEnd = line + strlen(line);
+					while (match) {
+						if (((match == line) || !IsWordCharacter(match[-1])) &&
+						        ((match + searchLength == (lineEnd)) || !IsWordCharacter(match[searchLength]))) {
+							break;
 						}
-						if (match) {
+						match = strstr(match + 1, searchString);
+					}
+				}
+				if (match) {
 //!-start-[FindResultListStyle]
-							if (props.GetInt("lexer.errorlist.findliststyle", 1)) {
+					if (listStyle) {
 #if !defined(GTK)
-								os.append(".");
+						os.append(".");
 #endif
-								os.append(fPath.AsUTF8().c_str() + basePath);
-							}
-							else
+						os.append(item->path.AsUTF8().c_str() + basePath);
+					}
+					else
 //!-end-[FindResultListStyle]
-							os.append(fPath.AsUTF8().c_str());
-							os.append(":");
-							SString lNumber(fr.LineNumber());
-							os.append(lNumber.c_str());
-							os.append(":");
+					os.append(item->path.AsUTF8().c_str());
+					os.append(":");
+					SString lNumber(fr.LineNumber());
+					os.append(lNumber.c_str());
+					os.append(":");
 //!-start-[FindResultListStyle]
-							if (props.GetInt("lexer.errorlist.findliststyle", 1) == 1) {
-								lNumber = fr.Original();
-								lNumber.substitute('\t',' ');
-								lNumber.trimleft("\n\r ");
-								lNumber.insert(0," ",1);
-								while ( lNumber.substitute("  "," ") );
-								os.append(lNumber.c_str());
-							}
-							else
-//!-end-[FindResultListStyle]
-							os.append(fr.Original());
-							os.append("\n");
-						}
+					if (listStyle == 1) {
+						lNumber = fr.Original();
+						lNumber.substitute('\t',' ');
+						lNumber.trimleft("\n\r ");
+						lNumber.insert(0," ",1);
+						while ( lNumber.substitute("  "," ") );
+						os.append(lNumber.c_str());
 					}
+					else
+//!-end-[FindResultListStyle]
+					os.append(fr.Original());
+					os.append("\n");
 				}
 			}
 		}
 	}
+}
+
+void GrepPool::Process(int thread, GrepItem *item) {
+	if (!cancelled) {
+		if (item->directory)
+			ListDirectory(thread, item);
+		else
+			SearchFile(item);
+	}
+	Lock lock(mutexDone);
+	item->done = true;
+}
+
+bool GrepPool::Done(GrepItem *item) {
+	Lock lock(mutexDone);
+	return item->done;
+}
+
+void GrepPool::Help(int thread) {
+	GrepItem *item = 0;
+	if (Take(thread, item))
+		Process(thread, item);
+	else
+		GrepIdle();
+}
+
+void GrepPool::Run(int thread) {
+	while (!finished) {
+		Help(thread);
+	}
+}
+
+struct GrepWorker : public Worker {
+	GrepPool *pool;
+	int thread;
+	GrepWorker(GrepPool *pool_, int thread_) : pool(pool_), thread(thread_) {
+	}
+	virtual void Execute() {
+		pool->Run(thread);
+		completed = true;
+	}
+};
+
+// Output is written in pieces of about this size so results appear as they are found
+static const size_t grepBatchSize = 64 * 1024;
+
+struct GrepFrame {
+	GrepItem *directory;
+	size_t next;
+	GrepFrame(GrepItem *directory_) : directory(directory_), next(0) {
+	}
+};
+//!-end-[ParallelGrep]
+
+void SciTEBase::GrepOutput(GrepFlags gf, SString &os) {
 	if (os.length()) {
 		if (gf & grepStdOut) {
 			fwrite(os.c_str(), os.length(), 1, stdout);
 		} else {
 			OutputAppendStringSynchronised(os.c_str());
 		}
+		os.clear();
 	}
-	for (size_t j = 0; j < directories.size(); j++) {
-		FilePath fPath = directories[j];
-		if ((gf & grepDot) || GrepIntoDirectory(fPath.Name())) {
-//!			GrepRecursive(gf, fPath, searchString, fileTypes);
-			GrepRecursive(gf, fPath, searchString, fileTypes, basePath); //!-change-[FindResultListStyle]
+}
+
+//!-start-[TrigramIndex]
+// Deeper directories are not indexed as they are most likely a loop of links
+static const int maxIndexDepth = 64;
+
+/// Brings the trigram index of a directory up to date on its own thread.
+struct GrepIndexWorker : public PostingWorker {
+	WorkerListener *pListener;
+	SciTEBase *pSciTE;
+	FilePath indexFile;
+	FilePath root;
+	long long sizeLimit;	///< Set by GrepIndexStart on the main thread
+
+	GrepIndexWorker(SciTEBase *pSciTE_, FilePath indexFile_, FilePath root_) :
+		pListener(pSciTE_), pSciTE(pSciTE_), indexFile(indexFile_), root(root_), sizeLimit(0) {
+	}
+	void Collect(FilePath directory, FilePathSet &paths, int depth) {
+		FilePathSet directories;
+		FilePathSet files;
+		directory.List(directories, files);
+		paths.insert(paths.end(), files.begin(), files.end());
+		for (size_t i = 0; (i < directories.size()) && !cancelling; i++) {
+			if ((depth < maxIndexDepth) && pSciTE->GrepIntoDirectory(directories[i].Name()))
+				Collect(directories[i], paths, depth + 1);
+		}
+	}
+	virtual void Execute() {
+		FilePathSet paths;
+		Collect(root, paths, 0);
+		if (!cancelling)
+			TrigramIndex::Update(indexFile, root, paths, sizeLimit, &cancelling);
+		PostFinished(pListener, WORK_GREPINDEXED);
+	}
+};
+//!-end-[TrigramIndex]
+
+//!-start-[ParallelGrep]
+GrepSettings SciTEBase::GrepSettingsFromProps() {
+	GrepSettings settings;
+	settings.threads = props.GetInt("find.in.files.threads");
+	if (settings.threads <= 0)
+		settings.threads = ProcessorCount();
+	settings.findListStyle = props.GetInt("lexer.errorlist.findliststyle", 1);
+	settings.indexing = props.GetInt("find.in.files.index") != 0;
+	SString indexDirectory = props.GetExpanded("find.in.files.index.directory");
+	settings.indexDirectory = indexDirectory.length() ?
+		FilePath(GUI::StringFromUTF8(indexDirectory.c_str())) : GetSciteUserHome();
+	return settings;
+}
+//!-end-[ParallelGrep]
+
+//!void SciTEBase::GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes) {
+void SciTEBase::GrepRecursive(GrepFlags gf, FilePath baseDir, const char *searchString, const GUI::gui_char *fileTypes, unsigned int basePath, const GrepSettings &settings) { //!-change-[FindResultListStyle]
+//!-start-[ParallelGrep]
+	// May run on another thread so only uses settings read before it started
+	const int threads = settings.threads;
+//!-start-[TrigramIndex]
+	const bool indexing = settings.indexing;
+	FilePath indexFile;
+	TrigramIndex index;
+	bool indexed = false;
+	if (indexing) {
+		indexFile = TrigramIndex::IndexFileFor(settings.indexDirectory, baseDir);
+		indexed = index.Load(indexFile, baseDir);
+		if (indexed)
+			index.Query(searchString);
+	}
+//!-end-[TrigramIndex]
+	GrepPool pool(this, threads, gf, searchString, fileTypes, basePath,
+		settings.findListStyle, indexed ? &index : NULL);
+	std::vector<GrepWorker *> workers;
+	for (int thread = 1; thread < threads; thread++) {
+		GrepWorker *pWorker = new GrepWorker(&pool, thread);
+		if (PerformOnNewThread(pWorker))
+			workers.push_back(pWorker);
+		else
+			delete pWorker;
+	}
+
+	// This thread writes the results in the order of a depth first walk of the tree,
+	// searching files itself while it waits for the item that is next.
+	GrepItem root(baseDir, true);
+	pool.Push(0, &root);
+	std::vector<GrepFrame> frames;
+	frames.push_back(GrepFrame(&root));
+	GrepItem *waitFor = &root;
+	SString os;
+	while (waitFor) {
+		if (!pool.Done(waitFor)) {
+			GrepOutput(gf, os);
+			while (!pool.Done(waitFor) && !jobQueue.Cancelled()) {
+				pool.Help(0);
+			}
+		}
+		if (jobQueue.Cancelled()) {
+			pool.Cancel();
+			break;
 		}
+		if (!waitFor->directory) {
+			os.append(waitFor->result.c_str(), waitFor->result.length());
+			waitFor->result = SString();
+			if (os.length() >= grepBatchSize)
+				GrepOutput(gf, os);
+		}
+		waitFor = 0;
+		while (!frames.empty() && !waitFor) {
+			GrepFrame &frame = frames.back();
+			if (frame.next < frame.directory->children.size()) {
+				waitFor = frame.directory->children[frame.next++];
+				if (waitFor->directory)
+					frames.push_back(GrepFrame(waitFor));
+			} else {
+				// Everything below has been written so can be released
+				frame.directory->DeleteChildren();
+				frames.pop_back();
+			}
+		}
+	}
+	GrepOutput(gf, os);
+
+	pool.Finish();
+	for (size_t i = 0; i < workers.size(); i++) {
+		while (!workers[i]->FinishedJob())
+			GrepIdle();
+		delete workers[i];
 	}
+//!-end-[ParallelGrep]
+//!-start-[TrigramIndex]
+	// Started by the main thread which owns pIndexWorker
+	if (indexing && (!indexed || pool.Stale()) && !jobQueue.Cancelled())
+		PostOnMainThread(WORK_GREPINDEXSTART, new GrepIndexWorker(this, indexFile, baseDir));
+//!-end-[TrigramIndex]
 }
 
-void SciTEBase::InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const GUI::gui_char *fileTypes, const char *search) {
+//!-start-[TrigramIndex]
+void SciTEBase::GrepIndexStart(Worker *pPosted) {
+	GrepIndexWorker *pWorker = static_cast<GrepIndexWorker *>(pPosted);
+	// Only one index is built at a time
+	if (pIndexWorker) {
+		delete pWorker;
+		return;
+	}
+	pWorker->sizeLimit = props.GetInt("find.in.files.index.size", 64);
+	pWorker->sizeLimit *= 1024 * 1024;
+	pIndexWorker = pWorker;
+	if (!PerformOnNewThread(pWorker)) {
+		pIndexWorker = 0;
+		delete pWorker;
+	}
+}
+//!-end-[TrigramIndex]
+
+//!void SciTEBase::InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const GUI::gui_char *fileTypes, const char *search) {
+void SciTEBase::InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const GUI::gui_char *fileTypes, const char *search, const GrepSettings &settings) { //!-change-[ParallelGrep]
 	sptr_t originalEnd = 0;
 	GUI::ElapsedTime commandTime;
 	unsigned int basePathLen = 0; //!-add-[FindResultListStyle]
@@ -1483,7 +2049,7 @@ void SciTEBase::InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const
 		os.append(search);
 		os.append("\" in \"");
 //!-start-[FindResultListStyle]
-		if (props.GetInt("lexer.errorlist.findliststyle", 1)) {
+		if (settings.findListStyle) { //!-change-[ParallelGrep]
 			std::string dir = GUI::UTF8FromString(directory);
 			basePathLen = dir.length();
 			os.append(dir.c_str());
@@ -1498,14 +2064,20 @@ void SciTEBase::InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const
 		os.append("\"\n");
 		OutputAppendStringSynchronised(os.c_str());
 		MakeOutputVisible();
-		originalEnd = wOutput.Send(SCI_GETCURRENTPOS);
+//!		originalEnd = wOutput.Send(SCI_GETCURRENTPOS);
+//!-start-[ParallelGrep]
+		// Without scrolling the output is only touched by the calls above which a
+		// platform may synchronise when searching on another thread
+		if (gf & grepScroll)
+			originalEnd = wOutput.Send(SCI_GETCURRENTPOS);
+//!-end-[ParallelGrep]
 	}
 	SString searchString(search);
 	if (!(gf & grepMatchCase)) {
 		searchString.lowercase();
 	}
 //!	GrepRecursive(gf, FilePath(directory), searchString.c_str(), fileTypes);
-	GrepRecursive(gf, FilePath(directory), searchString.c_str(), fileTypes, basePathLen); //!-change-[FindResultListStyle]
+	GrepRecursive(gf, FilePath(directory), searchString.c_str(), fileTypes, basePathLen, settings); //!-change-[FindResultListStyle]
 	if (!(gf & grepStdOut)) {
 		SString sExitMessage(">");
 		if (jobQueue.TimeCommands()) {
@@ -1519,3 +2091,29 @@ void SciTEBase::InternalGrep(GrepFlags gf, const GUI::gui_char *directory, const
 	}
 }
 
+//!-start-[ParallelGrep]
+void SciTEBase::InternalGrepJob(const Job &job, const GrepSettings &settings, bool scroll) {
+	// job.command is "(w|~)(c|~)(d|~)(b|~)\0files\0text"
+	const char *grepCmd = job.command.c_str();
+	if (*grepCmd) {
+		GrepFlags gf = grepNone;
+		if (*grepCmd == 'w')
+			gf = static_cast<GrepFlags>(gf | grepWholeWord);
+		grepCmd++;
+		if (*grepCmd == 'c')
+			gf = static_cast<GrepFlags>(gf | grepMatchCase);
+		grepCmd++;
+		if (*grepCmd == 'd')
+			gf = static_cast<GrepFlags>(gf | grepDot);
+		grepCmd++;
+		if (*grepCmd == 'b')
+			gf = static_cast<GrepFlags>(gf | grepBinary);
+		const char *findFiles = grepCmd + 2;
+		const char *findWhat = findFiles + strlen(findFiles) + 1;
+		if (scroll)
+			gf = static_cast<GrepFlags>(gf | grepScroll);
+		InternalGrep(gf, job.directory.AsInternal(), GUI::StringFromUTF8(findFiles).c_str(), findWhat, settings);
+	}
+}
+//!-end-[ParallelGrep]
+
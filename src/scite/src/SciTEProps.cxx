@@ -12,6 +12,7 @@
 #include <fcntl.h>
 #include <time.h>
 #include <locale.h>
+#include <sys/stat.h> //!-add-[ApiCache]
 
 #include <string>
 #include <vector>
@@ -67,6 +68,7 @@ const GUI::gui_char menuAccessIndicator[] = GUI_TEXT("&");
 #include "JobQueue.h"
 #include "Cookie.h"
 #include "Worker.h"
+#include "FileWorker.h" //!-add-[PropsSnapshot]
 #include "SciTEBase.h"
 
 void SciTEBase::SetImportMenu() {
@@ -117,11 +119,103 @@ void SciTEBase::SetLanguageMenu() {
 
 const GUI::gui_char propLocalFileName[] = GUI_TEXT("SciTE.properties");
 const GUI::gui_char propDirectoryFileName[] = GUI_TEXT("SciTEDirectory.properties");
+//!-start-[PropsSnapshot]
+const GUI::gui_char propSnapshotFileName[] = GUI_TEXT("SciTE.propsnapshot");
+static const char propSnapshotMagic[] = "SciTE properties 2\n";
+
+/**
+Use the global and user properties kept in the snapshot written when they were last
+read if none of the files they came from have changed since.
+*/
+bool SciTEBase::ReadPropsSnapshot() {
+	const FilePath snapshotFile = UserFilePath(propSnapshotFileName);
+	time_t written = 0;
+	Sci_Position sizeSnapshot = 0;
+	if (!snapshotFile.Status(written, sizeSnapshot))
+		return false;
+	MappedFile *mf = MappedFile::Open(snapshotFile);
+	if (!mf)
+		return false;
+	const char *data = mf->Data();
+	const size_t lenMagic = strlen(propSnapshotMagic);
+	unsigned int checksum = 0;
+	size_t length = static_cast<size_t>(mf->Length());
+	bool valid = (length > lenMagic + sizeof(checksum)) &&
+		(memcmp(data, propSnapshotMagic, lenMagic) == 0);
+	if (valid) {
+		length -= sizeof(checksum);
+		memcpy(&checksum, data + length, sizeof(checksum));
+		valid = checksum == HashText(data, length);
+	}
+	const char *end = data + length;
+	data += lenMagic;
+	std::string pathBase;
+	std::string pathUser;
+	std::string excludes;
+	std::string includes;
+	PropsSources sources;
+	valid = valid && ReadString(data, end, pathBase) && ReadString(data, end, pathUser) &&
+		(pathBase == GetDefaultPropertiesFileName().AsUTF8()) &&
+		(pathUser == GetUserPropertiesFileName().AsUTF8()) &&
+		ReadString(data, end, excludes) && ReadString(data, end, includes) &&
+		sources.ReadFrom(data, end) && sources.Current(propsBase.superPS, written) &&
+		propsBase.ReadFrom(data, end) &&
+		sources.ReadFrom(data, end) && sources.Current(propsUser.superPS, written) &&
+		propsUser.ReadFrom(data, end);
+	std::vector<FilePath> imports;
+	std::string import;
+	while (valid && (data < end)) {
+		valid = ReadString(data, end, import);
+		imports.push_back(FilePath(GUI::StringFromUTF8(import.c_str())));
+	}
+	mf->Release();
+	// The files set the import filter they were read with
+	if (!valid || (props.Get("imports.exclude") != excludes.c_str()) ||
+		(props.Get("imports.include") != includes.c_str()))
+		return false;
+	filter.SetFilter(excludes, includes);
+	importFiles = imports;
+	return true;
+}
+
+void SciTEBase::WritePropsSnapshot(const SString &excludes, const SString &includes,
+	const PropsSources &sourcesBase, const PropsSources &sourcesUser) {
+	FilePath snapshotFile = UserFilePath(propSnapshotFileName);
+	if (!props.GetInt("properties.snapshot", 1)) {
+		snapshotFile.Remove();
+		return;
+	}
+	std::string data(propSnapshotMagic);
+	AppendString(data, GetDefaultPropertiesFileName().AsUTF8());
+	AppendString(data, GetUserPropertiesFileName().AsUTF8());
+	AppendString(data, excludes.c_str());
+	AppendString(data, includes.c_str());
+	sourcesBase.AppendTo(data);
+	propsBase.AppendTo(data);
+	sourcesUser.AppendTo(data);
+	propsUser.AppendTo(data);
+	for (size_t i = 0; i < importFiles.size(); i++)
+		AppendString(data, importFiles[i].AsUTF8());
+	const unsigned int checksum = HashText(data.c_str(), data.length());
+	data.append(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+	// Replace the snapshot in one step as another instance may have it mapped
+	const FilePath fileNew(GUI::gui_string(snapshotFile.AsInternal()) + GUI_TEXT(".new"));
+	FILE *fp = fileNew.Open(fileWrite);
+	if (!fp)
+		return;
+	fwrite(data.c_str(), 1, data.length(), fp);
+	const bool written = !ferror(fp);
+	if ((fclose(fp) != 0) || !written || !fileNew.Rename(snapshotFile))
+		fileNew.Remove();
+}
+//!-end-[PropsSnapshot]
 
 /**
 Read global and user properties files.
+The snapshot is not used when reloading as a file saved just now may have the same time.
 */
-void SciTEBase::ReadGlobalPropFile() {
+//!void SciTEBase::ReadGlobalPropFile() {
+void SciTEBase::ReadGlobalPropFile(bool useSnapshot) { //!-change-[PropsSnapshot]
 #if defined(__unix__)
 	extern char **environ;
 	char **e=environ;
@@ -145,6 +239,16 @@ void SciTEBase::ReadGlobalPropFile() {
 	homepath = GetSciteUserHome();
 	props.Set("SciteUserHome", homepath.AsUTF8().c_str());
 //!-end-[scite.userhome]
+//!-start-[PropsSnapshot]
+	if (useSnapshot && ReadPropsSnapshot()) {
+		if (!localiser.read) {
+			ReadLocalization();
+		}
+		return;
+	}
+	PropsSources sourcesBase;
+	PropsSources sourcesUser;
+//!-end-[PropsSnapshot]
 	SString excludes;
 	SString includes;
 
@@ -164,12 +268,24 @@ void SciTEBase::ReadGlobalPropFile() {
 
 		propsBase.Clear();
 		FilePath propfileBase = GetDefaultPropertiesFileName();
+//!		propsBase.Read(propfileBase, propfileBase.Directory(), filter, &importFiles);
+//!-start-[PropsSnapshot]
+		sourcesBase = PropsSources();
+		PropSetFile::sourcesRead = &sourcesBase;
 		propsBase.Read(propfileBase, propfileBase.Directory(), filter, &importFiles);
+//!-end-[PropsSnapshot]
 
 		propsUser.Clear();
 		FilePath propfileUser = GetUserPropertiesFileName();
+//!		propsUser.Read(propfileUser, propfileUser.Directory(), filter, &importFiles);
+//!-start-[PropsSnapshot]
+		sourcesUser = PropsSources();
+		PropSetFile::sourcesRead = &sourcesUser;
 		propsUser.Read(propfileUser, propfileUser.Directory(), filter, &importFiles);
+		PropSetFile::sourcesRead = 0;
+//!-end-[PropsSnapshot]
 	}
+	WritePropsSnapshot(excludes, includes, sourcesBase, sourcesUser); //!-add-[PropsSnapshot]
 
 	if (!localiser.read) {
 		ReadLocalization();
@@ -576,6 +692,75 @@ void SciTEBase::ReadAPI(const SString &fileNameForExtension) {
 	}
 }
 
+//!-start-[ApiCache]
+// When each of the api files was changed, to tell whether a copy read before is still right
+static SString ApiStamps(const SString &fileNames, size_t &size) {
+	SString stamps;
+	size = 0;
+	SString names = fileNames;
+	names.substitute(';', '\0');
+	const char *apiFileName = names.c_str();
+	const char *nameEnd = apiFileName + fileNames.length();
+	while (apiFileName < nameEnd) {
+		struct stat statusFile;
+		if (stat(apiFileName, &statusFile) == 0) {
+			char stamp[64];
+			sprintf(stamp, "%ld:%ld;", static_cast<long>(statusFile.st_mtime),
+				static_cast<long>(statusFile.st_size));
+			stamps += stamp;
+			size += statusFile.st_size;
+		} else {
+			stamps += "-;";
+		}
+		apiFileName += strlen(apiFileName) + 1;
+	}
+	return stamps;
+}
+
+void SciTEBase::SwitchAPI(const SString &fileNameForExtension, const SString &fileNames) {
+	const size_t cacheLimit = static_cast<size_t>(props.GetInt("api.cache.size", 64)) * 1024 * 1024;
+	// Keep the list in use for when a buffer using it is shown again
+	if (apis && (cacheLimit > 0)) {
+		ApiCacheEntry entry;
+		entry.fileNames = apisFileNames;
+		entry.stamps = apisStamps;
+		entry.size = apisSize;
+		entry.list = new StringList(true);
+		entry.list->Swap(apis);
+		apiCache.push_back(entry);
+	}
+	apis.Clear();
+	apisFileNames = fileNames;
+	apisStamps = ApiStamps(fileNames, apisSize);
+	for (size_t i = 0; i < apiCache.size(); i++) {
+		if (apiCache[i].fileNames == fileNames) {
+			// Files changed since they were read are read again
+			if (apiCache[i].stamps == apisStamps)
+				apis.Swap(*apiCache[i].list);
+			delete apiCache[i].list;
+			apiCache.erase(apiCache.begin() + i);
+			break;
+		}
+	}
+	if (!apis)
+		ReadAPI(fileNameForExtension);
+	size_t sizeCache = 0;
+	for (size_t j = 0; j < apiCache.size(); j++)
+		sizeCache += apiCache[j].size;
+	while (!apiCache.empty() && (sizeCache > cacheLimit)) {
+		sizeCache -= apiCache.front().size;
+		delete apiCache.front().list;
+		apiCache.erase(apiCache.begin());
+	}
+}
+
+void SciTEBase::ClearApiCache() {
+	for (size_t i = 0; i < apiCache.size(); i++)
+		delete apiCache[i].list;
+	apiCache.clear();
+}
+//!-end-[ApiCache]
+
 SString SciTEBase::FindLanguageProperty(const char *pattern, const char *defaultValue) {
 	SString key = pattern;
 	key.substitute("*", language.c_str());
@@ -863,11 +1048,16 @@ void SciTEBase::ReadProperties() {
 		ForwardPropertyToEditor(propertiesToForward[i]);
 	}
 
-	if (apisFileNames != props.GetNewExpand("api.",	fileNameForExtension.c_str())) {
-		apis.Clear();
-		ReadAPI(fileNameForExtension);
-		apisFileNames = props.GetNewExpand("api.", fileNameForExtension.c_str());
-	}
+//!	if (apisFileNames != props.GetNewExpand("api.",	fileNameForExtension.c_str())) {
+//!		apis.Clear();
+//!		ReadAPI(fileNameForExtension);
+//!		apisFileNames = props.GetNewExpand("api.", fileNameForExtension.c_str());
+//!	}
+//!-start-[ApiCache]
+	SString apisFileNamesNew = props.GetNewExpand("api.", fileNameForExtension.c_str());
+	if (apisFileNames != apisFileNamesNew)
+		SwitchAPI(fileNameForExtension, apisFileNamesNew);
+//!-end-[ApiCache]
 
 	props.Set("APIPath", apisFileNames.c_str());
 
@@ -1126,6 +1316,18 @@ void SciTEBase::ReadProperties() {
 		autoCompleteIgnoreCase = sval == "1";
 	wEditor.Call(SCI_AUTOCSETIGNORECASE, autoCompleteIgnoreCase ? 1 : 0);
 	wOutput.Call(SCI_AUTOCSETIGNORECASE, 1);
+//!-start-[FuzzyAutoComplete]
+	autoCompleteFuzzy = FindIntLanguageProperty("autocomplete.*.fuzzy") != 0;
+	autoCompleteMaxItems = props.GetInt("autocomplete.max.items", 100);
+//!-end-[FuzzyAutoComplete]
+//!-start-[AutoCompleteWordIndex]
+	autoCompleteWordIndex = props.GetInt("autocompleteword.index", 1) != 0;
+	autoCompleteWordAllBuffers = props.GetInt("autocompleteword.all.buffers") != 0;
+	if (!autoCompleteWordIndex) {
+		// The indexes stop following changes so have to be built again when turned back on
+		WordIndexInvalidateAll();
+	}
+//!-end-[AutoCompleteWordIndex]
 
 	int autoCChooseSingle = props.GetInt("autocomplete.choose.single");
 	wEditor.Call(SCI_AUTOCSETCHOOSESINGLE, autoCChooseSingle),
@@ -1170,6 +1372,23 @@ void SciTEBase::ReadProperties() {
 
 	wEditor.Call(SCI_SETLAYOUTCACHE, props.GetInt("cache.layout", SC_CACHE_CARET));
 	wOutput.Call(SCI_SETLAYOUTCACHE, props.GetInt("output.cache.layout", SC_CACHE_CARET));
+//!-start-[LayoutCacheMemory]
+	int layoutCacheMemory = props.GetInt("cache.layout.memory", -1);
+	if (layoutCacheMemory >= 0)
+		wEditor.Call(SCI_SETLAYOUTCACHEMEMORY, layoutCacheMemory);
+	layoutCacheMemory = props.GetInt("output.cache.layout.memory", -1);
+	if (layoutCacheMemory >= 0)
+		wOutput.Call(SCI_SETLAYOUTCACHEMEMORY, layoutCacheMemory);
+//!-end-[LayoutCacheMemory]
+	wEditor.Call(SCI_SETCHUNKSIZE, props.GetInt("storage.chunk.size")); //!-add-[ChunkedStorage]
+	wEditor.Call(SCI_SETBACKGROUNDLEXING, props.GetInt("lexing.background")); //!-add-[BackgroundLexing]
+	wEditor.Call(SCI_SETWRAPTHREADS, props.GetInt("wrap.threads", 1)); //!-add-[WrapThreads]
+	wEditor.Call(SCI_SETUNDOMEMORYLIMIT, props.GetInt("undo.memory.limit")); //!-add-[UndoArena]
+//!-start-[SharedPositionCache]
+	int positionCacheMemory = props.GetInt("position.cache.memory");
+	if (positionCacheMemory > 0)
+		wEditor.Call(SCI_SETPOSITIONCACHEMEMORY, positionCacheMemory);
+//!-end-[SharedPositionCache]
 
 	bracesCheck = props.GetInt("braces.check");
 	bracesSloppy = props.GetInt("braces.sloppy");
@@ -1269,6 +1488,7 @@ void SciTEBase::ReadProperties() {
 
 
 	scrollOutput = props.GetInt("output.scroll", 1);
+	outputMaxSize = props.GetInt("output.max.size");	//!-add-[OutputBatch]
 
 	tabHideOne = props.GetInt("tabbar.hide.one");
 
@@ -1292,6 +1512,13 @@ void SciTEBase::ReadProperties() {
 		//doesn't seem to fire as an event of its own; just modifies the
 		//insert and delete events.
 	}
+//!-start-[AutoCompleteWordIndex]
+	if (autoCompleteWordIndex) {
+		// The word index uncounts the words around a change before it happens
+		wEditor.Call(SCI_SETMODEVENTMASK, SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT
+			| SC_MOD_BEFOREINSERT | SC_MOD_BEFOREDELETE | wEditor.Call(SCI_GETMODEVENTMASK, 0));
+	}
+//!-end-[AutoCompleteWordIndex]
 
 	// Create a margin column for the folding symbols
 	wEditor.Call(SCI_SETMARGINTYPEN, 2, SC_MARGIN_SYMBOL);
@@ -5,6 +5,7 @@
 // Copyright 2010 by Neil Hodgson <neilh@scintilla.org>
 // The License.txt file describes the conditions under which this software may be distributed.
 
+#include <stddef.h> //!-add-[PropsSnapshot]
 #include <string.h>
 
 #include <string>
@@ -204,3 +205,31 @@ unsigned int UnSlashLowOctal(char *s) {
 	*o = '\0';
 	return static_cast<unsigned int>(o - sStart);
 }
+
+//!-start-[PropsSnapshot]
+void AppendNumber(std::string &data, long long value) {
+	data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void AppendString(std::string &data, const std::string &s) {
+	AppendNumber(data, static_cast<long long>(s.length()));
+	data.append(s);
+}
+
+bool ReadNumber(const char *&data, const char *end, long long &value) {
+	if (end - data < static_cast<ptrdiff_t>(sizeof(value)))
+		return false;
+	memcpy(&value, data, sizeof(value));
+	data += sizeof(value);
+	return true;
+}
+
+bool ReadString(const char *&data, const char *end, std::string &s) {
+	long long length = 0;
+	if (!ReadNumber(data, end, length) || (length < 0) || (length > end - data))
+		return false;
+	s.assign(data, static_cast<size_t>(length));
+	data += length;
+	return true;
+}
+//!-end-[PropsSnapshot]
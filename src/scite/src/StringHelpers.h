@@ -13,6 +13,27 @@ char *Slash(const char *s, bool quoteQuotes);
 unsigned int UnSlash(char *s);
 unsigned int UnSlashLowOctal(char *s);
 
+//!-start-[HashText]
+const unsigned int hashTextStart = 2166136261U;
+
+// FNV-1a hash continuing from hash so that text hashed in pieces gives the same value.
+inline unsigned int HashText(const char *s, size_t length, unsigned int hash=hashTextStart) {
+	for (size_t i = 0; i < length; i++) {
+		hash ^= static_cast<unsigned char>(s[i]);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+//!-end-[HashText]
+
+//!-start-[PropsSnapshot]
+// Numbers are written as they are in memory as the data is only read by the same build.
+void AppendNumber(std::string &data, long long value);
+void AppendString(std::string &data, const std::string &s);
+bool ReadNumber(const char *&data, const char *end, long long &value);
+bool ReadString(const char *&data, const char *end, std::string &s);
+//!-end-[PropsSnapshot]
+
 class ILocalize {
 public:
 	virtual GUI::gui_string Text(const char *s, bool retainIfNotFound=true) = 0;
@@ -9,7 +9,9 @@
 #include <string.h>
 
 #include <string>
+#include <vector>
 #include <map>
+#include <algorithm>
 
 #include "SString.h"
 #include "StringList.h"
@@ -101,9 +103,11 @@ void StringList::Clear() {
 	len = 0;
 	sorted = false;
 	sortedNoCase = false;
+	ClearNames(); //!-add-[FuzzyAutoComplete]
 }
 
 void StringList::Set(const char *s) {
+	ClearNames(); //!-add-[FuzzyAutoComplete]
 	list = StringDup(s);
 	sorted = false;
 	sortedNoCase = false;
@@ -119,6 +123,7 @@ char *StringList::Allocate(int size) {
 }
 
 void StringList::SetFromAllocated() {
+	ClearNames(); //!-add-[FuzzyAutoComplete]
 	sorted = false;
 	sortedNoCase = false;
 	words = ArrayFromStringList(list, &len, onlyLineEnds);
@@ -411,6 +416,241 @@ char *StringList::GetNearestWords(
 	return NULL;
 }
 
+//!-start-[FuzzyAutoComplete]
+static inline char MakeLowerCase(char ch) {
+	if (ch < 'A' || ch > 'Z')
+		return ch;
+	else
+		return static_cast<char>(ch - 'A' + 'a');
+}
+
+static inline bool IsAlphaNumeric(char ch) {
+	return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+/**
+ * A bit for each letter, ignoring case, and for digits, '_', '.' and other characters
+ * so names which can not contain all the characters of a search are quickly skipped.
+ */
+static unsigned int CharacterMask(const char *s, size_t len) {
+	unsigned int mask = 0;
+	for (size_t i = 0; i < len; i++) {
+		const char ch = MakeLowerCase(s[i]);
+		if (ch >= 'a' && ch <= 'z')
+			mask |= 1u << (ch - 'a');
+		else if (ch >= '0' && ch <= '9')
+			mask |= 1u << 26;
+		else if (ch == '_')
+			mask |= 1u << 27;
+		else if (ch == '.')
+			mask |= 1u << 28;
+		else
+			mask |= 1u << 29;
+	}
+	return mask;
+}
+
+/**
+ * Length of the name at the start of an element, up to a '(' or one of the separators
+ * and without any spaces before it.
+ */
+static size_t LengthName(const char *word, const char *separators) {
+	size_t length = 0;
+	while (word[length] && (word[length] != '(') && !strchr(separators, word[length]))
+		length++;
+	while ((length > 0) && IsASpace(word[length - 1]))
+		length--;
+	return length;
+}
+
+//!-start-[ApiCache]
+void StringList::Swap(StringList &other) {
+	std::swap(words, other.words);
+	std::swap(wordsNoCase, other.wordsNoCase);
+	std::swap(list, other.list);
+	std::swap(len, other.len);
+	std::swap(onlyLineEnds, other.onlyLineEnds);
+	std::swap(sorted, other.sorted);
+	std::swap(sortedNoCase, other.sortedNoCase);
+	std::swap_ranges(starts, starts + 256, other.starts);
+	std::swap(names, other.names);
+	std::swap(namesSorted, other.namesSorted);
+	std::swap(namesNoCase, other.namesNoCase);
+	std::swap(namesMasks, other.namesMasks);
+	std::swap(lenNames, other.lenNames);
+	SString separators = namesSeparators;
+	namesSeparators = other.namesSeparators;
+	other.namesSeparators = separators;
+}
+//!-end-[ApiCache]
+
+void StringList::ClearNames() {
+	delete []names;
+	names = 0;
+	delete []namesSorted;
+	namesSorted = 0;
+	delete []namesNoCase;
+	namesNoCase = 0;
+	delete []namesMasks;
+	namesMasks = 0;
+	lenNames = 0;
+	namesSeparators = "";
+}
+
+void StringList::BuildNames(const char *separators) {
+	ClearNames();
+	namesSeparators = separators;
+	size_t size = 0;
+	for (int i = 0; i < len; i++)
+		size += LengthName(words[i], separators) + 1;
+	names = new char[size + 1];
+	namesSorted = new const char *[len + 1];
+	char *name = names;
+	for (int i = 0; i < len; i++) {
+		const size_t length = LengthName(words[i], separators);
+		if (length) {
+			memcpy(name, words[i], length);
+			name[length] = '\0';
+			namesSorted[lenNames++] = name;
+			name += length + 1;
+		}
+	}
+	qsort(reinterpret_cast<void*>(namesSorted), lenNames, sizeof(*namesSorted), slCmpString);
+	int unique = 0;
+	for (int j = 0; j < lenNames; j++) {
+		if ((unique == 0) || strcmp(namesSorted[unique - 1], namesSorted[j]))
+			namesSorted[unique++] = namesSorted[j];
+	}
+	lenNames = unique;
+	namesNoCase = new const char *[lenNames + 1];
+	memcpy(namesNoCase, namesSorted, lenNames * sizeof(*namesSorted));
+	qsort(reinterpret_cast<void*>(namesNoCase), lenNames, sizeof(*namesNoCase), slCmpStringNoCase);
+	namesMasks = new unsigned int[lenNames + 1];
+	for (int k = 0; k < lenNames; k++)
+		namesMasks[k] = CharacterMask(namesSorted[k], strlen(namesSorted[k]));
+}
+
+/**
+ * How well a name matches the characters of a search in order, ignoring case, or -1 when
+ * it does not contain them all. Characters matched at the start of the name or of a word
+ * inside it, following the previous match, or with the same case score more.
+ */
+static int FuzzyScore(const char *search, size_t searchLen, const char *name) {
+	int score = 0;
+	int previous = -2;
+	int pos = 0;
+	for (size_t i = 0; i < searchLen; i++) {
+		const char ch = MakeLowerCase(search[i]);
+		while (name[pos] && (MakeLowerCase(name[pos]) != ch))
+			pos++;
+		if (!name[pos])
+			return -1;
+		score++;
+		if (pos == 0) {
+			score += 8;
+		} else if (!IsAlphaNumeric(name[pos - 1]) ||
+			((name[pos - 1] >= 'a') && (name[pos - 1] <= 'z') && (name[pos] >= 'A') && (name[pos] <= 'Z'))) {
+			score += 4;
+		}
+		if (pos == previous + 1)
+			score += 4;
+		if (name[pos] == search[i])
+			score++;
+		previous = pos;
+		pos++;
+	}
+	return score;
+}
+
+struct RankedName {
+	int score;
+	const char *name;
+};
+
+static bool BetterRanked(const RankedName &a, const RankedName &b) {
+	if (a.score != b.score)
+		return a.score > b.score;
+	const size_t lenA = strlen(a.name);
+	const size_t lenB = strlen(b.name);
+	if (lenA != lenB)
+		return lenA < lenB;
+	return strcmp(a.name, b.name) < 0;
+}
+
+/**
+ * Returns the names of elements, without duplicates, separated by spaces.
+ * Without fuzzy, they are the first maxWords names starting with the passed string,
+ * in sorted order.
+ * With fuzzy, they are the best maxWords names containing the characters of the passed
+ * string in order, the best first.
+ * truncated is set when more names than maxWords matched.
+ * The name of an element ends at a '(' or one of the separators.
+ *
+ * NOTE: returned buffer has to be freed with delete[].
+ */
+char *StringList::GetCompletions(const char *wordStart, size_t searchLen, bool ignoreCase,
+	const char *separators, bool fuzzy, int maxWords, bool &truncated) {
+	truncated = false;
+	if (0 == words)
+		return NULL;
+	const size_t maxResults = (maxWords > 0) ? maxWords : 1;
+	if (!names || (namesSeparators != separators))
+		BuildNames(separators);
+	SString wordsNear;
+	wordsNear.setsizegrowth(1000);
+	if (fuzzy) {
+		const unsigned int mask = CharacterMask(wordStart, searchLen);
+		std::vector<RankedName> ranked;
+		for (int i = 0; i < lenNames; i++) {
+			if ((namesMasks[i] & mask) == mask) {
+				const int score = FuzzyScore(wordStart, searchLen, namesSorted[i]);
+				if (score >= 0) {
+					RankedName rn = { score, namesSorted[i] };
+					ranked.push_back(rn);
+				}
+			}
+		}
+		const size_t results = std::min(ranked.size(), maxResults);
+		truncated = ranked.size() > maxResults;
+		std::partial_sort(ranked.begin(), ranked.begin() + results, ranked.end(), BetterRanked);
+		for (size_t r = 0; r < results; r++)
+			wordsNear.append(ranked[r].name, strlen(ranked[r].name), ' ');
+	} else {
+		const char **sortedNames = ignoreCase ? namesNoCase : namesSorted;
+		// Binary search for the first name starting with wordStart
+		int start = 0;
+		int end = lenNames;
+		while (start < end) {
+			const int pivot = (start + end) / 2;
+			const int cond = ignoreCase ?
+				CompareNCaseInsensitive(wordStart, sortedNames[pivot], searchLen) :
+				strncmp(wordStart, sortedNames[pivot], searchLen);
+			if (cond > 0)
+				start = pivot + 1;
+			else
+				end = pivot;
+		}
+		size_t results = 0;
+		for (int i = start; i < lenNames; i++) {
+			const int cond = ignoreCase ?
+				CompareNCaseInsensitive(wordStart, sortedNames[i], searchLen) :
+				strncmp(wordStart, sortedNames[i], searchLen);
+			if (cond)
+				break;
+			if (results == maxResults) {
+				truncated = true;
+				break;
+			}
+			results++;
+			wordsNear.append(sortedNames[i], strlen(sortedNames[i]), ' ');
+		}
+	}
+	if (wordsNear.length() == 0)
+		return NULL;
+	return wordsNear.detach();
+}
+//!-end-[FuzzyAutoComplete]
+
 #ifdef _MSC_VER
 // Unreferenced inline functions are OK
 #pragma warning(disable: 4514)
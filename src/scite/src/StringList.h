@@ -16,9 +16,23 @@ public:
 	bool sorted;
 	bool sortedNoCase;
 	int starts[256];
+//!-start-[FuzzyAutoComplete]
+	// Names of the words up to a separator, without duplicates, for completion lists.
+	// Built when first needed.
+	char *names;
+	const char **namesSorted;
+	const char **namesNoCase;
+	unsigned int *namesMasks;	///< Characters present in each of namesSorted
+	int lenNames;
+	SString namesSeparators;
+	void ClearNames();
+	void BuildNames(const char *separators);
+//!-end-[FuzzyAutoComplete]
 	StringList(bool onlyLineEnds_ = false) :
 		words(0), wordsNoCase(0), list(0), len(0), onlyLineEnds(onlyLineEnds_),
-		sorted(false), sortedNoCase(false) {}
+//!		sorted(false), sortedNoCase(false) {}
+		sorted(false), sortedNoCase(false), //!-change-[FuzzyAutoComplete]
+		names(0), namesSorted(0), namesNoCase(0), namesMasks(0), lenNames(0) {} //!-add-[FuzzyAutoComplete]
 	~StringList() { Clear(); }
 	operator bool() const { return len ? true : false; }
 	char *operator[](int ind) { return words[ind]; }
@@ -32,5 +46,10 @@ public:
 		bool ignoreCase = false, SString wordCharacters="", int wordIndex = -1);
 	char *GetNearestWords(const char *wordStart, size_t searchLen,
 		bool ignoreCase=false, char otherSeparator='\0', bool exactLen=false);
+//!-start-[FuzzyAutoComplete]
+	char *GetCompletions(const char *wordStart, size_t searchLen, bool ignoreCase,
+		const char *separators, bool fuzzy, int maxWords, bool &truncated);
+//!-end-[FuzzyAutoComplete]
+	void Swap(StringList &other); //!-add-[ApiCache]
 };
 
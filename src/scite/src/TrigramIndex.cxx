@@ -0,0 +1,503 @@
+// SciTE - Scintilla based Text Editor
+/** @file TrigramIndex.cxx
+ ** Index of the sequences of three bytes in the files below a directory.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iterator>
+
+#include "Scintilla.h"
+
+#include "GUI.h"
+#include "StringHelpers.h"
+#include "FilePath.h"
+#include "TrigramIndex.h"
+
+/*
+ * Layout of an index file, numbers of 32 or 64 bits stored least significant byte first
+ * so an index can be read by any build:
+ *   "SciTETI2"
+ *   size of a path character, root directory
+ *   number of files, number of trigrams
+ *   for each file: relative path, modification time, size, kind
+ *   for each trigram in increasing order: trigram, bytes of its file numbers
+ *   for each trigram: increasing file numbers, each stored as the difference from the
+ *   previous one in 7 bit groups with the top bit set on all but the last group
+ * A path is stored as its length followed by its characters, each also least significant
+ * byte first.
+ */
+
+static const char indexMagic[] = "SciTETI2";
+static const size_t magicLength = 8;
+// Limit on a stored path so that a damaged file can not cause a huge allocation
+static const unsigned int maxPathLength = 32768;
+// Size of the first read of a file which decides whether it is binary as Find in Files does
+static const size_t readSize = 64 * 1024;
+// Estimated size of a file number in the index
+static const int bytesPerFile = 2;
+
+static void AppendNumber(std::vector<unsigned char> &data, unsigned long long value, size_t bytes) {
+	for (size_t i = 0; i < bytes; i++) {
+		data.push_back(static_cast<unsigned char>(value & 0xff));
+		value >>= 8;
+	}
+}
+
+static unsigned long long NumberAt(const unsigned char *data, size_t bytes) {
+	unsigned long long value = 0;
+	for (size_t i = bytes; i > 0; i--)
+		value = (value << 8) | data[i - 1];
+	return value;
+}
+
+static void WriteNumber(FILE *fp, unsigned long long value, size_t bytes) {
+	unsigned char data[8];
+	for (size_t i = 0; i < bytes; i++) {
+		data[i] = static_cast<unsigned char>(value & 0xff);
+		value >>= 8;
+	}
+	fwrite(data, 1, bytes, fp);
+}
+
+static bool ReadNumber(FILE *fp, unsigned long long &value, size_t bytes) {
+	unsigned char data[8];
+	if (fread(data, 1, bytes, fp) != bytes)
+		return false;
+	value = NumberAt(data, bytes);
+	return true;
+}
+
+static void WriteU32(FILE *fp, unsigned int value) {
+	WriteNumber(fp, value, 4);
+}
+
+static void WriteI64(FILE *fp, long long value) {
+	WriteNumber(fp, static_cast<unsigned long long>(value), 8);
+}
+
+static void WriteString(FILE *fp, const GUI::gui_string &s) {
+	WriteU32(fp, static_cast<unsigned int>(s.length()));
+	std::vector<unsigned char> data;
+	for (size_t i = 0; i < s.length(); i++)
+		AppendNumber(data, static_cast<unsigned long long>(s[i]), sizeof(GUI::gui_char));
+	if (!data.empty())
+		fwrite(&data[0], 1, data.size(), fp);
+}
+
+static bool ReadU32(FILE *fp, unsigned int &value) {
+	unsigned long long number = 0;
+	if (!ReadNumber(fp, number, 4))
+		return false;
+	value = static_cast<unsigned int>(number);
+	return true;
+}
+
+static bool ReadI64(FILE *fp, long long &value) {
+	unsigned long long number = 0;
+	if (!ReadNumber(fp, number, 8))
+		return false;
+	value = static_cast<long long>(number);
+	return true;
+}
+
+static bool ReadString(FILE *fp, GUI::gui_string &s) {
+	unsigned int length = 0;
+	if (!ReadU32(fp, length) || (length > maxPathLength))
+		return false;
+	const size_t bytes = length * sizeof(GUI::gui_char);
+	std::vector<unsigned char> data(bytes + 1);
+	if (fread(&data[0], 1, bytes, fp) != bytes)
+		return false;
+	s.resize(length);
+	for (unsigned int i = 0; i < length; i++)
+		s[i] = static_cast<GUI::gui_char>(NumberAt(&data[i * sizeof(GUI::gui_char)], sizeof(GUI::gui_char)));
+	return true;
+}
+
+static inline unsigned int Fold(unsigned char ch) {
+	return ((ch >= 'A') && (ch <= 'Z')) ? (ch - 'A' + 'a') : ch;
+}
+
+static void FileStatus(const FilePath &path, long long &modified, long long &size) {
+	time_t modifiedTime = 0;
+	Sci_Position length = -1;
+	if (!path.Status(modifiedTime, length)) {
+		modifiedTime = 0;
+		length = -1;
+	}
+	modified = static_cast<long long>(modifiedTime);
+	size = static_cast<long long>(length);
+}
+
+static bool ShorterEntry(const std::pair<unsigned int, long> &a, const std::pair<unsigned int, long> &b) {
+	return a.first < b.first;
+}
+
+TrigramIndex::TrigramIndex() : filtering(false) {
+}
+
+const TrigramIndex::TrigramEntry *TrigramIndex::Find(unsigned int trigram) const {
+	size_t low = 0;
+	size_t high = trigrams.size();
+	while (low < high) {
+		const size_t middle = (low + high) / 2;
+		if (trigrams[middle].trigram < trigram)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	if ((low < trigrams.size()) && (trigrams[low].trigram == trigram))
+		return &trigrams[low];
+	return 0;
+}
+
+bool TrigramIndex::ReadFiles(FILE *fp, const TrigramEntry &te, std::vector<int> &ids) const {
+	ids.clear();
+	if (te.length == 0)
+		return true;
+	std::vector<unsigned char> data(te.length);
+	if ((fseek(fp, static_cast<long>(te.offset), SEEK_SET) != 0) || (fread(&data[0], 1, te.length, fp) != te.length))
+		return false;
+	int id = 0;
+	unsigned int delta = 0;
+	int shift = 0;
+	for (size_t i = 0; i < data.size(); i++) {
+		delta |= static_cast<unsigned int>(data[i] & 0x7f) << shift;
+		if (data[i] & 0x80) {
+			shift += 7;
+		} else {
+			id += delta;
+			if ((id < 0) || (id >= static_cast<int>(files.size())))
+				return false;
+			ids.push_back(id);
+			delta = 0;
+			shift = 0;
+		}
+	}
+	return true;
+}
+
+int TrigramIndex::FileFromPath(const FilePath &path) const {
+	const GUI::gui_string name(path.AsInternal());
+	if ((name.length() <= root.length()) || (name.compare(0, root.length(), root) != 0))
+		return -1;
+	std::map<GUI::gui_string, int>::const_iterator it = fileFromPath.find(name.substr(root.length()));
+	return (it != fileFromPath.end()) ? it->second : -1;
+}
+
+bool TrigramIndex::Load(const FilePath &indexFile_, const FilePath &root_) {
+	indexFile = indexFile_;
+	root = root_.AsInternal();
+	files.clear();
+	fileFromPath.clear();
+	trigrams.clear();
+	candidates.clear();
+	filtering = false;
+	FILE *fp = indexFile.Open(fileRead);
+	if (!fp)
+		return false;
+	char magic[magicLength];
+	unsigned int charSize = 0;
+	GUI::gui_string rootIndexed;
+	unsigned int fileCount = 0;
+	unsigned int trigramCount = 0;
+	bool ok = (fread(magic, 1, magicLength, fp) == magicLength) &&
+		(memcmp(magic, indexMagic, magicLength) == 0) &&
+		ReadU32(fp, charSize) && (charSize == sizeof(GUI::gui_char)) &&
+		ReadString(fp, rootIndexed) && (rootIndexed == root) &&
+		ReadU32(fp, fileCount) && ReadU32(fp, trigramCount);
+	for (unsigned int i = 0; ok && (i < fileCount); i++) {
+		FileEntry fe;
+		unsigned int kind = kindUnindexed;
+		ok = ReadString(fp, fe.path) && ReadI64(fp, fe.modified) && ReadI64(fp, fe.size) && ReadU32(fp, kind);
+		fe.kind = kind;
+		files.push_back(fe);
+		fileFromPath[fe.path] = i;
+	}
+	long long offset = 0;
+	for (unsigned int j = 0; ok && (j < trigramCount); j++) {
+		TrigramEntry te;
+		ok = ReadU32(fp, te.trigram) && ReadU32(fp, te.length);
+		te.offset = offset;
+		offset += te.length;
+		trigrams.push_back(te);
+	}
+	if (ok) {
+		// File numbers follow the list of trigrams
+		const long long start = ftell(fp);
+		for (size_t k = 0; k < trigrams.size(); k++) {
+			trigrams[k].offset += start;
+		}
+	}
+	fclose(fp);
+	if (!ok) {
+		files.clear();
+		fileFromPath.clear();
+		trigrams.clear();
+	}
+	return ok;
+}
+
+void TrigramIndex::Query(const char *text) {
+	filtering = false;
+	candidates.clear();
+	const size_t length = strlen(text);
+	if ((length < 3) || files.empty())
+		return;
+	std::vector<unsigned int> wanted;
+	for (size_t i = 0; i + 2 < length; i++) {
+		const unsigned char *bytes = reinterpret_cast<const unsigned char *>(text + i);
+		wanted.push_back((Fold(bytes[0]) << 16) | (Fold(bytes[1]) << 8) | Fold(bytes[2]));
+	}
+	std::sort(wanted.begin(), wanted.end());
+	wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+	// Shortest lists first so the intersection shrinks quickly
+	std::vector<std::pair<unsigned int, long> > entries;
+	for (size_t j = 0; j < wanted.size(); j++) {
+		const TrigramEntry *te = Find(wanted[j]);
+		if (!te) {
+			// No file contains this trigram
+			candidates.assign(files.size(), false);
+			filtering = true;
+			return;
+		}
+		entries.push_back(std::pair<unsigned int, long>(te->length, static_cast<long>(te - &trigrams[0])));
+	}
+	std::sort(entries.begin(), entries.end(), ShorterEntry);
+	FILE *fp = indexFile.Open(fileRead);
+	if (!fp)
+		return;
+	std::vector<int> common;
+	std::vector<int> ids;
+	std::vector<int> both;
+	bool ok = true;
+	for (size_t k = 0; k < entries.size(); k++) {
+		if (!ReadFiles(fp, trigrams[entries[k].second], ids)) {
+			ok = false;
+			break;
+		}
+		if (k == 0) {
+			common.swap(ids);
+		} else {
+			both.clear();
+			std::set_intersection(common.begin(), common.end(), ids.begin(), ids.end(), std::back_inserter(both));
+			common.swap(both);
+		}
+		if (common.empty())
+			break;
+	}
+	fclose(fp);
+	if (ok) {
+		candidates.assign(files.size(), false);
+		for (size_t m = 0; m < common.size(); m++) {
+			candidates[common[m]] = true;
+		}
+		filtering = true;
+	}
+}
+
+TrigramIndex::FileState TrigramIndex::Check(const FilePath &path, bool searchBinary) const {
+	const int id = FileFromPath(path);
+	if (id < 0)
+		return fileUnknown;
+	const FileEntry &fe = files[id];
+	long long modified = 0;
+	long long size = 0;
+	FileStatus(path, modified, size);
+	if ((fe.modified != modified) || (fe.size != size))
+		return fileUnknown;
+	if (fe.kind == kindBinary)
+		return searchBinary ? fileSearch : fileSkip;
+	if (fe.kind == kindUnindexed)
+		return fileSearch;
+	return (!filtering || candidates[id]) ? fileSearch : fileSkip;
+}
+
+// Collect the distinct trigrams of a file into found using seen, one bit for each
+// possible trigram, which is left clear again.
+static int ReadTrigrams(const FilePath &path, std::vector<unsigned char> &seen, std::vector<unsigned int> &found) {
+	found.clear();
+	FILE *fp = path.Open(fileRead);
+	if (!fp)
+		return TrigramIndex::kindUnindexed;
+	int kind = TrigramIndex::kindText;
+	std::vector<char> block(readSize);
+	unsigned int trigram = 0;
+	size_t bytes = 0;
+	size_t lengthBlock;
+	while ((lengthBlock = fread(&block[0], 1, readSize, fp)) > 0) {
+		if ((bytes == 0) && memchr(&block[0], 0, lengthBlock)) {
+			// Binary files are not searched by default so their contents are not indexed
+			kind = TrigramIndex::kindBinary;
+			break;
+		}
+		for (size_t i = 0; i < lengthBlock; i++) {
+			trigram = ((trigram << 8) | Fold(static_cast<unsigned char>(block[i]))) & 0xffffff;
+			if (++bytes >= 3) {
+				const unsigned char bit = static_cast<unsigned char>(1 << (trigram & 7));
+				if (!(seen[trigram >> 3] & bit)) {
+					seen[trigram >> 3] |= bit;
+					found.push_back(trigram);
+				}
+			}
+		}
+	}
+	fclose(fp);
+	for (size_t j = 0; j < found.size(); j++) {
+		seen[found[j] >> 3] = 0;
+	}
+	if (kind == TrigramIndex::kindBinary)
+		found.clear();
+	return kind;
+}
+
+bool TrigramIndex::Update(const FilePath &indexFile, const FilePath &root, const FilePathSet &paths,
+	long long sizeLimit, volatile bool *cancelling) {
+	TrigramIndex previous;
+	const bool reuse = previous.Load(indexFile, root);
+	const GUI::gui_string rootName(root.AsInternal());
+
+	std::vector<FileEntry> files;
+	std::vector<int> fromPrevious(previous.files.size(), -1);
+	std::vector<size_t> toRead;	// Positions in paths of files to read
+	std::vector<int> idsToRead;
+	for (size_t i = 0; i < paths.size(); i++) {
+		const GUI::gui_string name(paths[i].AsInternal());
+		if ((name.length() <= rootName.length()) || (name.compare(0, rootName.length(), rootName) != 0))
+			continue;
+		FileEntry fe;
+		fe.path = name.substr(rootName.length());
+		FileStatus(paths[i], fe.modified, fe.size);
+		fe.kind = kindUnindexed;
+		const int id = static_cast<int>(files.size());
+		const int idPrevious = previous.FileFromPath(paths[i]);
+		if ((idPrevious >= 0) && (previous.files[idPrevious].kind != kindUnindexed) &&
+			(previous.files[idPrevious].modified == fe.modified) && (previous.files[idPrevious].size == fe.size)) {
+			fe.kind = previous.files[idPrevious].kind;
+			fromPrevious[idPrevious] = id;
+		} else {
+			toRead.push_back(i);
+			idsToRead.push_back(id);
+		}
+		files.push_back(fe);
+	}
+
+	// Each pair of a trigram and a file containing it is held as one number with the
+	// trigram in the high half so sorting groups the files of each trigram in order
+	std::vector<unsigned long long> postings;
+	if (reuse) {
+		FILE *fp = indexFile.Open(fileRead);
+		if (fp) {
+			std::vector<int> ids;
+			for (size_t t = 0; t < previous.trigrams.size(); t++) {
+				if (cancelling && *cancelling) {
+					fclose(fp);
+					return false;
+				}
+				if (!previous.ReadFiles(fp, previous.trigrams[t], ids))
+					break;
+				const unsigned long long trigram = previous.trigrams[t].trigram;
+				for (size_t k = 0; k < ids.size(); k++) {
+					if (fromPrevious[ids[k]] >= 0)
+						postings.push_back((trigram << 32) | fromPrevious[ids[k]]);
+				}
+			}
+			fclose(fp);
+		}
+	}
+
+	std::vector<unsigned char> seen((0xffffff + 1) / 8);
+	std::vector<unsigned int> found;
+	for (size_t r = 0; r < toRead.size(); r++) {
+		if (cancelling && *cancelling)
+			return false;
+		// Files past the limit stay unindexed and are always searched
+		if (static_cast<long long>(postings.size()) * bytesPerFile > sizeLimit)
+			break;
+		const unsigned long long id = idsToRead[r];
+		files[id].kind = ReadTrigrams(paths[toRead[r]], seen, found);
+		for (size_t f = 0; f < found.size(); f++) {
+			postings.push_back((static_cast<unsigned long long>(found[f]) << 32) | id);
+		}
+	}
+	std::sort(postings.begin(), postings.end());
+
+	// Encode the file numbers of each trigram
+	std::vector<unsigned char> encoded;
+	std::vector<unsigned int> trigramsFound;
+	std::vector<unsigned int> lengths;
+	size_t startEncoded = 0;
+	unsigned int idPrevious = 0;
+	for (size_t k = 0; k < postings.size(); k++) {
+		const unsigned int trigram = static_cast<unsigned int>(postings[k] >> 32);
+		const unsigned int id = static_cast<unsigned int>(postings[k] & 0xffffffff);
+		if (trigramsFound.empty() || (trigram != trigramsFound.back())) {
+			if (!trigramsFound.empty())
+				lengths.push_back(static_cast<unsigned int>(encoded.size() - startEncoded));
+			trigramsFound.push_back(trigram);
+			startEncoded = encoded.size();
+			idPrevious = 0;
+		}
+		unsigned int delta = id - idPrevious;
+		idPrevious = id;
+		while (delta >= 0x80) {
+			encoded.push_back(static_cast<unsigned char>((delta & 0x7f) | 0x80));
+			delta >>= 7;
+		}
+		encoded.push_back(static_cast<unsigned char>(delta));
+	}
+	if (!trigramsFound.empty())
+		lengths.push_back(static_cast<unsigned int>(encoded.size() - startEncoded));
+	std::vector<unsigned long long>().swap(postings);
+
+	// Write to a new file then replace the old one so a reader never sees a partial index
+	const FilePath fileNew(GUI::gui_string(indexFile.AsInternal()) + GUI_TEXT(".new"));
+	FILE *fp = fileNew.Open(fileWrite);
+	if (!fp)
+		return false;
+	fwrite(indexMagic, 1, magicLength, fp);
+	WriteU32(fp, sizeof(GUI::gui_char));
+	WriteString(fp, rootName);
+	WriteU32(fp, static_cast<unsigned int>(files.size()));
+	WriteU32(fp, static_cast<unsigned int>(trigramsFound.size()));
+	for (size_t i = 0; i < files.size(); i++) {
+		WriteString(fp, files[i].path);
+		WriteI64(fp, files[i].modified);
+		WriteI64(fp, files[i].size);
+		WriteU32(fp, files[i].kind);
+	}
+	for (size_t t = 0; t < trigramsFound.size(); t++) {
+		WriteU32(fp, trigramsFound[t]);
+		WriteU32(fp, lengths[t]);
+	}
+	if (!encoded.empty())
+		fwrite(&encoded[0], 1, encoded.size(), fp);
+	const bool written = !ferror(fp);
+	if ((fclose(fp) != 0) || !written) {
+		fileNew.Remove();
+		return false;
+	}
+	indexFile.Remove();
+	return fileNew.Rename(indexFile);
+}
+
+FilePath TrigramIndex::IndexFileFor(const FilePath &directory, const FilePath &root) {
+	// Hash of the root directory so that each root has its own file
+	const std::string name = root.AsUTF8();
+	const unsigned int hash = HashText(name.c_str(), name.length());
+	char hashText[20];
+	sprintf(hashText, "%08x", hash);
+	GUI::gui_string fileName = GUI_TEXT("SciTE-");
+	fileName += GUI::StringFromUTF8(hashText);
+	fileName += GUI_TEXT(".trigrams");
+	return FilePath(directory, FilePath(fileName));
+}
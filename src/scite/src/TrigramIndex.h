@@ -0,0 +1,67 @@
+// SciTE - Scintilla based Text Editor
+/** @file TrigramIndex.h
+ ** Index of the sequences of three bytes in the files below a directory.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+/// Records which files below a root directory contain each sequence of three bytes
+/// so that Find in Files only has to read the files containing every sequence of the
+/// text searched for.
+/// Letters are indexed in lower case so one index serves case sensitive and case
+/// insensitive searches. A file is only skipped when its size and modification time
+/// are still those it had when it was indexed.
+class TrigramIndex {
+public:
+	enum FileKind { kindText, kindBinary, kindUnindexed };
+	enum FileState { fileUnknown, fileSkip, fileSearch };
+
+	struct FileEntry {
+		GUI::gui_string path;	///< Relative to the root directory
+		long long modified;
+		long long size;
+		int kind;
+	};
+
+private:
+	struct TrigramEntry {
+		unsigned int trigram;
+		unsigned int length;	///< Bytes of encoded file numbers
+		long long offset;
+	};
+
+	FilePath indexFile;
+	GUI::gui_string root;
+	std::vector<FileEntry> files;
+	std::map<GUI::gui_string, int> fileFromPath;
+	std::vector<TrigramEntry> trigrams;
+	std::vector<bool> candidates;
+	bool filtering;
+
+	const TrigramEntry *Find(unsigned int trigram) const;
+	bool ReadFiles(FILE *fp, const TrigramEntry &te, std::vector<int> &ids) const;
+	int FileFromPath(const FilePath &path) const;
+
+public:
+	TrigramIndex();
+	/// Read the list of files and trigrams, leaving the file numbers on disk until needed.
+	bool Load(const FilePath &indexFile_, const FilePath &root_);
+	/// Work out which files may contain text. Text shorter than 3 bytes does not filter.
+	void Query(const char *text);
+	/// Whether a file has to be searched. fileUnknown when it is not in the index or has changed.
+	FileState Check(const FilePath &path, bool searchBinary) const;
+	int Files() const {
+		return static_cast<int>(files.size());
+	}
+
+	/// Write an index of paths to indexFile, reusing what it already holds for unchanged files.
+	/// Files after sizeLimit bytes of trigrams have been collected are left unindexed.
+	static bool Update(const FilePath &indexFile, const FilePath &root, const FilePathSet &paths,
+		long long sizeLimit, volatile bool *cancelling);
+	/// Name of the index of root inside directory.
+	static FilePath IndexFileFor(const FilePath &directory, const FilePath &root);
+};
+
+#endif
@@ -0,0 +1,262 @@
+// SciTE - Scintilla based Text Editor
+/** @file WordIndex.cxx
+ ** Counts of the words in a document for autocompletion.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "Scintilla.h"
+
+#include "GUI.h"
+#include "StringHelpers.h"
+#include "WordIndex.h"
+
+// Case is changed for ASCII only, matching CompareNCaseInsensitive in Scintilla
+// which orders the list when autocompletion ignores case.
+static inline char MakeUpperCase(char ch) {
+	if (ch < 'a' || ch > 'z')
+		return ch;
+	else
+		return static_cast<char>(ch - 'a' + 'A');
+}
+
+static bool LessNoCase(const char *a, size_t lengthA, const char *b, size_t lengthB) {
+	const size_t length = (lengthA < lengthB) ? lengthA : lengthB;
+	for (size_t i = 0; i < length; i++) {
+		const char upperA = MakeUpperCase(a[i]);
+		const char upperB = MakeUpperCase(b[i]);
+		if (upperA != upperB)
+			return upperA < upperB;
+	}
+	if (lengthA != lengthB)
+		return lengthA < lengthB;
+	for (size_t j = 0; j < length; j++) {
+		if (a[j] != b[j])
+			return a[j] < b[j];
+	}
+	return false;
+}
+
+bool WordLessNoCase::operator()(const std::string &a, const std::string &b) const {
+	return LessNoCase(a.c_str(), a.length(), b.c_str(), b.length());
+}
+
+namespace {
+
+/// A word of a text being counted.
+struct WordSpan {
+	size_t start;
+	size_t length;
+	int count;
+};
+
+class SpanLess {
+	const char *text;
+public:
+	explicit SpanLess(const char *text_) : text(text_) {
+	}
+	bool operator()(const WordSpan &a, const WordSpan &b) const {
+		return LessNoCase(text + a.start, a.length, text + b.start, b.length);
+	}
+};
+
+}
+
+WordIndex::WordIndex() : state(stateEmpty), generation(0), lengthDocument(0), changing(false) {
+}
+
+void WordIndex::Invalidate() {
+	words.clear();
+	state = stateEmpty;
+	generation++;
+	changing = false;
+}
+
+bool WordIndex::Valid(long long lengthDocument_, const char *wordCharacters_) const {
+	return (state == stateReady) && !changing && (lengthDocument == lengthDocument_) &&
+		(wordCharacters == wordCharacters_);
+}
+
+int WordIndex::StartBuild(long long lengthDocument_, const char *wordCharacters_) {
+	words.clear();
+	state = stateBuilding;
+	generation++;
+	lengthDocument = lengthDocument_;
+	wordCharacters = wordCharacters_;
+	changing = false;
+	return generation;
+}
+
+bool WordIndex::FinishBuild(int generation_, WordCounts &counts) {
+	if ((state != stateBuilding) || (generation != generation_) || changing) {
+		counts.clear();
+		return false;
+	}
+	for (WordCounts::const_iterator it = words.begin(); it != words.end(); ++it) {
+		int &count = counts[it->first];
+		count += it->second;
+		if (count <= 0)
+			counts.erase(it->first);
+	}
+	words.swap(counts);
+	counts.clear();
+	state = stateReady;
+	return true;
+}
+
+void WordIndex::BeforeChange(const char *text, size_t length) {
+	if (state == stateEmpty)
+		return;
+	if (changing) {
+		// The notification after the last change was missed
+		Invalidate();
+		return;
+	}
+	Count(words, text, length, wordCharacters.c_str(), -1);
+	changing = true;
+}
+
+void WordIndex::BeforeClear() {
+	if (state == stateEmpty)
+		return;
+	if (changing) {
+		Invalidate();
+		return;
+	}
+	// An empty document has no words so any build running is not needed
+	words.clear();
+	state = stateReady;
+	generation++;
+	changing = true;
+}
+
+void WordIndex::AfterChange(const char *text, size_t length, long long lengthChange) {
+	if (state == stateEmpty)
+		return;
+	if (!changing) {
+		// The notification before this change was missed
+		Invalidate();
+		return;
+	}
+	Count(words, text, length, wordCharacters.c_str(), 1);
+	lengthDocument += lengthChange;
+	changing = false;
+}
+
+void WordIndex::Find(const char *prefix, bool ignoreCase, const std::string &wordCurrent,
+	std::vector<std::string> &matches) const {
+	const size_t lengthPrefix = strlen(prefix);
+	// The upper case form of prefix comes first of the words which are the same ignoring case
+	std::string first(prefix);
+	for (size_t i = 0; i < lengthPrefix; i++)
+		first[i] = MakeUpperCase(first[i]);
+	for (WordCounts::const_iterator it = words.lower_bound(first); it != words.end(); ++it) {
+		const std::string &word = it->first;
+		if (word.length() < lengthPrefix)
+			break;
+		bool samePrefix = true;
+		for (size_t j = 0; j < lengthPrefix && samePrefix; j++)
+			samePrefix = MakeUpperCase(word[j]) == first[j];
+		if (!samePrefix)
+			break;
+		if (word.length() == lengthPrefix)
+			continue;
+		if (!ignoreCase && (word.compare(0, lengthPrefix, prefix) != 0))
+			continue;
+		int count = it->second;
+		if (word == wordCurrent)
+			count--;
+		if (count > 0)
+			matches.push_back(word);
+	}
+}
+
+void WordIndex::CountAll(WordCounts &counts, const char *text, size_t length,
+	const char *wordCharacters_, volatile bool *cancelling) {
+	bool isWord[256];
+	for (int ch = 0; ch < 256; ch++)
+		isWord[ch] = false;
+	for (const char *wc = wordCharacters_; *wc; wc++)
+		isWord[static_cast<unsigned char>(*wc)] = true;
+	// Most words occur many times so they are first counted in a hash table of
+	// spans of text and only the distinct words are sorted into counts
+	const size_t empty = static_cast<size_t>(-1);
+	std::vector<size_t> slots(1024, empty);
+	std::vector<WordSpan> spans;
+	size_t i = 0;
+	while (i < length) {
+		if (!isWord[static_cast<unsigned char>(text[i])]) {
+			i++;
+			continue;
+		}
+		if (cancelling && *cancelling)
+			return;
+		const size_t start = i;
+		while ((i < length) && isWord[static_cast<unsigned char>(text[i])])
+			i++;
+		const size_t lengthWord = i - start;
+		const size_t mask = slots.size() - 1;
+		size_t slot = HashText(text + start, lengthWord) & mask;
+		while ((slots[slot] != empty) && ((spans[slots[slot]].length != lengthWord) ||
+			(memcmp(text + spans[slots[slot]].start, text + start, lengthWord) != 0)))
+			slot = (slot + 1) & mask;
+		if (slots[slot] != empty) {
+			spans[slots[slot]].count++;
+			continue;
+		}
+		const WordSpan span = { start, lengthWord, 1 };
+		slots[slot] = spans.size();
+		spans.push_back(span);
+		if (spans.size() * 2 > slots.size()) {
+			// Keep the table at most half full
+			std::vector<size_t> larger(slots.size() * 2, empty);
+			const size_t maskLarger = larger.size() - 1;
+			for (size_t s = 0; s < spans.size(); s++) {
+				size_t slotLarger = HashText(text + spans[s].start, spans[s].length) & maskLarger;
+				while (larger[slotLarger] != empty)
+					slotLarger = (slotLarger + 1) & maskLarger;
+				larger[slotLarger] = s;
+			}
+			slots.swap(larger);
+		}
+	}
+	std::vector<size_t>().swap(slots);
+	std::sort(spans.begin(), spans.end(), SpanLess(text));
+	// In order so each word is inserted at the end
+	for (size_t s = 0; s < spans.size(); s++) {
+		const std::string word(text + spans[s].start, spans[s].length);
+		counts.insert(counts.end(), WordCounts::value_type(word, spans[s].count));
+	}
+}
+
+void WordIndex::Count(WordCounts &counts, const char *text, size_t length,
+	const char *wordCharacters_, int delta, volatile bool *cancelling) {
+	bool isWord[256];
+	for (int ch = 0; ch < 256; ch++)
+		isWord[ch] = false;
+	for (const char *wc = wordCharacters_; *wc; wc++)
+		isWord[static_cast<unsigned char>(*wc)] = true;
+	size_t i = 0;
+	while (i < length) {
+		if (!isWord[static_cast<unsigned char>(text[i])]) {
+			i++;
+			continue;
+		}
+		if (cancelling && *cancelling)
+			return;
+		const size_t start = i;
+		while ((i < length) && isWord[static_cast<unsigned char>(text[i])])
+			i++;
+		const std::string word(text + start, i - start);
+		int &count = counts[word];
+		count += delta;
+		if (count == 0)
+			counts.erase(word);
+	}
+}
@@ -0,0 +1,82 @@
+// SciTE - Scintilla based Text Editor
+/** @file WordIndex.h
+ ** Counts of the words in a document for autocompletion.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef WORDINDEX_H
+#define WORDINDEX_H
+
+/// Orders words as Scintilla does when autocompletion ignores case, then words which
+/// differ only in case by their bytes, so the words starting with some text are
+/// next to each other whether or not case is ignored.
+struct WordLessNoCase {
+	bool operator()(const std::string &a, const std::string &b) const;
+};
+
+/// Counts how often each word occurs in a document so that the words starting with
+/// some text are found without searching the document.
+/// The counts are first made on another thread from a copy of the text. Changes to
+/// the document made while that runs are counted here and added to the counts when
+/// they arrive. After that the words around each insertion and deletion are counted
+/// again as the document tells about the change before and after it happens.
+class WordIndex {
+public:
+	typedef std::map<std::string, int, WordLessNoCase> WordCounts;
+
+private:
+	enum State { stateEmpty, stateBuilding, stateReady };
+
+	/// While building, only the changes made since the text was copied
+	WordCounts words;
+	State state;
+	int generation;
+	long long lengthDocument;
+	std::string wordCharacters;
+	bool changing;	///< Between the notifications before and after a change
+
+public:
+	WordIndex();
+	/// Forget the counts. A build still running will be ignored when it finishes.
+	void Invalidate();
+	/// Whether the counts are those of a document of lengthDocument_ bytes with these word characters.
+	bool Valid(long long lengthDocument_, const char *wordCharacters_) const;
+	bool Empty() const {
+		return state == stateEmpty;
+	}
+	bool Building() const {
+		return state == stateBuilding;
+	}
+	bool Ready() const {
+		return state == stateReady;
+	}
+
+	/// Start counting a copy of a document.
+	/// @return the number to pass to FinishBuild with the counts of the copy.
+	int StartBuild(long long lengthDocument_, const char *wordCharacters_);
+	/// Take the counts of the copy of the document, adding the changes made since.
+	/// The counts are emptied. @return false if the build is no longer wanted.
+	bool FinishBuild(int generation_, WordCounts &counts);
+
+	/// Before text is changed, uncount the words of text which covers the change
+	/// together with the words it touches.
+	void BeforeChange(const char *text, size_t length);
+	/// Before all of the document is deleted.
+	void BeforeClear();
+	/// After text is changed by lengthChange bytes, count the words covering the change.
+	void AfterChange(const char *text, size_t length, long long lengthChange);
+
+	/// Append the words longer than prefix which start with it to matches.
+	/// One occurrence of wordCurrent, the word being typed, is not counted.
+	void Find(const char *prefix, bool ignoreCase, const std::string &wordCurrent,
+		std::vector<std::string> &matches) const;
+
+	/// Add delta to the count of each run of wordCharacters_ in text.
+	static void Count(WordCounts &counts, const char *text, size_t length,
+		const char *wordCharacters_, int delta, volatile bool *cancelling = 0);
+	/// Count the words of a whole document into empty counts, faster than Count for long texts.
+	static void CountAll(WordCounts &counts, const char *text, size_t length,
+		const char *wordCharacters_, volatile bool *cancelling = 0);
+};
+
+#endif
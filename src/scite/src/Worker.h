@@ -29,3 +29,31 @@ struct Worker {
 struct WorkerListener {
 	virtual void PostOnMainThread(int cmd, Worker *pWorker) = 0;
 };
+
+//!-start-[WorkerFinish]
+/// A worker whose final post asks the main thread to delete it.
+/// The post is made while holding mutexFinish so AwaitFinished blocks until the
+/// thread has let go of the worker instead of spinning.
+struct PostingWorker : public Worker {
+	Mutex *mutexFinish;
+
+	PostingWorker() : mutexFinish(Mutex::Create()) {
+	}
+	virtual ~PostingWorker() {
+		delete mutexFinish;
+	}
+	/// Called last by Execute so nothing touches the worker after the post.
+	void PostFinished(WorkerListener *pListener, int cmd) {
+		Lock lock(mutexFinish);
+		completed = true;
+		pListener->PostOnMainThread(cmd, this);
+	}
+	void AwaitFinished() {
+		Lock lock(mutexFinish);
+	}
+	virtual void Cancel() {
+		Worker::Cancel();
+		AwaitFinished();
+	}
+};
+//!-end-[WorkerFinish]
@@ -783,6 +783,7 @@ DWORD SciTEWin::ExecuteOne(const Job &jobToRun) {
 	}
 
 	if (jobToRun.jobType == jobGrep) {
+/*!
 		// jobToRun.command is "(w|~)(c|~)(d|~)(b|~)\0files\0text"
 		const char *grepCmd = jobToRun.command.c_str();
 		if (*grepCmd) {
@@ -804,6 +805,8 @@ DWORD SciTEWin::ExecuteOne(const Job &jobToRun) {
 				gf = static_cast<GrepFlags>(gf | grepScroll);
 			InternalGrep(gf, jobToRun.directory.AsInternal(), GUI::StringFromUTF8(findFiles).c_str(), findWhat);
 		}
+*/
+		InternalGrepJob(jobToRun, cmdWorker.grepSettings, cmdWorker.outputScroll == 1); //!-add-[ParallelGrep]
 		return exitcode;
 	}
 
@@ -984,6 +987,7 @@ DWORD SciTEWin::ExecuteOne(const Job &jobToRun) {
 					// Is this the right thing to do when writing to the pipe fails?
 					::CloseHandle(hWriteSubProcess);
 					hWriteSubProcess = INVALID_HANDLE_VALUE;
+					OutputFlush(true);	//!-add-[OutputBatch]
 					OutputAppendStringSynchronised("\n>Input pipe closed due to write failure.\n");
 				}
 
@@ -992,6 +996,7 @@ DWORD SciTEWin::ExecuteOne(const Job &jobToRun) {
 						       sizeof(buffer), &bytesRead, NULL);
 
 				if (bTest && bytesRead) {
+					countPeeks = 0;	//!-add-[OutputBatch] keep reading without sleeping while the tool writes
 
 					if (jobToRun.flags & jobRepSelMask) {
 						repSelBuf.append(buffer, bytesRead);
@@ -1011,14 +1016,20 @@ DWORD SciTEWin::ExecuteOne(const Job &jobToRun) {
 						}
 //!-end-[oem2ansi]
 						// Display the data
-						OutputAppendStringSynchronised(buffer, bytesRead);
+//!						OutputAppendStringSynchronised(buffer, bytesRead);
+//!-start-[OutputBatch]
+						// in batches so a tool writing a lot does not append, lex and repaint for every read
+						if (OutputAppendBatched(buffer, static_cast<int>(bytesRead), true))
+							::UpdateWindow(MainHWND());
+//!-end-[OutputBatch]
 					}
 
-					::UpdateWindow(MainHWND());
+//!					::UpdateWindow(MainHWND());
 				} else {
 					running = false;
 				}
 			} else {
+				OutputFlush(true);	//!-add-[OutputBatch]
 				if (::GetExitCodeProcess(pi.hProcess, &exitcode)) {
 					if (STILL_ACTIVE != exitcode) {
 						// Already dead
@@ -1033,6 +1044,7 @@ DWORD SciTEWin::ExecuteOne(const Job &jobToRun) {
 					// don't answer to a normal termination command.
 					// This function is dangerous: dependant DLLs don't know the process
 					// is terminated, and memory isn't released.
+					OutputFlush(true);	//!-add-[OutputBatch]
 					OutputAppendStringSynchronised("\n>Process failed to respond; forcing abrupt termination...\n");
 					::TerminateProcess(pi.hProcess, 1);
 				}
@@ -1040,6 +1052,7 @@ DWORD SciTEWin::ExecuteOne(const Job &jobToRun) {
 				cancelled = true;
 			}
 		}
+		OutputFlush(true);	//!-add-[OutputBatch]
 
 		if (WAIT_OBJECT_0 != ::WaitForSingleObject(pi.hProcess, 1000)) {
 			OutputAppendStringSynchronised("\n>Process failed to respond; forcing abrupt termination...");
@@ -1112,7 +1125,8 @@ void SciTEWin::ProcessExecute() {
 	// scroll and return only if output.scroll equals
 	// one in the properties file
 	if ((cmdWorker.outputScroll == 1) && returnOutputToCommand)
-		wOutput.Send(SCI_GOTOPOS, cmdWorker.originalEnd, 0);
+//!		wOutput.Send(SCI_GOTOPOS, cmdWorker.originalEnd, 0);
+		wOutput.Send(SCI_GOTOPOS, (cmdWorker.originalEnd > outputRemoved) ? cmdWorker.originalEnd - outputRemoved : 0, 0);	//!-change-[OutputBatch]
 	returnOutputToCommand = true;
 	PostOnMainThread(WORK_EXECUTE, &cmdWorker);
 }
@@ -1214,7 +1228,9 @@ void SciTEWin::Execute() {
 
 	cmdWorker.Initialise(false);
 	cmdWorker.outputScroll = props.GetInt("output.scroll", 1);
+	cmdWorker.grepSettings = GrepSettingsFromProps(); //!-add-[ParallelGrep]
 	cmdWorker.originalEnd = wOutput.Call(SCI_GETTEXTLENGTH);
+	outputRemoved = 0;	//!-add-[OutputBatch]
 	cmdWorker.commandTime.Duration(true);
 	cmdWorker.flags = jobQueue.jobQueue[cmdWorker.icmd].flags;
 	if (scrollOutput)
@@ -102,6 +102,7 @@ public:
 	int flags;
 	bool seenOutput;
 	int outputScroll;
+	GrepSettings grepSettings; //!-add-[ParallelGrep]
 
 	CommandWorker();
 	void Initialise(bool resetToStart);
@@ -57,6 +57,9 @@ INCLUDEDIRS=-I../../scintilla/include -I../../scintilla/win32 -I../src
 OBJS=\
 	SciTEBase.obj \
 	FileWorker.obj \
+	TrigramIndex.obj \
+	WordIndex.obj \
+	FileWatcher.obj \
 	Cookie.obj \
 	Credits.obj \
 	FilePath.obj \
@@ -84,6 +87,9 @@ LEXLIB=..\..\scintilla\win32\Lexers.lib
 OBJSSTATIC=\
 	SciTEBase.obj \
 	FileWorker.obj \
+	TrigramIndex.obj \
+	WordIndex.obj \
+	FileWatcher.obj \
 	Cookie.obj \
 	Credits.obj \
 	FilePath.obj \
@@ -128,6 +134,8 @@ OBJSSTATIC=\
 	..\..\scintilla\win32\PositionCache.obj \
 	..\..\scintilla\win32\PropSetSimple.obj \
 	..\..\scintilla\win32\RESearch.obj \
+	..\..\scintilla\win32\DFASearch.obj \
+	..\..\scintilla\win32\BackgroundLexer.obj \
 	..\..\scintilla\win32\RunStyles.obj \
 	..\..\scintilla\win32\ScintillaBaseL.obj \
 	..\..\scintilla\win32\ScintillaWinL.obj \
@@ -429,7 +437,8 @@ PropSetFile.obj: \
 	../src/GUI.h \
 	../src/SString.h \
 	../src/FilePath.h \
-	../src/PropSetFile.h
+	../src/PropSetFile.h \
+	../src/StringHelpers.h
 SciTEBase.obj: \
 	../src/SciTEBase.cxx \
 	../../scintilla/include/Scintilla.h \
@@ -446,6 +455,7 @@ SciTEBase.obj: \
 	../src/Mutex.h \
 	../src/JobQueue.h \
 	../src/Worker.h \
+	../src/WordIndex.h \
 	../src/SciTEBase.h
 FileWorker.obj: \
 	../src/FileWorker.cxx \
@@ -453,8 +463,34 @@ FileWorker.obj: \
 	../../scintilla/include/SciLexer.h \
 	../src/GUI.h \
 	../src/SString.h \
+	../src/Mutex.h \
 	../src/Worker.h \
 	../src/FileWorker.h
+TrigramIndex.obj: \
+	../src/TrigramIndex.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/TrigramIndex.h
+WordIndex.obj: \
+	../src/WordIndex.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/WordIndex.h
+FileWatcher.obj: \
+	../src/FileWatcher.cxx \
+	../../scintilla/include/Scintilla.h \
+	../../scintilla/include/ILexer.h \
+	../src/GUI.h \
+	../src/SString.h \
+	../src/FilePath.h \
+	../src/Cookie.h \
+	../src/Mutex.h \
+	../src/Worker.h \
+	../src/FileWorker.h \
+	../src/FileWatcher.h
 Cookie.obj: \
 	../src/Cookie.cxx \
 	../../scintilla/include/Scintilla.h \
@@ -492,6 +528,7 @@ SciTEBuffers.obj: \
 	../src/SciTE.h \
 	../src/Mutex.h \
 	../src/JobQueue.h \
+	../src/WordIndex.h \
 	../src/SciTEBase.h
 SciTEIO.obj: \
 	../src/SciTEIO.cxx \
@@ -509,6 +546,7 @@ SciTEIO.obj: \
 	../src/JobQueue.h \
 	../src/SciTEBase.h \
 	../src/Cookie.h \
+	../src/TrigramIndex.h \
 	../src/Utf8_16.h
 SciTEProps.obj: \
 	../src/SciTEProps.cxx \
@@ -526,6 +564,7 @@ SciTEProps.obj: \
 	../src/IFaceTable.h \
 	../src/Mutex.h \
 	../src/JobQueue.h \
+	../src/FileWorker.h \
 	../src/SciTEBase.h
 StringList.obj: \
 	../src/StringList.cxx \
@@ -93,6 +93,9 @@ OBJS=\
 	FilePath.obj \
 	SciTEBuffers.obj \
 	SciTEIO.obj \
+	TrigramIndex.obj \
+	WordIndex.obj \
+	FileWatcher.obj \
 	Exporters.obj \
 	PropSetFile.obj \
 	StringList.obj \
@@ -205,6 +208,9 @@ OBJSSTATIC=\
 	FilePath.obj \
 	SciTEBuffers.obj \
 	SciTEIO.obj \
+	TrigramIndex.obj \
+	WordIndex.obj \
+	FileWatcher.obj \
 	Exporters.obj \
 	PropSetFile.obj \
 	StringList.obj \
@@ -237,6 +243,8 @@ OBJSSTATIC=\
 	..\..\scintilla\win32\PositionCache.obj \
 	..\..\scintilla\win32\PropSet.obj \
 	..\..\scintilla\win32\RESearch.obj \
+	..\..\scintilla\win32\DFASearch.obj \
+	..\..\scintilla\win32\BackgroundLexer.obj \
 	..\..\scintilla\win32\RunStyles.obj \
 	..\..\scintilla\win32\ScintillaBaseL.obj \
 	..\..\scintilla\win32\ScintillaWinL.obj \
@@ -661,7 +669,8 @@ Exporters.obj: \
 PropSetFile.obj: \
 	../src/PropSetFile.cxx \
 	../src/PropSetFile.h \
-	../src/SString.h
+	../src/SString.h \
+	../src/StringHelpers.h
 SciTEBase.obj: \
 	../src/SciTEBase.cxx \
 	../../scintilla/include/Platform.h \
@@ -703,6 +712,31 @@ SciTEBuffers.obj: \
 	../src/Mutex.h \
 	../src/JobQueue.h \
 	../src/SciTEBase.h
+TrigramIndex.obj: \
+	../src/TrigramIndex.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/FilePath.h \
+	../src/TrigramIndex.h
+WordIndex.obj: \
+	../src/WordIndex.cxx \
+	../../scintilla/include/Scintilla.h \
+	../src/GUI.h \
+	../src/StringHelpers.h \
+	../src/WordIndex.h
+FileWatcher.obj: \
+	../src/FileWatcher.cxx \
+	../../scintilla/include/Scintilla.h \
+	../../scintilla/include/ILexer.h \
+	../src/GUI.h \
+	../src/SString.h \
+	../src/FilePath.h \
+	../src/Cookie.h \
+	../src/Mutex.h \
+	../src/Worker.h \
+	../src/FileWorker.h \
+	../src/FileWatcher.h
 SciTEIO.obj: \
 	../src/SciTEIO.cxx \
 	../../scintilla/include/Platform.h \